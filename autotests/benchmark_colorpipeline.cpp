@@ -0,0 +1,127 @@
+/*
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include <QTest>
+
+#include "core/colorpipeline.h"
+
+using namespace KWin;
+
+/**
+ * The sample points of a 1D lookup table with @a size entries, like the ones computed for KMS.
+ */
+static std::vector<QVector3D> lut1DSamples(size_t size)
+{
+    std::vector<QVector3D> samples(size);
+    for (size_t i = 0; i < size; i++) {
+        const float input = i / float(size - 1);
+        samples[i] = QVector3D(input, input, input);
+    }
+    return samples;
+}
+
+/**
+ * The sample points of a 3D lookup table with @a size entries in each dimension.
+ */
+static std::vector<QVector3D> lut3DSamples(size_t size)
+{
+    std::vector<QVector3D> samples;
+    samples.reserve(size * size * size);
+    for (size_t r = 0; r < size; r++) {
+        for (size_t g = 0; g < size; g++) {
+            for (size_t b = 0; b < size; b++) {
+                samples.push_back(QVector3D(r, g, b) / float(size - 1));
+            }
+        }
+    }
+    return samples;
+}
+
+class BenchmarkColorPipeline : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void evaluate_data();
+    void evaluate();
+    void evaluateBatch_data();
+    void evaluateBatch();
+
+private:
+    void addPipelines();
+};
+
+void BenchmarkColorPipeline::addPipelines()
+{
+    QTest::addColumn<std::shared_ptr<ColorDescription>>("srcColor");
+    QTest::addColumn<std::shared_ptr<ColorDescription>>("dstColor");
+    QTest::addColumn<std::vector<QVector3D>>("samples");
+
+    const auto bt2020pq = std::make_shared<ColorDescription>(ColorDescription{
+        Colorimetry::BT2020,
+        TransferFunction(TransferFunction::PerceptualQuantizer),
+        203,
+        0,
+        1000,
+        1000,
+    });
+    const auto bt1886 = std::make_shared<ColorDescription>(ColorDescription{
+        Colorimetry::BT709,
+        TransferFunction(TransferFunction::BT1886, 0.1, 300),
+        300,
+        0.1,
+        std::nullopt,
+        std::nullopt,
+    });
+
+    QTest::addRow("sRGB -> BT2020 PQ, 4096 entry 1D LUT") << ColorDescription::sRGB << bt2020pq << lut1DSamples(4096);
+    QTest::addRow("sRGB -> BT2020 PQ, 33x33x33 3D LUT") << ColorDescription::sRGB << bt2020pq << lut3DSamples(33);
+    QTest::addRow("BT2020 PQ -> sRGB, 33x33x33 3D LUT") << bt2020pq << ColorDescription::sRGB << lut3DSamples(33);
+    QTest::addRow("sRGB -> BT1886, 4096 entry 1D LUT") << ColorDescription::sRGB << bt1886 << lut1DSamples(4096);
+}
+
+void BenchmarkColorPipeline::evaluate_data()
+{
+    addPipelines();
+}
+
+void BenchmarkColorPipeline::evaluate()
+{
+    QFETCH(std::shared_ptr<ColorDescription>, srcColor);
+    QFETCH(std::shared_ptr<ColorDescription>, dstColor);
+    QFETCH(std::vector<QVector3D>, samples);
+
+    const ColorPipeline pipeline = ColorPipeline::create(srcColor, dstColor, RenderingIntent::Perceptual);
+    std::vector<QVector3D> output(samples.size());
+    QBENCHMARK {
+        for (size_t i = 0; i < samples.size(); i++) {
+            output[i] = pipeline.evaluate(samples[i]);
+        }
+    }
+}
+
+void BenchmarkColorPipeline::evaluateBatch_data()
+{
+    addPipelines();
+}
+
+void BenchmarkColorPipeline::evaluateBatch()
+{
+    QFETCH(std::shared_ptr<ColorDescription>, srcColor);
+    QFETCH(std::shared_ptr<ColorDescription>, dstColor);
+    QFETCH(std::vector<QVector3D>, samples);
+
+    const ColorPipeline pipeline = ColorPipeline::create(srcColor, dstColor, RenderingIntent::Perceptual);
+    std::vector<QVector3D> output;
+    QBENCHMARK {
+        output = samples;
+        pipeline.evaluate(output);
+    }
+}
+
+QTEST_MAIN(BenchmarkColorPipeline)
+
+#include "benchmark_colorpipeline.moc"
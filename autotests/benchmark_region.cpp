@@ -0,0 +1,369 @@
+/*
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include <QDir>
+#include <QTest>
+
+#include "core/regiontrace.h"
+
+using namespace KWin;
+
+Q_DECLARE_METATYPE(QList<KWin::RegionTraceFrame>)
+
+static const Rect s_outputRect(0, 0, 2560, 1440);
+
+/**
+ * A browser window with a toolbar and a sidebar on top of a panel, the page content is scrolled.
+ */
+static QList<RegionTraceFrame> browserScrollingTrace()
+{
+    const Rect panel(0, 1400, 2560, 40);
+    const Rect browser(200, 100, 1800, 1200);
+    const Rect page(460, 180, 1540, 1120);
+
+    QList<RegionTraceFrame> frames;
+    for (int i = 0; i < 240; ++i) {
+        RegionTraceFrame frame;
+        // the page and the scroll bar are repainted, as well as a tab that shows the progress
+        frame.damage = Region(page) | Rect(1984, 180 + (i * 7) % 1000, 16, 120) | Rect(210 + (i % 8) * 180, 110, 24, 24);
+        frame.windows = {
+            RegionTraceWindow{
+                .bounds = browser.grownBy(QMargins(24, 24, 24, 24)),
+                .opaque = Region(browser) - Rect(browser.x(), browser.y(), 12, 12) - Rect(browser.right() - 12, browser.y(), 12, 12),
+            },
+            RegionTraceWindow{
+                .bounds = panel,
+                .opaque = Region(),
+            },
+            RegionTraceWindow{
+                .bounds = s_outputRect,
+                .opaque = Region(s_outputRect),
+            },
+        };
+        frames.append(frame);
+    }
+    return frames;
+}
+
+/**
+ * A terminal that prints lots of text, only the lines that changed and the cursor are repainted.
+ */
+static QList<RegionTraceFrame> terminalSpamTrace()
+{
+    const Rect terminal(300, 200, 1200, 800);
+    const Rect editor(1000, 300, 1400, 1000);
+
+    QList<RegionTraceFrame> frames;
+    for (int i = 0; i < 240; ++i) {
+        QList<Rect> lines;
+        for (int line = 0; line < 40; ++line) {
+            if ((line * 31 + i) % 3 == 0) {
+                lines.append(Rect(terminal.x() + 8, terminal.y() + 30 + line * 19, 40 + ((line * 17 + i * 13) % 1100), 19));
+            }
+        }
+
+        RegionTraceFrame frame;
+        frame.damage = Region::fromSortedRects(lines) & terminal;
+        frame.windows = {
+            RegionTraceWindow{
+                .bounds = editor.grownBy(QMargins(24, 24, 24, 24)),
+                .opaque = Region(editor),
+            },
+            RegionTraceWindow{
+                .bounds = terminal.grownBy(QMargins(24, 24, 24, 24)),
+                .opaque = Region(terminal),
+            },
+            RegionTraceWindow{
+                .bounds = s_outputRect,
+                .opaque = Region(s_outputRect),
+            },
+        };
+        frames.append(frame);
+    }
+    return frames;
+}
+
+/**
+ * A video player with subtitles, and a translucent on-screen display that's shown for a while.
+ */
+static QList<RegionTraceFrame> videoWithSubtitlesTrace()
+{
+    const Rect video(320, 180, 1920, 1080);
+    const Rect controls(320, 1160, 1920, 100);
+
+    QList<RegionTraceFrame> frames;
+    for (int i = 0; i < 240; ++i) {
+        RegionTraceFrame frame;
+        frame.damage = Region(video);
+        if (i % 60 < 45) {
+            // the subtitles are rendered in a subsurface
+            frame.damage |= Rect(760, 1080 - (i % 2) * 20, 1040, 80);
+        }
+
+        frame.windows = {
+            RegionTraceWindow{
+                .bounds = Rect(760, 1060, 1040, 100),
+                .opaque = Region(),
+            },
+        };
+        if (i < 120) {
+            frame.windows.append(RegionTraceWindow{
+                .bounds = controls,
+                .opaque = Region(),
+            });
+        }
+        frame.windows.append(RegionTraceWindow{
+            .bounds = video,
+            .opaque = Region(video),
+        });
+        frame.windows.append(RegionTraceWindow{
+            .bounds = s_outputRect,
+            .opaque = Region(s_outputRect),
+        });
+        frames.append(frame);
+    }
+    return frames;
+}
+
+/**
+ * Benchmarks Region and RegionF operations the same way the scene uses them when painting.
+ *
+ * Besides the built-in synthetic traces, the benchmarks replay the traces that are found in
+ * the directory specified by the KWIN_REGION_TRACES_DIR environment variable. Such traces can
+ * be recorded from a running session by starting kwin with KWIN_SCENE_REGION_TRACE set to the
+ * path of the trace file.
+ */
+class BenchmarkRegion : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void occlusion_data();
+    void occlusion();
+    void united_data();
+    void united();
+    void subtracted_data();
+    void subtracted();
+    void intersected_data();
+    void intersected();
+    void scaledAndRoundedOut_data();
+    void scaledAndRoundedOut();
+    void regionFUnited_data();
+    void regionFUnited();
+    void regionFSubtracted_data();
+    void regionFSubtracted();
+    void regionFIntersected_data();
+    void regionFIntersected();
+    void regionFScaledAndRoundedOut_data();
+    void regionFScaledAndRoundedOut();
+
+private:
+    void addTraces();
+};
+
+void BenchmarkRegion::addTraces()
+{
+    QTest::addColumn<QList<RegionTraceFrame>>("frames");
+
+    QTest::addRow("browser scrolling") << browserScrollingTrace();
+    QTest::addRow("terminal spam") << terminalSpamTrace();
+    QTest::addRow("video with subtitles") << videoWithSubtitlesTrace();
+
+    const QString tracesDirectory = qEnvironmentVariable("KWIN_REGION_TRACES_DIR");
+    if (!tracesDirectory.isEmpty()) {
+        const QDir directory(tracesDirectory);
+        const QStringList fileNames = directory.entryList(QDir::Files, QDir::Name);
+        for (const QString &fileName : fileNames) {
+            const auto frames = loadRegionTrace(directory.filePath(fileName));
+            if (!frames) {
+                qWarning() << "Failed to load region trace" << fileName;
+                continue;
+            }
+            QTest::addRow("%s", qPrintable(fileName)) << *frames;
+        }
+    }
+}
+
+void BenchmarkRegion::occlusion_data()
+{
+    addTraces();
+}
+
+void BenchmarkRegion::occlusion()
+{
+    // see WorkspaceScene::paintSimpleScreen()
+    QFETCH(QList<RegionTraceFrame>, frames);
+
+    QBENCHMARK {
+        for (const RegionTraceFrame &frame : std::as_const(frames)) {
+            Region visible = frame.damage;
+            for (const RegionTraceWindow &window : frame.windows) {
+                const Region painted = visible & window.bounds;
+                Q_UNUSED(painted)
+                visible -= window.opaque;
+            }
+        }
+    }
+}
+
+void BenchmarkRegion::united_data()
+{
+    addTraces();
+}
+
+void BenchmarkRegion::united()
+{
+    // the repair region of a buffer with an age of 3
+    QFETCH(QList<RegionTraceFrame>, frames);
+
+    QBENCHMARK {
+        for (qsizetype i = 2; i < frames.size(); ++i) {
+            const Region repair = frames[i].damage | frames[i - 1].damage | frames[i - 2].damage;
+            Q_UNUSED(repair)
+        }
+    }
+}
+
+void BenchmarkRegion::subtracted_data()
+{
+    addTraces();
+}
+
+void BenchmarkRegion::subtracted()
+{
+    QFETCH(QList<RegionTraceFrame>, frames);
+
+    QBENCHMARK {
+        for (const RegionTraceFrame &frame : std::as_const(frames)) {
+            for (const RegionTraceWindow &window : frame.windows) {
+                const Region remaining = frame.damage - window.opaque;
+                Q_UNUSED(remaining)
+            }
+        }
+    }
+}
+
+void BenchmarkRegion::intersected_data()
+{
+    addTraces();
+}
+
+void BenchmarkRegion::intersected()
+{
+    QFETCH(QList<RegionTraceFrame>, frames);
+
+    QBENCHMARK {
+        for (const RegionTraceFrame &frame : std::as_const(frames)) {
+            for (const RegionTraceWindow &window : frame.windows) {
+                const Region intersection = frame.damage & window.opaque;
+                Q_UNUSED(intersection)
+            }
+        }
+    }
+}
+
+void BenchmarkRegion::scaledAndRoundedOut_data()
+{
+    addTraces();
+}
+
+void BenchmarkRegion::scaledAndRoundedOut()
+{
+    QFETCH(QList<RegionTraceFrame>, frames);
+
+    QBENCHMARK {
+        for (const RegionTraceFrame &frame : std::as_const(frames)) {
+            const Region scaled = frame.damage.scaledAndRoundedOut(1.25);
+            Q_UNUSED(scaled)
+        }
+    }
+}
+
+static QList<RegionF> toRegionF(const QList<RegionTraceFrame> &frames, qreal scale)
+{
+    QList<RegionF> regions;
+    regions.reserve(frames.size());
+    for (const RegionTraceFrame &frame : frames) {
+        regions.append(RegionF(frame.damage).scaled(scale));
+    }
+    return regions;
+}
+
+void BenchmarkRegion::regionFUnited_data()
+{
+    addTraces();
+}
+
+void BenchmarkRegion::regionFUnited()
+{
+    QFETCH(QList<RegionTraceFrame>, frames);
+    const QList<RegionF> regions = toRegionF(frames, 1.0 / 1.25);
+
+    QBENCHMARK {
+        for (qsizetype i = 2; i < regions.size(); ++i) {
+            const RegionF repair = regions[i] | regions[i - 1] | regions[i - 2];
+            Q_UNUSED(repair)
+        }
+    }
+}
+
+void BenchmarkRegion::regionFSubtracted_data()
+{
+    addTraces();
+}
+
+void BenchmarkRegion::regionFSubtracted()
+{
+    QFETCH(QList<RegionTraceFrame>, frames);
+    const QList<RegionF> regions = toRegionF(frames, 1.0 / 1.25);
+
+    QBENCHMARK {
+        for (qsizetype i = 1; i < regions.size(); ++i) {
+            const RegionF remaining = regions[i] - regions[i - 1];
+            Q_UNUSED(remaining)
+        }
+    }
+}
+
+void BenchmarkRegion::regionFIntersected_data()
+{
+    addTraces();
+}
+
+void BenchmarkRegion::regionFIntersected()
+{
+    QFETCH(QList<RegionTraceFrame>, frames);
+    const QList<RegionF> regions = toRegionF(frames, 1.0 / 1.25);
+
+    QBENCHMARK {
+        for (qsizetype i = 1; i < regions.size(); ++i) {
+            const RegionF intersection = regions[i] & regions[i - 1];
+            Q_UNUSED(intersection)
+        }
+    }
+}
+
+void BenchmarkRegion::regionFScaledAndRoundedOut_data()
+{
+    addTraces();
+}
+
+void BenchmarkRegion::regionFScaledAndRoundedOut()
+{
+    QFETCH(QList<RegionTraceFrame>, frames);
+    const QList<RegionF> regions = toRegionF(frames, 1.0 / 1.25);
+
+    QBENCHMARK {
+        for (const RegionF &region : regions) {
+            const Region scaled = region.scaled(1.25).roundedOut();
+            Q_UNUSED(scaled)
+        }
+    }
+}
+
+QTEST_GUILESS_MAIN(BenchmarkRegion)
+
+#include "benchmark_region.moc"
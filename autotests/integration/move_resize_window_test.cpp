@@ -14,6 +14,9 @@
 #include "pointer_input.h"
 #include "scene/windowitem.h"
 #include "virtualdesktops.h"
+#include "wayland/clientconnection.h"
+#include "wayland/commitlatency.h"
+#include "wayland/surface.h"
 #include "wayland_server.h"
 #include "window.h"
 #include "workspace.h"
@@ -41,6 +44,7 @@ private Q_SLOTS:
     void cleanup();
     void testMove();
     void testResize();
+    void testResizeThrottled();
     void testPackTo_data();
     void testPackTo();
     void testPackAgainstClient_data();
@@ -290,6 +294,66 @@ void MoveResizeWindowTest::testResize()
     QVERIFY(Test::waitForWindowClosed(window));
 }
 
+void MoveResizeWindowTest::testResizeThrottled()
+{
+    // this test verifies that only one resize is sent to the client at a time during an
+    // interactive resize, the sizes requested while the client is busy are dropped
+
+    std::unique_ptr<KWayland::Client::Surface> surface(Test::createSurface());
+    std::unique_ptr<Test::XdgToplevel> shellSurface(Test::createXdgToplevelSurface(surface.get()));
+    auto window = Test::renderAndWaitForShown(surface.get(), QSize(100, 50), Qt::blue);
+    QVERIFY(window);
+    const CommitLatencyStatistics &statistics = window->surface()->client()->commitLatency();
+    const quint64 resizeCount = statistics.resizeLatency().count();
+
+    QSignalSpy toplevelConfigureRequestedSpy(shellSurface.get(), &Test::XdgToplevel::configureRequested);
+    QSignalSpy surfaceConfigureRequestedSpy(shellSurface->xdgSurface(), &Test::XdgSurface::configureRequested);
+    QSignalSpy frameGeometryChangedSpy(window, &Window::frameGeometryChanged);
+
+    // begin resize
+    workspace()->slotWindowResize();
+    QCOMPARE(workspace()->moveResizeWindow(), window);
+    QVERIFY(surfaceConfigureRequestedSpy.wait());
+    shellSurface->xdgSurface()->ack_configure(surfaceConfigureRequestedSpy.last().at(0).value<quint32>());
+
+    // the first resize is sent right away
+    window->keyPressEvent(Qt::Key_Right);
+    window->updateInteractiveMoveResize(Cursors::self()->mouse()->pos(), Qt::KeyboardModifiers());
+    QVERIFY(surfaceConfigureRequestedSpy.wait());
+    QCOMPARE(toplevelConfigureRequestedSpy.last().at(0).toSize(), QSize(108, 50));
+    const int configureCount = surfaceConfigureRequestedSpy.count();
+
+    // the following ones have to wait until the client has caught up
+    window->keyPressEvent(Qt::Key_Right);
+    window->updateInteractiveMoveResize(Cursors::self()->mouse()->pos(), Qt::KeyboardModifiers());
+    window->keyPressEvent(Qt::Key_Down);
+    window->updateInteractiveMoveResize(Cursors::self()->mouse()->pos(), Qt::KeyboardModifiers());
+    QVERIFY(!surfaceConfigureRequestedSpy.wait(100));
+    QCOMPARE(window->moveResizeGeometry(), RectF(0, 0, 116, 58));
+
+    shellSurface->xdgSurface()->ack_configure(surfaceConfigureRequestedSpy.last().at(0).value<quint32>());
+    Test::render(surface.get(), QSize(108, 50), Qt::blue);
+    QVERIFY(frameGeometryChangedSpy.wait());
+    QCOMPARE(window->frameGeometry(), RectF(0, 0, 108, 50));
+    QCOMPARE(statistics.resizeLatency().count(), resizeCount + 1);
+
+    // only the latest size is sent
+    QVERIFY(surfaceConfigureRequestedSpy.wait());
+    QCOMPARE(surfaceConfigureRequestedSpy.count(), configureCount + 1);
+    QCOMPARE(toplevelConfigureRequestedSpy.last().at(0).toSize(), QSize(116, 58));
+    shellSurface->xdgSurface()->ack_configure(surfaceConfigureRequestedSpy.last().at(0).value<quint32>());
+    Test::render(surface.get(), QSize(116, 58), Qt::blue);
+    QVERIFY(frameGeometryChangedSpy.wait());
+    QCOMPARE(window->frameGeometry(), RectF(0, 0, 116, 58));
+    QCOMPARE(statistics.resizeLatency().count(), resizeCount + 2);
+
+    window->keyPressEvent(Qt::Key_Enter);
+    QCOMPARE(workspace()->moveResizeWindow(), nullptr);
+
+    shellSurface.reset();
+    QVERIFY(Test::waitForWindowClosed(window));
+}
+
 void MoveResizeWindowTest::testPackTo_data()
 {
     QTest::addColumn<QString>("methodCall");
@@ -0,0 +1,295 @@
+/*
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "kwin_wayland_test.h"
+
+#include "compositor.h"
+#include "core/regiontrace.h"
+#include "core/renderbackend.h"
+#include "effect/effectloader.h"
+#include "wayland_server.h"
+#include "window.h"
+#include "workspace.h"
+
+#include <KConfigGroup>
+#include <KWayland/Client/subsurface.h>
+#include <KWayland/Client/surface.h>
+
+#include <algorithm>
+#include <time.h>
+
+namespace KWin
+{
+
+/**
+ * This runs scripted workloads on the virtual backend and reports how much CPU time each frame
+ * takes, from one presented frame to the next. The clients run in the same process, so their
+ * work is included, but it stays the same between runs. The frame count can be changed with
+ * KWIN_SCENE_BENCHMARK_FRAMES
+ *
+ * Region traces recorded with KWIN_SCENE_REGION_TRACE can be replayed by pointing
+ * KWIN_SCENE_BENCHMARK_TRACE to them
+ */
+class SceneBenchmark : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void init();
+    void cleanup();
+
+    void benchmarkDamageWindows_data();
+    void benchmarkDamageWindows();
+    void benchmarkSubSurfaces_data();
+    void benchmarkSubSurfaces();
+    void benchmarkResize();
+    void benchmarkReplayTrace();
+
+private:
+    bool measureFrames(int count, const std::function<KWayland::Client::Surface *(int frame)> &prepare);
+};
+
+static std::chrono::nanoseconds processCpuTime()
+{
+    timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return std::chrono::seconds(ts.tv_sec) + std::chrono::nanoseconds(ts.tv_nsec);
+}
+
+static int frameCount()
+{
+    const int count = qEnvironmentVariableIntValue("KWIN_SCENE_BENCHMARK_FRAMES");
+    return count > 0 ? count : 120;
+}
+
+void SceneBenchmark::initTestCase()
+{
+    qRegisterMetaType<KWin::Window *>();
+    QVERIFY(waylandServer()->init(qAppName()));
+
+    // effects would make the results depend on their animations
+    auto config = KSharedConfig::openConfig(QString(), KConfig::SimpleConfig);
+    KConfigGroup plugins(config, QStringLiteral("Plugins"));
+    const auto builtinNames = EffectLoader().listOfKnownEffects();
+    for (const QString &name : builtinNames) {
+        plugins.writeEntry(name + QStringLiteral("Enabled"), false);
+    }
+    config->sync();
+    kwinApp()->setConfig(config);
+
+    kwinApp()->start();
+    Test::setOutputConfig({
+        Rect(0, 0, 1920, 1080),
+        Rect(1920, 0, 1920, 1080),
+    });
+    QVERIFY(Compositor::self());
+    QCOMPARE(Compositor::self()->backend()->compositingType(), KWin::OpenGLCompositing);
+}
+
+void SceneBenchmark::init()
+{
+    QVERIFY(Test::setupWaylandConnection(Test::AdditionalWaylandInterface::PresentationTime));
+}
+
+void SceneBenchmark::cleanup()
+{
+    Test::destroyWaylandConnection();
+}
+
+/**
+ * Runs @a count frames. For every frame, @a prepare has to commit the changes of the clients and
+ * return the surface whose last commit gets presented in the frame, or nullptr to skip the frame.
+ */
+bool SceneBenchmark::measureFrames(int count, const std::function<KWayland::Client::Surface *(int frame)> &prepare)
+{
+    std::vector<std::chrono::nanoseconds> cpuTimes;
+    cpuTimes.reserve(count);
+    for (int i = 0; i < count; i++) {
+        const auto start = processCpuTime();
+        KWayland::Client::Surface *presentedSurface = prepare(i);
+        if (!presentedSurface) {
+            continue;
+        }
+        const auto feedback = std::make_unique<Test::WpPresentationFeedback>(Test::presentationTime()->feedback(*presentedSurface));
+        QSignalSpy presented(feedback.get(), &Test::WpPresentationFeedback::presented);
+        presentedSurface->commit(KWayland::Client::Surface::CommitFlag::None);
+        if (!presented.wait()) {
+            return false;
+        }
+        cpuTimes.push_back(processCpuTime() - start);
+    }
+    if (cpuTimes.empty()) {
+        return true;
+    }
+
+    std::ranges::sort(cpuTimes);
+    const auto percentile = [&cpuTimes](double percentile) {
+        return std::chrono::duration_cast<std::chrono::microseconds>(cpuTimes[std::min<size_t>(cpuTimes.size() - 1, cpuTimes.size() * percentile)]).count();
+    };
+    qInfo("%s: %d frames, CPU time per frame: median %lldus, p90 %lldus, p99 %lldus, max %lldus",
+          QTest::currentDataTag() ? QTest::currentDataTag() : QTest::currentTestFunction(),
+          int(cpuTimes.size()), percentile(0.5), percentile(0.9), percentile(0.99), percentile(1));
+    return true;
+}
+
+void SceneBenchmark::benchmarkDamageWindows_data()
+{
+    QTest::addColumn<int>("windowCount");
+    QTest::addColumn<bool>("damageAll");
+
+    QTest::addRow("1 window") << 1 << true;
+    QTest::addRow("10 windows, all damaged") << 10 << true;
+    QTest::addRow("40 windows, all damaged") << 40 << true;
+    QTest::addRow("40 windows, one damaged") << 40 << false;
+}
+
+void SceneBenchmark::benchmarkDamageWindows()
+{
+    // this simulates a busy desktop, where the windows repaint small parts of themselves
+    QFETCH(int, windowCount);
+    QFETCH(bool, damageAll);
+
+    std::vector<std::unique_ptr<Test::XdgToplevelWindow>> windows;
+    for (int i = 0; i < windowCount; i++) {
+        auto window = std::make_unique<Test::XdgToplevelWindow>();
+        QVERIFY(window->show(QSize(800, 600), QColor::fromHsv(i * 9 % 360, 255, 255)));
+        windows.push_back(std::move(window));
+    }
+
+    QVERIFY(measureFrames(frameCount(), [&](int frame) {
+        for (size_t i = damageAll ? 0 : windows.size() - 1; i < windows.size(); i++) {
+            KWayland::Client::Surface *surface = windows[i]->m_surface.get();
+            surface->damage(QRect((frame * 37) % 700, (frame * 23) % 500, 100, 100));
+            if (i != windows.size() - 1) {
+                surface->commit(KWayland::Client::Surface::CommitFlag::None);
+            }
+        }
+        return windows.back()->m_surface.get();
+    }));
+}
+
+void SceneBenchmark::benchmarkSubSurfaces_data()
+{
+    QTest::addColumn<int>("subSurfaceCount");
+
+    QTest::addRow("4 subsurfaces") << 4;
+    QTest::addRow("32 subsurfaces") << 32;
+}
+
+void SceneBenchmark::benchmarkSubSurfaces()
+{
+    // this simulates a client like a video player or a browser that uses subsurfaces for parts of its content
+    QFETCH(int, subSurfaceCount);
+
+    Test::XdgToplevelWindow window;
+    QVERIFY(window.show(QSize(1280, 720), Qt::blue));
+
+    std::vector<std::unique_ptr<KWayland::Client::Surface>> surfaces;
+    std::vector<std::unique_ptr<KWayland::Client::SubSurface>> subSurfaces;
+    for (int i = 0; i < subSurfaceCount; i++) {
+        auto surface = Test::createSurface();
+        auto subSurface = Test::createSubSurface(surface.get(), window.m_surface.get());
+        subSurface->setPosition(QPoint((i % 8) * 160, (i / 8) * 180));
+        Test::render(surface.get(), QSize(160, 180), QColor::fromHsv(i * 11 % 360, 255, 255));
+        surfaces.push_back(std::move(surface));
+        subSurfaces.push_back(std::move(subSurface));
+    }
+    QVERIFY(window.presentWait());
+
+    QVERIFY(measureFrames(frameCount(), [&](int frame) {
+        for (const auto &surface : surfaces) {
+            surface->damage(QRect(0, 0, 160, 180));
+            surface->commit(KWayland::Client::Surface::CommitFlag::None);
+        }
+        // the subsurfaces are synchronized, their state gets applied with the parent
+        return window.m_surface.get();
+    }));
+}
+
+void SceneBenchmark::benchmarkResize()
+{
+    // this simulates interactively resizing a window, every frame gets a new buffer of a different size
+    Test::XdgToplevelWindow window;
+    QVERIFY(window.show(QSize(800, 600), Qt::blue));
+
+    QVERIFY(measureFrames(frameCount(), [&](int frame) {
+        const int delta = (frame % 60) * 8;
+        const QSize size(800 + delta, 600 + delta / 2);
+        QImage image(size, QImage::Format_ARGB32_Premultiplied);
+        image.fill(Qt::blue);
+        window.m_surface->attachBuffer(Test::waylandShmPool()->createBuffer(image));
+        window.m_surface->damage(QRect(QPoint(0, 0), size));
+        return window.m_surface.get();
+    }));
+}
+
+void SceneBenchmark::benchmarkReplayTrace()
+{
+    // this replays the windows and the damage of a recorded session. Every window slot of the
+    // trace gets a client window that is moved and resized to match it in every frame.
+    // Only the geometry is replayed, the windows are opaque and not decorated
+    const QString filePath = qEnvironmentVariable("KWIN_SCENE_BENCHMARK_TRACE");
+    if (filePath.isEmpty()) {
+        QSKIP("KWIN_SCENE_BENCHMARK_TRACE is not set");
+    }
+    const auto frames = loadRegionTrace(filePath);
+    QVERIFY(frames.has_value());
+
+    qsizetype windowCount = 0;
+    for (const RegionTraceFrame &frame : *frames) {
+        windowCount = std::max(windowCount, frame.windows.size());
+    }
+    std::vector<std::unique_ptr<Test::XdgToplevelWindow>> windows;
+    for (qsizetype i = 0; i < windowCount; i++) {
+        auto window = std::make_unique<Test::XdgToplevelWindow>();
+        QVERIFY(window->show(QSize(100, 100), QColor::fromHsv(i * 9 % 360, 255, 255)));
+        windows.push_back(std::move(window));
+    }
+    // the trace lists the windows from top to bottom
+    for (auto it = windows.rbegin(); it != windows.rend(); ++it) {
+        workspace()->raiseWindow((*it)->m_window);
+    }
+
+    QVERIFY(measureFrames(frames->size(), [&](int frameIndex) -> KWayland::Client::Surface * {
+        const RegionTraceFrame &frame = frames->at(frameIndex);
+        if (frame.windows.isEmpty()) {
+            return nullptr;
+        }
+        for (qsizetype i = 0; i < windowCount; i++) {
+            Test::XdgToplevelWindow *window = windows[i].get();
+            if (i >= frame.windows.size() || frame.windows[i].bounds.isEmpty()) {
+                window->m_window->setMinimized(true);
+                continue;
+            }
+            const Rect &bounds = frame.windows[i].bounds;
+            window->m_window->setMinimized(false);
+            window->m_window->move(bounds.topLeft());
+            if (window->m_surface->size() != bounds.size()) {
+                QImage image(bounds.size(), QImage::Format_RGB32);
+                image.fill(QColor::fromHsv(i * 9 % 360, 255, 255));
+                window->m_surface->attachBuffer(Test::waylandShmPool()->createBuffer(image));
+            }
+            Region damage = (frame.damage & bounds).translated(-bounds.topLeft());
+            if (i == 0) {
+                // make sure that the frame gets painted and presented
+                damage |= Rect(0, 0, 1, 1);
+            }
+            for (const Rect &rect : damage.rects()) {
+                window->m_surface->damage(rect);
+            }
+            if (i != 0) {
+                window->m_surface->commit(KWayland::Client::Surface::CommitFlag::None);
+            }
+        }
+        return windows.front()->m_surface.get();
+    }));
+}
+
+}
+
+WAYLANDTEST_MAIN(KWin::SceneBenchmark)
+#include "scene_benchmark.moc"
@@ -84,6 +84,7 @@ private Q_SLOTS:
 
     void selection();
     void internalSelection();
+    void sharedSelectionData();
     void destroySelection();
     void invalidSerialForSelection();
     void unsetSupersededSelection();
@@ -233,6 +234,56 @@ void SelectionTest::internalSelection()
     QVERIFY(selectionClearedSpy.wait());
 }
 
+void SelectionTest::sharedSelectionData()
+{
+    // This test verifies that the source is asked for the data only once if it's read several times.
+
+    auto connection = Test::Connection::setup(Test::AdditionalWaylandInterface::Seat | Test::AdditionalWaylandInterface::DataDeviceManager);
+
+    std::unique_ptr<KWayland::Client::DataDevice> dataDevice(connection->dataDeviceManager->getDataDevice(connection->seat));
+    std::unique_ptr<KWayland::Client::DataSource> dataSource(connection->dataDeviceManager->createDataSource());
+    dataSource->offer(plainText());
+    connect(dataSource.get(), &KWayland::Client::DataSource::sendDataRequested, this, [](const QString &mimeType, int fd) {
+        const auto data = QByteArrayLiteral("foo");
+        write(fd, data.data(), data.size());
+        close(fd);
+    });
+    QSignalSpy sendDataRequestedSpy(dataSource.get(), &KWayland::Client::DataSource::sendDataRequested);
+
+    auto surface = Test::createSurface(connection->compositor);
+    auto shellSurface = Test::createXdgToplevelSurface(connection->xdgShell, surface.get());
+    auto window = Test::renderAndWaitForShown(connection->shm, surface.get(), QSize(100, 100), Qt::red);
+
+    std::unique_ptr<KWayland::Client::Keyboard> keyboard(connection->seat->createKeyboard());
+    QSignalSpy keyboardEnteredSpy(keyboard.get(), &KWayland::Client::Keyboard::entered);
+    workspace()->activateWindow(window);
+    QVERIFY(keyboardEnteredSpy.wait());
+    const quint32 enteredSerial = keyboardEnteredSpy.last().at(0).value<quint32>();
+
+    // Set the selection.
+    dataDevice->setSelection(enteredSerial, dataSource.get());
+
+    QSignalSpy dataDeviceSelectionOfferedSpy(dataDevice.get(), &KWayland::Client::DataDevice::selectionOffered);
+    QVERIFY(dataDeviceSelectionOfferedSpy.wait());
+    KWayland::Client::DataOffer *offer = dataDevice->offeredSelection();
+
+    // Ask for data twice at the same time.
+    const QFuture<QByteArray> firstData = readMimeTypeData(offer, plainText());
+    const QFuture<QByteArray> secondData = readMimeTypeData(offer, plainText());
+    QVERIFY(waitFuture(firstData));
+    if (!secondData.isFinished()) {
+        QVERIFY(waitFuture(secondData));
+    }
+    QCOMPARE(firstData.result(), QByteArrayLiteral("foo"));
+    QCOMPARE(secondData.result(), QByteArrayLiteral("foo"));
+
+    // And once more after the source has sent everything.
+    const QFuture<QByteArray> thirdData = readMimeTypeData(offer, plainText());
+    QVERIFY(waitFuture(thirdData));
+    QCOMPARE(thirdData.result(), QByteArrayLiteral("foo"));
+    QCOMPARE(sendDataRequestedSpy.count(), 1);
+}
+
 void SelectionTest::destroySelection()
 {
     // This test verifies that the wl_data_offer will be withdrawn if the associated data source is destroyed.
@@ -0,0 +1,273 @@
+/*
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "kwin_wayland_test.h"
+
+#include "compositor.h"
+#include "core/backendoutput.h"
+#include "core/frametimingjournal.h"
+#include "core/outputbackend.h"
+#include "core/renderbackend.h"
+#include "core/renderloop.h"
+#include "effect/effectloader.h"
+#include "virtualdesktops.h"
+#include "wayland_server.h"
+#include "window.h"
+#include "workspace.h"
+
+#include <KConfigGroup>
+#include <KWayland/Client/subsurface.h>
+#include <KWayland/Client/surface.h>
+
+#include <QElapsedTimer>
+
+#include <algorithm>
+#include <span>
+#include <sys/resource.h>
+
+namespace KWin
+{
+
+/**
+ * This maps and unmaps lots of windows on the virtual backend and reports how many windows
+ * are managed per second, how long the frames painted in the meantime took to render and
+ * the peak memory usage of the process.
+ *
+ * The amount of windows can be changed with KWIN_WINDOW_CHURN_WINDOWS, the desktop switching
+ * test uses half of them. The results are only compared to budgets if those are set, as they
+ * depend on the machine:
+ * - KWIN_WINDOW_CHURN_MIN_RATE: windows that have to be managed per second at least
+ * - KWIN_WINDOW_CHURN_MAX_FRAME_TIME_US: maximum render time of a frame during the churn
+ * - KWIN_WINDOW_CHURN_MAX_RSS_MB: maximum peak resident memory of the process
+ */
+class WindowChurnBenchmark : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void init();
+    void cleanup();
+
+    void benchmarkMapUnmap();
+    void benchmarkSubSurfaceTree();
+    void benchmarkDesktopSwitch();
+
+private:
+    void startMeasuring();
+    bool finishMeasuring(const char *name, int windowCount, std::chrono::nanoseconds duration);
+
+    std::vector<uint64_t> m_firstSequences;
+};
+
+static int windowCount(int defaultCount)
+{
+    const int count = qEnvironmentVariableIntValue("KWIN_WINDOW_CHURN_WINDOWS");
+    return count > 0 ? count : defaultCount;
+}
+
+static qint64 peakResidentMemory()
+{
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    // the maximum resident set size is in kilobytes on Linux
+    return usage.ru_maxrss / 1024;
+}
+
+void WindowChurnBenchmark::initTestCase()
+{
+    qRegisterMetaType<KWin::Window *>();
+    QVERIFY(waylandServer()->init(qAppName()));
+
+    // effects would make the results depend on their animations
+    auto config = KSharedConfig::openConfig(QString(), KConfig::SimpleConfig);
+    KConfigGroup plugins(config, QStringLiteral("Plugins"));
+    const auto builtinNames = EffectLoader().listOfKnownEffects();
+    for (const QString &name : builtinNames) {
+        plugins.writeEntry(name + QStringLiteral("Enabled"), false);
+    }
+    config->sync();
+    kwinApp()->setConfig(config);
+
+    kwinApp()->start();
+    Test::setOutputConfig({
+        Rect(0, 0, 1920, 1080),
+    });
+    QVERIFY(Compositor::self());
+    QCOMPARE(Compositor::self()->backend()->compositingType(), KWin::OpenGLCompositing);
+}
+
+void WindowChurnBenchmark::init()
+{
+    QVERIFY(Test::setupWaylandConnection(Test::AdditionalWaylandInterface::PresentationTime));
+}
+
+void WindowChurnBenchmark::cleanup()
+{
+    Test::destroyWaylandConnection();
+    VirtualDesktopManager::self()->setCount(1);
+}
+
+void WindowChurnBenchmark::startMeasuring()
+{
+    m_firstSequences.clear();
+    const auto outputs = kwinApp()->outputBackend()->outputs();
+    for (BackendOutput *output : outputs) {
+        const FrameTimingJournal *journal = output->renderLoop()->frameTimings();
+        m_firstSequences.push_back(journal ? journal->lastSequence() + 1 : 1);
+    }
+}
+
+/**
+ * Reports the results of the churn that started with the last call to startMeasuring() and
+ * took @a duration to handle @a windowCount windows. Only the most recent frames of the churn
+ * are taken into account if it painted more of them than the frame timing journals keep.
+ */
+bool WindowChurnBenchmark::finishMeasuring(const char *name, int windowCount, std::chrono::nanoseconds duration)
+{
+    std::vector<std::chrono::nanoseconds> renderTimes;
+    const auto outputs = kwinApp()->outputBackend()->outputs();
+    for (qsizetype i = 0; i < outputs.size() && i < qsizetype(m_firstSequences.size()); i++) {
+        const FrameTimingJournal *journal = outputs[i]->renderLoop()->frameTimings();
+        if (!journal) {
+            continue;
+        }
+        const QByteArray data = journal->records(m_firstSequences[i], FrameTimingJournal::s_capacity);
+        const auto records = std::span(reinterpret_cast<const FrameTimingRecord *>(data.constData()), data.size() / sizeof(FrameTimingRecord));
+        for (const FrameTimingRecord &record : records) {
+            if (!(record.flags & FrameTimingRecord::Dropped)) {
+                renderTimes.push_back(std::chrono::nanoseconds(record.renderEnd - record.renderStart));
+            }
+        }
+    }
+    std::ranges::sort(renderTimes);
+    const auto percentile = [&renderTimes](double percentile) -> long long {
+        if (renderTimes.empty()) {
+            return 0;
+        }
+        return std::chrono::duration_cast<std::chrono::microseconds>(renderTimes[std::min<size_t>(renderTimes.size() - 1, renderTimes.size() * percentile)]).count();
+    };
+
+    const double windowsPerSecond = windowCount / std::chrono::duration<double>(duration).count();
+    const qint64 peakMemory = peakResidentMemory();
+    qInfo("%s: %d windows in %lldms, %.1f windows/s, %d frames with render time median %lldus, max %lldus, peak RSS %lldMB",
+          name, windowCount, std::chrono::duration_cast<std::chrono::milliseconds>(duration).count(), windowsPerSecond,
+          int(renderTimes.size()), percentile(0.5), percentile(1), peakMemory);
+
+    bool ok = true;
+    if (const int minRate = qEnvironmentVariableIntValue("KWIN_WINDOW_CHURN_MIN_RATE"); minRate > 0 && windowsPerSecond < minRate) {
+        qWarning("%s: %.1f windows/s is below the budget of %d", name, windowsPerSecond, minRate);
+        ok = false;
+    }
+    if (const int maxFrameTime = qEnvironmentVariableIntValue("KWIN_WINDOW_CHURN_MAX_FRAME_TIME_US"); maxFrameTime > 0 && percentile(1) > maxFrameTime) {
+        qWarning("%s: a frame took %lldus, which is above the budget of %dus", name, percentile(1), maxFrameTime);
+        ok = false;
+    }
+    if (const int maxMemory = qEnvironmentVariableIntValue("KWIN_WINDOW_CHURN_MAX_RSS_MB"); maxMemory > 0 && peakMemory > maxMemory) {
+        qWarning("%s: peak RSS of %lldMB is above the budget of %dMB", name, peakMemory, maxMemory);
+        ok = false;
+    }
+    return ok;
+}
+
+void WindowChurnBenchmark::benchmarkMapUnmap()
+{
+    // this simulates applications that create and destroy lots of short-lived windows
+    const int count = windowCount(1000);
+    std::vector<std::unique_ptr<Test::XdgToplevelWindow>> windows;
+    windows.reserve(count);
+
+    startMeasuring();
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < count; i++) {
+        auto window = std::make_unique<Test::XdgToplevelWindow>();
+        QVERIFY(window->show(QSize(64, 64), QColor::fromHsv(i * 9 % 360, 255, 255)));
+        windows.push_back(std::move(window));
+    }
+    QVERIFY(finishMeasuring("map", count, std::chrono::nanoseconds(timer.nsecsElapsed())));
+
+    startMeasuring();
+    timer.restart();
+    for (const auto &window : windows) {
+        QVERIFY(window->unmapAndWaitForClosed());
+    }
+    windows.clear();
+    QVERIFY(Test::waylandSync());
+    QVERIFY(finishMeasuring("unmap", count, std::chrono::nanoseconds(timer.nsecsElapsed())));
+}
+
+void WindowChurnBenchmark::benchmarkSubSurfaceTree()
+{
+    // this simulates clients with deeply nested subsurfaces, like browsers embedding videos in iframes
+    constexpr int depth = 200;
+    Test::XdgToplevelWindow window;
+    QVERIFY(window.show(QSize(800, 600), Qt::blue));
+
+    std::vector<std::unique_ptr<KWayland::Client::Surface>> surfaces;
+    std::vector<std::unique_ptr<KWayland::Client::SubSurface>> subSurfaces;
+    startMeasuring();
+    QElapsedTimer timer;
+    timer.start();
+    KWayland::Client::Surface *parent = window.m_surface.get();
+    for (int i = 0; i < depth; i++) {
+        auto surface = Test::createSurface();
+        auto subSurface = Test::createSubSurface(surface.get(), parent);
+        subSurface->setPosition(QPoint(2, 2));
+        Test::render(surface.get(), QSize(32, 32), QColor::fromHsv(i * 11 % 360, 255, 255));
+        parent = surface.get();
+        surfaces.push_back(std::move(surface));
+        subSurfaces.push_back(std::move(subSurface));
+    }
+    // the subsurfaces are synchronized, committing the parent surface applies the whole tree
+    QVERIFY(window.presentWait());
+    QVERIFY(finishMeasuring("subsurface tree", depth, std::chrono::nanoseconds(timer.nsecsElapsed())));
+
+    startMeasuring();
+    timer.restart();
+    while (!subSurfaces.empty()) {
+        subSurfaces.pop_back();
+        surfaces.pop_back();
+    }
+    QVERIFY(window.presentWait());
+    QVERIFY(finishMeasuring("subsurface tree teardown", depth, std::chrono::nanoseconds(timer.nsecsElapsed())));
+}
+
+void WindowChurnBenchmark::benchmarkDesktopSwitch()
+{
+    // this switches between two virtual desktops that share 500 windows between them
+    const int count = windowCount(1000) / 2;
+    constexpr int switchCount = 50;
+    VirtualDesktopManager::self()->setCount(2);
+    const QList<VirtualDesktop *> desktops = VirtualDesktopManager::self()->desktops();
+    QCOMPARE(desktops.size(), 2);
+
+    std::vector<std::unique_ptr<Test::XdgToplevelWindow>> windows;
+    windows.reserve(count);
+    for (int i = 0; i < count; i++) {
+        auto window = std::make_unique<Test::XdgToplevelWindow>();
+        QVERIFY(window->show(QSize(200, 150), QColor::fromHsv(i * 9 % 360, 255, 255)));
+        workspace()->sendWindowToDesktops(window->m_window, {desktops[i % 2]}, false);
+        windows.push_back(std::move(window));
+    }
+
+    startMeasuring();
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < switchCount; i++) {
+        VirtualDesktopManager::self()->setCurrent(desktops[(i + 1) % 2]);
+        // make sure that the frame with the new desktop gets painted and presented,
+        // otherwise only the last switch would be painted
+        QVERIFY(windows[(i + 1) % 2]->presentWait());
+    }
+    // every switch shows and hides half of the windows
+    QVERIFY(finishMeasuring("desktop switch", switchCount * count, std::chrono::nanoseconds(timer.nsecsElapsed())));
+}
+
+}
+
+WAYLANDTEST_MAIN(KWin::WindowChurnBenchmark)
+#include "window_churn_benchmark.moc"
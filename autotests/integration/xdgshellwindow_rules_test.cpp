@@ -173,6 +173,8 @@ private Q_SLOTS:
 
     void testMatchTransientParent_data();
     void testMatchTransientParent();
+    void testMatchOrder_data();
+    void testMatchOrder();
 
 private:
     void createTestWindow(ClientFlags flags = None);
@@ -3350,5 +3352,53 @@ void TestXdgShellWindowRules::testMatchTransientParent()
     QCOMPARE(windowWithOutParent->keepAbove(), !hasTransientParent);
 }
 
+void TestXdgShellWindowRules::testMatchOrder_data()
+{
+    QTest::addColumn<QStringList>("rules");
+    QTest::addColumn<QPoint>("expectedPosition");
+
+    QTest::newRow("regexp first") << QStringList{QStringLiteral("regexp"), QStringLiteral("exact"), QStringLiteral("other")} << QPoint(10, 10);
+    QTest::newRow("exact first") << QStringList{QStringLiteral("other"), QStringLiteral("exact"), QStringLiteral("regexp")} << QPoint(42, 42);
+}
+
+void TestXdgShellWindowRules::testMatchOrder()
+{
+    // this test verifies that the rules matching a window are applied in the order of the
+    // rule book, no matter how they match the window class
+    QFETCH(QStringList, rules);
+    QFETCH(QPoint, expectedPosition);
+
+    m_config->group(QStringLiteral("General")).writeEntry("rules", rules);
+
+    KConfigGroup regexp = m_config->group(QStringLiteral("regexp"));
+    regexp.writeEntry("position", QPoint(10, 10));
+    regexp.writeEntry("positionrule", int(Rules::Force));
+    regexp.writeEntry("wmclass", "org\\.kde\\..*");
+    regexp.writeEntry("wmclasscomplete", false);
+    regexp.writeEntry("wmclassmatch", int(Rules::RegExpMatch));
+
+    KConfigGroup exact = m_config->group(QStringLiteral("exact"));
+    exact.writeEntry("position", QPoint(42, 42));
+    exact.writeEntry("positionrule", int(Rules::Force));
+    exact.writeEntry("wmclass", "org.kde.foo");
+    exact.writeEntry("wmclasscomplete", false);
+    exact.writeEntry("wmclassmatch", int(Rules::ExactMatch));
+
+    KConfigGroup other = m_config->group(QStringLiteral("other"));
+    other.writeEntry("position", QPoint(100, 100));
+    other.writeEntry("positionrule", int(Rules::Force));
+    other.writeEntry("wmclass", "org.kde.bar");
+    other.writeEntry("wmclasscomplete", false);
+    other.writeEntry("wmclassmatch", int(Rules::ExactMatch));
+    m_config->sync();
+
+    workspace()->slotReconfigure();
+
+    createTestWindow();
+    QCOMPARE(m_window->pos(), expectedPosition);
+
+    destroyTestWindow();
+}
+
 WAYLANDTEST_MAIN(TestXdgShellWindowRules)
 #include "xdgshellwindow_rules_test.moc"
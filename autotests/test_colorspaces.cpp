@@ -49,6 +49,10 @@ private Q_SLOTS:
     void testBlackPointCompensation();
     void testSCRGB();
     void testNightLightNoTonemapping();
+    void testFoldTransferFunctionPair();
+    void testFoldClamps();
+    void testBatchEvaluation_data();
+    void testBatchEvaluation();
 };
 
 static bool compareVectors(const QVector3D &one, const QVector3D &two, float maxDifference)
@@ -690,6 +694,109 @@ void TestColorspaces::testNightLightNoTonemapping()
     QVERIFY(std::holds_alternative<InverseColorTransferFunction>(pipeline.ops[3].operation));
 }
 
+void TestColorspaces::testFoldTransferFunctionPair()
+{
+    // encoding and decoding with the same curve, but different luminance ranges, is just a scaling
+    const TransferFunction encoding(TransferFunction::gamma22, 0, 80);
+    const TransferFunction decoding(TransferFunction::gamma22, 0, 200);
+    ColorPipeline reference(ValueRange{.min = 0, .max = 80}, ColorspaceType::LinearRGB);
+    reference.ops.push_back(ColorOp{
+        .input = ValueRange{.min = 0, .max = 80},
+        .inputSpace = ColorspaceType::LinearRGB,
+        .operation = InverseColorTransferFunction(encoding),
+        .output = ValueRange{.min = 0, .max = 1},
+        .outputSpace = ColorspaceType::NonLinearRGB,
+    });
+    reference.ops.push_back(ColorOp{
+        .input = ValueRange{.min = 0, .max = 1},
+        .inputSpace = ColorspaceType::NonLinearRGB,
+        .operation = ColorTransferFunction(decoding),
+        .output = ValueRange{.min = 0, .max = 200},
+        .outputSpace = ColorspaceType::LinearRGB,
+    });
+
+    ColorPipeline pipeline(ValueRange{.min = 0, .max = 80}, ColorspaceType::LinearRGB);
+    pipeline.addInverseTransferFunction(encoding, ColorspaceType::NonLinearRGB);
+    pipeline.addTransferFunction(decoding, ColorspaceType::LinearRGB);
+    QCOMPARE(pipeline.ops.size(), 1);
+    QVERIFY(std::holds_alternative<ColorMultiplier>(pipeline.ops[0].operation));
+    QCOMPARE(pipeline.currentOutputRange().max, 200.0);
+    for (const QVector3D &color : {QVector3D(0, 0, 0), QVector3D(10, 40, 80), QVector3D(80, 80, 80)}) {
+        QVERIFY(compareVectors(pipeline.evaluate(color), reference.evaluate(color), 0.001));
+    }
+}
+
+void TestColorspaces::testFoldClamps()
+{
+    // inverse transfer functions already clamp to [0; 1]
+    ColorPipeline pipeline(ValueRange{.min = 0, .max = 1000}, ColorspaceType::LinearRGB);
+    pipeline.addInverseTransferFunction(TransferFunction(TransferFunction::PerceptualQuantizer), ColorspaceType::NonLinearRGB);
+    pipeline.addClamp(ValueRange{.min = 0, .max = 1});
+    QCOMPARE(pipeline.ops.size(), 1);
+
+    // clamps at the end of one pipeline and the start of the other one are merged
+    ColorPipeline first(ValueRange{.min = 0, .max = 2}, ColorspaceType::LinearRGB);
+    first.addMultiplier(2);
+    first.addClamp(ValueRange{.min = 0, .max = 3});
+    ColorPipeline second(ValueRange{.min = 0, .max = 3}, ColorspaceType::LinearRGB);
+    second.addClamp(ValueRange{.min = 0, .max = 2});
+    const ColorPipeline merged = first.merged(second);
+    QCOMPARE(merged.ops.size(), 2);
+    QVERIFY(std::holds_alternative<ColorMultiplier>(merged.ops[0].operation));
+    const auto clamp = std::get_if<ColorClamp>(&merged.ops[1].operation);
+    QVERIFY(clamp);
+    QCOMPARE(clamp->m_maxValue, 2.0);
+}
+
+void TestColorspaces::testBatchEvaluation_data()
+{
+    QTest::addColumn<std::shared_ptr<ColorDescription>>("srcColor");
+    QTest::addColumn<std::shared_ptr<ColorDescription>>("dstColor");
+
+    const auto bt2020pq = std::make_shared<ColorDescription>(ColorDescription{
+        Colorimetry::BT2020,
+        TransferFunction(TransferFunction::PerceptualQuantizer),
+        203,
+        0,
+        1000,
+        1000,
+    });
+    const auto bt1886 = std::make_shared<ColorDescription>(ColorDescription{
+        Colorimetry::BT709,
+        TransferFunction(TransferFunction::BT1886, 0.1, 300),
+        300,
+        0.1,
+        std::nullopt,
+        std::nullopt,
+    });
+    QTest::addRow("sRGB -> BT2020 PQ") << ColorDescription::sRGB << bt2020pq;
+    QTest::addRow("BT2020 PQ -> sRGB") << bt2020pq << ColorDescription::sRGB;
+    QTest::addRow("sRGB -> BT1886") << ColorDescription::sRGB << bt1886;
+    QTest::addRow("BT1886 -> BT2020 PQ") << bt1886 << bt2020pq;
+}
+
+void TestColorspaces::testBatchEvaluation()
+{
+    QFETCH(std::shared_ptr<ColorDescription>, srcColor);
+    QFETCH(std::shared_ptr<ColorDescription>, dstColor);
+
+    // evaluating a batch has to give the same results as evaluating the values one by one
+    const ColorPipeline pipeline = ColorPipeline::create(srcColor, dstColor, RenderingIntent::Perceptual);
+    std::vector<QVector3D> values;
+    for (int r = 0; r <= 8; r++) {
+        for (int g = 0; g <= 8; g++) {
+            for (int b = 0; b <= 8; b++) {
+                values.push_back(QVector3D(r, g, b) / 8);
+            }
+        }
+    }
+    std::vector<QVector3D> batch = values;
+    pipeline.evaluate(batch);
+    for (size_t i = 0; i < values.size(); i++) {
+        QVERIFY(compareVectors(batch[i], pipeline.evaluate(values[i]), 0.000001));
+    }
+}
+
 QTEST_MAIN(TestColorspaces)
 
 #include "test_colorspaces.moc"
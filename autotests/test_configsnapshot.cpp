@@ -0,0 +1,77 @@
+/*
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include <QTest>
+
+#include "utils/configsnapshot.h"
+
+#include <KConfigGroup>
+#include <KSharedConfig>
+
+using namespace KWin;
+
+class TestConfigSnapshot : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void unchanged();
+    void changedEntry();
+    void addedAndRemovedGroups();
+    void nestedGroup();
+};
+
+void TestConfigSnapshot::unchanged()
+{
+    auto config = KSharedConfig::openConfig(QString(), KConfig::SimpleConfig);
+    config->group(QStringLiteral("Windows")).writeEntry("FocusPolicy", "ClickToFocus");
+    config->group(QStringLiteral("TabBox")).writeEntry("LayoutName", "thumbnail_grid");
+
+    const ConfigSnapshot before(config.data());
+    const ConfigSnapshot after(config.data());
+    QCOMPARE(before, after);
+    QVERIFY(before.changedGroups(after).isEmpty());
+}
+
+void TestConfigSnapshot::changedEntry()
+{
+    auto config = KSharedConfig::openConfig(QString(), KConfig::SimpleConfig);
+    config->group(QStringLiteral("Windows")).writeEntry("FocusPolicy", "ClickToFocus");
+    config->group(QStringLiteral("TabBox")).writeEntry("LayoutName", "thumbnail_grid");
+    const ConfigSnapshot before(config.data());
+
+    config->group(QStringLiteral("TabBox")).writeEntry("LayoutName", "compact");
+    const ConfigSnapshot after(config.data());
+    QCOMPARE(before.changedGroups(after), QSet<QString>{QStringLiteral("TabBox")});
+}
+
+void TestConfigSnapshot::addedAndRemovedGroups()
+{
+    auto config = KSharedConfig::openConfig(QString(), KConfig::SimpleConfig);
+    config->group(QStringLiteral("Windows")).writeEntry("FocusPolicy", "ClickToFocus");
+    const ConfigSnapshot before(config.data());
+
+    config->deleteGroup(QStringLiteral("Windows"));
+    config->group(QStringLiteral("Plugins")).writeEntry("blurEnabled", false);
+    const ConfigSnapshot after(config.data());
+    QCOMPARE(before.changedGroups(after), (QSet<QString>{QStringLiteral("Windows"), QStringLiteral("Plugins")}));
+    QCOMPARE(after.changedGroups(before), (QSet<QString>{QStringLiteral("Windows"), QStringLiteral("Plugins")}));
+}
+
+void TestConfigSnapshot::nestedGroup()
+{
+    auto config = KSharedConfig::openConfig(QString(), KConfig::SimpleConfig);
+    config->group(QStringLiteral("Script-foo")).group(QStringLiteral("General")).writeEntry("Enabled", true);
+    const ConfigSnapshot before(config.data());
+
+    config->group(QStringLiteral("Script-foo")).group(QStringLiteral("General")).writeEntry("Enabled", false);
+    const ConfigSnapshot after(config.data());
+    QCOMPARE(before.changedGroups(after), QSet<QString>{QStringLiteral("Script-foo")});
+}
+
+QTEST_GUILESS_MAIN(TestConfigSnapshot)
+
+#include "test_configsnapshot.moc"
@@ -0,0 +1,57 @@
+/*
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include <QTest>
+
+#include "utils/framearena.h"
+
+#include <vector>
+
+using namespace KWin;
+
+class TestFrameArena : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void reuse();
+    void grow();
+};
+
+void TestFrameArena::reuse()
+{
+    FrameArena arena(4096);
+
+    const void *first = nullptr;
+    {
+        std::pmr::vector<int> values(arena.resource());
+        values.reserve(16);
+        first = values.data();
+    }
+    arena.reset();
+
+    std::pmr::vector<int> values(arena.resource());
+    values.reserve(16);
+    QCOMPARE(values.data(), first);
+    QCOMPARE(arena.capacity(), size_t(4096));
+}
+
+void TestFrameArena::grow()
+{
+    FrameArena arena(1024);
+    {
+        std::pmr::vector<int> values(arena.resource());
+        values.resize(4096);
+    }
+    QCOMPARE(arena.capacity(), size_t(1024));
+
+    arena.reset();
+    QVERIFY(arena.capacity() >= 4096 * sizeof(int));
+}
+
+QTEST_GUILESS_MAIN(TestFrameArena)
+
+#include "test_framearena.moc"
@@ -0,0 +1,128 @@
+/*
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include <QTemporaryDir>
+#include <QTest>
+
+#include "core/frametimingjournal.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+using namespace KWin;
+
+class TestFrameTimingJournal : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void empty();
+    void wrapAround();
+    void batches();
+    void file();
+};
+
+static FrameTimingRecord makeRecord(int64_t target)
+{
+    FrameTimingRecord record{};
+    record.targetPresentation = target;
+    return record;
+}
+
+static QList<FrameTimingRecord> unpack(const QByteArray &data)
+{
+    Q_ASSERT(data.size() % sizeof(FrameTimingRecord) == 0);
+    QList<FrameTimingRecord> ret(data.size() / sizeof(FrameTimingRecord));
+    std::memcpy(ret.data(), data.constData(), data.size());
+    return ret;
+}
+
+void TestFrameTimingJournal::empty()
+{
+    FrameTimingJournal journal(QStringLiteral("test"));
+    QCOMPARE(journal.lastSequence(), 0u);
+    QVERIFY(journal.records(0, 100).isEmpty());
+}
+
+void TestFrameTimingJournal::wrapAround()
+{
+    FrameTimingJournal journal(QStringLiteral("test"));
+    const uint32_t total = FrameTimingJournal::s_capacity + 10;
+    for (uint32_t i = 1; i <= total; i++) {
+        journal.add(makeRecord(i));
+    }
+    QCOMPARE(journal.lastSequence(), uint64_t(total));
+
+    // the oldest records have been overwritten
+    const auto records = unpack(journal.records(0, total));
+    QCOMPARE(records.size(), qsizetype(FrameTimingJournal::s_capacity));
+    QCOMPARE(records.front().sequence, 11u);
+    QCOMPARE(records.front().targetPresentation, 11);
+    QCOMPARE(records.back().sequence, uint64_t(total));
+    QCOMPARE(records.back().targetPresentation, int64_t(total));
+}
+
+void TestFrameTimingJournal::batches()
+{
+    FrameTimingJournal journal(QStringLiteral("test"));
+    for (int i = 1; i <= 20; i++) {
+        journal.add(makeRecord(i * 100));
+    }
+
+    auto records = unpack(journal.records(5, 3));
+    QCOMPARE(records.size(), 3);
+    QCOMPARE(records[0].sequence, 5u);
+    QCOMPARE(records[0].targetPresentation, 500);
+    QCOMPARE(records[2].sequence, 7u);
+
+    records = unpack(journal.records(18, 10));
+    QCOMPARE(records.size(), 3);
+    QCOMPARE(records.back().sequence, 20u);
+
+    QVERIFY(journal.records(21, 10).isEmpty());
+}
+
+void TestFrameTimingJournal::file()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    qputenv("KWIN_FRAME_TIMINGS_DIR", dir.path().toLocal8Bit());
+
+    QString path;
+    {
+        FrameTimingJournal journal(QStringLiteral("test"));
+        qunsetenv("KWIN_FRAME_TIMINGS_DIR");
+        path = journal.filePath();
+        QVERIFY(!path.isEmpty());
+        journal.add(makeRecord(42));
+
+        // another process should be able to map the file and read the records
+        const int fd = open(qPrintable(path), O_RDONLY | O_CLOEXEC);
+        QVERIFY(fd >= 0);
+        const size_t size = sizeof(FrameTimingJournal::Header) + FrameTimingJournal::s_capacity * sizeof(FrameTimingRecord);
+        void *data = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+        close(fd);
+        QVERIFY(data != MAP_FAILED);
+
+        const auto header = static_cast<const FrameTimingJournal::Header *>(data);
+        QCOMPARE(header->magic, FrameTimingJournal::s_magic);
+        QCOMPARE(header->version, FrameTimingJournal::s_version);
+        QCOMPARE(header->recordSize, uint32_t(sizeof(FrameTimingRecord)));
+        QCOMPARE(header->capacity, FrameTimingJournal::s_capacity);
+        QCOMPARE(header->lastSequence, 1u);
+        const auto records = reinterpret_cast<const FrameTimingRecord *>(static_cast<const char *>(data) + sizeof(FrameTimingJournal::Header));
+        QCOMPARE(records[1].sequence, 1u);
+        QCOMPARE(records[1].targetPresentation, 42);
+        munmap(data, size);
+    }
+    // the file is removed together with the journal
+    QVERIFY(!QFile::exists(path));
+}
+
+QTEST_GUILESS_MAIN(TestFrameTimingJournal)
+
+#include "test_frametimingjournal.moc"
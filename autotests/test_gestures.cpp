@@ -12,6 +12,8 @@
 #include <QTest>
 #include <QtWidgets/qaction.h>
 #include <iostream>
+#include <memory>
+#include <vector>
 
 using namespace KWin;
 
@@ -33,6 +35,8 @@ private Q_SLOTS:
     void testMinimumDeltaReached_data();
     void testMinimumDeltaReached();
     void testNotEmitCallbacksBeforeDirectionDecided();
+    void benchmarkSwipeUpdate();
+    void benchmarkPinchUpdate();
 };
 
 void GestureTest::testMinimumDeltaReached_data()
@@ -305,5 +309,51 @@ void GestureTest::testNotEmitCallbacksBeforeDirectionDecided()
     QCOMPARE(contractSpy.count(), 1);
 }
 
+void GestureTest::benchmarkSwipeUpdate()
+{
+    // a high rate touchpad sends hundreds of updates per second, with gestures
+    // registered for every direction and finger count
+    GestureRecognizer recognizer;
+    std::vector<std::unique_ptr<SwipeGesture>> gestures;
+    for (uint fingerCount = 3; fingerCount <= 4; fingerCount++) {
+        for (SwipeDirection direction : {SwipeDirection::Up, SwipeDirection::Down, SwipeDirection::Left, SwipeDirection::Right}) {
+            auto gesture = std::make_unique<SwipeGesture>(fingerCount);
+            gesture->setDirection(direction);
+            recognizer.registerSwipeGesture(gesture.get());
+            gestures.push_back(std::move(gesture));
+        }
+    }
+
+    QBENCHMARK {
+        recognizer.startSwipeGesture(3);
+        for (int i = 0; i < 100; i++) {
+            recognizer.updateSwipeGesture(QPointF(1, 0.1));
+        }
+        recognizer.endSwipeGesture();
+    }
+}
+
+void GestureTest::benchmarkPinchUpdate()
+{
+    GestureRecognizer recognizer;
+    std::vector<std::unique_ptr<PinchGesture>> gestures;
+    for (uint fingerCount = 3; fingerCount <= 4; fingerCount++) {
+        for (PinchDirection direction : {PinchDirection::Expanding, PinchDirection::Contracting}) {
+            auto gesture = std::make_unique<PinchGesture>(fingerCount);
+            gesture->setDirection(direction);
+            recognizer.registerPinchGesture(gesture.get());
+            gestures.push_back(std::move(gesture));
+        }
+    }
+
+    QBENCHMARK {
+        recognizer.startPinchGesture(4);
+        for (int i = 0; i < 100; i++) {
+            recognizer.updatePinchGesture(1 + i * 0.01, 0, QPointF());
+        }
+        recognizer.endPinchGesture();
+    }
+}
+
 QTEST_MAIN(GestureTest)
 #include "test_gestures.moc"
@@ -161,6 +161,22 @@ static QList<Region> enumerateRegions(const QSize &gridSize, const QSize &unit =
     return regions;
 }
 
+/**
+ * Returns a region that looks like a checkerboard with @a size by @a size cells, which is
+ * roughly what the damage looks like when many small windows and subsurfaces are updated.
+ */
+static Region checkerboardRegion(int size, int cellSize = 16)
+{
+    QList<Rect> rects;
+    rects.reserve(size * size / 2 + 1);
+    for (int y = 0; y < size; ++y) {
+        for (int x = y % 2; x < size; x += 2) {
+            rects.append(Rect(x * cellSize, y * cellSize, cellSize, cellSize));
+        }
+    }
+    return Region::fromSortedRects(rects);
+}
+
 static QSize testGridSize()
 {
     const QString text = qEnvironmentVariable("KWIN_TEST_REGION_GRID_SIZE");
@@ -214,6 +230,9 @@ private Q_SLOTS:
     void fromAndToQRegion();
     void grownBy_data();
     void grownBy();
+    void benchmarkIntersectsRect();
+    void benchmarkIntersectsRegion();
+    void benchmarkContainsRect();
 
 private:
     const QSize gridSize = testGridSize();
@@ -679,6 +698,40 @@ void TestRegion::grownBy()
     QTEST(region.grownBy(margins), "expected");
 }
 
+void TestRegion::benchmarkIntersectsRect()
+{
+    const Region region = checkerboardRegion(64);
+    // a rect that covers a gap in the bottom-right corner of the checkerboard
+    const Rect rect(63 * 16, 62 * 16, 16, 16);
+    QVERIFY(!region.intersects(rect));
+
+    QBENCHMARK {
+        region.intersects(rect);
+    }
+}
+
+void TestRegion::benchmarkIntersectsRegion()
+{
+    const Region region = checkerboardRegion(64);
+    const Region other = region.translated(16, 0) & Region(Rect(0, 0, 64 * 16, 64 * 16));
+    QVERIFY(!region.intersects(other));
+
+    QBENCHMARK {
+        region.intersects(other);
+    }
+}
+
+void TestRegion::benchmarkContainsRect()
+{
+    const Region region = checkerboardRegion(64) | Region(Rect(0, 32 * 16, 64 * 16, 16));
+    const Rect rect(0, 32 * 16, 64 * 16, 16);
+    QVERIFY(region.contains(rect));
+
+    QBENCHMARK {
+        region.contains(rect);
+    }
+}
+
 QTEST_MAIN(TestRegion)
 
 #include "test_region.moc"
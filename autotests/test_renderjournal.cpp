@@ -0,0 +1,87 @@
+/*
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include <QTest>
+
+#include "core/renderjournal.h"
+
+using namespace KWin;
+using namespace std::chrono_literals;
+
+class TestRenderJournal : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void empty();
+    void percentile();
+    void singleSpike();
+    void workloads();
+    void outdated();
+};
+
+void TestRenderJournal::empty()
+{
+    RenderJournal journal(0.95);
+    QCOMPARE(journal.result(), 0ns);
+    QCOMPARE(journal.result(RenderWorkload::Effects), 0ns);
+}
+
+void TestRenderJournal::percentile()
+{
+    RenderJournal journal(0.5);
+    std::chrono::nanoseconds timestamp = 1s;
+    for (int i = 1; i <= 10; i++) {
+        journal.add(std::chrono::milliseconds(i), timestamp);
+        timestamp += 16ms;
+    }
+    QCOMPARE(journal.result(), 5ms);
+}
+
+void TestRenderJournal::singleSpike()
+{
+    RenderJournal journal(0.95);
+    std::chrono::nanoseconds timestamp = 1s;
+    for (size_t i = 0; i < RenderJournal::s_historySize; i++) {
+        journal.add(i == 10 ? 20ms : 2ms, timestamp);
+        timestamp += 16ms;
+    }
+    // a single slow frame should not affect the estimate
+    QCOMPARE(journal.result(), 2ms);
+
+    // but once it has left the history, it must not affect it either
+    for (size_t i = 0; i < RenderJournal::s_historySize; i++) {
+        journal.add(3ms, timestamp);
+        timestamp += 16ms;
+    }
+    QCOMPARE(journal.result(), 3ms);
+}
+
+void TestRenderJournal::workloads()
+{
+    RenderJournal journal(0.95);
+    journal.add(4ms, 1s, RenderWorkload::Composited);
+    // no data yet, fall back to composited
+    QCOMPARE(journal.result(RenderWorkload::DirectScanout), 4ms);
+
+    journal.add(1ms, 1s + 16ms, RenderWorkload::DirectScanout);
+    journal.add(8ms, 1s + 32ms, RenderWorkload::Effects);
+    QCOMPARE(journal.result(RenderWorkload::Composited), 4ms);
+    QCOMPARE(journal.result(RenderWorkload::DirectScanout), 1ms);
+    QCOMPARE(journal.result(RenderWorkload::Effects), 8ms);
+}
+
+void TestRenderJournal::outdated()
+{
+    RenderJournal journal(0.95);
+    journal.add(10ms, 1s);
+    journal.add(2ms, 20s);
+    QCOMPARE(journal.result(), 2ms);
+}
+
+QTEST_GUILESS_MAIN(TestRenderJournal)
+
+#include "test_renderjournal.moc"
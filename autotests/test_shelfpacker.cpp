@@ -0,0 +1,98 @@
+/*
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include <QTest>
+
+#include "scene/shelfpacker.h"
+
+using namespace KWin;
+
+class TestShelfPacker : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void noOverlap();
+    void tooBig();
+    void reuseShelf();
+    void grow();
+};
+
+void TestShelfPacker::noOverlap()
+{
+    ShelfPacker packer(QSize(256, 256));
+
+    QList<Rect> rects;
+    for (int i = 0; i < 40; ++i) {
+        const auto rect = packer.allocate(QSize(10 + (i * 7) % 30, 10 + (i * 13) % 30));
+        QVERIFY(rect.has_value());
+        QVERIFY(Rect(0, 0, 256, 256).contains(*rect));
+        for (const Rect &other : std::as_const(rects)) {
+            QVERIFY(!rect->intersects(other));
+        }
+        rects.append(*rect);
+    }
+    QVERIFY(!packer.isEmpty());
+
+    for (const Rect &rect : std::as_const(rects)) {
+        packer.free(rect);
+    }
+    QVERIFY(packer.isEmpty());
+    QCOMPARE(packer.usedArea(), qint64(0));
+}
+
+void TestShelfPacker::tooBig()
+{
+    ShelfPacker packer(QSize(64, 64));
+    QVERIFY(!packer.allocate(QSize(65, 10)).has_value());
+    QVERIFY(!packer.allocate(QSize(10, 65)).has_value());
+    QVERIFY(!packer.allocate(QSize(0, 10)).has_value());
+
+    QVERIFY(packer.allocate(QSize(64, 40)).has_value());
+    // only 24 pixels are left below the first shelf
+    QVERIFY(!packer.allocate(QSize(10, 30)).has_value());
+    QVERIFY(packer.allocate(QSize(10, 24)).has_value());
+}
+
+void TestShelfPacker::reuseShelf()
+{
+    ShelfPacker packer(QSize(64, 64));
+
+    const auto a = packer.allocate(QSize(32, 32));
+    const auto b = packer.allocate(QSize(32, 32));
+    const auto c = packer.allocate(QSize(64, 32));
+    QVERIFY(a && b && c);
+    QVERIFY(!packer.allocate(QSize(16, 16)).has_value());
+
+    // the first shelf is still used by the second rect
+    packer.free(*a);
+    QVERIFY(!packer.allocate(QSize(16, 16)).has_value());
+    QCOMPARE(packer.fragmentation(), 0.25);
+
+    // once the shelf is empty, it can be used for smaller rects
+    packer.free(*b);
+    const auto d = packer.allocate(QSize(16, 16));
+    QVERIFY(d.has_value());
+    QCOMPARE(d->topLeft(), QPoint(0, 0));
+}
+
+void TestShelfPacker::grow()
+{
+    ShelfPacker packer(QSize(32, 32));
+
+    const auto a = packer.allocate(QSize(32, 32));
+    QVERIFY(a.has_value());
+    QVERIFY(!packer.allocate(QSize(32, 32)).has_value());
+
+    packer.grow(QSize(64, 64));
+    QCOMPARE(packer.size(), QSize(64, 64));
+    const auto b = packer.allocate(QSize(32, 32));
+    QVERIFY(b.has_value());
+    QVERIFY(!a->intersects(*b));
+}
+
+QTEST_GUILESS_MAIN(TestShelfPacker)
+#include "test_shelfpacker.moc"
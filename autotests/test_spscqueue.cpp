@@ -0,0 +1,104 @@
+/*
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include <QTest>
+
+#include "utils/spscqueue.h"
+
+#include <memory>
+#include <thread>
+
+using namespace KWin;
+
+class TestSpscQueue : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void order();
+    void full();
+    void peek();
+    void threads();
+};
+
+void TestSpscQueue::order()
+{
+    SpscQueue<std::unique_ptr<int>, 4> queue;
+    QVERIFY(!queue.pop());
+    for (int round = 0; round < 3; round++) {
+        // wrap around a couple of times
+        for (int i = 0; i < 3; i++) {
+            QVERIFY(queue.push(std::make_unique<int>(i)));
+        }
+        for (int i = 0; i < 3; i++) {
+            std::optional<std::unique_ptr<int>> value = queue.pop();
+            QVERIFY(value);
+            QCOMPARE(**value, i);
+        }
+        QVERIFY(!queue.pop());
+    }
+}
+
+void TestSpscQueue::full()
+{
+    SpscQueue<std::unique_ptr<int>, 2> queue;
+    QVERIFY(queue.push(std::make_unique<int>(0)));
+    QVERIFY(queue.push(std::make_unique<int>(1)));
+    QVERIFY(queue.isFull());
+
+    // a value that doesn't fit anymore is left to the caller
+    auto value = std::make_unique<int>(2);
+    QVERIFY(!queue.push(std::move(value)));
+    QVERIFY(value);
+
+    QCOMPARE(**queue.pop(), 0);
+    QVERIFY(!queue.isFull());
+    QVERIFY(queue.push(std::move(value)));
+    QCOMPARE(**queue.pop(), 1);
+    QCOMPARE(**queue.pop(), 2);
+}
+
+void TestSpscQueue::peek()
+{
+    SpscQueue<int, 4> queue;
+    QCOMPARE(queue.peek(), nullptr);
+    QVERIFY(queue.push(1));
+    QVERIFY(queue.push(2));
+    QCOMPARE(*queue.peek(), 1);
+    QCOMPARE(*queue.peek(1), 2);
+    QCOMPARE(queue.peek(2), nullptr);
+    QCOMPARE(*queue.pop(), 1);
+    QCOMPARE(*queue.peek(), 2);
+}
+
+void TestSpscQueue::threads()
+{
+    constexpr int count = 100000;
+    SpscQueue<int, 64> queue;
+    std::thread producer([&queue]() {
+        for (int i = 0; i < count; i++) {
+            while (!queue.push(int(i))) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    int expected = 0;
+    while (expected < count) {
+        if (std::optional<int> value = queue.pop()) {
+            QCOMPARE(*value, expected);
+            expected++;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+    QVERIFY(!queue.pop());
+}
+
+QTEST_GUILESS_MAIN(TestSpscQueue)
+
+#include "test_spscqueue.moc"
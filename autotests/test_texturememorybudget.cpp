@@ -0,0 +1,150 @@
+/*
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include <QTest>
+
+#include "scene/texturememorybudget.h"
+
+#include <thread>
+
+using namespace KWin;
+using namespace std::chrono_literals;
+
+class TestTextureMemoryBudget : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void usage();
+    void evictLeastRecentlyUsed();
+    void nonEvictable();
+    void minimumAge();
+    void destroyDuringEviction();
+};
+
+void TestTextureMemoryBudget::usage()
+{
+    TextureMemoryBudget budget(1000, 0ms);
+
+    auto a = budget.track(QStringLiteral("a"));
+    auto b = budget.track(QStringLiteral("b"));
+    auto c = budget.track(QStringLiteral("b"));
+    a->setSize(100);
+    b->setSize(200);
+    c->setSize(300);
+    QCOMPARE(budget.usage(), size_t(600));
+
+    const auto byOwner = budget.usageByOwner();
+    QCOMPARE(byOwner.size(), size_t(2));
+    QCOMPARE(byOwner.at(QStringLiteral("a")), size_t(100));
+    QCOMPARE(byOwner.at(QStringLiteral("b")), size_t(500));
+
+    c->setSize(50);
+    QCOMPARE(budget.usage(), size_t(350));
+
+    b.reset();
+    QCOMPARE(budget.usage(), size_t(150));
+}
+
+void TestTextureMemoryBudget::evictLeastRecentlyUsed()
+{
+    TextureMemoryBudget budget(1000, 0ms);
+
+    QStringList evicted;
+    auto track = [&budget, &evicted](const QString &owner) {
+        return budget.track(owner, [owner, &evicted]() {
+            evicted.append(owner);
+        });
+    };
+
+    auto a = track(QStringLiteral("a"));
+    auto b = track(QStringLiteral("b"));
+    auto c = track(QStringLiteral("c"));
+
+    a->setSize(400);
+    std::this_thread::sleep_for(1ms);
+    b->setSize(400);
+    b->markUsed();
+    std::this_thread::sleep_for(1ms);
+    a->markUsed();
+    QVERIFY(evicted.isEmpty());
+
+    // b is the least recently used allocation, and releasing it is enough
+    std::this_thread::sleep_for(1ms);
+    c->setSize(400);
+    QCOMPARE(evicted, QStringList{QStringLiteral("b")});
+    QCOMPARE(b->size(), size_t(0));
+    QCOMPARE(budget.usage(), size_t(800));
+
+    // shrinking the budget evicts a, then c
+    evicted.clear();
+    c->markUsed();
+    budget.setBudget(0);
+    QCOMPARE(evicted, (QStringList{QStringLiteral("a"), QStringLiteral("c")}));
+    QCOMPARE(budget.usage(), size_t(0));
+}
+
+void TestTextureMemoryBudget::nonEvictable()
+{
+    TextureMemoryBudget budget(1000, 0ms);
+
+    bool evicted = false;
+    auto thumbnail = budget.track(QStringLiteral("thumbnail"));
+    auto cache = budget.track(QStringLiteral("cache"), [&evicted]() {
+        evicted = true;
+    });
+
+    cache->setSize(500);
+    std::this_thread::sleep_for(1ms);
+    thumbnail->setSize(2000);
+    QVERIFY(evicted);
+    QVERIFY(!thumbnail->isEvictable());
+    QCOMPARE(thumbnail->size(), size_t(2000));
+    QCOMPARE(budget.usage(), size_t(2000));
+}
+
+void TestTextureMemoryBudget::minimumAge()
+{
+    TextureMemoryBudget budget(1000, 1h);
+
+    bool evicted = false;
+    auto cache = budget.track(QStringLiteral("cache"), [&evicted]() {
+        evicted = true;
+    });
+
+    // recently used memory is kept even if it exceeds the budget
+    cache->setSize(2000);
+    QVERIFY(!evicted);
+    QCOMPARE(budget.usage(), size_t(2000));
+}
+
+void TestTextureMemoryBudget::destroyDuringEviction()
+{
+    TextureMemoryBudget budget(1000, 0ms);
+
+    std::unique_ptr<TextureMemoryAllocation> a;
+    std::unique_ptr<TextureMemoryAllocation> b;
+    a = budget.track(QStringLiteral("a"), [&a, &b]() {
+        a.reset();
+        b.reset();
+    });
+    b = budget.track(QStringLiteral("b"), []() {
+        QFAIL("b has already been destroyed");
+    });
+
+    a->setSize(400);
+    std::this_thread::sleep_for(1ms);
+    b->setSize(400);
+    std::this_thread::sleep_for(1ms);
+    budget.setBudget(100);
+    QVERIFY(!a);
+    QVERIFY(!b);
+    QCOMPARE(budget.usage(), size_t(0));
+}
+
+QTEST_GUILESS_MAIN(TestTextureMemoryBudget)
+
+#include "test_texturememorybudget.moc"
@@ -0,0 +1,103 @@
+/*
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include <QTest>
+
+#include "core/vblankestimator.h"
+
+#include <random>
+
+using namespace KWin;
+using namespace std::chrono_literals;
+
+class TestVblankEstimator : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void unlocked();
+    void jitter();
+    void drift();
+    void missedVblanks();
+    void pause();
+};
+
+void TestVblankEstimator::unlocked()
+{
+    VblankEstimator estimator;
+    estimator.reset(16'666'667ns);
+    QVERIFY(!estimator.isLocked());
+    QCOMPARE(estimator.period(), 16'666'667ns);
+    // without any timestamps, there's nothing to align to
+    QCOMPARE(estimator.nearestVblank(1s), 1s);
+}
+
+void TestVblankEstimator::jitter()
+{
+    // the timestamps are up to 1ms off, but the estimate should still be close to the real vblanks
+    const std::chrono::nanoseconds period = 16'666'667ns;
+    const std::chrono::nanoseconds phase = 5'000'000ns;
+    VblankEstimator estimator;
+    estimator.reset(period);
+
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<int64_t> jitter(-1'000'000, 1'000'000);
+    for (int i = 0; i < 600; i++) {
+        estimator.addTimestamp(phase + i * period + std::chrono::nanoseconds(jitter(generator)));
+    }
+    QVERIFY(estimator.isLocked());
+    QVERIFY(std::chrono::abs(estimator.period() - period) < 10us);
+    const std::chrono::nanoseconds vblank = phase + 601 * period;
+    QVERIFY(std::chrono::abs(estimator.nearestVblank(vblank + 3ms) - vblank) < 500us);
+}
+
+void TestVblankEstimator::drift()
+{
+    // the real refresh rate is a bit lower than the nominal one
+    const std::chrono::nanoseconds period = 16'700'000ns;
+    VblankEstimator estimator;
+    estimator.reset(16'666'667ns);
+    for (int i = 0; i < 1000; i++) {
+        estimator.addTimestamp(1s + i * period);
+    }
+    QVERIFY(estimator.isLocked());
+    QVERIFY(std::chrono::abs(estimator.period() - period) < 1us);
+    const std::chrono::nanoseconds vblank = 1s + 1100 * period;
+    QVERIFY(std::chrono::abs(estimator.nearestVblank(vblank) - vblank) < 100us);
+}
+
+void TestVblankEstimator::missedVblanks()
+{
+    // if frames are only presented every few vblanks, they should still be tracked
+    const std::chrono::nanoseconds period = 10ms;
+    VblankEstimator estimator;
+    estimator.reset(period);
+    for (int i = 0; i < 100; i++) {
+        estimator.addTimestamp(1s + (i * 3) * period);
+    }
+    QVERIFY(estimator.isLocked());
+    QCOMPARE(estimator.nearestVblank(1s + 400 * period + 2ms), 1s + 400 * period);
+}
+
+void TestVblankEstimator::pause()
+{
+    const std::chrono::nanoseconds period = 10ms;
+    VblankEstimator estimator;
+    estimator.reset(period);
+    for (int i = 0; i < 20; i++) {
+        estimator.addTimestamp(1s + i * period);
+    }
+    QVERIFY(estimator.isLocked());
+
+    // after a long pause, the phase can't be trusted anymore
+    estimator.addTimestamp(100s + 3ms);
+    QVERIFY(!estimator.isLocked());
+    QCOMPARE(estimator.nearestVblank(100s + 13ms), 100s + 13ms);
+}
+
+QTEST_GUILESS_MAIN(TestVblankEstimator)
+
+#include "test_vblankestimator.moc"
@@ -1952,6 +1952,23 @@ void TestWaylandSeat::testKeymap()
     address = reinterpret_cast<char *>(file.map(0, keymapChangedSpy.first().last().value<quint32>()));
     QVERIFY(address);
     QCOMPARE(qstrcmp(address, "bar"), 0);
+    file.close();
+
+    // setting the same keymap again doesn't send it
+    keymapChangedSpy.clear();
+    m_seatInterface->keyboard()->setKeymap(QByteArrayLiteral("bar"));
+    QVERIFY(!keymapChangedSpy.wait(100));
+
+    // switching back to a previous keymap sends it again
+    m_seatInterface->keyboard()->setKeymap(QByteArrayLiteral("foo"));
+    QVERIFY(keymapChangedSpy.wait());
+    fd = keymapChangedSpy.first().first().toInt();
+    QVERIFY(fd != -1);
+    QCOMPARE(keymapChangedSpy.first().last().value<quint32>(), 4u);
+    QVERIFY(file.open(fd, QIODevice::ReadOnly));
+    address = reinterpret_cast<char *>(file.map(0, keymapChangedSpy.first().last().value<quint32>()));
+    QVERIFY(address);
+    QCOMPARE(qstrcmp(address, "foo"), 0);
 }
 
 QTEST_GUILESS_MAIN(TestWaylandSeat)
@@ -535,6 +535,11 @@ void TestWindowManagement::testGeometry()
     QVERIFY(windowGeometryChangedSpy.wait());
     QCOMPARE(windowGeometryChangedSpy.count(), 2);
     QCOMPARE(m_window->geometry(), QRect(0, 0, 35, 45));
+    // geometry changes in a row should only send the latest geometry, which the client already has
+    m_windowInterface->setGeometry(QRect(5, 5, 10, 10));
+    m_windowInterface->setGeometry(QRect(0, 0, 35, 45));
+    QVERIFY(!windowGeometryChangedSpy.wait(100));
+    QCOMPARE(windowGeometryChangedSpy.count(), 2);
 
     // let's bind a second PlasmaWindowManagement to verify the initial setting
     std::unique_ptr<KWayland::Client::PlasmaWindowManagement> pm(
@@ -562,6 +567,11 @@ void TestWindowManagement::testIcon()
     QCOMPARE(iconChangedSpy.count(), 1);
     QCOMPARE(m_window->icon().pixmap(32, 32), dummyIcon.pixmap(32, 32));
 
+    // setting the same icon again shouldn't make the clients fetch it again
+    m_windowInterface->setIcon(dummyIcon);
+    QVERIFY(!iconChangedSpy.wait(100));
+    QCOMPARE(iconChangedSpy.count(), 1);
+
     // let's set a themed icon
     m_windowInterface->setIcon(QIcon::fromTheme(QStringLiteral("wayland")));
     QVERIFY(iconChangedSpy.wait());
@@ -8,6 +8,7 @@
 #include <QTest>
 // WaylandServer
 #include "wayland/clientconnection.h"
+#include "wayland/commitlatency.h"
 #include "wayland/display.h"
 // Wayland
 #include <wayland-server.h>
@@ -16,6 +17,8 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <array>
+
 using namespace KWin;
 
 class TestWaylandServerDisplay : public QObject
@@ -27,6 +30,9 @@ private Q_SLOTS:
     void testClientConnection();
     void testConnectNoSocket();
     void testAutoSocketName();
+    void testRequestAccounting();
+    void testCommitLatency();
+    void testInputLatency();
 };
 
 void TestWaylandServerDisplay::testSocketName()
@@ -168,5 +174,128 @@ void TestWaylandServerDisplay::testAutoSocketName()
     QCOMPARE(socketNameChangedSpy1.count(), 1);
 }
 
+void TestWaylandServerDisplay::testRequestAccounting()
+{
+    KWin::Display display;
+    display.start();
+    display.setDispatchBudget(std::chrono::microseconds::zero(), 3);
+    QCOMPARE(display.dispatchRequestBudget(), 3u);
+
+    int sv[2];
+    QVERIFY(socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, sv) >= 0);
+    ClientConnection *connection = display.createClient(sv[0]);
+    QVERIFY(connection);
+    QCOMPARE(connection->requestCount(), quint64(0));
+
+    // send wl_display.sync requests, the header is the object id followed by the message size and the opcode
+    const auto sendSyncRequests = [&sv](uint32_t firstId, int count) {
+        for (int i = 0; i < count; ++i) {
+            const std::array<uint32_t, 3> message{1, (12 << 16) | 0, firstId + i};
+            QCOMPARE(write(sv[1], message.data(), sizeof(message)), ssize_t(sizeof(message)));
+        }
+    };
+
+    sendSyncRequests(2, 2);
+    display.dispatchEvents();
+    QCOMPARE(connection->requestCount(), quint64(2));
+    QCOMPARE(connection->lastDispatchRequestCount(), 2u);
+    QCOMPARE(connection->budgetExceededCount(), quint64(0));
+
+    sendSyncRequests(4, 5);
+    display.dispatchEvents();
+    QCOMPARE(connection->requestCount(), quint64(7));
+    QCOMPARE(connection->lastDispatchRequestCount(), 5u);
+    QCOMPARE(connection->budgetExceededCount(), quint64(1));
+
+    connection->destroy();
+    close(sv[0]);
+    close(sv[1]);
+}
+
+void TestWaylandServerDisplay::testCommitLatency()
+{
+    KWin::Display display;
+    display.start();
+
+    int sv[2];
+    QVERIFY(socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, sv) >= 0);
+    ClientConnection *connection = display.createClient(sv[0]);
+    QVERIFY(connection);
+
+    const auto &statistics = connection->commitLatency();
+    QCOMPARE(statistics.histogram(CommitLatencyStatistics::Stage::Total).count(), quint64(0));
+    QCOMPARE(statistics.histogram(CommitLatencyStatistics::Stage::Total).percentile(0.5), std::chrono::nanoseconds::zero());
+
+    const auto now = std::chrono::steady_clock::now();
+    const CommitTimings timings{
+        .committed = now - std::chrono::milliseconds(3),
+        .fencesSignaled = now - std::chrono::milliseconds(2),
+        .applied = now - std::chrono::microseconds(100),
+    };
+
+    // a presented feedback records every stage
+    {
+        CommitLatencyFeedback feedback(connection, timings);
+        feedback.presented(std::chrono::milliseconds(16), (now + std::chrono::milliseconds(10)).time_since_epoch(), PresentationMode::VSync);
+    }
+    QCOMPARE(statistics.histogram(CommitLatencyStatistics::Stage::Fences).count(), quint64(1));
+    QCOMPARE(statistics.histogram(CommitLatencyStatistics::Stage::Fences).percentile(1.0), std::chrono::milliseconds(1));
+    QCOMPARE(statistics.histogram(CommitLatencyStatistics::Stage::Queue).percentile(1.0), std::chrono::milliseconds(2));
+    QCOMPARE(statistics.histogram(CommitLatencyStatistics::Stage::Total).percentile(1.0), std::chrono::milliseconds(16));
+    QCOMPARE(statistics.discardedCount(), quint64(0));
+
+    // a feedback that is destroyed without being presented counts as discarded
+    {
+        CommitLatencyFeedback feedback(connection, timings);
+    }
+    QCOMPARE(statistics.histogram(CommitLatencyStatistics::Stage::Total).count(), quint64(1));
+    QCOMPARE(statistics.discardedCount(), quint64(1));
+
+    close(sv[1]);
+}
+
+void TestWaylandServerDisplay::testInputLatency()
+{
+    KWin::Display display;
+    display.start();
+
+    int sv[2];
+    QVERIFY(socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, sv) >= 0);
+    ClientConnection *connection = display.createClient(sv[0]);
+    QVERIFY(connection);
+    QVERIFY(!connection->takeInputTrace());
+
+    // only the first input event until the next commit is traced
+    const auto now = std::chrono::steady_clock::now();
+    const auto inputTimestamp = std::chrono::duration_cast<std::chrono::microseconds>((now - std::chrono::milliseconds(20)).time_since_epoch());
+    connection->traceInput(inputTimestamp);
+    connection->traceInput(inputTimestamp + std::chrono::milliseconds(5));
+    const std::optional<InputTrace> trace = connection->takeInputTrace();
+    QVERIFY(trace);
+    QCOMPARE(trace->timestamp, inputTimestamp);
+    QVERIFY(!connection->takeInputTrace());
+
+    connection->traceInput(inputTimestamp);
+    const std::optional<InputTrace> nextTrace = connection->takeInputTrace();
+    QVERIFY(nextTrace);
+    QVERIFY(nextTrace->id != trace->id);
+
+    const CommitTimings timings{
+        .committed = now - std::chrono::milliseconds(3),
+        .fencesSignaled = now - std::chrono::milliseconds(2),
+        .applied = now - std::chrono::milliseconds(1),
+        .input = trace,
+    };
+    {
+        CommitLatencyFeedback feedback(connection, timings);
+        feedback.presented(std::chrono::milliseconds(16), (now + std::chrono::milliseconds(5)).time_since_epoch(), PresentationMode::VSync);
+    }
+    const auto &statistics = connection->commitLatency();
+    QCOMPARE(statistics.inputLatency().count(), quint64(1));
+    QCOMPARE(statistics.inputLatency().percentile(1.0), std::chrono::milliseconds(32));
+
+    close(sv[1]);
+}
+
 QTEST_GUILESS_MAIN(TestWaylandServerDisplay)
 #include "test_display.moc"
@@ -123,6 +123,12 @@ void Activities::slotCurrentChanged(const QString &newActivity)
     m_previous = m_current;
     m_current = newActivity;
 
+    // The desktops of the new activity are restored and the windows of all outputs are
+    // updated behind one stacking update; the workspace skips the per desktop update
+    // while switching and updates all outputs at once when currentChanged() is emitted.
+    StackingUpdatesBlocker blocker(workspace());
+    m_switching = true;
+
     const auto it = m_lastVirtualDesktop.find(m_current);
     if (it != m_lastVirtualDesktop.end()) {
         const auto &outputDesktops = it->second;
@@ -139,6 +145,7 @@ void Activities::slotCurrentChanged(const QString &newActivity)
     }
 
     Q_EMIT currentChanged(newActivity);
+    m_switching = false;
 }
 
 void Activities::slotRemoved(const QString &activity)
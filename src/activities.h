@@ -54,6 +54,12 @@ public:
     const QString &current() const;
     const QString &previous() const;
 
+    /**
+     * Returns @c true while the current activity is being switched, that is from
+     * currentAboutToChange() until currentChanged() has been handled.
+     */
+    bool isSwitching() const;
+
     static QString nullUuid();
 
     KActivities::Controller::ServiceStatus serviceStatus() const;
@@ -94,6 +100,7 @@ private Q_SLOTS:
 private:
     QString m_previous;
     QString m_current;
+    bool m_switching = false;
     KActivities::Controller *m_controller;
     std::unordered_map<QString, std::unordered_map<QString, QString>> m_lastVirtualDesktop;
     KSharedConfig::Ptr m_config;
@@ -114,6 +121,11 @@ inline const QString &Activities::previous() const
     return m_previous;
 }
 
+inline bool Activities::isSwitching() const
+{
+    return m_switching;
+}
+
 inline QString Activities::nullUuid()
 {
     // cloned from kactivities/src/lib/core/consumer.cpp
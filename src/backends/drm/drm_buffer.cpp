@@ -48,7 +48,7 @@ DrmFramebufferData::~DrmFramebufferData()
     }
 }
 
-DrmFramebuffer::DrmFramebuffer(const std::shared_ptr<DrmFramebufferData> &data, GraphicsBuffer *buffer, FileDescriptor &&readFence)
+DrmFramebuffer::DrmFramebuffer(const std::shared_ptr<DrmFramebufferData> &data, GraphicsBuffer *buffer, FileDescriptor &&readFence, Sync sync)
     : m_data(data)
     , m_bufferRef(buffer)
 {
@@ -57,6 +57,11 @@ DrmFramebuffer::DrmFramebuffer(const std::shared_ptr<DrmFramebufferData> &data,
         m_readable = true;
     }
     m_syncFd = std::move(readFence);
+    if (sync == Sync::Explicit && !m_syncFd.isValid()) {
+        // no need to export the implicit fences or to poll the dmabuf
+        m_readable = true;
+        return;
+    }
 #if defined(Q_OS_LINUX)
     if (!m_syncFd.isValid()) {
         dma_buf_export_sync_file req{
@@ -34,7 +34,19 @@ public:
 class KWIN_EXPORT DrmFramebuffer
 {
 public:
-    DrmFramebuffer(const std::shared_ptr<DrmFramebufferData> &data, GraphicsBuffer *buffer, FileDescriptor &&readFence);
+    enum class Sync {
+        /**
+         * Without a read fence, the buffer is synchronized with the fences in its dmabuf
+         */
+        Implicit,
+        /**
+         * The buffer has been synchronized before it got imported, if there is no read
+         * fence, it's ready to be scanned out
+         */
+        Explicit,
+    };
+
+    DrmFramebuffer(const std::shared_ptr<DrmFramebufferData> &data, GraphicsBuffer *buffer, FileDescriptor &&readFence, Sync sync);
 
     uint32_t framebufferId() const;
 
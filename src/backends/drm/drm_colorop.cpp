@@ -334,12 +334,16 @@ std::optional<DrmAbstractColorOp::Priority> DrmLutColorOp16::colorOpPreference(c
 
 void DrmLutColorOp16::program(DrmAtomicCommit *commit, const std::deque<ColorOp::Operation> &operations)
 {
+    std::vector<QVector3D> samples(m_maxSize);
     for (uint32_t i = 0; i < m_maxSize; i++) {
         const double input = i / double(m_maxSize - 1);
-        QVector3D output(input, input, input);
-        for (const auto &op : operations) {
-            output = ColorOp::applyOperation(op, output);
-        }
+        samples[i] = QVector3D(input, input, input);
+    }
+    for (const auto &op : operations) {
+        ColorOp::applyOperation(op, samples);
+    }
+    for (uint32_t i = 0; i < m_maxSize; i++) {
+        const QVector3D &output = samples[i];
         m_components[i] = {
             .red = uint16_t(std::round(std::clamp(output.x(), 0.0f, 1.0f) * std::numeric_limits<uint16_t>::max())),
             .green = uint16_t(std::round(std::clamp(output.y(), 0.0f, 1.0f) * std::numeric_limits<uint16_t>::max())),
@@ -472,12 +476,16 @@ std::optional<DrmAbstractColorOp::Priority> DrmLutColorOp32::colorOpPreference(c
 
 void DrmLutColorOp32::program(DrmAtomicCommit *commit, const std::deque<ColorOp::Operation> &operations)
 {
+    std::vector<QVector3D> samples(m_maxSize);
     for (uint32_t i = 0; i < m_maxSize; i++) {
         const double input = i / double(m_maxSize - 1);
-        QVector3D output(input, input, input);
-        for (const auto &op : operations) {
-            output = ColorOp::applyOperation(op, output);
-        }
+        samples[i] = QVector3D(input, input, input);
+    }
+    for (const auto &op : operations) {
+        ColorOp::applyOperation(op, samples);
+    }
+    for (uint32_t i = 0; i < m_maxSize; i++) {
+        const QVector3D &output = samples[i];
         m_components[i] = {
             .red = uint32_t(std::round(std::clamp<double>(output.x(), 0.0, 1.0) * std::numeric_limits<uint32_t>::max())),
             .green = uint32_t(std::round(std::clamp<double>(output.y(), 0.0, 1.0) * std::numeric_limits<uint32_t>::max())),
@@ -749,23 +757,26 @@ bool DrmLut3DColorOp::canBeInputOrOutput(ColorspaceType type) const
 
 void DrmLut3DColorOp::program(DrmAtomicCommit *commit, const std::deque<ColorOp::Operation> &operations)
 {
+    std::vector<QVector3D> samples(m_components.size());
     for (size_t r = 0; r < m_size; r++) {
         for (size_t g = 0; g < m_size; g++) {
             for (size_t b = 0; b < m_size; b++) {
-                QVector3D output = QVector3D(r, g, b) / float(m_size - 1);
-                for (const auto &op : operations) {
-                    output = ColorOp::applyOperation(op, output);
-                }
-                const size_t index = b * m_size * m_size + g * m_size + r;
-                m_components[index] = LutComponent32{
-                    .red = uint32_t(std::round(std::clamp<double>(output.x(), 0.0, 1.0) * std::numeric_limits<uint32_t>::max())),
-                    .green = uint32_t(std::round(std::clamp<double>(output.y(), 0.0, 1.0) * std::numeric_limits<uint32_t>::max())),
-                    .blue = uint32_t(std::round(std::clamp<double>(output.z(), 0.0, 1.0) * std::numeric_limits<uint32_t>::max())),
-                    .reserved = 0,
-                };
+                samples[b * m_size * m_size + g * m_size + r] = QVector3D(r, g, b) / float(m_size - 1);
             }
         }
     }
+    for (const auto &op : operations) {
+        ColorOp::applyOperation(op, samples);
+    }
+    for (size_t index = 0; index < samples.size(); index++) {
+        const QVector3D &output = samples[index];
+        m_components[index] = LutComponent32{
+            .red = uint32_t(std::round(std::clamp<double>(output.x(), 0.0, 1.0) * std::numeric_limits<uint32_t>::max())),
+            .green = uint32_t(std::round(std::clamp<double>(output.y(), 0.0, 1.0) * std::numeric_limits<uint32_t>::max())),
+            .blue = uint32_t(std::round(std::clamp<double>(output.z(), 0.0, 1.0) * std::numeric_limits<uint32_t>::max())),
+            .reserved = 0,
+        };
+    }
     commit->addBlob(*m_value, DrmBlob::create(m_value->drmObject()->gpu(), m_components.data(), m_components.size() * sizeof(LutComponent32)));
     if (m_interpolation) {
         commit->addEnum(*m_interpolation, Lut3DInterpolation::Tetrahedal);
@@ -15,9 +15,12 @@
 #include "drm_gpu.h"
 #include "drm_object.h"
 #include "drm_property.h"
+#include "ftrace.h"
 
 #include <QCoreApplication>
 #include <QThread>
+#include <algorithm>
+#include <array>
 #include <set>
 
 using namespace std::chrono_literals;
@@ -129,8 +132,33 @@ bool DrmAtomicCommit::commitModeset()
     return doCommit(DRM_MODE_ATOMIC_ALLOW_MODESET);
 }
 
+bool DrmAtomicCommit::commitBatch(std::span<DrmAtomicCommit *const> commits)
+{
+    const bool canBatch = std::ranges::all_of(commits, [](DrmAtomicCommit *commit) {
+        return commit->m_crtc.has_value() && !commit->isTearing() && !commit->m_modeset;
+    });
+    if (!canBatch) {
+        return false;
+    }
+    DrmAtomicCommit merged(*commits.front());
+    for (DrmAtomicCommit *commit : commits.subspan(1)) {
+        merged.merge(commit);
+    }
+    if (!merged.test()) {
+        return false;
+    }
+    return merged.doCommit(DRM_MODE_ATOMIC_NONBLOCK | DRM_MODE_PAGE_FLIP_EVENT, commits);
+}
+
 bool DrmAtomicCommit::doCommit(uint32_t flags)
 {
+    DrmAtomicCommit *self = this;
+    return doCommit(flags, std::span(&self, 1));
+}
+
+bool DrmAtomicCommit::doCommit(uint32_t flags, std::span<DrmAtomicCommit *const> pageflipReceivers)
+{
+    fTraceDuration((flags & DRM_MODE_ATOMIC_TEST_ONLY) ? "Atomic test" : "Atomic commit", " flags=", flags);
     std::vector<uint32_t> objects;
     std::vector<uint32_t> propertyCounts;
     std::vector<uint32_t> propertyIds;
@@ -165,9 +193,20 @@ bool DrmAtomicCommit::doCommit(uint32_t flags)
     if (flags & DRM_MODE_PAGE_FLIP_EVENT) {
         lock = m_gpu->lockPendingCommits();
     }
+    const auto start = std::chrono::steady_clock::now();
     const bool success = drmIoctl(m_gpu->fd(), DRM_IOCTL_MODE_ATOMIC, &commitData) == 0;
     if (success && (flags & DRM_MODE_PAGE_FLIP_EVENT)) {
-        m_gpu->registerPendingCommit(lock, *m_crtc, this);
+        // this must happen before the commit is registered, as the
+        // pageflip event may be processed right after that
+        const auto now = std::chrono::steady_clock::now();
+        for (DrmAtomicCommit *receiver : pageflipReceivers) {
+            for (const auto &[plane, frame] : receiver->m_frames) {
+                if (frame) {
+                    frame->setCommitTime(now, now - start);
+                }
+            }
+            m_gpu->registerPendingCommit(lock, *receiver->m_crtc, receiver);
+        }
     }
     return success;
 }
@@ -228,6 +267,47 @@ const std::unordered_set<DrmPlane *> &DrmAtomicCommit::modifiedPlanes() const
     return m_planes;
 }
 
+std::vector<uint64_t> DrmAtomicCommit::testKey(std::span<const uint32_t> ignored) const
+{
+    std::unordered_set<uint32_t> ignoredProperties(ignored.begin(), ignored.end());
+    for (DrmPlane *plane : m_planes) {
+        if (plane->inFenceFd.isValid()) {
+            ignoredProperties.insert(plane->inFenceFd.propId());
+        }
+    }
+    std::vector<std::array<uint64_t, 3>> properties;
+    for (const auto &[object, objectProperties] : m_properties) {
+        for (const auto &[property, value] : objectProperties) {
+            if (!ignoredProperties.contains(property)) {
+                properties.push_back({object, property, value});
+            }
+        }
+    }
+    std::ranges::sort(properties);
+    std::vector<std::array<uint64_t, 5>> buffers;
+    for (const auto &[plane, buffer] : m_buffers) {
+        // framebuffer ids get reused once a framebuffer is destroyed, so describe the buffer as well
+        const DmaBufAttributes *attributes = buffer && buffer->buffer() ? buffer->buffer()->dmabufAttributes() : nullptr;
+        if (attributes) {
+            buffers.push_back({plane->id(), attributes->format, attributes->modifier, uint64_t(attributes->width), uint64_t(attributes->height)});
+        } else {
+            buffers.push_back({plane->id(), 0, 0, 0, 0});
+        }
+    }
+    std::ranges::sort(buffers);
+
+    std::vector<uint64_t> ret;
+    ret.reserve(1 + properties.size() * 3 + buffers.size() * 5);
+    ret.push_back(isTearing() ? 1 : 0);
+    for (const auto &property : properties) {
+        ret.insert(ret.end(), property.begin(), property.end());
+    }
+    for (const auto &buffer : buffers) {
+        ret.insert(ret.end(), buffer.begin(), buffer.end());
+    }
+    return ret;
+}
+
 void DrmAtomicCommit::merge(DrmAtomicCommit *onTop)
 {
     for (const auto &[obj, properties] : onTop->m_properties) {
@@ -323,6 +403,9 @@ bool DrmLegacyCommit::doPageflip(PresentationMode mode)
     auto lock = gpu()->lockPendingCommits();
     const bool success = drmModePageFlip(gpu()->fd(), m_crtc->id(), m_buffer->framebufferId(), flags, gpu()) == 0;
     if (success) {
+        if (m_frame) {
+            m_frame->setCommitTime(std::chrono::steady_clock::now(), std::chrono::nanoseconds::zero());
+        }
         gpu()->registerPendingCommit(lock, m_crtc->id(), this);
     }
     return success;
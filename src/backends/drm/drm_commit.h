@@ -13,8 +13,10 @@
 
 #include <QHash>
 #include <chrono>
+#include <span>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 #include "core/renderloop.h"
 #include "drm_pointer.h"
@@ -79,6 +81,14 @@ public:
     std::optional<bool> isVrr() const;
     const std::unordered_set<DrmPlane *> &modifiedPlanes() const;
 
+    /**
+     * Returns a description of the state this commit would apply, which is equal for two
+     * commits if an atomic test of one of them would have the same result as a test of the
+     * other. Fences are left out, buffers are described by their framebuffer id, format,
+     * modifier and size. The values of @a ignoredProperties are left out as well.
+     */
+    std::vector<uint64_t> testKey(std::span<const uint32_t> ignoredProperties = {}) const;
+
     void merge(DrmAtomicCommit *onTop);
 
     void setAllowedVrrDelay(std::optional<std::chrono::nanoseconds> allowedDelay);
@@ -94,8 +104,16 @@ public:
      */
     void requestPageflipEvent(uint32_t crtcId);
 
+    /**
+     * Commits all of @p commits with a single atomic ioctl. Each of them gets its own
+     * pageflip event, as if they had been committed separately.
+     * @return false if the commits can't be committed together
+     */
+    static bool commitBatch(std::span<DrmAtomicCommit *const> commits);
+
 private:
     bool doCommit(uint32_t flags);
+    bool doCommit(uint32_t flags, std::span<DrmAtomicCommit *const> pageflipReceivers);
 
     const QList<DrmPipeline *> m_pipelines;
     std::optional<std::chrono::steady_clock::time_point> m_targetPageflipTime;
@@ -0,0 +1,79 @@
+/*
+    KWin - the KDE window manager
+    This file is part of the KDE project.
+
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "drm_commit_batcher.h"
+#include "drm_commit.h"
+#include "drm_gpu.h"
+#include "drm_logging.h"
+
+using namespace std::chrono_literals;
+
+namespace KWin
+{
+
+// how long the first commit of a batch waits for the other ones at most.
+// This is accounted for by the safety margin of the commit threads
+static constexpr std::chrono::nanoseconds s_batchWindow = 300us;
+
+DrmCommitBatcher::DrmCommitBatcher(DrmGpu *gpu)
+    : m_gpu(gpu)
+{
+}
+
+void DrmCommitBatcher::addParticipant()
+{
+    std::unique_lock lock(m_mutex);
+    m_participants++;
+}
+
+void DrmCommitBatcher::removeParticipant()
+{
+    std::unique_lock lock(m_mutex);
+    m_participants--;
+    // a batch may be waiting for this participant
+    m_batchChanged.notify_all();
+}
+
+bool DrmCommitBatcher::commit(DrmAtomicCommit *commit)
+{
+    std::unique_lock lock(m_mutex);
+    if (m_openBatch) {
+        const auto batch = m_openBatch;
+        batch->commits.push_back(commit);
+        m_batchChanged.notify_all();
+        m_batchChanged.wait(lock, [&batch]() {
+            return batch->state != Batch::State::Open;
+        });
+        return batch->state == Batch::State::Committed;
+    }
+
+    const auto batch = std::make_shared<Batch>();
+    batch->commits.push_back(commit);
+    m_openBatch = batch;
+    m_batchChanged.wait_for(lock, s_batchWindow, [this, &batch]() {
+        return batch->commits.size() >= m_participants;
+    });
+    m_openBatch.reset();
+
+    if (batch->commits.size() == 1) {
+        // nothing to batch with
+        batch->state = Batch::State::Failed;
+        return false;
+    }
+
+    // the other threads are blocked until the state changes, so the commits can't go away
+    const bool success = DrmAtomicCommit::commitBatch(batch->commits);
+    if (!success) {
+        qCDebug(KWIN_DRM) << "Batched commit of" << batch->commits.size() << "CRTCs failed on GPU" << m_gpu << ", committing them separately";
+    }
+    batch->state = success ? Batch::State::Committed : Batch::State::Failed;
+    m_batchChanged.notify_all();
+    return success;
+}
+
+}
@@ -0,0 +1,73 @@
+/*
+    KWin - the KDE window manager
+    This file is part of the KDE project.
+
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace KWin
+{
+
+class DrmAtomicCommit;
+class DrmGpu;
+
+/**
+ * The DrmCommitBatcher class merges atomic commits of different CRTCs on the same
+ * GPU that are due at roughly the same time into a single atomic ioctl.
+ *
+ * Each DrmCommitThread still schedules its commits on its own, but instead of committing
+ * directly it joins the currently open batch. The first commit thread to join waits for a
+ * short time for the other threads, or until all of them have joined, and then commits
+ * the whole batch at once. If the merged commit fails the test, every thread falls back
+ * to committing on its own.
+ *
+ * Batching is opt-in with the KWIN_DRM_BATCH_COMMITS environment variable.
+ */
+class DrmCommitBatcher
+{
+public:
+    explicit DrmCommitBatcher(DrmGpu *gpu);
+
+    /**
+     * Must be called by every commit thread that may add commits to batches, so
+     * that a batch can be closed as soon as all of them have joined
+     */
+    void addParticipant();
+    void removeParticipant();
+
+    /**
+     * Adds @p commit to the current batch and blocks until the batch has been committed.
+     * @return true if the batch containing the commit has been committed successfully,
+     *         false if the commit must be committed individually instead
+     */
+    bool commit(DrmAtomicCommit *commit);
+
+private:
+    struct Batch
+    {
+        enum class State {
+            Open,
+            Committed,
+            Failed,
+        };
+        std::vector<DrmAtomicCommit *> commits;
+        State state = State::Open;
+    };
+
+    DrmGpu *const m_gpu;
+    std::mutex m_mutex;
+    std::condition_variable m_batchChanged;
+    std::shared_ptr<Batch> m_openBatch;
+    size_t m_participants = 0;
+};
+
+}
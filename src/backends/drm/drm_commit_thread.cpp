@@ -8,11 +8,14 @@
 */
 #include "drm_commit_thread.h"
 #include "drm_commit.h"
+#include "drm_commit_batcher.h"
 #include "drm_gpu.h"
 #include "drm_logging.h"
 #include "utils/envvar.h"
 #include "utils/realtime.h"
 
+#include <algorithm>
+#include <cmath>
 #include <ranges>
 #include <span>
 #include <thread>
@@ -24,15 +27,19 @@ namespace KWin
 
 DrmCommitThread::DrmCommitThread(DrmGpu *gpu, const QString &name)
     : m_gpu(gpu)
+    , m_batcher(gpu->commitBatcher())
     , m_targetPageflipTime(std::chrono::steady_clock::now())
 {
     if (!gpu->atomicModeSetting()) {
         return;
     }
+    if (m_batcher) {
+        m_batcher->addParticipant();
+    }
 
-    m_thread.reset(QThread::create([this]() {
+    m_thread.reset(QThread::create([this, name]() {
         const auto thread = QThread::currentThread();
-        gainRealTime();
+        gainRealTime(RealTimeRole::Commit, name);
         while (true) {
             if (thread->isInterruptionRequested()) {
                 return;
@@ -75,11 +82,17 @@ DrmCommitThread::DrmCommitThread(DrmGpu *gpu, const QString &name)
             if (m_commits.empty()) {
                 continue;
             }
+            // with SCHED_DEADLINE, the runtime budget depends on the refresh rate
+            setRealTimePeriod(m_minVblankInterval);
             const auto now = std::chrono::steady_clock::now();
+            m_commitStartTime = now;
             if (m_targetPageflipTime > now + m_safetyMargin) {
+                const auto wakeupTime = m_targetPageflipTime - m_safetyMargin;
                 lock.unlock();
-                std::this_thread::sleep_until(m_targetPageflipTime - m_safetyMargin);
+                std::this_thread::sleep_until(wakeupTime);
                 lock.lock();
+                // include the scheduling latency in the measured commit latency
+                m_commitStartTime = wakeupTime;
                 // the main thread might've modified the list
                 if (m_commits.empty()) {
                     continue;
@@ -130,6 +143,8 @@ DrmCommitThread::DrmCommitThread(DrmGpu *gpu, const QString &name)
                 if (m_commits.empty()) {
                     continue;
                 }
+                // the time spent waiting for the VRR delay was intentional
+                m_commitStartTime = std::chrono::steady_clock::now();
             }
             submit();
         }
@@ -151,7 +166,7 @@ void DrmCommitThread::submit()
 {
     DrmAtomicCommit *commit = m_commits.front().get();
     const auto vrr = commit->isVrr();
-    const bool success = commit->commit();
+    const bool success = (m_batcher && !commit->isTearing() && m_batcher->commit(commit)) || commit->commit();
     if (success) {
         m_vrr = vrr.value_or(m_vrr);
         m_tearing = commit->isTearing();
@@ -162,22 +177,22 @@ void DrmCommitThread::submit()
         // after we return from the commit ioctl, but we don't have any better
         // way to know when it's done
         m_lastCommitTime = std::chrono::steady_clock::now();
+        if (m_lastCommitTime > m_commitStartTime) {
+            m_commitLatencies[m_commitLatencyIndex] = m_lastCommitTime - m_commitStartTime;
+            m_commitLatencyIndex = (m_commitLatencyIndex + 1) % m_commitLatencies.size();
+            m_commitLatencyCount = std::min(m_commitLatencyCount + 1, m_commitLatencies.size());
+        }
         // this is when we wanted to have completed the commit
         const auto targetTimestamp = m_targetPageflipTime - m_baseSafetyMargin;
-        // this is how much safety we need to add or remove to achieve that next time
-        const auto safetyDifference = targetTimestamp - m_lastCommitTime;
-        if (safetyDifference < std::chrono::nanoseconds::zero()) {
+        if (m_lastCommitTime > targetTimestamp) {
             // the commit was done later than desired, immediately add the
             // required difference to make sure that it doesn't happen again
-            m_additionalSafetyMargin -= safetyDifference;
+            m_lateCommitPenalty = std::max(m_lateCommitPenalty, m_additionalSafetyMargin + (m_lastCommitTime - targetTimestamp));
         } else {
-            // we were done earlier than desired. This isn't problematic, but
-            // we want to keep latency at a minimum, so slowly reduce the safety margin
-            m_additionalSafetyMargin -= safetyDifference / 10;
+            // otherwise, quickly go back to the learned margin
+            m_lateCommitPenalty /= 2;
         }
-        const auto maximumReasonableMargin = std::min<std::chrono::nanoseconds>(3ms, m_minVblankInterval / 2);
-        m_additionalSafetyMargin = std::clamp(m_additionalSafetyMargin, 0ns, maximumReasonableMargin);
-        m_safetyMargin = m_baseSafetyMargin + m_additionalSafetyMargin;
+        updateSafetyMargin();
     } else {
         if (m_commits.size() > 1) {
             // the failure may have been because of the reordering of commits
@@ -321,6 +336,9 @@ DrmCommitThread::~DrmCommitThread()
             m_pong.notify_all();
         }
         m_thread->wait();
+        if (m_batcher) {
+            m_batcher->removeParticipant();
+        }
     }
     if (m_committed) {
         m_committed->setDefunct();
@@ -357,17 +375,43 @@ void DrmCommitThread::clearDroppedCommits()
     m_commitsToDelete.clear();
 }
 
-// TODO reduce the default for this, once we have a more accurate way to know when an atomic commit
-// is actually applied. Waiting for the commit returning seems to work on Intel and AMD, but not with NVidia
-static const std::chrono::microseconds s_safetyMarginMinimum{environmentVariableIntValue("KWIN_DRM_OVERRIDE_SAFETY_MARGIN").value_or(1000)};
+static const std::optional<std::chrono::microseconds> s_safetyMarginOverride = environmentVariableIntValue("KWIN_DRM_OVERRIDE_SAFETY_MARGIN").transform([](int value) {
+    return std::chrono::microseconds(value);
+});
 
 void DrmCommitThread::setModeInfo(uint32_t maximum, std::chrono::nanoseconds vblankTime)
 {
     std::unique_lock lock(m_mutex);
     m_minVblankInterval = std::chrono::nanoseconds(1'000'000'000'000ull / maximum);
     // the kernel rejects commits that happen during vblank
-    // the 1.5ms on top of that was chosen experimentally, for the time it takes to commit + scheduling inaccuracies
-    m_baseSafetyMargin = vblankTime + s_safetyMarginMinimum;
+    // Waiting for the commit returning seems to work on Intel and AMD, but not with NVidia,
+    // so with NVidia some additional time is always reserved
+    // TODO reduce this, once we have a more accurate way to know when an atomic commit is actually applied
+    const std::chrono::nanoseconds minimum = s_safetyMarginOverride.value_or(m_gpu->drmDevice()->isNvidia() ? 1ms : 0ms);
+    m_baseSafetyMargin = vblankTime + minimum;
+    m_safetyMargin = m_baseSafetyMargin + m_additionalSafetyMargin;
+}
+
+void DrmCommitThread::updateSafetyMargin()
+{
+    // until enough data is available, use a conservative value
+    static constexpr size_t minimumSampleCount = 16;
+    // how often the commit may take longer than the margin accounts for
+    static constexpr double latencyQuantile = 0.99;
+    // for timer and scheduler inaccuracies
+    static constexpr std::chrono::nanoseconds schedulingSlack = 250us;
+
+    std::chrono::nanoseconds learnedMargin = 1ms;
+    if (m_commitLatencyCount >= minimumSampleCount) {
+        std::array<std::chrono::nanoseconds, std::tuple_size_v<decltype(m_commitLatencies)>> sorted;
+        const auto end = std::copy_n(m_commitLatencies.begin(), m_commitLatencyCount, sorted.begin());
+        const size_t rank = std::clamp<size_t>(std::ceil(latencyQuantile * m_commitLatencyCount), 1, m_commitLatencyCount);
+        std::nth_element(sorted.begin(), sorted.begin() + rank - 1, end);
+        learnedMargin = sorted[rank - 1] + schedulingSlack;
+    }
+    const auto maximumReasonableMargin = std::min<std::chrono::nanoseconds>(3ms, m_minVblankInterval / 2);
+    m_additionalSafetyMargin = std::clamp(std::max(learnedMargin, m_lateCommitPenalty), 0ns, maximumReasonableMargin);
+    m_lateCommitPenalty = std::min(m_lateCommitPenalty, maximumReasonableMargin);
     m_safetyMargin = m_baseSafetyMargin + m_additionalSafetyMargin;
 }
 
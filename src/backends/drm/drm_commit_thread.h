@@ -10,6 +10,7 @@
 
 #include <QObject>
 #include <QThread>
+#include <array>
 #include <condition_variable>
 #include <mutex>
 #include <vector>
@@ -19,6 +20,7 @@ namespace KWin
 
 class DrmGpu;
 class DrmCommit;
+class DrmCommitBatcher;
 class DrmAtomicCommit;
 class DrmLegacyCommit;
 
@@ -50,8 +52,10 @@ private:
     void optimizeCommits(TimePoint pageflipTarget);
     void submit();
     void handlePing();
+    void updateSafetyMargin();
 
     DrmGpu *const m_gpu;
+    DrmCommitBatcher *const m_batcher;
     std::unique_ptr<DrmCommit> m_committed;
     std::vector<std::unique_ptr<DrmAtomicCommit>> m_commits;
     std::unique_ptr<QThread> m_thread;
@@ -68,6 +72,24 @@ private:
     std::chrono::nanoseconds m_safetyMargin{0};
     std::chrono::nanoseconds m_baseSafetyMargin{0};
     std::chrono::nanoseconds m_additionalSafetyMargin = std::chrono::milliseconds(1);
+
+    /**
+     * The time at which the thread started to work on the current commit. For commits that
+     * the thread waited for, this is the planned wakeup time, so that scheduling latency is
+     * accounted for as well.
+     */
+    TimePoint m_commitStartTime;
+    /**
+     * How long it took to get from m_commitStartTime to the commit ioctl returning,
+     * for the most recent commits
+     */
+    std::array<std::chrono::nanoseconds, 128> m_commitLatencies;
+    size_t m_commitLatencyCount = 0;
+    size_t m_commitLatencyIndex = 0;
+    /**
+     * Added on top of the learned margin after a commit missed its deadline, decays quickly
+     */
+    std::chrono::nanoseconds m_lateCommitPenalty{0};
     bool m_ping = false;
     bool m_pageflipTimeoutDetected = false;
 };
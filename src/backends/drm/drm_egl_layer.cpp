@@ -53,6 +53,9 @@ EglGbmLayer::EglGbmLayer(EglGbmBackend *eglBackend, DrmGpu *gpu, DrmPlane::TypeI
 std::optional<OutputLayerBeginFrameInfo> EglGbmLayer::doBeginFrame()
 {
     m_scanoutBuffer.reset();
+    // the compositor sets the max luminance of the layer to what the content on it needs
+    const double referenceLuminance = m_color->referenceLuminance();
+    const bool hdrContent = m_color->maxHdrLuminance().value_or(referenceLuminance) > referenceLuminance;
     return m_surface.startRendering(targetRect().size(),
                                     drmOutput()->transform().combine(OutputTransform::FlipY),
                                     supportedDrmFormats(),
@@ -64,6 +67,7 @@ std::optional<OutputLayerBeginFrameInfo> EglGbmLayer::doBeginFrame()
                                     drmOutput()->scale(),
                                     drmOutput()->colorPowerTradeoff(),
                                     drmOutput()->needsShadowBuffer(),
+                                    hdrContent,
                                     m_requiredAlphaBits);
 }
 
@@ -81,6 +85,15 @@ bool EglGbmLayer::preparePresentationTest()
     return m_surface.renderTestBuffer(targetRect().size(), supportedDrmFormats(), drmOutput()->nextState().colorPowerTradeoff, m_requiredAlphaBits) != nullptr;
 }
 
+bool EglGbmLayer::fallBackToSaferModifier()
+{
+    if (!isEnabled() || m_scanoutBuffer) {
+        // the modifier of client buffers is up to the client
+        return false;
+    }
+    return m_surface.avoidCurrentModifier() && preparePresentationTest();
+}
+
 static const auto s_allowHardwareRotation = environmentVariableBoolValue("KWIN_ENABLE_HW_ROTATION");
 static const bool s_directScanoutDisabled = environmentVariableBoolValue("KWIN_DRM_NO_DIRECT_SCANOUT").value_or(false);
 
@@ -92,6 +105,10 @@ bool EglGbmLayer::earlyScanoutChecks()
     if (m_type != OutputLayerType::Primary && drmOutput()->shouldDisableNonPrimaryPlanes()) {
         return false;
     }
+    if (m_type == OutputLayerType::CursorOnly && targetFor(gpu(), DrmPlane::TypeIndex::Cursor) == EglGbmLayerSurface::BufferTarget::Dumb) {
+        // legacy and virtual machine cursors have to be dumb buffers of a fixed size
+        return false;
+    }
     if (gpu()->needsModeset()) {
         // don't do direct scanout with modeset, it might lead to locking
         // the hardware to some buffer format we can't switch away from
@@ -133,7 +150,7 @@ bool EglGbmLayer::earlyScanoutChecks()
     return true;
 }
 
-bool EglGbmLayer::importScanoutBuffer(GraphicsBuffer *buffer, const std::shared_ptr<OutputFrame> &frame)
+bool EglGbmLayer::importScanoutBuffer(GraphicsBuffer *buffer, bool explicitSync, const std::shared_ptr<OutputFrame> &frame)
 {
     if (buffer->dmabufAttributes()->device != gpu()->drmDevice()->deviceId()
         && (!gpu()->renderDevice() || buffer->dmabufAttributes()->device != gpu()->renderDevice()->deviceId())) {
@@ -144,7 +161,7 @@ bool EglGbmLayer::importScanoutBuffer(GraphicsBuffer *buffer, const std::shared_
         //   is also very unlikely to yield the correct results.
         return false;
     }
-    m_scanoutBuffer = gpu()->importBuffer(buffer, FileDescriptor{});
+    m_scanoutBuffer = gpu()->importBuffer(buffer, FileDescriptor{}, explicitSync ? DrmFramebuffer::Sync::Explicit : DrmFramebuffer::Sync::Implicit);
     if (m_scanoutBuffer) {
         m_surface.forgetDamage(); // TODO: Use absolute frame sequence numbers for indexing the DamageJournal. It's more flexible and less error-prone
     }
@@ -31,12 +31,13 @@ public:
     std::optional<OutputLayerBeginFrameInfo> doBeginFrame() override;
     bool doEndFrame(const Region &renderedDeviceRegion, const Region &damagedDeviceRegion, OutputFrame *frame) override;
     bool preparePresentationTest() override;
+    bool fallBackToSaferModifier() override;
     std::shared_ptr<DrmFramebuffer> currentBuffer() const override;
     void releaseBuffers() override;
 
 private:
     bool earlyScanoutChecks() override;
-    bool importScanoutBuffer(GraphicsBuffer *buffer, const std::shared_ptr<OutputFrame> &frame) override;
+    bool importScanoutBuffer(GraphicsBuffer *buffer, bool explicitSync, const std::shared_ptr<OutputFrame> &frame) override;
 
     EglGbmLayerSurface m_surface;
     std::shared_ptr<DrmFramebuffer> m_scanoutBuffer;
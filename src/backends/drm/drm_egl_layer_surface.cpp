@@ -21,6 +21,7 @@
 #include "multigpuswapchain.h"
 #include "opengl/eglnativefence.h"
 #include "opengl/eglswapchain.h"
+#include "opengl/glgpuprofiler.h"
 #include "opengl/gllut.h"
 #include "opengl/glrendertimequery.h"
 #include "opengl/icc_shader.h"
@@ -30,6 +31,7 @@
 #include <drm_fourcc.h>
 #include <errno.h>
 #include <gbm.h>
+#include <ranges>
 #include <unistd.h>
 
 namespace KWin
@@ -41,6 +43,7 @@ static const QList<uint32_t> cpuCopyFormats = {DRM_FORMAT_ARGB8888, DRM_FORMAT_X
 
 static const bool bufferAgeEnabled = environmentVariableBoolValue("KWIN_USE_BUFFER_AGE").value_or(true);
 static const bool s_forceMGPUSync = environmentVariableBoolValue("KWIN_DRM_FORCE_GL_FINISH_MGPU_COPY").value_or(false);
+static const bool s_directImportMGPU = environmentVariableBoolValue("KWIN_DRM_MGPU_DIRECT_IMPORT").value_or(true);
 static const bool s_forcePresentSync = environmentVariableBoolValue("KWIN_DRM_FORCE_GL_FINISH_PRESENT").value_or(false);
 
 static gbm_format_name_desc formatName(uint32_t format)
@@ -81,7 +84,7 @@ std::optional<OutputLayerBeginFrameInfo> EglGbmLayerSurface::startRendering(cons
                                                                             const std::shared_ptr<IccProfile> &iccProfile,
                                                                             const Colorimetry &wireColor, const TransferFunction::Type &wireTransfer,
                                                                             double scale, BackendOutput::ColorPowerTradeoff tradeoff,
-                                                                            bool useShadowBuffer, uint32_t requiredAlphaBits)
+                                                                            bool useShadowBuffer, bool hdrContent, uint32_t requiredAlphaBits)
 {
     if (!checkSurface(bufferSize, formats, tradeoff, requiredAlphaBits)) {
         return std::nullopt;
@@ -132,9 +135,23 @@ std::optional<OutputLayerBeginFrameInfo> EglGbmLayerSurface::startRendering(cons
     m_surface->compositingTimeQuery = std::make_unique<GLRenderTimeQuery>(m_surface->context);
     m_surface->compositingTimeQuery->begin();
     if (m_surface->needsShadowBuffer) {
-        if (!m_surface->shadowSwapchain || m_surface->shadowSwapchain->size() != m_surface->gbmSwapchain->size()) {
+        // floating point blending buffers cost twice the memory bandwidth of 10 bit ones,
+        // so they're only used while HDR content is shown
+        const bool highPrecision = hdrContent && tradeoff == BackendOutput::ColorPowerTradeoff::PreferAccuracy;
+        if (!m_surface->shadowSwapchain || m_surface->shadowSwapchain->size() != m_surface->gbmSwapchain->size() || m_surface->shadowHighPrecision != highPrecision) {
+            m_surface->shadowSwapchain.reset();
+            m_surface->shadowDamageJournal.clear();
+            m_surface->shadowHighPrecision = highPrecision;
             const auto formats = m_eglBackend->eglDisplayObject()->nonExternalOnlySupportedDrmFormats();
-            const QList<FormatInfo> sortedFormats = OutputLayer::filterAndSortFormats(formats, requiredAlphaBits, tradeoff);
+            QList<FormatInfo> sortedFormats = OutputLayer::filterAndSortFormats(formats, requiredAlphaBits, tradeoff);
+            if (!highPrecision && tradeoff == BackendOutput::ColorPowerTradeoff::PreferAccuracy) {
+                auto sdrFormats = sortedFormats | std::views::filter([](const FormatInfo &format) {
+                    return !format.floatingPoint && format.bitsPerColor >= 10;
+                }) | std::ranges::to<QList>();
+                if (!sdrFormats.isEmpty()) {
+                    sortedFormats = std::move(sdrFormats);
+                }
+            }
             for (const auto format : sortedFormats) {
                 GraphicsBufferOptions options{
                     .size = m_surface->gbmSwapchain->size(),
@@ -237,6 +254,7 @@ bool EglGbmLayerSurface::endRendering(const Region &damagedDeviceRegion, OutputF
         const QSize rotatedSize = mapping.map(m_surface->gbmSwapchain->size());
         const Region repaint = mapping.map(deviceRepaint & Rect(QPoint(), rotatedSize), rotatedSize);
 
+        GLGpuProfilerScope profilerScope(m_surface->iccShader ? QStringLiteral("ICC profile") : QStringLiteral("Color conversion"));
         GLFramebuffer *fbo = m_surface->currentSlot->framebuffer();
         GLFramebuffer::pushFramebuffer(fbo);
         ShaderBinder binder = m_surface->iccShader ? ShaderBinder(m_surface->iccShader->shader()) : ShaderBinder(ShaderTrait::MapTexture | ShaderTrait::TransformColorspace);
@@ -324,7 +342,43 @@ void EglGbmLayerSurface::forgetDamage()
     if (m_surface) {
         m_surface->damageJournal.clear();
         m_surface->shadowDamageJournal.clear();
+        m_surface->importDumbDamageJournal.clear();
+    }
+}
+
+bool EglGbmLayerSurface::avoidCurrentModifier()
+{
+    if (!m_surface || m_surface->bufferTarget != BufferTarget::Normal) {
+        return false;
+    }
+    const uint32_t format = m_surface->gbmSwapchain->format();
+    const uint64_t modifier = m_surface->gbmSwapchain->modifier();
+    if (m_surface->importMode == MultiGpuImportMode::DirectImport) {
+        // the display GPU may not be able to scan out of the memory the buffer
+        // was placed in, no matter which modifier it has. Fall back to a copy
+        qCDebug(KWIN_DRM) << "Presentation test failed with a buffer of the render GPU for format" << formatName(format).name << ", falling back to a copy";
+        m_failedDirectImportFormats.insert(format);
+        for (Surface *surface : {m_surface.get(), m_oldSurface.get()}) {
+            if (surface && surface->importMode == MultiGpuImportMode::DirectImport && surface->gbmSwapchain->format() == format) {
+                surface->needsRecreation = true;
+            }
+        }
+        return true;
     }
+    if (m_surface->importMode != MultiGpuImportMode::None) {
+        return false;
+    }
+    if (modifier == DRM_FORMAT_MOD_LINEAR || modifier == DRM_FORMAT_MOD_INVALID || m_avoidedModifiers[format].contains(modifier)) {
+        return false;
+    }
+    qCDebug(KWIN_DRM) << "Presentation test failed with modifier" << modifier << "for format" << formatName(format).name << ", trying to avoid it";
+    m_avoidedModifiers[format].insert(modifier);
+    for (Surface *surface : {m_surface.get(), m_oldSurface.get()}) {
+        if (surface && surface->gbmSwapchain && surface->gbmSwapchain->format() == format && surface->gbmSwapchain->modifier() == modifier) {
+            surface->needsRecreation = true;
+        }
+    }
+    return true;
 }
 
 bool EglGbmLayerSurface::checkSurface(const QSize &size, const FormatModifierMap &formats, BackendOutput::ColorPowerTradeoff tradeoff, uint32_t requiredAlphaBits)
@@ -346,6 +400,7 @@ bool EglGbmLayerSurface::checkSurface(const QSize &size, const FormatModifierMap
             // FIXME: Use absolute frame sequence numbers for indexing the DamageJournal
             m_oldSurface->damageJournal.clear();
             m_oldSurface->shadowDamageJournal.clear();
+            m_oldSurface->importDumbDamageJournal.clear();
             m_oldSurface->gbmSwapchain->resetBufferAge();
             if (m_oldSurface->shadowSwapchain) {
                 m_oldSurface->shadowSwapchain->resetBufferAge();
@@ -374,6 +429,7 @@ bool EglGbmLayerSurface::doesSurfaceFit(Surface *surface, const QSize &size, con
     }
     switch (surface->importMode) {
     case MultiGpuImportMode::None:
+    case MultiGpuImportMode::DirectImport:
         return formats.containsFormat(surface->gbmSwapchain->format(), surface->gbmSwapchain->modifier());
     case MultiGpuImportMode::DumbBuffer:
         return formats.contains(surface->importDumbSwapchain->format());
@@ -427,6 +483,12 @@ std::unique_ptr<EglGbmLayerSurface::Surface> EglGbmLayerSurface::createSurface(c
             return surface;
         }
     }
+    if (s_directImportMGPU && bufferTarget == BufferTarget::Normal) {
+        if (auto surface = doTestFormats(sortedFormats, MultiGpuImportMode::DirectImport)) {
+            qCDebug(KWIN_DRM) << "chose direct import with format" << formatName(surface->gbmSwapchain->format()).name << "and modifier" << surface->gbmSwapchain->modifier();
+            return surface;
+        }
+    }
     if (auto surface = doTestFormats(sortedFormats, MultiGpuImportMode::GpuCopy)) {
         // qCDebug(KWIN_DRM) << "chose egl import with format" << formatName(surface->gbmSwapchain->format()).name << "and modifier" << surface->gbmSwapchain->modifier();
         return surface;
@@ -453,12 +515,31 @@ std::unique_ptr<EglGbmLayerSurface::Surface> EglGbmLayerSurface::createSurface(c
         renderModifiers.intersect(m_gpu->renderDevice()->allImportableFormats().value(format));
         // transferring non-linear buffers with implicit modifiers between GPUs is likely to yield wrong results
         renderModifiers.erase(DRM_FORMAT_MOD_INVALID);
+    } else if (importMode == MultiGpuImportMode::DirectImport) {
+        if (bufferTarget != BufferTarget::Normal
+            || m_failedDirectImportFormats.contains(format)
+            || !m_eglBackend->renderDevice()
+            || m_eglBackend->renderDevice()->isSoftwareDevice()) {
+            return nullptr;
+        }
+        // the display GPU scans out the buffer as it is, so only modifiers it supports on this plane
+        // can be used. Vendor specific modifiers usually only match between GPUs of the same vendor
+        renderModifiers.intersect(modifiers);
+        renderModifiers.erase(DRM_FORMAT_MOD_INVALID);
     } else if (cpuCopy) {
         if (!cpuCopyFormats.contains(format)) {
             return nullptr;
         }
     } else {
         renderModifiers.intersect(modifiers);
+        // modifiers that failed in presentation tests before are only used if there's nothing else
+        ModifierList preferredModifiers = renderModifiers;
+        for (const uint64_t modifier : m_avoidedModifiers.value(format)) {
+            preferredModifiers.erase(modifier);
+        }
+        if (!preferredModifiers.empty()) {
+            renderModifiers = preferredModifiers;
+        }
     }
     if (renderModifiers.empty()) {
         return nullptr;
@@ -471,7 +552,7 @@ std::unique_ptr<EglGbmLayerSurface::Surface> EglGbmLayerSurface::createSurface(c
         .format = format,
         .modifiers = renderModifiers,
         .software = false,
-        .scanout = importMode == MultiGpuImportMode::None && bufferTarget == BufferTarget::Normal,
+        .scanout = (importMode == MultiGpuImportMode::None || importMode == MultiGpuImportMode::DirectImport) && bufferTarget == BufferTarget::Normal,
     };
     if (importMode == MultiGpuImportMode::None && bufferTarget == BufferTarget::Normal) {
         ret->gbmSwapchain = EglSwapchain::create(m_gpu->drmDevice()->allocator(), m_eglBackend->openglContext(), options);
@@ -525,10 +606,16 @@ std::shared_ptr<DrmFramebuffer> EglGbmLayerSurface::doRenderTestBuffer(Surface *
 std::shared_ptr<DrmFramebuffer> EglGbmLayerSurface::importBuffer(Surface *surface, EglSwapchainSlot *slot, FileDescriptor &&readFence, OutputFrame *frame, const Region &damagedDeviceRegion) const
 {
     if (surface->bufferTarget == BufferTarget::Dumb || surface->importMode == MultiGpuImportMode::DumbBuffer) {
-        return importWithCpu(surface, slot, frame);
+        return importWithCpu(surface, slot, frame, damagedDeviceRegion);
     } else if (surface->importMode == MultiGpuImportMode::GpuCopy) {
         return importWithCopy(surface, slot, std::move(readFence), frame, damagedDeviceRegion);
     } else {
+        if (surface->importMode == MultiGpuImportMode::DirectImport) {
+            // the display GPU can only wait for the rendering to finish with a fence
+            if (!readFence.isValid() || !m_eglBackend->eglDisplayObject()->supportsNativeFence() || s_forceMGPUSync) {
+                glFinish();
+            }
+        }
         const auto ret = m_gpu->importBuffer(slot->buffer(), std::move(readFence));
         if (!ret) {
             qCWarning(KWIN_DRM, "Failed to create framebuffer: %s", strerror(errno));
@@ -558,7 +645,7 @@ std::shared_ptr<DrmFramebuffer> EglGbmLayerSurface::importWithCopy(Surface *surf
     return m_gpu->importBuffer(imported->buffer, std::move(imported->sync));
 }
 
-std::shared_ptr<DrmFramebuffer> EglGbmLayerSurface::importWithCpu(Surface *surface, EglSwapchainSlot *source, OutputFrame *frame) const
+std::shared_ptr<DrmFramebuffer> EglGbmLayerSurface::importWithCpu(Surface *surface, EglSwapchainSlot *source, OutputFrame *frame, const Region &damagedDeviceRegion) const
 {
     std::unique_ptr<CpuRenderTimeQuery> copyTime;
     if (frame) {
@@ -570,23 +657,29 @@ std::shared_ptr<DrmFramebuffer> EglGbmLayerSurface::importWithCpu(Surface *surfa
         qCWarning(KWIN_DRM) << "EglGbmLayerSurface::importWithCpu: failed to get a target dumb buffer";
         return nullptr;
     }
-    const auto size = source->buffer()->size();
-    const qsizetype srcStride = 4 * size.width();
+
+    // the dumb buffer still contains the frame it was used for last, only read back what changed since then
+    const Region deviceRepaint = damagedDeviceRegion | surface->importDumbDamageJournal.accumulate(slot->age(), Region::infinite());
+    surface->importDumbDamageJournal.add(damagedDeviceRegion);
+    const QSize size = source->buffer()->size();
+    const Rect bufferRect(QPoint(0, 0), size);
+    Region bufferRepaint;
+    if (deviceRepaint == Region::infinite()) {
+        bufferRepaint = bufferRect;
+    } else {
+        const QSize orientedSize = source->texture()->contentTransform().map(size);
+        bufferRepaint = source->texture()->contentTransform().map(deviceRepaint, orientedSize) & bufferRect;
+    }
+
     EglContext *context = m_eglBackend->openglContext();
     GLFramebuffer::pushFramebuffer(source->framebuffer());
     QImage *const dst = slot->view()->image();
-    if (dst->bytesPerLine() == srcStride) {
-        context->glReadnPixels(0, 0, dst->width(), dst->height(), GL_BGRA, GL_UNSIGNED_BYTE, dst->sizeInBytes(), dst->bits());
-    } else {
-        // there's padding, need to copy line by line
-        if (surface->cpuCopyCache.size() != dst->size()) {
-            surface->cpuCopyCache = QImage(dst->size(), QImage::Format_RGBA8888);
-        }
-        context->glReadnPixels(0, 0, dst->width(), dst->height(), GL_BGRA, GL_UNSIGNED_BYTE, surface->cpuCopyCache.sizeInBytes(), surface->cpuCopyCache.bits());
-        for (int i = 0; i < dst->height(); i++) {
-            std::memcpy(dst->scanLine(i), surface->cpuCopyCache.scanLine(i), srcStride);
-        }
+    glPixelStorei(GL_PACK_ROW_LENGTH, dst->bytesPerLine() / 4);
+    for (const Rect &rect : bufferRepaint.rects()) {
+        const qsizetype offset = rect.y() * dst->bytesPerLine() + rect.x() * 4;
+        context->glReadnPixels(rect.x(), rect.y(), rect.width(), rect.height(), GL_BGRA, GL_UNSIGNED_BYTE, dst->sizeInBytes() - offset, dst->bits() + offset);
     }
+    glPixelStorei(GL_PACK_ROW_LENGTH, 0);
     GLFramebuffer::popFramebuffer();
 
     const auto ret = m_gpu->importBuffer(slot->buffer(), FileDescriptor{});
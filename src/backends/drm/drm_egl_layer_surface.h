@@ -11,6 +11,7 @@
 #include <QHash>
 #include <QMap>
 #include <QPointer>
+#include <QSet>
 #include <chrono>
 #include <optional>
 
@@ -52,19 +53,33 @@ public:
     explicit EglGbmLayerSurface(DrmGpu *gpu, EglGbmBackend *eglBackend, BufferTarget target = BufferTarget::Normal);
     ~EglGbmLayerSurface();
 
+    /**
+     * Starts rendering a frame. If @a useShadowBuffer is @c true, the frame is blended in an
+     * intermediate buffer first. Unless @a hdrContent is @c true, that buffer doesn't use
+     * floating point formats, as 10 bits per color are enough for SDR content.
+     */
     std::optional<OutputLayerBeginFrameInfo> startRendering(const QSize &bufferSize, OutputTransform transformation, const FormatModifierMap &formats,
                                                             const std::shared_ptr<ColorDescription> &blendingColor,
                                                             const std::shared_ptr<ColorDescription> &layerBlendingColor,
                                                             const std::shared_ptr<IccProfile> &iccProfile,
                                                             const Colorimetry &wireColor, const TransferFunction::Type &wireTransfer,
                                                             double scale, BackendOutput::ColorPowerTradeoff tradeoff,
-                                                            bool useShadowBuffer, uint32_t requiredAlphaBits);
+                                                            bool useShadowBuffer, bool hdrContent, uint32_t requiredAlphaBits);
     bool endRendering(const Region &damagedDeviceRegion, OutputFrame *frame);
 
     void destroyResources();
     EglGbmBackend *eglBackend() const;
     std::shared_ptr<DrmFramebuffer> renderTestBuffer(const QSize &bufferSize, const FormatModifierMap &formats, BackendOutput::ColorPowerTradeoff tradeoff, uint32_t requiredAlphaBits);
     void forgetDamage();
+    /**
+     * Stops using the explicit modifier of the current buffers, because the presentation test
+     * with them failed. Some hardware has tighter restrictions for compressed and
+     * tiled layouts than for linear buffers, for example on the number of planes that can
+     * use them at the same time. Buffers of another GPU are copied for the display GPU
+     * instead of being scanned out directly.
+     * @returns @c true if the surface will be recreated with a different modifier
+     */
+    bool avoidCurrentModifier();
 
     std::shared_ptr<DrmFramebuffer> currentBuffer() const;
     const std::shared_ptr<ColorDescription> &colorDescription() const;
@@ -72,6 +87,11 @@ public:
 private:
     enum class MultiGpuImportMode {
         None,
+        /**
+         * The buffer is rendered on the render GPU and scanned out by the display GPU
+         * without a copy, which needs a modifier both of them support
+         */
+        DirectImport,
         GpuCopy,
         DumbBuffer,
     };
@@ -86,8 +106,8 @@ private:
         std::shared_ptr<EglSwapchainSlot> currentSlot;
         DamageJournal damageJournal;
         std::unique_ptr<QPainterSwapchain> importDumbSwapchain;
+        DamageJournal importDumbDamageJournal;
         std::unique_ptr<MultiGpuSwapchain> importSwapchain;
-        QImage cpuCopyCache;
         MultiGpuImportMode importMode;
         std::shared_ptr<DrmFramebuffer> currentFramebuffer;
         BufferTarget bufferTarget;
@@ -97,6 +117,7 @@ private:
         // for color management
         bool needsShadowBuffer = false;
         std::shared_ptr<EglSwapchain> shadowSwapchain;
+        bool shadowHighPrecision = false;
         std::shared_ptr<EglSwapchainSlot> currentShadowSlot;
         std::shared_ptr<ColorDescription> layerBlendingColor = ColorDescription::sRGB;
         std::shared_ptr<ColorDescription> blendingColor = ColorDescription::sRGB;
@@ -118,7 +139,7 @@ private:
     std::shared_ptr<DrmFramebuffer> doRenderTestBuffer(Surface *surface) const;
     std::shared_ptr<DrmFramebuffer> importBuffer(Surface *surface, EglSwapchainSlot *source, FileDescriptor &&readFence, OutputFrame *frame, const Region &damagedDeviceRegion) const;
     std::shared_ptr<DrmFramebuffer> importWithCopy(Surface *surface, EglSwapchainSlot *source, FileDescriptor &&readFence, OutputFrame *frame, const Region &damagedDeviceRegion) const;
-    std::shared_ptr<DrmFramebuffer> importWithCpu(Surface *surface, EglSwapchainSlot *source, OutputFrame *frame) const;
+    std::shared_ptr<DrmFramebuffer> importWithCpu(Surface *surface, EglSwapchainSlot *source, OutputFrame *frame, const Region &damagedDeviceRegion) const;
 
     std::unique_ptr<Surface> m_surface;
     std::unique_ptr<Surface> m_oldSurface;
@@ -126,6 +147,8 @@ private:
     DrmGpu *const m_gpu;
     EglGbmBackend *const m_eglBackend;
     const BufferTarget m_requestedBufferTarget;
+    FormatModifierMap m_avoidedModifiers;
+    QSet<uint32_t> m_failedDirectImportFormats;
 };
 
 }
@@ -16,6 +16,7 @@
 #include "drm_backend.h"
 #include "drm_buffer.h"
 #include "drm_commit.h"
+#include "drm_commit_batcher.h"
 #include "drm_commit_thread.h"
 #include "drm_connector.h"
 #include "drm_crtc.h"
@@ -59,6 +60,7 @@ namespace KWin
 
 static const std::optional<bool> s_modifiersEnv = environmentVariableBoolValue("KWIN_DRM_USE_MODIFIERS");
 static const std::optional<bool> s_colorPipelineEnv = environmentVariableBoolValue("KWIN_DRM_USE_COLOR_PIPELINE");
+static const bool s_batchCommitsEnv = environmentVariableBoolValue("KWIN_DRM_BATCH_COMMITS").value_or(false);
 
 DrmGpu::DrmGpu(DrmBackend *backend, int fd, std::unique_ptr<DrmDevice> &&device)
     : m_fd(fd)
@@ -107,6 +109,11 @@ DrmGpu::DrmGpu(DrmBackend *backend, int fd, std::unique_ptr<DrmDevice> &&device)
 
     initDrmResources();
 
+    if (m_atomicModeSetting && s_batchCommitsEnv) {
+        qCDebug(KWIN_DRM) << "Batching atomic commits of different CRTCs on GPU" << this;
+        m_commitBatcher = std::make_unique<DrmCommitBatcher>(this);
+    }
+
     if (m_atomicModeSetting == false) {
         m_asyncPageflipSupported = drmGetCap(fd, DRM_CAP_ASYNC_PAGE_FLIP, &capability) == 0 && capability == 1;
     } else {
@@ -141,6 +148,7 @@ DrmGpu::DrmGpu(DrmBackend *backend, int fd, std::unique_ptr<DrmDevice> &&device)
 DrmGpu::~DrmGpu()
 {
     // clean up all `DrmFramebuffer`s before destroying the egl display
+    m_retainedFramebuffers.clear();
     removeOutputs();
     m_planeLayerMap.clear();
     m_legacyLayerMap.clear();
@@ -291,6 +299,7 @@ bool DrmGpu::updateOutputs()
     for (const auto &crtc : std::as_const(m_crtcs)) {
         crtc->updateProperties();
     }
+    invalidateTestCache();
     // update plane properties
     for (const auto &plane : std::as_const(m_planes)) {
         plane->updateProperties();
@@ -390,9 +399,11 @@ DrmPipeline::Error DrmGpu::checkCrtcAssignment(QList<DrmConnector *> connectors,
         return DrmPipeline::Error::NotEnoughCrtcs;
     }
     DrmCrtc *currentCrtc = nullptr;
-    if (m_atomicModeSetting) {
-        // try the crtc that this connector is already connected to first
-        const uint32_t id = connector->crtcId.value();
+    const auto knownCrtc = m_preferredCrtcs.find(connector->id());
+    if (knownCrtc != m_preferredCrtcs.end() || m_atomicModeSetting) {
+        // try the crtc that worked with the same set of outputs before, or the
+        // crtc that this connector is already connected to first
+        const uint32_t id = knownCrtc != m_preferredCrtcs.end() ? knownCrtc->second : connector->crtcId.value();
         auto it = std::ranges::find_if(crtcs, [id](const DrmCrtc *crtc) {
             return id == crtc->id();
         });
@@ -452,10 +463,39 @@ DrmPipeline::Error DrmGpu::testPendingConfiguration()
             return c1->crtcId.value() > c2->crtcId.value();
         });
     }
+    // when the same outputs have been enabled before, for example when re-docking a laptop,
+    // start with the crtc assignment that worked back then instead of searching for one again
+    QList<uint32_t> enabledConnectors;
+    for (DrmConnector *connector : std::as_const(connectors)) {
+        const auto it = m_pipelineMap.find(connector);
+        if (it != m_pipelineMap.end() && it->second->enabled() && connector->isConnected()) {
+            enabledConnectors.push_back(connector->id());
+        }
+    }
+    std::ranges::sort(enabledConnectors);
+    m_preferredCrtcs = m_knownCrtcAssignments.value(enabledConnectors);
+    const auto rememberAssignment = [this, &enabledConnectors](DrmPipeline::Error err) {
+        m_preferredCrtcs.clear();
+        if (err != DrmPipeline::Error::None) {
+            return err;
+        }
+        std::unordered_map<uint32_t, uint32_t> assignment;
+        for (const uint32_t connectorId : std::as_const(enabledConnectors)) {
+            const auto it = std::ranges::find_if(m_pipelineMap, [connectorId](const auto &pair) {
+                return pair.first->id() == connectorId;
+            });
+            if (it != m_pipelineMap.end() && it->second->crtc()) {
+                assignment[connectorId] = it->second->crtc()->id();
+            }
+        }
+        m_knownCrtcAssignments[enabledConnectors] = std::move(assignment);
+        return err;
+    };
+
     m_forceLowBandwidthMode = false;
     auto err = checkCrtcAssignment(connectors, crtcs, std::chrono::steady_clock::now() + s_checkCrtcTimeout);
     if (err == DrmPipeline::Error::None || err == DrmPipeline::Error::NoPermission || err == DrmPipeline::Error::FramePending) {
-        return err;
+        return rememberAssignment(err);
     }
     const bool hasPreferAccuracy = std::ranges::any_of(m_drmOutputs, [](const auto &output) {
         return output->colorPowerTradeoff() == BackendOutput::ColorPowerTradeoff::PreferAccuracy;
@@ -466,7 +506,47 @@ DrmPipeline::Error DrmGpu::testPendingConfiguration()
         m_forceLowBandwidthMode = true;
         err = checkCrtcAssignment(connectors, crtcs, std::chrono::steady_clock::now() + s_checkCrtcTimeout);
     }
-    return err;
+    return rememberAssignment(err);
+}
+
+bool DrmGpu::testCommit(DrmAtomicCommit *commit, const QList<DrmPipeline *> &pipelines)
+{
+    constexpr size_t maxCachedResults = 32;
+
+    // the test is done against the current state of everything that isn't in the commit,
+    // so the result can only be reused if the commit contains all active pipelines
+    const bool cacheable = std::ranges::all_of(m_pipelines, [&pipelines](DrmPipeline *pipeline) {
+        return pipelines.contains(pipeline) || (!pipeline->activePending() && !pipeline->output()->lease());
+    });
+    if (!cacheable) {
+        return commit->test();
+    }
+
+    std::vector<uint64_t> key = commit->testKey();
+    const size_t hash = qHashRange(key.begin(), key.end());
+    const auto it = std::ranges::find_if(m_testCache, [hash, &key](const TestResult &result) {
+        return result.hash == hash && result.key == key;
+    });
+    if (it != m_testCache.end()) {
+        errno = it->error;
+        return it->error == 0;
+    }
+
+    const bool success = commit->test();
+    if (m_testCache.size() >= maxCachedResults) {
+        m_testCache.pop_front();
+    }
+    m_testCache.push_back(TestResult{
+        .hash = hash,
+        .key = std::move(key),
+        .error = success ? 0 : errno,
+    });
+    return success;
+}
+
+void DrmGpu::invalidateTestCache()
+{
+    m_testCache.clear();
 }
 
 void DrmGpu::releaseUnusedBuffers()
@@ -633,6 +713,11 @@ void DrmGpu::registerPendingCommit(std::unique_lock<std::mutex> &lock, uint32_t
     m_pendingCommits[crtcId] = commit;
 }
 
+DrmCommitBatcher *DrmGpu::commitBatcher() const
+{
+    return m_commitBatcher.get();
+}
+
 void DrmGpu::removeOutput(DrmOutput *output)
 {
     qCDebug(KWIN_DRM) << "Removing output" << output;
@@ -767,6 +852,8 @@ void DrmGpu::setActive(bool active)
 {
     if (m_isActive != active) {
         m_isActive = active;
+        // another drm master may have changed anything while we were inactive
+        invalidateTestCache();
         if (active) {
             for (const DrmOutput *output : std::as_const(m_drmOutputs)) {
                 output->renderLoop()->uninhibit();
@@ -851,6 +938,7 @@ void DrmGpu::doModeset()
         return;
     }
     m_inModeset = true;
+    invalidateTestCache();
     const DrmPipeline::Error err = DrmPipeline::commitPipelines(pipelines, this, DrmPipeline::CommitMode::CommitModeset, unusedModesetObjects());
     for (DrmPipeline *pipeline : std::as_const(pipelines)) {
         if (pipeline->modesetPresentPending()) {
@@ -972,7 +1060,7 @@ void DrmGpu::assignOutputLayers()
     }
 }
 
-std::shared_ptr<DrmFramebuffer> DrmGpu::importBuffer(GraphicsBuffer *buffer, FileDescriptor &&readFence)
+std::shared_ptr<DrmFramebuffer> DrmGpu::importBuffer(GraphicsBuffer *buffer, FileDescriptor &&readFence, DrmFramebuffer::Sync sync)
 {
     const DmaBufAttributes *attributes = buffer->dmabufAttributes();
     if (Q_UNLIKELY(!attributes)) {
@@ -981,7 +1069,11 @@ std::shared_ptr<DrmFramebuffer> DrmGpu::importBuffer(GraphicsBuffer *buffer, Fil
 
     const auto it = m_fbCache.constFind(buffer);
     if (it != m_fbCache.constEnd()) {
-        return std::make_shared<DrmFramebuffer>(it->lock(), buffer, std::move(readFence));
+        const auto fbData = it->lock();
+        if (fbData) {
+            retainFramebuffer(fbData);
+        }
+        return std::make_shared<DrmFramebuffer>(fbData, buffer, std::move(readFence), sync);
     }
 
     uint32_t handles[] = {0, 0, 0, 0};
@@ -1055,7 +1147,27 @@ std::shared_ptr<DrmFramebuffer> DrmGpu::importBuffer(GraphicsBuffer *buffer, Fil
     auto fbData = std::make_shared<DrmFramebufferData>(this, framebufferId, buffer);
     m_fbCache[buffer] = fbData;
     connect(buffer, &GraphicsBuffer::destroyed, this, &DrmGpu::forgetBufferObject);
-    return std::make_shared<DrmFramebuffer>(fbData, buffer, std::move(readFence));
+    retainFramebuffer(fbData);
+    return std::make_shared<DrmFramebuffer>(fbData, buffer, std::move(readFence), sync);
+}
+
+void DrmGpu::retainFramebuffer(const std::shared_ptr<DrmFramebufferData> &data)
+{
+    // Clients cycle through a few buffers, keeping their framebuffers around when they're not
+    // scanned out for a while avoids importing them again when they get promoted again
+    static constexpr size_t maxRetainedFramebuffers = 16;
+
+    const auto it = std::ranges::find(m_retainedFramebuffers, data);
+    if (it != m_retainedFramebuffers.end()) {
+        std::rotate(it, it + 1, m_retainedFramebuffers.end());
+        return;
+    }
+    m_retainedFramebuffers.push_back(data);
+    if (m_retainedFramebuffers.size() > maxRetainedFramebuffers) {
+        // destroying the framebuffer removes it from m_fbCache, take it out of the list first
+        const auto evicted = std::move(m_retainedFramebuffers.front());
+        m_retainedFramebuffers.pop_front();
+    }
 }
 
 void DrmGpu::forgetBuffer(GraphicsBuffer *buf)
@@ -1066,7 +1178,15 @@ void DrmGpu::forgetBuffer(GraphicsBuffer *buf)
 
 void DrmGpu::forgetBufferObject(QObject *buf)
 {
-    m_fbCache.remove(static_cast<GraphicsBuffer *>(buf));
+    const auto it = m_fbCache.find(static_cast<GraphicsBuffer *>(buf));
+    if (it == m_fbCache.end()) {
+        return;
+    }
+    const auto fbData = it->lock();
+    m_fbCache.erase(it);
+    if (fbData) {
+        std::erase(m_retainedFramebuffers, fbData);
+    }
 }
 
 QList<OutputLayer *> DrmGpu::compatibleOutputLayers(BackendOutput *output) const
@@ -22,6 +22,7 @@
 #include <QTimer>
 
 #include <chrono>
+#include <deque>
 #include <epoxy/egl.h>
 #include <mutex>
 #include <sys/types.h>
@@ -44,6 +45,7 @@ class GraphicsBuffer;
 class GraphicsBufferAllocator;
 class OutputFrame;
 class DrmCommit;
+class DrmCommitBatcher;
 class RenderDevice;
 
 class DrmLease : public QObject
@@ -112,11 +114,18 @@ public:
     void removeOutputs();
 
     DrmPipeline::Error testPendingConfiguration();
+    /**
+     * Does an atomic test of @p commit, which contains the state of @p pipelines. If the same
+     * state has been tested before and the other pipelines can't influence the result, the
+     * previous result is returned instead. On failure, errno is set as by the test ioctl.
+     */
+    bool testCommit(DrmAtomicCommit *commit, const QList<DrmPipeline *> &pipelines);
+    void invalidateTestCache();
     void releaseUnusedBuffers();
     bool needsModeset() const;
     void maybeModeset(DrmPipeline *pipeline, const std::shared_ptr<OutputFrame> &frame);
 
-    std::shared_ptr<DrmFramebuffer> importBuffer(GraphicsBuffer *buffer, FileDescriptor &&explicitFence);
+    std::shared_ptr<DrmFramebuffer> importBuffer(GraphicsBuffer *buffer, FileDescriptor &&explicitFence, DrmFramebuffer::Sync sync = DrmFramebuffer::Sync::Implicit);
     void forgetBuffer(GraphicsBuffer *buf);
     void releaseBuffers();
     void createLayers();
@@ -132,6 +141,12 @@ public:
     std::unique_lock<std::mutex> lockPendingCommits();
     void registerPendingCommit(std::unique_lock<std::mutex> &lock, uint32_t crtcId, DrmCommit *commit);
 
+    /**
+     * Returns the batcher that merges commits of different CRTCs, or @c null if commits
+     * shouldn't be batched on this GPU.
+     */
+    DrmCommitBatcher *commitBatcher() const;
+
 Q_SIGNALS:
     void activeChanged(bool active);
     void outputAdded(BackendOutput *output);
@@ -143,6 +158,7 @@ private:
     void removeOutput(DrmOutput *output);
     void initDrmResources();
     void forgetBufferObject(QObject *buf);
+    void retainFramebuffer(const std::shared_ptr<DrmFramebufferData> &data);
     void doModeset();
     void setRenderDevice(RenderDevice *device);
     void updateRenderDevice();
@@ -152,6 +168,13 @@ private:
     QList<DrmObject *> unusedModesetObjects() const;
     void assignOutputLayers();
 
+    struct TestResult
+    {
+        size_t hash;
+        std::vector<uint64_t> key;
+        int error;
+    };
+
     static void pageFlipHandler(int fd, unsigned int sequence, unsigned int sec, unsigned int usec, unsigned int crtc_id, void *user_data);
 
     const int m_fd;
@@ -176,6 +199,8 @@ private:
     // declared before every member that can own a DrmCommit, so it outlives them
     std::unordered_map<uint32_t, DrmCommit *> m_pendingCommits;
     std::mutex m_pendingCommitsMutex;
+    // used by the commit threads, so it must outlive the pipelines
+    std::unique_ptr<DrmCommitBatcher> m_commitBatcher;
 
     std::vector<std::unique_ptr<DrmPlane>> m_planes;
     std::vector<std::unique_ptr<DrmCrtc>> m_crtcs;
@@ -194,8 +219,14 @@ private:
     std::unordered_map<DrmPipeline *, std::shared_ptr<OutputFrame>> m_pendingModesetFrames;
     bool m_inModeset = false;
     QHash<GraphicsBuffer *, std::weak_ptr<DrmFramebufferData>> m_fbCache;
+    // the framebuffers of the most recently imported buffers, the least recently used one first
+    std::deque<std::shared_ptr<DrmFramebufferData>> m_retainedFramebuffers;
     std::vector<std::unique_ptr<DrmCommit>> m_defunctCommits;
     QTimer m_delayedModesetTimer;
+    std::deque<TestResult> m_testCache;
+    // connector to crtc ids that worked for a sorted list of enabled connectors
+    QHash<QList<uint32_t>, std::unordered_map<uint32_t, uint32_t>> m_knownCrtcAssignments;
+    std::unordered_map<uint32_t, uint32_t> m_preferredCrtcs;
 };
 
 }
@@ -152,4 +152,9 @@ QList<QSize> DrmPipelineLayer::recommendedSizes() const
     }
 }
 
+bool DrmPipelineLayer::fallBackToSaferModifier()
+{
+    return false;
+}
+
 }
@@ -42,6 +42,12 @@ public:
     FormatModifierMap supportedAsyncDrmFormats() const override;
 
     virtual std::shared_ptr<DrmFramebuffer> currentBuffer() const = 0;
+    /**
+     * Called when the presentation test failed, to switch the buffers that KWin renders into
+     * to a more conservative modifier.
+     * @returns @c true if the layer has new buffers for another test
+     */
+    virtual bool fallBackToSaferModifier();
 
     DrmPlane *plane() const;
 
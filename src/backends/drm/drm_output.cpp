@@ -30,6 +30,7 @@
 #include <QMatrix4x4>
 // c++
 #include <cerrno>
+#include <cmath>
 // drm
 #include <drm_fourcc.h>
 #include <libdrm/drm_mode.h>
@@ -314,6 +315,16 @@ bool DrmOutput::testPresentation(const std::shared_ptr<OutputFrame> &frame)
         m_pipeline->setPresentationMode(PresentationMode::VSync);
         err = m_pipeline->testPresent(frame);
     }
+    if (err != DrmPipeline::Error::None) {
+        // compressed and tiled buffers can have restrictions the formats of the planes don't tell us about
+        bool retry = false;
+        for (DrmPipelineLayer *layer : layers) {
+            retry |= layer->fallBackToSaferModifier();
+        }
+        if (retry) {
+            err = m_pipeline->testPresent(frame);
+        }
+    }
     return err == DrmPipeline::Error::None;
 }
 
@@ -729,10 +740,73 @@ void DrmOutput::setChannelFactors(const QVector3D &rgb)
     m_sRgbChannelFactors = rgb;
     State next = m_state;
     next.colorDescription = applyNightLight(next.originalColorDescription, m_sRgbChannelFactors);
-    tryKmsColorOffloading(next);
+    if (!tryUpdateCrtcNightLight(next)) {
+        tryKmsColorOffloading(next);
+    }
     setState(next);
 }
 
+static bool hasSameOperations(const ColorPipeline &left, const ColorPipeline &right)
+{
+    return left.inputSpace == right.inputSpace && std::ranges::equal(left.ops, right.ops, [](const ColorOp &leftOp, const ColorOp &rightOp) {
+        return leftOp.operation.index() == rightOp.operation.index()
+            && leftOp.inputSpace == rightOp.inputSpace
+            && leftOp.outputSpace == rightOp.outputSpace;
+    });
+}
+
+bool DrmOutput::tryUpdateCrtcNightLight(State &next)
+{
+    // Night light transitions change the white point in many small steps. If the crtc already converts
+    // from the blending color to the output, the scene can keep blending in the previous blending color,
+    // and only the values in the crtc color pipeline need to change. The values in the kms properties don't
+    // affect whether the driver accepts a commit, so the pipeline isn't tested, it gets committed with the
+    // next presentation, without rendering anything. Blending with a slightly wrong white point is only
+    // noticeable in saturated colors, so once it's too far off, the blending color is updated again.
+    constexpr double maxWhitePointDistance = 0.005;
+    constexpr TransferFunction::Type blendingSpace = TransferFunction::gamma22;
+
+    if (!m_gpu->atomicModeSetting() || !m_pipeline->activePending() || m_pipeline->layers().empty() || m_lease) {
+        return false;
+    }
+    const ColorPipeline &currentPipeline = m_pipeline->crtcColorPipeline();
+    if (m_needsShadowBuffer || currentPipeline.isIdentity() || next.layerBlendingColor != next.blendingColor) {
+        return false;
+    }
+    const bool hdr = next.highDynamicRange && (capabilities() & Capability::HighDynamicRange);
+    const ColorProfileSource profileSource = hdr ? next.hdrColorProfileSource : next.colorProfileSource;
+    const bool usesICC = profileSource == ColorProfileSource::ICC && (hdr ? next.hdrIccProfile : next.iccProfile);
+    if (usesICC || next.colorPowerTradeoff == ColorPowerTradeoff::PreferAccuracy || next.colorDescription->transferFunction().type != blendingSpace) {
+        return false;
+    }
+
+    const xy retainedWhite = next.blendingColor->containerColorimetry().white().toxy();
+    const xy targetWhite = next.colorDescription->containerColorimetry().white().toxy();
+    if (std::hypot(retainedWhite.x - targetWhite.x, retainedWhite.y - targetWhite.y) > maxWhitePointDistance) {
+        return false;
+    }
+
+    // the same pipelines as in tryKmsColorOffloading, but the scene contents are interpreted as being
+    // encoded in the new blending color
+    const auto encoding = next.originalColorDescription->withReference(next.colorDescription->referenceLuminance());
+    ColorPipeline pipeline = ColorPipeline::create(next.colorDescription, encoding, RenderingIntent::AbsoluteColorimetricNoAdaptation);
+    if (!hasSameOperations(pipeline, currentPipeline)) {
+        pipeline = ColorPipeline(ValueRange{0, 1}, ColorspaceType::NonLinearRGB);
+        pipeline.addMatrix(next.colorDescription->toOther(*encoding, RenderingIntent::AbsoluteColorimetricNoAdaptation), pipeline.currentOutputRange(), ColorspaceType::NonLinearRGB);
+        if (!hasSameOperations(pipeline, currentPipeline)) {
+            return false;
+        }
+    }
+    if (!m_pipeline->crtc()->postBlendingPipeline || !m_pipeline->crtc()->postBlendingPipeline->matchPipeline(m_gpu, pipeline)) {
+        return false;
+    }
+
+    m_pipeline->setCrtcColorPipeline(pipeline);
+    m_pipeline->applyPendingChanges();
+    m_renderLoop->scheduleRepaint();
+    return true;
+}
+
 void DrmOutput::tryKmsColorOffloading(State &next)
 {
     if (!m_pipeline->activePending() || m_pipeline->layers().empty() || m_lease) {
@@ -78,6 +78,7 @@ public:
 
 private:
     void tryKmsColorOffloading(State &next);
+    bool tryUpdateCrtcNightLight(State &next);
     double calculateMaxArtificialHdrHeadroom(const State &next) const;
     std::shared_ptr<ColorDescription> createColorDescription(const State &next) const;
     Capabilities computeCapabilities() const;
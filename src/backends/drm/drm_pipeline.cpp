@@ -32,6 +32,8 @@
 #include <drm_fourcc.h>
 #include <gbm.h>
 
+#include <array>
+
 using namespace std::literals;
 
 namespace KWin
@@ -114,6 +116,10 @@ DrmPipeline::Error DrmPipeline::commitPipelines(const QList<DrmPipeline *> &pipe
 DrmPipeline::Error DrmPipeline::commitPipelinesAtomic(const QList<DrmPipeline *> &pipelines, DrmGpu *gpu, CommitMode mode, const std::shared_ptr<OutputFrame> &frame, const QList<DrmObject *> &unusedObjects)
 {
     const auto commit = std::make_unique<DrmAtomicCommit>(gpu, pipelines);
+    for (DrmPipeline *pipeline : pipelines) {
+        // the pending state may have changed, asynchronous updates have to be tested again
+        pipeline->m_lastAsyncTestKey.clear();
+    }
     if (mode == CommitMode::Test) {
         // if there's a modeset pending, the tests on top of that state
         // also have to allow modesets or they'll always fail
@@ -169,7 +175,7 @@ DrmPipeline::Error DrmPipeline::commitPipelinesAtomic(const QList<DrmPipeline *>
         return Error::None;
     }
     case CommitMode::Test: {
-        if (!commit->test()) {
+        if (!gpu->testCommit(commit.get(), pipelines)) {
             return errnoToError();
         }
         return Error::None;
@@ -486,16 +492,24 @@ bool DrmPipeline::presentAsync(OutputLayer *layer, std::optional<std::chrono::na
         return false;
     }
     const auto drmLayer = static_cast<DrmPipelineLayer *>(layer);
-    if (drmLayer->plane()) {
-        // test the full state, to take pending commits into account
-        if (DrmPipeline::commitPipelinesAtomic({this}, gpu(), CommitMode::Test, nullptr, {}) != Error::None) {
-            return false;
-        }
+    if (DrmPlane *plane = drmLayer->plane()) {
         // only give the actual state update to the commit thread, so that it can potentially reorder the commits
         auto partialUpdate = std::make_unique<DrmAtomicCommit>(gpu(), QList{this});
         partialUpdate->requestPageflipEvent(m_pending.crtc->id());
-        prepareAtomicPlane(partialUpdate.get(), drmLayer->plane(), drmLayer, nullptr);
+        prepareAtomicPlane(partialUpdate.get(), plane, drmLayer, nullptr);
         partialUpdate->setAllowedVrrDelay(allowedVrrDelay);
+
+        // Moving the plane, which is all that happens for most cursor updates, doesn't change
+        // whether the state works. Only test the full state, to take pending commits into account,
+        // if something else changed since the last successful test
+        const std::array positionProperties{plane->crtcX.propId(), plane->crtcY.propId()};
+        std::vector<uint64_t> testKey = partialUpdate->testKey(positionProperties);
+        if (testKey != m_lastAsyncTestKey) {
+            if (DrmPipeline::commitPipelinesAtomic({this}, gpu(), CommitMode::Test, nullptr, {}) != Error::None) {
+                return false;
+            }
+            m_lastAsyncTestKey = std::move(testKey);
+        }
         m_commitThread->addCommit(std::move(partialUpdate));
         return true;
     } else {
@@ -669,6 +683,11 @@ void DrmPipeline::setRgbRange(BackendOutput::RgbRange range)
     m_pending.rgbRange = range;
 }
 
+const ColorPipeline &DrmPipeline::crtcColorPipeline() const
+{
+    return m_pending.crtcColorPipeline;
+}
+
 void DrmPipeline::setCrtcColorPipeline(const ColorPipeline &pipeline)
 {
     m_pending.crtcColorPipeline = pipeline;
@@ -94,6 +94,7 @@ public:
     BackendOutput::RgbRange rgbRange() const;
     DrmConnector::DrmContentType contentType() const;
     const std::shared_ptr<IccProfile> &iccProfile() const;
+    const ColorPipeline &crtcColorPipeline() const;
 
     void setCrtc(DrmCrtc *crtc);
     void setMode(const std::shared_ptr<DrmConnectorMode> &mode);
@@ -172,6 +173,9 @@ private:
     State m_next;
 
     std::unique_ptr<DrmCommitThread> m_commitThread;
+    // describes the last asynchronous plane update that has been tested successfully
+    // on top of the pending state, without the position of the plane
+    std::vector<uint64_t> m_lastAsyncTestKey;
 };
 
 }
@@ -30,6 +30,7 @@
 #include <QDBusConnection>
 #include <QMutexLocker>
 #include <QSocketNotifier>
+#include <QThread>
 
 #include <cmath>
 #include <libinput.h>
@@ -127,7 +128,10 @@ Connection::Connection(std::unique_ptr<Context> &&input)
 
 Connection::~Connection()
 {
-    m_eventQueue.clear();
+    while (m_eventQueue.pop()) {
+    }
+    while (m_processedEvents.pop()) {
+    }
     qDeleteAll(m_devices);
     qDeleteAll(m_tools);
 }
@@ -141,7 +145,7 @@ void Connection::doSetup()
 {
     Q_ASSERT(!m_notifier);
 
-    gainRealTime();
+    gainRealTime(RealTimeRole::Input, QThread::currentThread()->objectName());
 
     m_notifier = std::make_unique<QSocketNotifier>(m_input->fileDescriptor(), QSocketNotifier::Read);
     connect(m_notifier.get(), &QSocketNotifier::activated, this, &Connection::handleEvent);
@@ -171,20 +175,43 @@ void Connection::deactivate()
 void Connection::handleEvent()
 {
     QMutexLocker locker(&m_mutex);
-    const bool wasEmpty = m_eventQueue.empty();
+    // libinput isn't thread-safe, so the events are destroyed in this thread as well
+    while (m_processedEvents.pop()) {
+    }
+
+    bool added = false;
     do {
+        if (m_eventQueue.isFull()) {
+            // leave the remaining events in libinput's queue, the main thread
+            // reschedules this once it has caught up
+            m_stalled = true;
+            if (m_eventQueue.isFull()) {
+                break;
+            }
+            m_stalled = false;
+        }
         m_input->dispatch();
         std::unique_ptr<Event> event = m_input->event();
         if (!event) {
             break;
         }
-        m_eventQueue.push_back(std::move(event));
+        m_eventQueue.push(std::move(event));
+        added = true;
     } while (true);
-    if (wasEmpty && !m_eventQueue.empty()) {
+    // only one wakeup per batch, the main thread processes all events that are queued by then
+    if (added && !m_wakeupPending.exchange(true)) {
         Q_EMIT eventsRead();
     }
 }
 
+void Connection::recycle(std::unique_ptr<Event> &&event)
+{
+    if (!m_processedEvents.push(std::move(event))) {
+        QMutexLocker locker(&m_mutex);
+        event.reset();
+    }
+}
+
 #ifndef KWIN_BUILD_TESTING
 QPointF devicePointToGlobalPosition(const QPointF &devicePos, const BackendOutput *output)
 {
@@ -260,12 +287,13 @@ TabletTool *Connection::getOrCreateTool(libinput_tablet_tool *handle)
 
 void Connection::processEvents()
 {
-    QMutexLocker locker(&m_mutex);
-    while (m_eventQueue.size() != 0) {
-        std::unique_ptr<Event> event = std::move(m_eventQueue.front());
-        m_eventQueue.pop_front();
+    m_wakeupPending = false;
+    while (std::optional<std::unique_ptr<Event>> next = m_eventQueue.pop()) {
+        std::unique_ptr<Event> event = std::move(*next);
         switch (event->type()) {
         case LIBINPUT_EVENT_DEVICE_ADDED: {
+            // the device gets configured, which must not race with the connection thread
+            QMutexLocker locker(&m_mutex);
             auto device = new Device(event->nativeDevice());
             device->moveToThread(thread());
             m_devices << device;
@@ -369,17 +397,16 @@ void Connection::processEvents()
             auto delta = pe->delta();
             auto deltaNonAccel = pe->deltaUnaccelerated();
             auto latestTime = pe->time();
-            auto it = m_eventQueue.begin();
-            while (it != m_eventQueue.end()) {
-                if ((*it)->type() == LIBINPUT_EVENT_POINTER_MOTION) {
-                    std::unique_ptr<PointerEvent> p{static_cast<PointerEvent *>(it->release())};
-                    delta += p->delta();
-                    deltaNonAccel += p->deltaUnaccelerated();
-                    latestTime = p->time();
-                    it = m_eventQueue.erase(it);
-                } else {
+            while (std::unique_ptr<Event> *next = m_eventQueue.peek()) {
+                if ((*next)->type() != LIBINPUT_EVENT_POINTER_MOTION) {
                     break;
                 }
+                std::unique_ptr<Event> motion = std::move(*m_eventQueue.pop());
+                const PointerEvent *p = static_cast<PointerEvent *>(motion.get());
+                delta += p->delta();
+                deltaNonAccel += p->deltaUnaccelerated();
+                latestTime = p->time();
+                recycle(std::move(motion));
             }
             Q_EMIT pe->device()->pointerMotion(delta, deltaNonAccel, latestTime, pe->device());
             Q_EMIT pe->device()->pointerFrame(pe->device());
@@ -609,6 +636,11 @@ void Connection::processEvents()
             // nothing
             break;
         }
+        recycle(std::move(event));
+    }
+
+    if (m_stalled.exchange(false)) {
+        QMetaObject::invokeMethod(this, &Connection::handleEvent, Qt::QueuedConnection);
     }
 }
 
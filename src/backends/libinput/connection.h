@@ -9,6 +9,7 @@
 #pragma once
 
 #include "effect/globals.h"
+#include "utils/spscqueue.h"
 
 #include <KSharedConfig>
 
@@ -18,7 +19,8 @@
 #include <QRecursiveMutex>
 #include <QSize>
 #include <QStringList>
-#include <deque>
+
+#include <atomic>
 
 class QSocketNotifier;
 class QThread;
@@ -78,6 +80,7 @@ private Q_SLOTS:
 private:
     Connection(std::unique_ptr<Context> &&input);
     void handleEvent();
+    void recycle(std::unique_ptr<Event> &&event);
     void applyDeviceConfig(Device *device);
     void applyScreenToDevice(Device *device);
     void doSetup();
@@ -85,7 +88,16 @@ private:
 
     std::unique_ptr<QSocketNotifier> m_notifier;
     QRecursiveMutex m_mutex;
-    std::deque<std::unique_ptr<Event>> m_eventQueue;
+    /**
+     * The events read by the connection thread, waiting to be processed by the main thread
+     */
+    SpscQueue<std::unique_ptr<Event>, 1024> m_eventQueue;
+    /**
+     * The events processed by the main thread, waiting to be destroyed in the connection thread
+     */
+    SpscQueue<std::unique_ptr<Event>, 1024> m_processedEvents;
+    std::atomic<bool> m_wakeupPending = false;
+    std::atomic<bool> m_stalled = false;
     QList<Device *> m_devices;
     QList<TabletTool *> m_tools;
     KSharedConfigPtr m_config;
@@ -160,6 +160,7 @@ enum class ConfigKey {
     TabletToolPressureRangeMax,
     InputArea,
     TabletToolRelativeMode,
+    TabletToolCursorPrediction,
     Rotation,
     OutputUuid,
 };
@@ -269,6 +270,7 @@ static const QMap<ConfigKey, std::shared_ptr<ConfigDataBase>> s_configData{
     {ConfigKey::TabletToolPressureRangeMax, std::make_shared<ConfigData<double>>(QByteArrayLiteral("TabletToolPressureRangeMax"), &Device::setPressureRangeMax, &Device::defaultPressureRangeMax)},
     {ConfigKey::InputArea, std::make_shared<ConfigData<QRectF>>(QByteArrayLiteral("InputArea"), &Device::setInputArea, &Device::defaultInputArea)},
     {ConfigKey::TabletToolRelativeMode, std::make_shared<ConfigData<bool>>(QByteArrayLiteral("TabletToolRelativeMode"), &Device::setTabletToolRelative, &Device::defaultTabletToolIsRelative)},
+    {ConfigKey::TabletToolCursorPrediction, std::make_shared<ConfigData<uint32_t>>(QByteArrayLiteral("TabletToolCursorPrediction"), &Device::setTabletToolCursorPrediction, &Device::defaultTabletToolCursorPrediction)},
     {ConfigKey::Rotation, std::make_shared<ConfigData<uint32_t>>(QByteArrayLiteral("Rotation"), &Device::setRotation, &Device::defaultRotation)},
 };
 
@@ -1160,6 +1162,19 @@ void Device::setTabletToolRelative(bool relative)
     Q_EMIT tabletToolRelativeChanged();
 }
 
+void Device::setTabletToolCursorPrediction(uint32_t milliseconds)
+{
+    // predicting further ahead than a few frames is just guessing
+    milliseconds = std::min(milliseconds, 50u);
+    if (milliseconds == m_tabletToolCursorPrediction) {
+        return;
+    }
+
+    m_tabletToolCursorPrediction = milliseconds;
+    writeEntry(ConfigKey::TabletToolCursorPrediction, m_tabletToolCursorPrediction);
+    Q_EMIT tabletToolCursorPredictionChanged();
+}
+
 QList<unsigned int> Device::numModes() const
 {
     const int numGroups = libinput_device_tablet_pad_get_num_mode_groups(m_device);
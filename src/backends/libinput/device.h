@@ -189,6 +189,8 @@ class KWIN_EXPORT Device : public InputDevice
     Q_PROPERTY(double defaultPressureRangeMax READ defaultPressureRangeMax CONSTANT)
 
     Q_PROPERTY(bool tabletToolIsRelative READ tabletToolIsRelative WRITE setTabletToolRelative NOTIFY tabletToolRelativeChanged)
+    /// how far ahead the cursor of the tool is predicted, in milliseconds
+    Q_PROPERTY(uint32_t tabletToolCursorPrediction READ tabletToolCursorPrediction WRITE setTabletToolCursorPrediction NOTIFY tabletToolCursorPredictionChanged)
     Q_PROPERTY(bool supportsRotation READ supportsRotation CONSTANT)
     /// rotation angle, as 0 to 360 degrees
     Q_PROPERTY(uint32_t rotation READ rotation WRITE setRotation NOTIFY rotationChanged)
@@ -774,6 +776,18 @@ public:
         return defaultValue("TabletToolRelativeMode", false);
     }
 
+    uint32_t tabletToolCursorPrediction() const override
+    {
+        return m_tabletToolCursorPrediction;
+    }
+
+    void setTabletToolCursorPrediction(uint32_t milliseconds);
+
+    uint32_t defaultTabletToolCursorPrediction() const
+    {
+        return defaultValue("TabletToolCursorPrediction", 0u);
+    }
+
     QList<unsigned int> numModes() const;
     QList<unsigned int> currentModes() const;
 
@@ -816,6 +830,7 @@ Q_SIGNALS:
     void pressureRangeMaxChanged();
     void inputAreaChanged();
     void tabletToolRelativeChanged();
+    void tabletToolCursorPredictionChanged();
     void rotationChanged();
     void currentModesChanged();
 
@@ -923,6 +938,7 @@ private:
 
     QRectF m_inputArea;
     bool m_tabletToolIsRelative = false;
+    uint32_t m_tabletToolCursorPrediction = 0;
     QList<unsigned int> m_currentModes;
     bool m_isVirtual = false;
 };
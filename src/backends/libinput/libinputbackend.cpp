@@ -7,6 +7,8 @@
 #include "libinputbackend.h"
 #include "connection.h"
 #include "device.h"
+#include "wayland/display.h"
+#include "wayland_server.h"
 
 namespace KWin
 {
@@ -22,6 +24,11 @@ LibinputBackend::LibinputBackend(Session *session, QObject *parent)
 
     connect(m_connection, &LibInput::Connection::eventsRead, this, [this]() {
         m_connection->processEvents();
+        // The clients are usually flushed when the event loop is about to go idle, but it may
+        // have to composite a frame before that. Don't make the input wait for the rendering.
+        if (auto server = waylandServer()) {
+            server->display()->flush();
+        }
     }, Qt::QueuedConnection);
 
     connect(m_connection, &LibInput::Connection::deviceAdded,
@@ -53,6 +53,7 @@ std::optional<OutputLayerBeginFrameInfo> VirtualEglLayer::doBeginFrame()
         if (!m_swapchain) {
             return std::nullopt;
         }
+        m_damageJournal.clear();
     }
 
     m_current = m_swapchain->acquire();
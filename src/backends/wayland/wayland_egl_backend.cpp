@@ -26,6 +26,7 @@
 #include <KWayland/Client/subsurface.h>
 #include <KWayland/Client/surface.h>
 
+#include <algorithm>
 #include <cmath>
 #include <drm_fourcc.h>
 #include <fcntl.h>
@@ -38,6 +39,16 @@ namespace Wayland
 
 static const bool bufferAgeEnabled = qEnvironmentVariable("KWIN_USE_BUFFER_AGE") != QStringLiteral("0");
 
+// every overlay layer is a subsurface of the output surface that client buffers can be forwarded
+// to, instead of compositing them. Raising the count lets nested sessions with many windows
+// pass all of them through to the host compositor
+static int overlayLayerCount()
+{
+    bool ok = false;
+    const int count = qEnvironmentVariableIntValue("KWIN_WAYLAND_OVERLAY_LAYERS", &ok);
+    return ok ? std::clamp(count, 0, 64) : 4;
+}
+
 WaylandEglLayer::WaylandEglLayer(WaylandOutput *output, WaylandEglBackend *backend, OutputLayerType type, int zpos)
     : WaylandLayer(output, type, zpos)
     , m_backend(backend)
@@ -90,6 +101,7 @@ std::optional<OutputLayerBeginFrameInfo> WaylandEglLayer::doBeginFrame()
             qCWarning(KWIN_WAYLAND_BACKEND) << "Could not find a suitable render format";
             return std::nullopt;
         }
+        m_damageJournal.clear();
     }
 
     m_buffer = m_swapchain->acquire();
@@ -128,9 +140,12 @@ bool WaylandEglLayer::earlyScanoutChecks()
     return test();
 }
 
-bool WaylandEglLayer::importScanoutBuffer(GraphicsBuffer *buffer, const std::shared_ptr<OutputFrame> &frame)
+bool WaylandEglLayer::importScanoutBuffer(GraphicsBuffer *buffer, bool explicitSync, const std::shared_ptr<OutputFrame> &frame)
 {
     setBuffer(buffer, Region::infinite());
+    // the frames in between aren't in the journal, the swapchain buffers
+    // have to be repainted fully once compositing resumes
+    m_damageJournal.clear();
     return true;
 }
 
@@ -262,7 +277,8 @@ void WaylandEglBackend::createOutputLayers(BackendOutput *output)
     auto primary = std::make_unique<WaylandEglLayer>(waylandOutput, this, OutputLayerType::Primary, 0);
     primary->subSurface()->placeAbove(waylandOutput->surface());
     layers.push_back(std::move(primary));
-    for (int z = 1; z < 5; z++) {
+    static const int layerCount = overlayLayerCount();
+    for (int z = 1; z <= layerCount; z++) {
         auto layer = std::make_unique<WaylandEglLayer>(waylandOutput, this, OutputLayerType::GenericLayer, z);
         layer->subSurface()->placeAbove(static_cast<WaylandEglLayer *>(layers.back().get())->surface());
         layers.push_back(std::move(layer));
@@ -227,7 +227,7 @@ static void handlePresented(void *data,
     if (refresh != 0) {
         refreshRate = 1'000'000'000'000 / refresh;
     }
-    reinterpret_cast<WaylandOutput *>(data)->framePresented(timestamp, refreshRate);
+    reinterpret_cast<WaylandOutput *>(data)->framePresented(timestamp, refreshRate, flags & WP_PRESENTATION_FEEDBACK_KIND_HW_CLOCK);
 }
 
 static void handleSyncOutput(void *data, struct wp_presentation_feedback *, struct wl_output *)
@@ -340,8 +340,10 @@ void WaylandOutput::frameDiscarded()
     m_frames.pop_front();
 }
 
-void WaylandOutput::framePresented(std::chrono::nanoseconds timestamp, uint32_t refreshRate)
+void WaylandOutput::framePresented(std::chrono::nanoseconds timestamp, uint32_t refreshRate, bool hardwareClock)
 {
+    // without a hardware clock, the host compositor only knows roughly when the frame was presented
+    m_renderLoop->setVblankEstimationEnabled(!hardwareClock);
     if (refreshRate != this->refreshRate()) {
         m_refreshRate = refreshRate;
         const auto mode = std::make_shared<OutputMode>(OutputModeline(pixelSize(), m_refreshRate));
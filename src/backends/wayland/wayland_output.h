@@ -103,7 +103,7 @@ public:
     bool present(const QList<OutputLayer *> &layersToUpdate, const std::shared_ptr<OutputFrame> &frame) override;
 
     void frameDiscarded();
-    void framePresented(std::chrono::nanoseconds timestamp, uint32_t refreshRate);
+    void framePresented(std::chrono::nanoseconds timestamp, uint32_t refreshRate, bool hardwareClock);
 
     void applyChanges(const OutputConfiguration &config) override;
 
@@ -21,6 +21,8 @@
 namespace KWin
 {
 
+static const bool s_bufferAgeEnabled = qEnvironmentVariable("KWIN_USE_BUFFER_AGE") != QStringLiteral("0");
+
 X11WindowedEglPrimaryLayer::X11WindowedEglPrimaryLayer(X11WindowedEglBackend *backend, X11WindowedOutput *output)
     : OutputLayer(output, OutputLayerType::Primary)
     , m_output(output)
@@ -56,6 +58,7 @@ std::optional<OutputLayerBeginFrameInfo> X11WindowedEglPrimaryLayer::doBeginFram
         if (!m_swapchain) {
             return std::nullopt;
         }
+        m_damageJournal.clear();
     }
 
     m_buffer = m_swapchain->acquire();
@@ -63,7 +66,10 @@ std::optional<OutputLayerBeginFrameInfo> X11WindowedEglPrimaryLayer::doBeginFram
         return std::nullopt;
     }
 
-    Region repaint = Region::infinite();
+    // the whole pixmap gets presented, so exposed parts of the window are
+    // only repainted to make sure that a frame gets presented
+    Region repaint = s_bufferAgeEnabled ? m_damageJournal.accumulate(m_buffer->age(), Region::infinite()) : Region::infinite();
+    repaint |= m_output->exposedArea();
     m_output->clearExposedArea();
 
     m_query = std::make_unique<GLRenderTimeQuery>(m_backend->openglContextRef());
@@ -83,6 +89,7 @@ bool X11WindowedEglPrimaryLayer::doEndFrame(const Region &renderedDeviceRegion,
     EGLNativeFence releaseFence{m_backend->eglDisplayObject()};
     m_swapchain->release(m_buffer, releaseFence.fileDescriptor().duplicate());
     m_output->setPrimaryBuffer(m_buffer->buffer());
+    m_damageJournal.add(damagedDeviceRegion);
     return true;
 }
 
@@ -11,6 +11,7 @@
 #include "core/outputlayer.h"
 #include "opengl/eglbackend.h"
 #include "opengl/glutils.h"
+#include "utils/damagejournal.h"
 
 namespace KWin
 {
@@ -37,6 +38,7 @@ private:
     std::shared_ptr<EglSwapchain> m_swapchain;
     std::shared_ptr<EglSwapchainSlot> m_buffer;
     std::unique_ptr<GLRenderTimeQuery> m_query;
+    DamageJournal m_damageJournal;
     X11WindowedOutput *const m_output;
     X11WindowedEglBackend *const m_backend;
 };
@@ -26,9 +26,14 @@
 #include "dbusinterface.h"
 #include "effect/effecthandler.h"
 #include "ftrace.h"
+#include "idledetector.h"
+#include "input.h"
 #include "opengl/eglbackend.h"
+#include "opengl/glgpuprofiler.h"
 #include "opengl/glplatform.h"
 #include "renderloopdrivenqanimationdriver.h"
+#include "stalldetector.h"
+#include "startuptracer.h"
 #include "scene/cursoritem.h"
 #include "scene/itemrenderer_opengl.h"
 #include "scene/surfaceitem.h"
@@ -36,6 +41,7 @@
 #include "scene/workspacescene.h"
 #include "utils/common.h"
 #include "utils/envvar.h"
+#include "wayland/presentationtime.h"
 #include "wayland/surface.h"
 #include "wayland_server.h"
 #include "window.h"
@@ -69,6 +75,12 @@ Compositor *Compositor::self()
     return s_compositor;
 }
 
+// the frame interval while the user doesn't interact with the system, for example 100ms
+// limits outputs that only show a blinking cursor or a ticking clock to 10 frames per second
+static const bool s_cursorScanout = environmentVariableBoolValue("KWIN_CURSOR_DIRECT_SCANOUT").value_or(true);
+static const std::chrono::milliseconds s_lowActivityFrameInterval(qEnvironmentVariableIntValue("KWIN_LOW_ACTIVITY_FRAME_INTERVAL"));
+static constexpr std::chrono::milliseconds s_lowActivityTimeout = std::chrono::seconds(2);
+
 Compositor::Compositor(QObject *workspace)
     : QObject(workspace)
     , m_allowOverlaysEnv(environmentVariableBoolValue("KWIN_USE_OVERLAYS"))
@@ -87,6 +99,21 @@ Compositor::Compositor(QObject *workspace)
     });
 
     FTraceLogger::create();
+    m_stallDetector = new StallDetector(this);
+
+    if (s_lowActivityFrameInterval > std::chrono::milliseconds::zero() && input()) {
+        // idle inhibitors, like the ones of video players, keep the frame rate up
+        auto detector = new IdleDetector(s_lowActivityTimeout, IdleDetector::OperatingMode::FollowsInhibitors, this);
+        connect(detector, &IdleDetector::idle, this, [this]() {
+            m_lowActivity = true;
+        });
+        connect(detector, &IdleDetector::resumed, this, [this]() {
+            m_lowActivity = false;
+            for (const auto &[loop, view] : m_primaryViews) {
+                loop->setMinimumFrameInterval(std::chrono::nanoseconds::zero());
+            }
+        });
+    }
 
     connect(GpuManager::self(), &GpuManager::renderDeviceRemoved, this, [this](RenderDevice *device) {
         if (m_renderDevice != device) {
@@ -133,6 +160,7 @@ void Compositor::reinitialize()
 
 void Compositor::handleFrameRequested(RenderLoop *renderLoop)
 {
+    Q_EMIT aboutToComposite(renderLoop);
     composite(renderLoop);
 }
 
@@ -205,40 +233,35 @@ static RenderDevice *selectRenderDevice()
     if (devices.empty()) {
         return nullptr;
     }
-    const auto filterOutputs = [](RenderDevice *device) {
-        return kwinApp()->outputBackend()->outputs()
-            | std::views::filter([device](BackendOutput *output) {
-            return output->scanoutDevice()
-                && GpuManager::self()->compatibleRenderDevice(&*output->scanoutDevice()) == device;
-        })
-            | std::ranges::to<QList>();
+    // Every output that isn't driven by the chosen GPU needs its content copied over to the
+    // other GPU for every frame, so choose the GPU that needs to copy the fewest pixels.
+    // Internal displays count double, as they're usually the primary screen and keeping the
+    // integrated GPU in charge of them with only a single external display saves power
+    const auto copyCost = [](RenderDevice *device) {
+        qint64 ret = 0;
+        for (BackendOutput *output : kwinApp()->outputBackend()->outputs()) {
+            if (output->isNonDesktop() || !output->scanoutDevice()
+                || GpuManager::self()->compatibleRenderDevice(&*output->scanoutDevice()) == device) {
+                continue;
+            }
+            const QSize size = output->pixelSize();
+            ret += qint64(size.width()) * size.height() * (output->isInternal() ? 2 : 1);
+        }
+        return ret;
     };
-    std::unordered_map<RenderDevice *, QList<BackendOutput *>> outputs;
+    std::unordered_map<RenderDevice *, qint64> costs;
     for (const auto &device : devices) {
-        outputs[device.get()] = filterOutputs(device.get());
+        costs[device.get()] = copyCost(device.get());
     }
 
-    return std::ranges::min_element(devices, [&outputs](const auto &gpu1, const auto &gpu2) {
+    return std::ranges::min_element(devices, [&costs](const auto &gpu1, const auto &gpu2) {
         const bool software1 = gpu1->eglDisplay()->isSoftwareRenderer();
         const bool software2 = gpu2->eglDisplay()->isSoftwareRenderer();
         if (software1 != software2) {
             // avoid needing to do software rendering with the primary GPU
             return !software1;
         }
-
-        const auto &outputs1 = outputs[gpu1.get()];
-        const auto &outputs2 = outputs[gpu2.get()];
-        const size_t internalOutputs1 = std::ranges::count_if(outputs1, &BackendOutput::isInternal);
-        const size_t internalOutputs2 = std::ranges::count_if(outputs2, &BackendOutput::isInternal);
-        if (internalOutputs1 != internalOutputs2) {
-            return internalOutputs1 > internalOutputs2;
-        }
-        const size_t desktopOutputs1 = std::ranges::count_if(outputs1, std::not_fn(&BackendOutput::isNonDesktop));
-        const size_t desktopOutputs2 = std::ranges::count_if(outputs2, std::not_fn(&BackendOutput::isNonDesktop));
-        if (desktopOutputs1 != desktopOutputs2) {
-            return desktopOutputs1 > desktopOutputs2;
-        }
-        return outputs1.size() > outputs2.size();
+        return costs[gpu1.get()] < costs[gpu2.get()];
     })->get();
 }
 
@@ -379,8 +402,11 @@ void Compositor::start()
 
     m_state = State::On;
 
-    // Sets also the 'effects' pointer.
-    new EffectsHandler(this, kwinApp()->scene());
+    {
+        startupStage("Effects");
+        // Sets also the 'effects' pointer.
+        new EffectsHandler(this, kwinApp()->scene());
+    }
 
     Q_EMIT compositingToggled(true);
 }
@@ -455,18 +481,26 @@ static bool prepareDirectScanout(RenderView *view, LogicalOutput *logicalOutput,
         return false;
     }
     const auto layer = view->layer();
+    const auto fail = [layer](OutputLayerStatistics::ScanoutFailure failure) {
+        layer->statistics().scanoutFailures[size_t(failure)]++;
+        return false;
+    };
     const auto candidate = view->scanoutCandidate();
     if (!candidate) {
         layer->setScanoutCandidate(nullptr);
-        return false;
+        return fail(OutputLayerStatistics::ScanoutFailure::NoCandidate);
     }
     const auto buffer = candidate->buffer();
     if (!buffer) {
-        return false;
+        return fail(OutputLayerStatistics::ScanoutFailure::NoDmabuf);
     }
     const auto attrs = buffer->dmabufAttributes();
     if (!attrs) {
-        return false;
+        return fail(OutputLayerStatistics::ScanoutFailure::NoDmabuf);
+    }
+    if (candidate->bufferAcquireFence().isValid()) {
+        // the client is still rendering to the buffer, the renderer can wait for it on the GPU
+        return fail(OutputLayerStatistics::ScanoutFailure::PendingFence);
     }
     layer->setTargetRect(mapItemToOutputDeviceCoordinates(candidate, view, logicalOutput, backendOutput));
     layer->setEnabled(true);
@@ -475,18 +509,50 @@ static bool prepareDirectScanout(RenderView *view, LogicalOutput *logicalOutput,
     layer->setOffloadTransform(candidate->bufferTransform().combine(backendOutput->transform().inverted()));
     layer->setColor(candidate->colorDescription(), candidate->renderingIntent(), ColorPipeline::create(candidate->colorDescription(), backendOutput->layerBlendingColor(), candidate->renderingIntent()));
     if (!layer->earlyScanoutChecks()) {
-        return false;
+        return fail(OutputLayerStatistics::ScanoutFailure::EarlyChecks);
     }
     const bool tearing = frame->presentationMode() == PresentationMode::Async || frame->presentationMode() == PresentationMode::AdaptiveAsync;
     const auto formats = tearing ? layer->supportedAsyncDrmFormats() : layer->supportedDrmFormats();
-    if (!formats.containsFormat(attrs->format, attrs->modifier) || !layer->importScanoutBuffer(candidate->buffer(), frame)) {
+    std::optional<OutputLayerStatistics::ScanoutFailure> failure;
+    if (!formats.contains(attrs->format)) {
+        failure = OutputLayerStatistics::ScanoutFailure::UnsupportedFormat;
+    } else if (!formats.containsFormat(attrs->format, attrs->modifier)) {
+        failure = OutputLayerStatistics::ScanoutFailure::UnsupportedModifier;
+    } else if (!layer->importScanoutBuffer(candidate->buffer(), candidate->hasExplicitSync(), frame)) {
+        failure = OutputLayerStatistics::ScanoutFailure::ImportFailed;
+    }
+    if (failure) {
         layer->setScanoutCandidate(candidate);
         candidate->setScanoutHint(layer->scanoutDevice(), formats);
-        return false;
+        return fail(*failure);
     }
     return true;
 }
 
+/**
+ * Cursor planes usually can't scale and often only support a few buffer sizes,
+ * so only cursor surfaces that already match the plane are worth trying to scan out.
+ */
+static bool isCursorScanoutCandidate(RenderView *view, LogicalOutput *logicalOutput, BackendOutput *backendOutput)
+{
+    if (!s_cursorScanout) {
+        return false;
+    }
+    SurfaceItem *candidate = view->scanoutCandidate();
+    if (!candidate || !candidate->buffer() || !candidate->buffer()->dmabufAttributes()) {
+        return false;
+    }
+    const QSize bufferSize = candidate->buffer()->size();
+    if (candidate->bufferSourceBox() != RectF(QPointF(0, 0), bufferSize)) {
+        return false;
+    }
+    if (mapItemToOutputDeviceCoordinates(candidate, view, logicalOutput, backendOutput).size() != bufferSize) {
+        return false;
+    }
+    const auto recommendedSizes = view->layer()->recommendedSizes();
+    return recommendedSizes.isEmpty() || recommendedSizes.contains(bufferSize);
+}
+
 static bool prepareRendering(RenderView *view, LogicalOutput *logicalOutput, BackendOutput *backendOutput, uint32_t requiredAlphaBits)
 {
     if (!view->isVisible()) {
@@ -524,8 +590,18 @@ static bool renderLayer(RenderView *view, LogicalOutput *logicalOutput, BackendO
     }
     auto &[renderTarget, repaint] = beginInfo.value();
     const Region bufferDamage = surfaceDamage.united(repaint).intersected(renderTarget.transformedRect());
+    // only the primary layers get profiled, the others are usually cheap to render
+    GLGpuProfiler *profiler = view->layer()->type() == OutputLayerType::Primary ? GLGpuProfiler::current() : nullptr;
+    if (profiler) {
+        profiler->beginFrame(backendOutput->name());
+        profiler->beginSection(QStringLiteral("Total"));
+    }
     view->paint(renderTarget, view->renderOffset(), bufferDamage);
-    return view->layer()->endFrame(bufferDamage, surfaceDamage, frame.get());
+    const bool ret = view->layer()->endFrame(bufferDamage, surfaceDamage, frame.get());
+    if (profiler) {
+        profiler->endFrame();
+    }
+    return ret;
 }
 
 static OutputLayer *findLayer(std::span<OutputLayer *const> layers, OutputLayerType type)
@@ -629,8 +705,13 @@ std::pair<QList<Compositor::LayerData>, bool> Compositor::setupLayers(SceneView
                                                                       const QList<OutputLayer *> &outputLayers,
                                                                       const std::unordered_map<OutputLayer *, Item *> &assignments,
                                                                       const std::shared_ptr<OutputFrame> &frame,
-                                                                      std::unordered_set<OutputLayer *> &toUpdate)
+                                                                      std::unordered_set<OutputLayer *> &toUpdate,
+                                                                      bool *testFailed,
+                                                                      bool allowCursorScanout)
 {
+    if (testFailed) {
+        *testFailed = false;
+    }
     QList<OutputLayer *> unusedOutputLayers = outputLayers;
     QList<LayerData> layers;
 
@@ -693,6 +774,10 @@ std::pair<QList<Compositor::LayerData>, bool> Compositor::setupLayers(SceneView
                         }).value_or(30);
                         maxVrrCursorDelay = std::chrono::nanoseconds(1'000'000'000) / std::max(effectiveMinRate, 30u);
                     }
+                    if (cursorView->needsRepaint() && isCursorScanoutCandidate(cursorView, logicalOutput, backendOutput)) {
+                        // composite() scans out the new buffer of the cursor surface
+                        return;
+                    }
                     outputLayer->setTargetRect(mapGlobalLogicalToOutputDeviceCoordinates(cursorView->viewport(), logicalOutput, backendOutput));
                     outputLayer->setEnabled(true);
                     if (cursorView->needsRepaint() && prepareRendering(cursorView, logicalOutput, backendOutput, 8)) {
@@ -710,7 +795,7 @@ std::pair<QList<Compositor::LayerData>, bool> Compositor::setupLayers(SceneView
         }
         layers.push_back(LayerData{
             .view = view.get(),
-            .directScanout = !isCursor,
+            .directScanout = !isCursor || (allowCursorScanout && isCursorScanoutCandidate(view.get(), logicalOutput, backendOutput)),
             .directScanoutOnly = !isCursor,
             .highPriority = isCursor,
             .surfaceDamage = Region(),
@@ -723,15 +808,26 @@ std::pair<QList<Compositor::LayerData>, bool> Compositor::setupLayers(SceneView
     // disable entirely unused output layers
     for (OutputLayer *layer : unusedOutputLayers) {
         m_overlayViews[backendOutput->renderLoop()].erase(layer);
-        layer->setEnabled(false);
-        // TODO only add the layer to `toUpdate` when necessary
-        toUpdate.insert(layer);
+        // layers that are already disabled don't need to be part of the commit,
+        // otherwise pushing a frame that only changes the cursor or an overlay
+        // would needlessly touch all the other planes as well
+        if (layer->isEnabled()) {
+            layer->setEnabled(false);
+            toUpdate.insert(layer);
+        }
     }
 
     // import buffers and prepare rendering
     for (auto &layer : layers) {
         if (layer.directScanout && !prepareDirectScanout(layer.view, logicalOutput, backendOutput, frame)) {
-            return std::make_pair(layers, false);
+            if (layer.directScanoutOnly) {
+                return std::make_pair(layers, false);
+            }
+            // a cursor with a buffer that can't be scanned out is composited into the layer instead
+            layer.directScanout = false;
+        } else if (layer.directScanout && !layer.directScanoutOnly) {
+            const auto outputLayer = layer.view->layer();
+            outputLayer->setHotspot(backendOutput->transform().map(layer.view->hotspot() * layer.view->scale(), outputLayer->targetRect().size()));
         }
     }
     for (auto &layer : layers) {
@@ -739,7 +835,85 @@ std::pair<QList<Compositor::LayerData>, bool> Compositor::setupLayers(SceneView
             return std::make_pair(layers, false);
         }
     }
-    return std::make_pair(layers, backendOutput->testPresentation(frame));
+    const bool tested = backendOutput->testPresentation(frame);
+    if (testFailed) {
+        *testFailed = !tested;
+    }
+    if (!tested) {
+        for (const auto &layer : layers) {
+            if (layer.view->layer()->isEnabled()) {
+                layer.view->layer()->statistics().testFailures++;
+            }
+        }
+    }
+    return std::make_pair(layers, tested);
+}
+
+QList<Compositor::LayerConfigurationEntry> Compositor::describeLayerConfiguration(RenderView *view, LogicalOutput *logicalOutput, BackendOutput *backendOutput,
+                                                                                  const std::unordered_map<OutputLayer *, Item *> &assignments) const
+{
+    QList<LayerConfigurationEntry> ret;
+    bool hasScanoutItem = false;
+    for (const auto &[layer, item] : assignments) {
+        LayerConfigurationEntry entry{
+            .layer = layer,
+            .item = item,
+            .zpos = layer->zpos(),
+            .targetRect = Rect(),
+        };
+        // the scene and the cursor are composited, their buffers are always compatible with the layer
+        if (item != kwinApp()->scene()->containerItem() && !qobject_cast<CursorItem *>(item)) {
+            hasScanoutItem = true;
+            entry.targetRect = mapItemToOutputDeviceCoordinates(item, view, logicalOutput, backendOutput);
+            if (const auto surfaceItem = qobject_cast<SurfaceItem *>(item)) {
+                if (const auto attrs = surfaceItem->buffer() ? surfaceItem->buffer()->dmabufAttributes() : nullptr) {
+                    entry.format = attrs->format;
+                    entry.modifier = attrs->modifier;
+                }
+            }
+        }
+        ret.push_back(entry);
+    }
+    if (!hasScanoutItem) {
+        // falling back from this configuration wouldn't save anything
+        return {};
+    }
+    std::ranges::sort(ret, [](const LayerConfigurationEntry &left, const LayerConfigurationEntry &right) {
+        return left.zpos > right.zpos;
+    });
+    return ret;
+}
+
+bool Compositor::isKnownFailingLayerConfiguration(RenderLoop *renderLoop, const QList<LayerConfigurationEntry> &configuration)
+{
+    // conditions other than the configuration itself, like memory bandwidth, can change, so retry eventually
+    constexpr std::chrono::seconds retryDelay(5);
+
+    if (configuration.isEmpty()) {
+        return false;
+    }
+    auto &failed = m_failedLayerConfigurations[renderLoop];
+    const auto deadline = std::chrono::steady_clock::now() - retryDelay;
+    std::erase_if(failed, [deadline](const FailedLayerConfiguration &config) {
+        return config.time < deadline;
+    });
+    return std::ranges::any_of(failed, [&configuration](const FailedLayerConfiguration &config) {
+        return config.entries == configuration;
+    });
+}
+
+void Compositor::addFailingLayerConfiguration(RenderLoop *renderLoop, const QList<LayerConfigurationEntry> &configuration)
+{
+    constexpr size_t maxFailedConfigurations = 16;
+
+    auto &failed = m_failedLayerConfigurations[renderLoop];
+    if (failed.size() >= maxFailedConfigurations) {
+        failed.pop_front();
+    }
+    failed.push_back(FailedLayerConfiguration{
+        .entries = configuration,
+        .time = std::chrono::steady_clock::now(),
+    });
 }
 
 void Compositor::composite(RenderLoop *renderLoop)
@@ -815,6 +989,9 @@ void Compositor::composite(RenderLoop *renderLoop)
         frame->setPresentationMode(tearing ? PresentationMode::Async : PresentationMode::VSync);
     }
 
+    const bool limitFrameRate = m_lowActivity && !activeFullscreenItem && !m_renderLoopDrivenAnimationDriver->isRunning() && !(effects && effects->hasActiveFullScreenEffect());
+    renderLoop->setMinimumFrameInterval(limitFrameRate ? s_lowActivityFrameInterval : std::chrono::nanoseconds::zero());
+
     primaryView->prePaint(frame.get());
 
     // slowly adjust the artificial HDR headroom for the next frame. Note that
@@ -846,6 +1023,17 @@ void Compositor::composite(RenderLoop *renderLoop)
     const QList<Item *> layerCandidates = scene->layerCandidates(allowedOutputLayers.size());
     auto idealLayerAssignments = assignLayers(primaryView, layerCandidates, allowedOutputLayers);
 
+    // atomic tests with overlays can be slow, so don't test a configuration again
+    // that recently failed and go straight to the fallbacks instead
+    QList<LayerConfigurationEntry> idealConfiguration;
+    if (idealLayerAssignments.has_value()) {
+        idealConfiguration = describeLayerConfiguration(primaryView, logicalOutput, output, *idealLayerAssignments);
+        if (isKnownFailingLayerConfiguration(renderLoop, idealConfiguration)) {
+            idealLayerAssignments.reset();
+            idealConfiguration.clear();
+        }
+    }
+
     // fallback 1
     auto scenePlusCursor = layerCandidates | std::views::filter([](Item *item) {
         return qobject_cast<CursorItem *>(item) != nullptr;
@@ -864,19 +1052,25 @@ void Compositor::composite(RenderLoop *renderLoop)
     }
 
     std::unordered_set<OutputLayer *> toUpdate;
+    bool idealTestFailed = false;
     auto [layers, result] = setupLayers(primaryView, logicalOutput, output, allowedOutputLayers,
-                                        *idealLayerAssignments, frame, toUpdate);
+                                        *idealLayerAssignments, frame, toUpdate, &idealTestFailed);
 
     // test and downgrade the configuration until the test is successful
     if (!result) {
+        if (idealTestFailed && !idealConfiguration.isEmpty()) {
+            addFailingLayerConfiguration(renderLoop, idealConfiguration);
+        }
+        idealConfiguration.clear();
+
         // first, fall back to composited primary + hardware cursor, if that's not already done
         const bool fallback1 = layers.size() <= 2 && std::ranges::all_of(layers, [](const LayerData &layer) {
-            return layer.highPriority;
+            return layer.highPriority && !layer.directScanout;
         });
         if (!fallback1) {
             idealLayerAssignments = assignLayers(primaryView, scenePlusCursor, allowedOutputLayers);
             std::tie(layers, result) = setupLayers(primaryView, logicalOutput, output, allowedOutputLayers,
-                                                   *idealLayerAssignments, frame, toUpdate);
+                                                   *idealLayerAssignments, frame, toUpdate, nullptr, false);
         }
 
         // if this still doesn't work, fall back to primary only
@@ -884,7 +1078,7 @@ void Compositor::composite(RenderLoop *renderLoop)
         if (!result && !fallback2) {
             idealLayerAssignments = assignLayers(primaryView, sceneOnly, allowedOutputLayers);
             std::tie(layers, result) = setupLayers(primaryView, logicalOutput, output, allowedOutputLayers,
-                                                   *idealLayerAssignments, frame, toUpdate);
+                                                   *idealLayerAssignments, frame, toUpdate, nullptr, false);
         }
     }
 
@@ -922,6 +1116,17 @@ void Compositor::composite(RenderLoop *renderLoop)
         renderLoop->newFramePrepared();
     }
 
+    const bool composited = std::ranges::any_of(layers, [primaryView](const LayerData &layer) {
+        return layer.view == primaryView && layer.view->layer()->isEnabled();
+    });
+    if (!composited) {
+        frame->setRenderWorkload(RenderWorkload::DirectScanout);
+    } else if (effects && effects->hasActiveEffects()) {
+        frame->setRenderWorkload(RenderWorkload::Effects);
+    } else {
+        frame->setRenderWorkload(RenderWorkload::Composited);
+    }
+
     // NOTE that this does not count the time spent in BackendOutput::present,
     // but the drm backend, where that's necessary, tracks that time itself
     totalTimeQuery->end();
@@ -932,16 +1137,19 @@ void Compositor::composite(RenderLoop *renderLoop)
         // and even with atomic modesetting, drivers are buggy and atomic tests
         // sometimes have false positives
         result = false;
+        if (!idealConfiguration.isEmpty()) {
+            addFailingLayerConfiguration(renderLoop, idealConfiguration);
+        }
 
         // same fallbacks as above:
         // first, fall back to composited primary + hardware cursor, if that's not already done
         const bool fallback1 = layers.size() <= 2 && std::ranges::all_of(layers, [](const LayerData &layer) {
-            return layer.highPriority;
+            return layer.highPriority && !layer.directScanout;
         });
         if (!fallback1) {
             idealLayerAssignments = assignLayers(primaryView, scenePlusCursor, allowedOutputLayers);
             std::tie(layers, result) = setupLayers(primaryView, logicalOutput, output, allowedOutputLayers,
-                                                   *idealLayerAssignments, frame, toUpdate);
+                                                   *idealLayerAssignments, frame, toUpdate, nullptr, false);
             if (result) {
                 renderLayers();
                 result = output->present(toUpdate | std::ranges::to<QList>(), frame);
@@ -953,7 +1161,7 @@ void Compositor::composite(RenderLoop *renderLoop)
         if (!result && !fallback2) {
             idealLayerAssignments = assignLayers(primaryView, sceneOnly, allowedOutputLayers);
             std::tie(layers, result) = setupLayers(primaryView, logicalOutput, output, allowedOutputLayers,
-                                                   *idealLayerAssignments, frame, toUpdate);
+                                                   *idealLayerAssignments, frame, toUpdate, nullptr, false);
             if (result) {
                 renderLayers();
                 result = output->present(toUpdate | std::ranges::to<QList>(), frame);
@@ -970,7 +1178,34 @@ void Compositor::composite(RenderLoop *renderLoop)
         }
     }
 
+    if (result) {
+        for (const auto &layer : layers) {
+            OutputLayer *outputLayer = layer.view->layer();
+            if (!outputLayer->isEnabled()) {
+                continue;
+            }
+            if (layer.directScanout) {
+                if (auto item = qobject_cast<SurfaceItemWayland *>(layer.view->scanoutCandidate())) {
+                    frame->sharedFeedback<PresentationTimeFeedbackBatch>()->setZeroCopy(item->surface());
+                }
+            }
+            OutputLayerStatistics &statistics = outputLayer->statistics();
+            if (!toUpdate.contains(outputLayer)) {
+                statistics.skipped++;
+            } else if (layer.directScanout) {
+                statistics.directScanout++;
+            } else {
+                statistics.composited++;
+            }
+        }
+    }
+
+    updateEarlyScanoutHint(renderLoop, activeFullscreenItem, findLayer(allowedOutputLayers, OutputLayerType::Primary), tearing, *idealLayerAssignments);
+
     scene->frame(primaryView, frame.get());
+    // Send the frame callbacks right away rather than when the event loop is about to block,
+    // which can be after other outputs have been composited
+    waylandServer()->display()->flush();
     primaryView->postPaint();
 
     // the layers have to stay valid until after postPaint, so this needs to happen after it
@@ -997,13 +1232,56 @@ void Compositor::composite(RenderLoop *renderLoop)
     }
 }
 
+void Compositor::updateEarlyScanoutHint(RenderLoop *renderLoop, SurfaceItem *fullscreenItem, OutputLayer *primaryLayer, bool tearing,
+                                        const std::unordered_map<OutputLayer *, Item *> &assignments)
+{
+    // keep the hint for a while after the surface stopped being eligible, so that
+    // briefly opening a popup or moving the cursor over the window doesn't make
+    // the client reallocate its buffers twice
+    constexpr std::chrono::seconds withdrawDelay(2);
+
+    EarlyScanoutHint &hint = m_earlyScanoutHints[renderLoop];
+    const auto now = std::chrono::steady_clock::now();
+
+    // once the item is on a layer, prepareDirectScanout() takes care of the feedback
+    const bool onLayer = fullscreenItem && std::ranges::any_of(assignments | std::views::values, [fullscreenItem](Item *item) {
+        return item == fullscreenItem;
+    });
+    const bool eligible = fullscreenItem
+        && !onLayer
+        && primaryLayer
+        && primaryLayer->scanoutDevice()
+        && fullscreenItem->buffer()
+        && fullscreenItem->buffer()->dmabufAttributes()
+        && fullscreenItem->opacity() == 1.0;
+
+    if (eligible) {
+        if (hint.item != fullscreenItem) {
+            if (hint.item) {
+                hint.item->setScanoutHint(nullptr, {});
+            }
+            hint.item = fullscreenItem;
+        }
+        hint.lastEligible = now;
+        const auto formats = tearing ? primaryLayer->supportedAsyncDrmFormats() : primaryLayer->supportedDrmFormats();
+        fullscreenItem->setScanoutHint(primaryLayer->scanoutDevice(), formats);
+    } else if (hint.item && onLayer && hint.item == fullscreenItem) {
+        hint.item.clear();
+    } else if (hint.item && now - hint.lastEligible > withdrawDelay) {
+        hint.item->setScanoutHint(nullptr, {});
+        hint.item.clear();
+    }
+}
+
 void Compositor::handleOutputsChanged()
 {
     for (auto &[loop, layer] : m_primaryViews) {
         disconnect(loop, &RenderLoop::frameRequested, this, &Compositor::handleFrameRequested);
+        disconnect(loop, &RenderLoop::refreshRateChanged, this, &Compositor::updateStallThreshold);
     }
     m_overlayViews.clear();
     m_primaryViews.clear();
+    m_failedLayerConfigurations.clear();
     const auto outputs = kwinApp()->outputBackend()->outputs();
     for (BackendOutput *output : outputs) {
         if (LogicalOutput *logicalOutput = workspace()->findOutput(output)) {
@@ -1019,6 +1297,8 @@ void Compositor::addOutput(LogicalOutput *logicalOutput, BackendOutput *backendO
     }
     assignOutputLayers(logicalOutput, backendOutput);
     connect(backendOutput->renderLoop(), &RenderLoop::frameRequested, this, &Compositor::handleFrameRequested);
+    connect(backendOutput->renderLoop(), &RenderLoop::refreshRateChanged, this, &Compositor::updateStallThreshold);
+    updateStallThreshold();
 }
 
 void Compositor::removeOutput(BackendOutput *output)
@@ -1027,9 +1307,26 @@ void Compositor::removeOutput(BackendOutput *output)
         return;
     }
     disconnect(output->renderLoop(), &RenderLoop::frameRequested, this, &Compositor::handleFrameRequested);
+    disconnect(output->renderLoop(), &RenderLoop::refreshRateChanged, this, &Compositor::updateStallThreshold);
     m_overlayViews.erase(output->renderLoop());
     m_primaryViews.erase(output->renderLoop());
     m_brokenCursors.erase(output->renderLoop());
+    m_earlyScanoutHints.erase(output->renderLoop());
+    m_failedLayerConfigurations.erase(output->renderLoop());
+    updateStallThreshold();
+}
+
+void Compositor::updateStallThreshold()
+{
+    int refreshRate = 60000;
+    if (!m_primaryViews.empty()) {
+        refreshRate = std::ranges::max(m_primaryViews | std::views::transform([](const auto &pair) {
+            return pair.first->refreshRate();
+        }));
+    }
+    if (refreshRate > 0) {
+        m_stallDetector->setRefreshInterval(std::chrono::nanoseconds(1'000'000'000'000 / refreshRate));
+    }
 }
 
 void Compositor::assignOutputLayers(LogicalOutput *logicalOutput, BackendOutput *backendOutput)
@@ -1060,6 +1357,7 @@ void Compositor::assignOutputLayers(LogicalOutput *logicalOutput, BackendOutput
     }
     // will be re-assigned in the next composite() pass
     m_overlayViews.erase(backendOutput->renderLoop());
+    m_failedLayerConfigurations.erase(backendOutput->renderLoop());
 }
 
 } // namespace KWin
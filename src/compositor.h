@@ -15,7 +15,10 @@
 
 #include <QHash>
 #include <QObject>
+#include <QPointer>
 
+#include <chrono>
+#include <deque>
 #include <memory>
 
 namespace KWin
@@ -38,6 +41,8 @@ class RenderLoopDrivenQAnimationDriver;
 class RenderView;
 class Item;
 class RenderDevice;
+class SurfaceItem;
+class StallDetector;
 
 class KWIN_EXPORT Compositor : public QObject
 {
@@ -84,6 +89,11 @@ Q_SIGNALS:
     void aboutToToggleCompositing();
     void aboutToStop();
     void primaryGpuChanged();
+    /**
+     * This signal is emitted right before a frame is composited for the given @a renderLoop.
+     * It's the last chance to apply state that should be visible in the frame.
+     */
+    void aboutToComposite(RenderLoop *renderLoop);
 
 protected:
     explicit Compositor(QObject *parent = nullptr);
@@ -119,7 +129,50 @@ protected:
                                                   const QList<OutputLayer *> &outputLayers,
                                                   const std::unordered_map<OutputLayer *, Item *> &assignments,
                                                   const std::shared_ptr<OutputFrame> &frame,
-                                                  std::unordered_set<OutputLayer *> &toUpdate);
+                                                  std::unordered_set<OutputLayer *> &toUpdate,
+                                                  bool *testFailed = nullptr,
+                                                  bool allowCursorScanout = true);
+
+    void updateEarlyScanoutHint(RenderLoop *renderLoop, SurfaceItem *fullscreenItem, OutputLayer *primaryLayer, bool tearing,
+                                const std::unordered_map<OutputLayer *, Item *> &assignments);
+
+    /**
+     * A fullscreen surface that is told about the formats of the primary layer before it's
+     * actually picked for direct scanout, so it can switch to a suitable buffer early.
+     */
+    struct EarlyScanoutHint
+    {
+        QPointer<SurfaceItem> item;
+        std::chrono::steady_clock::time_point lastEligible;
+    };
+
+    /**
+     * Describes what an output layer is used for in a layer configuration, with enough
+     * detail to tell whether a previously failed atomic test would fail again.
+     */
+    struct LayerConfigurationEntry
+    {
+        OutputLayer *layer;
+        Item *item;
+        int zpos;
+        Rect targetRect;
+        uint32_t format = 0;
+        uint64_t modifier = 0;
+
+        bool operator==(const LayerConfigurationEntry &other) const = default;
+    };
+
+    struct FailedLayerConfiguration
+    {
+        QList<LayerConfigurationEntry> entries;
+        std::chrono::steady_clock::time_point time;
+    };
+
+    QList<LayerConfigurationEntry> describeLayerConfiguration(RenderView *view, LogicalOutput *logicalOutput, BackendOutput *backendOutput,
+                                                              const std::unordered_map<OutputLayer *, Item *> &assignments) const;
+    bool isKnownFailingLayerConfiguration(RenderLoop *renderLoop, const QList<LayerConfigurationEntry> &configuration);
+    void addFailingLayerConfiguration(RenderLoop *renderLoop, const QList<LayerConfigurationEntry> &configuration);
+    void updateStallThreshold();
 
     CompositingType m_selectedCompositor = NoCompositing;
 
@@ -128,9 +181,13 @@ protected:
     std::unordered_map<RenderLoop *, std::unique_ptr<SceneView>> m_primaryViews;
     std::unordered_map<RenderLoop *, std::unordered_map<OutputLayer *, std::unique_ptr<ItemView>>> m_overlayViews;
     std::unordered_set<RenderLoop *> m_brokenCursors;
+    std::unordered_map<RenderLoop *, EarlyScanoutHint> m_earlyScanoutHints;
+    std::unordered_map<RenderLoop *, std::deque<FailedLayerConfiguration>> m_failedLayerConfigurations;
     std::optional<bool> m_allowOverlaysEnv;
     RenderLoopDrivenQAnimationDriver *m_renderLoopDrivenAnimationDriver;
     RenderDevice *m_renderDevice = nullptr;
+    StallDetector *m_stallDetector;
+    bool m_lowActivity = false;
 };
 
 } // namespace KWin
@@ -10,6 +10,7 @@
 #include "colortransformation.h"
 
 #include <QVector3D>
+#include <QtConcurrentRun>
 
 namespace KWin
 {
@@ -22,6 +23,11 @@ ColorLUT3D::ColorLUT3D(std::unique_ptr<ColorTransformation> &&transformation, si
 {
 }
 
+ColorLUT3D::~ColorLUT3D()
+{
+    m_baking.waitForFinished();
+}
+
 size_t ColorLUT3D::xSize() const
 {
     return m_xSize;
@@ -42,8 +48,32 @@ QVector3D ColorLUT3D::sample(const QVector3D &rgb)
     return m_transformation->transform(rgb);
 }
 
+void ColorLUT3D::bake()
+{
+    if (m_baking.isValid()) {
+        return;
+    }
+    // evaluating the transformation only reads from it, so it can be shared with the worker
+    m_baking = QtConcurrent::run([this]() {
+        std::vector<QVector3D> samples;
+        samples.reserve(m_xSize * m_ySize * m_zSize);
+        for (size_t z = 0; z < m_zSize; z++) {
+            for (size_t y = 0; y < m_ySize; y++) {
+                for (size_t x = 0; x < m_xSize; x++) {
+                    samples.push_back(m_transformation->transform(QVector3D(x / double(m_xSize - 1), y / double(m_ySize - 1), z / double(m_zSize - 1))));
+                }
+            }
+        }
+        m_samples = std::move(samples);
+    });
+}
+
 QVector3D ColorLUT3D::sample(size_t x, size_t y, size_t z)
 {
+    if (m_baking.isValid()) {
+        m_baking.waitForFinished();
+        return m_samples[(z * m_ySize + y) * m_xSize + x];
+    }
     return m_transformation->transform(QVector3D(x / double(m_xSize - 1), y / double(m_ySize - 1), z / double(m_zSize - 1)));
 }
 
@@ -8,8 +8,10 @@
 */
 #pragma once
 
+#include <QFuture>
 #include <QVector>
 #include <memory>
+#include <vector>
 
 #include "kwin_export.h"
 
@@ -24,12 +26,23 @@ class KWIN_EXPORT ColorLUT3D
 {
 public:
     ColorLUT3D(std::unique_ptr<ColorTransformation> &&transformation, size_t xSize, size_t ySize, size_t zSize);
+    ~ColorLUT3D();
 
     size_t xSize() const;
     size_t ySize() const;
     size_t zSize() const;
 
+    /**
+     * Starts evaluating the transformation for all the grid points of the LUT on a
+     * worker thread, so that sampling them later on doesn't need to do it anymore.
+     */
+    void bake();
+
     QVector3D sample(const QVector3D &rgb);
+    /**
+     * Returns the value of the grid point. If the LUT is still being baked,
+     * this waits for it to be done.
+     */
     QVector3D sample(size_t x, size_t y, size_t z);
 
 private:
@@ -37,6 +50,8 @@ private:
     const size_t m_xSize;
     const size_t m_ySize;
     const size_t m_zSize;
+    std::vector<QVector3D> m_samples;
+    QFuture<void> m_baking;
 };
 
 }
@@ -10,6 +10,7 @@
 #include "iccprofile.h"
 
 #include <numbers>
+#include <optional>
 
 namespace KWin
 {
@@ -181,6 +182,22 @@ void ColorPipeline::addTransferFunction(TransferFunction tf, ColorspaceType outp
             if (invTf->tf == tf) {
                 ops.erase(ops.end() - 1);
                 return;
+            } else if (invTf->tf.type == tf.type && tf.type != TransferFunction::BT1886) {
+                // encoding and decoding with the same curve only maps the luminance range
+                // of the inverse transfer function to the one of this transfer function
+                const TransferFunction inverse = invTf->tf;
+                ops.erase(ops.end() - 1);
+                const double scale = (tf.maxLuminance - tf.minLuminance) / (inverse.maxLuminance - inverse.minLuminance);
+                const double offset = tf.minLuminance - inverse.minLuminance * scale;
+                QMatrix4x4 mat;
+                mat.translate(offset, offset, offset);
+                mat.scale(scale);
+                addMatrix(mat, ValueRange{
+                                   .min = currentOutputRange().min * scale + offset,
+                                   .max = currentOutputRange().max * scale + offset,
+                               },
+                          outputType);
+                return;
             }
         }
     }
@@ -381,12 +398,44 @@ void ColorPipeline::add1DLUT(const std::shared_ptr<ColorTransformation> &transfo
     });
 }
 
+/**
+ * Returns the range that the output of the operation is guaranteed to be in, regardless of the input
+ */
+static std::optional<ValueRange> guaranteedOutputRange(const ColorOp::Operation &operation)
+{
+    if (const auto invTf = std::get_if<InverseColorTransferFunction>(&operation)) {
+        switch (invTf->tf.type) {
+        case TransferFunction::sRGB:
+        case TransferFunction::gamma22:
+        case TransferFunction::PerceptualQuantizer:
+            return ValueRange{
+                .min = 0,
+                .max = 1,
+            };
+        case TransferFunction::linear:
+        case TransferFunction::BT1886:
+            return std::nullopt;
+        }
+    } else if (const auto clamp = std::get_if<ColorClamp>(&operation)) {
+        return ValueRange{
+            .min = clamp->m_minValue,
+            .max = clamp->m_maxValue,
+        };
+    }
+    return std::nullopt;
+}
+
 void ColorPipeline::addClamp(const ValueRange &range)
 {
     // any values outside of the range we clamp to don't need to be
     // preserved, so we can directly clamp the last output range here
     if (!ops.empty()) {
         auto &last = ops.back();
+        if (const auto guaranteed = guaranteedOutputRange(last.operation); guaranteed && !std::holds_alternative<ColorClamp>(last.operation)
+            && guaranteed->min >= range.min && guaranteed->max <= range.max) {
+            // the previous operation already clamps to the range
+            return;
+        }
         last.output.min = std::clamp(last.output.min, range.min, range.max);
         last.output.max = std::clamp(last.output.max, range.min, range.max);
         if (auto otherClamp = std::get_if<ColorClamp>(&last.operation)) {
@@ -429,6 +478,11 @@ void ColorPipeline::add(const ColorOp &op)
         addTransferFunction(tf->tf, op.outputSpace);
     } else if (const auto tf = std::get_if<InverseColorTransferFunction>(&op.operation)) {
         addInverseTransferFunction(tf->tf, op.outputSpace);
+    } else if (const auto clamp = std::get_if<ColorClamp>(&op.operation)) {
+        addClamp(ValueRange{
+            .min = clamp->m_minValue,
+            .max = clamp->m_maxValue,
+        });
     } else {
         ops.push_back(op);
     }
@@ -460,6 +514,13 @@ QVector3D ColorPipeline::evaluate(const QVector3D &input) const
     return ret;
 }
 
+void ColorPipeline::evaluate(std::span<QVector3D> values) const
+{
+    for (const auto &op : ops) {
+        ColorOp::applyOperation(op.operation, values);
+    }
+}
+
 bool ColorPipeline::operator==(const ColorPipeline &other) const
 {
     // NOTE that this can't just use the default compiler-generated
@@ -500,6 +561,54 @@ QVector3D ColorOp::applyOperation(const ColorOp::Operation &operation, const QVe
     }
 }
 
+static void applyMatrix(const QMatrix4x4 &matrix, std::span<QVector3D> values)
+{
+    // the same as QMatrix4x4 * QVector3D, without checking the type of the matrix for every value
+    const float *m = matrix.constData();
+    const bool projective = m[3] != 0 || m[7] != 0 || m[11] != 0 || m[15] != 1;
+    for (QVector3D &value : values) {
+        const float x = value.x() * m[0] + value.y() * m[4] + value.z() * m[8] + m[12];
+        const float y = value.x() * m[1] + value.y() * m[5] + value.z() * m[9] + m[13];
+        const float z = value.x() * m[2] + value.y() * m[6] + value.z() * m[10] + m[14];
+        if (projective) {
+            const float w = value.x() * m[3] + value.y() * m[7] + value.z() * m[11] + m[15];
+            if (w != 1.0f) {
+                value = QVector3D(x / w, y / w, z / w);
+                continue;
+            }
+        }
+        value = QVector3D(x, y, z);
+    }
+}
+
+void ColorOp::applyOperation(const ColorOp::Operation &operation, std::span<QVector3D> values)
+{
+    if (const auto mat = std::get_if<ColorMatrix>(&operation)) {
+        applyMatrix(mat->mat, values);
+    } else if (const auto mult = std::get_if<ColorMultiplier>(&operation)) {
+        const QVector3D factors = mult->factors;
+        for (QVector3D &value : values) {
+            value *= factors;
+        }
+    } else if (const auto tf = std::get_if<ColorTransferFunction>(&operation)) {
+        tf->tf.encodedToNits(values);
+    } else if (const auto tf = std::get_if<InverseColorTransferFunction>(&operation)) {
+        tf->tf.nitsToEncoded(values);
+    } else if (auto clamp = std::get_if<KWin::ColorClamp>(&operation)) {
+        const float minValue = clamp->m_minValue;
+        const float maxValue = clamp->m_maxValue;
+        for (QVector3D &value : values) {
+            value = QVector3D(std::clamp(value.x(), minValue, maxValue),
+                              std::clamp(value.y(), minValue, maxValue),
+                              std::clamp(value.z(), minValue, maxValue));
+        }
+    } else {
+        for (QVector3D &value : values) {
+            value = applyOperation(operation, value);
+        }
+    }
+}
+
 ColorTransferFunction::ColorTransferFunction(TransferFunction tf)
     : tf(tf)
 {
@@ -114,6 +114,10 @@ public:
     bool operator==(const ColorOp &) const = default;
     QVector3D apply(const QVector3D input) const;
     static QVector3D applyOperation(const ColorOp::Operation &operation, const QVector3D &input);
+    /**
+     * Applies the operation to all @a values in place.
+     */
+    static void applyOperation(const ColorOp::Operation &operation, std::span<QVector3D> values);
 };
 
 class KWIN_EXPORT ColorPipeline
@@ -142,6 +146,12 @@ public:
     const ValueRange &currentOutputRange() const;
     ColorspaceType currentOutputSpace() const;
     QVector3D evaluate(const QVector3D &input) const;
+    /**
+     * Evaluates the pipeline for all @a values in place. Each operation is applied to the whole
+     * batch before the next one, which is a lot faster than evaluating the values one by one
+     * when many of them are needed, e.g. to compute a lookup table.
+     */
+    void evaluate(std::span<QVector3D> values) const;
 
     void addMultiplier(double factor);
     void addMultiplier(const QVector3D &factors);
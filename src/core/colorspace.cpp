@@ -772,99 +772,172 @@ TransferFunction::TransferFunction(Type tf, double minLuminance, double maxLumin
 {
 }
 
-double TransferFunction::encodedToNits(double encoded) const
+/**
+ * Calls @a function with a kernel that converts one encoded value of @a tf to nits. The
+ * type of the transfer function and the constants that only depend on the luminance range
+ * are resolved once, so that converting many values doesn't go through the switch and
+ * compute the constants for every single one of them.
+ */
+template<typename Function>
+static auto visitEncodedToNits(const TransferFunction &tf, Function &&function)
 {
-    switch (type) {
-    case TransferFunction::sRGB: {
-        if (encoded < 0.04045) {
-            return std::max(encoded / 12.92, 0.0) * (maxLuminance - minLuminance) + minLuminance;
-        } else {
-            return std::clamp(std::pow((encoded + 0.055) / 1.055, 12.0 / 5.0), 0.0, 1.0) * (maxLuminance - minLuminance) + minLuminance;
-        }
-    }
+    const double minLuminance = tf.minLuminance;
+    const double range = tf.maxLuminance - tf.minLuminance;
+    switch (tf.type) {
+    case TransferFunction::sRGB:
+        return function([=](double encoded) {
+            if (encoded < 0.04045) {
+                return std::max(encoded / 12.92, 0.0) * range + minLuminance;
+            } else {
+                return std::clamp(std::pow((encoded + 0.055) / 1.055, 12.0 / 5.0), 0.0, 1.0) * range + minLuminance;
+            }
+        });
     case TransferFunction::gamma22:
-        return std::pow(encoded, 2.2) * (maxLuminance - minLuminance) + minLuminance;
+        return function([=](double encoded) {
+            return std::pow(encoded, 2.2) * range + minLuminance;
+        });
     case TransferFunction::linear:
-        return encoded * (maxLuminance - minLuminance) + minLuminance;
-    case TransferFunction::PerceptualQuantizer: {
-        const double c1 = 0.8359375;
-        const double c2 = 18.8515625;
-        const double c3 = 18.6875;
-        const double m1_inv = 1.0 / 0.1593017578125;
-        const double m2_inv = 1.0 / 78.84375;
-        const double powed = std::pow(encoded, m2_inv);
-        const double num = std::max(powed - c1, 0.0);
-        const double den = c2 - c3 * powed;
-        return std::pow(num / den, m1_inv) * (maxLuminance - minLuminance) + minLuminance;
+        return function([=](double encoded) {
+            return encoded * range + minLuminance;
+        });
+    case TransferFunction::PerceptualQuantizer:
+        return function([=](double encoded) {
+            const double c1 = 0.8359375;
+            const double c2 = 18.8515625;
+            const double c3 = 18.6875;
+            const double m1_inv = 1.0 / 0.1593017578125;
+            const double m2_inv = 1.0 / 78.84375;
+            const double powed = std::pow(encoded, m2_inv);
+            const double num = std::max(powed - c1, 0.0);
+            const double den = c2 - c3 * powed;
+            return std::pow(num / den, m1_inv) * range + minLuminance;
+        });
+    case TransferFunction::BT1886: {
+        constexpr double gamma = 2.4;
+        const double minLumPow = std::pow(tf.minLuminance, 1.0 / gamma);
+        const double tmp = std::pow(tf.maxLuminance, 1.0 / gamma) - minLumPow;
+        const double alpha = std::pow(tmp, gamma);
+        const double beta = minLumPow / tmp;
+        return function([=](double encoded) {
+            return alpha * std::pow(std::max(encoded + beta, 0.0), gamma);
+        });
+    }
     }
+    Q_UNREACHABLE();
+}
+
+/**
+ * Like visitEncodedToNits(), but with a kernel that converts nits to encoded values.
+ */
+template<typename Function>
+static auto visitNitsToEncoded(const TransferFunction &tf, Function &&function)
+{
+    const double minLuminance = tf.minLuminance;
+    const double range = tf.maxLuminance - tf.minLuminance;
+    switch (tf.type) {
+    case TransferFunction::sRGB:
+        return function([=](double nits) {
+            const double normalized = (nits - minLuminance) / range;
+            if (normalized < 0.0031308) {
+                return std::max(normalized / 12.92, 0.0);
+            } else {
+                return std::clamp(std::pow(normalized, 5.0 / 12.0) * 1.055 - 0.055, 0.0, 1.0);
+            }
+        });
+    case TransferFunction::gamma22:
+        return function([=](double nits) {
+            const double normalized = (nits - minLuminance) / range;
+            return std::pow(std::clamp(normalized, 0.0, 1.0), 1.0 / 2.2);
+        });
+    case TransferFunction::linear:
+        return function([=](double nits) {
+            return (nits - minLuminance) / range;
+        });
+    case TransferFunction::PerceptualQuantizer:
+        return function([=](double nits) {
+            const double normalized = (nits - minLuminance) / range;
+            const double c1 = 0.8359375;
+            const double c2 = 18.8515625;
+            const double c3 = 18.6875;
+            const double m1 = 0.1593017578125;
+            const double m2 = 78.84375;
+            const double powed = std::pow(std::clamp(normalized, 0.0, 1.0), m1);
+            const double num = c1 + c2 * powed;
+            const double denum = 1 + c3 * powed;
+            return std::pow(num / denum, m2);
+        });
     case TransferFunction::BT1886: {
         constexpr double gamma = 2.4;
-        const double minLumPow = std::pow(minLuminance, 1.0 / gamma);
-        const double tmp = std::pow(maxLuminance, 1.0 / gamma) - minLumPow;
+        const double minLumPow = std::pow(tf.minLuminance, 1.0 / gamma);
+        const double tmp = std::pow(tf.maxLuminance, 1.0 / gamma) - minLumPow;
         const double alpha = std::pow(tmp, gamma);
         const double beta = minLumPow / tmp;
-        return alpha * std::pow(std::max(encoded + beta, 0.0), gamma);
+        return function([=](double nits) {
+            return std::pow(nits / alpha, 1.0 / gamma) - beta;
+        });
     }
     }
     Q_UNREACHABLE();
 }
 
+double TransferFunction::encodedToNits(double encoded) const
+{
+    return visitEncodedToNits(*this, [encoded](auto kernel) {
+        return kernel(encoded);
+    });
+}
+
 QVector3D TransferFunction::encodedToNits(const QVector3D &encoded) const
 {
-    return QVector3D(encodedToNits(encoded.x()), encodedToNits(encoded.y()), encodedToNits(encoded.z()));
+    return visitEncodedToNits(*this, [&encoded](auto kernel) {
+        return QVector3D(kernel(encoded.x()), kernel(encoded.y()), kernel(encoded.z()));
+    });
 }
 
 QVector4D TransferFunction::encodedToNits(const QVector4D &encoded) const
 {
-    return QVector4D(encodedToNits(encoded.x()), encodedToNits(encoded.y()), encodedToNits(encoded.z()), encoded.w());
+    return visitEncodedToNits(*this, [&encoded](auto kernel) {
+        return QVector4D(kernel(encoded.x()), kernel(encoded.y()), kernel(encoded.z()), encoded.w());
+    });
 }
 
-double TransferFunction::nitsToEncoded(double nits) const
+void TransferFunction::encodedToNits(std::span<QVector3D> values) const
 {
-    const double normalized = (nits - minLuminance) / (maxLuminance - minLuminance);
-    switch (type) {
-    case TransferFunction::sRGB: {
-        if (normalized < 0.0031308) {
-            return std::max(normalized / 12.92, 0.0);
-        } else {
-            return std::clamp(std::pow(normalized, 5.0 / 12.0) * 1.055 - 0.055, 0.0, 1.0);
+    visitEncodedToNits(*this, [values](auto kernel) {
+        for (QVector3D &value : values) {
+            value = QVector3D(kernel(value.x()), kernel(value.y()), kernel(value.z()));
         }
-    }
-    case TransferFunction::gamma22:
-        return std::pow(std::clamp(normalized, 0.0, 1.0), 1.0 / 2.2);
-    case TransferFunction::linear:
-        return normalized;
-    case TransferFunction::PerceptualQuantizer: {
-        const double c1 = 0.8359375;
-        const double c2 = 18.8515625;
-        const double c3 = 18.6875;
-        const double m1 = 0.1593017578125;
-        const double m2 = 78.84375;
-        const double powed = std::pow(std::clamp(normalized, 0.0, 1.0), m1);
-        const double num = c1 + c2 * powed;
-        const double denum = 1 + c3 * powed;
-        return std::pow(num / denum, m2);
-    }
-    case TransferFunction::BT1886: {
-        constexpr double gamma = 2.4;
-        const double minLumPow = std::pow(minLuminance, 1.0 / gamma);
-        const double tmp = std::pow(maxLuminance, 1.0 / gamma) - minLumPow;
-        const double alpha = std::pow(tmp, gamma);
-        const double beta = minLumPow / tmp;
-        return std::pow(nits / alpha, 1.0 / gamma) - beta;
-    }
-    }
-    Q_UNREACHABLE();
+    });
+}
+
+double TransferFunction::nitsToEncoded(double nits) const
+{
+    return visitNitsToEncoded(*this, [nits](auto kernel) {
+        return kernel(nits);
+    });
 }
 
 QVector3D TransferFunction::nitsToEncoded(const QVector3D &nits) const
 {
-    return QVector3D(nitsToEncoded(nits.x()), nitsToEncoded(nits.y()), nitsToEncoded(nits.z()));
+    return visitNitsToEncoded(*this, [&nits](auto kernel) {
+        return QVector3D(kernel(nits.x()), kernel(nits.y()), kernel(nits.z()));
+    });
 }
 
 QVector4D TransferFunction::nitsToEncoded(const QVector4D &nits) const
 {
-    return QVector4D(nitsToEncoded(nits.x()), nitsToEncoded(nits.y()), nitsToEncoded(nits.z()), nits.w());
+    return visitNitsToEncoded(*this, [&nits](auto kernel) {
+        return QVector4D(kernel(nits.x()), kernel(nits.y()), kernel(nits.z()), nits.w());
+    });
+}
+
+void TransferFunction::nitsToEncoded(std::span<QVector3D> values) const
+{
+    visitNitsToEncoded(*this, [values](auto kernel) {
+        for (QVector3D &value : values) {
+            value = QVector3D(kernel(value.x()), kernel(value.y()), kernel(value.z()));
+        }
+    });
 }
 
 bool TransferFunction::isRelative() const
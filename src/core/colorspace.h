@@ -5,6 +5,7 @@
 */
 #pragma once
 #include <optional>
+#include <span>
 
 #include <QMatrix4x4>
 #include <QVector2D>
@@ -178,6 +179,11 @@ public:
     QVector3D nitsToEncoded(const QVector3D &nits) const;
     QVector4D encodedToNits(const QVector4D &encoded) const;
     QVector4D nitsToEncoded(const QVector4D &nits) const;
+    /**
+     * Converts all @a values in place. This is a lot faster than converting them one by one.
+     */
+    void encodedToNits(std::span<QVector3D> values) const;
+    void nitsToEncoded(std::span<QVector3D> values) const;
 
     double bt1886A() const;
     double bt1886B() const;
@@ -108,9 +108,26 @@ const QHash<uint32_t, YuvConversion> FormatInfo::s_drmConversions = {
     {DRM_FORMAT_NV12, YuvConversion{
                           {YuvFormat{DRM_FORMAT_R8, 1, 1}, YuvFormat{DRM_FORMAT_GR88, 2, 2}},
                       }},
+    // the chroma plane of NV21 has Cr first, sampling it as RG88 puts Cb into the red channel again
+    {DRM_FORMAT_NV21, YuvConversion{
+                          {YuvFormat{DRM_FORMAT_R8, 1, 1}, YuvFormat{DRM_FORMAT_RG88, 2, 2}},
+                      }},
+    {DRM_FORMAT_NV16, YuvConversion{
+                          {YuvFormat{DRM_FORMAT_R8, 1, 1}, YuvFormat{DRM_FORMAT_GR88, 2, 1}},
+                      }},
+    {DRM_FORMAT_NV24, YuvConversion{
+                          {YuvFormat{DRM_FORMAT_R8, 1, 1}, YuvFormat{DRM_FORMAT_GR88, 1, 1}},
+                      }},
     {DRM_FORMAT_P010, YuvConversion{
                           {YuvFormat{DRM_FORMAT_R16, 1, 1}, YuvFormat{DRM_FORMAT_GR1616, 2, 2}},
                       }},
+    // P012 and P016 are MSB aligned like P010, so the same shader applies to all of them
+    {DRM_FORMAT_P012, YuvConversion{
+                          {YuvFormat{DRM_FORMAT_R16, 1, 1}, YuvFormat{DRM_FORMAT_GR1616, 2, 2}},
+                      }},
+    {DRM_FORMAT_P016, YuvConversion{
+                          {YuvFormat{DRM_FORMAT_R16, 1, 1}, YuvFormat{DRM_FORMAT_GR1616, 2, 2}},
+                      }},
     {DRM_FORMAT_XYUV8888, YuvConversion{
                               {YuvFormat{DRM_FORMAT_XRGB8888, 1, 1}},
                           }},
@@ -418,6 +435,33 @@ const std::unordered_map<uint32_t, FormatInfo> FormatInfo::s_knownFormats = {
                           .vulkanFormat = VK_FORMAT_UNDEFINED,
                           .floatingPoint = false,
                       }},
+    {DRM_FORMAT_NV21, FormatInfo{
+                          .drmFormat = DRM_FORMAT_NV21,
+                          .bitsPerColor = 8,
+                          .alphaBits = 0,
+                          .bitsPerPixel = 24,
+                          .openglFormat = GL_R8,
+                          .vulkanFormat = VK_FORMAT_UNDEFINED,
+                          .floatingPoint = false,
+                      }},
+    {DRM_FORMAT_NV16, FormatInfo{
+                          .drmFormat = DRM_FORMAT_NV16,
+                          .bitsPerColor = 8,
+                          .alphaBits = 0,
+                          .bitsPerPixel = 24,
+                          .openglFormat = GL_R8,
+                          .vulkanFormat = VK_FORMAT_UNDEFINED,
+                          .floatingPoint = false,
+                      }},
+    {DRM_FORMAT_NV24, FormatInfo{
+                          .drmFormat = DRM_FORMAT_NV24,
+                          .bitsPerColor = 8,
+                          .alphaBits = 0,
+                          .bitsPerPixel = 24,
+                          .openglFormat = GL_R8,
+                          .vulkanFormat = VK_FORMAT_UNDEFINED,
+                          .floatingPoint = false,
+                      }},
     {DRM_FORMAT_P010, FormatInfo{
                           .drmFormat = DRM_FORMAT_P010,
                           .bitsPerColor = 10,
@@ -427,6 +471,24 @@ const std::unordered_map<uint32_t, FormatInfo> FormatInfo::s_knownFormats = {
                           .vulkanFormat = VK_FORMAT_UNDEFINED,
                           .floatingPoint = false,
                       }},
+    {DRM_FORMAT_P012, FormatInfo{
+                          .drmFormat = DRM_FORMAT_P012,
+                          .bitsPerColor = 12,
+                          .alphaBits = 0,
+                          .bitsPerPixel = 48,
+                          .openglFormat = GL_R16,
+                          .vulkanFormat = VK_FORMAT_UNDEFINED,
+                          .floatingPoint = false,
+                      }},
+    {DRM_FORMAT_P016, FormatInfo{
+                          .drmFormat = DRM_FORMAT_P016,
+                          .bitsPerColor = 16,
+                          .alphaBits = 0,
+                          .bitsPerPixel = 48,
+                          .openglFormat = GL_R16,
+                          .vulkanFormat = VK_FORMAT_UNDEFINED,
+                          .floatingPoint = false,
+                      }},
     {DRM_FORMAT_XYUV8888, FormatInfo{
                               .drmFormat = DRM_FORMAT_XYUV8888,
                               .bitsPerColor = 8,
@@ -0,0 +1,148 @@
+/*
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "frametimingjournal.h"
+#include "utils/common.h"
+
+#include <QDir>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace KWin
+{
+
+static constexpr size_t s_mapSize = sizeof(FrameTimingJournal::Header) + FrameTimingJournal::s_capacity * sizeof(FrameTimingRecord);
+
+FrameTimingJournal::FrameTimingJournal(const QString &outputName)
+{
+    const QString directory = qEnvironmentVariable("KWIN_FRAME_TIMINGS_DIR");
+    if (!directory.isEmpty()) {
+        m_filePath = QDir(directory).filePath(QStringLiteral("kwin-frame-timings-%1.bin").arg(outputName));
+        m_fd = FileDescriptor(open(qPrintable(m_filePath), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0600));
+        if (!m_fd.isValid() || ftruncate(m_fd.get(), s_mapSize) != 0) {
+            qCWarning(KWIN_CORE) << "Failed to create frame timing file" << m_filePath << strerror(errno);
+            m_fd.reset();
+            m_filePath.clear();
+        } else {
+            m_map = MemoryMap(s_mapSize, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd.get(), 0);
+        }
+    }
+    if (!m_map.isValid()) {
+        m_map = MemoryMap(s_mapSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    }
+    if (!m_map.isValid()) {
+        qCWarning(KWIN_CORE) << "Failed to allocate the frame timing journal for" << outputName;
+        return;
+    }
+
+    // anonymous and freshly truncated mappings are zero-initialized
+    Header *header = this->header();
+    header->magic = s_magic;
+    header->version = s_version;
+    header->recordSize = sizeof(FrameTimingRecord);
+    header->capacity = s_capacity;
+}
+
+FrameTimingJournal::~FrameTimingJournal()
+{
+    if (!m_filePath.isEmpty()) {
+        unlink(qPrintable(m_filePath));
+    }
+}
+
+FrameTimingJournal::Header *FrameTimingJournal::header() const
+{
+    return m_map.isValid() ? static_cast<Header *>(m_map.data()) : nullptr;
+}
+
+FrameTimingRecord *FrameTimingJournal::recordAt(uint64_t sequence) const
+{
+    auto records = reinterpret_cast<FrameTimingRecord *>(static_cast<char *>(m_map.data()) + sizeof(Header));
+    return &records[sequence % s_capacity];
+}
+
+void FrameTimingJournal::add(const FrameTimingRecord &record)
+{
+    if (record.flags & FrameTimingRecord::Dropped) {
+        m_droppedCount++;
+    }
+
+    Header *header = this->header();
+    if (!header) {
+        return;
+    }
+    std::atomic_ref<uint64_t> lastSequence(header->lastSequence);
+    const uint64_t sequence = lastSequence.load(std::memory_order_relaxed) + 1;
+
+    FrameTimingRecord *slot = recordAt(sequence);
+    std::atomic_ref<uint64_t> slotSequence(slot->sequence);
+    // mark the record as being written to
+    slotSequence.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    static_assert(offsetof(FrameTimingRecord, sequence) == 0);
+    std::memcpy(reinterpret_cast<char *>(slot) + sizeof(uint64_t), reinterpret_cast<const char *>(&record) + sizeof(uint64_t), sizeof(FrameTimingRecord) - sizeof(uint64_t));
+
+    slotSequence.store(sequence, std::memory_order_release);
+    lastSequence.store(sequence, std::memory_order_release);
+}
+
+QByteArray FrameTimingJournal::records(uint64_t firstSequence, uint32_t maxCount) const
+{
+    Header *header = this->header();
+    if (!header || maxCount == 0) {
+        return QByteArray();
+    }
+    const uint64_t last = std::atomic_ref<uint64_t>(header->lastSequence).load(std::memory_order_acquire);
+    const uint64_t oldest = last >= s_capacity ? last - s_capacity + 1 : 1;
+    const uint64_t first = std::max(firstSequence, oldest);
+    if (first > last) {
+        return QByteArray();
+    }
+    const uint64_t count = std::min<uint64_t>(last - first + 1, maxCount);
+
+    QByteArray ret;
+    ret.reserve(count * sizeof(FrameTimingRecord));
+    for (uint64_t sequence = first; sequence < first + count; sequence++) {
+        FrameTimingRecord *slot = recordAt(sequence);
+        std::atomic_ref<uint64_t> slotSequence(slot->sequence);
+        if (slotSequence.load(std::memory_order_acquire) != sequence) {
+            continue;
+        }
+        FrameTimingRecord copy;
+        std::memcpy(&copy, slot, sizeof(FrameTimingRecord));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slotSequence.load(std::memory_order_relaxed) != sequence) {
+            continue;
+        }
+        copy.sequence = sequence;
+        ret.append(reinterpret_cast<const char *>(&copy), sizeof(FrameTimingRecord));
+    }
+    return ret;
+}
+
+uint64_t FrameTimingJournal::lastSequence() const
+{
+    Header *header = this->header();
+    return header ? std::atomic_ref<uint64_t>(header->lastSequence).load(std::memory_order_acquire) : 0;
+}
+
+uint64_t FrameTimingJournal::droppedCount() const
+{
+    return m_droppedCount;
+}
+
+QString FrameTimingJournal::filePath() const
+{
+    return m_filePath;
+}
+
+} // namespace KWin
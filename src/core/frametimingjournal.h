@@ -0,0 +1,139 @@
+/*
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include "kwin_export.h"
+#include "utils/filedescriptor.h"
+#include "utils/memorymap.h"
+
+#include <QByteArray>
+#include <QString>
+
+#include <chrono>
+#include <cstdint>
+
+namespace KWin
+{
+
+/**
+ * A fixed-size record describing how a single frame was scheduled, rendered and presented.
+ * All timestamps are in nanoseconds on the monotonic clock, durations are in nanoseconds.
+ * Fields that are unknown are zero.
+ *
+ * The layout of this struct is part of the frame timing file format and must not change
+ * without bumping FrameTimingJournal::s_version.
+ */
+struct FrameTimingRecord
+{
+    enum Flag : uint32_t {
+        Dropped = 1 << 0,
+        Vrr = 1 << 1,
+        Tearing = 1 << 2,
+        DirectScanout = 1 << 3,
+        Effects = 1 << 4,
+        /**
+         * The render loop was triple buffering when the frame got presented, i.e. frames were
+         * scheduled more than one refresh cycle in advance because compositing was predicted
+         * to take about as long as a refresh cycle or longer.
+         */
+        TripleBuffering = 1 << 5,
+    };
+
+    /**
+     * Sequence number of the record, starting at 1. A value of 0 means that the
+     * record is either unused or being written to.
+     */
+    uint64_t sequence;
+    int64_t targetPresentation;
+    int64_t actualPresentation;
+    int64_t renderStart;
+    int64_t renderEnd;
+    int64_t gpuTime;
+    int64_t commitSubmit;
+    /**
+     * How long the commit ioctl took.
+     */
+    int64_t commitDuration;
+    /**
+     * How long before the target presentation time the backend needed the frame to be
+     * submitted, see RenderLoop::setPresentationSafetyMargin().
+     */
+    int64_t safetyMargin;
+    int64_t predictedRenderTime;
+    int64_t refreshDuration;
+    uint32_t presentationMode;
+    uint32_t flags;
+};
+static_assert(sizeof(FrameTimingRecord) == 96);
+
+/**
+ * The FrameTimingJournal class keeps the timings of the most recently presented or
+ * dropped frames of an output in a ring buffer.
+ *
+ * The ring buffer consists of a Header followed by FrameTimingRecords. If the
+ * KWIN_FRAME_TIMINGS_DIR environment variable is set, it lives in a file in that directory
+ * that other processes can map to monitor the frame timings. Records are written by a single
+ * thread and readers never block the writer: a reader has to check that the sequence number
+ * of a record is the same before and after copying it, otherwise the record has been
+ * overwritten in the meantime.
+ */
+class KWIN_EXPORT FrameTimingJournal
+{
+public:
+    static constexpr uint32_t s_magic = 0x4b57'4654; // "KWFT"
+    static constexpr uint32_t s_version = 1;
+    static constexpr uint32_t s_capacity = 512;
+
+    struct Header
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t recordSize;
+        uint32_t capacity;
+        /**
+         * The sequence number of the most recently written record.
+         */
+        uint64_t lastSequence;
+    };
+    static_assert(sizeof(Header) == 24);
+
+    explicit FrameTimingJournal(const QString &outputName);
+    ~FrameTimingJournal();
+
+    void add(const FrameTimingRecord &record);
+
+    /**
+     * Returns up to @a maxCount records with a sequence number that is equal to or greater
+     * than @a firstSequence as packed FrameTimingRecords. Records that have already been
+     * overwritten are skipped.
+     */
+    QByteArray records(uint64_t firstSequence, uint32_t maxCount) const;
+
+    uint64_t lastSequence() const;
+    /**
+     * Returns how many of the frames added to the journal have been dropped, including
+     * the ones whose records have already been overwritten.
+     */
+    uint64_t droppedCount() const;
+
+    /**
+     * Returns the path of the file backing the journal, or an empty string if the
+     * journal is kept in anonymous memory.
+     */
+    QString filePath() const;
+
+private:
+    Header *header() const;
+    FrameTimingRecord *recordAt(uint64_t sequence) const;
+
+    QString m_filePath;
+    FileDescriptor m_fd;
+    MemoryMap m_map;
+    uint64_t m_droppedCount = 0;
+};
+
+} // namespace KWin
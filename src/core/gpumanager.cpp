@@ -298,22 +298,42 @@ static uint64_t align(uint64_t size, uint64_t minimum)
 
 std::optional<DmaBufAttributes> GpuManager::createUdmabuf(const ShmAttributes *attributes) const
 {
-#if defined(Q_OS_LINUX)
-    if (!m_udmabuf.isValid() || !m_udmabufDevId) {
+    if (attributes->offset % getpagesize() != 0) {
         return std::nullopt;
     }
-    if (attributes->offset % getpagesize() != 0) {
+    FileDescriptor udmabuf = createUdmabuf(attributes->fd, attributes->offset, align(attributes->size.height() * attributes->stride, getpagesize()));
+    if (!udmabuf.isValid()) {
         return std::nullopt;
     }
+    return udmabufAttributes(std::move(udmabuf), 0, attributes);
+}
+
+FileDescriptor GpuManager::createUdmabuf(const FileDescriptor &memfd, off_t offset, size_t size) const
+{
+#if defined(Q_OS_LINUX)
+    if (!m_udmabuf.isValid() || !m_udmabufDevId) {
+        return FileDescriptor{};
+    }
     struct udmabuf_create create{
-        .memfd = uint32_t(attributes->fd.get()),
+        .memfd = uint32_t(memfd.get()),
         .flags = UDMABUF_FLAGS_CLOEXEC,
-        .offset = uint64_t(attributes->offset),
-        .size = align(attributes->size.height() * attributes->stride, getpagesize()),
+        .offset = uint64_t(offset),
+        .size = uint64_t(size),
     };
     int dmabufFd = ioctl(m_udmabuf.get(), UDMABUF_CREATE, &create);
     if (dmabufFd < 0) {
         qCDebug(KWIN_CORE, "Could not create udmabuf: %s", strerror(errno));
+        return FileDescriptor{};
+    }
+    return FileDescriptor{dmabufFd};
+#else
+    return FileDescriptor{};
+#endif
+}
+
+std::optional<DmaBufAttributes> GpuManager::udmabufAttributes(FileDescriptor &&udmabuf, off_t offset, const ShmAttributes *attributes) const
+{
+    if (!udmabuf.isValid() || !m_udmabufDevId) {
         return std::nullopt;
     }
 
@@ -326,13 +346,10 @@ std::optional<DmaBufAttributes> GpuManager::createUdmabuf(const ShmAttributes *a
     // NOTE this may require special handling in the future,
     // since in theory udmabuf can be imported into any device
     ret.device = *m_udmabufDevId;
-    ret.fd[0] = FileDescriptor{dmabufFd};
-    ret.offset[0] = 0;
+    ret.fd[0] = std::move(udmabuf);
+    ret.offset[0] = offset;
     ret.pitch[0] = attributes->stride;
     return ret;
-#else
-    return std::nullopt;
-#endif
 }
 
 const FileDescriptor &GpuManager::udmabuf() const
@@ -58,6 +58,17 @@ public:
      *      both CPU and GPU side accesses is up to the importer!
      */
     std::optional<DmaBufAttributes> createUdmabuf(const ShmAttributes *attributes) const;
+    /**
+     * Creates a udmabuf that covers @a size bytes of the memfd @a memfd, starting at @a offset.
+     * Both the offset and the size must be page-aligned. Returns an invalid file descriptor
+     * if the udmabuf can't be created.
+     */
+    FileDescriptor createUdmabuf(const FileDescriptor &memfd, off_t offset, size_t size) const;
+    /**
+     * Describes the shm buffer with the given @a attributes as a dmabuf, with the buffer
+     * starting at @a offset in @a udmabuf.
+     */
+    std::optional<DmaBufAttributes> udmabufAttributes(FileDescriptor &&udmabuf, off_t offset, const ShmAttributes *attributes) const;
     const FileDescriptor &udmabuf() const;
 
     void addDevice(std::unique_ptr<RenderDevice> &&kmsSoftwareDevice);
@@ -96,6 +96,11 @@ const SinglePixelAttributes *GraphicsBuffer::singlePixelAttributes() const
     return nullptr;
 }
 
+QImage GraphicsBuffer::convertedImage() const
+{
+    return QImage();
+}
+
 void GraphicsBuffer::addReleasePoint(const std::shared_ptr<SyncReleasePoint> &releasePoint)
 {
     m_releasePoints.push_back(releasePoint);
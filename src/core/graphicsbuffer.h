@@ -9,6 +9,7 @@
 #include "kwin_export.h"
 #include "utils/filedescriptor.h"
 
+#include <QImage>
 #include <QObject>
 #include <QSize>
 #include <sys/types.h>
@@ -94,6 +95,13 @@ public:
     virtual const ShmAttributes *shmAttributes() const;
     virtual const SinglePixelAttributes *singlePixelAttributes() const;
 
+    /**
+     * Returns the contents of the buffer converted to QImage::Format_ARGB32_Premultiplied if
+     * the conversion has already been done ahead of time, for example on a worker thread.
+     * Otherwise returns a null image.
+     */
+    virtual QImage convertedImage() const;
+
     /**
      * the added release point will be referenced as long as this buffer is referenced
      */
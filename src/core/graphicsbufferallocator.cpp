@@ -5,16 +5,93 @@
 */
 
 #include "core/graphicsbufferallocator.h"
+#include "core/graphicsbuffer.h"
+
+#include <QTimer>
+
+#include <algorithm>
 
 namespace KWin
 {
 
+// long enough to cover the swapchains being recreated after a mode change or hotplug,
+// short enough to not keep lots of video memory around for nothing
+static constexpr std::chrono::milliseconds s_recycleGracePeriod = std::chrono::seconds(3);
+static constexpr size_t s_maxRecycledBuffers = 8;
+
 GraphicsBufferAllocator::GraphicsBufferAllocator()
 {
 }
 
 GraphicsBufferAllocator::~GraphicsBufferAllocator()
 {
+    for (const RecycledBuffer &recycled : m_recycledBuffers) {
+        recycled.buffer->drop();
+    }
+}
+
+void GraphicsBufferAllocator::recycle(GraphicsBuffer *buffer, const GraphicsBufferOptions &options)
+{
+    if (m_recycledBuffers.size() >= s_maxRecycledBuffers) {
+        m_recycledBuffers.front().buffer->drop();
+        m_recycledBuffers.pop_front();
+    }
+    m_recycledBuffers.push_back(RecycledBuffer{
+        .buffer = buffer,
+        .options = options,
+        .expiry = std::chrono::steady_clock::now() + s_recycleGracePeriod,
+    });
+    if (!m_recycleTimer) {
+        m_recycleTimer = std::make_unique<QTimer>();
+        m_recycleTimer->setSingleShot(true);
+        QObject::connect(m_recycleTimer.get(), &QTimer::timeout, m_recycleTimer.get(), [this]() {
+            dropExpiredBuffers();
+        });
+    }
+    if (!m_recycleTimer->isActive()) {
+        m_recycleTimer->start(s_recycleGracePeriod);
+    }
+}
+
+static bool isCompatible(const GraphicsBufferOptions &recycled, const GraphicsBufferOptions &requested)
+{
+    if (recycled.size != requested.size
+        || recycled.format != requested.format
+        || recycled.software != requested.software
+        || recycled.scanout != requested.scanout) {
+        return false;
+    }
+    if (recycled.modifiers.empty() || requested.modifiers.empty()) {
+        return recycled.modifiers.empty() && requested.modifiers.empty();
+    }
+    return recycled.modifiers.size() == 1 && requested.modifiers.contains(recycled.modifiers.front());
+}
+
+GraphicsBuffer *GraphicsBufferAllocator::reuse(const GraphicsBufferOptions &options)
+{
+    // buffers that are still referenced, for example because they're still on screen or
+    // their release fence hasn't been signaled yet, can't be handed out
+    const auto it = std::ranges::find_if(m_recycledBuffers, [&options](const RecycledBuffer &recycled) {
+        return !recycled.buffer->isReferenced() && isCompatible(recycled.options, options);
+    });
+    if (it == m_recycledBuffers.end()) {
+        return nullptr;
+    }
+    GraphicsBuffer *buffer = it->buffer;
+    m_recycledBuffers.erase(it);
+    return buffer;
+}
+
+void GraphicsBufferAllocator::dropExpiredBuffers()
+{
+    const auto now = std::chrono::steady_clock::now();
+    while (!m_recycledBuffers.empty() && m_recycledBuffers.front().expiry <= now) {
+        m_recycledBuffers.front().buffer->drop();
+        m_recycledBuffers.pop_front();
+    }
+    if (!m_recycledBuffers.empty()) {
+        m_recycleTimer->start(std::chrono::duration_cast<std::chrono::milliseconds>(m_recycledBuffers.front().expiry - now) + std::chrono::milliseconds(1));
+    }
 }
 
 } // namespace KWin
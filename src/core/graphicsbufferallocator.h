@@ -12,6 +12,12 @@
 #include <QList>
 #include <QSize>
 
+#include <chrono>
+#include <deque>
+#include <memory>
+
+class QTimer;
+
 namespace KWin
 {
 
@@ -45,6 +51,33 @@ public:
     virtual ~GraphicsBufferAllocator();
 
     virtual GraphicsBuffer *allocate(const GraphicsBufferOptions &options) = 0;
+
+    /**
+     * Takes over a @a buffer that has been allocated with the given @a options and isn't
+     * needed anymore. Instead of being destroyed right away, it's kept around for a short
+     * while so that a new swapchain with the same properties can use it, for example after
+     * a mode change or when an output is re-enabled.
+     */
+    void recycle(GraphicsBuffer *buffer, const GraphicsBufferOptions &options);
+
+    /**
+     * Returns a recycled buffer that satisfies the @a options and isn't in use anymore,
+     * or @c nullptr if there is none. The buffer has to be dropped like an allocated one.
+     */
+    GraphicsBuffer *reuse(const GraphicsBufferOptions &options);
+
+private:
+    struct RecycledBuffer
+    {
+        GraphicsBuffer *buffer;
+        GraphicsBufferOptions options;
+        std::chrono::steady_clock::time_point expiry;
+    };
+
+    void dropExpiredBuffers();
+
+    std::deque<RecycledBuffer> m_recycledBuffers;
+    std::unique_ptr<QTimer> m_recycleTimer;
 };
 
 } // namespace KWin
@@ -14,7 +14,7 @@
 namespace KWin
 {
 
-static QImage::Format drmFormatToQImageFormat(uint32_t drmFormat)
+QImage::Format drmFormatToQImageFormat(uint32_t drmFormat)
 {
     switch (drmFormat) {
 #if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
@@ -13,6 +13,12 @@
 namespace KWin
 {
 
+/**
+ * Returns the QImage format that matches the memory layout of the given @a drmFormat, or
+ * QImage::Format_Invalid if there is none.
+ */
+KWIN_EXPORT QImage::Format drmFormatToQImageFormat(uint32_t drmFormat);
+
 class KWIN_EXPORT GraphicsBufferView
 {
 public:
@@ -248,9 +248,13 @@ static std::optional<ColorPipeline> parseBToATag(cmsHPROFILE profile, cmsTagSign
             const auto [x, y, z] = *size;
             std::vector<std::unique_ptr<ColorPipelineStage>> stages;
             stages.push_back(std::make_unique<ColorPipelineStage>(cmsStageDup(stage)));
+            auto lut = std::make_shared<ColorLUT3D>(std::make_unique<ColorTransformation>(std::move(stages)), x, y, z);
+            // the LUT only gets uploaded once the profile is used for rendering,
+            // sample it in the meantime instead of blocking the first frame with it
+            lut->bake();
             ret.add(ColorOp{
                 .input = ValueRange{},
-                .operation = std::make_shared<ColorLUT3D>(std::make_unique<ColorTransformation>(std::move(stages)), x, y, z),
+                .operation = std::move(lut),
                 .output = ValueRange{},
             });
         } break;
@@ -510,12 +514,17 @@ std::expected<std::unique_ptr<IccProfile>, QString> IccProfile::load(const QStri
         ColorPipeline pipeline;
         pipeline.addMatrix(toXYZD50, ValueRange{}, ColorspaceType::AnyNonRGB);
         pipeline.add(bToA1 ? *bToA1 : *bToA0);
+        std::vector<QVector3D> results(trcSize);
+        for (size_t i = 0; i < trcSize; i++) {
+            const float relativeI = i / float(trcSize - 1);
+            results[i] = QVector3D{relativeI, relativeI, relativeI};
+        }
+        pipeline.evaluate(results);
         std::array<float, trcSize> red;
         std::array<float, trcSize> green;
         std::array<float, trcSize> blue;
         for (size_t i = 0; i < trcSize; i++) {
-            const float relativeI = i / float(trcSize - 1);
-            const QVector3D result = pipeline.evaluate(QVector3D{relativeI, relativeI, relativeI});
+            const QVector3D &result = results[i];
             red[i] = result.x();
             green[i] = result.y();
             blue[i] = result.z();
@@ -92,6 +92,11 @@ bool InputDevice::tabletToolIsRelative() const
     return false;
 }
 
+uint32_t InputDevice::tabletToolCursorPrediction() const
+{
+    return 0;
+}
+
 } // namespace KWin
 
 #include "moc_inputdevice.cpp"
@@ -132,6 +132,12 @@ public:
     virtual QList<InputDeviceTabletPadModeGroup> modeGroups() const;
 
     virtual bool tabletToolIsRelative() const;
+    /**
+     * Returns how far ahead in time the position of the cursor of a tablet tool should be
+     * predicted, in milliseconds. Zero disables the prediction, the cursor is then shown
+     * where the tool has been sampled. The clients always get the sampled positions.
+     */
+    virtual uint32_t tabletToolCursorPrediction() const;
 
 Q_SIGNALS:
     void keyChanged(quint32 key, KeyboardKeyState, std::chrono::microseconds time, InputDevice *device);
@@ -12,6 +12,42 @@
 namespace KWin
 {
 
+const char *outputLayerTypeName(OutputLayerType type)
+{
+    switch (type) {
+    case OutputLayerType::Primary:
+        return "primary";
+    case OutputLayerType::CursorOnly:
+        return "cursor";
+    case OutputLayerType::EfficientOverlay:
+        return "efficient_overlay";
+    case OutputLayerType::GenericLayer:
+        return "generic";
+    }
+    Q_UNREACHABLE();
+}
+
+const char *OutputLayerStatistics::scanoutFailureName(ScanoutFailure failure)
+{
+    switch (failure) {
+    case ScanoutFailure::NoCandidate:
+        return "no_candidate";
+    case ScanoutFailure::NoDmabuf:
+        return "no_dmabuf";
+    case ScanoutFailure::PendingFence:
+        return "pending_fence";
+    case ScanoutFailure::EarlyChecks:
+        return "early_checks";
+    case ScanoutFailure::UnsupportedFormat:
+        return "unsupported_format";
+    case ScanoutFailure::UnsupportedModifier:
+        return "unsupported_modifier";
+    case ScanoutFailure::ImportFailed:
+        return "import_failed";
+    }
+    Q_UNREACHABLE();
+}
+
 OutputLayer::OutputLayer(BackendOutput *output, OutputLayerType type)
     : m_type(type)
     , m_output(output)
@@ -113,7 +149,7 @@ bool OutputLayer::earlyScanoutChecks()
     return false;
 }
 
-bool OutputLayer::importScanoutBuffer(GraphicsBuffer *buffer, const std::shared_ptr<OutputFrame> &frame)
+bool OutputLayer::importScanoutBuffer(GraphicsBuffer *buffer, bool explicitSync, const std::shared_ptr<OutputFrame> &frame)
 {
     return false;
 }
@@ -292,6 +328,16 @@ QList<FormatInfo> OutputLayer::filterAndSortFormats(const FormatModifierMap &for
     return ret;
 }
 
+OutputLayerStatistics &OutputLayer::statistics()
+{
+    return m_statistics;
+}
+
+const OutputLayerStatistics &OutputLayer::statistics() const
+{
+    return m_statistics;
+}
+
 } // namespace KWin
 
 #include "moc_outputlayer.cpp"
@@ -15,6 +15,7 @@
 #include <QObject>
 #include <QPointer>
 
+#include <array>
 #include <chrono>
 #include <optional>
 
@@ -55,6 +56,69 @@ enum class OutputLayerType {
     GenericLayer,
 };
 
+KWIN_EXPORT const char *outputLayerTypeName(OutputLayerType type);
+
+/**
+ * The OutputLayerStatistics type counts how the frames of an output layer have been produced,
+ * and why the content assigned to the layer couldn't be scanned out directly. The counters
+ * only ever grow, readers can compare them over time.
+ */
+struct KWIN_EXPORT OutputLayerStatistics
+{
+    enum class ScanoutFailure {
+        /**
+         * The assigned content is not a single surface without visible children
+         */
+        NoCandidate,
+        /**
+         * The surface has no buffer, or the buffer is not a dmabuf
+         */
+        NoDmabuf,
+        /**
+         * The client is still rendering to the buffer
+         */
+        PendingFence,
+        /**
+         * The geometry, transform or color of the surface can't be handled by the layer
+         */
+        EarlyChecks,
+        /**
+         * The layer doesn't support the format of the buffer at all
+         */
+        UnsupportedFormat,
+        /**
+         * The layer supports the format of the buffer, but not with its modifier. Usually
+         * this means that the dmabuf feedback didn't reach the client in time
+         */
+        UnsupportedModifier,
+        /**
+         * The backend failed to import the buffer
+         */
+        ImportFailed,
+    };
+    static constexpr size_t s_scanoutFailureCount = 7;
+
+    static const char *scanoutFailureName(ScanoutFailure failure);
+
+    /**
+     * Frames that have been presented with a client buffer on the layer
+     */
+    uint64_t directScanout = 0;
+    /**
+     * Frames that have been presented with newly rendered content on the layer
+     */
+    uint64_t composited = 0;
+    /**
+     * Frames that have been presented without changing the content of the enabled layer
+     */
+    uint64_t skipped = 0;
+    /**
+     * Layer configurations with this layer enabled that the backend rejected in a test
+     */
+    uint64_t testFailures = 0;
+    std::array<uint64_t, s_scanoutFailureCount> scanoutFailures{};
+};
+
 class KWIN_EXPORT OutputLayer : public QObject
 {
     Q_OBJECT
@@ -104,9 +168,11 @@ public:
      */
     virtual bool earlyScanoutChecks();
     /**
-     * Attempts to import the buffer for direct scanout
+     * Attempts to import the buffer for direct scanout. If @a explicitSync is @c true, the
+     * client's rendering to the buffer is known to be complete and there is no need to
+     * wait for its implicit fences
      */
-    virtual bool importScanoutBuffer(GraphicsBuffer *buffer, const std::shared_ptr<OutputFrame> &frame);
+    virtual bool importScanoutBuffer(GraphicsBuffer *buffer, bool explicitSync, const std::shared_ptr<OutputFrame> &frame);
 
     void setScanoutCandidate(SurfaceItem *item);
 
@@ -154,6 +220,9 @@ public:
 
     virtual void releaseBuffers() = 0;
 
+    OutputLayerStatistics &statistics();
+    const OutputLayerStatistics &statistics() const;
+
 Q_SIGNALS:
     void repaintScheduled();
 
@@ -181,6 +250,7 @@ protected:
     int m_zpos = 0;
     int m_minZpos = 0;
     int m_maxZpos = 0;
+    OutputLayerStatistics m_statistics;
 };
 
 } // namespace KWin
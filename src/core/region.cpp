@@ -8,6 +8,14 @@
 
 #include <QDebug>
 
+#include <algorithm>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
 namespace KWin
 {
 
@@ -36,14 +44,69 @@ bool Region::isEmpty() const
 
 qsizetype Region::bandByY(int y) const
 {
-    // If it becomes a performance bottleneck, use the binary search algorithm.
+    // The bands are sorted by the y coordinate, so the bottom edges of the rectangles are sorted too.
+    const auto it = std::partition_point(m_rects.cbegin(), m_rects.cend(), [y](const Rect &rect) {
+        return rect.bottom() <= y;
+    });
+    return std::distance(m_rects.cbegin(), it);
+}
+
+/*!
+ * \internal
+ *
+ * Returns \c true if any rectangle in \a rects overlaps the horizontal span between \a left and \a right.
+ *
+ * SSE2 and NEON are always available on x86-64 and AArch64, respectively, so there is no need
+ * for runtime dispatching.
+ */
+static bool overlapsHorizontally(QSpan<const Rect> rects, int left, int right)
+{
     qsizetype index = 0;
-    for (; index != m_rects.size(); ++index) {
-        if (y < m_rects[index].bottom()) {
-            break;
+
+#if defined(__SSE2__)
+    static_assert(sizeof(Rect) == 4 * sizeof(int));
+    const __m128i lefts = _mm_set1_epi32(left);
+    const __m128i rights = _mm_set1_epi32(right);
+    for (; index + 4 <= rects.size(); index += 4) {
+        const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(rects.data() + index));
+        const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(rects.data() + index + 1));
+        const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i *>(rects.data() + index + 2));
+        const __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i *>(rects.data() + index + 3));
+
+        // Transpose the rectangles so the left and the right edges end up in their own registers.
+        const __m128i abLeftTop = _mm_unpacklo_epi32(a, b);
+        const __m128i abRightBottom = _mm_unpackhi_epi32(a, b);
+        const __m128i cdLeftTop = _mm_unpacklo_epi32(c, d);
+        const __m128i cdRightBottom = _mm_unpackhi_epi32(c, d);
+        const __m128i rectLefts = _mm_unpacklo_epi64(abLeftTop, cdLeftTop);
+        const __m128i rectRights = _mm_unpacklo_epi64(abRightBottom, cdRightBottom);
+
+        const __m128i overlaps = _mm_and_si128(_mm_cmplt_epi32(rectLefts, rights), _mm_cmpgt_epi32(rectRights, lefts));
+        if (_mm_movemask_epi8(overlaps)) {
+            return true;
+        }
+    }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    static_assert(sizeof(Rect) == 4 * sizeof(int32_t));
+    const int32x4_t lefts = vdupq_n_s32(left);
+    const int32x4_t rights = vdupq_n_s32(right);
+    for (; index + 4 <= rects.size(); index += 4) {
+        // De-interleave the rectangles, val[0] and val[2] contain the left and the right edges.
+        const int32x4x4_t edges = vld4q_s32(reinterpret_cast<const int32_t *>(rects.data() + index));
+        const uint32x4_t overlaps = vandq_u32(vcltq_s32(edges.val[0], rights), vcgtq_s32(edges.val[2], lefts));
+        if (vmaxvq_u32(overlaps)) {
+            return true;
         }
     }
-    return index;
+#endif
+
+    for (; index < rects.size(); ++index) {
+        if (rects[index].left() < right && left < rects[index].right()) {
+            return true;
+        }
+    }
+
+    return false;
 }
 
 bool Region::contains(const Rect &rect) const
@@ -135,35 +198,15 @@ bool Region::intersects(const Rect &rect) const
         return false;
     }
 
-    int scanline = rect.top();
-    for (qsizetype index = bandByY(scanline); index != m_rects.size(); ++index) {
-        if (m_rects[index].bottom() <= scanline) {
-            continue;
-        }
-
-        // The current band is below the specified rectangle, no intersection is possible.
-        if (rect.bottom() <= m_rects[index].top()) {
-            return false;
-        }
-
-        // Skip a rectangle in the current band if it is far to the left.
-        if (m_rects[index].right() <= rect.left()) {
-            continue;
-        }
-
-        // Jump to the next band if a rectangle in the current band is far to the right.
-        if (rect.right() <= m_rects[index].left()) {
-            scanline = m_rects[index].bottom();
-            if (rect.bottom() <= scanline) {
-                return false;
-            }
-        } else {
-            // A rectangle in the current band partially overlaps with the specified rectangle.
-            return true;
-        }
-    }
+    // All rectangles in the bands between these two overlap the specified rectangle vertically,
+    // so it only remains to check whether any of them overlaps it horizontally.
+    const qsizetype firstBand = bandByY(rect.top());
+    const auto lastBand = std::partition_point(m_rects.cbegin() + firstBand, m_rects.cend(), [&rect](const Rect &candidate) {
+        return candidate.top() < rect.bottom();
+    });
 
-    return false;
+    const QSpan<const Rect> candidates(m_rects.constData() + firstBand, std::distance(m_rects.cbegin() + firstBand, lastBand));
+    return overlapsHorizontally(candidates, rect.left(), rect.right());
 }
 
 bool Region::intersects(const Region &other) const
@@ -1354,14 +1397,11 @@ bool RegionF::isEmpty() const
 
 qsizetype RegionF::bandByY(qreal y) const
 {
-    // If it becomes a performance bottleneck, use the binary search algorithm.
-    qsizetype index = 0;
-    for (; index != m_rects.size(); ++index) {
-        if (y < m_rects[index].bottom()) {
-            break;
-        }
-    }
-    return index;
+    // The bands are sorted by the y coordinate, so the bottom edges of the rectangles are sorted too.
+    const auto it = std::partition_point(m_rects.cbegin(), m_rects.cend(), [y](const RectF &rect) {
+        return rect.bottom() <= y;
+    });
+    return std::distance(m_rects.cbegin(), it);
 }
 
 bool RegionF::contains(const RectF &rect) const
@@ -0,0 +1,146 @@
+/*
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "core/regiontrace.h"
+#include "utils/common.h"
+
+namespace KWin
+{
+
+static void writeRect(QByteArray &buffer, const Rect &rect)
+{
+    buffer += ' ';
+    buffer += QByteArray::number(rect.x());
+    buffer += ',';
+    buffer += QByteArray::number(rect.y());
+    buffer += ',';
+    buffer += QByteArray::number(rect.width());
+    buffer += ',';
+    buffer += QByteArray::number(rect.height());
+}
+
+static std::optional<Rect> parseRect(QByteArrayView token)
+{
+    const QList<QByteArray> parts = token.toByteArray().split(',');
+    if (parts.size() != 4) {
+        return std::nullopt;
+    }
+
+    int values[4];
+    for (int i = 0; i < 4; ++i) {
+        bool ok = false;
+        values[i] = parts[i].toInt(&ok);
+        if (!ok) {
+            return std::nullopt;
+        }
+    }
+
+    if (values[2] < 0 || values[3] < 0) {
+        return std::nullopt;
+    }
+
+    return Rect(values[0], values[1], values[2], values[3]);
+}
+
+RegionTraceWriter::RegionTraceWriter(const QString &filePath)
+    : m_file(filePath)
+{
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qCWarning(KWIN_CORE) << "Failed to open region trace file" << filePath << m_file.errorString();
+    }
+}
+
+bool RegionTraceWriter::isValid() const
+{
+    return m_file.isOpen();
+}
+
+void RegionTraceWriter::beginFrame(const Region &damage)
+{
+    m_buffer += "frame";
+    for (const Rect &rect : damage.rects()) {
+        writeRect(m_buffer, rect);
+    }
+    m_buffer += '\n';
+    m_inFrame = true;
+}
+
+void RegionTraceWriter::addWindow(const Rect &bounds, const Region &opaque)
+{
+    if (!m_inFrame) {
+        return;
+    }
+
+    m_buffer += "window";
+    writeRect(m_buffer, bounds);
+    for (const Rect &rect : opaque.rects()) {
+        writeRect(m_buffer, rect);
+    }
+    m_buffer += '\n';
+}
+
+void RegionTraceWriter::endFrame()
+{
+    if (!m_inFrame) {
+        return;
+    }
+    m_inFrame = false;
+
+    if (m_file.isOpen()) {
+        m_file.write(m_buffer);
+        m_file.flush();
+    }
+    m_buffer.clear();
+}
+
+std::optional<QList<RegionTraceFrame>> loadRegionTrace(const QString &filePath)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return std::nullopt;
+    }
+
+    QList<RegionTraceFrame> frames;
+    while (!file.atEnd()) {
+        const QByteArray line = file.readLine().trimmed();
+        if (line.isEmpty() || line.startsWith('#')) {
+            continue;
+        }
+
+        const QList<QByteArray> tokens = line.split(' ');
+
+        QList<Rect> rects;
+        rects.reserve(tokens.size() - 1);
+        for (qsizetype i = 1; i < tokens.size(); ++i) {
+            const auto rect = parseRect(tokens[i]);
+            if (!rect) {
+                return std::nullopt;
+            }
+            rects.append(*rect);
+        }
+
+        if (tokens[0] == "frame") {
+            frames.append(RegionTraceFrame{
+                .damage = Region::fromUnsortedRects(rects),
+            });
+        } else if (tokens[0] == "window") {
+            if (frames.isEmpty() || rects.isEmpty()) {
+                return std::nullopt;
+            }
+            const Rect bounds = rects.takeFirst();
+            frames.last().windows.append(RegionTraceWindow{
+                .bounds = bounds,
+                .opaque = Region::fromUnsortedRects(rects),
+            });
+        } else {
+            return std::nullopt;
+        }
+    }
+
+    return frames;
+}
+
+} // namespace KWin
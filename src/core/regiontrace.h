@@ -0,0 +1,80 @@
+/*
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include "core/region.h"
+
+#include <QFile>
+
+#include <optional>
+
+namespace KWin
+{
+
+/**
+ * A window that took part in the occlusion culling pass of a frame.
+ */
+struct RegionTraceWindow
+{
+    /**
+     * The part of the output that the window can paint to, in device coordinates.
+     */
+    Rect bounds;
+    /**
+     * The part of the window that occludes the windows below it, in device coordinates.
+     */
+    Region opaque;
+};
+
+/**
+ * The regions that the scene had to deal with while painting a single frame.
+ */
+struct RegionTraceFrame
+{
+    /**
+     * The repaint region, in device coordinates.
+     */
+    Region damage;
+    /**
+     * The painted windows, from top to bottom.
+     */
+    QList<RegionTraceWindow> windows;
+};
+
+/**
+ * The RegionTraceWriter class records the regions that are used to paint frames, so they
+ * can be replayed in Region benchmarks later.
+ *
+ * A trace is a text file with one record per line. A "frame" line lists the rectangles in the
+ * damage of a frame, and it's followed by a "window" line for every window in that frame. The
+ * first rectangle in a "window" line is the bounds of the window, the remaining rectangles make
+ * up its opaque region. Rectangles are written as "x,y,width,height".
+ */
+class KWIN_EXPORT RegionTraceWriter
+{
+public:
+    explicit RegionTraceWriter(const QString &filePath);
+
+    bool isValid() const;
+
+    void beginFrame(const Region &damage);
+    void addWindow(const Rect &bounds, const Region &opaque);
+    void endFrame();
+
+private:
+    QFile m_file;
+    QByteArray m_buffer;
+    bool m_inFrame = false;
+};
+
+/**
+ * Loads a trace written by RegionTraceWriter from @a filePath. Returns std::nullopt if
+ * the file can't be read or it's malformed.
+ */
+KWIN_EXPORT std::optional<QList<RegionTraceFrame>> loadRegionTrace(const QString &filePath);
+
+} // namespace KWin
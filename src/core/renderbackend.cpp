@@ -24,6 +24,11 @@ RenderTimeSpan RenderTimeSpan::operator|(const RenderTimeSpan &other) const
     };
 }
 
+std::chrono::nanoseconds RenderTimeQuery::gpuTime() const
+{
+    return std::chrono::nanoseconds::zero();
+}
+
 CpuRenderTimeQuery::CpuRenderTimeQuery()
     : m_start(std::chrono::steady_clock::now())
 {
@@ -55,7 +60,7 @@ OutputFrame::~OutputFrame()
 {
     Q_ASSERT(QThread::currentThread() == QCoreApplication::instance()->thread());
     if (!m_presented && m_loop) {
-        RenderLoopPrivate::get(m_loop)->notifyFrameDropped();
+        RenderLoopPrivate::get(m_loop)->notifyFrameDropped(this);
     }
 }
 
@@ -90,6 +95,11 @@ void OutputFrame::presented(std::chrono::nanoseconds timestamp, PresentationMode
     m_presented = true;
 
     const auto renderTime = queryRenderTime();
+    if (renderTime) {
+        for (const auto &query : m_renderTimeQueries) {
+            m_gpuTime += query->gpuTime();
+        }
+    }
     if (m_loop) {
         RenderLoopPrivate::get(m_loop)->notifyFrameCompleted(timestamp, renderTime, mode, this);
     }
@@ -123,6 +133,16 @@ void OutputFrame::addRenderTimeQuery(std::unique_ptr<RenderTimeQuery> &&query)
     m_renderTimeQueries.push_back(std::move(query));
 }
 
+void OutputFrame::setRenderWorkload(RenderWorkload workload)
+{
+    m_renderWorkload = workload;
+}
+
+RenderWorkload OutputFrame::renderWorkload() const
+{
+    return m_renderWorkload;
+}
+
 std::chrono::steady_clock::time_point OutputFrame::targetPageflipTime() const
 {
     return m_targetPageflipTime;
@@ -138,6 +158,27 @@ std::chrono::nanoseconds OutputFrame::predictedRenderTime() const
     return m_predictedRenderTime;
 }
 
+std::chrono::nanoseconds OutputFrame::gpuTime() const
+{
+    return m_gpuTime;
+}
+
+void OutputFrame::setCommitTime(std::chrono::steady_clock::time_point time, std::chrono::nanoseconds duration)
+{
+    m_commitTime = time;
+    m_commitDuration = duration;
+}
+
+std::optional<std::chrono::steady_clock::time_point> OutputFrame::commitTime() const
+{
+    return m_commitTime;
+}
+
+std::chrono::nanoseconds OutputFrame::commitDuration() const
+{
+    return m_commitDuration;
+}
+
 std::optional<double> OutputFrame::brightness() const
 {
     return m_brightness;
@@ -7,6 +7,7 @@
 #pragma once
 
 #include "core/drm_formats.h"
+#include "core/renderjournal.h"
 #include "core/rendertarget.h"
 #include "effect/globals.h"
 #include "utils/filedescriptor.h"
@@ -50,6 +51,11 @@ class KWIN_EXPORT RenderTimeQuery
 public:
     virtual ~RenderTimeQuery() = default;
     virtual std::optional<RenderTimeSpan> query() = 0;
+    /**
+     * Returns how long the GPU was busy with the work measured by this query, or zero
+     * if the query doesn't measure GPU time. Only valid after query() has returned a result.
+     */
+    virtual std::chrono::nanoseconds gpuTime() const;
 };
 
 class KWIN_EXPORT CpuRenderTimeQuery : public RenderTimeQuery
@@ -79,6 +85,14 @@ public:
 
     void addFeedback(std::shared_ptr<PresentationFeedback> &&feedback);
 
+    /**
+     * Returns the feedback of type @c T that is shared by everything painted in this frame,
+     * and adds it to the frame on first use. This lets feedbacks that are delivered together
+     * be sent in one pass rather than one by one.
+     */
+    template<typename T>
+    T *sharedFeedback();
+
     void setContentType(ContentType type);
     std::optional<ContentType> contentType() const;
 
@@ -87,10 +101,27 @@ public:
 
     void addRenderTimeQuery(std::unique_ptr<RenderTimeQuery> &&query);
 
+    void setRenderWorkload(RenderWorkload workload);
+    RenderWorkload renderWorkload() const;
+
     std::chrono::steady_clock::time_point targetPageflipTime() const;
     std::chrono::nanoseconds refreshDuration() const;
     std::chrono::nanoseconds predictedRenderTime() const;
 
+    /**
+     * Returns the total GPU time of the render time queries. Only valid after the
+     * frame has been presented.
+     */
+    std::chrono::nanoseconds gpuTime() const;
+
+    /**
+     * The time at which the frame was handed to the kernel, if known, and how long
+     * the commit took. This may be set from the thread that submits the frame.
+     */
+    void setCommitTime(std::chrono::steady_clock::time_point time, std::chrono::nanoseconds duration);
+    std::optional<std::chrono::steady_clock::time_point> commitTime() const;
+    std::chrono::nanoseconds commitDuration() const;
+
     std::optional<double> brightness() const;
     void setBrightness(double brightness);
 
@@ -108,15 +139,35 @@ private:
     const std::chrono::steady_clock::time_point m_targetPageflipTime;
     const std::chrono::nanoseconds m_predictedRenderTime;
     std::vector<std::shared_ptr<PresentationFeedback>> m_feedbacks;
+    std::vector<PresentationFeedback *> m_sharedFeedbacks;
     std::optional<ContentType> m_contentType;
     PresentationMode m_presentationMode = PresentationMode::VSync;
     std::vector<std::unique_ptr<RenderTimeQuery>> m_renderTimeQueries;
+    RenderWorkload m_renderWorkload = RenderWorkload::Composited;
+    std::chrono::nanoseconds m_gpuTime{0};
+    std::optional<std::chrono::steady_clock::time_point> m_commitTime;
+    std::chrono::nanoseconds m_commitDuration{0};
     bool m_presented = false;
     std::optional<double> m_brightness;
     std::optional<double> m_dimmingFactor;
     std::optional<double> m_artificialHdrHeadroom;
 };
 
+template<typename T>
+T *OutputFrame::sharedFeedback()
+{
+    for (PresentationFeedback *feedback : m_sharedFeedbacks) {
+        if (auto shared = dynamic_cast<T *>(feedback)) {
+            return shared;
+        }
+    }
+    auto feedback = std::make_shared<T>();
+    T *ret = feedback.get();
+    m_sharedFeedbacks.push_back(ret);
+    m_feedbacks.push_back(std::move(feedback));
+    return ret;
+}
+
 /**
  * The RenderBackend class is the base class for all rendering backends.
  */
@@ -6,6 +6,8 @@
 
 #include "renderjournal.h"
 
+#include <QtEnvironmentVariables>
+
 #include <algorithm>
 #include <cmath>
 
@@ -14,33 +16,65 @@ using namespace std::chrono_literals;
 namespace KWin
 {
 
-RenderJournal::RenderJournal()
+static double defaultPercentile()
 {
+    bool ok = false;
+    const double percentile = qEnvironmentVariable("KWIN_RENDER_TIME_PERCENTILE").toDouble(&ok);
+    if (ok && percentile > 0 && percentile <= 100) {
+        return percentile / 100.0;
+    }
+    return 0.95;
 }
 
-static std::chrono::nanoseconds mix(std::chrono::nanoseconds duration1, std::chrono::nanoseconds duration2, double ratio)
+RenderJournal::RenderJournal(std::optional<double> percentile)
+    : m_percentile(std::clamp(percentile.value_or(defaultPercentile()), 0.0, 1.0))
 {
-    return std::chrono::nanoseconds(int64_t(std::round(duration1.count() * ratio + duration2.count() * (1 - ratio))));
 }
 
-void RenderJournal::add(std::chrono::nanoseconds renderTime, std::chrono::nanoseconds presentationTimestamp)
+void RenderJournal::add(std::chrono::nanoseconds renderTime, std::chrono::nanoseconds presentationTimestamp, RenderWorkload workload)
 {
-    const auto timeDifference = m_lastAdd ? presentationTimestamp - *m_lastAdd : 10s;
-    m_lastAdd = presentationTimestamp;
+    History &history = m_histories[size_t(workload)];
+
+    // if nothing has been rendered with this workload for a long time, the
+    // old measurements don't say much about the current situation anymore
+    static constexpr std::chrono::nanoseconds maxAge = 10s;
+    if (history.lastAdd && presentationTimestamp - *history.lastAdd > maxAge) {
+        history.count = 0;
+        history.next = 0;
+    }
+    history.lastAdd = presentationTimestamp;
 
-    static constexpr std::chrono::nanoseconds varianceTimeConstant = 6s;
-    const double varianceRatio = std::clamp(timeDifference.count() / double(varianceTimeConstant.count()), 0.001, 0.1);
-    const auto renderTimeDiff = std::max(renderTime - m_result, 0ns);
-    m_variance = std::max(mix(renderTimeDiff, m_variance, varianceRatio), renderTimeDiff);
+    history.samples[history.next] = renderTime;
+    history.next = (history.next + 1) % s_historySize;
+    history.count = std::min(history.count + 1, s_historySize);
 
-    static constexpr std::chrono::nanoseconds timeConstant = 500ms;
-    const double ratio = std::clamp(timeDifference.count() / double(timeConstant.count()), 0.01, 1.0);
-    m_result = mix(renderTime, m_result, ratio);
+    update(history);
+}
+
+void RenderJournal::update(History &history) const
+{
+    std::array<std::chrono::nanoseconds, s_historySize> sorted;
+    const auto end = std::copy_n(history.samples.begin(), history.count, sorted.begin());
+
+    // nearest-rank percentile
+    const size_t rank = std::clamp<size_t>(std::ceil(m_percentile * history.count), 1, history.count);
+    const auto nth = sorted.begin() + (rank - 1);
+    std::nth_element(sorted.begin(), nth, end);
+    history.result = *nth;
+}
+
+std::chrono::nanoseconds RenderJournal::result(RenderWorkload workload) const
+{
+    const History &history = m_histories[size_t(workload)];
+    if (history.count == 0) {
+        return m_histories[size_t(RenderWorkload::Composited)].result;
+    }
+    return history.result;
 }
 
-std::chrono::nanoseconds RenderJournal::result() const
+double RenderJournal::percentile() const
 {
-    return m_result + m_variance * 2;
+    return m_percentile;
 }
 
 } // namespace KWin
@@ -7,29 +7,79 @@
 #pragma once
 #include "kwin_export.h"
 
+#include <array>
 #include <chrono>
 #include <optional>
 
 namespace KWin
 {
 
+/**
+ * Describes what kind of work the compositor had to do to produce a frame. Render times
+ * differ a lot between these, so they are tracked separately.
+ */
+enum class RenderWorkload {
+    /**
+     * The scene is composited without any active effects.
+     */
+    Composited,
+    /**
+     * Nothing is composited, all content is scanned out directly.
+     */
+    DirectScanout,
+    /**
+     * The scene is composited and at least one effect is active.
+     */
+    Effects,
+};
+
 /**
  * The RenderJournal class measures how long it takes to render frames and estimates how
  * long it will take to render the next frame.
+ *
+ * The estimate is a percentile of the most recent render times, tracked separately for
+ * each RenderWorkload. Unlike a moving average, a single slow frame does not inflate the
+ * estimate for many subsequent frames, and spikes that happen regularly are accounted for.
  */
 class KWIN_EXPORT RenderJournal
 {
 public:
-    explicit RenderJournal();
+    /**
+     * The number of recent render times that are considered for each workload.
+     */
+    static constexpr size_t s_historySize = 64;
 
-    void add(std::chrono::nanoseconds renderTime, std::chrono::nanoseconds presentationTimestamp);
+    /**
+     * Constructs a journal that estimates the @a percentile of recent render times,
+     * in the range of [0, 1]. By default, the 95th percentile is used, which can be
+     * overridden with the KWIN_RENDER_TIME_PERCENTILE environment variable.
+     */
+    explicit RenderJournal(std::optional<double> percentile = std::nullopt);
 
-    std::chrono::nanoseconds result() const;
+    void add(std::chrono::nanoseconds renderTime, std::chrono::nanoseconds presentationTimestamp, RenderWorkload workload = RenderWorkload::Composited);
+
+    /**
+     * Returns the estimated render time for the @a workload. If there isn't any
+     * data for the workload yet, the estimate for composited frames is used.
+     */
+    std::chrono::nanoseconds result(RenderWorkload workload = RenderWorkload::Composited) const;
+
+    double percentile() const;
 
 private:
-    std::chrono::nanoseconds m_result{0};
-    std::chrono::nanoseconds m_variance{0};
-    std::optional<std::chrono::nanoseconds> m_lastAdd;
+    struct History
+    {
+        std::array<std::chrono::nanoseconds, s_historySize> samples;
+        size_t count = 0;
+        size_t next = 0;
+        std::optional<std::chrono::nanoseconds> lastAdd;
+        std::chrono::nanoseconds result{0};
+    };
+
+    void update(History &history) const;
+
+    const double m_percentile;
+    std::array<History, 3> m_histories;
 };
 
 } // namespace KWin
@@ -31,6 +31,15 @@ RenderLoopPrivate::RenderLoopPrivate(RenderLoop *q, BackendOutput *output)
     QObject::connect(&compositeTimer, &PreciseTimer::timeout, q, [this] {
         dispatch();
     });
+    vblankEstimator.reset(std::chrono::nanoseconds(1'000'000'000'000ull / refreshRate));
+}
+
+std::chrono::nanoseconds RenderLoopPrivate::vblankInterval() const
+{
+    if (vblankEstimationEnabled && vblankEstimator.isLocked()) {
+        return vblankEstimator.period();
+    }
+    return std::chrono::nanoseconds(1'000'000'000'000ull / refreshRate);
 }
 
 void RenderLoopPrivate::scheduleNextRepaint()
@@ -44,12 +53,12 @@ void RenderLoopPrivate::scheduleNextRepaint()
 void RenderLoopPrivate::scheduleRepaint(std::chrono::nanoseconds lastTargetTimestamp)
 {
     pendingReschedule = false;
-    const std::chrono::nanoseconds vblankInterval(1'000'000'000'000ull / refreshRate);
+    const std::chrono::nanoseconds vblankInterval = this->vblankInterval();
     const std::chrono::nanoseconds currentTime(std::chrono::steady_clock::now().time_since_epoch());
 
     // Estimate when it's a good time to perform the next compositing cycle.
     // the 1ms on top of the safety margin is required for timer and scheduler inaccuracies
-    std::chrono::nanoseconds expectedCompositingTime = std::min(renderJournal.result() + safetyMargin + 1ms, 2 * vblankInterval);
+    std::chrono::nanoseconds expectedCompositingTime = std::min(renderJournal.result(renderWorkload) + safetyMargin + 1ms, 2 * vblankInterval);
 
     if (presentationMode == PresentationMode::VSync) {
         // normal presentation: pageflips only happen at vblank
@@ -66,11 +75,19 @@ void RenderLoopPrivate::scheduleRepaint(std::chrono::nanoseconds lastTargetTimes
         // -> apply some amount of hysteresis to avoid switching back and forth constantly
         if (pageflipsInAdvance > 1) {
             // immediately switch to triple buffering when needed
+            if (!wasTripleBuffering) {
+                qCDebug(KWIN_CORE, "%s: switching to triple buffering, expected compositing time %lldus, refresh duration %lldus",
+                        output ? qPrintable(output->name()) : "", static_cast<long long>(std::chrono::duration_cast<std::chrono::microseconds>(expectedCompositingTime).count()),
+                        static_cast<long long>(std::chrono::duration_cast<std::chrono::microseconds>(vblankInterval).count()));
+            }
             wasTripleBuffering = true;
             doubleBufferingCounter = 0;
         } else if (wasTripleBuffering) {
             // but wait a bit before switching back to double buffering
             if (doubleBufferingCounter >= 10) {
+                qCDebug(KWIN_CORE, "%s: switching to double buffering, expected compositing time %lldus, refresh duration %lldus",
+                        output ? qPrintable(output->name()) : "", static_cast<long long>(std::chrono::duration_cast<std::chrono::microseconds>(expectedCompositingTime).count()),
+                        static_cast<long long>(std::chrono::duration_cast<std::chrono::microseconds>(vblankInterval).count()));
                 wasTripleBuffering = false;
             } else if (expectedCompositingTime >= vblankInterval * 0.95) {
                 // also don't switch back if render times are just barely enough for double buffering
@@ -93,7 +110,11 @@ void RenderLoopPrivate::scheduleRepaint(std::chrono::nanoseconds lastTargetTimes
             const uint32_t intervalsSinceLastTimestamp = std::max<int32_t>(std::round((nextPresentationTimestamp - lastPresentationTimestamp).count() / double(vblankInterval.count())), 0);
             nextPresentationTimestamp = lastPresentationTimestamp + intervalsSinceLastTimestamp * vblankInterval;
         } else {
-            nextPresentationTimestamp = lastPresentationTimestamp + std::max(pageflipsSince + pageflipsInAdvance, pageflipsSinceLastToTarget + 1) * vblankInterval;
+            uint64_t pageflips = std::max(pageflipsSince + pageflipsInAdvance, pageflipsSinceLastToTarget + 1);
+            if (minimumFrameInterval > vblankInterval) {
+                pageflips = std::max<uint64_t>(pageflips, (minimumFrameInterval + vblankInterval - 1ns) / vblankInterval);
+            }
+            nextPresentationTimestamp = lastPresentationTimestamp + pageflips * vblankInterval;
         }
     } else {
         wasTripleBuffering = false;
@@ -108,7 +129,7 @@ void RenderLoopPrivate::scheduleRepaint(std::chrono::nanoseconds lastTargetTimes
         }
     }
 
-    const std::chrono::nanoseconds nextRenderTimestamp = nextPresentationTimestamp - expectedCompositingTime;
+    nextRenderTimestamp = nextPresentationTimestamp - expectedCompositingTime;
     compositeTimer.start(nextRenderTimestamp);
 }
 
@@ -117,8 +138,10 @@ void RenderLoopPrivate::delayScheduleRepaint()
     pendingReschedule = true;
 }
 
-void RenderLoopPrivate::notifyFrameDropped()
+void RenderLoopPrivate::notifyFrameDropped(const OutputFrame *frame)
 {
+    recordFrameTiming(frame, std::chrono::nanoseconds::zero(), std::nullopt, frame->presentationMode(), true);
+
     Q_ASSERT(pendingFrameCount > 0);
     pendingFrameCount--;
 
@@ -141,13 +164,17 @@ void RenderLoopPrivate::notifyFrameCompleted(std::chrono::nanoseconds timestamp,
                        << "," << safetyMargin.count() << "," << frame->refreshDuration().count() << "," << (vrr ? 1 : 0) << "," << (tearing ? 1 : 0) << "," << frame->predictedRenderTime().count() << "\n";
     }
 
+    recordFrameTiming(frame, timestamp, renderTime, mode, false);
+
     Q_ASSERT(pendingFrameCount > 0);
     pendingFrameCount--;
 
     notifyVblank(timestamp);
 
+    // assume that the next frame is going to be similar to this one
+    renderWorkload = frame->renderWorkload();
     if (renderTime) {
-        renderJournal.add(renderTime->end - renderTime->start, timestamp);
+        renderJournal.add(renderTime->end - renderTime->start, timestamp, renderWorkload);
     }
     if (compositeTimer.isActive()) {
         // reschedule to match the new timestamp and render time
@@ -160,8 +187,64 @@ void RenderLoopPrivate::notifyFrameCompleted(std::chrono::nanoseconds timestamp,
     Q_EMIT q->framePresented(q, timestamp, mode);
 }
 
+void RenderLoopPrivate::recordFrameTiming(const OutputFrame *frame, std::chrono::nanoseconds timestamp, std::optional<RenderTimeSpan> renderTime, PresentationMode mode, bool dropped)
+{
+    if (!output) {
+        return;
+    }
+    if (!frameTimings) {
+        frameTimings = std::make_unique<FrameTimingJournal>(output->name());
+    }
+    const auto times = renderTime.value_or(RenderTimeSpan{});
+    uint32_t flags = 0;
+    if (dropped) {
+        flags |= FrameTimingRecord::Dropped;
+    }
+    if (mode == PresentationMode::AdaptiveSync || mode == PresentationMode::AdaptiveAsync) {
+        flags |= FrameTimingRecord::Vrr;
+    }
+    if (mode == PresentationMode::Async || mode == PresentationMode::AdaptiveAsync) {
+        flags |= FrameTimingRecord::Tearing;
+    }
+    if (wasTripleBuffering) {
+        flags |= FrameTimingRecord::TripleBuffering;
+    }
+    switch (frame->renderWorkload()) {
+    case RenderWorkload::DirectScanout:
+        flags |= FrameTimingRecord::DirectScanout;
+        break;
+    case RenderWorkload::Effects:
+        flags |= FrameTimingRecord::Effects;
+        break;
+    case RenderWorkload::Composited:
+        break;
+    }
+    frameTimings->add(FrameTimingRecord{
+        .sequence = 0,
+        .targetPresentation = frame->targetPageflipTime().time_since_epoch().count(),
+        .actualPresentation = timestamp.count(),
+        .renderStart = times.start.time_since_epoch().count(),
+        .renderEnd = times.end.time_since_epoch().count(),
+        .gpuTime = dropped ? 0 : frame->gpuTime().count(),
+        .commitSubmit = frame->commitTime().value_or(std::chrono::steady_clock::time_point{}).time_since_epoch().count(),
+        .commitDuration = frame->commitDuration().count(),
+        .safetyMargin = safetyMargin.count(),
+        .predictedRenderTime = frame->predictedRenderTime().count(),
+        .refreshDuration = frame->refreshDuration().count(),
+        .presentationMode = uint32_t(mode),
+        .flags = flags,
+    });
+}
+
 void RenderLoopPrivate::notifyVblank(std::chrono::nanoseconds timestamp)
 {
+    if (vblankEstimationEnabled && presentationMode == PresentationMode::VSync) {
+        vblankEstimator.addTimestamp(timestamp);
+        if (vblankEstimator.isLocked()) {
+            // the timestamp itself is imprecise, repaints should be scheduled against the real vblanks
+            timestamp = vblankEstimator.nearestVblank(timestamp);
+        }
+    }
     if (lastPresentationTimestamp <= timestamp) {
         lastPresentationTimestamp = timestamp;
     } else {
@@ -238,6 +321,7 @@ void RenderLoop::setRefreshRate(int refreshRate)
         return;
     }
     d->refreshRate = refreshRate;
+    d->vblankEstimator.reset(std::chrono::nanoseconds(1'000'000'000'000ull / refreshRate));
     Q_EMIT refreshRateChanged();
 
     if (d->compositeTimer.isActive()) {
@@ -250,6 +334,11 @@ void RenderLoop::setPresentationSafetyMargin(std::chrono::nanoseconds safetyMarg
     d->safetyMargin = safetyMargin;
 }
 
+void RenderLoop::setVblankEstimationEnabled(bool enabled)
+{
+    d->vblankEstimationEnabled = enabled;
+}
+
 void RenderLoop::scheduleRepaint(Item *item, OutputLayer *outputLayer)
 {
     const bool vrr = d->presentationMode == PresentationMode::AdaptiveSync || d->presentationMode == PresentationMode::AdaptiveAsync;
@@ -257,8 +346,18 @@ void RenderLoop::scheduleRepaint(Item *item, OutputLayer *outputLayer)
     if ((vrr || tearing) && (item || outputLayer) && activeWindowControlsVrrRefreshRate() && d->output) {
         SurfaceItem *const surfaceItem = workspace()->activeWindow()->surfaceItem();
         if (item != surfaceItem && !surfaceItem->isAncestorOf(item)) {
-            constexpr std::chrono::milliseconds s_delayVrrTimer = 1'000ms / 30;
-            d->delayedVrrTimer.start(s_delayVrrTimer, Qt::PreciseTimer, this);
+            // Other updates would make the refresh rate follow them instead of the active window,
+            // so they're delayed to be presented with the next frame of the active window. If
+            // that frame doesn't arrive shortly after it's expected, they're presented alone.
+            // The deadline isn't pushed back by further updates, otherwise constantly changing
+            // things like the cursor could hold back output updates for arbitrarily long
+            if (!d->delayedVrrTimer.isActive()) {
+                constexpr std::chrono::milliseconds s_maxVrrDelay = 1'000ms / 30;
+                constexpr std::chrono::milliseconds s_vrrDelayMargin = 1ms;
+                const auto frameTime = surfaceItem->recursiveFrameTimeEstimation().value_or(s_maxVrrDelay);
+                const auto delay = std::min(std::chrono::ceil<std::chrono::milliseconds>(frameTime) + s_vrrDelayMargin, s_maxVrrDelay);
+                d->delayedVrrTimer.start(delay, Qt::PreciseTimer, this);
+            }
             return;
         }
     }
@@ -300,6 +399,19 @@ std::chrono::nanoseconds RenderLoop::nextPresentationTimestamp() const
     return d->nextPresentationTimestamp;
 }
 
+std::chrono::nanoseconds RenderLoop::nextRenderDeadline() const
+{
+    if (d->compositeTimer.isActive()) {
+        return d->nextRenderTimestamp;
+    }
+    // this is a rough version of what scheduleRepaint() would do
+    const std::chrono::nanoseconds vblankInterval = d->vblankInterval();
+    const std::chrono::nanoseconds currentTime(std::chrono::steady_clock::now().time_since_epoch());
+    const std::chrono::nanoseconds expectedCompositingTime = std::min(d->renderJournal.result(d->renderWorkload) + d->safetyMargin + 1ms, 2 * vblankInterval);
+    const int64_t pageflips = std::max<int64_t>((currentTime + expectedCompositingTime - d->lastPresentationTimestamp + vblankInterval - 1ns) / vblankInterval, 1);
+    return d->lastPresentationTimestamp + pageflips * vblankInterval - expectedCompositingTime;
+}
+
 void RenderLoop::setPresentationMode(PresentationMode mode)
 {
     if (mode != d->presentationMode) {
@@ -313,9 +425,28 @@ void RenderLoop::setMaxPendingFrameCount(uint32_t maxCount)
     d->maxPendingFrameCount = maxCount;
 }
 
+void RenderLoop::setMinimumFrameInterval(std::chrono::nanoseconds interval)
+{
+    if (d->minimumFrameInterval == interval) {
+        return;
+    }
+    const bool lowered = interval < d->minimumFrameInterval;
+    d->minimumFrameInterval = interval;
+    if (lowered && d->compositeTimer.isActive()) {
+        // don't keep waiting for a frame that was delayed because of the old interval
+        d->compositeTimer.stop();
+        d->scheduleRepaint(d->lastPresentationTimestamp);
+    }
+}
+
 std::chrono::nanoseconds RenderLoop::predictedRenderTime() const
 {
-    return d->renderJournal.result();
+    return d->renderJournal.result(d->renderWorkload);
+}
+
+FrameTimingJournal *RenderLoop::frameTimings() const
+{
+    return d->frameTimings.get();
 }
 
 } // namespace KWin
@@ -18,6 +18,7 @@ class SurfaceItem;
 class Item;
 class BackendOutput;
 class OutputLayer;
+class FrameTimingJournal;
 
 /**
  * The RenderLoop class represents the compositing scheduler on a particular output.
@@ -73,6 +74,13 @@ public:
 
     void setPresentationSafetyMargin(std::chrono::nanoseconds safetyMargin);
 
+    /**
+     * Enables estimating the vblanks from the presentation timestamps. This should be used
+     * if the timestamps are imprecise, repaints are then scheduled against the estimated
+     * vblanks instead.
+     */
+    void setVblankEstimationEnabled(bool enabled);
+
     /**
      * Schedules a compositing cycle at the next available moment.
      */
@@ -91,15 +99,35 @@ public:
      */
     std::chrono::nanoseconds nextPresentationTimestamp() const;
 
+    /**
+     * Returns when the compositor is going to start rendering the next frame, or would start
+     * it if a repaint was scheduled now. Client buffers have to be ready by then to make it
+     * into that frame. The returned timestamp is sourced from the monotonic clock.
+     */
+    std::chrono::nanoseconds nextRenderDeadline() const;
+
     void setPresentationMode(PresentationMode mode);
 
     void setMaxPendingFrameCount(uint32_t maxCount);
 
+    /**
+     * Sets the minimum time between the presentation of two frames, rounded up to whole
+     * refresh cycles. This saves power while only small things like a clock change on the
+     * output. The default of zero doesn't limit the frame rate.
+     */
+    void setMinimumFrameInterval(std::chrono::nanoseconds interval);
+
     /**
      * Returns the expected time how long it is going to take to render the next frame.
      */
     std::chrono::nanoseconds predictedRenderTime() const;
 
+    /**
+     * Returns the timings of recently presented and dropped frames, or @c null if no
+     * frame has been presented or dropped yet.
+     */
+    FrameTimingJournal *frameTimings() const;
+
     // TODO integrate cursor updates into the render loop / frame scheduling somehow?
     // and then remove this again
     bool activeWindowControlsVrrRefreshRate() const;
@@ -6,10 +6,12 @@
 
 #pragma once
 
+#include "frametimingjournal.h"
 #include "renderbackend.h"
 #include "renderjournal.h"
 #include "renderloop.h"
 #include "utils/precisetimer.h"
+#include "vblankestimator.h"
 
 #include <QBasicTimer>
 
@@ -34,20 +36,27 @@ public:
     void scheduleNextRepaint();
     void scheduleRepaint(std::chrono::nanoseconds lastTargetTimestamp);
 
-    void notifyFrameDropped();
+    void notifyFrameDropped(const OutputFrame *frame);
     void notifyFrameCompleted(std::chrono::nanoseconds timestamp, std::optional<RenderTimeSpan> renderTime, PresentationMode mode, OutputFrame *frame);
     void notifyVblank(std::chrono::nanoseconds timestamp);
+    void recordFrameTiming(const OutputFrame *frame, std::chrono::nanoseconds timestamp, std::optional<RenderTimeSpan> renderTime, PresentationMode mode, bool dropped);
+    std::chrono::nanoseconds vblankInterval() const;
 
     RenderLoop *const q;
     BackendOutput *const output;
     std::optional<std::fstream> m_debugOutput;
+    std::unique_ptr<FrameTimingJournal> frameTimings;
     std::chrono::nanoseconds lastPresentationTimestamp = std::chrono::nanoseconds::zero();
     std::chrono::nanoseconds nextPresentationTimestamp = std::chrono::nanoseconds::zero();
+    std::chrono::nanoseconds nextRenderTimestamp = std::chrono::nanoseconds::zero();
     bool wasTripleBuffering = false;
     int doubleBufferingCounter = 0;
     PreciseTimer compositeTimer;
     RenderJournal renderJournal;
+    RenderWorkload renderWorkload = RenderWorkload::Composited;
     int refreshRate = 60000;
+    VblankEstimator vblankEstimator;
+    bool vblankEstimationEnabled = false;
     int pendingFrameCount = 0;
     bool preparingNewFrame = false;
     int inhibitCount = 0;
@@ -56,6 +65,7 @@ public:
 
     PresentationMode presentationMode = PresentationMode::VSync;
     int maxPendingFrameCount = 1;
+    std::chrono::nanoseconds minimumFrameInterval = std::chrono::nanoseconds::zero();
 
     QBasicTimer delayedVrrTimer;
 };
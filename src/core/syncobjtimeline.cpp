@@ -46,6 +46,17 @@ FileDescriptor SyncReleasePoint::mergeSyncFds(const FileDescriptor &one, const F
     }
 }
 
+void SyncReleasePoint::setSyncFdDeadline(const FileDescriptor &fd, std::chrono::steady_clock::time_point deadline)
+{
+#ifdef SYNC_IOC_SET_DEADLINE
+    sync_set_deadline args{
+        .deadline_ns = uint64_t(deadline.time_since_epoch().count()),
+        .pad = 0,
+    };
+    drmIoctl(fd.get(), SYNC_IOC_SET_DEADLINE, &args);
+#endif
+}
+
 SyncReferencer::SyncReferencer(GraphicsBuffer *buffer, FileDescriptor &&syncFd)
     : m_buffer(buffer)
     , m_sync(std::move(syncFd))
@@ -203,4 +214,22 @@ bool SyncTimeline::isMaterialized(uint64_t timelinePoint)
             == 0);
 }
 
+void SyncTimeline::setDeadline(uint64_t timelinePoint, std::chrono::steady_clock::time_point deadline)
+{
+#ifdef DRM_SYNCOBJ_WAIT_FLAGS_WAIT_DEADLINE
+    // with a timeout in the past, this only sets the deadline on the fence of the point
+    drm_syncobj_timeline_wait args{
+        .handles = uint64_t(uintptr_t(&m_handle)),
+        .points = uint64_t(uintptr_t(&timelinePoint)),
+        .timeout_nsec = 0,
+        .count_handles = 1,
+        .flags = DRM_SYNCOBJ_WAIT_FLAGS_WAIT_DEADLINE,
+        .first_signaled = 0,
+        .pad = 0,
+        .deadline_nsec = uint64_t(deadline.time_since_epoch().count()),
+    };
+    drmIoctl(m_drmFd, DRM_IOCTL_SYNCOBJ_TIMELINE_WAIT, &args);
+#endif
+}
+
 }
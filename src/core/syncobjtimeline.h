@@ -9,6 +9,7 @@
 #include "utils/filedescriptor.h"
 
 #include <QSocketNotifier>
+#include <chrono>
 #include <memory>
 #include <stdint.h>
 
@@ -28,6 +29,11 @@ public:
     virtual void addReleaseFence(const FileDescriptor &fd) = 0;
 
     static FileDescriptor mergeSyncFds(const FileDescriptor &one, const FileDescriptor &two);
+    /**
+     * Tells the driver that the work behind the sync file @a fd should be done by
+     * @a deadline, so that it can boost clocks if needed
+     */
+    static void setSyncFdDeadline(const FileDescriptor &fd, std::chrono::steady_clock::time_point deadline);
 
 protected:
     explicit SyncReleasePoint() = default;
@@ -109,6 +115,11 @@ public:
     void moveInto(uint64_t timelinePoint, const FileDescriptor &fd);
     FileDescriptor exportSyncFile(uint64_t timelinePoint);
     bool isMaterialized(uint64_t timelinePoint);
+    /**
+     * Tells the driver that the timeline point should be signaled by @a deadline. This
+     * only has an effect if the point has already been materialized
+     */
+    void setDeadline(uint64_t timelinePoint, std::chrono::steady_clock::time_point deadline);
 
 private:
     const int32_t m_drmFd;
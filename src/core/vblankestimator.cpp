@@ -0,0 +1,84 @@
+/*
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "vblankestimator.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace KWin
+{
+
+// the gains of the loop filter, the phase reacts quickly, the period slowly
+static constexpr double s_phaseGain = 1.0 / 16;
+static constexpr double s_periodGain = 1.0 / 512;
+// the real refresh rate can't be too far away from the nominal one
+static constexpr double s_maxPeriodDeviation = 0.05;
+// after this many vblanks without a timestamp, the phase is too uncertain to be corrected
+static constexpr int64_t s_maxGap = 100;
+static constexpr int s_lockThreshold = 8;
+
+void VblankEstimator::reset(std::chrono::nanoseconds nominalPeriod)
+{
+    m_nominalPeriod = nominalPeriod;
+    m_period = nominalPeriod.count();
+    m_phase.reset();
+    m_stableCount = 0;
+}
+
+void VblankEstimator::addTimestamp(std::chrono::nanoseconds timestamp)
+{
+    if (m_period <= 0) {
+        return;
+    }
+    if (!m_phase) {
+        m_phase = timestamp;
+        return;
+    }
+    const double sinceLast = (timestamp - *m_phase).count();
+    const int64_t vblanks = std::llround(sinceLast / m_period);
+    if (vblanks < 0 || vblanks > s_maxGap) {
+        // either the timestamps went backwards or there was a long pause, start over
+        m_phase = timestamp;
+        m_stableCount = 0;
+        return;
+    }
+
+    const double predicted = m_phase->count() + vblanks * m_period;
+    const double error = timestamp.count() - predicted;
+    m_phase = std::chrono::nanoseconds(std::llround(predicted + s_phaseGain * error));
+    if (vblanks > 0) {
+        const double nominal = m_nominalPeriod.count();
+        m_period = std::clamp(m_period + s_periodGain * error / vblanks, nominal * (1 - s_maxPeriodDeviation), nominal * (1 + s_maxPeriodDeviation));
+    }
+
+    if (std::abs(error) < m_period / 10) {
+        m_stableCount = std::min(m_stableCount + 1, s_lockThreshold);
+    } else {
+        m_stableCount = 0;
+    }
+}
+
+bool VblankEstimator::isLocked() const
+{
+    return m_stableCount >= s_lockThreshold;
+}
+
+std::chrono::nanoseconds VblankEstimator::period() const
+{
+    return std::chrono::nanoseconds(std::llround(m_period));
+}
+
+std::chrono::nanoseconds VblankEstimator::nearestVblank(std::chrono::nanoseconds timestamp) const
+{
+    if (!m_phase || m_period <= 0) {
+        return timestamp;
+    }
+    const int64_t vblanks = std::llround((timestamp - *m_phase).count() / m_period);
+    return *m_phase + std::chrono::nanoseconds(std::llround(vblanks * m_period));
+}
+
+} // namespace KWin
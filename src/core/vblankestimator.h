@@ -0,0 +1,58 @@
+/*
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+#include "kwin_export.h"
+
+#include <chrono>
+#include <optional>
+
+namespace KWin
+{
+
+/**
+ * The VblankEstimator class predicts vblanks of outputs that only provide imprecise
+ * presentation timestamps, like the outputs of the nested Wayland backend.
+ *
+ * It works like a phase-locked loop: every timestamp is compared with the vblank the
+ * estimator predicted for it, and a fraction of the error corrects the phase, a smaller
+ * fraction the period. This way, jitter in the timestamps averages out, while the estimate
+ * still follows slow drift of the real refresh rate.
+ */
+class KWIN_EXPORT VblankEstimator
+{
+public:
+    /**
+     * Forgets everything that has been learned so far, and starts over with
+     * the @a nominalPeriod as the first estimate of the period.
+     */
+    void reset(std::chrono::nanoseconds nominalPeriod);
+
+    /**
+     * Updates the estimate with a presentation @a timestamp.
+     */
+    void addTimestamp(std::chrono::nanoseconds timestamp);
+
+    /**
+     * Returns whether the estimate has converged. Until then, the presentation
+     * timestamps should be used as they are.
+     */
+    bool isLocked() const;
+
+    std::chrono::nanoseconds period() const;
+    /**
+     * Returns the estimated vblank that is closest to @a timestamp.
+     */
+    std::chrono::nanoseconds nearestVblank(std::chrono::nanoseconds timestamp) const;
+
+private:
+    std::chrono::nanoseconds m_nominalPeriod = std::chrono::nanoseconds::zero();
+    double m_period = 0;
+    std::optional<std::chrono::nanoseconds> m_phase;
+    int m_stableCount = 0;
+};
+
+} // namespace KWin
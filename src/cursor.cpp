@@ -12,12 +12,14 @@
 #include "core/output.h"
 #include "cursorsource.h"
 #include "main.h"
+#include "startuptracer.h"
 
 // KDE
 #include <KConfig>
 #include <KConfigGroup>
 // Qt
 #include <QDBusConnection>
+#include <QtConcurrentRun>
 
 namespace KWin
 {
@@ -143,6 +145,26 @@ void Cursor::updateTheme(const QString &name, int size)
     }
 }
 
+void Cursor::prefetchTheme(qreal devicePixelRatio)
+{
+    m_prefetchedTheme = QtConcurrent::run([name = m_themeName, size = m_themeSize, devicePixelRatio]() {
+        startupStage("Cursor theme prefetch");
+        return CursorTheme(name, size, devicePixelRatio);
+    });
+}
+
+CursorTheme Cursor::loadTheme(qreal devicePixelRatio)
+{
+    if (m_prefetchedTheme.isValid()) {
+        const CursorTheme prefetched = m_prefetchedTheme.result();
+        m_prefetchedTheme = QFuture<CursorTheme>();
+        if (prefetched.name() == m_themeName && prefetched.size() == m_themeSize && prefetched.devicePixelRatio() == devicePixelRatio) {
+            return prefetched;
+        }
+    }
+    return CursorTheme(m_themeName, m_themeSize, devicePixelRatio);
+}
+
 void Cursor::slotKGlobalSettingsNotifyChange(int type, int arg)
 {
     if (type == 5 /*CursorChanged*/) {
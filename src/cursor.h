@@ -9,8 +9,10 @@
 #pragma once
 
 #include "core/rect.h"
+#include "utils/cursortheme.h"
 
 // Qt
+#include <QFuture>
 #include <QHash>
 #include <QObject>
 #include <QPoint>
@@ -112,6 +114,16 @@ public:
      */
     static QString fallbackThemeName();
 
+    /**
+     * Starts looking up the files of the current cursor theme in a worker thread. The result
+     * is picked up by the next call to loadTheme() with the same @a devicePixelRatio.
+     */
+    void prefetchTheme(qreal devicePixelRatio);
+    /**
+     * Loads the cursor theme with the current theme name and size.
+     */
+    CursorTheme loadTheme(qreal devicePixelRatio);
+
     QPointF pos();
     void setPos(const QPointF &pos);
 
@@ -143,6 +155,7 @@ private:
     QPointF m_pos;
     QString m_themeName;
     int m_themeSize;
+    QFuture<CursorTheme> m_prefetchedTheme;
 };
 
 class KWIN_EXPORT Cursors : public QObject
@@ -15,14 +15,27 @@
 
 // kwin
 #include "compositor.h"
+#include "core/backendoutput.h"
+#include "core/frametimingjournal.h"
+#include "core/graphicsbuffer.h"
 #include "core/output.h"
+#include "core/outputbackend.h"
+#include "core/outputlayer.h"
 #include "core/renderbackend.h"
+#include "core/renderloop.h"
 #include "debug_console.h"
 #include "kwinadaptor.h"
 #include "main.h"
 #include "placement.h"
 #include "pluginmanager.h"
+#include "scene/surfaceitem.h"
+#include "scene/texturememorybudget.h"
+#include "scene/windowitem.h"
+#include "scene/workspacescene.h"
 #include "virtualdesktops.h"
+#include "wayland/clientconnection.h"
+#include "wayland/commitlatency.h"
+#include "wayland/surface.h"
 #include "window.h"
 #include "workspace.h"
 #if KWIN_BUILD_ACTIVITIES
@@ -31,11 +44,43 @@
 
 // Qt
 #include <QDBusConnection>
+#include <QHash>
 #include <QOpenGLContext>
 
+#include <algorithm>
+#include <array>
+#include <span>
+
 namespace KWin
 {
 
+static QHash<QString, LatencyHistogram> s_callLatency;
+
+/**
+ * Records how long the D-Bus method it has been created in took, the latencies are exported
+ * by CompositorDBusInterface::metrics()
+ */
+class DBusCallScope
+{
+public:
+    explicit DBusCallScope(const char *method)
+        : m_method(method)
+        , m_start(std::chrono::steady_clock::now())
+    {
+    }
+    ~DBusCallScope()
+    {
+        s_callLatency[QLatin1StringView(m_method)].add(std::chrono::steady_clock::now() - m_start);
+    }
+
+private:
+    const char *const m_method;
+    const std::chrono::steady_clock::time_point m_start;
+};
+
+// support information is expensive to assemble, but it barely changes
+static constexpr std::chrono::seconds s_supportInformationLifetime(1);
+
 DBusInterface::DBusInterface(QObject *parent)
     : QObject(parent)
     , m_serviceName(QStringLiteral("org.kde.KWin"))
@@ -73,21 +118,30 @@ void DBusInterface::killWindow()
 
 QString DBusInterface::supportInformation()
 {
-    return Workspace::self()->supportInformation();
+    DBusCallScope scope("org.kde.KWin.supportInformation");
+    const auto now = std::chrono::steady_clock::now();
+    if (m_supportInformation.isEmpty() || now - m_supportInformationTimestamp > s_supportInformationLifetime) {
+        m_supportInformation = Workspace::self()->supportInformation();
+        m_supportInformationTimestamp = now;
+    }
+    return m_supportInformation;
 }
 
 QString DBusInterface::activeOutputName()
 {
+    DBusCallScope scope("org.kde.KWin.activeOutputName");
     return Workspace::self()->activeOutput()->name();
 }
 
 int DBusInterface::currentDesktop()
 {
+    DBusCallScope scope("org.kde.KWin.currentDesktop");
     return VirtualDesktopManager::self()->current();
 }
 
 bool DBusInterface::setCurrentDesktop(int desktop)
 {
+    DBusCallScope scope("org.kde.KWin.setCurrentDesktop");
     return VirtualDesktopManager::self()->setCurrent(desktop);
 }
 
@@ -179,6 +233,7 @@ QVariantMap DBusInterface::queryWindowInfo()
 
 QVariantMap DBusInterface::getWindowInfo(const QString &uuid)
 {
+    DBusCallScope scope("org.kde.KWin.getWindowInfo");
     const auto window = workspace()->findWindow(QUuid::fromString(uuid));
     if (window) {
         return clientToVariantMap(window);
@@ -288,6 +343,308 @@ QStringList CompositorDBusInterface::supportedOpenGLPlatformInterfaces() const
     return {QStringLiteral("egl")};
 }
 
+static FrameTimingJournal *findFrameTimings(const QString &outputName)
+{
+    const auto outputs = kwinApp()->outputBackend()->outputs();
+    for (BackendOutput *output : outputs) {
+        if (output->name() == outputName) {
+            return output->renderLoop()->frameTimings();
+        }
+    }
+    return nullptr;
+}
+
+QByteArray CompositorDBusInterface::frameTimings(const QString &outputName, qulonglong firstSequence, uint maxCount)
+{
+    // keep the reply size reasonable
+    static constexpr uint maxBatchSize = 256;
+    DBusCallScope scope("org.kde.kwin.Compositing.frameTimings");
+    const FrameTimingJournal *journal = findFrameTimings(outputName);
+    return journal ? journal->records(firstSequence, std::min(maxCount, maxBatchSize)) : QByteArray();
+}
+
+QString CompositorDBusInterface::frameTimingsFile(const QString &outputName)
+{
+    const FrameTimingJournal *journal = findFrameTimings(outputName);
+    return journal ? journal->filePath() : QString();
+}
+
+static QString formatLatency(std::chrono::nanoseconds latency)
+{
+    if (latency == std::chrono::nanoseconds::max()) {
+        return QStringLiteral("more");
+    }
+    return QStringLiteral("%1ms").arg(std::chrono::duration<double, std::milli>(latency).count());
+}
+
+static QList<ClientConnection *> windowClients()
+{
+    QList<ClientConnection *> clients;
+    const auto windows = workspace()->windows();
+    for (const Window *window : windows) {
+        if (window->surface() && !clients.contains(window->surface()->client())) {
+            clients.push_back(window->surface()->client());
+        }
+    }
+    return clients;
+}
+
+QString CompositorDBusInterface::commitLatency()
+{
+    DBusCallScope scope("org.kde.kwin.Compositing.commitLatency");
+    static constexpr std::array stages{
+        std::make_pair(CommitLatencyStatistics::Stage::Fences, "fences"),
+        std::make_pair(CommitLatencyStatistics::Stage::Queue, "queue"),
+        std::make_pair(CommitLatencyStatistics::Stage::Paint, "paint"),
+        std::make_pair(CommitLatencyStatistics::Stage::Presentation, "presentation"),
+        std::make_pair(CommitLatencyStatistics::Stage::Total, "total"),
+    };
+
+    QString ret;
+    const QList<ClientConnection *> clients = windowClients();
+    for (const ClientConnection *client : clients) {
+        const CommitLatencyStatistics &statistics = client->commitLatency();
+        ret += QStringLiteral("%1 (pid %2), %3 discarded\n").arg(client->executablePath()).arg(client->processId()).arg(statistics.discardedCount());
+        for (const auto &[stage, name] : stages) {
+            const LatencyHistogram &histogram = statistics.histogram(stage);
+            ret += QStringLiteral("    %1: %2 commits, p50 <= %3, p90 <= %4, p99 <= %5\n")
+                       .arg(QLatin1StringView(name))
+                       .arg(histogram.count())
+                       .arg(formatLatency(histogram.percentile(0.5)), formatLatency(histogram.percentile(0.9)), formatLatency(histogram.percentile(0.99)));
+        }
+        const LatencyHistogram &input = statistics.inputLatency();
+        ret += QStringLiteral("    input to presentation: %1 commits, p50 <= %2, p90 <= %3, p99 <= %4\n")
+                   .arg(input.count())
+                   .arg(formatLatency(input.percentile(0.5)), formatLatency(input.percentile(0.9)), formatLatency(input.percentile(0.99)));
+        const LatencyHistogram &resize = statistics.resizeLatency();
+        ret += QStringLiteral("    interactive resize: %1 configures, p50 <= %2, p90 <= %3, p99 <= %4\n")
+                   .arg(resize.count())
+                   .arg(formatLatency(resize.percentile(0.5)), formatLatency(resize.percentile(0.9)), formatLatency(resize.percentile(0.99)));
+    }
+    return ret;
+}
+
+struct ItemMemoryUsage
+{
+    int items = 0;
+    size_t clientBuffers = 0;
+    size_t uploadedTextures = 0;
+};
+
+static void collectMemoryUsage(const Item *item, ItemMemoryUsage &usage)
+{
+    usage.items++;
+    if (const auto surfaceItem = qobject_cast<const SurfaceItem *>(item)) {
+        if (const GraphicsBuffer *buffer = surfaceItem->buffer()) {
+            if (const ShmAttributes *shm = buffer->shmAttributes()) {
+                usage.clientBuffers += size_t(shm->stride) * shm->size.height();
+                // shared memory buffers get copied to a texture, other buffers are imported
+                if (surfaceItem->texture()) {
+                    usage.uploadedTextures += size_t(shm->size.width()) * shm->size.height() * 4;
+                }
+            } else if (const DmaBufAttributes *dmabuf = buffer->dmabufAttributes()) {
+                for (int i = 0; i < dmabuf->planeCount; i++) {
+                    usage.clientBuffers += size_t(dmabuf->pitch[i]) * dmabuf->height;
+                }
+            }
+        }
+    }
+    const auto children = item->childItems();
+    for (const Item *child : children) {
+        collectMemoryUsage(child, usage);
+    }
+}
+
+static QString formatBytes(size_t bytes)
+{
+    return QStringLiteral("%1KiB").arg(bytes / 1024);
+}
+
+QString CompositorDBusInterface::memoryUsage()
+{
+    DBusCallScope scope("org.kde.kwin.Compositing.memoryUsage");
+
+    QString ret;
+    const auto windows = workspace()->windows();
+    for (const Window *window : windows) {
+        if (!window->windowItem()) {
+            continue;
+        }
+        ItemMemoryUsage usage;
+        collectMemoryUsage(window->windowItem(), usage);
+        ret += QStringLiteral("%1 (%2): %3 items, %4 client buffers, %5 uploaded textures\n")
+                   .arg(window->caption(), window->resourceClass())
+                   .arg(usage.items)
+                   .arg(formatBytes(usage.clientBuffers), formatBytes(usage.uploadedTextures));
+    }
+
+    const TextureMemoryBudget *budget = kwinApp()->scene()->textureMemoryBudget();
+    ret += QStringLiteral("Caches and offscreen textures: %1 of %2\n").arg(formatBytes(budget->usage()), formatBytes(budget->budget()));
+    const auto usageByOwner = budget->usageByOwner();
+    for (const auto &[owner, size] : usageByOwner) {
+        ret += QStringLiteral("    %1: %2\n").arg(owner, formatBytes(size));
+    }
+    return ret;
+}
+
+static QString metricLabelValue(const QString &value)
+{
+    QString ret = value;
+    ret.replace(QLatin1Char('\\'), QLatin1String("\\\\"));
+    ret.replace(QLatin1Char('"'), QLatin1String("\\\""));
+    ret.replace(QLatin1Char('\n'), QLatin1String("\\n"));
+    return QLatin1Char('"') + ret + QLatin1Char('"');
+}
+
+static QString metricSeconds(std::chrono::nanoseconds duration)
+{
+    return QString::number(std::chrono::duration<double>(duration).count(), 'g', 9);
+}
+
+static void appendMetricFamily(QString &ret, const char *name, const char *type, const char *help)
+{
+    ret += QStringLiteral("# TYPE %1 %2\n# HELP %1 %3\n").arg(QLatin1StringView(name), QLatin1StringView(type), QLatin1StringView(help));
+}
+
+static void appendHistogram(QString &ret, const char *name, const QString &labels, const LatencyHistogram &histogram)
+{
+    quint64 accumulated = 0;
+    for (size_t i = 0; i < LatencyHistogram::s_bucketCount; i++) {
+        accumulated += histogram.bucket(i);
+        const std::chrono::nanoseconds upperBound = LatencyHistogram::bucketUpperBound(i);
+        const QString le = upperBound == std::chrono::nanoseconds::max() ? QStringLiteral("+Inf") : metricSeconds(upperBound);
+        ret += QStringLiteral("%1_bucket{%2,le=\"%3\"} %4\n").arg(QLatin1StringView(name), labels, le).arg(accumulated);
+    }
+    ret += QStringLiteral("%1_count{%2} %3\n").arg(QLatin1StringView(name), labels).arg(histogram.count());
+}
+
+QString CompositorDBusInterface::metrics()
+{
+    DBusCallScope scope("org.kde.kwin.Compositing.metrics");
+    static constexpr std::array stages{
+        std::make_pair(CommitLatencyStatistics::Stage::Fences, "fences"),
+        std::make_pair(CommitLatencyStatistics::Stage::Queue, "queue"),
+        std::make_pair(CommitLatencyStatistics::Stage::Paint, "paint"),
+        std::make_pair(CommitLatencyStatistics::Stage::Presentation, "presentation"),
+        std::make_pair(CommitLatencyStatistics::Stage::Total, "total"),
+    };
+
+    struct OutputFrames
+    {
+        QString labels;
+        uint64_t frames;
+        uint64_t dropped;
+        std::vector<std::chrono::nanoseconds> renderTimes;
+    };
+    std::vector<OutputFrames> outputs;
+    const auto backendOutputs = kwinApp()->outputBackend()->outputs();
+    for (BackendOutput *output : backendOutputs) {
+        const FrameTimingJournal *journal = output->renderLoop()->frameTimings();
+        if (!journal) {
+            continue;
+        }
+        const QByteArray data = journal->records(0, FrameTimingJournal::s_capacity);
+        const auto records = std::span(reinterpret_cast<const FrameTimingRecord *>(data.constData()), data.size() / sizeof(FrameTimingRecord));
+        std::vector<std::chrono::nanoseconds> renderTimes;
+        for (const FrameTimingRecord &record : records) {
+            if (!(record.flags & FrameTimingRecord::Dropped)) {
+                renderTimes.push_back(std::chrono::nanoseconds(record.renderEnd - record.renderStart));
+            }
+        }
+        std::ranges::sort(renderTimes);
+        outputs.push_back(OutputFrames{
+            .labels = QStringLiteral("output=") + metricLabelValue(output->name()),
+            .frames = journal->lastSequence(),
+            .dropped = journal->droppedCount(),
+            .renderTimes = std::move(renderTimes),
+        });
+    }
+
+    QString ret;
+    appendMetricFamily(ret, "kwin_output_frames", "counter", "Frames that have been presented or dropped.");
+    for (const OutputFrames &output : outputs) {
+        ret += QStringLiteral("kwin_output_frames_total{%1} %2\n").arg(output.labels).arg(output.frames);
+    }
+    appendMetricFamily(ret, "kwin_output_dropped_frames", "counter", "Frames that have been dropped instead of presented.");
+    for (const OutputFrames &output : outputs) {
+        ret += QStringLiteral("kwin_output_dropped_frames_total{%1} %2\n").arg(output.labels).arg(output.dropped);
+    }
+    appendMetricFamily(ret, "kwin_output_render_time_seconds", "summary", "CPU and GPU time it took to render the recently presented frames.");
+    for (const OutputFrames &output : outputs) {
+        if (output.renderTimes.empty()) {
+            continue;
+        }
+        for (const double quantile : {0.5, 0.9, 0.99}) {
+            const auto renderTime = output.renderTimes[std::min<size_t>(output.renderTimes.size() - 1, output.renderTimes.size() * quantile)];
+            ret += QStringLiteral("kwin_output_render_time_seconds{%1,quantile=\"%2\"} %3\n").arg(output.labels).arg(quantile).arg(metricSeconds(renderTime));
+        }
+    }
+
+    struct LayerStatistics
+    {
+        QString labels;
+        OutputLayerStatistics statistics;
+    };
+    std::vector<LayerStatistics> layers;
+    if (RenderBackend *backend = Compositor::self()->backend()) {
+        for (BackendOutput *output : backendOutputs) {
+            const QList<OutputLayer *> outputLayers = backend->compatibleOutputLayers(output);
+            for (qsizetype i = 0; i < outputLayers.size(); i++) {
+                layers.push_back(LayerStatistics{
+                    .labels = QStringLiteral("output=%1,layer=\"%2\",type=\"%3\"").arg(metricLabelValue(output->name())).arg(i).arg(QLatin1StringView(outputLayerTypeName(outputLayers[i]->type()))),
+                    .statistics = outputLayers[i]->statistics(),
+                });
+            }
+        }
+    }
+    appendMetricFamily(ret, "kwin_output_layer_frames", "counter", "Presented frames with the layer enabled, by how its content was produced.");
+    for (const LayerStatistics &layer : layers) {
+        ret += QStringLiteral("kwin_output_layer_frames_total{%1,kind=\"direct_scanout\"} %2\n").arg(layer.labels).arg(layer.statistics.directScanout);
+        ret += QStringLiteral("kwin_output_layer_frames_total{%1,kind=\"composited\"} %2\n").arg(layer.labels).arg(layer.statistics.composited);
+        ret += QStringLiteral("kwin_output_layer_frames_total{%1,kind=\"skipped\"} %2\n").arg(layer.labels).arg(layer.statistics.skipped);
+    }
+    appendMetricFamily(ret, "kwin_output_layer_test_failures", "counter", "Layer configurations with the layer enabled that failed the presentation test.");
+    for (const LayerStatistics &layer : layers) {
+        ret += QStringLiteral("kwin_output_layer_test_failures_total{%1} %2\n").arg(layer.labels).arg(layer.statistics.testFailures);
+    }
+    appendMetricFamily(ret, "kwin_output_layer_scanout_failures", "counter", "Attempts to directly scan out the content assigned to the layer that failed, by reason.");
+    for (const LayerStatistics &layer : layers) {
+        for (size_t failure = 0; failure < OutputLayerStatistics::s_scanoutFailureCount; failure++) {
+            const char *reason = OutputLayerStatistics::scanoutFailureName(OutputLayerStatistics::ScanoutFailure(failure));
+            ret += QStringLiteral("kwin_output_layer_scanout_failures_total{%1,reason=\"%2\"} %3\n").arg(layer.labels, QLatin1StringView(reason)).arg(layer.statistics.scanoutFailures[failure]);
+        }
+    }
+
+    const QList<ClientConnection *> clients = windowClients();
+    QStringList clientLabels;
+    for (const ClientConnection *client : clients) {
+        clientLabels.append(QStringLiteral("client=%1,pid=\"%2\"").arg(metricLabelValue(client->executablePath())).arg(client->processId()));
+    }
+    appendMetricFamily(ret, "kwin_wayland_clients", "gauge", "Wayland clients with windows.");
+    ret += QStringLiteral("kwin_wayland_clients %1\n").arg(clients.size());
+    appendMetricFamily(ret, "kwin_client_commit_latency_seconds", "histogram", "Time from surface commits to the presentation of the frames they were painted in, split up into stages.");
+    for (qsizetype i = 0; i < clients.size(); i++) {
+        for (const auto &[stage, name] : stages) {
+            appendHistogram(ret, "kwin_client_commit_latency_seconds", clientLabels[i] + QStringLiteral(",stage=\"%1\"").arg(QLatin1StringView(name)), clients[i]->commitLatency().histogram(stage));
+        }
+    }
+    appendMetricFamily(ret, "kwin_client_input_latency_seconds", "histogram", "Time from input events to the presentation of the commits that followed them.");
+    for (qsizetype i = 0; i < clients.size(); i++) {
+        appendHistogram(ret, "kwin_client_input_latency_seconds", clientLabels[i], clients[i]->commitLatency().inputLatency());
+    }
+    appendMetricFamily(ret, "kwin_client_discarded_commits", "counter", "Commits that were painted in frames that have never been presented.");
+    for (qsizetype i = 0; i < clients.size(); i++) {
+        ret += QStringLiteral("kwin_client_discarded_commits_total{%1} %2\n").arg(clientLabels[i]).arg(clients[i]->commitLatency().discardedCount());
+    }
+
+    appendMetricFamily(ret, "kwin_dbus_call_latency_seconds", "histogram", "Time the D-Bus method calls took to be handled on the main thread.");
+    for (auto it = s_callLatency.cbegin(); it != s_callLatency.cend(); ++it) {
+        appendHistogram(ret, "kwin_dbus_call_latency_seconds", QStringLiteral("method=") + metricLabelValue(it.key()), it.value());
+    }
+    ret += QStringLiteral("# EOF\n");
+    return ret;
+}
+
 VirtualDesktopManagerDBusInterface::VirtualDesktopManagerDBusInterface(VirtualDesktopManager *parent)
     : QObject(parent)
     , m_manager(parent)
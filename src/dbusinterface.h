@@ -15,6 +15,8 @@
 
 #include "virtualdesktopsdbustypes.h"
 
+#include <chrono>
+
 namespace KWin
 {
 
@@ -97,6 +99,8 @@ private Q_SLOTS:
 private:
     QString m_serviceName;
     QDBusMessage m_replyQueryWindowInfo;
+    QString m_supportInformation;
+    std::chrono::steady_clock::time_point m_supportInformationTimestamp;
 };
 
 class CompositorDBusInterface : public QObject
@@ -167,6 +171,48 @@ public Q_SLOTS:
      */
     void reinitialize();
 
+    /**
+     * Returns up to @p maxCount packed frame timing records of the output with the name
+     * @p outputName, starting at the record with the sequence number @p firstSequence.
+     *
+     * @see FrameTimingRecord
+     */
+    QByteArray frameTimings(const QString &outputName, qulonglong firstSequence, uint maxCount);
+
+    /**
+     * Returns the path of the memory-mappable file with the frame timings of the output
+     * with the name @p outputName, or an empty string if the frame timings are not written
+     * to a file. Set the KWIN_FRAME_TIMINGS_DIR environment variable to enable the file.
+     */
+    QString frameTimingsFile(const QString &outputName);
+
+    /**
+     * Returns a human readable summary of how long the surface commits of each client with
+     * a window took from the commit request to their presentation, split up into waiting for
+     * buffer fences, waiting in the transaction queue, waiting to get painted and waiting for
+     * the painted frame to be presented.
+     *
+     * @see CommitLatencyStatistics
+     */
+    QString commitLatency();
+
+    /**
+     * Returns the performance counters of the compositor in the OpenMetrics text format, so
+     * that monitoring agents can scrape them: the presented and dropped frames and the recent
+     * render times of every output, how the frames of the output layers have been produced
+     * and why direct scanout failed, the commit latency histograms of every client with a
+     * window and how long the D-Bus calls took to be handled.
+     */
+    QString metrics();
+
+    /**
+     * Returns a human readable summary of how much memory the items of every window use,
+     * that is the number of items, the size of the client buffers they show and the size
+     * of the textures that the buffers have been copied to, followed by the GPU memory
+     * that is used by caches and offscreen textures.
+     */
+    QString memoryUsage();
+
 Q_SIGNALS:
     void compositingToggled(bool active);
 
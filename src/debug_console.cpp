@@ -8,13 +8,20 @@
 */
 #include "debug_console.h"
 #include "compositor.h"
+#include "core/backendoutput.h"
+#include "core/frametimingjournal.h"
 #include "core/inputdevice.h"
+#include "core/outputbackend.h"
+#include "core/outputlayer.h"
+#include "core/renderbackend.h"
+#include "core/renderloop.h"
 #include "effect/effecthandler.h"
 #include "input_event.h"
 #include "internalwindow.h"
 #include "keyboard_input.h"
 #include "main.h"
 #include "opengl/eglbackend.h"
+#include "opengl/glgpuprofiler.h"
 #include "opengl/glplatform.h"
 #include "opengl/glutils.h"
 #include "scene/workspacescene.h"
@@ -22,14 +29,17 @@
 #include "tiles/tile.h"
 #include "utils/filedescriptor.h"
 #include "utils/pipe.h"
+#include "utils/realtime.h"
 #include "virtualdesktops.h"
 #include "wayland/abstract_data_source.h"
 #include "wayland/clientconnection.h"
+#include "wayland/commitlatency.h"
 #include "wayland/datacontrolsource_v1.h"
 #include "wayland/datasource.h"
 #include "wayland/display.h"
 #include "wayland/primaryselectionsource_v1.h"
 #include "wayland/seat.h"
+#include "wayland/shmclientbuffer.h"
 #include "wayland/surface.h"
 #include "wayland_server.h"
 #include "waylandwindow.h"
@@ -47,6 +57,7 @@
 // Qt
 #include <QFont>
 #include <QFutureWatcher>
+#include <QLabel>
 #include <QMetaProperty>
 #include <QMetaType>
 #include <QMouseEvent>
@@ -55,6 +66,7 @@
 #include <QPushButton>
 #include <QScopeGuard>
 #include <QSortFilterProxyModel>
+#include <QTimer>
 #include <QWindow>
 #include <QtConcurrentRun>
 
@@ -65,6 +77,7 @@
 
 #include <fcntl.h>
 #include <functional>
+#include <span>
 #include <sys/poll.h>
 
 namespace KWin
@@ -695,6 +708,28 @@ static QString sourceString(const AbstractDataSource *const source)
     return QStringLiteral("%1(0x%2)").arg(source->metaObject()->className()).arg(qulonglong(source), 0, 16);
 }
 
+static QString shmStatisticsString()
+{
+    ShmClientBufferIntegration *shm = waylandServer()->display()->shm();
+    if (!shm) {
+        return i18n("Shared memory buffers are not supported");
+    }
+
+    const ShmUdmabufStatistics statistics = shm->udmabufStatistics();
+    const uint64_t imports = statistics.cachedImports + statistics.bufferImports;
+    const uint64_t buffers = imports + statistics.uploads;
+
+    QString text = s_tableStart;
+    text.append(tableHeaderRow(i18nc("udmabuf is a technical term and shouldn't be translated", "udmabuf Imports")));
+    text.append(tableRow(i18n("Converted pools"), statistics.poolImports));
+    text.append(tableRow(i18n("Buffers referencing their pool"), statistics.cachedImports));
+    text.append(tableRow(i18n("Buffers with their own udmabuf"), statistics.bufferImports));
+    text.append(tableRow(i18n("Uploaded buffers"), statistics.uploads));
+    text.append(tableRow(i18n("Hit rate"), buffers ? QStringLiteral("%1%").arg(100.0 * imports / buffers, 0, 'f', 1) : QStringLiteral("-")));
+    text.append(s_tableEnd);
+    return text;
+}
+
 DebugConsole::DebugConsole()
     : QWidget()
     , m_ui(new Ui::DebugConsole)
@@ -719,12 +754,25 @@ DebugConsole::DebugConsole()
 
     m_ui->tabWidget->addTab(new DebugConsoleEffectsTab(), i18nc("@label", "Effects"));
 
-    connect(m_ui->tabWidget, &QTabWidget::currentChanged, this, [this](int index) {
+    auto shmTab = new QLabel();
+    shmTab->setAlignment(Qt::AlignLeft | Qt::AlignTop);
+    shmTab->setTextFormat(Qt::RichText);
+    m_ui->tabWidget->addTab(shmTab, i18nc("@label", "Shared Memory"));
+
+    if (effects && effects->isOpenGLCompositing()) {
+        m_ui->tabWidget->addTab(new DebugConsoleGpuTimeTab(), i18nc("@label", "GPU Time"));
+    }
+    m_ui->tabWidget->addTab(new DebugConsolePerformanceTab(), i18nc("@label", "Performance"));
+
+    connect(m_ui->tabWidget, &QTabWidget::currentChanged, this, [this, shmTab](int index) {
         // delay creation of input event filter until the tab is selected
         if (index == m_ui->tabWidget->indexOf(m_ui->input) && !m_inputFilter) {
             m_inputFilter = std::make_unique<DebugConsoleFilter>(m_ui->inputTextEdit);
             input()->installInputEventSpy(m_inputFilter.get());
         }
+        if (index == m_ui->tabWidget->indexOf(shmTab)) {
+            shmTab->setText(shmStatisticsString());
+        }
         if (index == m_ui->tabWidget->indexOf(m_ui->keyboard)) {
             updateKeyboardTab();
             connect(input(), &InputRedirection::keyStateChanged, this, &DebugConsole::updateKeyboardTab);
@@ -1887,6 +1935,241 @@ DebugConsoleEffectsTab::DebugConsoleEffectsTab(QWidget *parent)
     }
 }
 
+DebugConsoleGpuTimeTab::DebugConsoleGpuTimeTab(QWidget *parent)
+    : QLabel(parent)
+    , m_timer(new QTimer(this))
+{
+    setAlignment(Qt::AlignLeft | Qt::AlignTop);
+    setTextFormat(Qt::RichText);
+    m_timer->setInterval(std::chrono::seconds(1));
+    connect(m_timer, &QTimer::timeout, this, &DebugConsoleGpuTimeTab::updateText);
+}
+
+DebugConsoleGpuTimeTab::~DebugConsoleGpuTimeTab()
+{
+    if (m_profiling) {
+        GLGpuProfiler::removeUser();
+    }
+}
+
+void DebugConsoleGpuTimeTab::showEvent(QShowEvent *event)
+{
+    QLabel::showEvent(event);
+    if (!m_profiling) {
+        m_profiling = true;
+        GLGpuProfiler::addUser();
+    }
+    updateText();
+    m_timer->start();
+}
+
+void DebugConsoleGpuTimeTab::hideEvent(QHideEvent *event)
+{
+    QLabel::hideEvent(event);
+    m_timer->stop();
+    if (m_profiling) {
+        m_profiling = false;
+        GLGpuProfiler::removeUser();
+    }
+}
+
+void DebugConsoleGpuTimeTab::updateText()
+{
+    const QStringList outputs = GLGpuProfiler::frameNames();
+    if (outputs.isEmpty()) {
+        setText(i18n("No frames have been profiled yet. If this doesn't change, the driver doesn't support timer queries."));
+        return;
+    }
+
+    QString text;
+    for (const QString &output : outputs) {
+        text.append(s_tableStart);
+        text.append(tableHeaderRow(output));
+        const QList<GLGpuProfiler::Section> sections = GLGpuProfiler::lastFrame(output);
+        for (const GLGpuProfiler::Section &section : sections) {
+            const QString indentation = QStringLiteral("&nbsp;&nbsp;&nbsp;&nbsp;").repeated(section.depth);
+            text.append(tableRow(indentation + section.name.toHtmlEscaped(), QStringLiteral("%1 ms").arg(section.duration.count() / 1'000'000.0, 0, 'f', 3)));
+        }
+        text.append(s_tableEnd);
+    }
+    setText(text);
+}
+
+DebugConsolePerformanceTab::DebugConsolePerformanceTab(QWidget *parent)
+    : QLabel(parent)
+    , m_timer(new QTimer(this))
+{
+    setAlignment(Qt::AlignLeft | Qt::AlignTop);
+    setTextFormat(Qt::RichText);
+    m_timer->setInterval(std::chrono::seconds(1));
+    connect(m_timer, &QTimer::timeout, this, &DebugConsolePerformanceTab::updateText);
+}
+
+void DebugConsolePerformanceTab::showEvent(QShowEvent *event)
+{
+    QLabel::showEvent(event);
+    updateText();
+    m_timer->start();
+}
+
+void DebugConsolePerformanceTab::hideEvent(QHideEvent *event)
+{
+    QLabel::hideEvent(event);
+    m_timer->stop();
+}
+
+static QString formatMilliseconds(std::chrono::nanoseconds duration)
+{
+    if (duration == std::chrono::nanoseconds::max()) {
+        // the last bucket of a histogram has no upper bound
+        return QStringLiteral("&infin;");
+    }
+    return QStringLiteral("%1 ms").arg(std::chrono::duration<double, std::milli>(duration).count(), 0, 'f', 2);
+}
+
+static QString formatHistogram(const LatencyHistogram &histogram)
+{
+    return i18n("%1 commits, p50 &le; %2, p90 &le; %3, p99 &le; %4",
+                histogram.count(),
+                formatMilliseconds(histogram.percentile(0.5)),
+                formatMilliseconds(histogram.percentile(0.9)),
+                formatMilliseconds(histogram.percentile(0.99)));
+}
+
+void DebugConsolePerformanceTab::updateText()
+{
+    // the journals keep more frames than an output presents in a second, so every frame
+    // of the last second is still there
+    const std::chrono::nanoseconds now = std::chrono::steady_clock::now().time_since_epoch();
+    const std::chrono::nanoseconds since = now - std::chrono::seconds(1);
+
+    QString text;
+    const auto outputs = kwinApp()->outputBackend()->outputs();
+    for (BackendOutput *output : outputs) {
+        const FrameTimingJournal *journal = output->renderLoop()->frameTimings();
+        if (!journal) {
+            // nothing has been presented on the output yet
+            continue;
+        }
+        const uint64_t lastSequence = journal->lastSequence();
+        const QByteArray data = journal->records(lastSequence > FrameTimingJournal::s_capacity ? lastSequence - FrameTimingJournal::s_capacity + 1 : 1, FrameTimingJournal::s_capacity);
+        const auto records = std::span(reinterpret_cast<const FrameTimingRecord *>(data.constData()), data.size() / sizeof(FrameTimingRecord));
+
+        int presented = 0;
+        int dropped = 0;
+        int missed = 0;
+        int directScanout = 0;
+        int tripleBuffering = 0;
+        std::chrono::nanoseconds totalRenderTime = std::chrono::nanoseconds::zero();
+        std::chrono::nanoseconds maxRenderTime = std::chrono::nanoseconds::zero();
+        std::chrono::nanoseconds totalGpuTime = std::chrono::nanoseconds::zero();
+        for (const FrameTimingRecord &record : records) {
+            const auto timestamp = std::chrono::nanoseconds(record.flags & FrameTimingRecord::Dropped ? record.targetPresentation : record.actualPresentation);
+            if (timestamp < since) {
+                continue;
+            }
+            if (record.flags & FrameTimingRecord::Dropped) {
+                dropped++;
+                continue;
+            }
+            presented++;
+            // a frame that got presented at least half a refresh cycle later than planned missed its deadline
+            if (record.targetPresentation && record.actualPresentation - record.targetPresentation > record.refreshDuration / 2) {
+                missed++;
+            }
+            if (record.flags & FrameTimingRecord::DirectScanout) {
+                directScanout++;
+            }
+            if (record.flags & FrameTimingRecord::TripleBuffering) {
+                tripleBuffering++;
+            }
+            const auto renderTime = std::chrono::nanoseconds(record.renderEnd - record.renderStart);
+            totalRenderTime += renderTime;
+            maxRenderTime = std::max(maxRenderTime, renderTime);
+            totalGpuTime += std::chrono::nanoseconds(record.gpuTime);
+        }
+
+        text.append(s_tableStart);
+        text.append(tableHeaderRow(output->name().toHtmlEscaped()));
+        text.append(tableRow(i18n("Presented frames"), presented));
+        text.append(tableRow(i18n("Dropped frames"), dropped));
+        text.append(tableRow(i18n("Missed deadlines"), missed));
+        text.append(tableRow(i18n("Direct scanout"), directScanout));
+        text.append(tableRow(i18n("Triple buffering"), tripleBuffering));
+        if (presented) {
+            text.append(tableRow(i18n("Average render time"), formatMilliseconds(totalRenderTime / presented)));
+            text.append(tableRow(i18n("Maximum render time"), formatMilliseconds(maxRenderTime)));
+            text.append(tableRow(i18n("Average GPU time"), formatMilliseconds(totalGpuTime / presented)));
+        }
+        text.append(s_tableEnd);
+
+        RenderBackend *backend = Compositor::self()->backend();
+        const QList<OutputLayer *> layers = backend ? backend->compatibleOutputLayers(output) : QList<OutputLayer *>();
+        for (qsizetype i = 0; i < layers.size(); i++) {
+            const OutputLayerStatistics &statistics = layers[i]->statistics();
+            text.append(s_tableStart);
+            text.append(tableHeaderRow(i18n("%1, layer %2 (%3)", output->name().toHtmlEscaped(), i, QLatin1StringView(outputLayerTypeName(layers[i]->type())))));
+            text.append(tableRow(i18n("Direct scanout frames"), statistics.directScanout));
+            text.append(tableRow(i18n("Composited frames"), statistics.composited));
+            text.append(tableRow(i18n("Skipped frames"), statistics.skipped));
+            text.append(tableRow(i18n("Failed tests"), statistics.testFailures));
+            for (size_t failure = 0; failure < OutputLayerStatistics::s_scanoutFailureCount; failure++) {
+                if (statistics.scanoutFailures[failure]) {
+                    const char *name = OutputLayerStatistics::scanoutFailureName(OutputLayerStatistics::ScanoutFailure(failure));
+                    text.append(tableRow(i18n("No direct scanout: %1", QLatin1StringView(name)), statistics.scanoutFailures[failure]));
+                }
+            }
+            text.append(s_tableEnd);
+        }
+    }
+
+    QList<ClientConnection *> clients;
+    const auto windows = workspace()->windows();
+    for (const Window *window : windows) {
+        if (window->surface() && !clients.contains(window->surface()->client())) {
+            clients.push_back(window->surface()->client());
+        }
+    }
+    for (const ClientConnection *client : std::as_const(clients)) {
+        const CommitLatencyStatistics &statistics = client->commitLatency();
+        text.append(s_tableStart);
+        text.append(tableHeaderRow(QStringLiteral("%1 (%2)").arg(client->executablePath().toHtmlEscaped()).arg(client->processId())));
+        text.append(tableRow(i18n("Commit to presentation"), formatHistogram(statistics.histogram(CommitLatencyStatistics::Stage::Total))));
+        text.append(tableRow(i18n("Waiting for fences"), formatHistogram(statistics.histogram(CommitLatencyStatistics::Stage::Fences))));
+        text.append(tableRow(i18n("Input to presentation"), formatHistogram(statistics.inputLatency())));
+        text.append(tableRow(i18n("Discarded commits"), statistics.discardedCount()));
+        text.append(s_tableEnd);
+    }
+
+    const QList<RealTimeThreadInfo> threads = realTimeThreads();
+    for (const RealTimeThreadInfo &thread : threads) {
+        text.append(s_tableStart);
+        text.append(tableHeaderRow(QStringLiteral("%1 (%2, %3)").arg(thread.name.toHtmlEscaped(), QLatin1StringView(realTimeRoleName(thread.role))).arg(thread.threadId)));
+        text.append(tableRow(i18n("Scheduling policy"), thread.policy));
+        if (thread.policy == QLatin1String("deadline")) {
+            text.append(tableRow(i18n("Runtime budget"), i18n("%1 every %2", formatMilliseconds(thread.runtime), formatMilliseconds(thread.period))));
+        } else {
+            text.append(tableRow(i18n("Priority"), thread.priority));
+        }
+        if (thread.utilizationMin || thread.utilizationMax) {
+            text.append(tableRow(i18n("Utilization clamp"), QStringLiteral("%1 - %2").arg(thread.utilizationMin.value_or(0)).arg(thread.utilizationMax.value_or(1024))));
+        }
+        if (!thread.cpus.isEmpty()) {
+            QStringList cpus;
+            for (int cpu : thread.cpus) {
+                cpus.append(QString::number(cpu));
+            }
+            text.append(tableRow(i18n("CPUs"), cpus.join(QLatin1String(", "))));
+        }
+        for (const QString &error : thread.errors) {
+            text.append(tableRow(i18n("Error"), error.toHtmlEscaped()));
+        }
+        text.append(s_tableEnd);
+    }
+
+    setText(text);
+}
+
 } // namespace KWin
 
 #include "moc_debug_console.cpp"
@@ -15,6 +15,7 @@
 #include <kwin_export.h>
 
 #include <QAbstractItemModel>
+#include <QLabel>
 #include <QList>
 #include <QListWidget>
 #include <QStyledItemDelegate>
@@ -22,9 +23,9 @@
 #include <functional>
 #include <memory>
 
-class QLabel;
 class QPushButton;
 class QTextEdit;
+class QTimer;
 
 namespace Ui
 {
@@ -234,4 +235,49 @@ public:
     explicit DebugConsoleEffectsTab(QWidget *parent = nullptr);
 };
 
+/**
+ * Shows how much GPU time the sections of the last frames took. The frames
+ * are only profiled while the tab is visible
+ */
+class DebugConsoleGpuTimeTab : public QLabel
+{
+    Q_OBJECT
+
+public:
+    explicit DebugConsoleGpuTimeTab(QWidget *parent = nullptr);
+    ~DebugConsoleGpuTimeTab() override;
+
+protected:
+    void showEvent(QShowEvent *event) override;
+    void hideEvent(QHideEvent *event) override;
+
+private:
+    void updateText();
+
+    QTimer *m_timer;
+    bool m_profiling = false;
+};
+
+/**
+ * Shows the frame timings of the outputs over the last second, how the frames of their
+ * layers have been produced and the commit latencies of the clients. The counters are collected all the time, the tab only reads them while it's
+ * visible
+ */
+class DebugConsolePerformanceTab : public QLabel
+{
+    Q_OBJECT
+
+public:
+    explicit DebugConsolePerformanceTab(QWidget *parent = nullptr);
+
+protected:
+    void showEvent(QShowEvent *event) override;
+    void hideEvent(QHideEvent *event) override;
+
+private:
+    void updateText();
+
+    QTimer *m_timer;
+};
+
 } // namespace KWin
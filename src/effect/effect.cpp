@@ -359,6 +359,26 @@ void Effect::reconfigure(ReconfigureFlags)
 {
 }
 
+void Effect::setPaintsAllWindows(bool paintsAll)
+{
+    m_paintsAllWindows = paintsAll;
+}
+
+void Effect::setPaintsWindow(EffectWindow *w, bool paints)
+{
+    if (!paints) {
+        m_paintedWindows.remove(w);
+        return;
+    }
+    connect(effects, &EffectsHandler::windowDeleted, this, &Effect::forgetPaintedWindow, Qt::UniqueConnection);
+    m_paintedWindows.insert(w);
+}
+
+void Effect::forgetPaintedWindow(EffectWindow *w)
+{
+    m_paintedWindows.remove(w);
+}
+
 void Effect::grabbedKeyboardEvent(QKeyEvent *)
 {
 }
@@ -15,6 +15,8 @@
 #include <KPluginFactory>
 #include <KSharedConfig>
 
+#include <QSet>
+
 class QKeyEvent;
 
 namespace KWin
@@ -810,6 +812,20 @@ public:
      */
     virtual bool isActive() const;
 
+    /*!
+     * Returns whether prePaintWindow(), paintWindow() and drawWindow() of this effect have to
+     * be called for the window \a w.
+     *
+     * By default, that is the case for every window. Effects that only affect a few windows can
+     * call setPaintsAllWindows(false) and register the windows they paint with setPaintsWindow(),
+     * the effect chain skips them for all other windows. If no active effect paints a window,
+     * it is painted without going through the effect chain at all.
+     */
+    bool paintsWindow(const EffectWindow *w) const
+    {
+        return m_paintsAllWindows || m_paintedWindows.contains(w);
+    }
+
     /*!
      * Reimplement this method to provide online debugging.
      *
@@ -1076,6 +1092,28 @@ public Q_SLOTS:
      * This function gets called when a reserved screen edge for \a border gets called.
      */
     virtual bool borderActivated(ElectricBorder border);
+
+protected:
+    /*!
+     * Sets whether the window painting methods of this effect are called for all windows, or only
+     * for the ones registered with setPaintsWindow().
+     *
+     * \sa paintsWindow()
+     */
+    void setPaintsAllWindows(bool paintsAll);
+    /*!
+     * Sets whether the window painting methods of this effect are called for the window \a w
+     * if the effect doesn't paint all windows. Deleted windows are unregistered automatically.
+     *
+     * \sa setPaintsAllWindows()
+     */
+    void setPaintsWindow(EffectWindow *w, bool paints);
+
+private:
+    void forgetPaintedWindow(EffectWindow *w);
+
+    QSet<const EffectWindow *> m_paintedWindows;
+    bool m_paintsAllWindows = true;
 };
 
 template<typename T>
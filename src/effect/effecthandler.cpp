@@ -69,6 +69,8 @@
 #include <QWindow>
 #include <QtMath>
 
+#include <algorithm>
+
 namespace KWin
 {
 
@@ -368,22 +370,34 @@ void EffectsHandler::postPaintScreen()
     // no special final code
 }
 
+EffectsHandler::EffectsIterator EffectsHandler::nextEffectPainting(EffectsIterator it, const EffectWindow *w) const
+{
+    return std::find_if(it, m_activeEffects.constEnd(), [w](const Effect *effect) {
+        return effect->paintsWindow(w);
+    });
+}
+
 void EffectsHandler::prePaintWindow(RenderView *view, EffectWindow *w, WindowPrePaintData &data)
 {
+    const EffectsIterator current = m_currentPaintWindowIterator;
+    m_currentPaintWindowIterator = nextEffectPainting(current, w);
     if (m_currentPaintWindowIterator != m_activeEffects.constEnd()) {
         (*m_currentPaintWindowIterator++)->prePaintWindow(view, w, data);
-        --m_currentPaintWindowIterator;
     }
+    m_currentPaintWindowIterator = current;
     // no special final code
 }
 
 bool EffectsHandler::paintWindow(const RenderTarget &renderTarget, const RenderViewport &viewport, EffectWindow *w, int mask, const Region &deviceRegion, WindowPaintData &data)
 {
+    const EffectsIterator current = m_currentPaintWindowIterator;
+    m_currentPaintWindowIterator = nextEffectPainting(current, w);
     if (m_currentPaintWindowIterator != m_activeEffects.constEnd()) {
         const bool ret = (*m_currentPaintWindowIterator++)->paintWindow(renderTarget, viewport, w, mask, deviceRegion, data);
-        --m_currentPaintWindowIterator;
+        m_currentPaintWindowIterator = current;
         return ret;
     } else {
+        m_currentPaintWindowIterator = current;
         return m_scene->finalPaintWindow(renderTarget, viewport, w, mask, deviceRegion, data);
     }
 }
@@ -400,11 +414,14 @@ Effect *EffectsHandler::provides(Effect::Feature ef)
 
 bool EffectsHandler::drawWindow(const RenderTarget &renderTarget, const RenderViewport &viewport, EffectWindow *w, int mask, const Region &deviceRegion, WindowPaintData &data)
 {
+    const EffectsIterator current = m_currentDrawWindowIterator;
+    m_currentDrawWindowIterator = nextEffectPainting(current, w);
     if (m_currentDrawWindowIterator != m_activeEffects.constEnd()) {
         const bool ret = (*m_currentDrawWindowIterator++)->drawWindow(renderTarget, viewport, w, mask, deviceRegion, data);
-        --m_currentDrawWindowIterator;
+        m_currentDrawWindowIterator = current;
         return ret;
     } else {
+        m_currentDrawWindowIterator = current;
         return m_scene->finalDrawWindow(renderTarget, viewport, w, mask, deviceRegion, data);
     }
 }
@@ -465,6 +482,11 @@ bool EffectsHandler::hasActiveFullScreenEffect() const
     return fullscreen_effect;
 }
 
+bool EffectsHandler::hasActiveEffects() const
+{
+    return !m_activeEffects.isEmpty();
+}
+
 bool EffectsHandler::isColorPickerActive() const
 {
     return isEffectActive(QStringLiteral("colorpicker"));
@@ -1177,6 +1199,8 @@ bool EffectsHandler::loadEffect(const QString &name)
 
 void EffectsHandler::unloadEffect(const QString &name)
 {
+    m_effectLoader->cancelDeferredLoad(name);
+
     auto it = std::find_if(effect_order.begin(), effect_order.end(), [name](EffectPair &pair) {
         return pair.first == name;
     });
@@ -1206,6 +1230,7 @@ void EffectsHandler::destroyEffect(Effect *effect)
     }
 
     stopMouseInterception(effect);
+    unsetColorFilter(effect);
 
 #if KWIN_BUILD_X11
     const QList<QByteArray> properties = m_propertiesForEffects.keys();
@@ -1330,6 +1355,33 @@ bool EffectsHandler::blocksDirectScanout() const
     });
 }
 
+void EffectsHandler::setColorFilter(Effect *effect, const QMatrix4x4 &filter)
+{
+    m_colorFilters[effect] = filter;
+    updateColorFilter();
+}
+
+void EffectsHandler::unsetColorFilter(Effect *effect)
+{
+    if (m_colorFilters.remove(effect)) {
+        updateColorFilter();
+    }
+}
+
+void EffectsHandler::updateColorFilter()
+{
+    QList<Effect *> filterEffects = m_colorFilters.keys();
+    std::ranges::sort(filterEffects, {}, &Effect::requestedEffectChainPosition);
+
+    QMatrix4x4 combined;
+    for (Effect *effect : std::as_const(filterEffects)) {
+        // effects later in the chain are applied on top of the earlier ones
+        combined = m_colorFilters[effect] * combined;
+    }
+    m_scene->renderer()->setColorFilter(combined);
+    m_scene->addRepaintFull();
+}
+
 Display *EffectsHandler::waylandDisplay() const
 {
     return waylandServer()->display();
@@ -25,6 +25,7 @@
 #include <QHash>
 #include <QList>
 #include <QLoggingCategory>
+#include <QMatrix4x4>
 #include <QStack>
 
 #include <KConfigWatcher>
@@ -38,7 +39,6 @@
 class KConfigGroup;
 class QFont;
 class QKeyEvent;
-class QMatrix4x4;
 class QMouseEvent;
 class QWheelEvent;
 class QAction;
@@ -694,6 +694,11 @@ public:
      */
     bool hasActiveFullScreenEffect() const;
 
+    /**
+     * Returns true if at least one effect takes part in the current painting pass.
+     */
+    bool hasActiveEffects() const;
+
     /**
      * Returns true if color picker effect is currently picking colors.
      */
@@ -723,6 +728,22 @@ public:
      */
     bool blocksDirectScanout() const;
 
+    /**
+     * Sets a color matrix that gets applied to everything the scene paints, in linear light.
+     * The filters of all effects are combined in the order of the effect chain and folded into
+     * the color space conversion that the scene does anyway, so they cost no extra pass.
+     *
+     * The effect should stay active while it sets a filter, so that direct scanout, which would
+     * skip the filter, is blocked. This is only supported with OpenGL compositing.
+     *
+     * @see unsetColorFilter
+     */
+    void setColorFilter(Effect *effect, const QMatrix4x4 &filter);
+    /**
+     * Removes the color filter set by @p effect
+     */
+    void unsetColorFilter(Effect *effect);
+
     WorkspaceScene *scene() const
     {
         return m_scene;
@@ -1075,12 +1096,18 @@ protected:
 
     void registerPropertyType(long atom, bool reg);
     void destroyEffect(Effect *effect);
+    void updateColorFilter();
     void reconfigureEffects();
     void configChanged(const KConfigGroup &group, const QByteArrayList &names);
 
     typedef QList<Effect *> EffectsList;
     typedef EffectsList::const_iterator EffectsIterator;
 
+    /**
+     * Returns the first active effect starting at @a it that paints the window @a w.
+     */
+    EffectsIterator nextEffectPainting(EffectsIterator it, const EffectWindow *w) const;
+
     struct
     {
         QPointF position;
@@ -1108,6 +1135,7 @@ protected:
     Compositor *m_compositor;
     WorkspaceScene *m_scene;
     QList<Effect *> m_grabbedMouseEffects;
+    QHash<Effect *, QMatrix4x4> m_colorFilters;
     EffectLoader *m_effectLoader;
     std::unique_ptr<WindowPropertyNotifyX11Filter> m_x11WindowPropertyNotify;
     KConfigWatcher::Ptr m_configWatcher;
@@ -20,12 +20,16 @@
 #include "utils/common.h"
 // KDE
 #include <KConfigGroup>
+#include <KGlobalAccel>
 #include <KPackage/Package>
 #include <KPackage/PackageLoader>
 // Qt
+#include <QAction>
 #include <QDebug>
+#include <QJsonArray>
 #include <QFutureWatcher>
 #include <QPluginLoader>
+#include <QPointer>
 #include <QQmlComponent>
 #include <QQmlEngine>
 #include <QStaticPlugin>
@@ -49,6 +53,10 @@ void AbstractEffectLoader::setConfig(KSharedConfig::Ptr config)
     m_config = config;
 }
 
+void AbstractEffectLoader::cancelDeferredLoad(const QString &name)
+{
+}
+
 LoadEffectFlags AbstractEffectLoader::readConfig(const QString &effectName, bool defaultValue) const
 {
     Q_ASSERT(m_config);
@@ -350,6 +358,7 @@ bool PluginEffectLoader::loadEffect(const KPluginMetaData &info, LoadEffectFlags
         qCDebug(KWIN_CORE) << "Loading flags disable effect: " << name;
         return false;
     }
+    m_deferredEffects.erase(name);
     if (m_loadedEffects.contains(name)) {
         qCDebug(KWIN_CORE) << name << " already loaded";
         return false;
@@ -395,11 +404,84 @@ void PluginEffectLoader::queryAndLoadAll()
     for (const auto &effect : effects) {
         const LoadEffectFlags flags = readConfig(effect.pluginId(), effect.isEnabledByDefault());
         if (flags.testFlag(LoadEffectFlag::Load)) {
-            loadEffect(effect, flags);
+            if (!deferLoad(effect, flags)) {
+                loadEffect(effect, flags);
+            }
         }
     }
 }
 
+bool PluginEffectLoader::deferLoad(const KPluginMetaData &info, LoadEffectFlags flags)
+{
+    // effects that are only ever activated with global shortcuts can list them in their metadata,
+    // they are loaded when one of the shortcuts is triggered for the first time
+    const QJsonArray shortcuts = info.rawData().value(QLatin1String("org.kde.kwin.effect")).toObject().value(QLatin1String("loadOnShortcuts")).toArray();
+    if (shortcuts.isEmpty()) {
+        return false;
+    }
+    const QString name = info.pluginId();
+    if (m_loadedEffects.contains(name)) {
+        return false;
+    }
+    if (m_deferredEffects.contains(name)) {
+        return true;
+    }
+
+    std::vector<std::unique_ptr<QAction>> actions;
+    bool hasShortcut = false;
+    for (const QJsonValue &value : shortcuts) {
+        const QString shortcut = value.toString();
+        // the default shortcuts are only known to the effect, they have been registered if it has
+        // been loaded before. if none of them has a key assigned, load the effect normally
+        const QList<QKeySequence> keys = KGlobalAccel::self()->globalShortcut(QStringLiteral("kwin"), shortcut);
+        if (keys.isEmpty()) {
+            continue;
+        }
+        hasShortcut = true;
+
+        auto action = std::make_unique<QAction>();
+        action->setObjectName(shortcut);
+        action->setProperty("componentName", QStringLiteral("kwin"));
+        KGlobalAccel::self()->setShortcut(action.get(), keys, KGlobalAccel::NoAutoloading);
+        connect(action.get(), &QAction::triggered, this, [this, info, flags, shortcut]() {
+            loadDeferredEffect(info, flags, shortcut);
+        });
+        actions.push_back(std::move(action));
+    }
+    if (!hasShortcut) {
+        return false;
+    }
+
+    qCDebug(KWIN_CORE) << "Deferring loading effect until it's used: " << name;
+    m_deferredEffects[name] = std::move(actions);
+    return true;
+}
+
+void PluginEffectLoader::loadDeferredEffect(const KPluginMetaData &info, LoadEffectFlags flags, const QString &shortcut)
+{
+    // this is invoked by one of the placeholder actions, which are going to be destroyed
+    QMetaObject::invokeMethod(this, [this, info, flags, shortcut]() {
+        QPointer<Effect> effect;
+        const auto connection = connect(this, &AbstractEffectLoader::effectLoaded, this, [&effect](Effect *loaded) {
+            effect = loaded;
+        });
+        loadEffect(info, flags);
+        disconnect(connection);
+
+        // pass the shortcut on to the action the effect has registered for it
+        if (effect) {
+            if (QAction *action = effect->findChild<QAction *>(shortcut)) {
+                action->trigger();
+            }
+        }
+    }, Qt::QueuedConnection);
+}
+
+void PluginEffectLoader::cancelDeferredLoad(const QString &name)
+{
+    m_deferredEffects.erase(name);
+}
+
 QList<KPluginMetaData> PluginEffectLoader::findAllEffects() const
 {
     return KPluginMetaData::findPlugins(m_pluginSubDirectory);
@@ -412,6 +494,7 @@ void PluginEffectLoader::setPluginSubDirectory(const QString &directory)
 
 void PluginEffectLoader::clear()
 {
+    m_deferredEffects.clear();
 }
 
 EffectLoader::EffectLoader(QObject *parent)
@@ -483,6 +566,13 @@ void EffectLoader::clear()
     }
 }
 
+void EffectLoader::cancelDeferredLoad(const QString &name)
+{
+    for (auto it = m_loaders.constBegin(); it != m_loaders.constEnd(); ++it) {
+        (*it)->cancelDeferredLoad(name);
+    }
+}
+
 KPluginMetaData EffectLoader::findEffect(const QString &name) const
 {
     for (const auto loader : m_loaders) {
@@ -19,6 +19,12 @@
 #include <QQueue>
 #include <QStaticPlugin>
 
+#include <map>
+#include <memory>
+#include <vector>
+
+class QAction;
+
 namespace KWin
 {
 
@@ -158,6 +164,14 @@ public:
      */
     virtual void clear() = 0;
 
+    /**
+     * @brief Discards the Effect with the given @p name if its loading has been deferred until
+     * it's used for the first time.
+     *
+     * The default implementation does nothing.
+     */
+    virtual void cancelDeferredLoad(const QString &name);
+
     /**
      * @brief Finds the effect with a given @p name.
      *
@@ -323,6 +337,7 @@ public:
     QStringList listOfKnownEffects() const override;
 
     void clear() override;
+    void cancelDeferredLoad(const QString &name) override;
     void queryAndLoadAll() override;
     bool loadEffect(const QString &name) override;
     bool loadEffect(const KPluginMetaData &info, LoadEffectFlags flags);
@@ -333,8 +348,15 @@ public:
 private:
     QList<KPluginMetaData> findAllEffects() const;
     EffectPluginFactory *factory(const KPluginMetaData &info) const;
+    bool deferLoad(const KPluginMetaData &info, LoadEffectFlags flags);
+    void loadDeferredEffect(const KPluginMetaData &info, LoadEffectFlags flags, const QString &shortcut);
+
     QStringList m_loadedEffects;
     QString m_pluginSubDirectory;
+    /**
+     * Placeholder actions for the global shortcuts of the effects that get loaded on first use.
+     */
+    std::map<QString, std::vector<std::unique_ptr<QAction>>> m_deferredEffects;
 };
 
 class KWIN_EXPORT EffectLoader : public AbstractEffectLoader
@@ -351,6 +373,7 @@ public:
     void queryAndLoadAll() override;
     void setConfig(KSharedConfig::Ptr config) override;
     void clear() override;
+    void cancelDeferredLoad(const QString &name) override;
     KPluginMetaData findEffect(const QString &name) const override;
 
 private:
@@ -11,9 +11,12 @@
 #include "core/renderviewport.h"
 #include "effect/effecthandler.h"
 #include "opengl/eglcontext.h"
+#include "opengl/glgpuprofiler.h"
 #include "opengl/gltexture.h"
 #include "opengl/glutils.h"
+#include "scene/texturememorybudget.h"
 #include "scene/windowitem.h"
+#include "scene/workspacescene.h"
 
 namespace KWin
 {
@@ -33,6 +36,7 @@ public:
 
     std::unique_ptr<GLTexture> m_texture;
     std::unique_ptr<GLFramebuffer> m_fbo;
+    std::unique_ptr<TextureMemoryAllocation> m_memory;
     bool m_isDirty = true;
     GLShader *m_shader = nullptr;
     RenderGeometry::VertexSnappingMode m_vertexSnappingMode = RenderGeometry::VertexSnappingMode::Round;
@@ -112,23 +116,38 @@ bool OffscreenData::maybeRender(EffectWindow *window)
     const RectF logicalGeometry = snapToPixels(window->expandedGeometry(), scale);
     const QSize textureSize = (logicalGeometry.size() * scale).toSize();
 
+    if (!m_memory) {
+        // the texture can be evicted if the window hasn't been painted for a while, it's
+        // simply rendered again the next time
+        m_memory = effects->scene()->textureMemoryBudget()->track(QStringLiteral("OffscreenEffect"), [this]() {
+            m_fbo.reset();
+            m_texture.reset();
+            m_isDirty = true;
+        });
+    }
+    m_memory->markUsed();
+
     if (textureSize.isEmpty()) {
         m_fbo.reset();
         m_texture.reset();
+        m_memory->setSize(0);
         return true;
     }
     if (!m_texture || m_texture->size() != textureSize) {
         m_texture = GLTexture::allocate(GL_RGBA8, textureSize);
         if (!m_texture) {
+            m_memory->setSize(0);
             return true;
         }
         m_texture->setFilter(GL_LINEAR);
         m_texture->setWrapMode(GL_CLAMP_TO_EDGE);
         m_fbo = std::make_unique<GLFramebuffer>(m_texture.get());
         m_isDirty = true;
+        m_memory->setSize(m_texture->memoryUsage());
     }
 
     if (m_isDirty) {
+        GLGpuProfilerScope profilerScope(QStringLiteral("Offscreen redirect"));
         RenderTarget renderTarget(m_fbo.get());
         RenderViewport viewport(logicalGeometry, scale, renderTarget, QPoint());
         GLFramebuffer::pushFramebuffer(m_fbo.get());
@@ -40,6 +40,7 @@
 #include <QOffscreenSurface>
 #include <QOpenGLContext>
 #include <QOpenGLFramebufferObject>
+#include <QPointer>
 #include <QQuickGraphicsDevice>
 #include <QQuickOpenGLUtils>
 #include <QQuickRenderTarget>
@@ -49,6 +50,34 @@
 namespace KWin
 {
 
+/**
+ * The OffscreenQuickContext class holds the OpenGL context that all offscreen views render
+ * with. The views that repaint on their own are rendered in one batch, so that the compositor
+ * has to switch to the context and back only once, no matter how many views are updated.
+ */
+class Q_DECL_HIDDEN OffscreenQuickContext
+{
+public:
+    static std::shared_ptr<OffscreenQuickContext> instance();
+
+    OffscreenQuickContext();
+
+    QOpenGLContext *glContext();
+    bool makeCurrent();
+    void doneCurrent();
+
+    void scheduleUpdate(OffscreenQuickView *view);
+    void cancelUpdate(OffscreenQuickView *view);
+
+private:
+    void updateScheduledViews();
+
+    std::unique_ptr<QOpenGLContext> m_glcontext;
+    std::unique_ptr<QOffscreenSurface> m_offscreenSurface;
+    QTimer m_updateTimer;
+    QList<QPointer<OffscreenQuickView>> m_scheduledViews;
+};
+
 class Q_DECL_HIDDEN OffscreenQuickView::Private
 {
 public:
@@ -63,8 +92,8 @@ public:
 
     std::unique_ptr<QQuickWindow> m_view;
     std::unique_ptr<QQuickRenderControl> m_renderControl;
-    std::unique_ptr<QOffscreenSurface> m_offscreenSurface;
-    std::unique_ptr<QOpenGLContext> m_glcontext;
+    std::shared_ptr<OffscreenQuickContext> m_context;
+    bool m_usingGl = false;
     std::shared_ptr<EglSwapchain> m_swapchain;
     std::shared_ptr<EglSwapchainSlot> m_currentSlot;
     std::unique_ptr<ImageItem> m_imageItem;
@@ -75,7 +104,6 @@ public:
     FormatModifierMap m_scanoutFormats;
     bool m_surfaceNeedsReallocation = false;
 
-    std::unique_ptr<QTimer> m_repaintTimer;
     QImage m_image;
     std::unique_ptr<GLTexture> m_textureExport;
     // if we should capture a QImage after rendering into our BO.
@@ -97,6 +125,7 @@ public:
     ulong lastMousePressTime = 0;
     Qt::MouseButton lastMousePressButton = Qt::NoButton;
 
+    bool canRender() const;
     void releaseResources();
 
     void updateTouchState(Qt::TouchPointState state, qint32 id, const QPointF &pos);
@@ -149,9 +178,111 @@ private:
     OffscreenQuickView *const m_view;
 };
 
+std::shared_ptr<OffscreenQuickContext> OffscreenQuickContext::instance()
+{
+    static std::weak_ptr<OffscreenQuickContext> s_instance;
+    std::shared_ptr<OffscreenQuickContext> context = s_instance.lock();
+    if (!context) {
+        context = std::make_shared<OffscreenQuickContext>();
+        s_instance = context;
+    }
+    return context;
+}
+
+OffscreenQuickContext::OffscreenQuickContext()
+{
+    m_updateTimer.setSingleShot(true);
+    m_updateTimer.setInterval(10);
+    QObject::connect(&m_updateTimer, &QTimer::timeout, &m_updateTimer, [this]() {
+        updateScheduledViews();
+    });
+}
+
+QOpenGLContext *OffscreenQuickContext::glContext()
+{
+    if (!m_glcontext) {
+        // the views render into textures, the format only matters for the offscreen surface
+        QSurfaceFormat format;
+        format.setOption(QSurfaceFormat::ResetNotification);
+        format.setDepthBufferSize(16);
+        format.setStencilBufferSize(8);
+        format.setAlphaBufferSize(8);
+
+        m_glcontext = std::make_unique<QOpenGLContext>();
+        m_glcontext->setFormat(format);
+        m_glcontext->create();
+
+        m_offscreenSurface = std::make_unique<QOffscreenSurface>();
+        m_offscreenSurface->setFormat(m_glcontext->format());
+        m_offscreenSurface->create();
+    }
+    return m_glcontext.get();
+}
+
+bool OffscreenQuickContext::makeCurrent()
+{
+    return glContext()->makeCurrent(m_offscreenSurface.get());
+}
+
+void OffscreenQuickContext::doneCurrent()
+{
+    if (m_glcontext) {
+        m_glcontext->doneCurrent();
+    }
+}
+
+void OffscreenQuickContext::scheduleUpdate(OffscreenQuickView *view)
+{
+    if (!m_scheduledViews.contains(view)) {
+        m_scheduledViews.append(view);
+    }
+    // the timer isn't restarted, a view that keeps asking for updates must not hold back the others
+    if (!m_updateTimer.isActive()) {
+        m_updateTimer.start();
+    }
+}
+
+void OffscreenQuickContext::cancelUpdate(OffscreenQuickView *view)
+{
+    m_scheduledViews.removeAll(view);
+    if (m_scheduledViews.isEmpty()) {
+        m_updateTimer.stop();
+    }
+}
+
+void OffscreenQuickContext::updateScheduledViews()
+{
+    const QList<QPointer<OffscreenQuickView>> views = std::exchange(m_scheduledViews, {});
+
+    EglContext *previousContext = EglContext::currentContext();
+    bool current = false;
+    for (const QPointer<OffscreenQuickView> &view : views) {
+        if (!view || !view->d->canRender()) {
+            continue;
+        }
+        if (view->d->m_usingGl && !current) {
+            if (!makeCurrent()) {
+                // probably a context loss event, kwin is about to reset all the effects anyway
+                return;
+            }
+            current = true;
+        }
+        view->render(nullptr);
+    }
+
+    if (current) {
+        doneCurrent();
+        if (previousContext) {
+            previousContext->makeCurrent();
+        }
+    }
+}
+
 OffscreenQuickView::OffscreenQuickView(ExportMode exportMode, bool alpha)
     : d(new OffscreenQuickView::Private)
 {
+    d->m_context = OffscreenQuickContext::instance();
+
     d->m_renderControl = std::make_unique<QQuickRenderControl>();
 
     d->m_view = std::make_unique<QQuickWindow>(d->m_renderControl.get());
@@ -183,19 +314,12 @@ OffscreenQuickView::OffscreenQuickView(ExportMode exportMode, bool alpha)
 
         d->m_view->setFormat(format);
 
-        d->m_glcontext = std::make_unique<QOpenGLContext>();
-        d->m_glcontext->setFormat(format);
-        d->m_glcontext->create();
-
-        // and the offscreen surface
-        d->m_offscreenSurface = std::make_unique<QOffscreenSurface>();
-        d->m_offscreenSurface->setFormat(d->m_glcontext->format());
-        d->m_offscreenSurface->create();
-
-        d->m_glcontext->makeCurrent(d->m_offscreenSurface.get());
-        d->m_view->setGraphicsDevice(QQuickGraphicsDevice::fromOpenGLContext(d->m_glcontext.get()));
+        // all views share one context, so that switching between them is free
+        d->m_usingGl = true;
+        d->m_context->makeCurrent();
+        d->m_view->setGraphicsDevice(QQuickGraphicsDevice::fromOpenGLContext(d->m_context->glContext()));
         d->m_renderControl->initialize();
-        d->m_glcontext->doneCurrent();
+        d->m_context->doneCurrent();
         d->m_surfaceItem = std::make_unique<QuickViewItem>(this, effects->scene()->overlayItem());
         d->m_item = d->m_surfaceItem.get();
     }
@@ -210,13 +334,6 @@ OffscreenQuickView::OffscreenQuickView(ExportMode exportMode, bool alpha)
     connect(d->m_view.get(), &QWindow::widthChanged, this, updateSize);
     connect(d->m_view.get(), &QWindow::heightChanged, this, updateSize);
 
-    d->m_repaintTimer = std::make_unique<QTimer>();
-    d->m_repaintTimer->setSingleShot(true);
-    d->m_repaintTimer->setInterval(10);
-
-    connect(d->m_repaintTimer.get(), &QTimer::timeout, this, [this]() {
-        update(nullptr);
-    });
     connect(d->m_renderControl.get(), &QQuickRenderControl::renderRequested, this, &OffscreenQuickView::handleRenderRequested);
     connect(d->m_renderControl.get(), &QQuickRenderControl::sceneChanged, this, &OffscreenQuickView::handleSceneChanged);
 
@@ -229,10 +346,11 @@ OffscreenQuickView::~OffscreenQuickView()
 {
     disconnect(d->m_renderControl.get(), &QQuickRenderControl::renderRequested, this, &OffscreenQuickView::handleRenderRequested);
     disconnect(d->m_renderControl.get(), &QQuickRenderControl::sceneChanged, this, &OffscreenQuickView::handleSceneChanged);
+    d->m_context->cancelUpdate(this);
 
-    if (d->m_glcontext) {
+    if (d->m_usingGl) {
         // close the view whilst we have an active GL context
-        d->m_glcontext->makeCurrent(d->m_offscreenSurface.get());
+        d->m_context->makeCurrent();
     }
 
     d->m_view.reset();
@@ -251,7 +369,7 @@ void OffscreenQuickView::setAutomaticRepaint(bool set)
 
         // If there's an in-flight update, disable it.
         if (!d->m_automaticRepaint) {
-            d->m_repaintTimer->stop();
+            d->m_context->cancelUpdate(this);
         }
     }
 }
@@ -264,7 +382,7 @@ void OffscreenQuickView::setDevicePixelRatio(qreal dpr)
 void OffscreenQuickView::handleSceneChanged()
 {
     if (d->m_automaticRepaint) {
-        d->m_repaintTimer->start();
+        d->m_context->scheduleUpdate(this);
     } else {
         d->m_item->scheduleFrame();
     }
@@ -274,31 +392,51 @@ void OffscreenQuickView::handleSceneChanged()
 void OffscreenQuickView::handleRenderRequested()
 {
     if (d->m_automaticRepaint) {
-        d->m_repaintTimer->start();
+        d->m_context->scheduleUpdate(this);
     } else {
         d->m_item->scheduleFrame();
     }
     Q_EMIT renderRequested();
 }
 
+bool OffscreenQuickView::Private::canRender() const
+{
+    return m_visible && !m_view->size().isEmpty();
+}
+
 void OffscreenQuickView::update(OutputFrame *frame)
 {
-    if (!d->m_visible) {
+    if (!d->canRender()) {
         return;
     }
-    if (d->m_view->size().isEmpty()) {
+    // an update has been done, so a scheduled one isn't needed anymore
+    d->m_context->cancelUpdate(this);
+    if (!d->m_usingGl) {
+        render(frame);
         return;
     }
 
-    bool usingGl = d->m_glcontext != nullptr;
     EglContext *previousContext = EglContext::currentContext();
+    if (!d->m_context->makeCurrent()) {
+        // probably a context loss event, kwin is about to reset all the effects anyway
+        return;
+    }
+    render(frame);
+    d->m_context->doneCurrent();
+    if (previousContext) {
+        previousContext->makeCurrent();
+    }
+}
+
+/**
+ * Renders the view, the shared context must be current if OpenGL is used.
+ */
+void OffscreenQuickView::render(OutputFrame *frame)
+{
+    const bool usingGl = d->m_usingGl;
     std::unique_ptr<GLRenderTimeQuery> renderTime;
 
     if (usingGl) {
-        if (!d->m_glcontext->makeCurrent(d->m_offscreenSurface.get())) {
-            // probably a context loss event, kwin is about to reset all the effects anyway
-            return;
-        }
         if (frame) {
             renderTime = std::make_unique<GLRenderTimeQuery>();
         }
@@ -339,7 +477,6 @@ void OffscreenQuickView::update(OutputFrame *frame)
                 d->m_swapchain = EglSwapchain::create(Compositor::self()->backend()->renderDevice()->allocator(), EglContext::currentContext(), options);
             }
             if (!d->m_swapchain) {
-                d->m_glcontext->doneCurrent();
                 qCWarning(LIBKWINEFFECTS, "Creating a swapchain for OffscreenQuickView failed!");
                 return;
             }
@@ -347,7 +484,6 @@ void OffscreenQuickView::update(OutputFrame *frame)
         }
         d->m_currentSlot = d->m_swapchain->acquire();
         if (!d->m_currentSlot) {
-            d->m_glcontext->doneCurrent();
             qCWarning(LIBKWINEFFECTS, "Acquire for OffscreenQuickView failed!");
             return;
         }
@@ -393,12 +529,7 @@ void OffscreenQuickView::update(OutputFrame *frame)
             renderTime->end();
             frame->addRenderTimeQuery(std::move(renderTime));
         }
-        d->m_glcontext->doneCurrent();
-        if (previousContext) {
-            previousContext->makeCurrent();
-        }
     }
-    d->m_item->scheduleRepaint(d->m_item->rect());
 }
 
 void OffscreenQuickView::forwardKeyEvent(QKeyEvent *keyEvent)
@@ -621,10 +752,10 @@ void OffscreenQuickView::setGeometry(const Rect &rect)
 
 void OffscreenQuickView::Private::releaseResources()
 {
-    if (m_glcontext) {
-        m_glcontext->makeCurrent(m_offscreenSurface.get());
+    if (m_usingGl) {
+        m_context->makeCurrent();
         m_view->releaseResources();
-        m_glcontext->doneCurrent();
+        m_context->doneCurrent();
     } else {
         m_view->releaseResources();
     }
@@ -147,10 +147,12 @@ Q_SIGNALS:
 private:
     void handleRenderRequested();
     void handleSceneChanged();
+    void render(OutputFrame *frame);
 
     class Private;
     std::unique_ptr<Private> d;
     friend class QuickViewItem;
+    friend class OffscreenQuickContext;
 };
 
 /**
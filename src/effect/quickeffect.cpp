@@ -17,6 +17,7 @@
 #include <QQmlIncubator>
 #include <QQuickItem>
 #include <QQuickWindow>
+#include <QTimer>
 #include <qpa/qwindowsysteminterface.h>
 
 namespace KWin
@@ -24,6 +25,43 @@ namespace KWin
 
 static QHash<QQuickWindow *, QuickSceneView *> s_views;
 
+// how long the delegates of the views may be incubated before control is returned to the
+// event loop, leaving most of a frame for compositing
+static constexpr int s_incubationBudget = 4;
+
+/*!
+ * \internal
+ *
+ * Incubates QML objects created asynchronously in small slices, so creating the views of an
+ * effect with hundreds of window delegates doesn't block compositing until all of them are
+ * done.
+ */
+class QuickSceneIncubationController : public QObject, public QQmlIncubationController
+{
+public:
+    explicit QuickSceneIncubationController(QQmlEngine *engine)
+        : QObject(engine)
+    {
+        m_timer.setInterval(0);
+        connect(&m_timer, &QTimer::timeout, this, [this]() {
+            incubateFor(s_incubationBudget);
+        });
+    }
+
+protected:
+    void incubatingObjectCountChanged(int count) override
+    {
+        if (count > 0) {
+            m_timer.start();
+        } else {
+            m_timer.stop();
+        }
+    }
+
+private:
+    QTimer m_timer;
+};
+
 class QuickSceneViewIncubator : public QQmlIncubator
 {
 public:
@@ -80,6 +118,8 @@ public:
     std::map<LogicalOutput *, std::unique_ptr<QuickSceneView>> views;
     QPointer<QuickSceneView> mouseImplicitGrab;
     bool running = false;
+    bool startPending = false;
+    bool preloadScheduled = false;
     bool viewCachingEnabled = false;
 };
 
@@ -199,6 +239,10 @@ QuickSceneEffect::QuickSceneEffect(QObject *parent)
     : Effect(parent)
     , d(new QuickSceneEffectPrivate)
 {
+    QQmlEngine *engine = effects->qmlEngine();
+    if (!engine->incubationController()) {
+        engine->setIncubationController(new QuickSceneIncubationController(engine));
+    }
 }
 
 QuickSceneEffect::~QuickSceneEffect()
@@ -252,6 +296,9 @@ bool QuickSceneEffect::isRunning() const
 
 void QuickSceneEffect::setRunning(bool running)
 {
+    if (!running) {
+        d->startPending = false;
+    }
     if (d->running != running) {
         if (running) {
             startInternal();
@@ -286,6 +333,7 @@ void QuickSceneEffect::setSource(const QUrl &url)
         d->delegate.clear();
         d->loadInfo = {};
         clearCachedViews();
+        preloadDelegate();
     }
 }
 
@@ -306,6 +354,65 @@ void QuickSceneEffect::loadFromModule(const QString &uri, const QString &typeNam
         d->loadInfo.uri = uri;
         d->loadInfo.typeName = typeName;
         clearCachedViews();
+        preloadDelegate();
+    }
+}
+
+bool QuickSceneEffect::loadDelegate(QQmlComponent::CompilationMode mode)
+{
+    d->delegate = new QQmlComponent(effects->qmlEngine(), this);
+    if (mode == QQmlComponent::Asynchronous) {
+        connect(d->delegate, &QQmlComponent::statusChanged, this, &QuickSceneEffect::handleDelegateStatusChanged);
+    }
+
+    if (!d->source.isEmpty()) {
+        d->delegate->loadUrl(d->source, mode);
+        if (d->delegate->isError()) {
+            qWarning().nospace() << "Failed to load " << d->source << ": " << d->delegate->errors();
+            d->delegate.clear();
+            return false;
+        }
+    } else {
+        d->delegate->loadFromModule(d->loadInfo.uri, d->loadInfo.typeName, mode);
+        if (d->delegate->isError()) {
+            qWarning().nospace() << "Failed to load " << (d->loadInfo.uri + u'.' + d->loadInfo.typeName) << d->delegate->errors();
+            d->delegate.clear();
+            return false;
+        }
+    }
+
+    Q_EMIT delegateChanged();
+    return true;
+}
+
+void QuickSceneEffect::preloadDelegate()
+{
+    if (d->preloadScheduled) {
+        return;
+    }
+    d->preloadScheduled = true;
+
+    // compile the component ahead of time so the first activation doesn't have to wait for it
+    QTimer::singleShot(0, this, [this]() {
+        d->preloadScheduled = false;
+        if (!d->delegate && (!d->source.isEmpty() || !d->loadInfo.uri.isEmpty())) {
+            loadDelegate(QQmlComponent::Asynchronous);
+        }
+    });
+}
+
+void QuickSceneEffect::handleDelegateStatusChanged()
+{
+    QQmlComponent *delegate = qobject_cast<QQmlComponent *>(sender());
+    if (!delegate || delegate != d->delegate) {
+        return;
+    }
+    if (delegate->isError()) {
+        qWarning() << "Failed to load" << delegate->url() << delegate->errors();
+        d->startPending = false;
+    } else if (delegate->isReady() && d->startPending) {
+        d->startPending = false;
+        startInternal();
     }
 }
 
@@ -532,25 +639,16 @@ void QuickSceneEffect::startInternal()
             return;
         }
 
-        d->delegate = new QQmlComponent(effects->qmlEngine(), this);
-
-        if (!d->source.isEmpty()) {
-            d->delegate->loadUrl(d->source);
-            if (d->delegate->isError()) {
-                qWarning().nospace() << "Failed to load " << d->source << ": " << d->delegate->errors();
-                d->delegate.clear();
-                return;
-            }
-        } else {
-            d->delegate->loadFromModule(d->loadInfo.uri, d->loadInfo.typeName);
-            if (d->delegate->isError()) {
-                qWarning().nospace() << "Failed to load " << (d->loadInfo.uri + u'.' + d->loadInfo.typeName) << d->delegate->errors();
-                d->delegate.clear();
-                return;
-            }
+        if (!loadDelegate(QQmlComponent::PreferSynchronous)) {
+            return;
         }
+    }
 
-        Q_EMIT delegateChanged();
+    if (d->delegate->isLoading()) {
+        // the delegate is still being compiled in the background, start once it's done
+        d->startPending = true;
+        connect(d->delegate, &QQmlComponent::statusChanged, this, &QuickSceneEffect::handleDelegateStatusChanged, Qt::UniqueConnection);
+        return;
     }
 
     if (!d->delegate->isReady()) {
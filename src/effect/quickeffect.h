@@ -282,8 +282,9 @@ public:
     /*!
      * Sets the source url to \a url.
      *
-     * Note that the QML component will be loaded the next
-     * time the effect is started.
+     * Note that the QML component will be compiled in the background once
+     * the event loop becomes idle, or the next time the effect is started,
+     * whichever comes first.
      *
      * While the effect is running, the source url cannot be changed.
      *
@@ -295,8 +296,9 @@ public:
     /*!
      * Use the QML component identified by \a uri and \a typename.
      *
-     * Note that the QML component will
-     * be loaded the next time the effect is started.
+     * Note that the QML component will be compiled in the background once
+     * the event loop becomes idle, or the next time the effect is started,
+     * whichever comes first.
      *
      * Cannot be called while the effect is running.
      *
@@ -357,6 +359,9 @@ private:
     void startInternal();
     void stopInternal();
     void clearCachedViews();
+    bool loadDelegate(QQmlComponent::CompilationMode mode);
+    void preloadDelegate();
+    void handleDelegateStatusChanged();
 
     std::unique_ptr<QuickSceneEffectPrivate> d;
     friend class QuickSceneEffectPrivate;
@@ -16,22 +16,20 @@ namespace KWin
 
 void FocusChain::remove(Window *window)
 {
-    for (auto it = m_desktopFocusChains.begin();
-         it != m_desktopFocusChains.end();
-         ++it) {
-        it.value().removeAll(window);
+    for (auto &[desktop, chain] : m_desktopFocusChains) {
+        chain.remove(window);
     }
-    m_mostRecentlyUsed.removeAll(window);
+    m_mostRecentlyUsed.remove(window);
 }
 
 void FocusChain::addDesktop(VirtualDesktop *desktop)
 {
-    m_desktopFocusChains.insert(desktop, Chain());
+    m_desktopFocusChains.try_emplace(desktop);
 }
 
 void FocusChain::removeDesktop(VirtualDesktop *desktop)
 {
-    m_desktopFocusChains.remove(desktop);
+    m_desktopFocusChains.erase(desktop);
 }
 
 Window *FocusChain::getForActivation(VirtualDesktop *desktop) const
@@ -41,13 +39,13 @@ Window *FocusChain::getForActivation(VirtualDesktop *desktop) const
 
 Window *FocusChain::getForActivation(VirtualDesktop *desktop, LogicalOutput *output) const
 {
-    auto it = m_desktopFocusChains.constFind(desktop);
-    if (it == m_desktopFocusChains.constEnd()) {
+    auto it = m_desktopFocusChains.find(desktop);
+    if (it == m_desktopFocusChains.end()) {
         return nullptr;
     }
-    const auto &chain = it.value();
-    for (int i = chain.size() - 1; i >= 0; --i) {
-        auto tmp = chain.at(i);
+    const Chain &chain = it->second;
+    for (auto chainIt = chain.rbegin(); chainIt != chain.rend(); ++chainIt) {
+        Window *tmp = *chainIt;
         // TODO: move the check into Window
         if (tmp->isShown() && tmp->isOnCurrentActivity()
             && (!m_separateScreenFocus || tmp->output() == output)) {
@@ -68,12 +66,9 @@ void FocusChain::update(Window *window, FocusChain::Change change)
     if (window->isOnAllDesktops()) {
         const VirtualDesktop *currentDesktop = VirtualDesktopManager::self()->currentDesktop(window->output());
         // Now on all desktops, add it to focus chains it is not already in
-        for (auto it = m_desktopFocusChains.begin();
-             it != m_desktopFocusChains.end();
-             ++it) {
-            auto &chain = it.value();
+        for (auto &[desktop, chain] : m_desktopFocusChains) {
             // Making first/last works only on current desktop, don't affect all desktops
-            if (it.key() == currentDesktop
+            if (desktop == currentDesktop
                 && (change == MakeFirst || change == MakeLast)) {
                 if (change == MakeFirst) {
                     makeFirstInChain(window, chain);
@@ -86,14 +81,11 @@ void FocusChain::update(Window *window, FocusChain::Change change)
         }
     } else {
         // Now only on desktop, remove it anywhere else
-        for (auto it = m_desktopFocusChains.begin();
-             it != m_desktopFocusChains.end();
-             ++it) {
-            auto &chain = it.value();
-            if (window->isOnDesktop(it.key())) {
+        for (auto &[desktop, chain] : m_desktopFocusChains) {
+            if (window->isOnDesktop(desktop)) {
                 updateWindowInChain(window, change, chain);
             } else {
-                chain.removeAll(window);
+                chain.remove(window);
             }
         }
     }
@@ -121,9 +113,9 @@ void FocusChain::insertWindowIntoChain(Window *window, Chain &chain)
     if (chain.contains(window)) {
         return;
     }
-    if (m_activeWindow && m_activeWindow != window && !chain.empty() && chain.last() == m_activeWindow) {
+    if (m_activeWindow && m_activeWindow != window && !chain.isEmpty() && chain.last() == m_activeWindow) {
         // Add it after the active window
-        chain.insert(chain.size() - 1, window);
+        chain.insertBefore(m_activeWindow, window);
     } else {
         // Otherwise add as the first one
         chain.append(window);
@@ -142,13 +134,11 @@ void FocusChain::moveAfterWindow(Window *window, Window *reference)
         return;
     }
 
-    for (auto it = m_desktopFocusChains.begin();
-         it != m_desktopFocusChains.end();
-         ++it) {
-        if (!window->isOnDesktop(it.key())) {
+    for (auto &[desktop, chain] : m_desktopFocusChains) {
+        if (!window->isOnDesktop(desktop)) {
             continue;
         }
-        moveAfterWindowInChain(window, reference, it.value());
+        moveAfterWindowInChain(window, reference, chain);
     }
     moveAfterWindowInChain(window, reference, m_mostRecentlyUsed);
 }
@@ -165,13 +155,11 @@ void FocusChain::moveBeforeWindow(Window *window, Window *reference)
         return;
     }
 
-    for (auto it = m_desktopFocusChains.begin();
-         it != m_desktopFocusChains.end();
-         ++it) {
-        if (!window->isOnDesktop(it.key())) {
+    for (auto &[desktop, chain] : m_desktopFocusChains) {
+        if (!window->isOnDesktop(desktop)) {
             continue;
         }
-        moveBeforeWindowInChain(window, reference, it.value());
+        moveBeforeWindowInChain(window, reference, chain);
     }
     moveBeforeWindowInChain(window, reference, m_mostRecentlyUsed);
 }
@@ -184,14 +172,13 @@ void FocusChain::moveAfterWindowInChain(Window *window, Window *reference, Chain
     if (!chain.contains(reference)) {
         return;
     }
+    chain.remove(window);
     if (Window::belongToSameApplication(reference, window)) {
-        chain.removeAll(window);
-        chain.insert(chain.indexOf(reference), window);
+        chain.insertBefore(reference, window);
     } else {
-        chain.removeAll(window);
-        for (int i = 0; i < chain.size(); ++i) {
-            if (Window::belongToSameApplication(reference, chain.at(i))) {
-                chain.insert(i, window);
+        for (Window *other : chain) {
+            if (Window::belongToSameApplication(reference, other)) {
+                chain.insertBefore(other, window);
                 break;
             }
         }
@@ -206,14 +193,13 @@ void FocusChain::moveBeforeWindowInChain(Window *window, Window *reference, Chai
     if (!chain.contains(reference)) {
         return;
     }
+    chain.remove(window);
     if (Window::belongToSameApplication(reference, window)) {
-        chain.removeAll(window);
-        chain.insert(chain.indexOf(reference) + 1, window);
+        chain.insertAfter(reference, window);
     } else {
-        chain.removeAll(window);
-        for (int i = chain.size() - 1; i >= 0; --i) {
-            if (Window::belongToSameApplication(reference, chain.at(i))) {
-                chain.insert(i + 1, window);
+        for (auto it = chain.rbegin(); it != chain.rend(); ++it) {
+            if (Window::belongToSameApplication(reference, *it)) {
+                chain.insertAfter(*it, window);
                 break;
             }
         }
@@ -233,14 +219,13 @@ Window *FocusChain::nextMostRecentlyUsed(Window *reference) const
     if (m_mostRecentlyUsed.isEmpty()) {
         return nullptr;
     }
-    const int index = m_mostRecentlyUsed.indexOf(reference);
-    if (index == -1) {
+    if (!m_mostRecentlyUsed.contains(reference)) {
         return m_mostRecentlyUsed.first();
     }
-    if (index == 0) {
-        return m_mostRecentlyUsed.last();
+    if (Window *previous = m_mostRecentlyUsed.previous(reference)) {
+        return previous;
     }
-    return m_mostRecentlyUsed.at(index - 1);
+    return m_mostRecentlyUsed.last();
 }
 
 // copied from activation.cpp
@@ -251,13 +236,13 @@ bool FocusChain::isUsableFocusCandidate(Window *c, Window *prev) const
 
 Window *FocusChain::nextForDesktop(Window *reference, VirtualDesktop *desktop) const
 {
-    auto it = m_desktopFocusChains.constFind(desktop);
-    if (it == m_desktopFocusChains.constEnd()) {
+    auto it = m_desktopFocusChains.find(desktop);
+    if (it == m_desktopFocusChains.end()) {
         return nullptr;
     }
-    const auto &chain = it.value();
-    for (int i = chain.size() - 1; i >= 0; --i) {
-        auto window = chain.at(i);
+    const Chain &chain = it->second;
+    for (auto chainIt = chain.rbegin(); chainIt != chain.rend(); ++chainIt) {
+        Window *window = *chainIt;
         if (isUsableFocusCandidate(window, reference)) {
             return window;
         }
@@ -270,7 +255,7 @@ void FocusChain::makeFirstInChain(Window *window, Chain &chain)
     if (window->isDeleted()) {
         return;
     }
-    chain.removeAll(window);
+    chain.remove(window);
     chain.append(window);
 }
 
@@ -279,17 +264,99 @@ void FocusChain::makeLastInChain(Window *window, Chain &chain)
     if (window->isDeleted()) {
         return;
     }
-    chain.removeAll(window);
+    chain.remove(window);
     chain.prepend(window);
 }
 
 bool FocusChain::contains(Window *window, VirtualDesktop *desktop) const
 {
-    auto it = m_desktopFocusChains.constFind(desktop);
-    if (it == m_desktopFocusChains.constEnd()) {
+    auto it = m_desktopFocusChains.find(desktop);
+    if (it == m_desktopFocusChains.end()) {
         return false;
     }
-    return it.value().contains(window);
+    return it->second.contains(window);
+}
+
+bool FocusChain::Chain::isEmpty() const
+{
+    return m_windows.empty();
+}
+
+bool FocusChain::Chain::contains(Window *window) const
+{
+    return m_positions.contains(window);
+}
+
+Window *FocusChain::Chain::first() const
+{
+    return m_windows.front();
+}
+
+Window *FocusChain::Chain::last() const
+{
+    return m_windows.back();
+}
+
+Window *FocusChain::Chain::previous(Window *window) const
+{
+    const auto it = m_positions.value(window);
+    if (it == m_windows.begin()) {
+        return nullptr;
+    }
+    return *std::prev(it);
+}
+
+void FocusChain::Chain::append(Window *window)
+{
+    Q_ASSERT(!contains(window));
+    m_positions.insert(window, m_windows.insert(m_windows.end(), window));
+}
+
+void FocusChain::Chain::prepend(Window *window)
+{
+    Q_ASSERT(!contains(window));
+    m_positions.insert(window, m_windows.insert(m_windows.begin(), window));
+}
+
+void FocusChain::Chain::insertBefore(Window *reference, Window *window)
+{
+    Q_ASSERT(contains(reference) && !contains(window));
+    m_positions.insert(window, m_windows.insert(m_positions.value(reference), window));
+}
+
+void FocusChain::Chain::insertAfter(Window *reference, Window *window)
+{
+    Q_ASSERT(contains(reference) && !contains(window));
+    m_positions.insert(window, m_windows.insert(std::next(m_positions.value(reference)), window));
+}
+
+void FocusChain::Chain::remove(Window *window)
+{
+    const auto it = m_positions.find(window);
+    if (it != m_positions.end()) {
+        m_windows.erase(it.value());
+        m_positions.erase(it);
+    }
+}
+
+FocusChain::Chain::const_iterator FocusChain::Chain::begin() const
+{
+    return m_windows.begin();
+}
+
+FocusChain::Chain::const_iterator FocusChain::Chain::end() const
+{
+    return m_windows.end();
+}
+
+FocusChain::Chain::const_reverse_iterator FocusChain::Chain::rbegin() const
+{
+    return m_windows.rbegin();
+}
+
+FocusChain::Chain::const_reverse_iterator FocusChain::Chain::rend() const
+{
+    return m_windows.rend();
 }
 
 } // namespace
@@ -12,6 +12,9 @@
 // Qt
 #include <QHash>
 #include <QObject>
+// std
+#include <list>
+#include <unordered_map>
 
 namespace KWin
 {
@@ -182,7 +185,52 @@ public Q_SLOTS:
     void removeDesktop(VirtualDesktop *desktop);
 
 private:
-    using Chain = QList<Window *>;
+    /**
+     * A focus chain, the most recently used Window is the last one. Windows can be looked up,
+     * removed and moved to either end of the chain in constant time.
+     */
+    class Chain
+    {
+    public:
+        using const_iterator = std::list<Window *>::const_iterator;
+        using const_reverse_iterator = std::list<Window *>::const_reverse_iterator;
+
+        Chain() = default;
+        Chain(const Chain &) = delete;
+        Chain &operator=(const Chain &) = delete;
+
+        bool isEmpty() const;
+        bool contains(Window *window) const;
+        Window *first() const;
+        Window *last() const;
+        /**
+         * Returns the Window in front of @p window, i.e. the one that has been used less
+         * recently, or @c null if @p window is the first one.
+         */
+        Window *previous(Window *window) const;
+
+        void append(Window *window);
+        void prepend(Window *window);
+        /**
+         * Inserts @p window in front of @p reference, which has to be in the chain.
+         */
+        void insertBefore(Window *reference, Window *window);
+        /**
+         * Inserts @p window behind @p reference, which has to be in the chain.
+         */
+        void insertAfter(Window *reference, Window *window);
+        void remove(Window *window);
+
+        const_iterator begin() const;
+        const_iterator end() const;
+        const_reverse_iterator rbegin() const;
+        const_reverse_iterator rend() const;
+
+    private:
+        std::list<Window *> m_windows;
+        QHash<Window *, std::list<Window *>::iterator> m_positions;
+    };
+
     /**
      * @brief Makes @p window the first Window in the given focus @p chain.
      *
@@ -210,7 +258,7 @@ private:
     void updateWindowInChain(Window *window, Change change, Chain &chain);
     void insertWindowIntoChain(Window *window, Chain &chain);
     Chain m_mostRecentlyUsed;
-    QHash<VirtualDesktop *, Chain> m_desktopFocusChains;
+    std::unordered_map<VirtualDesktop *, Chain> m_desktopFocusChains;
     bool m_separateScreenFocus = false;
     Window *m_activeWindow = nullptr;
 };
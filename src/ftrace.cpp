@@ -35,7 +35,7 @@ FTraceLogger::FTraceLogger(QObject *parent)
 
 bool FTraceLogger::isEnabled() const
 {
-    return m_file.isOpen();
+    return m_enabled.load(std::memory_order_relaxed);
 }
 
 void FTraceLogger::setEnabled(bool enabled)
@@ -50,6 +50,7 @@ void FTraceLogger::setEnabled(bool enabled)
     } else {
         m_file.close();
     }
+    m_enabled = m_file.isOpen();
     Q_EMIT enabledChanged();
 }
 
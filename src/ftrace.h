@@ -17,6 +17,9 @@
 #include <QObject>
 #include <QTextStream>
 
+#include <atomic>
+#include <optional>
+
 namespace KWin
 {
 
@@ -40,6 +43,15 @@ public:
      */
     bool isEnabled() const;
 
+    /**
+     * Returns whether the logger exists and is enabled. It only loads an atomic flag,
+     * so it can be checked in hot paths, also from other threads than the main thread.
+     */
+    static bool isActive()
+    {
+        return s_self && s_self->m_enabled.load(std::memory_order_relaxed);
+    }
+
     /**
      * Main log function
      * Takes any number of arguments that can be written into QTextStream
@@ -67,6 +79,7 @@ private:
     bool open();
     QFile m_file;
     QMutex m_mutex;
+    std::atomic<bool> m_enabled = false;
     KWIN_SINGLETON(FTraceLogger)
 };
 
@@ -96,13 +109,17 @@ private:
 /**
  * Optimised macro, arguments are only copied if tracing is enabled
  */
-#define fTrace(...)                              \
-    if (KWin::FTraceLogger::self()->isEnabled()) \
+#define fTrace(...)                  \
+    if (KWin::FTraceLogger::isActive()) \
         KWin::FTraceLogger::self()->trace(__VA_ARGS__);
 
 /**
  * Will insert two markers into the log. Once when called, and the second at the end of the relevant block
  * In GPUVis this will appear as a timed block with begin_ctx and end_ctx markers
  */
-#define fTraceDuration(...) \
-    std::unique_ptr<KWin::FTraceDuration> _duration(KWin::FTraceLogger::self()->isEnabled() ? new KWin::FTraceDuration(__VA_ARGS__) : nullptr);
+#define fTraceDuration(...) fTraceDurationImpl(__LINE__, __VA_ARGS__)
+#define fTraceDurationImpl(line, ...) fTraceDurationImpl2(line, __VA_ARGS__)
+#define fTraceDurationImpl2(line, ...)                    \
+    std::optional<KWin::FTraceDuration> _duration##line; \
+    if (KWin::FTraceLogger::isActive())                   \
+        _duration##line.emplace(__VA_ARGS__);
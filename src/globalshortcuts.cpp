@@ -108,6 +108,7 @@ void GlobalShortcutsManager::objectDeleted(QObject *object)
     while (it != m_shortcuts.end()) {
         if (it->action() == object) {
             it = m_shortcuts.erase(it);
+            m_indexDirty = true;
         } else {
             ++it;
         }
@@ -124,9 +125,45 @@ bool GlobalShortcutsManager::add(GlobalShortcut sc, DeviceType device)
     }
     connect(sc.action(), &QAction::destroyed, this, &GlobalShortcutsManager::objectDeleted);
     m_shortcuts.push_back(std::move(sc));
+    m_indexDirty = true;
     return true;
 }
 
+static quint64 pointerButtonKey(Qt::KeyboardModifiers modifiers, Qt::MouseButtons buttons)
+{
+    return (quint64(modifiers.toInt()) << 32) | quint32(buttons.toInt());
+}
+
+static quint64 pointerAxisKey(Qt::KeyboardModifiers modifiers, PointerAxisDirection axis)
+{
+    return (quint64(modifiers.toInt()) << 32) | quint32(axis);
+}
+
+void GlobalShortcutsManager::updateIndex()
+{
+    if (!m_indexDirty) {
+        return;
+    }
+    m_indexDirty = false;
+    m_pointerButtonIndex.clear();
+    m_pointerAxisIndex.clear();
+    for (qsizetype i = 0; i < m_shortcuts.size(); ++i) {
+        // if several shortcuts are the same, the one that was registered first wins
+        const Shortcut &shortcut = m_shortcuts[i].shortcut();
+        if (const auto button = std::get_if<PointerButtonShortcut>(&shortcut)) {
+            const quint64 key = pointerButtonKey(button->pointerModifiers, button->pointerButtons);
+            if (!m_pointerButtonIndex.contains(key)) {
+                m_pointerButtonIndex.insert(key, i);
+            }
+        } else if (const auto axis = std::get_if<PointerAxisShortcut>(&shortcut)) {
+            const quint64 key = pointerAxisKey(axis->axisModifiers, axis->axisDirection);
+            if (!m_pointerAxisIndex.contains(key)) {
+                m_pointerAxisIndex.insert(key, i);
+            }
+        }
+    }
+}
+
 void GlobalShortcutsManager::registerPointerShortcut(QAction *action, Qt::KeyboardModifiers modifiers, Qt::MouseButtons pointerButtons)
 {
     add(GlobalShortcut(PointerButtonShortcut{modifiers, pointerButtons}, action));
@@ -179,6 +216,7 @@ void GlobalShortcutsManager::forceRegisterTouchscreenSwipe(SwipeDirection direct
     m_touchscreenGestureRecognizer->registerSwipeGesture(shortcut.swipeGesture());
     connect(shortcut.action(), &QAction::destroyed, this, &GlobalShortcutsManager::objectDeleted);
     m_shortcuts.push_back(std::move(shortcut));
+    m_indexDirty = true;
 }
 
 bool GlobalShortcutsManager::processKey(Qt::KeyboardModifiers mods, int keyQt, KeyboardKeyState state)
@@ -200,20 +238,6 @@ bool GlobalShortcutsManager::processKey(Qt::KeyboardModifiers mods, int keyQt, K
     return false;
 }
 
-template<typename ShortcutKind, typename... Args>
-GlobalShortcut *match(QList<GlobalShortcut> &shortcuts, Args... args)
-{
-    for (auto &sc : shortcuts) {
-        if (std::holds_alternative<ShortcutKind>(sc.shortcut())) {
-            if (std::get<ShortcutKind>(sc.shortcut()) == ShortcutKind{args...}) {
-                return &sc;
-            }
-        }
-    }
-    return nullptr;
-}
-
-// TODO(C++20): use ranges for a nicer way of filtering by shortcut type
 bool GlobalShortcutsManager::processPointerPressed(Qt::KeyboardModifiers mods, Qt::MouseButtons pointerButtons)
 {
 #if KWIN_BUILD_GLOBALSHORTCUTS
@@ -223,11 +247,13 @@ bool GlobalShortcutsManager::processPointerPressed(Qt::KeyboardModifiers mods, Q
         m_kglobalAccel->pointerPressed(pointerButtons);
     }
 #endif
-    GlobalShortcut *shortcut = match<PointerButtonShortcut>(m_shortcuts, mods, pointerButtons);
-    if (shortcut) {
-        shortcut->invoke();
+    updateIndex();
+    const auto it = m_pointerButtonIndex.constFind(pointerButtonKey(mods, pointerButtons));
+    if (it == m_pointerButtonIndex.cend()) {
+        return false;
     }
-    return shortcut != nullptr;
+    m_shortcuts[*it].invoke();
+    return true;
 }
 
 bool GlobalShortcutsManager::processAxis(Qt::KeyboardModifiers mods, PointerAxisDirection axis, qreal delta)
@@ -239,11 +265,15 @@ bool GlobalShortcutsManager::processAxis(Qt::KeyboardModifiers mods, PointerAxis
         m_kglobalAccel->axisTriggered(axis);
     }
 #endif
-    GlobalShortcut *shortcut = match<PointerAxisShortcut>(m_shortcuts, mods, axis);
-    if (shortcut && std::abs(delta) >= 1.0f) {
-        shortcut->invoke();
+    updateIndex();
+    const auto it = m_pointerAxisIndex.constFind(pointerAxisKey(mods, axis));
+    if (it == m_pointerAxisIndex.cend()) {
+        return false;
+    }
+    if (std::abs(delta) >= 1.0f) {
+        m_shortcuts[*it].invoke();
     }
-    return shortcut != nullptr;
+    return true;
 }
 
 void GlobalShortcutsManager::processSwipeStart(DeviceType device, uint fingerCount)
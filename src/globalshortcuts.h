@@ -12,6 +12,7 @@
 // Qt
 #include "core/inputdevice.h"
 
+#include <QHash>
 #include <QKeySequence>
 
 #include <memory>
@@ -117,8 +118,17 @@ public:
 private:
     void objectDeleted(QObject *object);
     bool add(GlobalShortcut sc, DeviceType device = DeviceType::Touchpad);
+    void updateIndex();
 
     QList<GlobalShortcut> m_shortcuts;
+    /**
+     * The positions in m_shortcuts of the pointer button and axis shortcuts, keyed by their
+     * modifiers and button or axis, so that input events don't have to go through the whole
+     * list. The index is rebuilt lazily after shortcuts have been added or removed.
+     */
+    QHash<quint64, qsizetype> m_pointerButtonIndex;
+    QHash<quint64, qsizetype> m_pointerAxisIndex;
+    bool m_indexDirty = false;
 
 #if KWIN_BUILD_GLOBALSHORTCUTS
     std::unique_ptr<KGlobalAccelD> m_kglobalAccel;
@@ -0,0 +1,148 @@
+/*
+    SPDX-License-Identifier: GPL-2.0-only OR GPL-3.0-only OR LicenseRef-KDE-Accepted-GPL
+    SPDX-FileCopyrightText: 2026 KWin contributors
+*/
+
+// Prints the protocol logs written by KWin's ProtocolRecorder in the style of WAYLAND_DEBUG
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDataStream>
+#include <QFile>
+#include <QHash>
+
+#include <iostream>
+
+static constexpr quint32 s_magic = 0x5250574b; // "KWPR"
+static constexpr quint32 s_version = 1;
+
+struct Client
+{
+    qint32 pid;
+    QByteArray executable;
+};
+
+static QByteArray formatArgument(char type, quint32 value)
+{
+    switch (type) {
+    case 'i':
+        return QByteArray::number(qint32(value));
+    case 'u':
+        return QByteArray::number(value);
+    case 'f':
+        return QByteArray::number(qint32(value) / 256.0);
+    case 'h':
+        return "fd " + QByteArray::number(value);
+    case 's':
+        return "string[" + QByteArray::number(value) + "]";
+    case 'o':
+        return value ? "#" + QByteArray::number(value) : QByteArray("nil");
+    case 'n':
+        return "new id #" + QByteArray::number(value);
+    case 'a':
+        return "array[" + QByteArray::number(value) + "]";
+    default:
+        return QByteArray::number(value);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral("Prints a Wayland protocol log recorded by KWin"));
+    parser.addHelpOption();
+    parser.addPositionalArgument(QStringLiteral("file"), QStringLiteral("The file written by org.kde.kwin.ProtocolRecorder.dump"));
+    const QCommandLineOption clientOption(QStringLiteral("client"), QStringLiteral("Only print the messages of the client with this pid"), QStringLiteral("pid"));
+    parser.addOption(clientOption);
+    parser.process(app);
+
+    if (parser.positionalArguments().size() != 1) {
+        parser.showHelp(1);
+    }
+
+    QFile file(parser.positionalArguments().constFirst());
+    if (!file.open(QIODevice::ReadOnly)) {
+        std::cerr << "Failed to open " << qPrintable(file.fileName()) << ": " << qPrintable(file.errorString()) << std::endl;
+        return 1;
+    }
+
+    QDataStream stream(&file);
+    stream.setByteOrder(QDataStream::LittleEndian);
+
+    quint32 magic;
+    quint32 version;
+    stream >> magic >> version;
+    if (magic != s_magic || version != s_version) {
+        std::cerr << qPrintable(file.fileName()) << " is not a protocol log of a supported version" << std::endl;
+        return 1;
+    }
+
+    quint32 clientCount;
+    stream >> clientCount;
+    QHash<quint32, Client> clients;
+    for (quint32 i = 0; i < clientCount; ++i) {
+        quint32 id;
+        Client client;
+        stream >> id >> client.pid >> client.executable;
+        clients.insert(id, client);
+    }
+
+    quint32 stringCount;
+    stream >> stringCount;
+    QList<QByteArray> strings;
+    strings.reserve(stringCount);
+    for (quint32 i = 0; i < stringCount; ++i) {
+        QByteArray string;
+        stream >> string;
+        strings.append(string);
+    }
+
+    const bool filterClient = parser.isSet(clientOption);
+    const qint32 pid = parser.value(clientOption).toInt();
+
+    quint32 recordCount;
+    stream >> recordCount;
+    for (quint32 i = 0; i < recordCount && stream.status() == QDataStream::Ok; ++i) {
+        qint64 timestamp;
+        quint32 clientId;
+        quint32 objectId;
+        quint16 interface;
+        quint16 message;
+        quint16 signature;
+        quint8 event;
+        quint8 argumentCount;
+        stream >> timestamp >> clientId >> objectId >> interface >> message >> signature >> event >> argumentCount;
+
+        QByteArrayList arguments;
+        const QByteArray types = strings.value(signature);
+        qsizetype typeIndex = 0;
+        for (int argument = 0; argument < argumentCount; ++argument) {
+            quint32 value;
+            stream >> value;
+            while (typeIndex < types.size() && !QByteArrayView("iufhsona").contains(types[typeIndex])) {
+                typeIndex++;
+            }
+            arguments.append(formatArgument(typeIndex < types.size() ? types[typeIndex] : 'u', value));
+            typeIndex++;
+        }
+
+        const Client client = clients.value(clientId);
+        if (filterClient && client.pid != pid) {
+            continue;
+        }
+
+        std::cout << '[' << QByteArray::number(timestamp / 1'000'000.0, 'f', 3).rightJustified(14).constData() << "] "
+                  << "{" << clientId << " pid " << client.pid << ' ' << client.executable.constData() << "} "
+                  << (event ? "<- " : "-> ")
+                  << strings.value(interface).constData() << '#' << objectId << '.' << strings.value(message).constData()
+                  << '(' << arguments.join(", ").constData() << ")\n";
+    }
+
+    if (stream.status() != QDataStream::Ok) {
+        std::cerr << qPrintable(file.fileName()) << " is truncated" << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -7,6 +7,8 @@
 #include "idledetector.h"
 #include "input.h"
 
+#include <algorithm>
+
 using namespace std::chrono_literals;
 
 namespace KWin
@@ -18,7 +20,7 @@ IdleDetector::IdleDetector(std::chrono::milliseconds timeout, OperatingMode mode
     , m_mode(mode)
 {
     Q_ASSERT(timeout >= 0ms);
-    m_timer.start(timeout, this);
+    restartTimer();
 
     input()->addIdleDetector(this);
 }
@@ -34,10 +36,22 @@ void IdleDetector::timerEvent(QTimerEvent *event)
 {
     if (event->timerId() == m_timer.timerId()) {
         m_timer.stop();
-        markAsIdle();
+        const auto lastActivity = std::max(m_timerStart, input()->lastUserActivity());
+        const auto remaining = std::chrono::ceil<std::chrono::milliseconds>(lastActivity + m_timeout - std::chrono::steady_clock::now());
+        if (remaining > 0ms) {
+            m_timer.start(remaining, this);
+        } else {
+            markAsIdle();
+        }
     }
 }
 
+void IdleDetector::restartTimer()
+{
+    m_timerStart = std::chrono::steady_clock::now();
+    m_timer.start(m_timeout, this);
+}
+
 IdleDetector::OperatingMode IdleDetector::mode() const
 {
     return m_mode;
@@ -61,14 +75,14 @@ void IdleDetector::setInhibited(bool inhibited)
     if (inhibited) {
         m_timer.stop();
     } else {
-        m_timer.start(m_timeout, this);
+        restartTimer();
     }
 }
 
 void IdleDetector::activity()
 {
     if (!m_isInhibited) {
-        m_timer.start(m_timeout, this);
+        restartTimer();
         markAsResumed();
     }
 }
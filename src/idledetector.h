@@ -11,9 +11,19 @@
 #include <QBasicTimer>
 #include <QObject>
 
+#include <chrono>
+
 namespace KWin
 {
 
+/**
+ * The IdleDetector class notifies about the user being idle for the given timeout, and about
+ * the user being active again afterwards.
+ *
+ * User activity doesn't restart the timers of all detectors. Those that aren't idle check
+ * InputRedirection::lastUserActivity() when their timer expires, and wait for the rest of
+ * the timeout if there has been activity in the meantime.
+ */
 class KWIN_EXPORT IdleDetector : public QObject
 {
     Q_OBJECT
@@ -44,9 +54,11 @@ protected:
 private:
     void markAsIdle();
     void markAsResumed();
+    void restartTimer();
 
     QBasicTimer m_timer;
     std::chrono::milliseconds m_timeout;
+    std::chrono::steady_clock::time_point m_timerStart;
     bool m_isIdle = false;
     bool m_isInhibited = false;
     OperatingMode m_mode = OperatingMode::FollowsInhibitors;
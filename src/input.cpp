@@ -51,6 +51,7 @@
 #include "wayland/surface.h"
 #include "wayland/tablet_v2.h"
 #include "wayland_server.h"
+#include "windowhittestindex.h"
 #include "workspace.h"
 #include "xdgactivationv1.h"
 #include "xkb.h"
@@ -2103,6 +2104,21 @@ public:
     bool pointerMotion(PointerMotionEvent *event) override
     {
         auto seat = waylandServer()->seat();
+        if (!event->history.empty()) {
+            // the filters have seen the combined motion, but the client gets every single event
+            for (size_t i = 0; i < event->history.size(); ++i) {
+                const PointerMotionSample &sample = event->history[i];
+                seat->setTimestamp(sample.timestamp);
+                seat->notifyPointerMotion(sample.position);
+                if (!sample.delta.isNull()) {
+                    seat->relativePointerMotion(sample.delta, sample.deltaUnaccelerated, sample.timestamp);
+                }
+                if (i + 1 < event->history.size()) {
+                    seat->notifyPointerFrame();
+                }
+            }
+            return true;
+        }
         seat->setTimestamp(event->timestamp);
         seat->notifyPointerMotion(event->position);
         // absolute motion events confuse games and Wayland doesn't have a warp event yet
@@ -3409,22 +3425,38 @@ Qt::MouseButtons InputRedirection::qtButtonStates() const
 
 void InputRedirection::simulateUserActivity()
 {
-    const auto idleDetectors = m_idleDetectors; // the detector list can potentially change
+    // the detectors that aren't idle yet check the timestamp when their timers expire,
+    // so only the idle ones need to be woken up
+    m_lastUserActivity = std::chrono::steady_clock::now();
+    const auto idleDetectors = m_expiredIdleDetectors; // the detector list can potentially change
     for (IdleDetector *idleDetector : idleDetectors) {
         idleDetector->activity();
     }
 }
 
+std::chrono::steady_clock::time_point InputRedirection::lastUserActivity() const
+{
+    return m_lastUserActivity;
+}
+
 void InputRedirection::addIdleDetector(IdleDetector *detector)
 {
     Q_ASSERT(!m_idleDetectors.contains(detector));
     detector->setInhibited(!m_idleInhibitors.isEmpty());
     m_idleDetectors.append(detector);
+    connect(detector, &IdleDetector::idle, this, [this, detector]() {
+        m_expiredIdleDetectors.append(detector);
+    });
+    connect(detector, &IdleDetector::resumed, this, [this, detector]() {
+        m_expiredIdleDetectors.removeOne(detector);
+    });
 }
 
 void InputRedirection::removeIdleDetector(IdleDetector *detector)
 {
     m_idleDetectors.removeOne(detector);
+    m_expiredIdleDetectors.removeOne(detector);
+    disconnect(detector, nullptr, this, nullptr);
 }
 
 QList<Window *> InputRedirection::idleInhibitors() const
@@ -3463,24 +3495,12 @@ Window *InputRedirection::findToplevel(const QPointF &pos)
             return nullptr;
         }
     }
-    const QList<Window *> &stacking = Workspace::self()->stackingOrder();
-    if (stacking.isEmpty()) {
-        return nullptr;
+    if (!m_hitTestIndex) {
+        // the index only contains windows that can get input, i.e. windows that are not deleted,
+        // on the current desktop and activity, not minimized or hidden, and ready for painting
+        m_hitTestIndex = new WindowHitTestIndex(Workspace::self());
     }
-    auto it = stacking.end();
-    do {
-        --it;
-        Window *window = (*it);
-        if (window->isDeleted()) {
-            // a deleted window doesn't get mouse events
-            continue;
-        }
-        if (!window->isOnCurrentActivity() || !window->isOnCurrentDesktop() || window->isMinimized() || window->isHidden() || window->isHiddenByShowDesktop()) {
-            continue;
-        }
-        if (!window->readyForPainting()) {
-            continue;
-        }
+    for (Window *window : m_hitTestIndex->candidatesAt(pos)) {
         if (isScreenLocked) {
             if (!window->isLockScreen() && !window->isInputMethod() && !window->isLockScreenOverlay()) {
                 continue;
@@ -3489,7 +3509,7 @@ Window *InputRedirection::findToplevel(const QPointF &pos)
         if (window->hitTest(pos)) {
             return window;
         }
-    } while (it != stacking.begin());
+    }
     return nullptr;
 }
 
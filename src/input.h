@@ -12,6 +12,7 @@
 #include "config-kwin.h"
 
 #include "core/inputdevice.h"
+#include "ftrace.h"
 #include <QObject>
 #include <QPoint>
 #include <QPointer>
@@ -20,6 +21,7 @@
 #include <KSharedConfig>
 #include <QSet>
 
+#include <chrono>
 #include <functional>
 
 class KGlobalAccelInterface;
@@ -42,6 +44,7 @@ class PointerInputRedirection;
 class SeatInterface;
 class TabletInputRedirection;
 class TouchInputRedirection;
+class WindowHitTestIndex;
 class WindowSelectorFilter;
 struct SwitchEvent;
 struct TabletToolTipEvent;
@@ -132,6 +135,10 @@ public:
     void uninstallInputEventSpy(InputEventSpy *spy);
 
     void simulateUserActivity();
+    /**
+     * Returns when the user was last active, see simulateUserActivity()
+     */
+    std::chrono::steady_clock::time_point lastUserActivity() const;
 
     void addIdleDetector(IdleDetector *detector);
     void removeIdleDetector(IdleDetector *detector);
@@ -153,6 +160,7 @@ public:
      */
     void processFilters(auto method, const auto &...args)
     {
+        fTraceDuration("Input filters");
         for (const auto filter : std::as_const(m_filters)) {
             if ((filter->*method)(args...)) {
                 return;
@@ -300,8 +308,11 @@ private:
     QList<InputDevice *> m_inputDevices;
 
     QList<IdleDetector *> m_idleDetectors;
+    QList<IdleDetector *> m_expiredIdleDetectors;
+    std::chrono::steady_clock::time_point m_lastUserActivity;
     QList<Window *> m_idleInhibitors;
     std::unique_ptr<WindowSelectorFilter> m_windowSelector;
+    QPointer<WindowHitTestIndex> m_hitTestIndex;
 
     QList<InputEventFilter *> m_filters;
     QList<InputEventSpy *> m_spies;
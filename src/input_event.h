@@ -11,6 +11,7 @@
 #include "input.h"
 
 #include <chrono>
+#include <span>
 
 namespace KWin
 {
@@ -18,6 +19,14 @@ namespace KWin
 class InputDevice;
 class InputDeviceTabletTool;
 
+struct PointerMotionSample
+{
+    QPointF position;
+    QPointF delta;
+    QPointF deltaUnaccelerated;
+    std::chrono::microseconds timestamp;
+};
+
 struct PointerMotionEvent
 {
     InputDevice *device;
@@ -29,6 +38,11 @@ struct PointerMotionEvent
     Qt::KeyboardModifiers modifiers;
     Qt::KeyboardModifiers modifiersRelevantForShortcuts;
     std::chrono::microseconds timestamp;
+    /**
+     * If the event combines several motion events, the individual motion events, oldest
+     * first. The delta of the event is the sum of them.
+     */
+    std::span<const PointerMotionSample> history = {};
 };
 
 struct PointerButtonEvent
@@ -7,36 +7,67 @@
     SPDX-License-Identifier: GPL-2.0-or-later
 */
 #include "keyboard_repeat.h"
+#include "core/backendoutput.h"
+#include "core/output.h"
+#include "core/renderloop.h"
 #include "input_event.h"
 #include "keyboard_input.h"
 #include "wayland/keyboard.h"
 #include "wayland/seat.h"
 #include "wayland_server.h"
+#include "window.h"
 #include "xkb.h"
 
-#include <QTimer>
-
 namespace KWin
 {
 
 KeyboardRepeat::KeyboardRepeat(Xkb *xkb)
     : QObject()
-    , m_timer(new QTimer(this))
     , m_xkb(xkb)
+    , m_alignToFrames(qEnvironmentVariableIntValue("KWIN_KEY_REPEAT_ALIGN_TO_FRAMES") == 1)
 {
-    connect(m_timer, &QTimer::timeout, this, &KeyboardRepeat::handleKeyRepeat);
+    connect(&m_timer, &PreciseTimer::timeout, this, &KeyboardRepeat::handleKeyRepeat);
 }
 
 KeyboardRepeat::~KeyboardRepeat() = default;
 
+static std::chrono::nanoseconds monotonicNow()
+{
+    return std::chrono::steady_clock::now().time_since_epoch();
+}
+
 void KeyboardRepeat::handleKeyRepeat()
 {
+    const std::chrono::nanoseconds repeatTime = m_nextRepeat;
     // TODO: don't depend on WaylandServer
-    if (waylandServer()->seat()->keyboard()->keyRepeatRate() != 0) {
-        m_timer->setInterval(1000 / waylandServer()->seat()->keyboard()->keyRepeatRate());
+    const int rate = waylandServer()->seat()->keyboard()->keyRepeatRate();
+    if (rate != 0) {
+        // advance from the previous deadline rather than from now, so that late wakeups don't add up
+        m_nextRepeat += std::chrono::nanoseconds(1'000'000'000) / rate;
+        m_nextRepeat = std::max(m_nextRepeat, monotonicNow());
+        scheduleKeyRepeat();
+    }
+    Q_EMIT keyRepeat(m_key, std::chrono::duration_cast<std::chrono::microseconds>(repeatTime));
+}
+
+void KeyboardRepeat::scheduleKeyRepeat()
+{
+    std::chrono::nanoseconds deadline = m_nextRepeat;
+    if (m_alignToFrames) {
+        // Deliver the repeat right after the last vblank before it's due, so the focused client
+        // has the whole frame to react and every repeat shows up in the same frame relative to
+        // when it's sent, rather than sometimes one frame later depending on the phase.
+        const Window *window = waylandServer()->findWindow(waylandServer()->seat()->focusedKeyboardSurface());
+        const RenderLoop *renderLoop = window && window->output() ? window->output()->backendOutput()->renderLoop() : nullptr;
+        if (renderLoop && renderLoop->refreshRate() > 0 && renderLoop->lastPresentationTimestamp() != std::chrono::nanoseconds::zero()) {
+            const std::chrono::nanoseconds refreshInterval(1'000'000'000'000ull / renderLoop->refreshRate());
+            const std::chrono::nanoseconds lastVblank = renderLoop->lastPresentationTimestamp();
+            if (deadline > lastVblank) {
+                deadline = std::max(lastVblank + ((deadline - lastVblank) / refreshInterval) * refreshInterval, monotonicNow());
+            }
+        }
     }
-    // TODO: better time
-    Q_EMIT keyRepeat(m_key, m_time);
+    m_timer.start(deadline);
 }
 
 void KeyboardRepeat::keyboardKey(uint32_t key, KeyboardKeyState state, std::chrono::microseconds time)
@@ -47,14 +78,13 @@ void KeyboardRepeat::keyboardKey(uint32_t key, KeyboardKeyState state, std::chro
     if (state == KeyboardKeyState::Pressed) {
         // TODO: don't get these values from WaylandServer
         if (m_xkb->shouldKeyRepeat(key) && waylandServer()->seat()->keyboard()->keyRepeatDelay() != 0) {
-            m_timer->setInterval(waylandServer()->seat()->keyboard()->keyRepeatDelay());
             m_key = key;
-            m_time = time;
-            m_timer->start();
+            m_nextRepeat = monotonicNow() + std::chrono::milliseconds(waylandServer()->seat()->keyboard()->keyRepeatDelay());
+            scheduleKeyRepeat();
         }
     } else if (state == KeyboardKeyState::Released) {
         if (key == m_key) {
-            m_timer->stop();
+            m_timer.stop();
         }
     }
 }
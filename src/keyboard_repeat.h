@@ -9,11 +9,10 @@
 #pragma once
 
 #include "input.h"
+#include "utils/precisetimer.h"
 
 #include <QObject>
 
-class QTimer;
-
 namespace KWin
 {
 
@@ -34,10 +33,14 @@ Q_SIGNALS:
 
 private:
     void handleKeyRepeat();
-    QTimer *m_timer;
+    void scheduleKeyRepeat();
+
+    PreciseTimer m_timer;
     Xkb *m_xkb;
-    std::chrono::microseconds m_time;
+    // when the next repeat is due, in the monotonic clock like the timestamps of input events
+    std::chrono::nanoseconds m_nextRepeat = std::chrono::nanoseconds::zero();
     quint32 m_key = 0;
+    const bool m_alignToFrames;
 };
 
 }
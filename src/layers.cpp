@@ -81,6 +81,7 @@
 #endif
 
 #include <array>
+#include <vector>
 
 #include <QDebug>
 
@@ -118,6 +119,26 @@ void Workspace::updateStackingOrder(bool propagate_new_windows)
 
 #if KWIN_BUILD_X11
 
+/**
+ * Returns the part of @a next that has to be restacked so the windows that were stacked in
+ * the order of @a previous get stacked in the order of @a next. It starts with the last window
+ * that is stacked the same in both, which the other windows get stacked below.
+ */
+static QList<xcb_window_t> changedWindowStack(const QList<xcb_window_t> &previous, const QList<xcb_window_t> &next)
+{
+    const qsizetype commonSize = std::min(previous.size(), next.size());
+    qsizetype prefix = 0;
+    while (prefix < commonSize && previous[prefix] == next[prefix]) {
+        ++prefix;
+    }
+    qsizetype suffix = 0;
+    while (suffix < commonSize - prefix && previous[previous.size() - suffix - 1] == next[next.size() - suffix - 1]) {
+        ++suffix;
+    }
+    const qsizetype first = std::max<qsizetype>(0, prefix - 1);
+    return next.mid(first, next.size() - suffix - first);
+}
+
 /**
  * Propagates the managed windows to the world.
  * Called ONLY from updateStackingOrder().
@@ -164,10 +185,13 @@ void Workspace::propagateWindows(bool propagate_new_windows)
         newWindowStack << window->window();
     }
 
-    // TODO isn't it too inefficient to restack always all windows?
+    // Only the windows whose position has changed since the last time are restacked, unless
+    // restacking has been forced, for example because some window might have been restacked
+    // behind our back.
     // TODO don't restack not visible windows?
     Q_ASSERT(newWindowStack.at(0) == rootInfo()->supportWindow());
-    Xcb::restackWindows(newWindowStack);
+    Xcb::restackWindows(changedWindowStack(m_x11WindowStack, newWindowStack));
+    m_x11WindowStack = newWindowStack;
 
     QList<xcb_window_t> cl;
     if (propagate_new_windows) {
@@ -194,7 +218,10 @@ void Workspace::propagateWindows(bool propagate_new_windows)
     for (const auto win : std::as_const(manual_overlays)) {
         cl.push_back(win);
     }
-    rootInfo()->setClientListStacking(cl.constData(), cl.size());
+    if (cl != m_x11ClientListStacking) {
+        rootInfo()->setClientListStacking(cl.constData(), cl.size());
+        m_x11ClientListStacking = cl;
+    }
 }
 #endif
 
@@ -605,10 +632,22 @@ QList<Window *> Workspace::constrainedStackingOrder()
     }
 
     // Preserve the relative order of transient siblings in the unconstrained stacking order.
-    auto constraintComparator = [&stacking](Constraint *a, Constraint *b) {
-        return stacking.indexOf(a->above) > stacking.indexOf(b->above);
+    // The positions are looked up once per constraint rather than on every comparison.
+    std::vector<std::pair<qsizetype, Constraint *>> sortedConstraints;
+    auto sortConstraints = [&stacking, &sortedConstraints](QList<Constraint *> &constraints) {
+        sortedConstraints.clear();
+        sortedConstraints.reserve(constraints.size());
+        for (Constraint *constraint : std::as_const(constraints)) {
+            sortedConstraints.emplace_back(stacking.indexOf(constraint->above), constraint);
+        }
+        std::stable_sort(sortedConstraints.begin(), sortedConstraints.end(), [](const auto &a, const auto &b) {
+            return a.first > b.first;
+        });
+        for (qsizetype i = 0; i < constraints.size(); ++i) {
+            constraints[i] = sortedConstraints[i].second;
+        }
     };
-    std::sort(constraints.begin(), constraints.end(), constraintComparator);
+    sortConstraints(constraints);
 
     // Once we've enqueued all the root constraints, we traverse the constraints tree in
     // the reverse breadth-first search fashion. A constraint is applied only if its condition is
@@ -627,7 +666,7 @@ QList<Window *> Workspace::constrainedStackingOrder()
 
         // Preserve the relative order of transient siblings in the unconstrained stacking order.
         QList<Constraint *> children = constraint->children;
-        std::sort(children.begin(), children.end(), constraintComparator);
+        sortConstraints(children);
 
         for (Constraint *child : std::as_const(children)) {
             if (!child->enqueued) {
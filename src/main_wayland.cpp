@@ -14,10 +14,14 @@
 #include "backends/virtual/virtual_backend.h"
 #include "backends/wayland/wayland_backend.h"
 #include "compositor.h"
+#include "core/backendoutput.h"
 #include "core/outputbackend.h"
+#include "core/renderloop.h"
 #include "core/session.h"
+#include "cursor.h"
 #include "effect/effecthandler.h"
 #include "inputmethod.h"
+#include "startuptracer.h"
 #include "tabletmodemanager.h"
 #include "utils/realtime.h"
 #include "wayland/display.h"
@@ -136,24 +140,58 @@ ApplicationWayland::~ApplicationWayland()
 
 void ApplicationWayland::performStartup()
 {
-    createOptions();
+    startupStage("Startup");
+    {
+        startupStage("Options");
+        createOptions();
+    }
+
+    {
+        startupStage("Output backend");
+        createGpuManager();
+        if (!outputBackend()->initialize()) {
+            std::exit(1);
+        }
+    }
 
-    createGpuManager();
-    if (!outputBackend()->initialize()) {
-        std::exit(1);
+    // the cursor theme is only needed once the workspace is created, look it up meanwhile
+    qreal cursorDevicePixelRatio = 1;
+    const auto outputs = outputBackend()->outputs();
+    for (const BackendOutput *output : outputs) {
+        cursorDevicePixelRatio = std::max(cursorDevicePixelRatio, output->scale());
     }
+    Cursors::self()->mouse()->prefetchTheme(cursorDevicePixelRatio);
 
-    createInput();
-    createInputMethod();
-    createTabletModeManager();
+    {
+        startupStage("Input");
+        createInput();
+        createInputMethod();
+        createTabletModeManager();
+    }
 
     auto compositor = Compositor::create();
-    compositor->createRenderer();
-    createWorkspace();
-    createScene();
-    createPlugins();
+    {
+        startupStage("Renderer");
+        compositor->createRenderer();
+    }
+    {
+        startupStage("Workspace");
+        createWorkspace();
+    }
+    {
+        startupStage("Scene");
+        createScene();
+    }
+    {
+        startupStage("Plugins");
+        createPlugins();
+    }
 
-    compositor->start();
+    {
+        startupStage("Compositor");
+        compositor->start();
+    }
+    traceFirstFrame();
 
     // Note that we start accepting client connections after creating the Workspace.
     if (!waylandServer()->start()) {
@@ -162,6 +200,7 @@ void ApplicationWayland::performStartup()
 
 #if KWIN_BUILD_X11
     if (m_startXWayland) {
+        startupStage("Xwayland");
         m_xwayland = std::make_unique<Xwl::Xwayland>(this);
         m_xwayland->xwaylandLauncher()->setListenFds(m_xwaylandListenFds);
         m_xwayland->xwaylandLauncher()->setDisplayName(m_xwaylandDisplay);
@@ -181,6 +220,19 @@ void ApplicationWayland::performStartup()
     startSession();
 }
 
+void ApplicationWayland::traceFirstFrame()
+{
+    const auto outputs = outputBackend()->outputs();
+    for (BackendOutput *output : outputs) {
+        connect(output->renderLoop(), &RenderLoop::framePresented, this, []() {
+            if (!StartupTracer::isFinished()) {
+                StartupTracer::mark("First frame");
+                StartupTracer::finish();
+            }
+        }, Qt::SingleShotConnection);
+    }
+}
+
 void ApplicationWayland::refreshSettings(const KConfigGroup &group, const QByteArrayList &names)
 {
     if (group.name() == "Wayland" && names.contains("InputMethod")) {
@@ -274,6 +326,8 @@ pid_t ApplicationWayland::xwaylandPid() const
 
 int main(int argc, char *argv[])
 {
+    KWin::StartupTracer::mark("Process start");
+
 #if defined(Q_OS_LINUX)
     // Some Linux distros may set ambient capabilities, so clear CAP_SYS_NICE here to avoid
     // leaking it to all child processes.
@@ -282,7 +336,7 @@ int main(int argc, char *argv[])
 
     KWin::Application::setupMalloc();
     KWin::Application::setupLocalizedString();
-    KWin::gainRealTime();
+    KWin::gainRealTime(KWin::RealTimeRole::Compositor, QStringLiteral("kwin_wayland"));
 
     signal(SIGPIPE, SIG_IGN);
 
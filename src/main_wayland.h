@@ -87,6 +87,7 @@ protected:
 
 private:
     void startSession();
+    void traceFirstFrame();
     void refreshSettings(const KConfigGroup &group, const QByteArrayList &names);
 
     QStringList m_applicationsToStart;
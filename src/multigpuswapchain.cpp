@@ -67,6 +67,7 @@ static std::optional<DrmFormat> chooseFormat(uint32_t inputFormat, const FormatM
 }
 
 static const auto s_forceLinear = environmentVariableBoolValue("KWIN_VULKAN_FORCE_LINEAR_DST");
+static const auto s_useTransferQueue = environmentVariableBoolValue("KWIN_VULKAN_MULTI_GPU_TRANSFER_QUEUE");
 
 std::unique_ptr<MultiGpuSwapchain> MultiGpuSwapchain::create(RenderDevice *copyDevice, DrmDevice *targetDevice, uint32_t format, uint64_t modifier, const QSize &size, const FormatModifierMap &importFormats, bool scanout)
 {
@@ -165,6 +166,88 @@ std::optional<MultiGpuSwapchain::Ret> MultiGpuSwapchain::copyRgbBuffer(GraphicsB
     }
 }
 
+static void blitImage(vk::raii::CommandBuffer &commandBuffer, VulkanTexture *src, VulkanTexture *dst, const Region &region)
+{
+    const int height = dst->size().height();
+    const std::vector<vk::ImageBlit> regions = region.rects() | std::views::transform([height](const Rect &rect) {
+        return vk::ImageBlit{
+            // src
+            vk::ImageSubresourceLayers{
+                vk::ImageAspectFlagBits::eColor,
+                0,
+                0,
+                1,
+            },
+            std::array{
+                vk::Offset3D{rect.left(), height - rect.bottom(), 0},
+                vk::Offset3D{rect.right(), height - rect.top(), 1},
+            },
+            // dst
+            vk::ImageSubresourceLayers{
+                vk::ImageAspectFlagBits::eColor,
+                0,
+                0,
+                1,
+            },
+            std::array{
+                vk::Offset3D{rect.left(), height - rect.bottom(), 0},
+                vk::Offset3D{rect.right(), height - rect.top(), 1},
+            },
+        };
+    }) | std::ranges::to<std::vector>();
+    commandBuffer.blitImage(src->handle(), vk::ImageLayout::eGeneral,
+                            dst->handle(), vk::ImageLayout::eGeneral,
+                            regions, vk::Filter::eNearest);
+}
+
+static int alignDown(int value, uint32_t alignment)
+{
+    return value - value % int(alignment);
+}
+
+static int alignUp(int value, uint32_t alignment, int limit)
+{
+    return std::min(limit, alignDown(value + int(alignment) - 1, alignment));
+}
+
+static void copyImage(vk::raii::CommandBuffer &commandBuffer, VulkanTexture *src, VulkanTexture *dst, const Region &region, const VkExtent3D &granularity)
+{
+    const int width = dst->size().width();
+    const int height = dst->size().height();
+    const auto imageCopy = [](int x0, int y0, int x1, int y1) {
+        const vk::ImageSubresourceLayers layers{
+            vk::ImageAspectFlagBits::eColor,
+            0,
+            0,
+            1,
+        };
+        return vk::ImageCopy{
+            layers,
+            vk::Offset3D{x0, y0, 0},
+            layers,
+            vk::Offset3D{x0, y0, 0},
+            vk::Extent3D{uint32_t(x1 - x0), uint32_t(y1 - y0), 1},
+        };
+    };
+    std::vector<vk::ImageCopy> regions;
+    if (granularity.width == 0 || granularity.height == 0) {
+        // the queue can only copy whole images
+        regions.push_back(imageCopy(0, 0, width, height));
+    } else {
+        // copies have to be aligned to the granularity of the queue, unless they end at the edge
+        // of the image. Copying a few more pixels is fine, the whole source image is up to date
+        for (const Rect &rect : region.rects()) {
+            regions.push_back(imageCopy(alignDown(rect.left(), granularity.width),
+                                        alignDown(height - rect.bottom(), granularity.height),
+                                        alignUp(rect.right(), granularity.width, width),
+                                        alignUp(height - rect.top(), granularity.height, height)));
+        }
+    }
+    commandBuffer.copyImage(src->handle(), vk::ImageLayout::eGeneral,
+                            dst->handle(), vk::ImageLayout::eGeneral,
+                            regions);
+}
+
 std::optional<MultiGpuSwapchain::Ret> MultiGpuSwapchain::copyWithVulkan(GraphicsBuffer *src, const Region &damage, FileDescriptor &&sync, OutputFrame *frame,
                                                                         const std::shared_ptr<SyncReleasePoint> &releasePoint)
 {
@@ -202,7 +285,14 @@ std::optional<MultiGpuSwapchain::Ret> MultiGpuSwapchain::copyWithVulkan(Graphics
     }
     m_journal.add(damage);
 
-    auto commandBuffer = copyVk->createCommandBuffer();
+    // transfer queues can't blit, so they can only be used if the format doesn't need to be converted.
+    // As they are usually backed by copy engines, the copy can then happen in parallel to rendering
+    const bool useTransferQueue = s_useTransferQueue.value_or(true) && copyVk->hasTransferQueue()
+        && srcTexture->format() == m_currentVulkanSlot->texture()->format();
+    const auto queue = useTransferQueue ? VulkanDevice::Queue::Transfer : VulkanDevice::Queue::Graphics;
+    const uint32_t queueFamily = copyVk->queueFamily(queue);
+
+    auto commandBuffer = copyVk->createCommandBuffer(queue);
     vk::Result result = commandBuffer.begin(vk::CommandBufferBeginInfo{
         vk::CommandBufferUsageFlagBits::eOneTimeSubmit,
     });
@@ -213,7 +303,7 @@ std::optional<MultiGpuSwapchain::Ret> MultiGpuSwapchain::copyWithVulkan(Graphics
 
     std::unique_ptr<VulkanRenderTimeQuery> query;
     if (frame) {
-        query = VulkanRenderTimeQuery::begin(copyVk, commandBuffer, copyVk->graphicsQueueFamily());
+        query = VulkanRenderTimeQuery::begin(copyVk, commandBuffer, queueFamily);
     }
 
     vk::ImageMemoryBarrier2 memoryBarrier{
@@ -224,7 +314,7 @@ std::optional<MultiGpuSwapchain::Ret> MultiGpuSwapchain::copyWithVulkan(Graphics
         vk::ImageLayout::eGeneral,
         vk::ImageLayout::eGeneral,
         vk::QueueFamilyExternal,
-        copyVk->graphicsQueueFamily(),
+        queueFamily,
         m_currentVulkanSlot->texture()->handle(),
         vk::ImageSubresourceRange{
             vk::ImageAspectFlagBits::eColor,
@@ -241,37 +331,13 @@ std::optional<MultiGpuSwapchain::Ret> MultiGpuSwapchain::copyWithVulkan(Graphics
         memoryBarrier,
     });
 
-    const std::vector<vk::ImageBlit> regions = toRender.rects() | std::views::transform([&completeRect](const Rect &rect) {
-        return vk::ImageBlit{
-            // src
-            vk::ImageSubresourceLayers{
-                vk::ImageAspectFlagBits::eColor,
-                0,
-                0,
-                1,
-            },
-            std::array{
-                vk::Offset3D{rect.left(), completeRect.height() - rect.bottom(), 0},
-                vk::Offset3D{rect.right(), completeRect.height() - rect.top(), 1},
-            },
-            // dst
-            vk::ImageSubresourceLayers{
-                vk::ImageAspectFlagBits::eColor,
-                0,
-                0,
-                1,
-            },
-            std::array{
-                vk::Offset3D{rect.left(), completeRect.height() - rect.bottom(), 0},
-                vk::Offset3D{rect.right(), completeRect.height() - rect.top(), 1},
-            },
-        };
-    }) | std::ranges::to<std::vector>();
-    commandBuffer.blitImage(srcTexture->handle(), vk::ImageLayout::eGeneral,
-                            m_currentVulkanSlot->texture()->handle(), vk::ImageLayout::eGeneral,
-                            regions, vk::Filter::eNearest);
+    if (useTransferQueue) {
+        copyImage(commandBuffer, srcTexture.get(), m_currentVulkanSlot->texture(), toRender, copyVk->queueFamilyProperties()[queueFamily].minImageTransferGranularity);
+    } else {
+        blitImage(commandBuffer, srcTexture.get(), m_currentVulkanSlot->texture(), toRender);
+    }
 
-    memoryBarrier.setSrcQueueFamilyIndex(copyVk->graphicsQueueFamily());
+    memoryBarrier.setSrcQueueFamilyIndex(queueFamily);
     memoryBarrier.setDstQueueFamilyIndex(vk::QueueFamilyExternal);
     commandBuffer.pipelineBarrier2(vk::DependencyInfo{
         vk::DependencyFlags{},
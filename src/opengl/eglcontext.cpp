@@ -12,6 +12,8 @@
 #include "egldisplay.h"
 #include "eglimagetexture.h"
 #include "glframebuffer.h"
+#include "glgpuprofiler.h"
+#include "glpixelunpackbuffer.h"
 #include "glplatform.h"
 #include "glshader.h"
 #include "glshadermanager.h"
@@ -64,6 +66,17 @@ static bool checkIndexedQuads(EglContext *context)
     return haveBaseVertex && haveCopyBuffer && context->hasMapBufferRange();
 }
 
+static bool checkProgramBinaries(EglContext *context)
+{
+    if (!context->hasVersion(Version(3, 0)) && !context->hasOpenglExtension(QByteArrayLiteral("GL_OES_get_program_binary"))) {
+        return false;
+    }
+    // some drivers advertise the functionality, but don't support any binary formats
+    GLint formatCount = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+    return formatCount > 0;
+}
+
 typedef void (*eglFuncPtr)();
 static eglFuncPtr getProcAddress(const char *name)
 {
@@ -93,6 +106,8 @@ EglContext::EglContext(EglDisplay *display, EGLConfig config, ::EGLContext conte
     , m_haveSyncFences(hasVersion(Version(3, 0)))
     , m_supportsIndexedQuads(checkIndexedQuads(this))
     , m_supportsPackInvert(hasOpenglExtension(QByteArrayLiteral("GL_MESA_pack_invert")))
+    , m_supportsProgramBinaries(checkProgramBinaries(this))
+    , m_supportsComputeShaders(hasVersion(Version(3, 1)))
     , m_glPlatform(std::make_unique<GLPlatform>(m_versionString, m_glslVersionString, m_renderer, m_vendor))
     , m_display(display)
     , m_handle(context)
@@ -109,6 +124,11 @@ EglContext::EglContext(EglDisplay *display, EGLConfig config, ::EGLContext conte
         if (qgetenv("KWIN_PERSISTENT_VBO") != QByteArrayLiteral("0")) {
             m_streamingBuffer->setPersistent();
         }
+        // large enough for a couple of full HD frames in flight, the memory is only
+        // allocated once something is uploaded
+        if (hasVersion(Version(3, 0)) && qgetenv("KWIN_GL_PBO_UPLOADS") != QByteArrayLiteral("0")) {
+            m_pixelUnpackBuffer = std::make_unique<GLPixelUnpackBuffer>(32 * 1024 * 1024);
+        }
     }
 }
 
@@ -117,7 +137,9 @@ EglContext::~EglContext()
     makeCurrent();
     m_shaderManager.reset();
     m_streamingBuffer.reset();
+    m_pixelUnpackBuffer.reset();
     m_indexBuffer.reset();
+    m_gpuProfiler.reset();
     doneCurrent();
     eglDestroyContext(m_display->handle(), m_handle);
 }
@@ -362,6 +384,16 @@ bool EglContext::supportsPackInvert() const
     return m_supportsPackInvert;
 }
 
+bool EglContext::supportsProgramBinaries() const
+{
+    return m_supportsProgramBinaries;
+}
+
+bool EglContext::supportsComputeShaders() const
+{
+    return m_supportsComputeShaders;
+}
+
 ShaderManager *EglContext::shaderManager() const
 {
     return m_shaderManager.get();
@@ -372,11 +404,24 @@ GLVertexBuffer *EglContext::streamingVbo() const
     return m_streamingBuffer.get();
 }
 
+GLPixelUnpackBuffer *EglContext::pixelUnpackBuffer() const
+{
+    return m_pixelUnpackBuffer.get();
+}
+
 IndexBuffer *EglContext::indexBuffer() const
 {
     return m_indexBuffer.get();
 }
 
+GLGpuProfiler *EglContext::gpuProfiler()
+{
+    if (!m_gpuProfiler && m_supportsTimerQueries) {
+        m_gpuProfiler = std::make_unique<GLGpuProfiler>();
+    }
+    return m_gpuProfiler.get();
+}
+
 GLPlatform *EglContext::glPlatform() const
 {
     return m_glPlatform.get();
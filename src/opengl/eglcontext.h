@@ -25,6 +25,8 @@ class ShaderManager;
 class IndexBuffer;
 class GLPlatform;
 class GLFramebuffer;
+class GLPixelUnpackBuffer;
+class GLGpuProfiler;
 struct DmaBufAttributes;
 
 // GL_ARB_robustness / GL_EXT_robustness
@@ -73,9 +75,21 @@ public:
     bool haveBufferStorage() const;
     bool haveSyncFences() const;
     bool supportsPackInvert() const;
+    bool supportsProgramBinaries() const;
+    bool supportsComputeShaders() const;
     ShaderManager *shaderManager() const;
     GLVertexBuffer *streamingVbo() const;
+    /**
+     * @returns the staging buffer for asynchronous texture uploads, or @c nullptr
+     *          if the context doesn't support persistently mapped buffers
+     */
+    GLPixelUnpackBuffer *pixelUnpackBuffer() const;
     IndexBuffer *indexBuffer() const;
+    /**
+     * @returns the profiler for the GPU time of frames, or @c nullptr
+     *          if the context doesn't support timer queries
+     */
+    GLGpuProfiler *gpuProfiler();
     GLPlatform *glPlatform() const;
     QSet<QByteArray> openglExtensions() const;
 
@@ -148,6 +162,8 @@ private:
     const bool m_haveSyncFences;
     const bool m_supportsIndexedQuads;
     const bool m_supportsPackInvert;
+    const bool m_supportsProgramBinaries;
+    const bool m_supportsComputeShaders;
     const std::unique_ptr<GLPlatform> m_glPlatform;
     glGetGraphicsResetStatus_func m_glGetGraphicsResetStatus = nullptr;
     glReadnPixels_func m_glReadnPixels = nullptr;
@@ -159,7 +175,9 @@ private:
     const EGLConfig m_config;
     std::unique_ptr<ShaderManager> m_shaderManager;
     std::unique_ptr<GLVertexBuffer> m_streamingBuffer;
+    std::unique_ptr<GLPixelUnpackBuffer> m_pixelUnpackBuffer;
     std::unique_ptr<IndexBuffer> m_indexBuffer;
+    std::unique_ptr<GLGpuProfiler> m_gpuProfiler;
     QStack<GLFramebuffer *> m_fbos;
     uint32_t m_vao = 0;
     bool m_failed = false;
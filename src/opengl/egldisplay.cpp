@@ -17,7 +17,9 @@
 #include "utils/envvar.h"
 
 #include <QOpenGLContext>
+#include <QSet>
 #include <drm_fourcc.h>
+#include <sys/stat.h>
 
 #ifndef EGL_DRM_RENDER_NODE_FILE_EXT
 #define EGL_DRM_RENDER_NODE_FILE_EXT 0x3377
@@ -133,7 +135,12 @@ EglDisplay::EglDisplay(::EGLDisplay display, const QList<QByteArray> &extensions
 
 EglDisplay::~EglDisplay()
 {
-    for (const auto &image : m_importCache) {
+    // buffers with the same memory share their image
+    QSet<EGLImageKHR> images;
+    for (const auto &image : std::as_const(m_importCache)) {
+        images.insert(image);
+    }
+    for (const auto &image : std::as_const(images)) {
         destroyImage(image);
     }
     eglTerminate(m_handle);
@@ -387,6 +394,71 @@ void EglDisplay::destroyImage(EGLImageKHR image) const
 
 static const auto s_disableUdmabuf = environmentVariableBoolValue("KWIN_DISABLE_UDMABUF_IMPORT");
 
+std::optional<EglDisplay::DmaBufIdentity> EglDisplay::identify(const DmaBufAttributes &dmabuf, int plane, uint32_t format, const QSize &size)
+{
+    DmaBufIdentity identity{
+        .format = format,
+        .modifier = dmabuf.modifier,
+        .size = size,
+        .plane = plane,
+    };
+    for (int i = 0; i < dmabuf.planeCount; i++) {
+        struct stat info;
+        if (fstat(dmabuf.fd[i].get(), &info) != 0) {
+            return std::nullopt;
+        }
+        if (i == 0) {
+            identity.device = info.st_dev;
+        } else if (info.st_dev != identity.device) {
+            return std::nullopt;
+        }
+        identity.inodes[i] = info.st_ino;
+        identity.offsets[i] = dmabuf.offset[i];
+        identity.pitches[i] = dmabuf.pitch[i];
+    }
+    return identity;
+}
+
+EGLImageKHR EglDisplay::importShared(GraphicsBuffer *buffer, int plane, const std::function<EGLImageKHR()> &import, const std::optional<DmaBufIdentity> &identity)
+{
+    EGLImageKHR image = EGL_NO_IMAGE;
+    if (identity) {
+        if (auto it = m_sharedImages.find(*identity); it != m_sharedImages.end()) {
+            it->users++;
+            image = it->image;
+        }
+    }
+    if (image == EGL_NO_IMAGE) {
+        image = import();
+        if (identity && image != EGL_NO_IMAGE) {
+            m_sharedImages.insert(*identity, SharedImage{
+                                                 .image = image,
+                                                 .users = 1,
+                                             });
+        }
+    }
+
+    const std::pair key(buffer, plane);
+    m_importCache[key] = image;
+    connect(buffer, &QObject::destroyed, this, [this, key, identity]() {
+        releaseShared(m_importCache.take(key), identity);
+    });
+    return image;
+}
+
+void EglDisplay::releaseShared(EGLImageKHR image, const std::optional<DmaBufIdentity> &identity)
+{
+    if (identity) {
+        if (auto it = m_sharedImages.find(*identity); it != m_sharedImages.end() && it->image == image) {
+            if (--it->users > 0) {
+                return;
+            }
+            m_sharedImages.erase(it);
+        }
+    }
+    destroyImage(image);
+}
+
 EGLImageKHR EglDisplay::importBufferAsImage(GraphicsBuffer *buffer)
 {
     Q_ASSERT(buffer->dmabufAttributes() || buffer->shmAttributes());
@@ -397,19 +469,21 @@ EGLImageKHR EglDisplay::importBufferAsImage(GraphicsBuffer *buffer)
         return *it;
     }
 
-    EGLImageKHR image = EGL_NO_IMAGE;
-    if (buffer->dmabufAttributes()) {
-        image = importDmaBufAsImage(*buffer->dmabufAttributes());
-        // On Nvidia, sampling from udmabuf just results in black,
-        // and on i915 there are glitches on some systems
-    } else if (buffer->udmabufAttributes() && (!m_drmDevice || !s_disableUdmabuf.value_or(m_drmDevice->isNvidia() || m_drmDevice->isI915()))) {
-        image = importDmaBufAsImage(*buffer->udmabufAttributes());
+    if (const DmaBufAttributes *dmabuf = buffer->dmabufAttributes()) {
+        return importShared(buffer, 0, [this, dmabuf]() {
+            return importDmaBufAsImage(*dmabuf);
+        }, identify(*dmabuf, -1, dmabuf->format, QSize(dmabuf->width, dmabuf->height)));
     }
-    m_importCache[key] = image;
-    connect(buffer, &QObject::destroyed, this, [this, key]() {
-        destroyImage(m_importCache.take(key));
-    });
-    return image;
+    // On Nvidia, sampling from udmabuf just results in black,
+    // and on i915 there are glitches on some systems
+    if (buffer->udmabufAttributes() && (!m_drmDevice || !s_disableUdmabuf.value_or(m_drmDevice->isNvidia() || m_drmDevice->isI915()))) {
+        return importShared(buffer, 0, [this, buffer]() {
+            return importDmaBufAsImage(*buffer->udmabufAttributes());
+        }, std::nullopt);
+    }
+    return importShared(buffer, 0, []() {
+        return EGL_NO_IMAGE;
+    }, std::nullopt);
 }
 
 EGLImageKHR EglDisplay::importBufferAsImage(GraphicsBuffer *buffer, int plane, int format, const QSize &size)
@@ -422,12 +496,10 @@ EGLImageKHR EglDisplay::importBufferAsImage(GraphicsBuffer *buffer, int plane, i
         return *it;
     }
 
-    EGLImageKHR image = importDmaBufAsImage(*buffer->dmabufAttributes(), plane, format, size);
-    m_importCache[key] = image;
-    connect(buffer, &QObject::destroyed, this, [this, key]() {
-        destroyImage(m_importCache.take(key));
-    });
-    return image;
+    const DmaBufAttributes *dmabuf = buffer->dmabufAttributes();
+    return importShared(buffer, plane, [this, dmabuf, plane, format, size]() {
+        return importDmaBufAsImage(*dmabuf, plane, format, size);
+    }, identify(*dmabuf, plane, format, size));
 }
 
 }
@@ -16,7 +16,10 @@
 #include <QList>
 #include <QObject>
 #include <QSize>
+#include <array>
 #include <epoxy/egl.h>
+#include <functional>
+#include <optional>
 #include <sys/types.h>
 
 namespace KWin
@@ -70,6 +73,37 @@ private:
     Formats queryImportFormats() const;
     QString determineRenderNode() const;
 
+    /**
+     * Identifies the memory of a dmabuf, so that the same memory that is wrapped in
+     * different buffers, for example because a client creates a new wl_buffer for
+     * it, only gets imported once.
+     */
+    struct DmaBufIdentity
+    {
+        dev_t device = 0;
+        std::array<ino_t, 4> inodes{};
+        std::array<uint32_t, 4> offsets{};
+        std::array<uint32_t, 4> pitches{};
+        uint32_t format = 0;
+        uint64_t modifier = 0;
+        QSize size;
+        int plane = -1;
+
+        bool operator==(const DmaBufIdentity &other) const = default;
+        friend size_t qHash(const DmaBufIdentity &identity, size_t seed = 0)
+        {
+            return qHashMulti(seed, identity.inodes[0], identity.offsets[0], identity.format, identity.modifier, identity.plane);
+        }
+    };
+    struct SharedImage
+    {
+        EGLImageKHR image;
+        int users;
+    };
+    static std::optional<DmaBufIdentity> identify(const DmaBufAttributes &dmabuf, int plane, uint32_t format, const QSize &size);
+    EGLImageKHR importShared(GraphicsBuffer *buffer, int plane, const std::function<EGLImageKHR()> &import, const std::optional<DmaBufIdentity> &identity);
+    void releaseShared(EGLImageKHR image, const std::optional<DmaBufIdentity> &identity);
+
     const ::EGLDisplay m_handle;
     const QList<QByteArray> m_clientExtensions;
     const QList<QByteArray> m_extensions;
@@ -93,6 +127,7 @@ private:
     } m_functions;
 
     QHash<std::pair<GraphicsBuffer *, int>, EGLImageKHR> m_importCache;
+    QHash<DmaBufIdentity, SharedImage> m_sharedImages;
 };
 
 }
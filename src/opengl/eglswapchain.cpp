@@ -34,7 +34,11 @@ EglSwapchainSlot::~EglSwapchainSlot()
     m_framebuffer.reset();
     m_texture.reset();
     m_releasePoint->setBuffer(m_buffer);
-    m_buffer->drop();
+    if (m_allocator) {
+        m_allocator->recycle(m_buffer, m_options);
+    } else {
+        m_buffer->drop();
+    }
 }
 
 GraphicsBuffer *EglSwapchainSlot::buffer() const
@@ -99,6 +103,8 @@ EglSwapchain::EglSwapchain(GraphicsBufferAllocator *allocator, EglContext *conte
     , m_options(options)
     , m_slots({seed})
 {
+    seed->m_allocator = m_allocator;
+    seed->m_options = m_options;
 }
 
 EglSwapchain::~EglSwapchain()
@@ -134,7 +140,10 @@ std::shared_ptr<EglSwapchainSlot> EglSwapchain::acquire()
         return *it;
     }
 
-    GraphicsBuffer *buffer = m_allocator->allocate(m_options);
+    GraphicsBuffer *buffer = m_allocator->reuse(m_options);
+    if (!buffer) {
+        buffer = m_allocator->allocate(m_options);
+    }
     if (!buffer) {
         qCWarning(KWIN_OPENGL) << "Failed to allocate an egl gbm swapchain graphics buffer";
         return nullptr;
@@ -144,6 +153,8 @@ std::shared_ptr<EglSwapchainSlot> EglSwapchain::acquire()
     if (!slot) {
         return nullptr;
     }
+    slot->m_allocator = m_allocator;
+    slot->m_options = m_options;
     m_slots.append(slot);
     return slot;
 }
@@ -174,7 +185,10 @@ std::shared_ptr<EglSwapchain> EglSwapchain::create(GraphicsBufferAllocator *allo
     }
 
     // The seed graphics buffer is used to fixate modifiers.
-    GraphicsBuffer *seed = allocator->allocate(options);
+    GraphicsBuffer *seed = allocator->reuse(options);
+    if (!seed) {
+        seed = allocator->allocate(options);
+    }
     if (!seed) {
         return nullptr;
     }
@@ -52,6 +52,8 @@ private:
     std::shared_ptr<GLTexture> m_texture;
     int m_age = 0;
     std::shared_ptr<GraphicsBufferReleasePoint> m_releasePoint;
+    GraphicsBufferAllocator *m_allocator = nullptr;
+    GraphicsBufferOptions m_options;
     friend class EglSwapchain;
 };
 
@@ -0,0 +1,193 @@
+/*
+    KWin - the KDE window manager
+    This file is part of the KDE project.
+
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "glgpuprofiler.h"
+#include "opengl/eglcontext.h"
+
+#include <algorithm>
+
+namespace KWin
+{
+
+// results usually become available one or two frames later, if they take longer
+// than this the GPU is struggling anyways and older frames get dropped
+static constexpr size_t s_maxPendingFrames = 4;
+
+int GLGpuProfiler::s_users = 0;
+QHash<QString, QList<GLGpuProfiler::Section>> GLGpuProfiler::s_lastFrames;
+
+GLGpuProfiler::~GLGpuProfiler()
+{
+    if (!m_queries.empty()) {
+        glDeleteQueries(m_queries.size(), m_queries.data());
+    }
+}
+
+GLGpuProfiler *GLGpuProfiler::current()
+{
+    if (!s_users) {
+        return nullptr;
+    }
+    EglContext *context = EglContext::currentContext();
+    return context ? context->gpuProfiler() : nullptr;
+}
+
+void GLGpuProfiler::addUser()
+{
+    s_users++;
+}
+
+void GLGpuProfiler::removeUser()
+{
+    Q_ASSERT(s_users > 0);
+    if (--s_users == 0) {
+        s_lastFrames.clear();
+    }
+}
+
+bool GLGpuProfiler::isEnabled()
+{
+    return s_users > 0;
+}
+
+QList<GLGpuProfiler::Section> GLGpuProfiler::lastFrame(const QString &name)
+{
+    return s_lastFrames.value(name);
+}
+
+QStringList GLGpuProfiler::frameNames()
+{
+    QStringList names = s_lastFrames.keys();
+    names.sort();
+    return names;
+}
+
+GLuint GLGpuProfiler::takeQuery()
+{
+    if (m_freeQueries.empty()) {
+        GLuint query = 0;
+        glGenQueries(1, &query);
+        m_queries.push_back(query);
+        return query;
+    }
+    const GLuint query = m_freeQueries.back();
+    m_freeQueries.pop_back();
+    return query;
+}
+
+void GLGpuProfiler::release(PendingFrame &frame)
+{
+    for (const PendingSection &section : frame.sections) {
+        m_freeQueries.push_back(section.begin);
+        m_freeQueries.push_back(section.end);
+    }
+    frame.sections.clear();
+}
+
+void GLGpuProfiler::resolveFrames()
+{
+    // the queries finish in the order they were issued in, so it's enough to check
+    // the last one of a frame to know whether the results of the whole frame are available
+    while (!m_pendingFrames.empty()) {
+        PendingFrame &frame = m_pendingFrames.front();
+        if (!frame.sections.empty()) {
+            GLuint available = GL_FALSE;
+            glGetQueryObjectuiv(frame.lastQuery, GL_QUERY_RESULT_AVAILABLE, &available);
+            if (!available) {
+                return;
+            }
+            QList<Section> sections;
+            sections.reserve(frame.sections.size());
+            for (const PendingSection &section : frame.sections) {
+                GLint64 begin = 0;
+                GLint64 end = 0;
+                glGetQueryObjecti64v(section.begin, GL_QUERY_RESULT, &begin);
+                glGetQueryObjecti64v(section.end, GL_QUERY_RESULT, &end);
+                sections.push_back(Section{
+                    .name = section.name,
+                    .depth = section.depth,
+                    .duration = std::max(std::chrono::nanoseconds(end - begin), std::chrono::nanoseconds::zero()),
+                });
+            }
+            s_lastFrames[frame.name] = sections;
+            release(frame);
+        }
+        m_pendingFrames.pop_front();
+    }
+}
+
+void GLGpuProfiler::beginFrame(const QString &name)
+{
+    Q_ASSERT(!m_recording);
+    resolveFrames();
+    while (m_pendingFrames.size() >= s_maxPendingFrames) {
+        release(m_pendingFrames.front());
+        m_pendingFrames.pop_front();
+    }
+    m_pendingFrames.push_back(PendingFrame{
+        .name = name,
+        .sections = {},
+        .lastQuery = 0,
+    });
+    m_recording = true;
+}
+
+void GLGpuProfiler::endFrame()
+{
+    Q_ASSERT(m_recording);
+    while (!m_openSections.empty()) {
+        endSection();
+    }
+    m_recording = false;
+}
+
+void GLGpuProfiler::beginSection(const QString &name)
+{
+    if (!m_recording) {
+        return;
+    }
+    PendingFrame &frame = m_pendingFrames.back();
+    const GLuint begin = takeQuery();
+    glQueryCounter(begin, GL_TIMESTAMP);
+    m_openSections.push_back(frame.sections.size());
+    frame.sections.push_back(PendingSection{
+        .name = name,
+        .depth = int(m_openSections.size()) - 1,
+        .begin = begin,
+        .end = 0,
+    });
+}
+
+void GLGpuProfiler::endSection()
+{
+    if (!m_recording || m_openSections.empty()) {
+        return;
+    }
+    PendingSection &section = m_pendingFrames.back().sections[m_openSections.back()];
+    m_openSections.pop_back();
+    section.end = takeQuery();
+    glQueryCounter(section.end, GL_TIMESTAMP);
+    m_pendingFrames.back().lastQuery = section.end;
+}
+
+GLGpuProfilerScope::GLGpuProfilerScope(const QString &name)
+    : m_profiler(GLGpuProfiler::current())
+{
+    if (m_profiler) {
+        m_profiler->beginSection(name);
+    }
+}
+
+GLGpuProfilerScope::~GLGpuProfilerScope()
+{
+    if (m_profiler) {
+        m_profiler->endSection();
+    }
+}
+
+}
@@ -0,0 +1,118 @@
+/*
+    KWin - the KDE window manager
+    This file is part of the KDE project.
+
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+
+#include "kwin_export.h"
+
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+#include <chrono>
+#include <deque>
+#include <epoxy/gl.h>
+#include <vector>
+
+namespace KWin
+{
+
+/**
+ * The GLGpuProfiler class measures how much GPU time the sections of a frame take, for
+ * example the background, every window and the passes of the effects. Sections can be
+ * nested, the time of a section includes the time of the sections inside of it.
+ *
+ * The sections are measured with timestamp queries. Their results are only read once the
+ * GPU is done with them, usually a few frames later, so profiling never stalls rendering.
+ *
+ * Profiling costs some GPU time itself, so it's only done while something is interested
+ * in the results, see addUser()
+ */
+class KWIN_EXPORT GLGpuProfiler
+{
+public:
+    struct Section
+    {
+        QString name;
+        int depth;
+        std::chrono::nanoseconds duration;
+    };
+
+    ~GLGpuProfiler();
+
+    /**
+     * Starts recording the sections of the frame identified by @a name. The context
+     * of the profiler has to be current
+     */
+    void beginFrame(const QString &name);
+    void endFrame();
+
+    void beginSection(const QString &name);
+    void endSection();
+
+    /**
+     * @returns the profiler of the current context, or @c nullptr if nothing
+     *          is interested in the results or timer queries aren't supported
+     */
+    static GLGpuProfiler *current();
+
+    static void addUser();
+    static void removeUser();
+    static bool isEnabled();
+
+    /**
+     * @returns the sections of the last frame with the given @a name whose
+     *          results are available, from the outermost to the innermost ones
+     */
+    static QList<Section> lastFrame(const QString &name);
+    static QStringList frameNames();
+
+private:
+    struct PendingSection
+    {
+        QString name;
+        int depth;
+        GLuint begin;
+        GLuint end;
+    };
+    struct PendingFrame
+    {
+        QString name;
+        std::vector<PendingSection> sections;
+        GLuint lastQuery = 0;
+    };
+
+    GLuint takeQuery();
+    void release(PendingFrame &frame);
+    void resolveFrames();
+
+    std::vector<GLuint> m_queries;
+    std::vector<GLuint> m_freeQueries;
+    std::deque<PendingFrame> m_pendingFrames;
+    std::vector<size_t> m_openSections;
+    bool m_recording = false;
+
+    static int s_users;
+    static QHash<QString, QList<Section>> s_lastFrames;
+};
+
+/**
+ * Measures the GPU time of a section for as long as the object exists
+ */
+class KWIN_EXPORT GLGpuProfilerScope
+{
+public:
+    explicit GLGpuProfilerScope(const QString &name);
+    ~GLGpuProfilerScope();
+
+private:
+    GLGpuProfiler *const m_profiler;
+};
+
+}
@@ -0,0 +1,81 @@
+/*
+    KWin - the KDE window manager
+    This file is part of the KDE project.
+
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "opengl/glpixelpackbuffer.h"
+#include "core/rect.h"
+#include "opengl/eglcontext.h"
+#include "opengl/eglnativefence.h"
+
+namespace KWin
+{
+
+GLPixelPackBuffer::GLPixelPackBuffer(GLuint buffer, const QSize &size, FileDescriptor &&fence)
+    : m_buffer(buffer)
+    , m_size(size)
+    , m_fence(std::move(fence))
+{
+}
+
+GLPixelPackBuffer::~GLPixelPackBuffer()
+{
+    // This also unmaps the buffer
+    glDeleteBuffers(1, &m_buffer);
+}
+
+std::unique_ptr<GLPixelPackBuffer> GLPixelPackBuffer::readPixels(EglContext *context, const Rect &rect, GLenum format)
+{
+    if (rect.isEmpty()) {
+        return nullptr;
+    }
+    const GLsizei bufferSize = rect.width() * rect.height() * 4;
+
+    GLuint buffer = 0;
+    glGenBuffers(1, &buffer);
+    if (!buffer) {
+        return nullptr;
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, buffer);
+    glBufferData(GL_PIXEL_PACK_BUFFER, bufferSize, nullptr, GL_STREAM_READ);
+    context->glReadnPixels(rect.x(), rect.y(), rect.width(), rect.height(), format, GL_UNSIGNED_BYTE, bufferSize, nullptr);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    EGLNativeFence fence(context->displayObject());
+    return std::unique_ptr<GLPixelPackBuffer>(new GLPixelPackBuffer(buffer, rect.size(), fence.takeFileDescriptor()));
+}
+
+QSize GLPixelPackBuffer::size() const
+{
+    return m_size;
+}
+
+const FileDescriptor &GLPixelPackBuffer::fence() const
+{
+    return m_fence;
+}
+
+const uchar *GLPixelPackBuffer::map()
+{
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, m_buffer);
+    const auto data = static_cast<const uchar *>(glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, m_size.width() * m_size.height() * 4, GL_MAP_READ_BIT));
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    m_mapped = data;
+    return data;
+}
+
+void GLPixelPackBuffer::unmap()
+{
+    if (!m_mapped) {
+        return;
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, m_buffer);
+    glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    m_mapped = false;
+}
+
+} // namespace KWin
@@ -0,0 +1,68 @@
+/*
+    KWin - the KDE window manager
+    This file is part of the KDE project.
+
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+
+#include "kwin_export.h"
+#include "utils/filedescriptor.h"
+
+#include <QSize>
+#include <epoxy/gl.h>
+
+#include <memory>
+
+namespace KWin
+{
+
+class EglContext;
+class Rect;
+
+/**
+ * The GLPixelPackBuffer class reads back the pixels of a framebuffer without waiting for the GPU.
+ *
+ * glReadPixels() into a buffer bound to GL_PIXEL_PACK_BUFFER only queues the transfer. The
+ * pixels can be mapped once the fence that follows it has signaled, waiting for the file
+ * descriptor of the fence with a QSocketNotifier avoids stalling the compositor.
+ */
+class KWIN_EXPORT GLPixelPackBuffer
+{
+public:
+    ~GLPixelPackBuffer();
+
+    /**
+     * Queues the read back of @a rect of the currently bound framebuffer. The pixels are
+     * read as 4 bytes in the given @a format, which is either GL_RGBA or GL_BGRA. Returns
+     * nullptr if no buffer could be created.
+     */
+    static std::unique_ptr<GLPixelPackBuffer> readPixels(EglContext *context, const Rect &rect, GLenum format);
+
+    QSize size() const;
+
+    /**
+     * Returns the file descriptor of a fence that signals once the pixels are available,
+     * or an invalid file descriptor if the platform has no native fences.
+     */
+    const FileDescriptor &fence() const;
+
+    /**
+     * Maps the pixels, rows go from the bottom to the top like in OpenGL. This blocks until
+     * the transfer is done if the fence hasn't signaled yet. Returns nullptr on failure.
+     */
+    const uchar *map();
+    void unmap();
+
+private:
+    GLPixelPackBuffer(GLuint buffer, const QSize &size, FileDescriptor &&fence);
+
+    const GLuint m_buffer;
+    const QSize m_size;
+    const FileDescriptor m_fence;
+    bool m_mapped = false;
+};
+
+} // namespace KWin
@@ -0,0 +1,152 @@
+/*
+    KWin - the KDE window manager
+    This file is part of the KDE project.
+
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "opengl/glpixelunpackbuffer.h"
+#include "utils/common.h"
+
+#include <algorithm>
+
+namespace KWin
+{
+
+// keep allocations aligned well enough for any pixel format and for fast memcpy
+static constexpr size_t s_alignment = 64;
+
+GLPixelUnpackBuffer::GLPixelUnpackBuffer(size_t capacity)
+    : m_capacity(capacity)
+{
+}
+
+GLPixelUnpackBuffer::~GLPixelUnpackBuffer()
+{
+    for (const Batch &batch : m_batches) {
+        if (batch.sync) {
+            glDeleteSync(batch.sync);
+        }
+    }
+    if (m_buffer) {
+        // This also unmaps the buffer
+        glDeleteBuffers(1, &m_buffer);
+    }
+}
+
+size_t GLPixelUnpackBuffer::capacity() const
+{
+    return m_capacity;
+}
+
+bool GLPixelUnpackBuffer::createBuffer()
+{
+    const GLbitfield access = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+    glGenBuffers(1, &m_buffer);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_buffer);
+    glBufferStorage(GL_PIXEL_UNPACK_BUFFER, m_capacity, nullptr, access);
+    m_map = static_cast<uint8_t *>(glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, m_capacity, access));
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    if (!m_map) {
+        qCWarning(KWIN_OPENGL) << "Failed to map a persistent pixel unpack buffer, falling back to regular texture uploads";
+        glDeleteBuffers(1, &m_buffer);
+        m_buffer = 0;
+        m_failed = true;
+        return false;
+    }
+    return true;
+}
+
+void GLPixelUnpackBuffer::retireBatches()
+{
+    while (!m_batches.empty() && m_batches.front().sync) {
+        GLint value;
+        glGetSynciv(m_batches.front().sync, GL_SYNC_STATUS, 1, nullptr, &value);
+        if (value != GL_SIGNALED) {
+            break;
+        }
+        glDeleteSync(m_batches.front().sync);
+        m_batches.pop_front();
+    }
+    if (m_batches.empty()) {
+        m_head = 0;
+    }
+}
+
+std::optional<GLPixelUnpackBuffer::Allocation> GLPixelUnpackBuffer::allocate(size_t size)
+{
+    if (m_failed || size == 0 || size > m_capacity) {
+        return std::nullopt;
+    }
+    if (!m_map && !createBuffer()) {
+        return std::nullopt;
+    }
+
+    retireBatches();
+
+    // The memory that is still in use by the GPU starts at the oldest batch and ends at
+    // the head, possibly wrapping around the end of the buffer.
+    std::optional<uintptr_t> offset;
+    if (m_batches.empty()) {
+        offset = 0;
+    } else {
+        const uintptr_t tail = m_batches.front().begin;
+        if (m_head > tail) {
+            if (m_head + size <= m_capacity) {
+                offset = m_head;
+            } else if (size <= tail) {
+                offset = 0;
+            }
+        } else if (m_head + size <= tail) {
+            offset = m_head;
+        }
+    }
+    if (!offset) {
+        return std::nullopt;
+    }
+
+    if (m_batches.empty() || m_batches.back().sync) {
+        m_batches.push_back(Batch{
+            .begin = *offset,
+        });
+    }
+    m_head = std::min((*offset + size + s_alignment - 1) & ~(s_alignment - 1), m_capacity);
+
+    return Allocation{
+        .data = m_map + *offset,
+        .offset = *offset,
+    };
+}
+
+void GLPixelUnpackBuffer::endUploads()
+{
+    if (m_batches.empty() || m_batches.back().sync) {
+        return;
+    }
+    m_batches.back().sync = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    if (!m_batches.back().sync) {
+        // without a fence, there's no way to tell when the memory can be reused
+        glFinish();
+        m_batches.pop_back();
+        for (const Batch &batch : m_batches) {
+            glDeleteSync(batch.sync);
+        }
+        m_batches.clear();
+        m_head = 0;
+    }
+}
+
+void GLPixelUnpackBuffer::bind()
+{
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_buffer);
+}
+
+void GLPixelUnpackBuffer::unbind()
+{
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+}
+
+} // namespace KWin
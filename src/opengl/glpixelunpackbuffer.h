@@ -0,0 +1,79 @@
+/*
+    KWin - the KDE window manager
+    This file is part of the KDE project.
+
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+
+#include <epoxy/gl.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <optional>
+
+namespace KWin
+{
+
+/**
+ * The GLPixelUnpackBuffer class is a persistently mapped ring buffer that is used to stage
+ * pixel data for texture uploads.
+ *
+ * Pixel data is copied into the buffer and glTexSubImage2D() then sources it from the
+ * GL_PIXEL_UNPACK_BUFFER binding, so the driver can do the actual transfer asynchronously
+ * instead of copying it out of client memory before glTexSubImage2D() returns. Each batch
+ * of uploads is guarded by a fence, the memory is not reused until the GPU is done with it.
+ */
+class GLPixelUnpackBuffer
+{
+public:
+    struct Allocation
+    {
+        void *data;
+        uintptr_t offset;
+    };
+
+    explicit GLPixelUnpackBuffer(size_t capacity);
+    ~GLPixelUnpackBuffer();
+
+    size_t capacity() const;
+
+    /**
+     * Allocates @a size bytes in the buffer. Returns std::nullopt if there's not enough idle
+     * space, in which case the caller should upload the data directly from client memory.
+     * The returned offset is meant to be passed as the pixel data pointer to glTexSubImage2D()
+     * while the buffer is bound.
+     */
+    std::optional<Allocation> allocate(size_t size);
+
+    /**
+     * Inserts a fence that guards all allocations made since the last call to endUploads().
+     * This must be called after the commands consuming the allocations have been issued.
+     */
+    void endUploads();
+
+    void bind();
+    void unbind();
+
+private:
+    struct Batch
+    {
+        uintptr_t begin;
+        GLsync sync = nullptr;
+    };
+
+    bool createBuffer();
+    void retireBatches();
+
+    GLuint m_buffer = 0;
+    uint8_t *m_map = nullptr;
+    const size_t m_capacity;
+    uintptr_t m_head = 0;
+    std::deque<Batch> m_batches;
+    bool m_failed = false;
+};
+
+} // namespace KWin
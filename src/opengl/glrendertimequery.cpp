@@ -90,4 +90,12 @@ std::optional<RenderTimeSpan> GLRenderTimeQuery::query()
     };
 }
 
+std::chrono::nanoseconds GLRenderTimeQuery::gpuTime() const
+{
+    if (!m_gpuProbe.query) {
+        return std::chrono::nanoseconds::zero();
+    }
+    return std::max(m_gpuProbe.end - m_gpuProbe.start, std::chrono::nanoseconds::zero());
+}
+
 }
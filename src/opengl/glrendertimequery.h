@@ -33,6 +33,7 @@ public:
      * fetches the result of the query. If rendering is not done yet, this will block!
      */
     std::optional<RenderTimeSpan> query() override;
+    std::chrono::nanoseconds gpuTime() const override;
 
 private:
     const std::weak_ptr<EglContext> m_context;
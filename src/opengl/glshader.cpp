@@ -68,7 +68,7 @@ bool GLShader::link()
     return true;
 }
 
-std::optional<QByteArray> GLShader::preprocess(const QByteArray &src, GLenum shaderType, int recursionDepth) const
+std::optional<QByteArray> GLShader::preprocess(const QByteArray &src, GLenum shaderType, int recursionDepth)
 {
     recursionDepth++;
     if (recursionDepth > 10) {
@@ -83,7 +83,12 @@ std::optional<QByteArray> GLShader::preprocess(const QByteArray &src, GLenum sha
     const bool coreShader = context->glslVersion() >= Version(3, 0);
 
     if (recursionDepth == 1) {
-        if (coreShader) {
+        if (shaderType == GL_COMPUTE_SHADER) {
+            ret.append("#version 310 es\n");
+            ret.append("precision highp float;\n");
+            ret.append("precision highp sampler2D;\n");
+            ret.append("precision highp image2D;\n");
+        } else if (coreShader) {
             ret.append("#version 300 es\n");
             ret.append("precision highp float;\n");
             ret.append("precision highp sampler2D;\n");
@@ -167,7 +172,7 @@ bool GLShader::compile(GLuint program, GLenum shaderType, const QByteArray &sour
     glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
 
     if (status == 0) {
-        const char *typeName = (shaderType == GL_VERTEX_SHADER ? "vertex" : "fragment");
+        const char *typeName = shaderType == GL_VERTEX_SHADER ? "vertex" : (shaderType == GL_COMPUTE_SHADER ? "compute" : "fragment");
         qCCritical(KWIN_OPENGL) << "Failed to compile" << typeName << "shader:"
                                 << "\n"
                                 << log.data();
@@ -211,6 +216,39 @@ bool GLShader::load(const QByteArray &vertexSource, const QByteArray &fragmentSo
     return true;
 }
 
+bool GLShader::loadCompute(const QByteArray &computeSource)
+{
+    return compile(m_program, GL_COMPUTE_SHADER, computeSource);
+}
+
+bool GLShader::loadBinary(GLenum format, const QByteArray &binary)
+{
+    glProgramBinary(m_program, format, binary.constData(), binary.size());
+
+    int status;
+    glGetProgramiv(m_program, GL_LINK_STATUS, &status);
+    return status != 0;
+}
+
+std::optional<std::pair<GLenum, QByteArray>> GLShader::programBinary() const
+{
+    GLint length = 0;
+    glGetProgramiv(m_program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) {
+        return std::nullopt;
+    }
+
+    QByteArray binary(length, Qt::Uninitialized);
+    GLenum format = 0;
+    glGetProgramBinary(m_program, length, &length, &format, binary.data());
+    if (length <= 0) {
+        return std::nullopt;
+    }
+    binary.truncate(length);
+
+    return std::make_pair(format, binary);
+}
+
 void GLShader::bindAttributeLocation(const char *name, int index)
 {
     glBindAttribLocation(m_program, index, name);
@@ -509,7 +547,12 @@ static bool s_disableTonemapping = qEnvironmentVariableIntValue("KWIN_DISABLE_TO
 
 void GLShader::setColorspaceUniforms(const std::shared_ptr<ColorDescription> &src, const std::shared_ptr<ColorDescription> &dst, RenderingIntent intent)
 {
-    setUniform(Mat4Uniform::ColorimetryTransformation, src->toOther(*dst, intent));
+    setColorspaceUniforms(src, dst, intent, src->toOther(*dst, intent));
+}
+
+void GLShader::setColorspaceUniforms(const std::shared_ptr<ColorDescription> &src, const std::shared_ptr<ColorDescription> &dst, RenderingIntent intent, const QMatrix4x4 &colorimetryTransformation)
+{
+    setUniform(Mat4Uniform::ColorimetryTransformation, colorimetryTransformation);
     setUniform(IntUniform::SourceNamedTransferFunction, src->transferFunction().type);
     if (src->transferFunction().type == TransferFunction::BT1886) {
         setUniform(Vec2Uniform::SourceTransferFunctionParams, QVector2D(src->transferFunction().bt1886B(), src->transferFunction().bt1886A()));
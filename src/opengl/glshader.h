@@ -18,6 +18,8 @@
 #include <QVector2D>
 #include <QVector3D>
 #include <epoxy/gl.h>
+#include <optional>
+#include <utility>
 
 namespace KWin
 {
@@ -145,10 +147,22 @@ public:
     bool setUniform(ColorUniform uniform, const QColor &value);
 
     void setColorspaceUniforms(const std::shared_ptr<ColorDescription> &src, const std::shared_ptr<ColorDescription> &dst, RenderingIntent intent);
+    /**
+     * Same as above, but with a colorimetry transformation that has been computed
+     * with ColorDescription::toOther() before, to avoid computing it again.
+     */
+    void setColorspaceUniforms(const std::shared_ptr<ColorDescription> &src, const std::shared_ptr<ColorDescription> &dst, RenderingIntent intent, const QMatrix4x4 &colorimetryTransformation);
 
 protected:
     bool load(const QByteArray &vertexSource, const QByteArray &fragmentSource);
-    std::optional<QByteArray> preprocess(const QByteArray &src, GLenum shaderType, int recursionDepth = 0) const;
+    bool loadCompute(const QByteArray &computeSource);
+    /**
+     * Loads a program binary that has been previously retrieved with programBinary(). Returns
+     * false if the driver rejects the binary, e.g. because it has been updated in the meantime.
+     */
+    bool loadBinary(GLenum format, const QByteArray &binary);
+    std::optional<std::pair<GLenum, QByteArray>> programBinary() const;
+    static std::optional<QByteArray> preprocess(const QByteArray &src, GLenum shaderType, int recursionDepth = 0);
     bool compile(GLuint program, GLenum shaderType, const QByteArray &sourceCode) const;
     void bind();
     void unbind();
@@ -0,0 +1,146 @@
+/*
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "glshadercache.h"
+#include "config-kwin.h"
+#include "eglcontext.h"
+#include "utils/common.h"
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+namespace KWin
+{
+
+static const quint32 s_binaryMagic = 0x4b57'5342; // "KWSB"
+
+std::unique_ptr<ShaderCache> ShaderCache::create(EglContext *context)
+{
+    if (qEnvironmentVariable("KWIN_GL_SHADER_CACHE") == QLatin1StringView("0")) {
+        return nullptr;
+    }
+    if (!context->supportsProgramBinaries()) {
+        return nullptr;
+    }
+
+    const QString cacheLocation = QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation);
+    if (cacheLocation.isEmpty()) {
+        return nullptr;
+    }
+    const QString directory = cacheLocation + QLatin1StringView("/kwin/shaders");
+    if (!QDir().mkpath(directory)) {
+        qCWarning(KWIN_OPENGL) << "Failed to create the shader cache directory" << directory;
+        return nullptr;
+    }
+
+    // Binaries are only valid for the same driver, and shader sources may change between versions.
+    QByteArray driver;
+    driver.append(context->vendor()).append('\n');
+    driver.append(context->renderer()).append('\n');
+    driver.append(context->openglVersionString()).append('\n');
+    driver.append(context->glslVersionString()).append('\n');
+    driver.append(KWIN_VERSION_STRING.data(), KWIN_VERSION_STRING.size());
+
+    return std::unique_ptr<ShaderCache>(new ShaderCache(directory, driver));
+}
+
+ShaderCache::ShaderCache(const QString &directory, const QByteArray &driver)
+    : m_directory(directory)
+    , m_driver(driver)
+{
+    QFile file(m_directory + QLatin1StringView("/traits"));
+    if (file.open(QIODevice::ReadOnly)) {
+        while (!file.atEnd()) {
+            bool ok = false;
+            const int traits = file.readLine().trimmed().toInt(&ok);
+            if (ok) {
+                m_usedTraits.append(ShaderTraits::fromInt(traits));
+            }
+        }
+    }
+}
+
+QByteArray ShaderCache::key(const QByteArray &vertexSource, const QByteArray &fragmentSource) const
+{
+    QCryptographicHash hash(QCryptographicHash::Sha256);
+    hash.addData(m_driver);
+    hash.addData(QByteArrayView("\0", 1));
+    hash.addData(vertexSource);
+    hash.addData(QByteArrayView("\0", 1));
+    hash.addData(fragmentSource);
+    return hash.result().toHex();
+}
+
+QString ShaderCache::filePath(const QByteArray &key) const
+{
+    return m_directory + QLatin1Char('/') + QString::fromLatin1(key) + QLatin1StringView(".bin");
+}
+
+std::optional<ShaderCache::Binary> ShaderCache::load(const QByteArray &key) const
+{
+    QFile file(filePath(key));
+    if (!file.open(QIODevice::ReadOnly)) {
+        return std::nullopt;
+    }
+
+    QDataStream stream(&file);
+    quint32 magic = 0;
+    quint32 format = 0;
+    QByteArray data;
+    stream >> magic >> format >> data;
+    if (stream.status() != QDataStream::Ok || magic != s_binaryMagic || data.isEmpty()) {
+        return std::nullopt;
+    }
+
+    return Binary{
+        .format = format,
+        .data = data,
+    };
+}
+
+void ShaderCache::store(const QByteArray &key, const Binary &binary)
+{
+    // Write the binary atomically, another kwin instance may be reading it at the same time.
+    QSaveFile file(filePath(key));
+    if (!file.open(QIODevice::WriteOnly)) {
+        return;
+    }
+
+    QDataStream stream(&file);
+    stream << s_binaryMagic << quint32(binary.format) << binary.data;
+    if (!file.commit()) {
+        qCWarning(KWIN_OPENGL) << "Failed to store a shader binary in" << file.fileName();
+    }
+}
+
+void ShaderCache::remove(const QByteArray &key)
+{
+    QFile::remove(filePath(key));
+}
+
+QList<ShaderTraits> ShaderCache::usedTraits() const
+{
+    return m_usedTraits;
+}
+
+void ShaderCache::addUsedTraits(ShaderTraits traits)
+{
+    if (m_usedTraits.contains(traits)) {
+        return;
+    }
+    m_usedTraits.append(traits);
+
+    QFile file(m_directory + QLatin1StringView("/traits"));
+    if (file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        file.write(QByteArray::number(traits.toInt()) + '\n');
+    }
+}
+
+} // namespace KWin
@@ -0,0 +1,70 @@
+/*
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include "glshadermanager.h"
+
+#include <QByteArray>
+#include <QList>
+#include <QString>
+
+#include <epoxy/gl.h>
+#include <memory>
+#include <optional>
+
+namespace KWin
+{
+
+class EglContext;
+
+/**
+ * The ShaderCache class stores linked program binaries on disk, so shaders don't need to be
+ * compiled again in later sessions.
+ *
+ * Binaries are stored in $XDG_CACHE_HOME/kwin/shaders, keyed by a hash of the driver
+ * identification and the preprocessed shader sources. The cache also remembers what trait
+ * combinations have been used, so the ShaderManager can load them at startup. The cache can
+ * be disabled by setting the KWIN_GL_SHADER_CACHE environment variable to 0.
+ */
+class ShaderCache
+{
+public:
+    struct Binary
+    {
+        GLenum format;
+        QByteArray data;
+    };
+
+    /**
+     * Creates a cache for the current OpenGL context. Returns nullptr if the context does not
+     * support program binaries or the cache is disabled.
+     */
+    static std::unique_ptr<ShaderCache> create(EglContext *context);
+
+    QByteArray key(const QByteArray &vertexSource, const QByteArray &fragmentSource) const;
+
+    std::optional<Binary> load(const QByteArray &key) const;
+    void store(const QByteArray &key, const Binary &binary);
+    /**
+     * Removes a binary that the driver rejected.
+     */
+    void remove(const QByteArray &key);
+
+    QList<ShaderTraits> usedTraits() const;
+    void addUsedTraits(ShaderTraits traits);
+
+private:
+    ShaderCache(const QString &directory, const QByteArray &driver);
+
+    QString filePath(const QByteArray &key) const;
+
+    const QString m_directory;
+    const QByteArray m_driver;
+    QList<ShaderTraits> m_usedTraits;
+};
+
+} // namespace KWin
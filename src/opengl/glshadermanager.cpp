@@ -12,6 +12,7 @@
 #include "eglcontext.h"
 #include "glplatform.h"
 #include "glshader.h"
+#include "glshadercache.h"
 #include "glvertexbuffer.h"
 #include "utils/common.h"
 
@@ -27,7 +28,9 @@ ShaderManager *ShaderManager::instance()
 }
 
 ShaderManager::ShaderManager()
+    : m_cache(ShaderCache::create(EglContext::currentContext()))
 {
+    prewarm();
 }
 
 ShaderManager::~ShaderManager()
@@ -84,6 +87,16 @@ std::unique_ptr<GLShader> ShaderManager::generateCustomShader(ShaderTraits trait
     const auto vertex = defines + (vertexSource.isEmpty() ? generateVertexSource(traits) : vertexSource);
     const auto fragment = defines + (fragmentSource.isEmpty() ? generateFragmentSource(traits) : fragmentSource);
 
+    QByteArray cacheKey;
+    if (m_cache) {
+        cacheKey = this->cacheKey(vertex, fragment);
+        if (!cacheKey.isEmpty()) {
+            if (auto shader = loadCachedShader(cacheKey)) {
+                return shader;
+            }
+        }
+    }
+
     auto shader = std::make_unique<GLShader>();
     if (!shader->load(vertex, fragment)) {
         return nullptr;
@@ -92,13 +105,75 @@ std::unique_ptr<GLShader> ShaderManager::generateCustomShader(ShaderTraits trait
     shader->bindAttributeLocation("position", VA_Position);
     shader->bindAttributeLocation("texcoord", VA_TexCoord);
 
+    if (!cacheKey.isEmpty() && EglContext::currentContext()->hasVersion(Version(3, 0))) {
+        glProgramParameteri(shader->m_program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
+
     if (!shader->link()) {
         return nullptr;
     }
 
+    if (!cacheKey.isEmpty()) {
+        if (const auto binary = shader->programBinary()) {
+            m_cache->store(cacheKey, ShaderCache::Binary{
+                                         .format = binary->first,
+                                         .data = binary->second,
+                                     });
+        }
+    }
+
+    return shader;
+}
+
+QByteArray ShaderManager::cacheKey(const QByteArray &vertexSource, const QByteArray &fragmentSource) const
+{
+    // The key is computed from the preprocessed sources so changes in included files are picked up.
+    const auto vertex = GLShader::preprocess(vertexSource, GL_VERTEX_SHADER);
+    const auto fragment = GLShader::preprocess(fragmentSource, GL_FRAGMENT_SHADER);
+    if (!vertex || !fragment) {
+        return QByteArray();
+    }
+    return m_cache->key(*vertex, *fragment);
+}
+
+std::unique_ptr<GLShader> ShaderManager::loadCachedShader(const QByteArray &cacheKey)
+{
+    const auto binary = m_cache->load(cacheKey);
+    if (!binary) {
+        return nullptr;
+    }
+
+    auto shader = std::make_unique<GLShader>();
+    if (!shader->loadBinary(binary->format, binary->data)) {
+        qCDebug(KWIN_OPENGL) << "Discarding a stale shader binary";
+        m_cache->remove(cacheKey);
+        return nullptr;
+    }
+
     return shader;
 }
 
+void ShaderManager::prewarm()
+{
+    if (!m_cache) {
+        return;
+    }
+
+    // Only shaders that are in the cache are loaded, loading binaries is cheap compared to
+    // compiling them from scratch, so this doesn't slow down startup significantly.
+    const QList<ShaderTraits> usedTraits = m_cache->usedTraits();
+    for (const ShaderTraits traits : usedTraits) {
+        const QByteArray defines = listDefines(traits);
+        const QByteArray key = cacheKey(defines + generateVertexSource(traits), defines + generateFragmentSource(traits));
+        if (key.isEmpty()) {
+            continue;
+        }
+        if (auto shader = loadCachedShader(key)) {
+            m_shaderHash[traits] = std::move(shader);
+        }
+    }
+}
+
 std::unique_ptr<GLShader> ShaderManager::generateShaderFromFile(ShaderTraits traits, const QString &vertexFile, const QString &fragmentFile)
 {
     auto loadShaderFile = [](const QString &filePath) {
@@ -126,11 +201,32 @@ std::unique_ptr<GLShader> ShaderManager::generateShaderFromFile(ShaderTraits tra
     return generateCustomShader(traits, vertexSource, fragmentSource);
 }
 
+std::unique_ptr<GLShader> ShaderManager::generateComputeShaderFromFile(const QString &computeFile, const QByteArray &defines)
+{
+    QFile file(computeFile);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qCCritical(KWIN_OPENGL) << "Failed to read shader " << computeFile;
+        return nullptr;
+    }
+
+    auto shader = std::make_unique<GLShader>();
+    if (!shader->loadCompute(defines + file.readAll())) {
+        return nullptr;
+    }
+    if (!shader->link()) {
+        return nullptr;
+    }
+    return shader;
+}
+
 GLShader *ShaderManager::shader(ShaderTraits traits)
 {
     std::unique_ptr<GLShader> &shader = m_shaderHash[traits];
     if (!shader) {
         shader = generateShader(traits);
+        if (shader && m_cache) {
+            m_cache->addUsedTraits(traits);
+        }
     }
     return shader.get();
 }
@@ -21,6 +21,7 @@ namespace KWin
 {
 
 class GLShader;
+class ShaderCache;
 
 enum class ShaderTrait {
     MapTexture = (1 << 0),
@@ -142,6 +143,18 @@ public:
      */
     std::unique_ptr<GLShader> generateShaderFromFile(ShaderTraits traits, const QString &vertexFile = QString(), const QString &fragmentFile = QString());
 
+    /**
+     * Creates a compute shader from the given @p computeFile. The @p defines are inserted
+     * before the source code, they can be used to specialize the shader.
+     *
+     * Compute shaders need OpenGL ES 3.1, see EglContext::supportsComputeShaders().
+     *
+     * @param computeFile the compute shader source code file
+     * @param defines optional preprocessor definitions
+     * @return new generated shader, or @c null if the shader failed to compile
+     */
+    std::unique_ptr<GLShader> generateComputeShaderFromFile(const QString &computeFile, const QByteArray &defines = QByteArray());
+
     /**
      * @return a pointer to the ShaderManager instance
      */
@@ -153,9 +166,13 @@ private:
     QByteArray generateVertexSource(ShaderTraits traits) const;
     QByteArray generateFragmentSource(ShaderTraits traits) const;
     std::unique_ptr<GLShader> generateShader(ShaderTraits traits);
+    QByteArray cacheKey(const QByteArray &vertexSource, const QByteArray &fragmentSource) const;
+    std::unique_ptr<GLShader> loadCachedShader(const QByteArray &cacheKey);
+    void prewarm();
 
     QStack<GLShader *> m_boundShaders;
     std::map<ShaderTraits, std::unique_ptr<GLShader>> m_shaderHash;
+    std::unique_ptr<ShaderCache> m_cache;
 };
 
 /**
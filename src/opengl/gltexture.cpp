@@ -11,6 +11,7 @@
 
 #include "gltexture_p.h"
 #include "opengl/glframebuffer.h"
+#include "opengl/glpixelunpackbuffer.h"
 #include "opengl/glplatform.h"
 #include "opengl/glutils.h"
 #include "utils/common.h"
@@ -21,6 +22,8 @@
 #include <QVector3D>
 #include <QVector4D>
 
+#include <cstring>
+
 namespace KWin
 {
 
@@ -112,6 +115,11 @@ void GLTexture::setSize(const QSize &size)
 }
 
 void GLTexture::update(const QImage &image, const Region &region, const QPoint &offset)
+{
+    update(image, region.rects(), offset);
+}
+
+void GLTexture::update(const QImage &image, QSpan<const Rect> rects, const QPoint &offset)
 {
     if (image.isNull() || isNull()) {
         return;
@@ -140,18 +148,45 @@ void GLTexture::update(const QImage &image, const Region &region, const QPoint &
 
     bind();
 
-    for (const Rect &rect : region.rects()) {
-        Q_ASSERT(im.depth() % 8 == 0);
-        glPixelStorei(GL_UNPACK_ROW_LENGTH, im.bytesPerLine() / (im.depth() / 8));
+    Q_ASSERT(im.depth() % 8 == 0);
+    const int bytesPerPixel = im.depth() / 8;
+    GLPixelUnpackBuffer *staging = context->pixelUnpackBuffer();
+    bool staged = false;
+
+    for (const Rect &rect : rects) {
+        const size_t rowSize = size_t(rect.width()) * bytesPerPixel;
+        if (staging) {
+            // Copy the rows into the staging buffer so that the driver can transfer
+            // them to the texture asynchronously
+            if (const auto allocation = staging->allocate(rowSize * rect.height())) {
+                auto dst = static_cast<uint8_t *>(allocation->data);
+                for (int y = rect.top(); y < rect.bottom(); ++y) {
+                    std::memcpy(dst, im.constScanLine(y) + rect.x() * bytesPerPixel, rowSize);
+                    dst += rowSize;
+                }
+
+                staging->bind();
+                glTexSubImage2D(d->m_target, 0, offset.x() + rect.x(), offset.y() + rect.y(), rect.width(), rect.height(), glFormat, type, reinterpret_cast<const void *>(allocation->offset));
+                staging->unbind();
+                staged = true;
+                continue;
+            }
+        }
+
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, im.bytesPerLine() / bytesPerPixel);
         glPixelStorei(GL_UNPACK_SKIP_PIXELS, rect.x());
         glPixelStorei(GL_UNPACK_SKIP_ROWS, rect.y());
 
         glTexSubImage2D(d->m_target, 0, offset.x() + rect.x(), offset.y() + rect.y(), rect.width(), rect.height(), glFormat, type, im.constBits());
+
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+        glPixelStorei(GL_UNPACK_SKIP_PIXELS, 0);
+        glPixelStorei(GL_UNPACK_SKIP_ROWS, 0);
     }
 
-    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
-    glPixelStorei(GL_UNPACK_SKIP_PIXELS, 0);
-    glPixelStorei(GL_UNPACK_SKIP_ROWS, 0);
+    if (staged) {
+        staging->endUploads();
+    }
 
     unbind();
 }
@@ -296,11 +331,41 @@ GLenum GLTexture::filter() const
     return d->m_filter;
 }
 
+int GLTexture::mipLevels() const
+{
+    return d->m_mipLevels;
+}
+
 GLenum GLTexture::internalFormat() const
 {
     return d->m_internalFormat;
 }
 
+static size_t bytesPerPixel(GLenum internalFormat)
+{
+    switch (internalFormat) {
+    case GL_R8:
+        return 1;
+    case GL_RG8:
+    case GL_R16:
+        return 2;
+    case GL_RGBA16:
+    case GL_RGBA16F:
+        return 8;
+    case GL_RGBA32F:
+        return 16;
+    default:
+        return 4;
+    }
+}
+
+size_t GLTexture::memoryUsage() const
+{
+    const size_t base = size_t(d->m_size.width()) * d->m_size.height() * bytesPerPixel(d->m_internalFormat);
+    // a full mipmap chain adds a third
+    return d->m_mipLevels > 1 ? base * 4 / 3 : base;
+}
+
 void GLTexture::setFilter(GLenum filter)
 {
     if (filter != d->m_filter) {
@@ -431,6 +496,24 @@ std::unique_ptr<GLTexture> GLTexture::allocate(GLenum internalFormat, const QSiz
     return std::unique_ptr<GLTexture>(new GLTexture(GL_TEXTURE_2D, texture, internalFormat, size, levels, true, OutputTransform{}));
 }
 
+std::unique_ptr<GLTexture> GLTexture::allocateStorage(GLenum internalFormat, const QSize &size, int levels)
+{
+    if (!EglContext::currentContext()->supportsTextureStorage()) {
+        return nullptr;
+    }
+
+    GLuint texture = 0;
+    glGenTextures(1, &texture);
+    if (texture == 0) {
+        qCWarning(KWIN_OPENGL, "generating OpenGL texture handle failed");
+        return nullptr;
+    }
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexStorage2D(GL_TEXTURE_2D, levels, internalFormat, size.width(), size.height());
+    glBindTexture(GL_TEXTURE_2D, 0);
+    return std::unique_ptr<GLTexture>(new GLTexture(GL_TEXTURE_2D, texture, internalFormat, size, levels, true, OutputTransform{}));
+}
+
 std::unique_ptr<GLTexture> GLTexture::upload(const QImage &image)
 {
     if (image.isNull()) {
@@ -15,6 +15,7 @@
 #include <QExplicitlySharedDataPointer>
 #include <QMatrix4x4>
 #include <QSize>
+#include <QSpan>
 
 #include <epoxy/gl.h>
 
@@ -84,6 +85,10 @@ public:
     QMatrix4x4 matrix(TextureCoordinateType type) const;
 
     void update(const QImage &image, const Region &region, const QPoint &offset = QPoint());
+    /**
+     * Uploads the @a rects of the @a image. Unlike with the Region overload, the rects may overlap.
+     */
+    void update(const QImage &image, QSpan<const Rect> rects, const QPoint &offset = QPoint());
     void bind();
     void unbind();
     void render(const QSizeF &size);
@@ -94,6 +99,14 @@ public:
     GLenum target() const;
     GLenum filter() const;
     GLenum internalFormat() const;
+    /**
+     * Returns the number of mipmap levels that can be generated for the texture.
+     */
+    int mipLevels() const;
+    /**
+     * Returns an estimate of how much memory the texture occupies, in bytes.
+     */
+    size_t memoryUsage() const;
 
     QImage toImage();
 
@@ -122,6 +135,12 @@ public:
 
     static std::unique_ptr<GLTexture> createNonOwningWrapper(GLuint textureId, GLenum internalFormat, const QSize &size);
     static std::unique_ptr<GLTexture> allocate(GLenum internalFormat, const QSize &size, int levels = 1);
+    /**
+     * Allocates a texture with immutable storage of exactly the given @a internalFormat, as
+     * required for binding the texture to an image unit. Returns @c null if texture storage
+     * is not supported.
+     */
+    static std::unique_ptr<GLTexture> allocateStorage(GLenum internalFormat, const QSize &size, int levels = 1);
     static std::unique_ptr<GLTexture> upload(const QImage &image);
     static std::unique_ptr<GLTexture> upload(const QPixmap &pixmap);
 
@@ -277,6 +277,17 @@ void GLVertexBufferPrivate::reallocatePersistentBuffer(size_t size)
 
     nextOffset = 0;
     bufferEnd = bufferSize;
+
+    if (!map) {
+        // The storage is immutable, so a new buffer is needed for the regular streaming path.
+        qCWarning(KWIN_OPENGL) << "Failed to map a persistent vertex buffer, falling back to regular uploads";
+        glDeleteBuffers(1, &buffer);
+        glGenBuffers(1, &buffer);
+        glBindBuffer(GL_ARRAY_BUFFER, buffer);
+        bufferSize = 0;
+        bufferEnd = 0;
+        persistent = false;
+    }
 }
 
 bool GLVertexBufferPrivate::awaitFence(intptr_t end)
@@ -318,6 +329,9 @@ GLvoid *GLVertexBufferPrivate::getIdleRange(size_t size)
 {
     if (size > bufferSize) {
         reallocatePersistentBuffer(size * 2);
+        if (!map) {
+            return nullptr;
+        }
     }
 
     // Handle wrap-around
@@ -400,7 +414,11 @@ GLvoid *GLVertexBuffer::map(size_t size)
     d->frameSize += size;
 
     if (d->persistent) {
-        return d->getIdleRange(size);
+        GLvoid *range = d->getIdleRange(size);
+        // If the buffer couldn't be mapped persistently, fall back to the regular path.
+        if (range || d->persistent) {
+            return range;
+        }
     }
 
     glBindBuffer(GL_ARRAY_BUFFER, d->buffer);
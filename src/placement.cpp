@@ -21,6 +21,8 @@
 #include <QTextStream>
 #include <QTimer>
 
+#include <vector>
+
 namespace KWin
 {
 
@@ -145,6 +147,47 @@ static inline bool isIrrelevant(const Window *window, const Window *regarding, V
         || window->isDesktop();
 }
 
+/**
+ * The geometry of a window that a new window should preferably not overlap, in the
+ * integer coordinates used by the smart placement.
+ */
+struct PlacementObstacle
+{
+    int left;
+    int top;
+    int right;
+    int bottom;
+    int overlapWeight;
+};
+
+static std::vector<PlacementObstacle> placementObstacles(const Window *window, VirtualDesktop *desktop)
+{
+    // checking whether a window is relevant is comparatively expensive, and the placement
+    // checks the windows once for every candidate position, so they're only collected once
+    std::vector<PlacementObstacle> obstacles;
+    for (const Window *client : workspace()->stackingOrder()) {
+        if (isIrrelevant(client, window, desktop)) {
+            continue;
+        }
+        const int left = client->x();
+        const int top = client->y();
+        int overlapWeight = 1;
+        if (client->keepAbove()) {
+            overlapWeight = 16;
+        } else if (client->keepBelow() && !client->isDock()) { // ignore KeepBelow windows
+            overlapWeight = 0; // for placement (see X11Window::belongsToLayer() for Dock)
+        }
+        obstacles.push_back(PlacementObstacle{
+            .left = left,
+            .top = top,
+            .right = int(left + client->width()),
+            .bottom = int(top + client->height()),
+            .overlapWeight = overlapWeight,
+        });
+    }
+    return obstacles;
+}
+
 /**
  * Place the client \a c according to a really smart placement algorithm :-)
  */
@@ -176,6 +219,8 @@ std::optional<PlacementCommand> Placement::placeSmart(const Window *window, cons
     int xl, xr, yt, yb; // temp coords
     int basket; // temp holder
 
+    const std::vector<PlacementObstacle> obstacles = placementObstacles(window, desktop);
+
     // get the maximum allowed windows space
     int x = area.left();
     int y = area.top();
@@ -207,28 +252,17 @@ std::optional<PlacementCommand> Placement::placeSmart(const Window *window, cons
             cxr = x + cw;
             cyt = y;
             cyb = y + ch;
-            for (auto l = workspace()->stackingOrder().constBegin(); l != workspace()->stackingOrder().constEnd(); ++l) {
-                auto client = *l;
-                if (isIrrelevant(client, window, desktop)) {
-                    continue;
-                }
-                xl = client->x();
-                yt = client->y();
-                xr = xl + client->width();
-                yb = yt + client->height();
-
+            for (const PlacementObstacle &obstacle : obstacles) {
                 // if windows overlap, calc the overall overlapping
-                if ((cxl < xr) && (cxr > xl) && (cyt < yb) && (cyb > yt)) {
-                    xl = std::max(cxl, xl);
-                    xr = std::min(cxr, xr);
-                    yt = std::max(cyt, yt);
-                    yb = std::min(cyb, yb);
-                    if (client->keepAbove()) {
-                        overlap += 16 * (xr - xl) * (yb - yt);
-                    } else if (client->keepBelow() && !client->isDock()) { // ignore KeepBelow windows
-                        overlap += 0; // for placement (see X11Window::belongsToLayer() for Dock)
-                    } else {
-                        overlap += (xr - xl) * (yb - yt);
+                if ((cxl < obstacle.right) && (cxr > obstacle.left) && (cyt < obstacle.bottom) && (cyb > obstacle.top)) {
+                    xl = std::max(cxl, obstacle.left);
+                    xr = std::min(cxr, obstacle.right);
+                    yt = std::max(cyt, obstacle.top);
+                    yb = std::min(cyb, obstacle.bottom);
+                    overlap += obstacle.overlapWeight * (xr - xl) * (yb - yt);
+                    // this position can't be better than the best one so far anymore
+                    if (!first_pass && overlap >= min_overlap) {
+                        break;
                     }
                 }
             }
@@ -260,16 +294,11 @@ std::optional<PlacementCommand> Placement::placeSmart(const Window *window, cons
             }
 
             // compare to the position of each client on the same desk
-            for (auto l = workspace()->stackingOrder().constBegin(); l != workspace()->stackingOrder().constEnd(); ++l) {
-                auto client = *l;
-                if (isIrrelevant(client, window, desktop)) {
-                    continue;
-                }
-
-                xl = client->x();
-                yt = client->y();
-                xr = xl + client->width();
-                yb = yt + client->height();
+            for (const PlacementObstacle &obstacle : obstacles) {
+                xl = obstacle.left;
+                yt = obstacle.top;
+                xr = obstacle.right;
+                yb = obstacle.bottom;
 
                 // if not enough room above or under the current tested client
                 // determine the first non-overlapped x position
@@ -297,16 +326,9 @@ std::optional<PlacementCommand> Placement::placeSmart(const Window *window, cons
             }
 
             // test the position of each window on the desk
-            for (auto l = workspace()->stackingOrder().constBegin(); l != workspace()->stackingOrder().constEnd(); ++l) {
-                auto client = *l;
-                if (isIrrelevant(client, window, desktop)) {
-                    continue;
-                }
-
-                xl = client->x();
-                yt = client->y();
-                xr = xl + client->width();
-                yb = yt + client->height();
+            for (const PlacementObstacle &obstacle : obstacles) {
+                yt = obstacle.top;
+                yb = obstacle.bottom;
 
                 // if not enough room to the left or right of the current tested client
                 // determine the first non-overlapped y position
@@ -13,12 +13,15 @@
 #include "core/rendertarget.h"
 #include "core/renderviewport.h"
 #include "effect/effecthandler.h"
+#include "opengl/glgpuprofiler.h"
 #include "opengl/glplatform.h"
 #include "scene/backgroundeffectitem.h"
 #include "scene/decorationitem.h"
 #include "scene/scene.h"
 #include "scene/surfaceitem.h"
+#include "scene/texturememorybudget.h"
 #include "scene/windowitem.h"
+#include "scene/workspacescene.h"
 #include "wayland/backgroundeffect_v1.h"
 #include "wayland/display.h"
 #include "wayland/surface.h"
@@ -89,6 +92,8 @@ BlurEffect::BlurEffect()
 {
     BlurConfig::instance(effects->config());
     ensureResources();
+    // only the windows that have a blur region need to go through drawWindow()
+    setPaintsAllWindows(false);
 
     m_onscreenPass.shader = ShaderManager::instance()->generateShaderFromFile(ShaderTrait::MapTexture,
                                                                               QStringLiteral(":/effects/blur/shaders/vertex.vert"),
@@ -154,6 +159,10 @@ BlurEffect::BlurEffect()
         m_noisePass.noiseTextureSizeLocation = m_noisePass.shader->uniformLocation("noiseTextureSize");
     }
 
+    m_computePasses.supported = EglContext::currentContext()->supportsComputeShaders()
+        && EglContext::currentContext()->supportsTextureStorage()
+        && qgetenv("KWIN_BLUR_COMPUTE") != QByteArrayLiteral("0");
+
     initBlurStrengthValues();
     reconfigure(ReconfigureAll);
 
@@ -313,6 +322,7 @@ void BlurEffect::updateBlurRegion(EffectWindow *w)
 
     if (content.has_value() || frame.has_value()) {
         BlurEffectData &data = m_windows[w];
+        setPaintsWindow(w, true);
         data.content = content;
         data.frame = frame;
         if (!data.blurItem) {
@@ -325,6 +335,7 @@ void BlurEffect::updateBlurRegion(EffectWindow *w)
             effects->makeOpenGLContextCurrent();
             m_windows.erase(it);
         }
+        setPaintsWindow(w, false);
     }
 }
 
@@ -547,6 +558,102 @@ GLTexture *BlurEffect::ensureNoiseTexture()
     return m_noisePass.noiseTexture.get();
 }
 
+bool BlurEffect::ensureComputePasses(GLenum imageFormat)
+{
+    if (!m_computePasses.supported) {
+        return false;
+    }
+    if (m_computePasses.imageFormat == imageFormat) {
+        return true;
+    }
+
+    const QByteArray defines = "#define IMAGE_FORMAT " + QByteArray(imageFormat == GL_RGBA16F ? "rgba16f" : "rgba8") + "\n";
+    auto load = [&defines](ComputePass &pass, const QString &fileName) {
+        pass.shader = ShaderManager::instance()->generateComputeShaderFromFile(fileName, defines);
+        if (!pass.shader) {
+            return false;
+        }
+        pass.offsetLocation = pass.shader->uniformLocation("offset");
+        pass.regionLocation = pass.shader->uniformLocation("region");
+        return true;
+    };
+    if (!load(m_computePasses.downsample, QStringLiteral(":/effects/blur/shaders/downsample.comp"))
+        || !load(m_computePasses.upsample, QStringLiteral(":/effects/blur/shaders/upsample.comp"))) {
+        qCWarning(KWIN_BLUR) << "Failed to load compute shaders, falling back to fragment shaders";
+        m_computePasses.downsample.shader.reset();
+        m_computePasses.upsample.shader.reset();
+        m_computePasses.supported = false;
+        return false;
+    }
+
+    m_computePasses.imageFormat = imageFormat;
+    return true;
+}
+
+static void dispatchComputePass(GLShader *shader, int regionLocation, GLTexture *read, GLTexture *draw, GLenum imageFormat, const Region &region)
+{
+    read->bind();
+    glBindImageTexture(0, draw->texture(), 0, GL_FALSE, 0, GL_WRITE_ONLY, imageFormat);
+
+    for (const Rect &rect : region.rects()) {
+        // The region is relative to the top left corner, but images start at the bottom left corner
+        const int y = draw->height() - (rect.y() + rect.height());
+        shader->setUniform(regionLocation, QVector4D(rect.x(), y, rect.width(), rect.height()));
+        glDispatchCompute((rect.width() + 7) / 8, (rect.height() + 7) / 8, 1);
+    }
+
+    // The next pass samples the image that has just been written
+    glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT);
+    glBindImageTexture(0, 0, 0, GL_FALSE, 0, GL_WRITE_ONLY, imageFormat);
+}
+
+static bool allocateRenderTarget(GLenum format, GLenum imageFormat, const QSize &size, std::vector<std::unique_ptr<GLTexture>> &textures, std::vector<std::unique_ptr<GLFramebuffer>> &framebuffers)
+{
+    // Textures that compute shaders write to need immutable storage of the image format
+    auto texture = imageFormat == GL_NONE ? GLTexture::allocate(format, size) : GLTexture::allocateStorage(imageFormat, size);
+    if (!texture) {
+        qCWarning(KWIN_BLUR) << "Failed to allocate an offscreen texture";
+        return false;
+    }
+    texture->setFilter(GL_LINEAR);
+    texture->setWrapMode(GL_CLAMP_TO_EDGE);
+
+    auto framebuffer = std::make_unique<GLFramebuffer>(texture.get());
+    if (!framebuffer->valid()) {
+        qCWarning(KWIN_BLUR) << "Failed to create an offscreen framebuffer";
+        return false;
+    }
+    EglContext::currentContext()->pushFramebuffer(framebuffer.get());
+    glClear(GL_COLOR_BUFFER_BIT);
+    EglContext::currentContext()->popFramebuffer();
+    textures.push_back(std::move(texture));
+    framebuffers.push_back(std::move(framebuffer));
+    return true;
+}
+
+/**
+ * Returns the part of the given blur @a level that has to be redone if the background has
+ * changed in the @a damage region. The @a radius is the distance in logical pixels that damage
+ * spreads until it reaches the level.
+ */
+static Region levelUpdateRegion(const Region &damage, const Rect &backgroundRect, const GLTexture *texture, int level, float radius)
+{
+    const Rect localRect(0, 0, backgroundRect.width(), backgroundRect.height());
+    const int margin = std::ceil(radius);
+
+    Region region;
+    for (const Rect &rect : damage.rects()) {
+        region |= rect.grownBy(QMargins(margin, margin, margin, margin)) & localRect;
+    }
+
+    // Add another pixel to account for the rounding of the texture size
+    Region ret;
+    for (const Rect &rect : region.scaledAndRoundedOut(1.0 / (1 << level)).rects()) {
+        ret |= rect.grownBy(QMargins(1, 1, 1, 1)) & Rect(QPoint(0, 0), texture->size());
+    }
+    return ret;
+}
+
 void BlurEffect::blur(const RenderTarget &renderTarget, const RenderViewport &viewport, EffectWindow *w, int mask, const Region &deviceRegion, WindowPaintData &data)
 {
     auto it = m_windows.find(w);
@@ -605,31 +712,57 @@ void BlurEffect::blur(const RenderTarget &renderTarget, const RenderViewport &vi
         textureFormat = renderTarget.texture()->internalFormat();
     }
 
-    if (renderInfo.framebuffers.size() != (m_iterationCount + 1) || renderInfo.textures[0]->size() != backgroundRect.size() || renderInfo.textures[0]->internalFormat() != textureFormat) {
+    if (!renderInfo.memory) {
+        // The textures of views that haven't been presented for a while can be evicted. The
+        // cached background is gone then, so the whole window has to be repainted.
+        renderInfo.memory = effects->scene()->textureMemoryBudget()->track(QStringLiteral("BlurEffect"), [&renderInfo, w]() {
+            renderInfo.framebuffers.clear();
+            renderInfo.textures.clear();
+            renderInfo.upsampleFramebuffers.clear();
+            renderInfo.upsampleTextures.clear();
+            w->addRepaintFull();
+        });
+    }
+    renderInfo.memory->markUsed();
+
+    // The compute shaders can't write to the formats of all render targets, e.g. GL_RGB10_A2
+    GLenum imageFormat = GL_NONE;
+    if (textureFormat == GL_RGBA8 || textureFormat == GL_RGBA16F) {
+        if (ensureComputePasses(textureFormat)) {
+            imageFormat = textureFormat;
+        }
+    }
+
+    if (renderInfo.framebuffers.size() != (m_iterationCount + 1) || renderInfo.upsampleFramebuffers.size() != (m_iterationCount - 1) || renderInfo.textures[0]->size() != backgroundRect.size() || renderInfo.textures[0]->internalFormat() != textureFormat || renderInfo.imageFormat != imageFormat) {
         renderInfo.framebuffers.clear();
         renderInfo.textures.clear();
+        renderInfo.upsampleFramebuffers.clear();
+        renderInfo.upsampleTextures.clear();
+        renderInfo.valid = false;
+        renderInfo.imageFormat = imageFormat;
+        renderInfo.memory->setSize(0);
 
+        // The first texture is written by blits, not compute shaders
         glClearColor(0, 0, 0, 0);
         for (size_t i = 0; i <= m_iterationCount; ++i) {
-            auto texture = GLTexture::allocate(textureFormat, backgroundRect.size() / (1 << i));
-            if (!texture) {
-                qCWarning(KWIN_BLUR) << "Failed to allocate an offscreen texture";
+            if (!allocateRenderTarget(textureFormat, i == 0 ? GL_NONE : imageFormat, backgroundRect.size() / (1 << i), renderInfo.textures, renderInfo.framebuffers)) {
                 return;
             }
-            texture->setFilter(GL_LINEAR);
-            texture->setWrapMode(GL_CLAMP_TO_EDGE);
-
-            auto framebuffer = std::make_unique<GLFramebuffer>(texture.get());
-            if (!framebuffer->valid()) {
-                qCWarning(KWIN_BLUR) << "Failed to create an offscreen framebuffer";
+        }
+        for (size_t i = 1; i < m_iterationCount; ++i) {
+            if (!allocateRenderTarget(textureFormat, imageFormat, backgroundRect.size() / (1 << i), renderInfo.upsampleTextures, renderInfo.upsampleFramebuffers)) {
                 return;
             }
-            EglContext::currentContext()->pushFramebuffer(framebuffer.get());
-            glClear(GL_COLOR_BUFFER_BIT);
-            EglContext::currentContext()->popFramebuffer();
-            renderInfo.textures.push_back(std::move(texture));
-            renderInfo.framebuffers.push_back(std::move(framebuffer));
         }
+
+        size_t memoryUsage = 0;
+        for (const auto &texture : renderInfo.textures) {
+            memoryUsage += texture->memoryUsage();
+        }
+        for (const auto &texture : renderInfo.upsampleTextures) {
+            memoryUsage += texture->memoryUsage();
+        }
+        renderInfo.memory->setSize(memoryUsage);
     }
 
     // Fetch the pixels behind the shape that is going to be blurred.
@@ -638,6 +771,23 @@ void BlurEffect::blur(const RenderTarget &renderTarget, const RenderViewport &vi
         renderInfo.framebuffers[0]->blitFromRenderTarget(renderTarget, viewport, dirtyRect, dirtyRect.translated(-backgroundRect.topLeft()));
     }
 
+    // The blur from the previous frame can be reused where the background hasn't changed, the
+    // down and upsample passes only need to be redone around the fetched pixels.
+    Region backgroundDamage;
+    if (!renderInfo.valid || renderInfo.backgroundRect != backgroundRect || renderInfo.offset != m_offset) {
+        backgroundDamage = Rect(0, 0, backgroundRect.width(), backgroundRect.height());
+    } else {
+        backgroundDamage = dirtyRegion.translated(-backgroundRect.topLeft());
+    }
+    renderInfo.valid = false;
+
+    const auto upsampled = [&renderInfo](size_t level) {
+        if (level == renderInfo.framebuffers.size() - 1) {
+            return renderInfo.framebuffers[level].get();
+        }
+        return renderInfo.upsampleFramebuffers[level - 1].get();
+    };
+
     // Upload the geometry: the first 6 vertices are used when downsampling and upsampling offscreen,
     // the remaining vertices are used when rendering on the screen.
     GLVertexBuffer *vbo = GLVertexBuffer::streamingBuffer();
@@ -742,59 +892,120 @@ void BlurEffect::blur(const RenderTarget &renderTarget, const RenderViewport &vi
 
     vbo->bindArrays();
 
-    // The downsample pass of the dual Kawase algorithm: the background will be scaled down 50% every iteration.
-    {
-        ShaderManager::instance()->pushShader(m_downsamplePass.shader.get());
+    // Find the parts of each level that are affected by the damage. Each downsample pass reads the previous
+    // level up to offset half-pixels away, plus one pixel for the bilinear filter and one for the 2:1 mapping.
+    // Each upsample pass reads up to offset pixels away, plus one pixel for the bilinear filter.
+    std::vector<Region> downsampleRegions(renderInfo.framebuffers.size());
+    std::vector<Region> upsampleRegions(renderInfo.framebuffers.size() - 1);
+    if (!backgroundDamage.isEmpty()) {
+        float damageRadius = 0;
+        for (size_t i = 1; i < renderInfo.framebuffers.size(); ++i) {
+            damageRadius += (m_offset / 2.0f + 2) * (1 << (i - 1));
+            downsampleRegions[i] = levelUpdateRegion(backgroundDamage, backgroundRect, renderInfo.textures[i].get(), i, damageRadius);
+        }
+        for (size_t i = renderInfo.framebuffers.size() - 2; i > 0; --i) {
+            damageRadius += (m_offset + 2) * (1 << (i + 1));
+            upsampleRegions[i] = levelUpdateRegion(backgroundDamage, backgroundRect, upsampled(i)->colorAttachment(), i, damageRadius);
+        }
+    }
 
-        QMatrix4x4 projectionMatrix;
-        projectionMatrix.ortho(QRectF(0.0, 0.0, backgroundRect.width(), backgroundRect.height()));
+    if (backgroundDamage.isEmpty()) {
+        // The blur from the previous frame can be used as is
+    } else if (renderInfo.imageFormat != GL_NONE) {
+        GLGpuProfilerScope profilerScope(QStringLiteral("Blur"));
 
-        m_downsamplePass.shader->setUniform(m_downsamplePass.mvpMatrixLocation, projectionMatrix);
-        m_downsamplePass.shader->setUniform(m_downsamplePass.offsetLocation, float(m_offset));
+        // The downsample pass of the dual Kawase algorithm: the background will be scaled down 50% every iteration.
+        {
+            GLGpuProfilerScope downsampleScope(QStringLiteral("Downsample"));
+            ShaderManager::instance()->pushShader(m_computePasses.downsample.shader.get());
+            m_computePasses.downsample.shader->setUniform(m_computePasses.downsample.offsetLocation, float(m_offset));
+            for (size_t i = 1; i < renderInfo.framebuffers.size(); ++i) {
+                dispatchComputePass(m_computePasses.downsample.shader.get(), m_computePasses.downsample.regionLocation,
+                                    renderInfo.textures[i - 1].get(), renderInfo.textures[i].get(), renderInfo.imageFormat, downsampleRegions[i]);
+            }
+            ShaderManager::instance()->popShader();
+        }
 
-        for (size_t i = 1; i < renderInfo.framebuffers.size(); ++i) {
-            const auto &read = renderInfo.framebuffers[i - 1];
-            const auto &draw = renderInfo.framebuffers[i];
+        // The upsample pass of the dual Kawase algorithm: the background will be scaled up 200% every iteration.
+        {
+            GLGpuProfilerScope upsampleScope(QStringLiteral("Upsample"));
+            ShaderManager::instance()->pushShader(m_computePasses.upsample.shader.get());
+            m_computePasses.upsample.shader->setUniform(m_computePasses.upsample.offsetLocation, float(m_offset));
+            for (size_t i = renderInfo.framebuffers.size() - 2; i > 0; --i) {
+                dispatchComputePass(m_computePasses.upsample.shader.get(), m_computePasses.upsample.regionLocation,
+                                    upsampled(i + 1)->colorAttachment(), upsampled(i)->colorAttachment(), renderInfo.imageFormat, upsampleRegions[i]);
+            }
+            ShaderManager::instance()->popShader();
+        }
+    } else {
+        GLGpuProfilerScope profilerScope(QStringLiteral("Blur"));
+        glEnable(GL_SCISSOR_TEST);
+
+        // The downsample pass of the dual Kawase algorithm: the background will be scaled down 50% every iteration.
+        {
+            GLGpuProfilerScope downsampleScope(QStringLiteral("Downsample"));
+            ShaderManager::instance()->pushShader(m_downsamplePass.shader.get());
+
+            QMatrix4x4 projectionMatrix;
+            projectionMatrix.ortho(QRectF(0.0, 0.0, backgroundRect.width(), backgroundRect.height()));
+
+            m_downsamplePass.shader->setUniform(m_downsamplePass.mvpMatrixLocation, projectionMatrix);
+            m_downsamplePass.shader->setUniform(m_downsamplePass.offsetLocation, float(m_offset));
 
-            const QVector2D halfpixel(0.5 / read->colorAttachment()->width(),
-                                      0.5 / read->colorAttachment()->height());
-            m_downsamplePass.shader->setUniform(m_downsamplePass.halfpixelLocation, halfpixel);
+            for (size_t i = 1; i < renderInfo.framebuffers.size(); ++i) {
+                const auto &read = renderInfo.framebuffers[i - 1];
+                const auto &draw = renderInfo.framebuffers[i];
 
-            read->colorAttachment()->bind();
+                const QVector2D halfpixel(0.5 / read->colorAttachment()->width(),
+                                          0.5 / read->colorAttachment()->height());
+                m_downsamplePass.shader->setUniform(m_downsamplePass.halfpixelLocation, halfpixel);
 
-            GLFramebuffer::pushFramebuffer(draw.get());
-            vbo->draw(GL_TRIANGLES, 0, 6);
+                read->colorAttachment()->bind();
+
+                GLFramebuffer::pushFramebuffer(draw.get());
+                vbo->draw(downsampleRegions[i], GL_TRIANGLES, 0, 6, true);
+                GLFramebuffer::popFramebuffer();
+            }
+
+            ShaderManager::instance()->popShader();
         }
 
-        ShaderManager::instance()->popShader();
-    }
+        // The upsample pass of the dual Kawase algorithm: the background will be scaled up 200% every iteration.
+        {
+            GLGpuProfilerScope upsampleScope(QStringLiteral("Upsample"));
+            ShaderManager::instance()->pushShader(m_upsamplePass.shader.get());
 
-    // The upsample pass of the dual Kawase algorithm: the background will be scaled up 200% every iteration.
-    {
-        ShaderManager::instance()->pushShader(m_upsamplePass.shader.get());
+            QMatrix4x4 projectionMatrix;
+            projectionMatrix.ortho(QRectF(0.0, 0.0, backgroundRect.width(), backgroundRect.height()));
 
-        QMatrix4x4 projectionMatrix;
-        projectionMatrix.ortho(QRectF(0.0, 0.0, backgroundRect.width(), backgroundRect.height()));
+            m_upsamplePass.shader->setUniform(m_upsamplePass.mvpMatrixLocation, projectionMatrix);
+            m_upsamplePass.shader->setUniform(m_upsamplePass.offsetLocation, float(m_offset));
 
-        m_upsamplePass.shader->setUniform(m_upsamplePass.mvpMatrixLocation, projectionMatrix);
-        m_upsamplePass.shader->setUniform(m_upsamplePass.offsetLocation, float(m_offset));
+            for (size_t i = renderInfo.framebuffers.size() - 2; i > 0; --i) {
+                GLFramebuffer *read = upsampled(i + 1);
+                GLFramebuffer *draw = upsampled(i);
 
-        for (size_t i = renderInfo.framebuffers.size() - 1; i > 1; --i) {
-            GLFramebuffer::popFramebuffer();
-            const auto &read = renderInfo.framebuffers[i];
+                const QVector2D halfpixel(0.5 / read->colorAttachment()->width(),
+                                          0.5 / read->colorAttachment()->height());
+                m_upsamplePass.shader->setUniform(m_upsamplePass.halfpixelLocation, halfpixel);
 
-            const QVector2D halfpixel(0.5 / read->colorAttachment()->width(),
-                                      0.5 / read->colorAttachment()->height());
-            m_upsamplePass.shader->setUniform(m_upsamplePass.halfpixelLocation, halfpixel);
+                read->colorAttachment()->bind();
 
-            read->colorAttachment()->bind();
+                GLFramebuffer::pushFramebuffer(draw);
+                vbo->draw(upsampleRegions[i], GL_TRIANGLES, 0, 6, true);
+                GLFramebuffer::popFramebuffer();
+            }
 
-            vbo->draw(GL_TRIANGLES, 0, 6);
+            ShaderManager::instance()->popShader();
         }
 
-        ShaderManager::instance()->popShader();
+        glDisable(GL_SCISSOR_TEST);
     }
 
+    renderInfo.backgroundRect = backgroundRect;
+    renderInfo.offset = m_offset;
+    renderInfo.valid = true;
+
     const float modulation = opacity * opacity;
 
     if (const BorderRadius cornerRadius = w->window()->borderRadius(); !cornerRadius.isNull()) {
@@ -803,8 +1014,7 @@ void BlurEffect::blur(const RenderTarget &renderTarget, const RenderViewport &vi
         QMatrix4x4 projectionMatrix = viewport.projectionMatrix();
         projectionMatrix.translate(scaledBackgroundRect.x(), scaledBackgroundRect.y());
 
-        GLFramebuffer::popFramebuffer();
-        const auto &read = renderInfo.framebuffers[1];
+        GLFramebuffer *read = upsampled(1);
 
         const QVector2D halfpixel(0.5 / read->colorAttachment()->width(),
                                   0.5 / read->colorAttachment()->height());
@@ -845,8 +1055,7 @@ void BlurEffect::blur(const RenderTarget &renderTarget, const RenderViewport &vi
         QMatrix4x4 projectionMatrix = viewport.projectionMatrix();
         projectionMatrix.translate(scaledBackgroundRect.x(), scaledBackgroundRect.y());
 
-        GLFramebuffer::popFramebuffer();
-        const auto &read = renderInfo.framebuffers[1];
+        GLFramebuffer *read = upsampled(1);
 
         const QVector2D halfpixel(0.5 / read->colorAttachment()->width(),
                                   0.5 / read->colorAttachment()->height());
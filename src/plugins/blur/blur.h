@@ -19,6 +19,7 @@ namespace KWin
 {
 
 class BackgroundEffectItem;
+class TextureMemoryAllocation;
 
 struct BlurRenderData
 {
@@ -26,6 +27,22 @@ struct BlurRenderData
     /// contains not blurred background behind the window, it's cached.
     std::vector<std::unique_ptr<GLTexture>> textures;
     std::vector<std::unique_ptr<GLFramebuffer>> framebuffers;
+
+    /// The render targets of the upsample pass. They're kept separately from the downsample
+    /// render targets so both chains stay intact and only the damaged parts need to be redone
+    /// in the next frame. The last downsample render target is the first upsample level.
+    std::vector<std::unique_ptr<GLTexture>> upsampleTextures;
+    std::vector<std::unique_ptr<GLFramebuffer>> upsampleFramebuffers;
+
+    /// The geometry and the offset that the cached blur has been computed for
+    Rect backgroundRect;
+    float offset = 0;
+    bool valid = false;
+
+    /// The format of the blurred levels if they can be written by compute shaders, otherwise GL_NONE
+    GLenum imageFormat = GL_NONE;
+
+    std::unique_ptr<TextureMemoryAllocation> memory;
 };
 
 struct BlurEffectData
@@ -90,6 +107,7 @@ private:
     void updateBlurRegion(EffectWindow *w);
     void blur(const RenderTarget &renderTarget, const RenderViewport &viewport, EffectWindow *w, int mask, const Region &deviceRegion, WindowPaintData &data);
     GLTexture *ensureNoiseTexture();
+    bool ensureComputePasses(GLenum imageFormat);
 
 private:
     struct
@@ -140,6 +158,23 @@ private:
         int noiseTextureStength = 0;
     } m_noisePass;
 
+    struct ComputePass
+    {
+        std::unique_ptr<GLShader> shader;
+        int offsetLocation;
+        int regionLocation;
+    };
+
+    /// Compute shader versions of the downsample and upsample passes, they're used if
+    /// OpenGL ES 3.1 is available, unless KWIN_BLUR_COMPUTE=0 is set
+    struct
+    {
+        ComputePass downsample;
+        ComputePass upsample;
+        GLenum imageFormat = GL_NONE;
+        bool supported = false;
+    } m_computePasses;
+
     bool m_valid = false;
 #if KWIN_BUILD_X11
     long net_wm_blur_region = 0;
@@ -7,23 +7,15 @@
 #include "colorblindnesscorrection.h"
 
 #include "effect/effecthandler.h"
-#include "opengl/glshader.h"
 
 #include "colorblindnesscorrectionconfig.h"
 
-Q_LOGGING_CATEGORY(KWIN_COLORBLINDNESS_CORRECTION, "kwin_effect_colorblindnesscorrection", QtWarningMsg)
-
-static void ensureResources()
-{
-    // Must initialize resources manually because the effect is a static lib.
-    Q_INIT_RESOURCE(colorblindnesscorrection);
-}
+#include <QMatrix4x4>
 
 namespace KWin
 {
 
 ColorBlindnessCorrectionEffect::ColorBlindnessCorrectionEffect()
-    : OffscreenEffect()
 {
     ColorBlindnessCorrectionSettings::instance(effects->config());
     m_mode = static_cast<Mode>(ColorBlindnessCorrectionSettings::mode());
@@ -34,6 +26,7 @@ ColorBlindnessCorrectionEffect::ColorBlindnessCorrectionEffect()
 
 ColorBlindnessCorrectionEffect::~ColorBlindnessCorrectionEffect()
 {
+    effects->unsetColorFilter(this);
 }
 
 bool ColorBlindnessCorrectionEffect::supported()
@@ -43,111 +36,67 @@ bool ColorBlindnessCorrectionEffect::supported()
 
 void ColorBlindnessCorrectionEffect::loadData()
 {
-    ensureResources();
-
-    QMatrix3x3 defectMatrix;
-    QString fragPath = QStringLiteral(":/effects/colorblindnesscorrection/shaders/colorblindnesscorrection.frag");
+    // All of the corrections are linear, so they can be expressed as a single matrix that the
+    // scene applies while painting, instead of redirecting every window into a texture
+    if (m_mode == Monochrome) {
+        const float saturation = 1.0f - m_intensity;
+        const QVector3D luminance(0.2126, 0.7152, 0.0722);
+        QMatrix4x4 filter;
+        for (int row = 0; row < 3; row++) {
+            for (int column = 0; column < 3; column++) {
+                filter(row, column) = (row == column ? saturation : 0.0f) + (1.0f - saturation) * luminance[column];
+            }
+        }
+        effects->setColorFilter(this, filter);
+        return;
+    }
 
+    QMatrix4x4 defectMatrix;
     switch (m_mode) {
     case Deuteranopia:
-        defectMatrix(0, 0) = 1.0;
-        defectMatrix(1, 0) = 0.494207;
-        defectMatrix(2, 0) = 0.0;
-        defectMatrix(0, 1) = 0.0;
-        defectMatrix(1, 1) = 0.0;
-        defectMatrix(2, 1) = 0.0;
-        defectMatrix(0, 2) = 0.0;
-        defectMatrix(1, 2) = 1.24827;
-        defectMatrix(2, 2) = 1.0;
+        defectMatrix = QMatrix4x4(1.0, 0.0, 0.0, 0.0,
+                                  0.494207, 0.0, 1.24827, 0.0,
+                                  0.0, 0.0, 1.0, 0.0,
+                                  0.0, 0.0, 0.0, 1.0);
         break;
     case Tritanopia:
-        defectMatrix(0, 0) = 1.0;
-        defectMatrix(1, 0) = 0.0;
-        defectMatrix(2, 0) = -0.395913;
-        defectMatrix(0, 1) = 0.0;
-        defectMatrix(1, 1) = 1.0;
-        defectMatrix(2, 1) = 0.801109;
-        defectMatrix(0, 2) = 0.0;
-        defectMatrix(1, 2) = 0.0;
-        defectMatrix(2, 2) = 0.0;
-        break;
-    case Monochrome:
-        fragPath = QStringLiteral(":/effects/colorblindnesscorrection/shaders/monochrome.frag");
+        defectMatrix = QMatrix4x4(1.0, 0.0, 0.0, 0.0,
+                                  0.0, 1.0, 0.0, 0.0,
+                                  -0.395913, 0.801109, 0.0, 0.0,
+                                  0.0, 0.0, 0.0, 1.0);
         break;
     case Protanopia: // Most common, use it as fallback
     default:
-        defectMatrix(0, 0) = 0.0;
-        defectMatrix(1, 0) = 0.0;
-        defectMatrix(2, 0) = 0.0;
-        defectMatrix(0, 1) = 2.02344;
-        defectMatrix(1, 1) = 1.0;
-        defectMatrix(2, 1) = 0.0;
-        defectMatrix(0, 2) = -2.52581;
-        defectMatrix(1, 2) = 0.0;
-        defectMatrix(2, 2) = 1.0;
+        defectMatrix = QMatrix4x4(0.0, 2.02344, -2.52581, 0.0,
+                                  0.0, 1.0, 0.0, 0.0,
+                                  0.0, 0.0, 1.0, 0.0,
+                                  0.0, 0.0, 0.0, 1.0);
         break;
     }
 
-    m_shader = ShaderManager::instance()->generateShaderFromFile(ShaderTrait::MapTexture, QString(), fragPath);
-
-    if (!m_shader) {
-        qCCritical(KWIN_COLORBLINDNESS_CORRECTION) << "Failed to load the shader!";
-        return;
-    }
-
-    ShaderBinder binder{m_shader.get()};
-
-    if (m_mode != Monochrome) {
-        // These uniforms aren't present in the monochrome shader, so we shouldn't set them there.
-        m_shader->setUniform("intensity", m_intensity);
-        m_shader->setUniform("defectMatrix", defectMatrix);
-    }
-
-    for (const auto windows = effects->stackingOrder(); EffectWindow *w : windows) {
-        correctColor(w);
-    }
-    effects->addRepaintFull();
-
-    connect(effects, &EffectsHandler::windowDeleted, this, &ColorBlindnessCorrectionEffect::slotWindowDeleted);
-    connect(effects, &EffectsHandler::windowAdded, this, &ColorBlindnessCorrectionEffect::correctColor);
-}
-
-bool ColorBlindnessCorrectionEffect::drawWindow(const RenderTarget &renderTarget,
-                                                const RenderViewport &viewport,
-                                                EffectWindow *w,
-                                                int mask,
-                                                const Region &logicalRegion,
-                                                WindowPaintData &data)
-{
-    // The 'saturation' uniform is exported in the base function, so we have to modify its value beforehand.
-    if (m_mode == Monochrome) {
-        data.setSaturation(1.0f - m_intensity);
-    }
-
-    return OffscreenEffect::drawWindow(renderTarget, viewport, w, mask, logicalRegion, data);
-}
-
-void ColorBlindnessCorrectionEffect::correctColor(KWin::EffectWindow *w)
-{
-    if (m_windows.contains(w)) {
-        return;
-    }
-
-    redirect(w);
-    setShader(w, m_shader.get());
-    m_windows.insert(w);
-}
-
-void ColorBlindnessCorrectionEffect::slotWindowDeleted(EffectWindow *w)
-{
-    if (auto it = m_windows.find(w); it != m_windows.end()) {
-        m_windows.erase(it);
-    }
+    // The correction algorithm is taken from http://www.daltonize.org/search/label/Daltonize
+    // - simulate what a color looks like with the defect, in the LMS color space
+    // - shift the colors that can't be seen into the channels that can be seen
+    const QMatrix4x4 rgbToLMS(17.8824, 43.5161, 4.11935, 0.0,
+                              3.45565, 27.1554, 3.86714, 0.0,
+                              0.0299566, 0.184309, 1.46709, 0.0,
+                              0.0, 0.0, 0.0, 1.0);
+    const QMatrix4x4 lmsToRgb(0.0809444479, -0.130504409, 0.116721066, 0.0,
+                              -0.0102485335, 0.0540193266, -0.113614708, 0.0,
+                              -0.000365296938, -0.00412161469, 0.693511405, 0.0,
+                              0.0, 0.0, 0.0, 1.0);
+    const QMatrix4x4 errorShift(0.0, 0.0, 0.0, 0.0,
+                                0.7, 1.0, 0.0, 0.0,
+                                0.7, 0.0, 1.0, 0.0,
+                                0.0, 0.0, 0.0, 0.0);
+    const QMatrix4x4 error = QMatrix4x4() - lmsToRgb * defectMatrix * rgbToLMS;
+    effects->setColorFilter(this, QMatrix4x4() + m_intensity * errorShift * error);
 }
 
 bool ColorBlindnessCorrectionEffect::isActive() const
 {
-    return !m_windows.empty();
+    // direct scanout would skip the color filter
+    return true;
 }
 
 bool ColorBlindnessCorrectionEffect::provides(Feature f)
@@ -170,15 +119,6 @@ void ColorBlindnessCorrectionEffect::reconfigure(ReconfigureFlags flags)
 
     m_mode = newMode;
     m_intensity = newIntensity;
-
-    disconnect(effects, &EffectsHandler::windowDeleted, this, &ColorBlindnessCorrectionEffect::slotWindowDeleted);
-    disconnect(effects, &EffectsHandler::windowAdded, this, &ColorBlindnessCorrectionEffect::correctColor);
-
-    for (EffectWindow *w : m_windows) {
-        unredirect(w);
-    }
-    m_windows.clear();
-
     loadData();
 }
 
@@ -6,10 +6,7 @@
 
 #pragma once
 
-#include <unordered_set>
-
-#include "effect/offscreeneffect.h"
-#include "opengl/glshadermanager.h"
+#include "effect/effect.h"
 
 namespace KWin
 {
@@ -17,7 +14,7 @@ namespace KWin
 /**
  * The color filter supports protanopia, deuteranopia, tritanopia, and monochrome.
  */
-class ColorBlindnessCorrectionEffect : public OffscreenEffect
+class ColorBlindnessCorrectionEffect : public Effect
 {
     Q_OBJECT
 
@@ -36,29 +33,14 @@ public:
     bool provides(Feature) override;
     void reconfigure(ReconfigureFlags flags) override;
     int requestedEffectChainPosition() const override;
-    bool drawWindow(const RenderTarget &renderTarget,
-                    const RenderViewport &viewport,
-                    EffectWindow *w,
-                    int mask,
-                    const Region &logicalRegion,
-                    WindowPaintData &data) override;
 
     static bool supported();
 
-public Q_SLOTS:
-    void slotWindowDeleted(KWin::EffectWindow *w);
-
-private Q_SLOTS:
-    void correctColor(KWin::EffectWindow *w);
-
 private:
     void loadData();
 
     Mode m_mode = Protanopia;
     float m_intensity = 1.0f;
-
-    std::unordered_set<KWin::EffectWindow *> m_windows;
-    std::unique_ptr<GLShader> m_shader;
 };
 
 } // namespace
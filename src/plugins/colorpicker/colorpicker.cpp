@@ -18,6 +18,7 @@
 #include "effect/effect.h"
 #include "effect/effecthandler.h"
 #include "opengl/eglbackend.h"
+#include "opengl/glpixelpackbuffer.h"
 #include "opengl/glplatform.h"
 #include "opengl/glutils.h"
 #include "scene/item.h"
@@ -30,6 +31,7 @@
 #include <KLocalizedString>
 #include <QDBusConnection>
 #include <QDBusMetaType>
+#include <QSocketNotifier>
 
 Q_DECLARE_METATYPE(QColor)
 
@@ -67,6 +69,10 @@ ColorPickerEffect::ColorPickerEffect()
 
 ColorPickerEffect::~ColorPickerEffect()
 {
+    if (m_readback) {
+        effects->makeOpenGLContextCurrent();
+        m_readback.reset();
+    }
     setPicking(false);
 }
 
@@ -90,7 +96,7 @@ QColor ColorPickerEffect::pick()
             QDBusConnection::sessionBus().send(m_replyMessage.createErrorReply(QStringLiteral("org.kde.kwin.ColorPicker.Error.Cancelled"), "Color picking got cancelled"));
             setPicking(false);
         } else {
-            const auto turnOffPicking = qScopeGuard([this] {
+            auto turnOffPicking = qScopeGuard([this] {
                 setPicking(false);
             });
 
@@ -138,16 +144,48 @@ QColor ColorPickerEffect::pick()
             }
 
             GLFramebuffer::pushFramebuffer(target.get());
-            QImage snapshot = QImage(offscreenTexture->size(), QImage::Format_RGBA8888);
-            context->glReadnPixels(0, 0, snapshot.width(), snapshot.height(), GL_RGBA, GL_UNSIGNED_BYTE, snapshot.sizeInBytes(), static_cast<GLvoid *>(snapshot.bits()));
+            m_readback = GLPixelPackBuffer::readPixels(context, Rect(0, 0, 1, 1), GL_RGBA);
             GLFramebuffer::popFramebuffer();
+            if (!m_readback) {
+                return;
+            }
 
-            QDBusConnection::sessionBus().send(m_replyMessage.createReply(snapshot.pixelColor(0, 0)));
+            // don't stall the compositor by waiting for the GPU to finish rendering the pixel
+            turnOffPicking.dismiss();
+            if (m_readback->fence().isValid()) {
+                m_readbackNotifier = std::make_unique<QSocketNotifier>(m_readback->fence().get(), QSocketNotifier::Read);
+                connect(m_readbackNotifier.get(), &QSocketNotifier::activated, this, &ColorPickerEffect::finishReadback);
+            } else {
+                finishReadback();
+            }
         }
     });
     return QColor();
 }
 
+void ColorPickerEffect::finishReadback()
+{
+    const auto turnOffPicking = qScopeGuard([this] {
+        setPicking(false);
+    });
+    if (m_readbackNotifier) {
+        m_readbackNotifier.release()->deleteLater();
+    }
+    const std::unique_ptr<GLPixelPackBuffer> readback = std::move(m_readback);
+    if (!effects->makeOpenGLContextCurrent()) {
+        return;
+    }
+
+    const uchar *pixel = readback->map();
+    if (!pixel) {
+        return;
+    }
+    const QColor color(pixel[0], pixel[1], pixel[2], pixel[3]);
+    readback->unmap();
+
+    QDBusConnection::sessionBus().send(m_replyMessage.createReply(color));
+}
+
 void ColorPickerEffect::showInfoMessage()
 {
     effects->showOnScreenMessage(i18n("Select a position for color picking with left click or enter.\nEscape or right click to cancel."), QStringLiteral("color-picker"));
@@ -15,9 +15,13 @@
 #include <QDBusUnixFileDescriptor>
 #include <QObject>
 
+class QSocketNotifier;
+
 namespace KWin
 {
 
+class GLPixelPackBuffer;
+
 class ColorPickerEffect : public Effect, protected QDBusContext
 {
     Q_OBJECT
@@ -42,8 +46,11 @@ private:
     void showInfoMessage();
     void hideInfoMessage();
     void setPicking(bool picking);
+    void finishReadback();
 
     QDBusMessage m_replyMessage;
+    std::unique_ptr<GLPixelPackBuffer> m_readback;
+    std::unique_ptr<QSocketNotifier> m_readbackNotifier;
     bool m_picking = false;
 };
 
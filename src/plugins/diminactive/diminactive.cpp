@@ -12,6 +12,7 @@
 // own
 #include "diminactive.h"
 #include "effect/effecthandler.h"
+#include "scene/windowitem.h"
 
 // KConfigSkeleton
 #include "diminactiveconfig.h"
@@ -47,8 +48,6 @@ DimInactiveEffect::DimInactiveEffect()
             this, &DimInactiveEffect::windowAdded);
     connect(effects, &EffectsHandler::windowClosed,
             this, &DimInactiveEffect::windowClosed);
-    connect(effects, &EffectsHandler::windowDeleted,
-            this, &DimInactiveEffect::windowDeleted);
     connect(effects, &EffectsHandler::activeFullScreenEffectChanged,
             this, &DimInactiveEffect::activeFullScreenEffectChanged);
 
@@ -60,6 +59,10 @@ DimInactiveEffect::DimInactiveEffect()
 
 DimInactiveEffect::~DimInactiveEffect()
 {
+    const auto windows = effects->stackingOrder();
+    for (EffectWindow *window : windows) {
+        window->windowItem()->clearRenderProperties(this);
+    }
 }
 
 void DimInactiveEffect::reconfigure(ReconfigureFlags flags)
@@ -80,85 +83,43 @@ void DimInactiveEffect::reconfigure(ReconfigureFlags flags)
         ? m_activeWindow->group()
         : nullptr;
 
-    m_fullScreenTransition.timeLine.setDuration(animationTime(250ms));
-
-    effects->addRepaintFull();
+    updateWindows(0ms);
 }
 
-void DimInactiveEffect::prePaintScreen(ScreenPrePaintData &data)
+qreal DimInactiveEffect::targetStrength(const EffectWindow *w) const
 {
-    if (m_fullScreenTransition.active) {
-        m_fullScreenTransition.timeLine.advance(data.view);
-    }
-
-    auto transitionIt = m_transitions.begin();
-    while (transitionIt != m_transitions.end()) {
-        (*transitionIt).advance(data.view);
-        ++transitionIt;
+    if (effects->activeFullScreenEffect() || !canDimWindow(w)) {
+        return 0.0;
     }
-
-    effects->prePaintScreen(data);
+    return m_dimStrength;
 }
 
-bool DimInactiveEffect::paintWindow(const RenderTarget &renderTarget, const RenderViewport &viewport, EffectWindow *w, int mask, const Region &deviceRegion, WindowPaintData &data)
+void DimInactiveEffect::updateWindow(EffectWindow *w, std::chrono::milliseconds duration)
 {
-    auto transitionIt = m_transitions.constFind(w);
-    if (transitionIt != m_transitions.constEnd()) {
-        const qreal transitionProgress = (*transitionIt).value();
-        dimWindow(data, m_dimStrength * transitionProgress);
-        return effects->paintWindow(renderTarget, viewport, w, mask, deviceRegion, data);
-    }
-
-    auto forceIt = m_forceDim.constFind(w);
-    if (forceIt != m_forceDim.constEnd()) {
-        const qreal forcedStrength = *forceIt;
-        dimWindow(data, forcedStrength);
-        return effects->paintWindow(renderTarget, viewport, w, mask, deviceRegion, data);
-    }
-
-    if (canDimWindow(w)) {
-        dimWindow(data, m_dimStrength);
-    }
-
-    return effects->paintWindow(renderTarget, viewport, w, mask, deviceRegion, data);
+    const qreal strength = targetStrength(w);
+    WindowItem::RenderProperties properties;
+    properties.brightness = 1.0 - strength;
+    properties.saturation = 1.0 - strength;
+    w->windowItem()->setRenderProperties(this, properties, duration);
 }
 
-void DimInactiveEffect::postPaintScreen()
+void DimInactiveEffect::updateWindows(std::optional<std::chrono::milliseconds> duration)
 {
-    if (m_fullScreenTransition.active) {
-        if (m_fullScreenTransition.timeLine.done()) {
-            m_fullScreenTransition.active = false;
+    const auto windows = effects->stackingOrder();
+    for (EffectWindow *w : windows) {
+        // Closed windows keep the dim strength they had, so that they don't flicker
+        // while some effect animates their disappearing.
+        if (w->isDeleted()) {
+            continue;
         }
-        effects->addRepaintFull();
-    }
-
-    auto transitionIt = m_transitions.begin();
-    while (transitionIt != m_transitions.end()) {
-        EffectWindow *w = transitionIt.key();
-        if ((*transitionIt).done()) {
-            transitionIt = m_transitions.erase(transitionIt);
+        if (duration) {
+            updateWindow(w, *duration);
         } else {
-            ++transitionIt;
+            // windows become dimmed slower than they become undimmed
+            const bool dim = targetStrength(w) > 0.0;
+            updateWindow(w, animationTime(dim ? 250ms : 160ms));
         }
-        w->addRepaintFull();
-    }
-
-    effects->postPaintScreen();
-}
-
-void DimInactiveEffect::dimWindow(WindowPaintData &data, qreal strength)
-{
-    qreal dimFactor;
-    if (m_fullScreenTransition.active) {
-        dimFactor = 1.0 - m_fullScreenTransition.timeLine.value();
-    } else if (effects->activeFullScreenEffect()) {
-        dimFactor = 0.0;
-    } else {
-        dimFactor = 1.0;
     }
-
-    data.multiplyBrightness(1.0 - strength * dimFactor);
-    data.multiplySaturation(1.0 - strength * dimFactor);
 }
 
 bool DimInactiveEffect::canDimWindow(const EffectWindow *w) const
@@ -202,87 +163,6 @@ bool DimInactiveEffect::canDimWindow(const EffectWindow *w) const
         || w->isDesktop();
 }
 
-void DimInactiveEffect::scheduleInTransition(EffectWindow *w)
-{
-    TimeLine &timeLine = m_transitions[w];
-    timeLine.setDuration(animationTime(160ms));
-    if (timeLine.done()) {
-        // If the Out animation is still active, then we're truncating
-        // duration of the timeline(from 250ms to 160ms). If the timeline
-        // is about to be finished with the old duration, then after
-        // changing duration it will be in the "done" state. Thus, we
-        // have to reset the timeline, otherwise it won't update progress.
-        timeLine.reset();
-    }
-    timeLine.setDirection(TimeLine::Backward);
-    timeLine.setEasingCurve(QEasingCurve::InOutSine);
-}
-
-void DimInactiveEffect::scheduleGroupInTransition(EffectWindow *w)
-{
-    if (!m_dimByGroup) {
-        scheduleInTransition(w);
-        return;
-    }
-
-    if (!w->group()) {
-        scheduleInTransition(w);
-        return;
-    }
-
-    const auto members = w->group()->members();
-    for (EffectWindow *member : members) {
-        scheduleInTransition(member);
-    }
-}
-
-void DimInactiveEffect::scheduleOutTransition(EffectWindow *w)
-{
-    TimeLine &timeLine = m_transitions[w];
-    timeLine.setDuration(animationTime(250ms));
-    if (timeLine.done()) {
-        timeLine.reset();
-    }
-    timeLine.setDirection(TimeLine::Forward);
-    timeLine.setEasingCurve(QEasingCurve::InOutSine);
-}
-
-void DimInactiveEffect::scheduleGroupOutTransition(EffectWindow *w)
-{
-    if (!m_dimByGroup) {
-        scheduleOutTransition(w);
-        return;
-    }
-
-    if (!w->group()) {
-        scheduleOutTransition(w);
-        return;
-    }
-
-    const auto members = w->group()->members();
-    for (EffectWindow *member : members) {
-        scheduleOutTransition(member);
-    }
-}
-
-void DimInactiveEffect::scheduleRepaint(EffectWindow *w)
-{
-    if (!m_dimByGroup) {
-        w->addRepaintFull();
-        return;
-    }
-
-    if (!w->group()) {
-        w->addRepaintFull();
-        return;
-    }
-
-    const auto members = w->group()->members();
-    for (EffectWindow *member : members) {
-        member->addRepaintFull();
-    }
-}
-
 void DimInactiveEffect::windowActivated(EffectWindow *w)
 {
     if (!w) {
@@ -316,14 +196,8 @@ void DimInactiveEffect::windowActivated(EffectWindow *w)
         ? m_activeWindow->group()
         : nullptr;
 
-    if (previousActiveWindow) {
-        scheduleGroupOutTransition(previousActiveWindow);
-        scheduleRepaint(previousActiveWindow);
-    }
-
-    if (m_activeWindow) {
-        scheduleGroupInTransition(m_activeWindow);
-        scheduleRepaint(m_activeWindow);
+    if (previousActiveWindow != m_activeWindow) {
+        updateWindows(std::nullopt);
     }
 }
 
@@ -333,51 +207,11 @@ void DimInactiveEffect::windowAdded(EffectWindow *w)
             this, &DimInactiveEffect::updateActiveWindow);
     connect(w, &EffectWindow::windowFullScreenChanged,
             this, &DimInactiveEffect::updateActiveWindow);
+    updateWindow(w, 0ms);
 }
 
 void DimInactiveEffect::windowClosed(EffectWindow *w)
 {
-    // When a window is closed, we should force current dim strength that
-    // is applied to it to avoid flickering when some effect animates
-    // the disappearing of the window. If there is no such effect then
-    // it won't be dimmed.
-    qreal forcedStrength = 0.0;
-    bool shouldForceDim = false;
-
-    auto transitionIt = m_transitions.find(w);
-    if (transitionIt != m_transitions.end()) {
-        forcedStrength = m_dimStrength * (*transitionIt).value();
-        shouldForceDim = true;
-        m_transitions.erase(transitionIt);
-    } else if (m_activeWindow == w) {
-        forcedStrength = 0.0;
-        shouldForceDim = true;
-    } else if (m_dimByGroup && belongToSameGroup(m_activeWindow, w)) {
-        forcedStrength = 0.0;
-        shouldForceDim = true;
-    } else if (canDimWindow(w)) {
-        forcedStrength = m_dimStrength;
-        shouldForceDim = true;
-    }
-
-    if (shouldForceDim) {
-        m_forceDim.insert(w, forcedStrength);
-    }
-
-    if (m_activeWindow == w) {
-        m_activeWindow = nullptr;
-    }
-}
-
-void DimInactiveEffect::windowDeleted(EffectWindow *w)
-{
-    m_forceDim.remove(w);
-
-    // FIXME: Sometimes we can miss the window close signal because KWin
-    // can activate a window that is not ready for painting and the window
-    // gets destroyed immediately. So, we have to remove active transitions
-    // for that window here, otherwise we'll crash in postPaintScreen.
-    m_transitions.remove(w);
     if (m_activeWindow == w) {
         m_activeWindow = nullptr;
     }
@@ -385,16 +219,7 @@ void DimInactiveEffect::windowDeleted(EffectWindow *w)
 
 void DimInactiveEffect::activeFullScreenEffectChanged()
 {
-    if (m_fullScreenTransition.timeLine.done()) {
-        m_fullScreenTransition.timeLine.reset();
-    }
-    m_fullScreenTransition.timeLine.setDirection(
-        effects->activeFullScreenEffect()
-            ? TimeLine::Forward
-            : TimeLine::Backward);
-    m_fullScreenTransition.active = true;
-
-    effects->addRepaintFull();
+    updateWindows(animationTime(250ms));
 }
 
 void DimInactiveEffect::updateActiveWindow(EffectWindow *w)
@@ -411,6 +236,7 @@ void DimInactiveEffect::updateActiveWindow(EffectWindow *w)
     m_activeWindow = nullptr;
 
     m_activeWindow = canDimWindow(w) ? w : nullptr;
+    updateWindows(std::nullopt);
 }
 
 } // namespace KWin
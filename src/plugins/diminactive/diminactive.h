@@ -13,7 +13,9 @@
 
 // kwineffects
 #include "effect/effect.h"
-#include "effect/timeline.h"
+
+#include <chrono>
+#include <optional>
 
 namespace KWin
 {
@@ -36,10 +38,6 @@ public:
 
     void reconfigure(ReconfigureFlags flags) override;
 
-    void prePaintScreen(ScreenPrePaintData &data) override;
-    bool paintWindow(const RenderTarget &renderTarget, const RenderViewport &viewport, EffectWindow *w, int mask, const Region &deviceRegion, WindowPaintData &data) override;
-    void postPaintScreen() override;
-
     int requestedEffectChainPosition() const override;
     bool isActive() const override;
 
@@ -54,19 +52,19 @@ private Q_SLOTS:
     void windowActivated(EffectWindow *w);
     void windowAdded(EffectWindow *w);
     void windowClosed(EffectWindow *w);
-    void windowDeleted(EffectWindow *w);
     void activeFullScreenEffectChanged();
 
     void updateActiveWindow(EffectWindow *w);
 
 private:
-    void dimWindow(WindowPaintData &data, qreal strength);
     bool canDimWindow(const EffectWindow *w) const;
-    void scheduleInTransition(EffectWindow *w);
-    void scheduleGroupInTransition(EffectWindow *w);
-    void scheduleOutTransition(EffectWindow *w);
-    void scheduleGroupOutTransition(EffectWindow *w);
-    void scheduleRepaint(EffectWindow *w);
+    qreal targetStrength(const EffectWindow *w) const;
+    void updateWindow(EffectWindow *w, std::chrono::milliseconds duration);
+    /**
+     * Updates the dim strength of all windows. If no @a duration is given, the windows
+     * that get dimmed and undimmed use different durations.
+     */
+    void updateWindows(std::optional<std::chrono::milliseconds> duration);
 
 private:
     qreal m_dimStrength;
@@ -78,14 +76,6 @@ private:
 
     EffectWindow *m_activeWindow = nullptr;
     const EffectWindowGroup *m_activeWindowGroup;
-    QHash<EffectWindow *, TimeLine> m_transitions;
-    QHash<EffectWindow *, qreal> m_forceDim;
-
-    struct
-    {
-        bool active = false;
-        TimeLine timeLine;
-    } m_fullScreenTransition;
 };
 
 inline int DimInactiveEffect::requestedEffectChainPosition() const
@@ -95,7 +85,8 @@ inline int DimInactiveEffect::requestedEffectChainPosition() const
 
 inline bool DimInactiveEffect::isActive() const
 {
-    return true;
+    // the windows are dimmed with their render properties, not in the paint chain
+    return false;
 }
 
 inline int DimInactiveEffect::dimStrength() const
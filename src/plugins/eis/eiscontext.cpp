@@ -124,6 +124,24 @@ static std::chrono::microseconds currentTime()
     return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch());
 }
 
+/**
+ * The events of one frame happen at the same time, so the pointer motion in a frame is summed
+ * up or only its last absolute position is used. Remote desktop clients can send many motion
+ * events per frame, it's sent once before any other event of the device and at the end of the frame.
+ */
+static void flushPendingMotion(EisDevice *device)
+{
+    if (!device) {
+        return;
+    }
+    if (const auto delta = std::exchange(device->pendingMotion, std::nullopt)) {
+        Q_EMIT device->pointerMotion(*delta, *delta, currentTime(), device);
+    }
+    if (const auto position = std::exchange(device->pendingAbsoluteMotion, std::nullopt)) {
+        Q_EMIT device->pointerMotionAbsolute(*position, currentTime(), device);
+    }
+}
+
 void EisContext::updateKeymap()
 {
     for (const auto &client : m_clients) {
@@ -183,7 +201,12 @@ void EisContext::handleEvents()
             continue;
         }
 
-        switch (eis_event_get_type(event)) {
+        const auto type = eis_event_get_type(event);
+        if (device && type != EIS_EVENT_POINTER_MOTION && type != EIS_EVENT_POINTER_MOTION_ABSOLUTE) {
+            flushPendingMotion(device);
+        }
+
+        switch (type) {
         case EIS_EVENT_CLIENT_CONNECT: {
             auto client = eis_event_get_client(event);
             const char *clientName = eis_client_get_name(client);
@@ -269,15 +292,20 @@ void EisContext::handleEvents()
             const double x = eis_event_pointer_get_dx(event);
             const double y = eis_event_pointer_get_dy(event);
             qCDebug(KWIN_EIS) << device->name() << "pointer motion" << x << y;
-            const QPointF delta(x, y);
-            Q_EMIT device->pointerMotion(delta, delta, currentTime(), device);
+            if (device->pendingAbsoluteMotion) {
+                flushPendingMotion(device);
+            }
+            device->pendingMotion = device->pendingMotion.value_or(QPointF()) + QPointF(x, y);
             break;
         }
         case EIS_EVENT_POINTER_MOTION_ABSOLUTE: {
             const double x = eis_event_pointer_get_absolute_x(event);
             const double y = eis_event_pointer_get_absolute_y(event);
             qCDebug(KWIN_EIS) << device->name() << "pointer motion absolute" << x << y;
-            Q_EMIT device->pointerMotionAbsolute({x, y}, currentTime(), device);
+            if (device->pendingMotion) {
+                flushPendingMotion(device);
+            }
+            device->pendingAbsoluteMotion = QPointF(x, y);
             break;
         }
         case EIS_EVENT_BUTTON_BUTTON: {
@@ -286,12 +314,12 @@ void EisContext::handleEvents()
             qCDebug(KWIN_EIS) << device->name() << "button" << button << press;
             if (press) {
                 if (device->pressedButtons.contains(button)) {
-                    continue;
+                    break;
                 }
                 device->pressedButtons.insert(button);
             } else {
                 if (!device->pressedButtons.remove(button)) {
-                    continue;
+                    break;
                 }
             }
             Q_EMIT device->pointerButtonChanged(button, press ? PointerButtonState::Pressed : PointerButtonState::Released, currentTime(), device);
@@ -392,6 +420,12 @@ void EisContext::handleEvents()
         }
         eis_event_unref(event);
     }
+
+    // clients should end every batch of events with a frame, but don't hold on to motion if they don't
+    for (const auto &client : m_clients) {
+        flushPendingMotion(client->absoluteDevice.get());
+        flushPendingMotion(client->pointer.get());
+    }
 }
 
 }
@@ -11,6 +11,7 @@
 #include "xkb.h"
 
 #include <memory>
+#include <optional>
 
 struct eis_device;
 
@@ -39,6 +40,10 @@ public:
     QSet<quint32> pressedKeys;
     std::vector<int> activeTouches;
 
+    // pointer motion of the current frame, it is sent once with the end of the frame
+    std::optional<QPointF> pendingMotion;
+    std::optional<QPointF> pendingAbsoluteMotion;
+
     QString name() const override;
 
     bool isEnabled() const override;
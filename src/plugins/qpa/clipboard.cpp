@@ -125,7 +125,7 @@ QVariant ClipboardMimeData::retrieveData(const QString &mimeType, QMetaType pref
         return QVariant();
     }
 
-    m_dataSource->requestData(mimeType, std::move(pipe->writeEndpoint));
+    m_dataSource->receive(mimeType, std::move(pipe->writeEndpoint));
 
     waylandServer()->display()->flush();
     return readData(std::move(pipe->readEndpoint));
@@ -101,14 +101,23 @@ Region RegionScreenCastSource::render(GLFramebuffer *target, const Region &buffe
 
 Region RegionScreenCastSource::render(QImage *target, const Region &bufferRepair)
 {
-    auto texture = GLTexture::allocate(GL_RGBA8, target->size());
-    if (!texture) {
-        return Region{};
+    // The offscreen texture is kept around so only the damaged parts of the scene need to be
+    // repainted, just like with dmabuf buffers
+    Region repair;
+    if (!m_offscreenTexture || m_offscreenTexture->size() != target->size()) {
+        m_offscreenFramebuffer.reset();
+        m_offscreenTexture = GLTexture::allocate(GL_RGBA8, target->size());
+        if (!m_offscreenTexture) {
+            return Region{};
+        }
+        m_offscreenFramebuffer = std::make_unique<GLFramebuffer>(m_offscreenTexture.get());
+        repair = Region::infinite();
     }
-    GLFramebuffer buffer(texture.get());
-    const Region ret = render(&buffer, Region::infinite());
-    grabTexture(texture.get(), target);
-    return ret;
+    const Region damage = render(m_offscreenFramebuffer.get(), repair);
+    if (!damage.isEmpty() || !bufferRepair.isEmpty()) {
+        grabTexture(m_offscreenTexture.get(), target);
+    }
+    return damage;
 }
 
 uint RegionScreenCastSource::refreshRate() const
@@ -143,6 +152,11 @@ void RegionScreenCastSource::pause()
     m_cursorView.reset();
     m_sceneView.reset();
     m_layer.reset();
+    if (m_offscreenTexture) {
+        static_cast<EglBackend *>(Compositor::self()->backend())->openglContext()->makeCurrent();
+        m_offscreenFramebuffer.reset();
+        m_offscreenTexture.reset();
+    }
 }
 
 void RegionScreenCastSource::resume()
@@ -13,6 +13,8 @@ namespace KWin
 {
 
 class FilteredSceneView;
+class GLFramebuffer;
+class GLTexture;
 class ItemTreeView;
 class RegionScreenCastSource;
 class ScreencastLayer;
@@ -56,6 +58,8 @@ private:
     std::unique_ptr<ScreencastLayer> m_layer;
     std::unique_ptr<FilteredSceneView> m_sceneView;
     std::unique_ptr<ItemTreeView> m_cursorView;
+    std::unique_ptr<GLTexture> m_offscreenTexture;
+    std::unique_ptr<GLFramebuffer> m_offscreenFramebuffer;
 };
 
 } // namespace KWin
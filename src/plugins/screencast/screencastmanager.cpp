@@ -16,6 +16,7 @@
 #include "pipewirecore.h"
 #include "regionscreencastsource.h"
 #include "screencaststream.h"
+#include "sharedscreencastsource.h"
 #include "wayland/clientconnection.h"
 #include "wayland/display.h"
 #include "wayland/output.h"
@@ -63,7 +64,10 @@ void ScreencastManager::streamWindow(ScreencastStreamV1Interface *waylandStream,
         return;
     }
 
-    auto stream = new ScreenCastStream(new WindowScreenCastSource(window), getPipewireConnection(), this);
+    auto source = sharedSource(CaptureKey{window, std::nullopt, mode == ScreencastV1Interface::Embedded}, [window]() {
+        return new WindowScreenCastSource(window);
+    });
+    auto stream = new ScreenCastStream(source, getPipewireConnection(), this);
     stream->setObjectName(window->desktopFileName());
     stream->setCursorMode(mode);
 
@@ -110,7 +114,11 @@ void ScreencastManager::streamOutput(ScreencastStreamV1Interface *waylandStream,
         return;
     }
 
-    auto stream = new ScreenCastStream(new OutputScreenCastSource(streamOutput, waylandStream->connection()->processId()), getPipewireConnection(), this);
+    const pid_t pidToHide = waylandStream->connection()->processId();
+    auto source = sharedSource(CaptureKey{streamOutput, pidToHide, mode == ScreencastV1Interface::Embedded}, [streamOutput, pidToHide]() {
+        return new OutputScreenCastSource(streamOutput, pidToHide);
+    });
+    auto stream = new ScreenCastStream(source, getPipewireConnection(), this);
     stream->setObjectName(streamOutput->name());
     stream->setCursorMode(mode);
 
@@ -177,6 +185,25 @@ void ScreencastManager::integrateStreams(ScreencastStreamV1Interface *waylandStr
     }
 }
 
+ScreenCastSource *ScreencastManager::sharedSource(const CaptureKey &key, const std::function<ScreenCastSource *()> &create)
+{
+    std::erase_if(m_captures, [](const auto &entry) {
+        return !entry.second.object || entry.second.capture.expired();
+    });
+
+    std::shared_ptr<ScreenCastCapture> capture;
+    if (auto it = m_captures.find(key); it != m_captures.end()) {
+        capture = it->second.capture.lock();
+    } else {
+        capture = std::make_shared<ScreenCastCapture>(std::unique_ptr<ScreenCastSource>(create()));
+        m_captures[key] = CaptureEntry{
+            .object = key.object,
+            .capture = capture,
+        };
+    }
+    return new SharedScreenCastSource(capture);
+}
+
 std::shared_ptr<PipeWireCore> ScreencastManager::getPipewireConnection()
 {
     if (m_pipewireConnectionCache && m_pipewireConnectionCache->isValid()) {
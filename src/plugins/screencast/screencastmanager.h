@@ -12,10 +12,17 @@
 
 #include "wayland/screencast_v1.h"
 
+#include <QPointer>
+
+#include <functional>
+#include <map>
+
 namespace KWin
 {
 
 class LogicalOutput;
+class ScreenCastCapture;
+class ScreenCastSource;
 class ScreenCastStream;
 class PipeWireCore;
 
@@ -48,10 +55,30 @@ private:
 
     void integrateStreams(ScreencastStreamV1Interface *waylandStream, ScreenCastStream *stream);
 
+    /**
+     * Streams of the same object with the same cursor mode show the same contents, so
+     * they share one capture, which renders once per frame for all of them.
+     */
+    struct CaptureKey
+    {
+        QObject *object;
+        std::optional<pid_t> pidToHide;
+        bool embedCursor;
+
+        auto operator<=>(const CaptureKey &other) const = default;
+    };
+    struct CaptureEntry
+    {
+        QPointer<QObject> object;
+        std::weak_ptr<ScreenCastCapture> capture;
+    };
+    ScreenCastSource *sharedSource(const CaptureKey &key, const std::function<ScreenCastSource *()> &create);
+
     std::shared_ptr<PipeWireCore> getPipewireConnection();
 
     ScreencastV1Interface *m_screencast;
     std::shared_ptr<PipeWireCore> m_pipewireConnectionCache;
+    std::map<CaptureKey, CaptureEntry> m_captures;
 };
 
 } // namespace KWin
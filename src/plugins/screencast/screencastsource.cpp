@@ -13,6 +13,11 @@ ScreenCastSource::ScreenCastSource()
 {
 }
 
+bool ScreenCastSource::supportsDownscaling() const
+{
+    return false;
+}
+
 } // namespace KWin
 
 #include "moc_screencastsource.cpp"
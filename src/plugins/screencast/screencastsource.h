@@ -30,6 +30,11 @@ public:
     virtual quint32 drmFormat() const = 0;
     virtual QSize textureSize() const = 0;
     virtual qreal devicePixelRatio() const = 0;
+    /**
+     * Returns @c true if the source can render into buffers that are smaller than textureSize(),
+     * in which case the consumers of the stream can ask for any size up to textureSize().
+     */
+    virtual bool supportsDownscaling() const;
 
     virtual void setRenderCursor(bool enable) = 0;
     virtual Region render(GLFramebuffer *target, const Region &bufferRepair) = 0;
@@ -155,7 +155,8 @@ void ScreenCastStream::newStreamParams()
     qCDebug(KWIN_SCREENCAST) << objectName() << "announcing stream params. with dmabuf:" << m_dmabufParams.has_value();
     const int buffertypes = m_dmabufParams ? (1 << SPA_DATA_DmaBuf) : (1 << SPA_DATA_MemFd);
     const int bpp = m_videoFormat.format == SPA_VIDEO_FORMAT_RGB || m_videoFormat.format == SPA_VIDEO_FORMAT_BGR ? 3 : 4;
-    const int stride = SPA_ROUND_UP_N(m_resolution.width() * bpp, 4);
+    const QSize size = negotiatedSize();
+    const int stride = SPA_ROUND_UP_N(size.width() * bpp, 4);
 
     struct spa_pod_dynamic_builder pod_builder;
     struct spa_pod_frame f;
@@ -187,7 +188,7 @@ void ScreenCastStream::newStreamParams()
     if (!m_dmabufParams) {
         spa_pod_builder_add(&pod_builder.b,
                             SPA_PARAM_BUFFERS_blocks, SPA_POD_Int(1),
-                            SPA_PARAM_BUFFERS_size, SPA_POD_Int(stride * m_resolution.height()),
+                            SPA_PARAM_BUFFERS_size, SPA_POD_Int(stride * size.height()),
                             SPA_PARAM_BUFFERS_stride, SPA_POD_Int(stride),
                             SPA_PARAM_BUFFERS_align, SPA_POD_Int(16), 0);
     } else {
@@ -247,13 +248,14 @@ void ScreenCastStream::onStreamParamChanged(uint32_t id, const struct spa_pod *f
             receivedModifiers.insert(values[i]);
         }
 
-        if (!m_dmabufParams || m_dmabufParams->width != m_resolution.width() || m_dmabufParams->height != m_resolution.height() || !receivedModifiers.contains(m_dmabufParams->modifier)) {
+        const QSize size = negotiatedSize();
+        if (!m_dmabufParams || m_dmabufParams->width != size.width() || m_dmabufParams->height != size.height() || !receivedModifiers.contains(m_dmabufParams->modifier)) {
             // DRM_MOD_INVALID should be used as a last option. Do not just remove it it's the only
             // item on the list
             if (receivedModifiers.size() > 1) {
                 receivedModifiers.erase(DRM_FORMAT_MOD_INVALID);
             }
-            m_dmabufParams = testCreateDmaBuf(m_resolution, m_drmFormat, receivedModifiers);
+            m_dmabufParams = testCreateDmaBuf(size, m_drmFormat, receivedModifiers);
 
             // In case we fail to use any modifier from the list of offered ones, remove these
             // from our all future offerings, otherwise there will be no indication that it cannot
@@ -620,7 +622,6 @@ void ScreenCastStream::record(Contents contents)
     if (effectiveContents & Content::Video) {
         if (auto memfd = dynamic_cast<MemFdScreenCastBuffer *>(buffer)) {
             damage = m_source->render(memfd->view.image(), m_damageJournal.accumulate(memfd->m_age, Region::infinite()));
-            bumpBufferAge(memfd);
         } else if (auto dmabuf = dynamic_cast<DmaBufScreenCastBuffer *>(buffer)) {
             if (dmabuf->synctimeline) {
                 synctmeta = static_cast<spa_meta_sync_timeline *>(spa_buffer_find_meta_data(spa_buffer,
@@ -634,8 +635,17 @@ void ScreenCastStream::record(Contents contents)
             }
 
             damage = m_source->render(dmabuf->framebuffer.get(), m_damageJournal.accumulate(dmabuf->m_age, Region::infinite()));
-            bumpBufferAge(dmabuf);
         }
+
+        // If nothing has changed since the last frame, the consumer already has the current
+        // contents, keep the buffer for the next frame instead of sending a duplicate. A buffer
+        // that has never been sent must be sent though, e.g. after the stream has been resized.
+        if (damage.isEmpty() && !(contents & Content::Cursor) && buffer->m_age > 0 && m_lastSent.has_value()) {
+            m_dequeuedBuffers.append(pwBuffer);
+            return;
+        }
+
+        bumpBufferAge(buffer);
         m_damageJournal.add(damage);
     }
 
@@ -697,6 +707,14 @@ void ScreenCastStream::resize(const QSize &resolution)
     pw_stream_update_params(m_pwStream, params.data(), params.count());
 }
 
+QSize ScreenCastStream::negotiatedSize() const
+{
+    if (m_videoFormat.size.width == 0 || m_videoFormat.size.height == 0) {
+        return m_resolution;
+    }
+    return QSize(m_videoFormat.size.width, m_videoFormat.size.height);
+}
+
 void ScreenCastStream::addHeader(spa_buffer *spaBuffer)
 {
     spa_meta_header *spaHeader = (spa_meta_header *)spa_buffer_find_meta_data(spaBuffer, SPA_META_Header, sizeof(spa_meta_header));
@@ -759,27 +777,35 @@ QList<const spa_pod *> ScreenCastStream::buildFormats(bool fixate, char buffer[2
     spa_fraction maxFramerate = SPA_FRACTION(m_source->refreshRate() / 1000, 1);
 
     spa_rectangle resolution = SPA_RECTANGLE(uint32_t(m_resolution.width()), uint32_t(m_resolution.height()));
+    // sources that can downscale let consumers like thumbnails pick a smaller size
+    spa_rectangle minResolution = SPA_RECTANGLE(1, 1);
+    spa_rectangle *minResolutionChoice = m_source->supportsDownscaling() ? &minResolution : nullptr;
 
     QList<const spa_pod *> params;
     if (m_hasDmaBuf) {
         if (fixate) {
-            params.append(buildFormat(&podBuilder, dmabufFormat, &resolution, &defFramerate, &minFramerate, &maxFramerate, {m_dmabufParams->modifier}, SPA_POD_PROP_FLAG_MANDATORY));
+            spa_rectangle fixatedResolution = SPA_RECTANGLE(uint32_t(m_dmabufParams->width), uint32_t(m_dmabufParams->height));
+            params.append(buildFormat(&podBuilder, dmabufFormat, &fixatedResolution, nullptr, &defFramerate, &minFramerate, &maxFramerate, {m_dmabufParams->modifier}, SPA_POD_PROP_FLAG_MANDATORY));
         }
-        params.append(buildFormat(&podBuilder, dmabufFormat, &resolution, &defFramerate, &minFramerate, &maxFramerate, m_modifiers, SPA_POD_PROP_FLAG_MANDATORY | SPA_POD_PROP_FLAG_DONT_FIXATE));
+        params.append(buildFormat(&podBuilder, dmabufFormat, &resolution, minResolutionChoice, &defFramerate, &minFramerate, &maxFramerate, m_modifiers, SPA_POD_PROP_FLAG_MANDATORY | SPA_POD_PROP_FLAG_DONT_FIXATE));
     }
-    params.append(buildFormat(&podBuilder, shmFormat, &resolution, &defFramerate, &minFramerate, &maxFramerate, {}, 0));
+    params.append(buildFormat(&podBuilder, shmFormat, &resolution, minResolutionChoice, &defFramerate, &minFramerate, &maxFramerate, {}, 0));
     return params;
 }
 
 spa_pod *ScreenCastStream::buildFormat(struct spa_pod_builder *b, enum spa_video_format format, struct spa_rectangle *resolution,
-                                       struct spa_fraction *defaultFramerate, struct spa_fraction *minFramerate, struct spa_fraction *maxFramerate,
+                                       struct spa_rectangle *minResolution, struct spa_fraction *defaultFramerate, struct spa_fraction *minFramerate, struct spa_fraction *maxFramerate,
                                        const ModifierList &modifiers, quint32 modifiersFlags)
 {
     struct spa_pod_frame f[2];
     spa_pod_builder_push_object(b, &f[0], SPA_TYPE_OBJECT_Format, SPA_PARAM_EnumFormat);
     spa_pod_builder_add(b, SPA_FORMAT_mediaType, SPA_POD_Id(SPA_MEDIA_TYPE_video), 0);
     spa_pod_builder_add(b, SPA_FORMAT_mediaSubtype, SPA_POD_Id(SPA_MEDIA_SUBTYPE_raw), 0);
-    spa_pod_builder_add(b, SPA_FORMAT_VIDEO_size, SPA_POD_Rectangle(resolution), 0);
+    if (minResolution) {
+        spa_pod_builder_add(b, SPA_FORMAT_VIDEO_size, SPA_POD_CHOICE_RANGE_Rectangle(resolution, minResolution, resolution), 0);
+    } else {
+        spa_pod_builder_add(b, SPA_FORMAT_VIDEO_size, SPA_POD_Rectangle(resolution), 0);
+    }
     spa_pod_builder_add(b, SPA_FORMAT_VIDEO_framerate, SPA_POD_Fraction(defaultFramerate), 0);
     spa_pod_builder_add(b, SPA_FORMAT_VIDEO_maxFramerate,
                         SPA_POD_CHOICE_RANGE_Fraction(
@@ -832,7 +858,7 @@ void ScreenCastStream::addCursorMetadata(spa_buffer *spaBuffer, Cursor *cursor)
     }
     m_cursor.visible = true;
 
-    const qreal scale = m_source->devicePixelRatio();
+    const qreal scale = m_source->devicePixelRatio() * negotiatedSize().width() / std::max(m_resolution.width(), 1);
     const auto position = m_source->mapFromGlobal(cursor->pos()) * scale;
 
     spaMetaCursor->id = 1;
@@ -91,6 +91,11 @@ private:
     QList<const spa_pod *> buildFormats(bool fixate, char buffer[2048]);
     void updateParams();
     void resize(const QSize &resolution);
+    /**
+     * Returns the size of the buffers the consumer agreed on, which can be smaller than
+     * the size of the source if the source supports downscaling.
+     */
+    QSize negotiatedSize() const;
     void coreFailed(const QString &errorMessage);
     void addCursorMetadata(spa_buffer *spaBuffer, Cursor *cursor);
     void addHeader(spa_buffer *spaBuffer);
@@ -98,7 +103,7 @@ private:
     void addDamage(spa_buffer *spaBuffer, const Region &damagedRegion);
     void newStreamParams();
     spa_pod *buildFormat(struct spa_pod_builder *b, enum spa_video_format format, struct spa_rectangle *resolution,
-                         struct spa_fraction *defaultFramerate, struct spa_fraction *minFramerate, struct spa_fraction *maxFramerate,
+                         struct spa_rectangle *minResolution, struct spa_fraction *defaultFramerate, struct spa_fraction *minFramerate, struct spa_fraction *maxFramerate,
                          const ModifierList &modifiers, quint32 modifiersFlags);
     pw_buffer *dequeueBuffer();
     void record(Contents contents);
@@ -117,7 +122,7 @@ private:
     QSize m_resolution;
     bool m_closed = false;
 
-    spa_video_info_raw m_videoFormat;
+    spa_video_info_raw m_videoFormat{};
     QString m_error;
     ModifierList m_modifiers;
     std::optional<ScreenCastDmaBufTextureParams> m_dmabufParams; // when fixated
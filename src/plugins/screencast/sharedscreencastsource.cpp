@@ -0,0 +1,300 @@
+/*
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "sharedscreencastsource.h"
+
+#include "core/region.h"
+#include "opengl/glframebuffer.h"
+#include "opengl/gltexture.h"
+
+#include <QPainter>
+
+namespace KWin
+{
+
+ScreenCastCapture::ScreenCastCapture(std::unique_ptr<ScreenCastSource> &&source)
+    : m_source(std::move(source))
+{
+    connect(m_source.get(), &ScreenCastSource::frame, this, [this]() {
+        m_frameSerial++;
+        Q_EMIT frame();
+    });
+    connect(m_source.get(), &ScreenCastSource::closed, this, &ScreenCastCapture::closed);
+}
+
+ScreenCastCapture::~ScreenCastCapture()
+{
+    Q_ASSERT(m_consumers.isEmpty());
+}
+
+ScreenCastSource *ScreenCastCapture::source() const
+{
+    return m_source.get();
+}
+
+void ScreenCastCapture::attach(SharedScreenCastSource *consumer)
+{
+    m_consumers.append(consumer);
+}
+
+void ScreenCastCapture::detach(SharedScreenCastSource *consumer)
+{
+    m_consumers.removeOne(consumer);
+}
+
+void ScreenCastCapture::resume()
+{
+    m_activeCount++;
+    if (m_activeCount == 1) {
+        m_source->resume();
+    } else {
+        // the other streams already have the current contents, only the new one needs a frame
+        Q_EMIT frame();
+    }
+}
+
+void ScreenCastCapture::pause()
+{
+    m_activeCount--;
+    if (m_activeCount == 0) {
+        m_source->pause();
+        invalidate();
+    }
+}
+
+void ScreenCastCapture::setRenderCursor(bool enable)
+{
+    if (m_renderCursor != enable) {
+        m_renderCursor = enable;
+        m_source->setRenderCursor(enable);
+        m_frameSerial++;
+    }
+}
+
+void ScreenCastCapture::invalidate()
+{
+    m_framebufferCache.valid = false;
+    m_imageCache.valid = false;
+}
+
+bool ScreenCastCapture::updateFramebufferCache()
+{
+    const QSize size = m_source->textureSize();
+    if (!m_framebufferCache.texture || m_framebufferCache.texture->size() != size) {
+        m_framebufferCache.framebuffer.reset();
+        m_framebufferCache.texture = GLTexture::allocate(GL_RGBA8, size);
+        if (!m_framebufferCache.texture) {
+            return false;
+        }
+        m_framebufferCache.framebuffer = std::make_unique<GLFramebuffer>(m_framebufferCache.texture.get());
+        m_framebufferCache.valid = false;
+    }
+
+    if (m_framebufferCache.valid && m_framebufferCache.frameSerial == m_frameSerial) {
+        return true;
+    }
+
+    Region damage = m_source->render(m_framebufferCache.framebuffer.get(), m_framebufferCache.valid ? Region() : Region::infinite());
+    if (!m_framebufferCache.valid) {
+        m_framebufferCache.journal.clear();
+        damage = Rect(QPoint(), size);
+    }
+    m_framebufferCache.journal.add(damage);
+    m_framebufferCache.renderCount++;
+    m_framebufferCache.frameSerial = m_frameSerial;
+    m_framebufferCache.valid = true;
+    return true;
+}
+
+bool ScreenCastCapture::updateImageCache(const QImage &format)
+{
+    const QSize size = m_source->textureSize();
+    if (m_imageCache.image.size() != size || m_imageCache.image.format() != format.format()) {
+        m_imageCache.image = QImage(size, format.format());
+        if (m_imageCache.image.isNull()) {
+            return false;
+        }
+        m_imageCache.valid = false;
+    }
+
+    if (m_imageCache.valid && m_imageCache.frameSerial == m_frameSerial) {
+        return true;
+    }
+
+    Region damage = m_source->render(&m_imageCache.image, m_imageCache.valid ? Region() : Region::infinite());
+    if (!m_imageCache.valid) {
+        m_imageCache.journal.clear();
+        damage = Rect(QPoint(), size);
+    }
+    m_imageCache.journal.add(damage);
+    m_imageCache.renderCount++;
+    m_imageCache.frameSerial = m_frameSerial;
+    m_imageCache.valid = true;
+    return true;
+}
+
+Region ScreenCastCapture::render(SharedScreenCastSource *consumer, GLFramebuffer *target, const Region &bufferRepair)
+{
+    if (m_consumers.size() == 1) {
+        invalidate();
+        return m_source->render(target, bufferRepair);
+    }
+
+    if (!updateFramebufferCache()) {
+        return Region{};
+    }
+
+    const Rect bounds(QPoint(), target->size());
+    const Region damage = m_framebufferCache.journal.accumulate(m_framebufferCache.renderCount - consumer->m_framebufferRenderCount + 1, Region::infinite());
+    consumer->m_framebufferRenderCount = m_framebufferCache.renderCount;
+
+    GLFramebuffer::pushFramebuffer(m_framebufferCache.framebuffer.get());
+    if (target->size() != m_framebufferCache.texture->size()) {
+        // the consumer asked for a smaller size or the buffers of the stream haven't been
+        // resized yet, scale the whole frame
+        target->blitFromFramebuffer(Rect(), Rect(), GL_LINEAR);
+        GLFramebuffer::popFramebuffer();
+        return bounds;
+    }
+    const Region repaint = (damage | bufferRepair) & bounds;
+    for (const Rect &rect : repaint.rects()) {
+        target->blitFromFramebuffer(rect, rect, GL_NEAREST);
+    }
+    GLFramebuffer::popFramebuffer();
+
+    return damage & bounds;
+}
+
+Region ScreenCastCapture::render(SharedScreenCastSource *consumer, QImage *target, const Region &bufferRepair)
+{
+    if (m_consumers.size() == 1) {
+        invalidate();
+        return m_source->render(target, bufferRepair);
+    }
+
+    if (!updateImageCache(*target)) {
+        return Region{};
+    }
+
+    const Rect bounds(QPoint(), target->size());
+    const Region damage = m_imageCache.journal.accumulate(m_imageCache.renderCount - consumer->m_imageRenderCount + 1, Region::infinite());
+    consumer->m_imageRenderCount = m_imageCache.renderCount;
+
+    const QImage &source = m_imageCache.image;
+    if (target->size() != source.size()) {
+        QPainter painter(target);
+        painter.setCompositionMode(QPainter::CompositionMode_Source);
+        painter.drawImage(QRect(QPoint(), target->size()), source);
+        return bounds;
+    }
+    const int bytesPerPixel = source.depth() / 8;
+    const Region repaint = (damage | bufferRepair) & bounds;
+    for (const Rect &rect : repaint.rects()) {
+        for (int y = rect.y(); y < rect.y() + rect.height(); ++y) {
+            memcpy(target->scanLine(y) + rect.x() * bytesPerPixel, source.constScanLine(y) + rect.x() * bytesPerPixel, rect.width() * bytesPerPixel);
+        }
+    }
+
+    return damage & bounds;
+}
+
+SharedScreenCastSource::SharedScreenCastSource(const std::shared_ptr<ScreenCastCapture> &capture)
+    : m_capture(capture)
+{
+    m_capture->attach(this);
+    connect(m_capture.get(), &ScreenCastCapture::frame, this, [this]() {
+        if (m_active) {
+            Q_EMIT frame();
+        }
+    });
+    connect(m_capture.get(), &ScreenCastCapture::closed, this, &SharedScreenCastSource::closed);
+}
+
+SharedScreenCastSource::~SharedScreenCastSource()
+{
+    pause();
+    m_capture->detach(this);
+}
+
+uint SharedScreenCastSource::refreshRate() const
+{
+    return m_capture->source()->refreshRate();
+}
+
+quint32 SharedScreenCastSource::drmFormat() const
+{
+    return m_capture->source()->drmFormat();
+}
+
+QSize SharedScreenCastSource::textureSize() const
+{
+    return m_capture->source()->textureSize();
+}
+
+qreal SharedScreenCastSource::devicePixelRatio() const
+{
+    return m_capture->source()->devicePixelRatio();
+}
+
+bool SharedScreenCastSource::supportsDownscaling() const
+{
+    return m_capture->source()->supportsDownscaling();
+}
+
+void SharedScreenCastSource::setRenderCursor(bool enable)
+{
+    m_capture->setRenderCursor(enable);
+}
+
+Region SharedScreenCastSource::render(GLFramebuffer *target, const Region &bufferRepair)
+{
+    return m_capture->render(this, target, bufferRepair);
+}
+
+Region SharedScreenCastSource::render(QImage *target, const Region &bufferRepair)
+{
+    return m_capture->render(this, target, bufferRepair);
+}
+
+std::chrono::nanoseconds SharedScreenCastSource::clock() const
+{
+    return m_capture->source()->clock();
+}
+
+void SharedScreenCastSource::resume()
+{
+    if (!m_active) {
+        m_active = true;
+        m_capture->resume();
+    }
+}
+
+void SharedScreenCastSource::pause()
+{
+    if (m_active) {
+        m_active = false;
+        m_capture->pause();
+    }
+}
+
+bool SharedScreenCastSource::includesCursor(Cursor *cursor) const
+{
+    return m_capture->source()->includesCursor(cursor);
+}
+
+QPointF SharedScreenCastSource::mapFromGlobal(const QPointF &point) const
+{
+    return m_capture->source()->mapFromGlobal(point);
+}
+
+RectF SharedScreenCastSource::mapFromGlobal(const RectF &rect) const
+{
+    return m_capture->source()->mapFromGlobal(rect);
+}
+
+} // namespace KWin
+
+#include "moc_sharedscreencastsource.cpp"
@@ -0,0 +1,128 @@
+/*
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include "screencastsource.h"
+#include "utils/damagejournal.h"
+
+#include <QImage>
+#include <QList>
+
+#include <memory>
+
+namespace KWin
+{
+
+class SharedScreenCastSource;
+
+/**
+ * The ScreenCastCapture class lets several screencast streams of the same output or window
+ * share one source. The source is rendered at most once per frame into an intermediate
+ * buffer, which is then copied into the buffers of every stream. With a single stream,
+ * the source renders straight into the buffers of that stream, like without sharing.
+ */
+class ScreenCastCapture : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ScreenCastCapture(std::unique_ptr<ScreenCastSource> &&source);
+    ~ScreenCastCapture() override;
+
+    ScreenCastSource *source() const;
+
+Q_SIGNALS:
+    void frame();
+    void closed();
+
+private:
+    struct FramebufferCache
+    {
+        std::unique_ptr<GLTexture> texture;
+        std::unique_ptr<GLFramebuffer> framebuffer;
+        DamageJournal journal;
+        quint64 renderCount = 0;
+        quint64 frameSerial = 0;
+        bool valid = false;
+    };
+
+    struct ImageCache
+    {
+        QImage image;
+        DamageJournal journal;
+        quint64 renderCount = 0;
+        quint64 frameSerial = 0;
+        bool valid = false;
+    };
+
+    void attach(SharedScreenCastSource *consumer);
+    void detach(SharedScreenCastSource *consumer);
+    void resume();
+    void pause();
+    void setRenderCursor(bool enable);
+    Region render(SharedScreenCastSource *consumer, GLFramebuffer *target, const Region &bufferRepair);
+    Region render(SharedScreenCastSource *consumer, QImage *target, const Region &bufferRepair);
+    bool updateFramebufferCache();
+    bool updateImageCache(const QImage &format);
+    void invalidate();
+
+    std::unique_ptr<ScreenCastSource> m_source;
+    QList<SharedScreenCastSource *> m_consumers;
+    FramebufferCache m_framebufferCache;
+    ImageCache m_imageCache;
+    quint64 m_frameSerial = 1;
+    int m_activeCount = 0;
+    bool m_renderCursor = false;
+
+    friend class SharedScreenCastSource;
+};
+
+/**
+ * The SharedScreenCastSource class is the source of one stream that is recorded from a
+ * ScreenCastCapture shared with other streams.
+ */
+class SharedScreenCastSource : public ScreenCastSource
+{
+    Q_OBJECT
+
+public:
+    explicit SharedScreenCastSource(const std::shared_ptr<ScreenCastCapture> &capture);
+    ~SharedScreenCastSource() override;
+
+    uint refreshRate() const override;
+    quint32 drmFormat() const override;
+    QSize textureSize() const override;
+    qreal devicePixelRatio() const override;
+    bool supportsDownscaling() const override;
+
+    void setRenderCursor(bool enable) override;
+    Region render(GLFramebuffer *target, const Region &bufferRepair) override;
+    Region render(QImage *target, const Region &bufferRepair) override;
+    std::chrono::nanoseconds clock() const override;
+
+    void resume() override;
+    void pause() override;
+
+    bool includesCursor(Cursor *cursor) const override;
+
+    QPointF mapFromGlobal(const QPointF &point) const override;
+    RectF mapFromGlobal(const RectF &rect) const override;
+
+private:
+    std::shared_ptr<ScreenCastCapture> m_capture;
+    /**
+     * The render counts of the capture's caches at the time they were last copied into
+     * one of the buffers of this stream, or 0 if they haven't been copied yet.
+     */
+    quint64 m_framebufferRenderCount = 0;
+    quint64 m_imageRenderCount = 0;
+    bool m_active = false;
+
+    friend class ScreenCastCapture;
+};
+
+} // namespace KWin
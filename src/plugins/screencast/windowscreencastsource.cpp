@@ -15,20 +15,34 @@
 #include "core/renderviewport.h"
 #include "effect/effect.h"
 #include "input.h"
+#include "opengl/eglbackend.h"
+#include "opengl/eglnativefence.h"
 #include "opengl/glframebuffer.h"
+#include "opengl/glshader.h"
+#include "opengl/glshadermanager.h"
 #include "opengl/gltexture.h"
 #include "scene/itemrenderer.h"
+#include "scene/opengl/texture.h"
+#include "scene/surfaceitem.h"
+#include "scene/texturememorybudget.h"
 #include "scene/windowitem.h"
 #include "scene/workspacescene.h"
 #include "workspace.h"
 
 #include <drm_fourcc.h>
 
+#include <array>
+#include <bit>
+
 namespace KWin
 {
 
 WindowScreenCastSource::WindowScreenCastSource(Window *window)
     : ScreenCastSource()
+    , m_memory(kwinApp()->scene()->textureMemoryBudget()->track(QStringLiteral("WindowScreenCast"), [this]() {
+        m_downscaleFramebuffer.reset();
+        m_downscaleTexture.reset();
+    }))
 {
     add(window);
 
@@ -101,6 +115,11 @@ qreal WindowScreenCastSource::devicePixelRatio() const
     return m_windows[0]->targetScale();
 }
 
+bool WindowScreenCastSource::supportsDownscaling() const
+{
+    return true;
+}
+
 void WindowScreenCastSource::setRenderCursor(bool enable)
 {
     m_renderCursor = enable;
@@ -120,10 +139,156 @@ Region WindowScreenCastSource::render(QImage *target, const Region &bufferDamage
     return Rect(QPoint(), target->size());
 }
 
+SurfaceItem *WindowScreenCastSource::directCopyCandidate(const QSize &targetSize) const
+{
+    if (m_windows.size() != 1 || m_renderCursor) {
+        return nullptr;
+    }
+    WindowItem *windowItem = m_windows[0]->windowItem();
+    SurfaceItem *surfaceItem = windowItem->surfaceItem();
+    if (!surfaceItem || windowItem->decorationItem() || windowItem->shadowItem()) {
+        return nullptr;
+    }
+    // Anything that the item renderer would do besides copying the pixels rules out a copy
+    const std::array<const Item *, 3> items{windowItem, surfaceItem->parentItem(), surfaceItem};
+    for (const Item *item : items) {
+        if (item->opacity() != 1.0 || !item->transform().isIdentity() || !item->borderRadius().isNull()) {
+            return nullptr;
+        }
+    }
+    if (!surfaceItem->childItems().isEmpty()) {
+        return nullptr;
+    }
+    if (surfaceItem->bufferTransform() != OutputTransform::Normal
+        || surfaceItem->bufferSize() != targetSize
+        || surfaceItem->bufferSourceBox() != RectF(QPointF(0, 0), targetSize)
+        || surfaceItem->mapToScene(surfaceItem->rect()) != boundingRect()) {
+        return nullptr;
+    }
+    if (surfaceItem->colorDescription() != ColorDescription::sRGB) {
+        return nullptr;
+    }
+    return surfaceItem;
+}
+
+bool WindowScreenCastSource::copyDirectly(GLFramebuffer *target)
+{
+    if (!EglContext::currentContext()->supportsBlits()) {
+        return false;
+    }
+    SurfaceItem *surfaceItem = directCopyCandidate(target->size());
+    if (!surfaceItem) {
+        return false;
+    }
+
+    surfaceItem->preprocess();
+    auto texture = static_cast<TextureOpenGL *>(surfaceItem->texture());
+    if (!texture || texture->isFloatingPoint() || texture->planes().size() != 1) {
+        return false;
+    }
+    GLTexture *plane = texture->planes().constFirst();
+    if (plane->target() != GL_TEXTURE_2D || plane->size() != target->size()) {
+        return false;
+    }
+
+    GLFramebuffer source(plane);
+    if (!source.valid()) {
+        return false;
+    }
+
+    // Both the client buffer and the screencast buffer store the top row first, so a plain
+    // copy without flipping produces the same image as rendering the window
+    GLFramebuffer::pushFramebuffer(&source);
+    target->blitFromFramebuffer(Rect(QPoint(), plane->size()), Rect(QPoint(), target->size()), GL_NEAREST);
+    GLFramebuffer::popFramebuffer();
+
+    if (const auto releasePoint = texture->releasePoint()) {
+        EglBackend *backend = qobject_cast<EglBackend *>(Compositor::self()->backend());
+        EGLNativeFence fence(backend->eglDisplayObject());
+        if (fence.isValid()) {
+            releasePoint->addReleaseFence(fence.fileDescriptor());
+        }
+    }
+    return true;
+}
+
+void WindowScreenCastSource::releaseDownscaleTexture()
+{
+    m_downscaleFramebuffer.reset();
+    m_downscaleTexture.reset();
+    m_memory->setSize(0);
+}
+
+void WindowScreenCastSource::renderDownscaled(GLFramebuffer *target)
+{
+    const QSize fullSize = textureSize();
+    const qreal scale = std::min(target->size().width() / qreal(fullSize.width()), target->size().height() / qreal(fullSize.height()));
+
+    // Rendering the windows straight into a buffer that is less than half their size skips
+    // texels and makes text and edges shimmer, so render them at full size first and let the
+    // GPU sample the mipmaps of that. GLES2 only supports mipmaps for power of two sizes
+    if (scale >= 0.5 || !EglContext::currentContext()->hasVersion(Version(3, 0))) {
+        releaseDownscaleTexture();
+        renderWindows(target, devicePixelRatio() * scale);
+        return;
+    }
+
+    if (!m_downscaleTexture || m_downscaleTexture->size() != fullSize) {
+        m_downscaleFramebuffer.reset();
+        const int levels = std::bit_width(uint(std::max(fullSize.width(), fullSize.height())));
+        m_downscaleTexture = GLTexture::allocate(GL_RGBA8, fullSize, levels);
+        if (!m_downscaleTexture) {
+            m_memory->setSize(0);
+            renderWindows(target, devicePixelRatio() * scale);
+            return;
+        }
+        m_downscaleTexture->setContentTransform(OutputTransform::FlipY);
+        m_downscaleTexture->setFilter(GL_LINEAR_MIPMAP_LINEAR);
+        m_downscaleTexture->setWrapMode(GL_CLAMP_TO_EDGE);
+        m_downscaleFramebuffer = std::make_unique<GLFramebuffer>(m_downscaleTexture.get());
+        m_memory->setSize(m_downscaleTexture->memoryUsage());
+    }
+    m_memory->markUsed();
+
+    renderWindows(m_downscaleFramebuffer.get(), devicePixelRatio());
+    m_downscaleTexture->bind();
+    m_downscaleTexture->generateMipmaps();
+    m_downscaleTexture->unbind();
+
+    ShaderBinder shaderBinder(ShaderTrait::MapTexture);
+    QMatrix4x4 projectionMatrix;
+    projectionMatrix.scale(1, -1);
+    projectionMatrix.ortho(QRect(QPoint(), target->size()));
+    shaderBinder.shader()->setUniform(GLShader::Mat4Uniform::ModelViewProjectionMatrix, projectionMatrix);
+
+    GLFramebuffer::pushFramebuffer(target);
+    glClearColor(0.0, 0.0, 0.0, 0.0);
+    glClear(GL_COLOR_BUFFER_BIT);
+    m_downscaleTexture->render(QSizeF(fullSize) * scale);
+    GLFramebuffer::popFramebuffer();
+}
+
 Region WindowScreenCastSource::render(GLFramebuffer *target, const Region &bufferDamage)
+{
+    if (m_directCopy && copyDirectly(target)) {
+        releaseDownscaleTexture();
+        return Rect(QPoint(), target->size());
+    }
+
+    const QSize fullSize = textureSize();
+    if (target->size().width() < fullSize.width() || target->size().height() < fullSize.height()) {
+        renderDownscaled(target);
+    } else {
+        releaseDownscaleTexture();
+        renderWindows(target, devicePixelRatio());
+    }
+    return Rect(QPoint(), target->size());
+}
+
+void WindowScreenCastSource::renderWindows(GLFramebuffer *target, qreal scale)
 {
     RenderTarget renderTarget(target);
-    RenderViewport viewport(boundingRect(), devicePixelRatio(), renderTarget, QPoint());
+    RenderViewport viewport(boundingRect(), scale, renderTarget, QPoint());
 
     WorkspaceScene *scene = kwinApp()->scene();
 
@@ -137,7 +302,6 @@ Region WindowScreenCastSource::render(GLFramebuffer *target, const Region &buffe
         scene->renderer()->renderItem(renderTarget, viewport, scene->cursorItem(), 0, Region::infinite(), WindowPaintData{}, {}, {});
     }
     scene->renderer()->endFrame();
-    return Rect(QPoint(), target->size());
 }
 
 std::chrono::nanoseconds WindowScreenCastSource::clock() const
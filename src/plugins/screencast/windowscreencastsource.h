@@ -15,6 +15,11 @@
 namespace KWin
 {
 
+class GLFramebuffer;
+class GLTexture;
+class SurfaceItem;
+class TextureMemoryAllocation;
+
 class WindowScreenCastSource : public ScreenCastSource
 {
     Q_OBJECT
@@ -26,6 +31,7 @@ public:
     quint32 drmFormat() const override;
     QSize textureSize() const override;
     qreal devicePixelRatio() const override;
+    bool supportsDownscaling() const override;
     uint refreshRate() const override;
 
     void setRenderCursor(bool enable) override;
@@ -47,9 +53,23 @@ private:
     void unwatch(Window *window);
     RectF boundingRect() const;
 
+    /**
+     * Returns the surface item of the window if the window consists of nothing but a
+     * single buffer that covers the screencast buffer pixel for pixel, otherwise @c null.
+     */
+    SurfaceItem *directCopyCandidate(const QSize &targetSize) const;
+    bool copyDirectly(GLFramebuffer *target);
+    void renderWindows(GLFramebuffer *target, qreal scale);
+    void renderDownscaled(GLFramebuffer *target);
+    void releaseDownscaleTexture();
+
     QList<Window *> m_windows;
     bool m_active = false;
     bool m_renderCursor = false;
+    std::unique_ptr<GLTexture> m_downscaleTexture;
+    std::unique_ptr<GLFramebuffer> m_downscaleFramebuffer;
+    std::unique_ptr<TextureMemoryAllocation> m_memory;
+    const bool m_directCopy = qgetenv("KWIN_SCREENCAST_DIRECT_COPY") != QByteArrayLiteral("0");
 };
 
 } // namespace KWin
@@ -3,7 +3,6 @@
     This file is part of the KDE project.
 
     SPDX-FileCopyrightText: 2010 Martin Gräßlin <mgraesslin@kde.org>
-    SPDX-FileCopyrightText: 2010 Nokia Corporation and /or its subsidiary(-ies)
     SPDX-FileCopyrightText: 2021 Vlad Zahorodnii <vlad.zahorodnii@kde.org>
 
     SPDX-License-Identifier: GPL-2.0-or-later
@@ -18,6 +17,7 @@
 #include "core/renderviewport.h"
 #include "effect/effect.h"
 #include "opengl/eglbackend.h"
+#include "opengl/glpixelpackbuffer.h"
 #include "opengl/glplatform.h"
 #include "opengl/glutils.h"
 #include "scene/decorationitem.h"
@@ -31,7 +31,11 @@
 #include "window.h"
 #include "workspace.h"
 
-#include <QPainter>
+#include <QSocketNotifier>
+#include <QtEndian>
+
+#include <algorithm>
+#include <cstring>
 
 namespace KWin
 {
@@ -41,41 +45,28 @@ static bool shouldFilterWindowFromCapture(Window *window, std::optional<pid_t> p
     return window->excludeFromCapture() || (pidToHide.has_value() && window->pid() == *pidToHide);
 }
 
-static void convertFromGLImage(QImage &img, int w, int h, const OutputTransform &renderTargetTransformation)
+class ScreenShotReadback
 {
-    // from QtOpenGL/qgl.cpp
-    // SPDX-FileCopyrightText: 2010 Nokia Corporation and /or its subsidiary(-ies)
-    // see https://github.com/qt/qtbase/blob/dev/src/opengl/qgl.cpp
-    if (QSysInfo::ByteOrder == QSysInfo::BigEndian) {
-        // OpenGL gives RGBA; Qt wants ARGB
-        uint *p = reinterpret_cast<uint *>(img.bits());
-        uint *end = p + w * h;
-        while (p < end) {
-            uint a = *p << 24;
-            *p = (*p >> 8) | a;
-            p++;
-        }
-    } else {
-        // OpenGL gives ABGR (i.e. RGBA backwards); Qt wants ARGB
-        for (int y = 0; y < h; y++) {
-            uint *q = reinterpret_cast<uint *>(img.scanLine(y));
-            for (int x = 0; x < w; ++x) {
-                const uint pixel = *q;
-                *q = ((pixel << 16) & 0xff0000) | ((pixel >> 16) & 0xff)
-                    | (pixel & 0xff00ff00);
-
-                q++;
-            }
+public:
+    ScreenShotReadback(std::unique_ptr<GLPixelPackBuffer> &&buffer, qreal scale, const ScreenShotCallback &callback)
+        : buffer(std::move(buffer))
+        , scale(scale)
+        , callback(callback)
+    {
+    }
+
+    ~ScreenShotReadback()
+    {
+        if (callback) {
+            callback(std::nullopt);
         }
     }
 
-    QMatrix4x4 matrix;
-    // apply render target transformation
-    matrix *= renderTargetTransformation.inverted().toMatrix();
-    // OpenGL textures are flipped vs QImage
-    matrix.scale(1, -1);
-    img = img.transformed(matrix.toTransform());
-}
+    std::unique_ptr<GLPixelPackBuffer> buffer;
+    std::unique_ptr<QSocketNotifier> notifier;
+    const qreal scale;
+    ScreenShotCallback callback;
+};
 
 ScreenShotManager::ScreenShotManager()
     : m_dbusInterface2(new ScreenShotDBusInterface2(this))
@@ -84,19 +75,90 @@ ScreenShotManager::ScreenShotManager()
 
 ScreenShotManager::~ScreenShotManager()
 {
+    if (!m_readbacks.empty()) {
+        if (const auto eglBackend = Compositor::self() ? dynamic_cast<EglBackend *>(Compositor::self()->backend()) : nullptr) {
+            eglBackend->openglContext()->makeCurrent();
+        }
+        m_readbacks.clear();
+    }
+}
+
+void ScreenShotManager::readBack(EglContext *context, GLFramebuffer *framebuffer, qreal scale, const ScreenShotCallback &callback)
+{
+    // GL_BGRA matches QImage::Format_ARGB32_Premultiplied on little endian machines
+    GLFramebuffer::pushFramebuffer(framebuffer);
+    auto buffer = GLPixelPackBuffer::readPixels(context, Rect(QPoint(), framebuffer->size()), GL_BGRA);
+    GLFramebuffer::popFramebuffer();
+    if (!buffer) {
+        callback(std::nullopt);
+        return;
+    }
+
+    ScreenShotReadback *readback = m_readbacks.emplace_back(std::make_unique<ScreenShotReadback>(std::move(buffer), scale, callback)).get();
+    if (readback->buffer->fence().isValid()) {
+        readback->notifier = std::make_unique<QSocketNotifier>(readback->buffer->fence().get(), QSocketNotifier::Read);
+        connect(readback->notifier.get(), &QSocketNotifier::activated, this, [this, readback]() {
+            finishReadBack(readback);
+        });
+    } else {
+        finishReadBack(readback);
+    }
+}
+
+void ScreenShotManager::finishReadBack(ScreenShotReadback *readback)
+{
+    const auto it = std::ranges::find(m_readbacks, readback, &std::unique_ptr<ScreenShotReadback>::get);
+    Q_ASSERT(it != m_readbacks.end());
+    std::unique_ptr<ScreenShotReadback> finished = std::move(*it);
+    m_readbacks.erase(it);
+    if (finished->notifier) {
+        finished->notifier.release()->deleteLater();
+    }
+    const ScreenShotCallback callback = std::exchange(finished->callback, nullptr);
+
+    const auto eglBackend = dynamic_cast<EglBackend *>(Compositor::self()->backend());
+    if (!eglBackend || !eglBackend->openglContext()->makeCurrent()) {
+        callback(std::nullopt);
+        return;
+    }
+    const uchar *pixels = finished->buffer->map();
+    if (!pixels) {
+        callback(std::nullopt);
+        return;
+    }
+
+    // OpenGL rows go from the bottom to the top, so flip them while copying
+    const QSize size = finished->buffer->size();
+    const qsizetype stride = size.width() * 4;
+    QImage snapshot(size, QImage::Format_ARGB32_Premultiplied);
+    for (int y = 0; y < size.height(); y++) {
+        const uchar *source = pixels + (size.height() - y - 1) * stride;
+        if constexpr (QSysInfo::ByteOrder == QSysInfo::BigEndian) {
+            qFromLittleEndian<quint32>(source, size.width(), snapshot.scanLine(y));
+        } else {
+            std::memcpy(snapshot.scanLine(y), source, stride);
+        }
+    }
+    finished->buffer->unmap();
+    snapshot.setDevicePixelRatio(finished->scale);
+    finished.reset();
+
+    callback(snapshot);
 }
 
 // TODO share code with the screencast plugin?
 
-std::optional<QImage> ScreenShotManager::takeScreenShot(LogicalOutput *screen, ScreenShotFlags flags, std::optional<pid_t> pidToHide)
+void ScreenShotManager::takeScreenShot(LogicalOutput *screen, ScreenShotFlags flags, std::optional<pid_t> pidToHide, const ScreenShotCallback &callback)
 {
     const auto eglBackend = dynamic_cast<EglBackend *>(Compositor::self()->backend());
     if (!eglBackend) {
-        return std::nullopt;
+        callback(std::nullopt);
+        return;
     }
     const auto context = eglBackend->openglContext();
     if (!context || !context->makeCurrent()) {
-        return std::nullopt;
+        callback(std::nullopt);
+        return;
     }
 
     qreal scale = 1.0;
@@ -107,22 +169,26 @@ std::optional<QImage> ScreenShotManager::takeScreenShot(LogicalOutput *screen, S
 
     const auto offscreenTexture = GLTexture::allocate(GL_RGBA8, nativeSize);
     if (!offscreenTexture) {
-        return std::nullopt;
+        callback(std::nullopt);
+        return;
     }
     offscreenTexture->setFilter(GL_LINEAR);
     offscreenTexture->setWrapMode(GL_CLAMP_TO_EDGE);
     const auto target = std::make_unique<GLFramebuffer>(offscreenTexture.get());
     if (!target->valid()) {
-        return std::nullopt;
+        callback(std::nullopt);
+        return;
     }
 
     ScreenshotLayer layer(screen, target.get());
     if (!layer.preparePresentationTest()) {
-        return std::nullopt;
+        callback(std::nullopt);
+        return;
     }
     const auto beginInfo = layer.beginFrame();
     if (!beginInfo) {
-        return std::nullopt;
+        callback(std::nullopt);
+        return;
     }
     SceneView sceneView(kwinApp()->scene(), screen, nullptr, &layer);
     std::unique_ptr<ItemTreeView> cursorView;
@@ -140,28 +206,24 @@ std::optional<QImage> ScreenShotManager::takeScreenShot(LogicalOutput *screen, S
     sceneView.paint(beginInfo->renderTarget, QPoint(), fullDamage);
     sceneView.postPaint();
     if (!layer.endFrame(fullDamage, fullDamage, nullptr)) {
-        return std::nullopt;
+        callback(std::nullopt);
+        return;
     }
 
-    GLFramebuffer::pushFramebuffer(target.get());
-    QImage snapshot = QImage(offscreenTexture->size(), QImage::Format_ARGB32_Premultiplied);
-    context->glReadnPixels(0, 0, snapshot.width(), snapshot.height(), GL_RGBA, GL_UNSIGNED_BYTE, snapshot.sizeInBytes(), static_cast<GLvoid *>(snapshot.bits()));
-    convertFromGLImage(snapshot, snapshot.width(), snapshot.height(), OutputTransform::Normal);
-    GLFramebuffer::popFramebuffer();
-
-    snapshot.setDevicePixelRatio(scale);
-    return snapshot;
+    readBack(context, target.get(), scale, callback);
 }
 
-std::optional<QImage> ScreenShotManager::takeScreenShot(const Rect &area, ScreenShotFlags flags, std::optional<pid_t> pidToHide)
+void ScreenShotManager::takeScreenShot(const Rect &area, ScreenShotFlags flags, std::optional<pid_t> pidToHide, const ScreenShotCallback &callback)
 {
     const auto eglBackend = dynamic_cast<EglBackend *>(Compositor::self()->backend());
     if (!eglBackend) {
-        return std::nullopt;
+        callback(std::nullopt);
+        return;
     }
     const auto context = eglBackend->openglContext();
     if (!context || !context->makeCurrent()) {
-        return std::nullopt;
+        callback(std::nullopt);
+        return;
     }
 
     qreal scale = 1.0;
@@ -175,22 +237,26 @@ std::optional<QImage> ScreenShotManager::takeScreenShot(const Rect &area, Screen
 
     const auto offscreenTexture = GLTexture::allocate(GL_RGBA8, nativeSize);
     if (!offscreenTexture) {
-        return std::nullopt;
+        callback(std::nullopt);
+        return;
     }
     offscreenTexture->setFilter(GL_LINEAR);
     offscreenTexture->setWrapMode(GL_CLAMP_TO_EDGE);
     const auto target = std::make_unique<GLFramebuffer>(offscreenTexture.get());
     if (!target->valid()) {
-        return std::nullopt;
+        callback(std::nullopt);
+        return;
     }
 
     ScreenshotLayer layer(workspace()->outputs().front(), target.get());
     if (!layer.preparePresentationTest()) {
-        return std::nullopt;
+        callback(std::nullopt);
+        return;
     }
     const auto beginInfo = layer.beginFrame();
     if (!beginInfo) {
-        return std::nullopt;
+        callback(std::nullopt);
+        return;
     }
     SceneView sceneView(kwinApp()->scene(), workspace()->outputs().front(), nullptr, &layer);
     std::unique_ptr<ItemTreeView> cursorView;
@@ -208,32 +274,29 @@ std::optional<QImage> ScreenShotManager::takeScreenShot(const Rect &area, Screen
     sceneView.paint(beginInfo->renderTarget, QPoint(), fullDamage);
     sceneView.postPaint();
     if (!layer.endFrame(fullDamage, fullDamage, nullptr)) {
-        return std::nullopt;
+        callback(std::nullopt);
+        return;
     }
 
-    GLFramebuffer::pushFramebuffer(target.get());
-    QImage snapshot = QImage(offscreenTexture->size(), QImage::Format_ARGB32_Premultiplied);
-    context->glReadnPixels(0, 0, snapshot.width(), snapshot.height(), GL_RGBA, GL_UNSIGNED_BYTE, snapshot.sizeInBytes(), static_cast<GLvoid *>(snapshot.bits()));
-    convertFromGLImage(snapshot, snapshot.width(), snapshot.height(), OutputTransform::Normal);
-    GLFramebuffer::popFramebuffer();
-
-    snapshot.setDevicePixelRatio(scale);
-    return snapshot;
+    readBack(context, target.get(), scale, callback);
 }
 
-std::optional<QImage> ScreenShotManager::takeScreenShot(Window *window, ScreenShotFlags flags)
+void ScreenShotManager::takeScreenShot(Window *window, ScreenShotFlags flags, const ScreenShotCallback &callback)
 {
     if (window->excludeFromCapture()) {
-        return std::nullopt;
+        callback(std::nullopt);
+        return;
     }
 
     const auto eglBackend = dynamic_cast<EglBackend *>(Compositor::self()->backend());
     if (!eglBackend) {
-        return std::nullopt;
+        callback(std::nullopt);
+        return;
     }
     const auto context = eglBackend->openglContext();
     if (!context || !context->makeCurrent()) {
-        return std::nullopt;
+        callback(std::nullopt);
+        return;
     }
 
     const qreal scale = window->targetScale();
@@ -246,7 +309,8 @@ std::optional<QImage> ScreenShotManager::takeScreenShot(Window *window, ScreenSh
     const QSize nativeSize = (geometry.size() * scale).toSize();
     const auto offscreenTexture = GLTexture::allocate(GL_RGBA8, nativeSize);
     if (!offscreenTexture) {
-        return std::nullopt;
+        callback(std::nullopt);
+        return;
     }
 
     GLFramebuffer offscreenTarget(offscreenTexture.get());
@@ -270,14 +334,7 @@ std::optional<QImage> ScreenShotManager::takeScreenShot(Window *window, ScreenSh
     }
     scene->renderer()->endFrame();
 
-    GLFramebuffer::pushFramebuffer(&offscreenTarget);
-    QImage snapshot = QImage(offscreenTexture->size(), QImage::Format_ARGB32_Premultiplied);
-    context->glReadnPixels(0, 0, snapshot.width(), snapshot.height(), GL_RGBA, GL_UNSIGNED_BYTE, snapshot.sizeInBytes(), static_cast<GLvoid *>(snapshot.bits()));
-    convertFromGLImage(snapshot, snapshot.width(), snapshot.height(), OutputTransform::Normal);
-    GLFramebuffer::popFramebuffer();
-
-    snapshot.setDevicePixelRatio(scale);
-    return snapshot;
+    readBack(context, &offscreenTarget, scale, callback);
 }
 
 } // namespace KWin
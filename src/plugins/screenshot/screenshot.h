@@ -12,6 +12,9 @@
 
 #include "plugin.h"
 
+#include <functional>
+#include <vector>
+
 namespace KWin
 {
 
@@ -26,11 +29,20 @@ enum ScreenShotFlag {
 };
 Q_DECLARE_FLAGS(ScreenShotFlags, ScreenShotFlag)
 
+class EglContext;
+class GLFramebuffer;
 class LogicalOutput;
 class Rect;
 class ScreenShotDBusInterface2;
+class ScreenShotReadback;
 class Window;
 
+/**
+ * Gets called with the screenshot once it has been read back from the GPU, or std::nullopt
+ * if taking the screenshot failed.
+ */
+using ScreenShotCallback = std::function<void(const std::optional<QImage> &image)>;
+
 /**
  * The ScreenShotManager provides a convenient way to capture the contents of a given window,
  * screen or an area in the global coordinates.
@@ -43,12 +55,20 @@ public:
     ScreenShotManager();
     ~ScreenShotManager() override;
 
-    std::optional<QImage> takeScreenShot(LogicalOutput *screen, ScreenShotFlags flags, std::optional<pid_t> pidToHide);
-    std::optional<QImage> takeScreenShot(const Rect &area, ScreenShotFlags flags, std::optional<pid_t> pidToHide);
-    std::optional<QImage> takeScreenShot(Window *window, ScreenShotFlags flags = {});
+    /**
+     * The screenshots are rendered right away, but read back asynchronously, the @a callback
+     * can be called after these functions have returned.
+     */
+    void takeScreenShot(LogicalOutput *screen, ScreenShotFlags flags, std::optional<pid_t> pidToHide, const ScreenShotCallback &callback);
+    void takeScreenShot(const Rect &area, ScreenShotFlags flags, std::optional<pid_t> pidToHide, const ScreenShotCallback &callback);
+    void takeScreenShot(Window *window, ScreenShotFlags flags, const ScreenShotCallback &callback);
 
 private:
+    void readBack(EglContext *context, GLFramebuffer *framebuffer, qreal scale, const ScreenShotCallback &callback);
+    void finishReadBack(ScreenShotReadback *readback);
+
     std::unique_ptr<ScreenShotDBusInterface2> m_dbusInterface2;
+    std::vector<std::unique_ptr<ScreenShotReadback>> m_readbacks;
 };
 
 } // namespace KWin
@@ -432,38 +432,44 @@ QVariantMap ScreenShotDBusInterface2::CaptureWorkspace(const QVariantMap &option
 void ScreenShotDBusInterface2::takeScreenShot(LogicalOutput *screen, ScreenShotFlags flags,
                                               ScreenShotSinkPipe2 *sink, std::optional<pid_t> pid)
 {
-    if (const auto result = m_effect->takeScreenShot(screen, flags, pid)) {
-        sink->flush(*result, QVariantMap{
-                                 {QStringLiteral("screen"), screen->name()},
-                             });
-    } else {
-        sink->cancel();
-    }
-    sink->deleteLater();
+    m_effect->takeScreenShot(screen, flags, pid, [sink, name = screen->name()](const std::optional<QImage> &result) {
+        if (result) {
+            sink->flush(*result, QVariantMap{
+                                     {QStringLiteral("screen"), name},
+                                 });
+        } else {
+            sink->cancel();
+        }
+        sink->deleteLater();
+    });
 }
 
 void ScreenShotDBusInterface2::takeScreenShot(const Rect &area, ScreenShotFlags flags,
                                               ScreenShotSinkPipe2 *sink, std::optional<pid_t> pid)
 {
-    if (const auto result = m_effect->takeScreenShot(area, flags, pid)) {
-        sink->flush(*result, {});
-    } else {
-        sink->cancel();
-    }
-    sink->deleteLater();
+    m_effect->takeScreenShot(area, flags, pid, [sink](const std::optional<QImage> &result) {
+        if (result) {
+            sink->flush(*result, {});
+        } else {
+            sink->cancel();
+        }
+        sink->deleteLater();
+    });
 }
 
 void ScreenShotDBusInterface2::takeScreenShot(Window *window, ScreenShotFlags flags,
                                               ScreenShotSinkPipe2 *sink)
 {
-    if (const auto result = m_effect->takeScreenShot(window, flags)) {
-        sink->flush(*result, QVariantMap{
-                                 {QStringLiteral("windowId"), window->internalId().toString()},
-                             });
-    } else {
-        sink->cancel();
-    }
-    sink->deleteLater();
+    m_effect->takeScreenShot(window, flags, [sink, windowId = window->internalId().toString()](const std::optional<QImage> &result) {
+        if (result) {
+            sink->flush(*result, QVariantMap{
+                                     {QStringLiteral("windowId"), windowId},
+                                 });
+        } else {
+            sink->cancel();
+        }
+        sink->deleteLater();
+    });
 }
 
 } // namespace KWin
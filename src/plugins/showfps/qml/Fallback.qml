@@ -21,6 +21,13 @@ Rectangle {
             text: root.effect.fps + "/" + root.effect.maximumFps
         }
 
+        Text {
+            Layout.fillWidth: true
+            visible: root.effect.gpuTimes.length > 0
+            text: root.effect.gpuTimes
+            elide: Text.ElideRight
+        }
+
         Text {
             Layout.fillWidth: true
             text: i18nc("@label", "This effect is not a benchmark")
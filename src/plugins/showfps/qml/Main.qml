@@ -187,6 +187,14 @@ Rectangle {
             }
         }
 
+        Label {
+            Layout.fillWidth: true
+            visible: root.effect.gpuTimes.length > 0
+            text: root.effect.gpuTimes
+            font: Kirigami.Theme.smallFont
+            elide: Text.ElideRight
+        }
+
         Label {
             Layout.fillWidth: true
             text: i18nc("@label", "This effect is not a benchmark")
@@ -10,20 +10,25 @@
 #include "core/output.h"
 #include "core/renderviewport.h"
 #include "effect/effecthandler.h"
+#include "opengl/glgpuprofiler.h"
 #include "scene/workspacescene.h"
 
 #include <QQmlContext>
 
+#include <algorithm>
+
 namespace KWin
 {
 
 ShowFpsEffect::ShowFpsEffect()
 {
     connect(effects->scene(), &WorkspaceScene::viewRemoved, this, &ShowFpsEffect::removeView);
+    GLGpuProfiler::addUser();
 }
 
 ShowFpsEffect::~ShowFpsEffect()
 {
+    GLGpuProfiler::removeUser();
 }
 
 void ShowFpsEffect::removeView(RenderView *view)
@@ -57,6 +62,54 @@ QColor ShowFpsScreen::paintColor() const
     return QColor::fromHsvF(0.3 - (0.3 * normalizedDuration), 1.0, 1.0);
 }
 
+QString ShowFpsScreen::gpuTimes() const
+{
+    return m_gpuTimes;
+}
+
+static QString formatGpuTime(const QString &name, std::chrono::nanoseconds duration)
+{
+    return QStringLiteral("%1: %2 ms").arg(name).arg(duration.count() / 1'000'000.0, 0, 'f', 2);
+}
+
+static QString gpuTimesString(const QList<GLGpuProfiler::Section> &sections)
+{
+    // the sections are named after where they're nested in, e.g. "Konsole / Blur / Upsample"
+    struct Entry
+    {
+        QString name;
+        std::chrono::nanoseconds duration;
+    };
+    std::vector<Entry> entries;
+    QStringList lines;
+    QStringList path;
+    for (const GLGpuProfiler::Section &section : sections) {
+        path.resize(section.depth);
+        path.append(section.name);
+        if (section.depth == 0) {
+            lines.append(formatGpuTime(section.name, section.duration));
+        } else {
+            entries.push_back(Entry{
+                .name = path.mid(1).join(QLatin1String(" / ")),
+                .duration = section.duration,
+            });
+        }
+    }
+    if (lines.isEmpty()) {
+        return QString();
+    }
+
+    constexpr size_t maxEntries = 5;
+    const size_t count = std::min(maxEntries, entries.size());
+    std::partial_sort(entries.begin(), entries.begin() + count, entries.end(), [](const Entry &left, const Entry &right) {
+        return left.duration > right.duration;
+    });
+    for (size_t i = 0; i < count; i++) {
+        lines.append(formatGpuTime(entries[i].name, entries[i].duration));
+    }
+    return lines.join(QLatin1Char('\n'));
+}
+
 void ShowFpsEffect::prePaintScreen(ScreenPrePaintData &data)
 {
     effects->prePaintScreen(data);
@@ -94,10 +147,17 @@ void ShowFpsEffect::prePaintScreen(ScreenPrePaintData &data)
         screenData->m_newFps = 0;
         screenData->m_lastFpsTime = now;
         Q_EMIT screenData->fpsChanged();
+
+        const QString gpuTimes = gpuTimesString(GLGpuProfiler::lastFrame(screenData->m_outputName));
+        if (gpuTimes != screenData->m_gpuTimes) {
+            screenData->m_gpuTimes = gpuTimes;
+            Q_EMIT screenData->gpuTimesChanged();
+        }
     }
 
     const auto rect = data.view->viewport();
-    screenData->m_scene->setGeometry(QRect(rect.x() + rect.width() - 300, rect.y(), 300, 150));
+    const int height = screenData->m_gpuTimes.isEmpty() ? 150 : 250;
+    screenData->m_scene->setGeometry(QRect(rect.x() + rect.width() - 300, rect.y(), 300, height));
 }
 
 bool ShowFpsEffect::paintScreen(const RenderTarget &renderTarget, const RenderViewport &viewport, int mask, const Region &deviceRegion, LogicalOutput *screen)
@@ -107,6 +167,9 @@ bool ShowFpsEffect::paintScreen(const RenderTarget &renderTarget, const RenderVi
     }
 
     auto &screenData = m_data[m_currentView];
+    if (screen) {
+        screenData->m_outputName = screen->name();
+    }
     Region repaintRegion = deviceRegion & viewport.deviceRect();
     // we keep repainting this area, so it shouldn't be counted
     repaintRegion -= viewport.mapToDeviceCoordinatesAligned(Rect(screenData->m_scene->geometry()));
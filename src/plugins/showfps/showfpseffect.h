@@ -26,6 +26,7 @@ class ShowFpsScreen : public QObject
     Q_PROPERTY(int paintDuration READ paintDuration NOTIFY paintChanged)
     Q_PROPERTY(int paintAmount READ paintAmount NOTIFY paintChanged)
     Q_PROPERTY(QColor paintColor READ paintColor NOTIFY paintChanged)
+    Q_PROPERTY(QString gpuTimes READ gpuTimes NOTIFY gpuTimesChanged)
 
 public:
     int fps() const;
@@ -33,11 +34,16 @@ public:
     int paintDuration() const;
     int paintAmount() const;
     QColor paintColor() const;
+    /**
+     * The GPU time of the last profiled frame and of its most expensive sections
+     */
+    QString gpuTimes() const;
 
 Q_SIGNALS:
     void fpsChanged();
     void maximumFpsChanged();
     void paintChanged();
+    void gpuTimesChanged();
 
 public:
     std::unique_ptr<OffscreenQuickScene> m_scene;
@@ -48,6 +54,8 @@ public:
     int m_paintDuration = 0;
     int m_paintAmount = 0;
     QElapsedTimer m_paintDurationTimer;
+    QString m_outputName;
+    QString m_gpuTimes;
 };
 
 class ShowFpsEffect : public Effect
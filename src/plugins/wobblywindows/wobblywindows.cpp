@@ -252,13 +252,81 @@ void WobblyWindowsEffect::prePaintWindow(RenderView *view, EffectWindow *w, Wind
     effects->prePaintWindow(view, w, data);
 }
 
+namespace
+{
+
+/**
+ * The bicubic Bézier patch spanned by the 4x4 control points, in the power basis, so that a
+ * point on it can be evaluated with a few multiply-adds instead of summing up all 16 weighted
+ * control points.
+ */
+struct BezierPatch
+{
+    // coefficients[a][b] is the coefficient of u^a * v^b
+    WobblyWindowsEffect::Pair coefficients[4][4];
+
+    WobblyWindowsEffect::Pair evaluate(qreal u, qreal v) const
+    {
+        WobblyWindowsEffect::Pair res = {0.0, 0.0};
+        for (int a = 3; a >= 0; --a) {
+            const WobblyWindowsEffect::Pair *row = coefficients[a];
+            const qreal x = ((row[3].x * v + row[2].x) * v + row[1].x) * v + row[0].x;
+            const qreal y = ((row[3].y * v + row[2].y) * v + row[1].y) * v + row[0].y;
+            res.x = res.x * u + x;
+            res.y = res.y * u + y;
+        }
+        return res;
+    }
+};
+
+// converts the cubic Bernstein polynomials to the power basis, bernstein[a][i] is
+// the coefficient of t^a in the polynomial for the control point i
+static constexpr qreal bernstein[4][4] = {
+    {1, 0, 0, 0},
+    {-3, 3, 0, 0},
+    {3, -6, 3, 0},
+    {-1, 3, -3, 1},
+};
+
+static BezierPatch computeBezierPatch(const QList<WobblyWindowsEffect::Pair> &position, unsigned int width)
+{
+    // this assume the grid is 4*4
+    WobblyWindowsEffect::Pair rows[4][4]; // rows[a][j] is the coefficient of u^a in the row j
+    for (int a = 0; a < 4; ++a) {
+        for (unsigned int j = 0; j < 4; ++j) {
+            WobblyWindowsEffect::Pair &row = rows[a][j];
+            row = {0.0, 0.0};
+            for (unsigned int i = 0; i < 4; ++i) {
+                row.x += bernstein[a][i] * position[i + j * width].x;
+                row.y += bernstein[a][i] * position[i + j * width].y;
+            }
+        }
+    }
+
+    BezierPatch patch;
+    for (int a = 0; a < 4; ++a) {
+        for (int b = 0; b < 4; ++b) {
+            WobblyWindowsEffect::Pair &coefficient = patch.coefficients[a][b];
+            coefficient = {0.0, 0.0};
+            for (unsigned int j = 0; j < 4; ++j) {
+                coefficient.x += bernstein[b][j] * rows[a][j].x;
+                coefficient.y += bernstein[b][j] * rows[a][j].y;
+            }
+        }
+    }
+    return patch;
+}
+
+} // namespace
+
 void WobblyWindowsEffect::apply(EffectWindow *w, int mask, WindowPaintData &data, WindowQuadList &quads)
 {
-    if (windows.contains(w)) {
-        WindowWobblyInfos &wwi = windows[w];
+    if (auto it = windows.find(w); it != windows.end()) {
+        const WindowWobblyInfos &wwi = *it;
         if (!wwi.wobblying) {
             return;
         }
+        const BezierPatch patch = computeBezierPatch(wwi.position, wwi.width);
 
         int tx = w->frameGeometry().x();
         int ty = w->frameGeometry().y();
@@ -273,8 +341,7 @@ void WobblyWindowsEffect::apply(EffectWindow *w, int mask, WindowPaintData &data
         for (int i = 0; i < quads.count(); ++i) {
             for (int j = 0; j < 4; ++j) {
                 WindowVertex &v = quads[i][j];
-                Pair uv = {v.x() / width, v.y() / height};
-                Pair newPos = computeBezierPoint(wwi, uv);
+                const Pair newPos = patch.evaluate(v.x() / width, v.y() / height);
                 v.move(newPos.x - tx, newPos.y - ty);
             }
             left = std::min(left, quads[i].left());
@@ -520,38 +587,6 @@ void WobblyWindowsEffect::initWobblyInfo(WindowWobblyInfos &wwi, RectF geometry)
     }
 }
 
-WobblyWindowsEffect::Pair WobblyWindowsEffect::computeBezierPoint(const WindowWobblyInfos &wwi, Pair point) const
-{
-    const qreal tx = point.x;
-    const qreal ty = point.y;
-
-    // compute polynomial coeff
-
-    qreal px[4];
-    px[0] = (1 - tx) * (1 - tx) * (1 - tx);
-    px[1] = 3 * (1 - tx) * (1 - tx) * tx;
-    px[2] = 3 * (1 - tx) * tx * tx;
-    px[3] = tx * tx * tx;
-
-    qreal py[4];
-    py[0] = (1 - ty) * (1 - ty) * (1 - ty);
-    py[1] = 3 * (1 - ty) * (1 - ty) * ty;
-    py[2] = 3 * (1 - ty) * ty * ty;
-    py[3] = ty * ty * ty;
-
-    Pair res = {0.0, 0.0};
-
-    for (unsigned int j = 0; j < 4; ++j) {
-        for (unsigned int i = 0; i < 4; ++i) {
-            // this assume the grid is 4*4
-            res.x += px[i] * py[j] * wwi.position[i + j * wwi.width].x;
-            res.y += px[i] * py[j] * wwi.position[i + j * wwi.width].y;
-        }
-    }
-
-    return res;
-}
-
 namespace
 {
 
@@ -161,8 +161,6 @@ private:
 
     void initWobblyInfo(WindowWobblyInfos &wwi, RectF geometry) const;
 
-    WobblyWindowsEffect::Pair computeBezierPoint(const WindowWobblyInfos &wwi, Pair point) const;
-
     static void heightRingLinearMean(QList<Pair> &data, WindowWobblyInfos &wwi);
 
     void setParameterSet(const ParameterSet &pset);
@@ -332,6 +332,20 @@ ZoomEffect::OffscreenData *ZoomEffect::ensureOffscreenData(const RenderTarget &r
     return &data;
 }
 
+/**
+ * Returns the part of the unzoomed scene that ends up on any of the screens.
+ */
+RectF ZoomEffect::visibleSourceRect() const
+{
+    const RectF screens = effects->virtualScreenGeometry();
+    // add a margin for the texels that linear filtering samples at the edges
+    return RectF((screens.x() - m_xTranslation) / m_zoom,
+                 (screens.y() - m_yTranslation) / m_zoom,
+                 screens.width() / m_zoom,
+                 screens.height() / m_zoom)
+        .adjusted(-1, -1, 1, 1);
+}
+
 GLShader *ZoomEffect::shaderForZoom(double zoom)
 {
     if (zoom >= m_pixelGridZoom) {
@@ -366,11 +380,15 @@ bool ZoomEffect::paintScreen(const RenderTarget &renderTarget, const RenderViewp
         return false;
     }
 
-    // Render the scene in an offscreen texture and then upscale it.
+    // Render the scene in an offscreen texture and then upscale it. Only the part of the
+    // scene that is visible after zooming has to be rendered, the rest of the texture
+    // isn't sampled. Panning repaints everything, so no stale content becomes visible
     RenderTarget offscreenRenderTarget(offscreenData->framebuffer.get(), renderTarget.colorDescription());
     RenderViewport offscreenViewport(viewport.renderRect(), viewport.scale(), offscreenRenderTarget, QPoint());
+    const RectF visibleSource = visibleSourceRect() & viewport.renderRect();
+    const Region offscreenRegion = deviceRegion & offscreenViewport.mapToDeviceCoordinatesAligned(visibleSource);
     GLFramebuffer::pushFramebuffer(offscreenData->framebuffer.get());
-    if (!effects->paintScreen(offscreenRenderTarget, offscreenViewport, mask, deviceRegion, screen)) {
+    if (!effects->paintScreen(offscreenRenderTarget, offscreenViewport, mask, offscreenRegion, screen)) {
         return false;
     }
     GLFramebuffer::popFramebuffer();
@@ -524,9 +542,10 @@ void ZoomEffect::slotWindowAdded(EffectWindow *w)
     connect(w, &EffectWindow::windowDamaged, this, &ZoomEffect::slotWindowDamaged);
 }
 
-void ZoomEffect::slotWindowDamaged()
+void ZoomEffect::slotWindowDamaged(EffectWindow *w)
 {
-    if (m_zoom != 1.0) {
+    // damage outside of the zoomed area doesn't change what's on the screens
+    if (m_zoom != 1.0 && w->expandedGeometry().intersects(visibleSourceRect())) {
         effects->addRepaintFull();
     }
 }
@@ -70,7 +70,7 @@ private Q_SLOTS:
     void moveFocus(const QPointF &point);
     void slotMouseChanged(const QPointF &pos, const QPointF &old);
     void slotWindowAdded(EffectWindow *w);
-    void slotWindowDamaged();
+    void slotWindowDamaged(EffectWindow *w);
     void slotScreenRemoved(LogicalOutput *screen);
     void setTargetZoom(double value);
 
@@ -96,6 +96,7 @@ private:
     void realtimeZoom(double delta);
 
     OffscreenData *ensureOffscreenData(const RenderTarget &renderTarget, const RenderViewport &viewport, LogicalOutput *screen);
+    RectF visibleSourceRect() const;
 
     GLShader *shaderForZoom(double zoom);
     void trackTextCaret();
@@ -13,6 +13,7 @@
 
 #include "config-kwin.h"
 
+#include "compositor.h"
 #include "core/output.h"
 #include "cursorsource.h"
 #include "decorations/decoratedwindow.h"
@@ -72,7 +73,13 @@ static QPointF confineToBoundingBox(const QPointF &pos, const RectF &boundingBox
 PointerInputRedirection::PointerInputRedirection(InputRedirection *parent)
     : InputDeviceHandler(parent)
     , m_cursor(nullptr)
+    , m_coalesceMotion(qEnvironmentVariableIntValue("KWIN_POINTER_COALESCE_MOTION") == 1)
 {
+    // the pending motion is normally processed right before the next frame is composited,
+    // the timer only makes sure it doesn't get stuck if no frame is going to be painted
+    m_motionFlushTimer.setSingleShot(true);
+    m_motionFlushTimer.setInterval(std::chrono::milliseconds(20));
+    connect(&m_motionFlushTimer, &QTimer::timeout, this, &PointerInputRedirection::flushPendingMotion);
 }
 
 PointerInputRedirection::~PointerInputRedirection() = default;
@@ -267,6 +274,21 @@ void PointerInputRedirection::processMotionInternal(const QPointF &pos, const QP
         return;
     }
 
+    if (type == MotionType::Motion && shouldCoalesceMotion()) {
+        // move the cursor right away, but run the filters only once per frame
+        updatePosition(pos, delta, time);
+        m_pendingMotion.push_back(PointerMotionSample{
+            .position = m_pos,
+            .delta = delta,
+            .deltaUnaccelerated = deltaNonAccelerated,
+            .timestamp = time,
+        });
+        m_pendingMotionDevice = device;
+        scheduleMotionFlush();
+        return;
+    }
+    flushPendingMotion();
+
     PositionUpdateBlocker blocker(this);
     updatePosition(pos, delta, time);
 
@@ -287,12 +309,73 @@ void PointerInputRedirection::processMotionInternal(const QPointF &pos, const QP
     input()->processFilters(&InputEventFilter::pointerMotion, &event);
 }
 
+bool PointerInputRedirection::shouldCoalesceMotion() const
+{
+    if (!m_coalesceMotion) {
+        return false;
+    }
+    // clients using relative pointers, e.g. games, want every motion event with its timestamp
+    return !waylandServer()->seat()->isRelativePointerBound();
+}
+
+void PointerInputRedirection::scheduleMotionFlush()
+{
+    if (m_motionFlushTimer.isActive()) {
+        return;
+    }
+    m_motionFlushTimer.start();
+    if (Compositor *compositor = Compositor::self()) {
+        m_motionFlushConnection = connect(compositor, &Compositor::aboutToComposite, this, &PointerInputRedirection::flushPendingMotion, Qt::SingleShotConnection);
+    }
+}
+
+void PointerInputRedirection::flushPendingMotion()
+{
+    if (m_pendingMotion.empty()) {
+        return;
+    }
+    m_motionFlushTimer.stop();
+    disconnect(m_motionFlushConnection);
+
+    const std::vector<PointerMotionSample> history = std::exchange(m_pendingMotion, {});
+    const bool frame = std::exchange(m_pendingMotionFrame, false);
+
+    QPointF delta;
+    QPointF deltaNonAccelerated;
+    for (const PointerMotionSample &sample : history) {
+        delta += sample.delta;
+        deltaNonAccelerated += sample.deltaUnaccelerated;
+    }
+
+    PositionUpdateBlocker blocker(this);
+    PointerMotionEvent event{
+        .device = m_pendingMotionDevice,
+        .position = m_pos,
+        .delta = delta,
+        .deltaUnaccelerated = deltaNonAccelerated,
+        .warp = false,
+        .buttons = m_qtButtons,
+        .modifiers = input()->keyboardModifiers(),
+        .modifiersRelevantForShortcuts = input()->modifiersRelevantForGlobalShortcuts(),
+        .timestamp = history.back().timestamp,
+        .history = history,
+    };
+
+    update();
+    input()->processSpies(&InputEventSpy::pointerMotion, &event);
+    input()->processFilters(&InputEventFilter::pointerMotion, &event);
+    if (frame) {
+        input()->processFilters(&InputEventFilter::pointerFrame);
+    }
+}
+
 void PointerInputRedirection::processButton(uint32_t button, PointerButtonState state, std::chrono::microseconds time, InputDevice *device)
 {
     input()->setLastInputHandler(this);
     if (!inited()) {
         return;
     }
+    flushPendingMotion();
 
     if (state == PointerButtonState::Pressed) {
         update();
@@ -336,6 +419,7 @@ void PointerInputRedirection::processAxis(PointerAxis axis, qreal delta, qint32
     if (!inited()) {
         return;
     }
+    flushPendingMotion();
 
     update();
 
@@ -365,6 +449,7 @@ void PointerInputRedirection::processSwipeGestureBegin(int fingerCount, std::chr
     if (!inited()) {
         return;
     }
+    flushPendingMotion();
     update();
 
     PointerSwipeGestureBeginEvent event{
@@ -382,6 +467,7 @@ void PointerInputRedirection::processSwipeGestureUpdate(const QPointF &delta, st
     if (!inited()) {
         return;
     }
+    flushPendingMotion();
     update();
 
     PointerSwipeGestureUpdateEvent event{
@@ -399,6 +485,7 @@ void PointerInputRedirection::processSwipeGestureEnd(std::chrono::microseconds t
     if (!inited()) {
         return;
     }
+    flushPendingMotion();
     update();
 
     PointerSwipeGestureEndEvent event{
@@ -415,6 +502,7 @@ void PointerInputRedirection::processSwipeGestureCancelled(std::chrono::microsec
     if (!inited()) {
         return;
     }
+    flushPendingMotion();
     update();
 
     PointerSwipeGestureCancelEvent event{
@@ -431,6 +519,7 @@ void PointerInputRedirection::processPinchGestureBegin(int fingerCount, std::chr
     if (!inited()) {
         return;
     }
+    flushPendingMotion();
     update();
 
     PointerPinchGestureBeginEvent event{
@@ -448,6 +537,7 @@ void PointerInputRedirection::processPinchGestureUpdate(qreal scale, qreal angle
     if (!inited()) {
         return;
     }
+    flushPendingMotion();
     update();
 
     PointerPinchGestureUpdateEvent event{
@@ -467,6 +557,7 @@ void PointerInputRedirection::processPinchGestureEnd(std::chrono::microseconds t
     if (!inited()) {
         return;
     }
+    flushPendingMotion();
     update();
 
     PointerPinchGestureEndEvent event{
@@ -483,6 +574,7 @@ void PointerInputRedirection::processPinchGestureCancelled(std::chrono::microsec
     if (!inited()) {
         return;
     }
+    flushPendingMotion();
     update();
 
     PointerPinchGestureCancelEvent event{
@@ -498,6 +590,7 @@ void PointerInputRedirection::processHoldGestureBegin(int fingerCount, std::chro
     if (!inited()) {
         return;
     }
+    flushPendingMotion();
     update();
 
     PointerHoldGestureBeginEvent event{
@@ -514,6 +607,7 @@ void PointerInputRedirection::processHoldGestureEnd(std::chrono::microseconds ti
     if (!inited()) {
         return;
     }
+    flushPendingMotion();
     update();
 
     PointerHoldGestureEndEvent event{
@@ -529,6 +623,7 @@ void PointerInputRedirection::processHoldGestureCancelled(std::chrono::microseco
     if (!inited()) {
         return;
     }
+    flushPendingMotion();
     update();
 
     PointerHoldGestureCancelEvent event{
@@ -544,6 +639,11 @@ void PointerInputRedirection::processFrame(KWin::InputDevice *device)
     if (!inited()) {
         return;
     }
+    if (!m_pendingMotion.empty()) {
+        // sent together with the pending motion
+        m_pendingMotionFrame = true;
+        return;
+    }
 
     input()->processFilters(&InputEventFilter::pointerFrame);
 }
@@ -1194,7 +1294,7 @@ CursorTheme WaylandCursorImage::theme() const
 
 void WaylandCursorImage::updateCursorTheme()
 {
-    const Cursor *pointerCursor = Cursors::self()->mouse();
+    Cursor *pointerCursor = Cursors::self()->mouse();
     qreal targetDevicePixelRatio = 1;
 
     const auto outputs = workspace()->outputs();
@@ -1204,7 +1304,7 @@ void WaylandCursorImage::updateCursorTheme()
         }
     }
 
-    m_cursorTheme = CursorTheme(pointerCursor->themeName(), pointerCursor->themeSize(), targetDevicePixelRatio);
+    m_cursorTheme = pointerCursor->loadTheme(targetDevicePixelRatio);
     if (m_cursorTheme.isEmpty()) {
         qCWarning(KWIN_CORE) << "Failed to load cursor theme" << pointerCursor->themeName();
         m_cursorTheme = CursorTheme(Cursor::defaultThemeName(), Cursor::defaultThemeSize(), targetDevicePixelRatio);
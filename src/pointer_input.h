@@ -12,12 +12,16 @@
 
 #include "cursor.h"
 #include "input.h"
+#include "input_event.h"
 #include "utils/cursortheme.h"
 
 #include <QElapsedTimer>
 #include <QObject>
 #include <QPointF>
 #include <QPointer>
+#include <QTimer>
+
+#include <vector>
 
 class QWindow;
 
@@ -163,6 +167,9 @@ private:
         Warp,
     };
     void processMotionInternal(const QPointF &pos, const QPointF &delta, const QPointF &deltaNonAccelerated, std::chrono::microseconds time, InputDevice *device, MotionType type);
+    bool shouldCoalesceMotion() const;
+    void scheduleMotionFlush();
+    void flushPendingMotion();
     void cleanupDecoration(Decoration::DecoratedWindowImpl *old, Decoration::DecoratedWindowImpl *now) override;
 
     void focusUpdate(Window *focusOld, Window *focusNow) override;
@@ -197,6 +204,12 @@ private:
     bool m_lastOutputWasPlaceholder = true;
     QPointF m_movementInEdgeBarrier;
     std::chrono::microseconds m_lastMoveTime = std::chrono::microseconds::zero();
+    bool m_coalesceMotion = false;
+    std::vector<PointerMotionSample> m_pendingMotion;
+    QPointer<InputDevice> m_pendingMotionDevice;
+    bool m_pendingMotionFrame = false;
+    QTimer m_motionFlushTimer;
+    QMetaObject::Connection m_motionFlushConnection;
     friend class PositionUpdateBlocker;
     EdgeBarrierType m_lastEdgeBarrierType = EdgeBarrierType::NormalBarrier;
 };
@@ -17,6 +17,8 @@
 #include <QTemporaryFile>
 #include <kconfig.h>
 
+#include <algorithm>
+
 #ifndef KCMRULES
 #include "client_machine.h"
 #include "main.h"
@@ -81,9 +83,11 @@ Rules::Rules()
 {
 }
 
-#define READ_MATCH_STRING(var, func) \
-    var = settings->var() func;      \
-    var##match = static_cast<StringMatch>(settings->var##match())
+#define READ_MATCH_STRING(var, func)                                 \
+    var = settings->var() func;                                      \
+    var##match = static_cast<StringMatch>(settings->var##match());   \
+    var##regexp = var##match == RegExpMatch ? QRegularExpression(var) \
+                                            : QRegularExpression()
 
 #define READ_SET_RULE(var) \
     var = settings->var(); \
@@ -369,7 +373,7 @@ bool Rules::matchWMClass(const QString &match_class, const QString &match_name)
         QString cwmclass = wmclasscomplete
             ? match_name + ' ' + match_class
             : match_class;
-        if (wmclassmatch == RegExpMatch && !QRegularExpression(wmclass).match(cwmclass).hasMatch()) {
+        if (wmclassmatch == RegExpMatch && !wmclassregexp.match(cwmclass).hasMatch()) {
             return false;
         }
         if (wmclassmatch == ExactMatch && cwmclass != wmclass) {
@@ -385,7 +389,7 @@ bool Rules::matchWMClass(const QString &match_class, const QString &match_name)
 bool Rules::matchRole(const QString &match_role) const
 {
     if (windowrolematch != UnimportantMatch) {
-        if (windowrolematch == RegExpMatch && !QRegularExpression(windowrole).match(match_role).hasMatch()) {
+        if (windowrolematch == RegExpMatch && !windowroleregexp.match(match_role).hasMatch()) {
             return false;
         }
         if (windowrolematch == ExactMatch && match_role != windowrole) {
@@ -401,7 +405,7 @@ bool Rules::matchRole(const QString &match_role) const
 bool Rules::matchTitle(const QString &match_title) const
 {
     if (titlematch != UnimportantMatch) {
-        if (titlematch == RegExpMatch && !QRegularExpression(title).match(match_title).hasMatch()) {
+        if (titlematch == RegExpMatch && !titleregexp.match(match_title).hasMatch()) {
             return false;
         }
         if (titlematch == ExactMatch && title != match_title) {
@@ -423,7 +427,7 @@ bool Rules::matchClientMachine(const QString &match_machine, bool local) const
             return true;
         }
         if (clientmachinematch == RegExpMatch
-            && !QRegularExpression(clientmachine).match(match_machine).hasMatch()) {
+            && !clientmachineregexp.match(match_machine).hasMatch()) {
             return false;
         }
         if (clientmachinematch == ExactMatch
@@ -441,7 +445,7 @@ bool Rules::matchClientMachine(const QString &match_machine, bool local) const
 bool Rules::matchTag(const QString &match_tag) const
 {
     if (tagmatch != UnimportantMatch) {
-        if (tagmatch == RegExpMatch && !QRegularExpression(tag).match(match_tag).hasMatch()) {
+        if (tagmatch == RegExpMatch && !tagregexp.match(match_tag).hasMatch()) {
             return false;
         }
         if (tagmatch == ExactMatch && tag != match_tag) {
@@ -495,6 +499,16 @@ bool Rules::match(const Window *c) const
     return true;
 }
 
+QString Rules::exactWMClass() const
+{
+    return wmclassmatch == ExactMatch ? wmclass : QString();
+}
+
+bool Rules::isWMClassComplete() const
+{
+    return wmclasscomplete;
+}
+
 #define NOW_REMEMBER(_T_, _V_) ((selection & _T_) && (_V_##rule == (SetRule)Remember))
 
 bool Rules::update(Window *c, int selection)
@@ -940,12 +954,39 @@ void RuleBook::deleteAll()
 {
     qDeleteAll(m_rules);
     m_rules.clear();
+    updateIndex();
+}
+
+void RuleBook::updateIndex()
+{
+    m_wmClassRules.clear();
+    m_completeWMClassRules.clear();
+    m_otherRules.clear();
+    for (qsizetype i = 0; i < m_rules.size(); ++i) {
+        const Rules *rule = m_rules[i];
+        const QString wmClass = rule->exactWMClass();
+        if (wmClass.isEmpty()) {
+            m_otherRules.append(i);
+        } else if (rule->isWMClassComplete()) {
+            m_completeWMClassRules[wmClass].append(i);
+        } else {
+            m_wmClassRules[wmClass].append(i);
+        }
+    }
 }
 
 WindowRules RuleBook::find(const Window *window) const
 {
+    // Only the rules that can match the window class of the window are checked, in the
+    // order of the rule book
+    QList<qsizetype> candidates = m_otherRules;
+    candidates += m_wmClassRules.value(window->resourceClass());
+    candidates += m_completeWMClassRules.value(window->resourceName() + QLatin1Char(' ') + window->resourceClass());
+    std::sort(candidates.begin(), candidates.end());
+
     QList<Rules *> ret;
-    for (Rules *rule : m_rules) {
+    for (qsizetype index : std::as_const(candidates)) {
+        Rules *rule = m_rules[index];
         if (rule->match(window)) {
             qCDebug(KWIN_CORE) << "Rule found:" << rule << ":" << window;
             ret.append(rule);
@@ -982,6 +1023,7 @@ void RuleBook::edit(Window *c, bool whole_app)
 void RuleBook::setConfig(const KSharedConfig::Ptr &config)
 {
     m_book = std::make_unique<RuleBookSettings>(config);
+    m_snapshot.reset();
 }
 
 void RuleBook::load()
@@ -994,6 +1036,23 @@ void RuleBook::load()
     }
     m_book->load();
     m_rules = m_book->rules();
+    m_snapshot = ConfigSnapshot(m_book->sharedConfig().data());
+    updateIndex();
+}
+
+bool RuleBook::reload()
+{
+    if (!m_book || !m_snapshot) {
+        load();
+        return true;
+    }
+    m_book->sharedConfig()->reparseConfiguration();
+    if (ConfigSnapshot(m_book->sharedConfig().data()) == *m_snapshot) {
+        return false;
+    }
+    // the config has been reparsed already, but doing it twice is harmless
+    load();
+    return true;
 }
 
 void RuleBook::save()
@@ -1008,6 +1067,7 @@ void RuleBook::save()
 
 void RuleBook::discardUsed(Window *c, bool withdrawn)
 {
+    bool removed = false;
     for (QList<Rules *>::Iterator it = m_rules.begin();
          it != m_rules.end();) {
         if (c->rules()->contains(*it)) {
@@ -1023,6 +1083,7 @@ void RuleBook::discardUsed(Window *c, bool withdrawn)
                 Rules *r = *it;
                 it = m_rules.erase(it);
                 delete r;
+                removed = true;
                 if (index) {
                     m_book->removeRuleSettingsAt(index.value());
                 }
@@ -1031,6 +1092,9 @@ void RuleBook::discardUsed(Window *c, bool withdrawn)
         }
         ++it;
     }
+    if (removed) {
+        updateIndex();
+    }
     if (m_book->usrIsSaveNeeded()) {
         requestDiskStorage();
     }
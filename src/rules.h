@@ -9,10 +9,15 @@
 
 #pragma once
 
+#include <QHash>
 #include <QList>
+#include <QRegularExpression>
 
 #include "options.h"
 #include "utils/common.h"
+#include "utils/configsnapshot.h"
+
+#include <optional>
 
 class QDebug;
 class KConfig;
@@ -150,6 +155,13 @@ public:
 #ifndef KCMRULES
     bool discardUsed(bool withdrawn);
     bool match(const Window *c) const;
+    /**
+     * Returns the window class that windows must have exactly to match this rule, or an
+     * empty string if the rule matches the window class differently or not at all. If the
+     * complete window class is matched, it includes the resource name, separated by a space.
+     */
+    QString exactWMClass() const;
+    bool isWMClassComplete() const;
     bool update(Window *, int selection);
     bool applyPlacement(PlacementPolicy &placement) const;
     bool applyGeometry(RectF &rect, bool init) const;
@@ -226,6 +238,12 @@ private:
     StringMatch clientmachinematch;
     QString tag;
     StringMatch tagmatch;
+    // the regular expressions of the string matches, compiled once
+    QRegularExpression wmclassregexp;
+    QRegularExpression windowroleregexp;
+    QRegularExpression titleregexp;
+    QRegularExpression clientmachineregexp;
+    QRegularExpression tagregexp;
     bool hastransientparent;
     BoolMatch hastransientparentmatch;
     WindowTypes types; // types for matching
@@ -309,6 +327,11 @@ public:
     void setUpdatesDisabled(bool disable);
     bool areUpdatesDisabled() const;
     void load();
+    /**
+     * Re-reads the rules if their config changed since they were last loaded. Returns @c true
+     * if the rules were reloaded.
+     */
+    bool reload();
     void edit(Window *c, bool whole_app);
     void requestDiskStorage();
     void setConfig(const KSharedConfig::Ptr &config);
@@ -318,10 +341,17 @@ private Q_SLOTS:
 
 private:
     void deleteAll();
+    void updateIndex();
     QTimer *m_updateTimer;
     bool m_updatesDisabled;
     QList<Rules *> m_rules;
+    // the positions in m_rules of the rules that match an exact window class, or the complete
+    // window class, and of all the other rules, which have to be checked for every window
+    QHash<QString, QList<qsizetype>> m_wmClassRules;
+    QHash<QString, QList<qsizetype>> m_completeWMClassRules;
+    QList<qsizetype> m_otherRules;
     std::unique_ptr<RuleBookSettings> m_book;
+    std::optional<ConfigSnapshot> m_snapshot;
 };
 
 inline bool RuleBook::areUpdatesDisabled() const
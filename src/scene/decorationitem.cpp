@@ -6,24 +6,27 @@
 */
 
 #include "scene/decorationitem.h"
+#include "core/output.h"
 #include "decorations/decoratedwindow.h"
 #include "scene/atlas.h"
 #include "scene/itemrenderer.h"
 #include "scene/outlinedborderitem.h"
 #include "scene/scene.h"
 #include "window.h"
+#include "workspace.h"
 
 #include <KDecoration3/DecoratedWindow>
 #include <KDecoration3/Decoration>
 
 #include <QPainter>
 
+#include <algorithm>
+
 namespace KWin
 {
 
 DecorationRenderer::DecorationRenderer(Decoration::DecoratedWindowImpl *client)
     : m_client(client)
-    , m_imageSizesDirty(true)
 {
     connect(client->decoration(), &KDecoration3::Decoration::damaged, this, [this](const QRegion &region) {
         addDamage(RegionF(region));
@@ -46,23 +49,29 @@ void DecorationRenderer::invalidate()
     if (m_client) {
         addDamage(m_client->window()->rect());
     }
-    m_imageSizesDirty = true;
+    m_raster.imageSizesDirty = true;
+    for (Raster &raster : m_retainedRasters) {
+        raster.imageSizesDirty = true;
+    }
 }
 
 RegionF DecorationRenderer::damage() const
 {
-    return m_damage;
+    return m_raster.damage;
 }
 
 void DecorationRenderer::addDamage(const RegionF &region)
 {
-    m_damage += region;
+    m_raster.damage += region;
+    for (Raster &raster : m_retainedRasters) {
+        raster.damage += region;
+    }
     Q_EMIT damaged(region);
 }
 
 void DecorationRenderer::resetDamage()
 {
-    m_damage = RegionF();
+    m_raster.damage = RegionF();
 }
 
 qreal DecorationRenderer::effectiveDevicePixelRatio() const
@@ -73,25 +82,56 @@ qreal DecorationRenderer::effectiveDevicePixelRatio() const
 
 qreal DecorationRenderer::devicePixelRatio() const
 {
-    return m_devicePixelRatio;
+    return m_raster.devicePixelRatio;
 }
 
 void DecorationRenderer::setDevicePixelRatio(qreal dpr)
 {
-    if (m_devicePixelRatio != dpr) {
-        m_devicePixelRatio = dpr;
-        invalidate();
+    if (m_raster.devicePixelRatio == dpr) {
+        return;
+    }
+
+    Raster previous = std::move(m_raster);
+    const auto it = std::ranges::find(m_retainedRasters, dpr, &Raster::devicePixelRatio);
+    if (it != m_retainedRasters.end()) {
+        m_raster = std::move(*it);
+        m_retainedRasters.erase(it);
+    } else {
+        m_raster = Raster();
+        m_raster.devicePixelRatio = dpr;
+        if (m_client) {
+            m_raster.damage = m_client->window()->rect();
+        }
+    }
+    if (previous.atlas) {
+        m_retainedRasters.push_back(std::move(previous));
     }
+
+    if (m_client) {
+        Q_EMIT damaged(m_client->window()->rect());
+    }
+}
+
+void DecorationRenderer::retainDevicePixelRatios(const QList<qreal> &devicePixelRatios)
+{
+    std::erase_if(m_retainedRasters, [&devicePixelRatios](const Raster &raster) {
+        return !devicePixelRatios.contains(raster.devicePixelRatio);
+    });
+}
+
+bool DecorationRenderer::hasRetainedRasters() const
+{
+    return !m_retainedRasters.empty();
 }
 
 Atlas *DecorationRenderer::atlas() const
 {
-    return m_atlas.get();
+    return m_raster.atlas.get();
 }
 
 bool DecorationRenderer::needsRepaint() const
 {
-    return m_imageSizesDirty || !m_damage.isEmpty();
+    return m_raster.imageSizesDirty || !m_raster.damage.isEmpty();
 }
 
 void DecorationRenderer::render(ItemRenderer *itemRenderer, const RegionF &region)
@@ -104,8 +144,12 @@ void DecorationRenderer::render(ItemRenderer *itemRenderer, const RegionF &regio
                                               decorationRects[int(DecorationPart::Right)],
                                               decorationRects[int(DecorationPart::Bottom)]);
 
-    const bool resized = std::exchange(m_imageSizesDirty, false);
-    if (resized) {
+    // the decoration is invalidated on every size or border change, but the layout of the
+    // atlas only has to be redone if the size of a part actually changed. Otherwise only
+    // the repainted parts have to be uploaded
+    bool resized = false;
+    QImage *images = m_raster.images;
+    if (std::exchange(m_raster.imageSizesDirty, false)) {
         const qreal dpr = effectiveDevicePixelRatio();
 
         for (int i = 0; i < 4; ++i) {
@@ -113,10 +157,11 @@ void DecorationRenderer::render(ItemRenderer *itemRenderer, const RegionF &regio
                                          .scaled(dpr)
                                          .rounded()
                                          .size();
-            if (m_images[i].size() != nativeSize || m_images[i].devicePixelRatio() != dpr) {
-                m_images[i] = QImage(nativeSize, QImage::Format_ARGB32_Premultiplied);
-                m_images[i].setDevicePixelRatio(dpr);
-                m_images[i].fill(Qt::transparent);
+            if (images[i].size() != nativeSize || images[i].devicePixelRatio() != dpr) {
+                images[i] = QImage(nativeSize, QImage::Format_ARGB32_Premultiplied);
+                images[i].setDevicePixelRatio(dpr);
+                images[i].fill(Qt::transparent);
+                resized = true;
             }
         }
     }
@@ -157,20 +202,20 @@ void DecorationRenderer::render(ItemRenderer *itemRenderer, const RegionF &regio
 
     Rect repainted[4];
     for (int i = 0; i < 4; ++i) {
-        repainted[i] = renderPart(m_images[i], decorationRects[i], geometry);
+        repainted[i] = renderPart(images[i], decorationRects[i], geometry);
     }
 
-    if (!m_atlas) {
-        m_atlas = itemRenderer->createAtlas({m_images[0], m_images[1], m_images[2], m_images[3]});
+    if (!m_raster.atlas) {
+        m_raster.atlas = itemRenderer->createAtlas({images[0], images[1], images[2], images[3]});
         return;
     }
 
     if (resized) {
-        m_atlas->reset({m_images[0], m_images[1], m_images[2], m_images[3]});
+        m_raster.atlas->reset({images[0], images[1], images[2], images[3]});
     } else {
         for (int i = 0; i < 4; ++i) {
             if (!repainted[i].isEmpty()) {
-                m_atlas->update(i, m_images[i], repainted[i]);
+                m_raster.atlas->update(i, images[i], repainted[i]);
             }
         }
     }
@@ -178,8 +223,9 @@ void DecorationRenderer::render(ItemRenderer *itemRenderer, const RegionF &regio
 
 void DecorationRenderer::releaseResources()
 {
-    m_atlas.reset();
-    m_imageSizesDirty = true;
+    m_raster.atlas.reset();
+    m_raster.imageSizesDirty = true;
+    m_retainedRasters.clear();
 }
 
 DecorationItem::DecorationItem(KDecoration3::Decoration *decoration, Window *window, Item *parent)
@@ -189,6 +235,7 @@ DecorationItem::DecorationItem(KDecoration3::Decoration *decoration, Window *win
     , m_renderer(std::make_unique<DecorationRenderer>(window->decoratedWindow()))
 {
     connect(window, &Window::targetScaleChanged, this, &DecorationItem::updateScale);
+    connect(window, &Window::frameGeometryChanged, this, &DecorationItem::updateRetainedScales);
 
     connect(decoration->window(), &KDecoration3::DecoratedWindow::sizeChanged,
             this, &DecorationItem::handleDecorationGeometryChanged);
@@ -240,6 +287,26 @@ void DecorationItem::updateScale()
         m_renderer->setDevicePixelRatio(scale);
         discardQuads();
     }
+    updateRetainedScales();
+}
+
+void DecorationItem::updateRetainedScales()
+{
+    if (!m_renderer->hasRetainedRasters()) {
+        return;
+    }
+
+    // keep the rasters for the outputs the window is still on, so it can go back and forth
+    // between them without being rendered again
+    QList<qreal> scales;
+    const RectF frameGeometry = m_window->frameGeometry();
+    const auto outputs = workspace()->outputs();
+    for (LogicalOutput *output : outputs) {
+        if (output->geometryF().intersects(frameGeometry)) {
+            scales.append(output->scale());
+        }
+    }
+    m_renderer->retainDevicePixelRatios(scales);
 }
 
 void DecorationItem::updateOutline()
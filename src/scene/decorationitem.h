@@ -8,6 +8,8 @@
 
 #include "scene/item.h"
 
+#include <vector>
+
 namespace KDecoration3
 {
 
@@ -61,18 +63,36 @@ public:
     qreal devicePixelRatio() const;
     void setDevicePixelRatio(qreal dpr);
 
+    /**
+     * Drops the rasters kept for device pixel ratios other than the current one that are not
+     * in @a devicePixelRatios.
+     */
+    void retainDevicePixelRatios(const QList<qreal> &devicePixelRatios);
+    bool hasRetainedRasters() const;
+
     void releaseResources();
 
 Q_SIGNALS:
     void damaged(const RegionF &region);
 
 private:
+    /**
+     * The decoration rendered at one device pixel ratio. When a window moves between outputs
+     * with different scales, the raster of the previous scale is kept along with the damage
+     * it has missed since, so moving the window back only repaints what actually changed.
+     */
+    struct Raster
+    {
+        qreal devicePixelRatio = 1;
+        RegionF damage;
+        bool imageSizesDirty = true;
+        QImage images[4];
+        std::unique_ptr<Atlas> atlas;
+    };
+
     QPointer<Decoration::DecoratedWindowImpl> m_client;
-    RegionF m_damage;
-    qreal m_devicePixelRatio = 1;
-    bool m_imageSizesDirty;
-    QImage m_images[4];
-    std::unique_ptr<Atlas> m_atlas;
+    Raster m_raster;
+    std::vector<Raster> m_retainedRasters;
 };
 
 /**
@@ -95,6 +115,7 @@ public:
 private Q_SLOTS:
     void handleDecorationGeometryChanged();
     void updateScale();
+    void updateRetainedScales();
     void updateOutline();
 
 protected:
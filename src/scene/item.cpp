@@ -42,7 +42,10 @@ ItemEffect &ItemEffect::operator=(ItemEffect &&move)
     return *this;
 }
 
+static quint64 s_lastQuadsSerial = 0;
+
 Item::Item(Item *parent)
+    : m_quadsSerial(++s_lastQuadsSerial)
 {
     setParentItem(parent);
 }
@@ -106,7 +109,7 @@ void Item::setParentItem(Item *item)
     if (m_parentItem) {
         m_parentItem->addChild(this);
     }
-    updateItemToSceneTransform();
+    invalidateItemToSceneTransform();
     updateEffectiveVisibility();
 }
 
@@ -116,6 +119,7 @@ void Item::addChild(Item *item)
 
     m_childItems.append(item);
     markSortedChildItemsDirty();
+    markSubtreeDirty();
 
     updateBoundingRect();
     scheduleRepaint(item->transform().mapRect(item->boundingRect()).translated(item->position()));
@@ -155,6 +159,7 @@ void Item::setScene(Scene *scene)
             }
         }
         m_deviceRepaints.clear();
+        m_cleanSubtreeViews.clear();
         disconnect(m_scene, &Scene::viewRemoved, this, &Item::removeRepaints);
     }
     if (scene) {
@@ -178,7 +183,7 @@ void Item::setPosition(const QPointF &point)
     if (m_position != point) {
         scheduleMoveRepaint(this);
         m_position = point;
-        updateItemToSceneTransform();
+        invalidateItemToSceneTransform();
         if (m_parentItem) {
             m_parentItem->updateBoundingRect();
         }
@@ -257,29 +262,51 @@ void Item::setTransform(const QTransform &transform)
     }
     scheduleRepaint(boundingRect());
     m_transform = transform;
-    updateItemToSceneTransform();
+    invalidateItemToSceneTransform();
     if (m_parentItem) {
         m_parentItem->updateBoundingRect();
     }
     scheduleRepaint(boundingRect());
 }
 
-void Item::updateItemToSceneTransform()
+void Item::invalidateItemToSceneTransform()
 {
-    m_itemToSceneTransform = m_transform;
-    if (!m_position.isNull()) {
-        m_itemToSceneTransform *= QTransform::fromTranslate(m_position.x(), m_position.y());
-    }
-    if (m_parentItem) {
-        m_itemToSceneTransform *= m_parentItem->m_itemToSceneTransform;
+    // the transforms are computed lazily. If an item's transform is invalid, so are the
+    // transforms of its descendants, there's no need to visit them again
+    if (!m_itemToSceneTransform.has_value()) {
+        return;
     }
-    m_sceneToItemTransform = m_itemToSceneTransform.inverted();
+    m_itemToSceneTransform.reset();
+    m_sceneToItemTransform.reset();
 
     for (Item *childItem : std::as_const(m_childItems)) {
-        childItem->updateItemToSceneTransform();
+        childItem->invalidateItemToSceneTransform();
     }
 }
 
+const QTransform &Item::itemToSceneTransform() const
+{
+    if (!m_itemToSceneTransform.has_value()) {
+        QTransform transform = m_transform;
+        if (!m_position.isNull()) {
+            transform *= QTransform::fromTranslate(m_position.x(), m_position.y());
+        }
+        if (m_parentItem) {
+            transform *= m_parentItem->itemToSceneTransform();
+        }
+        m_itemToSceneTransform = transform;
+    }
+    return *m_itemToSceneTransform;
+}
+
+const QTransform &Item::sceneToItemTransform() const
+{
+    if (!m_sceneToItemTransform.has_value()) {
+        m_sceneToItemTransform = itemToSceneTransform().inverted();
+    }
+    return *m_sceneToItemTransform;
+}
+
 Region Item::mapToView(const Region &region, const RenderView *view) const
 {
     Region ret;
@@ -316,7 +343,7 @@ Region Item::mapToScene(const Region &region) const
     }
     Region ret;
     for (const Rect &rect : region.rects()) {
-        ret |= m_itemToSceneTransform.mapRect(rect);
+        ret |= itemToSceneTransform().mapRect(rect);
     }
     return ret;
 }
@@ -325,7 +352,7 @@ RegionF Item::mapToScene(const RegionF &region) const
 {
     RegionF ret;
     for (const RectF &rect : region.rects()) {
-        ret |= m_itemToSceneTransform.mapRect(rect);
+        ret |= itemToSceneTransform().mapRect(rect);
     }
     return ret;
 }
@@ -335,7 +362,7 @@ RectF Item::mapToScene(const RectF &rect) const
     if (rect.isEmpty()) {
         return Rect();
     }
-    return m_itemToSceneTransform.mapRect(rect);
+    return itemToSceneTransform().mapRect(rect);
 }
 
 RectF Item::mapFromScene(const RectF &rect) const
@@ -343,7 +370,7 @@ RectF Item::mapFromScene(const RectF &rect) const
     if (rect.isEmpty()) {
         return Rect();
     }
-    return m_sceneToItemTransform.mapRect(rect);
+    return sceneToItemTransform().mapRect(rect);
 }
 
 Rect Item::paintedDeviceArea(RenderView *view, const RectF &rect) const
@@ -454,6 +481,7 @@ void Item::scheduleRepaintInternal(const RegionF &region)
         const Region dirtyRegion = paintedDeviceArea(view, region);
         if (!dirtyRegion.isEmpty()) {
             m_deviceRepaints[view] += dirtyRegion;
+            markSubtreeDirty(view);
             view->scheduleRepaint(this);
         }
     }
@@ -475,6 +503,7 @@ void Item::scheduleMoveRepaint(Item *originallyMovedItem)
             // and this item was just implicitly moved as a consequence
             if (!view->canSkipMoveRepaint(originallyMovedItem)) {
                 m_deviceRepaints[view] += dirtyRegion;
+                markSubtreeDirty(view);
             }
             view->scheduleRepaint(this);
         }
@@ -492,6 +521,7 @@ void Item::scheduleRepaintInternal(RenderView *view, const RegionF &region)
     const Region dirtyRegion = paintedDeviceArea(view, region);
     if (!dirtyRegion.isEmpty()) {
         m_deviceRepaints[view] += dirtyRegion;
+        markSubtreeDirty(view);
         view->scheduleRepaint(this);
     }
 }
@@ -545,6 +575,7 @@ WindowQuadList Item::buildQuads() const
 void Item::discardQuads()
 {
     m_quads.reset();
+    m_quadsSerial = ++s_lastQuadsSerial;
 }
 
 WindowQuadList Item::quads() const
@@ -555,6 +586,11 @@ WindowQuadList Item::quads() const
     return m_quads.value();
 }
 
+quint64 Item::quadsSerial() const
+{
+    return m_quadsSerial;
+}
+
 bool Item::hasRepaints(RenderView *view) const
 {
     const auto it = m_deviceRepaints.find(view);
@@ -577,6 +613,33 @@ void Item::resetRepaints(RenderView *view)
 void Item::removeRepaints(RenderView *view)
 {
     m_deviceRepaints.remove(view);
+    m_cleanSubtreeViews.removeOne(view);
+}
+
+bool Item::hasDirtySubtree(RenderView *view) const
+{
+    return !m_cleanSubtreeViews.contains(view);
+}
+
+void Item::markSubtreeClean(RenderView *view)
+{
+    if (!m_cleanSubtreeViews.contains(view)) {
+        m_cleanSubtreeViews.append(view);
+    }
+}
+
+void Item::markSubtreeDirty(RenderView *view)
+{
+    // if an item is clean, so are its descendants. The ancestors of a dirty item are dirty too
+    for (Item *item = this; item && item->m_cleanSubtreeViews.removeOne(view); item = item->parentItem()) {
+    }
+}
+
+void Item::markSubtreeDirty()
+{
+    for (Item *item = this; item && !item->m_cleanSubtreeViews.isEmpty(); item = item->parentItem()) {
+        item->m_cleanSubtreeViews.clear();
+    }
 }
 
 bool Item::explicitVisible() const
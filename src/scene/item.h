@@ -17,6 +17,7 @@
 #include <QObject>
 #include <QPointer>
 #include <QTransform>
+#include <QVarLengthArray>
 
 #include <optional>
 
@@ -163,8 +164,23 @@ public:
     bool hasRepaints(RenderView *view) const;
     Region takeDeviceRepaints(RenderView *delegate);
     void resetRepaints(RenderView *delegate);
+    /**
+     * Returns @c true if this item or any of its descendants may have repaints for the given
+     * @a view, i.e. new repaints were scheduled since the subtree was last marked clean.
+     */
+    bool hasDirtySubtree(RenderView *view) const;
+    /**
+     * Marks this item and all of its descendants as having no repaints for the given @a view.
+     * This lets the repaint collection skip the subtree until repaints get scheduled in it again.
+     */
+    void markSubtreeClean(RenderView *view);
 
     WindowQuadList quads() const;
+    /**
+     * Returns a number that changes whenever the quads of the item are discarded. Unlike the
+     * address of the item, the number is never reused by other items.
+     */
+    quint64 quadsSerial() const;
     virtual void preprocess();
     const std::shared_ptr<ColorDescription> &colorDescription() const;
     RenderingIntent renderingIntent() const;
@@ -216,7 +232,9 @@ private:
     void addChild(Item *item);
     void removeChild(Item *item);
     void updateBoundingRect();
-    void updateItemToSceneTransform();
+    void invalidateItemToSceneTransform();
+    const QTransform &itemToSceneTransform() const;
+    const QTransform &sceneToItemTransform() const;
     void scheduleRepaintInternal(const RegionF &region);
     void scheduleRepaintInternal(RenderView *delegate, const RegionF &region);
     void scheduleSceneRepaintInternal(const RegionF &region);
@@ -225,6 +243,8 @@ private:
     bool computeEffectiveVisibility() const;
     void updateEffectiveVisibility();
     void removeRepaints(RenderView *delegate);
+    void markSubtreeDirty(RenderView *view);
+    void markSubtreeDirty();
 
     void scheduleMoveRepaint(Item *originallyMovedItem);
 
@@ -232,8 +252,8 @@ private:
     QPointer<Item> m_parentItem;
     QList<Item *> m_childItems;
     QTransform m_transform;
-    QTransform m_itemToSceneTransform;
-    QTransform m_sceneToItemTransform;
+    mutable std::optional<QTransform> m_itemToSceneTransform;
+    mutable std::optional<QTransform> m_sceneToItemTransform;
     RectF m_boundingRect;
     QPointF m_position;
     QSizeF m_size = QSize(0, 0);
@@ -243,7 +263,9 @@ private:
     bool m_explicitVisible = true;
     bool m_effectiveVisible = true;
     QMap<RenderView *, Region> m_deviceRepaints;
+    QVarLengthArray<RenderView *, 4> m_cleanSubtreeViews;
     mutable std::optional<WindowQuadList> m_quads;
+    quint64 m_quadsSerial;
     mutable std::optional<QList<Item *>> m_sortedChildItems;
     std::shared_ptr<ColorDescription> m_colorDescription = ColorDescription::sRGB;
     RenderingIntent m_renderingIntent = RenderingIntent::Perceptual;
@@ -29,4 +29,13 @@ void ItemRenderer::setLayerDebugging(bool enable)
 {
 }
 
+void ItemRenderer::setColorFilter(const QMatrix4x4 &filter)
+{
+}
+
+FrameArena *ItemRenderer::frameArena()
+{
+    return &m_frameArena;
+}
+
 } // namespace KWin
@@ -9,6 +9,7 @@
 #include <kwin_export.h>
 
 #include "core/region.h"
+#include "utils/framearena.h"
 
 #include <QMatrix4x4>
 #include <memory>
@@ -56,6 +57,22 @@ public:
     [[nodiscard]] virtual bool renderItem(const RenderTarget &renderTarget, const RenderViewport &viewport, Item *item, int mask, const Region &deviceRegion, const WindowPaintData &data, const std::function<bool(Item *)> &filter, const std::function<bool(Item *)> &holeFilter) = 0;
 
     virtual void setLayerDebugging(bool enable);
+
+    /**
+     * Sets a matrix that is applied to the colors of everything that gets rendered, in linear
+     * light and in the color space of the render target. It's combined with the color space
+     * conversions, so it doesn't need a separate pass.
+     */
+    virtual void setColorFilter(const QMatrix4x4 &filter);
+
+    /**
+     * Returns the arena for temporary allocations that are made while painting a frame.
+     * The arena is reset after the frame has been painted, see WorkspaceScene::postPaint().
+     */
+    FrameArena *frameArena();
+
+private:
+    FrameArena m_frameArena;
 };
 
 } // namespace KWin
@@ -11,10 +11,13 @@
 #include "core/renderviewport.h"
 #include "core/syncobjtimeline.h"
 #include "effect/effect.h"
+#include "ftrace.h"
 #include "opengl/eglnativefence.h"
+#include "opengl/glgpuprofiler.h"
 #include "scene/decorationitem.h"
 #include "scene/imageitem.h"
 #include "scene/opengl/atlas.h"
+#include "scene/opengl/imageatlas.h"
 #include "scene/opengl/ninepatch.h"
 #include "scene/opengl/texture.h"
 #include "scene/outlinedborderitem.h"
@@ -23,11 +26,15 @@
 #include "scene/workspacescene.h"
 #include "utils/common.h"
 
+#include <algorithm>
+#include <cmath>
+
 namespace KWin
 {
 
 ItemRendererOpenGL::ItemRendererOpenGL(EglDisplay *eglDisplay)
     : m_eglDisplay(eglDisplay)
+    , m_imageAtlas(std::make_shared<ImageAtlasOpenGL>())
 {
     const QString visualizeOptionsString = qEnvironmentVariable("KWIN_SCENE_VISUALIZE");
     if (!visualizeOptionsString.isEmpty()) {
@@ -41,8 +48,16 @@ std::unique_ptr<Texture> ItemRendererOpenGL::createTexture(GraphicsBuffer *buffe
     return BufferTextureOpenGL::create(buffer, releasePoint);
 }
 
+ItemRendererOpenGL::~ItemRendererOpenGL() = default;
+
 std::unique_ptr<Texture> ItemRendererOpenGL::createTexture(const QImage &image)
 {
+    // small images share textures, so that they don't need a texture object each
+    if (ImageAtlasOpenGL::canStore(image)) {
+        if (auto texture = m_imageAtlas->createTexture(image)) {
+            return texture;
+        }
+    }
     return ImageTextureOpenGL::create(image);
 }
 
@@ -68,12 +83,22 @@ std::unique_ptr<Atlas> ItemRendererOpenGL::createAtlas(const QList<QImage> &spri
     return AtlasOpenGL::create(sprites);
 }
 
+// most surfaces use one of a handful of color descriptions, this only has to hold
+// the combinations used by all outputs
+static constexpr size_t s_maxColorTransformations = 32;
+
 void ItemRendererOpenGL::beginFrame(const RenderTarget &renderTarget, const RenderViewport &viewport)
 {
     GLFramebuffer *fbo = renderTarget.framebuffer();
     GLFramebuffer::pushFramebuffer(fbo);
 
     GLVertexBuffer::streamingBuffer()->beginFrame();
+    m_imageAtlas->defragmentIfIdle();
+
+    if (m_colorTransformations.size() > s_maxColorTransformations) {
+        // the output color descriptions have most likely changed, the old entries are stale
+        m_colorTransformations.clear();
+    }
 }
 
 void ItemRendererOpenGL::endFrame()
@@ -81,7 +106,9 @@ void ItemRendererOpenGL::endFrame()
     GLVertexBuffer::streamingBuffer()->endOfFrame();
     GLFramebuffer::popFramebuffer();
 
-    if (m_eglDisplay) {
+    collectRetainedGeometry();
+
+    if (m_eglDisplay && !m_releasePoints.empty()) {
         EGLNativeFence fence(m_eglDisplay);
         if (fence.isValid()) {
             for (const auto &releasePoint : m_releasePoints) {
@@ -92,6 +119,37 @@ void ItemRendererOpenGL::endFrame()
     m_releasePoints.clear();
 }
 
+const ItemRendererOpenGL::ColorTransformation &ItemRendererOpenGL::cachedColorTransformation(const std::shared_ptr<ColorDescription> &source, const std::shared_ptr<ColorDescription> &destination, RenderingIntent intent, bool floatingPoint)
+{
+    const auto it = std::ranges::find_if(m_colorTransformations, [&](const ColorTransformation &transformation) {
+        return transformation.source == source
+            && transformation.destination == destination
+            && transformation.intent == intent
+            && transformation.floatingPoint == floatingPoint;
+    });
+    if (it != m_colorTransformations.end()) {
+        return *it;
+    }
+    const auto pipeline = ColorPipeline::create(source, destination, intent, floatingPoint ? ColorPipeline::InputType::FloatingPoint : ColorPipeline::InputType::FixedPoint);
+    return m_colorTransformations.emplace_back(ColorTransformation{
+        .source = source,
+        .destination = destination,
+        .intent = intent,
+        .floatingPoint = floatingPoint,
+        .isIdentity = pipeline.isIdentity() && m_colorFilter.isIdentity(),
+        .colorimetryTransformation = m_colorFilter * source->toOther(*destination, intent),
+    });
+}
+
+void ItemRendererOpenGL::setColorFilter(const QMatrix4x4 &filter)
+{
+    if (m_colorFilter != filter) {
+        m_colorFilter = filter;
+        // the cached transformations include the previous filter
+        m_colorTransformations.clear();
+    }
+}
+
 QVector4D ItemRendererOpenGL::modulate(float opacity, float brightness) const
 {
     const float a = opacity;
@@ -111,45 +169,156 @@ void ItemRendererOpenGL::setBlendEnabled(bool enabled)
     m_blendingEnabled = enabled;
 }
 
-static RenderGeometry clipQuads(const Item *item, const ItemRendererOpenGL::RenderContext *context)
+static RenderGeometry unclippedQuads(const WindowQuadList &quads, qreal scale)
 {
-    const WindowQuadList quads = item->quads();
+    RenderGeometry geometry;
+    geometry.reserve(quads.count() * 6);
+    for (const WindowQuad &quad : std::as_const(quads)) {
+        geometry.appendWindowQuad(quad, scale);
+    }
+    return geometry;
+}
 
-    const qreal scale = context->renderTargetScale;
-    const QPointF itemToDeviceTranslation = context->transformStack.top().map(QPointF(0., 0.))
+static QPointF deviceTranslation(const ItemRendererOpenGL::RenderContext *context)
+{
+    return context->transformStack.back().map(QPointF(0., 0.))
         - context->viewportOrigin
         + context->renderOffset;
+}
+
+/**
+ * Returns @c false if none of the quads of the @a item stick out of the device clip, so the
+ * geometry of the item doesn't depend on the region that is being repainted.
+ */
+static bool needsClipping(const Item *item, const ItemRendererOpenGL::RenderContext *context)
+{
+    if (context->deviceClip == Region::infinite() || context->hardwareClipping) {
+        return false;
+    }
+
+    const WindowQuadList quads = item->quads();
+    if (quads.isEmpty()) {
+        return false;
+    }
+
+    RectF bounds;
+    for (const WindowQuad &quad : quads) {
+        bounds |= quad.bounds();
+    }
+    const RectF deviceBounds = RectF(bounds.scaled(context->renderTargetScale).roundedOut())
+                                   .translated(deviceTranslation(context));
+    return !context->deviceClip.contains(deviceBounds.toAlignedRect());
+}
+
+static RenderGeometry clipQuads(const WindowQuadList &quads, const ItemRendererOpenGL::RenderContext *context)
+{
+    const qreal scale = context->renderTargetScale;
+    if (context->deviceClip == Region::infinite() || context->hardwareClipping) {
+        return unclippedQuads(quads, scale);
+    }
+
+    const QPointF itemToDeviceTranslation = deviceTranslation(context);
 
     RenderGeometry geometry;
     geometry.reserve(quads.count() * 6);
 
     // split all quads in bounding rect with the actual rects in the region
+    const QSpan<const Rect> clipRects = context->deviceClip.rects();
     for (const WindowQuad &quad : std::as_const(quads)) {
-        if (context->deviceClip != Region::infinite() && !context->hardwareClipping) {
-            // Scale to device coordinates, rounding as needed.
-            const RectF deviceBounds = quad.bounds().scaled(scale).rounded();
-
-            for (const Rect &deviceClipRect : context->deviceClip.rects()) {
-                const RectF relativeDeviceClipRect = RectF(deviceClipRect).translated(-itemToDeviceTranslation);
-                const RectF intersected = relativeDeviceClipRect.intersected(deviceBounds);
-                if (intersected.isValid()) {
-                    if (deviceBounds == intersected) {
-                        // case 1: completely contains, include and do not check other rects
-                        geometry.appendWindowQuad(quad, scale);
-                        break;
-                    }
-                    // case 2: intersection
-                    geometry.appendSubQuad(quad, intersected, scale);
+        // Scale to device coordinates, rounding as needed.
+        const RectF deviceBounds = quad.bounds().scaled(scale).rounded();
+        const RectF absoluteBounds = deviceBounds.translated(itemToDeviceTranslation);
+
+        // the rects are sorted in bands from top to bottom, so only the bands
+        // that overlap the quad vertically have to be looked at
+        auto it = std::ranges::partition_point(clipRects, [&absoluteBounds](const Rect &rect) {
+            return rect.bottom() <= absoluteBounds.top();
+        });
+        for (; it != clipRects.end() && it->top() < absoluteBounds.bottom(); ++it) {
+            if (it->right() <= absoluteBounds.left() || it->left() >= absoluteBounds.right()) {
+                continue;
+            }
+            const RectF relativeDeviceClipRect = RectF(*it).translated(-itemToDeviceTranslation);
+            const RectF intersected = relativeDeviceClipRect.intersected(deviceBounds);
+            if (intersected.isValid()) {
+                if (deviceBounds == intersected) {
+                    // case 1: completely contains, include and do not check other rects
+                    geometry.appendWindowQuad(quad, scale);
+                    break;
                 }
+                // case 2: intersection
+                geometry.appendSubQuad(quad, intersected, scale);
             }
-        } else {
-            geometry.appendWindowQuad(quad, scale);
         }
     }
 
     return geometry;
 }
 
+static WindowQuadList intersectQuads(const WindowQuadList &quads, const RegionF &region)
+{
+    WindowQuadList ret;
+    for (const WindowQuad &quad : quads) {
+        for (const RectF &rect : region.rects()) {
+            const double left = std::max(quad.left(), rect.left());
+            const double top = std::max(quad.top(), rect.top());
+            const double right = std::min(quad.right(), rect.right());
+            const double bottom = std::min(quad.bottom(), rect.bottom());
+            if (left < right && top < bottom) {
+                ret.append(quad.makeSubQuad(left, top, right, bottom));
+            }
+        }
+    }
+    return ret;
+}
+
+/**
+ * Splits the @a quads into the parts that are in the interior of the rounded box and the parts
+ * that are in its corners. Only the latter have to be drawn with the rounded corners shader,
+ * and the parts outside the box are dropped, since the shader wouldn't paint them anyway.
+ */
+static std::pair<WindowQuadList, WindowQuadList> splitRoundedCorners(const WindowQuadList &quads, const ItemRendererOpenGL::RenderCorner &corner, qreal scale)
+{
+    // the box is in device coordinates, the quads are in logical ones
+    const RectF box = corner.box;
+    const qreal topLeft = std::ceil(corner.radius.topLeft());
+    const qreal topRight = std::ceil(corner.radius.topRight());
+    const qreal bottomRight = std::ceil(corner.radius.bottomRight());
+    const qreal bottomLeft = std::ceil(corner.radius.bottomLeft());
+
+    const RectF cornerRects[] = {
+        RectF(box.left(), box.top(), topLeft, topLeft),
+        RectF(box.right() - topRight, box.top(), topRight, topRight),
+        RectF(box.right() - bottomRight, box.bottom() - bottomRight, bottomRight, bottomRight),
+        RectF(box.left(), box.bottom() - bottomLeft, bottomLeft, bottomLeft),
+    };
+
+    RegionF corners;
+    for (const RectF &cornerRect : cornerRects) {
+        const RectF clipped = cornerRect.intersected(box);
+        if (!clipped.isEmpty()) {
+            corners = corners.united(clipped.scaled(1 / scale));
+        }
+    }
+    const RegionF interior = RegionF(box.scaled(1 / scale)).subtracted(corners);
+
+    return {intersectQuads(quads, interior), intersectQuads(quads, corners)};
+}
+
+static bool canCullItem(const Item *item, const ItemRendererOpenGL::RenderContext *context)
+{
+    if (qFuzzyIsNull(context->opacityStack.back())) {
+        return true;
+    }
+    // with hardware clipping, the item can be transformed in ways that the clip can't be checked against
+    if (context->deviceClip == Region::infinite() || context->hardwareClipping) {
+        return false;
+    }
+    const RectF deviceBounds = RectF(context->transformStack.back().mapRect(item->boundingRect().scaled(context->renderTargetScale)))
+                                   .translated(context->renderOffset - context->viewportOrigin);
+    return !context->deviceClip.intersects(deviceBounds.toAlignedRect());
+}
+
 bool ItemRendererOpenGL::createRenderNode(Item *item, RenderContext *context, const std::function<bool(Item *)> &filter, const std::function<bool(Item *)> &holeFilter)
 {
     bool hole = false;
@@ -174,9 +343,18 @@ bool ItemRendererOpenGL::createRenderNode(Item *item, RenderContext *context, co
         matrix *= item->transform();
         matrix.scale(1 / scale, 1 / scale);
     }
-    context->transformStack.push(context->transformStack.top() * matrix);
+    context->transformStack.push_back(context->transformStack.back() * matrix);
 
-    context->opacityStack.push(context->opacityStack.top() * item->opacity());
+    context->opacityStack.push_back(context->opacityStack.back() * item->opacity());
+
+    // Clients like web browsers and video players can have lots of subsurfaces, many of
+    // which are usually occluded or invisible. Skip them and their children entirely, so
+    // they don't get preprocessed and don't cost anything beyond this check
+    if (canCullItem(item, context)) {
+        context->transformStack.pop_back();
+        context->opacityStack.pop_back();
+        return true;
+    }
 
     for (Item *childItem : sortedChildItems) {
         if (childItem->z() >= 0) {
@@ -192,13 +370,13 @@ bool ItemRendererOpenGL::createRenderNode(Item *item, RenderContext *context, co
     if (const BorderRadius radius = item->borderRadius(); !radius.isNull()) {
         const RectF nativeRect = item->rect().scaled(context->renderTargetScale).rounded();
         const BorderRadius nativeRadius = radius.scaled(context->renderTargetScale).rounded();
-        context->cornerStack.push({
+        context->cornerStack.push_back({
             .box = nativeRect,
             .radius = nativeRadius,
         });
-    } else if (!context->cornerStack.isEmpty()) {
-        const auto &top = std::as_const(context->cornerStack).top();
-        context->cornerStack.push({
+    } else if (!context->cornerStack.empty()) {
+        const auto &top = context->cornerStack.back();
+        context->cornerStack.push_back({
             .box = matrix.inverted().mapRect(top.box),
             .radius = top.radius,
         });
@@ -211,57 +389,66 @@ bool ItemRendererOpenGL::createRenderNode(Item *item, RenderContext *context, co
         return false;
     }
 
-    RenderGeometry geometry = clipQuads(item, context);
+    // geometry that doesn't have to be clipped is built in setGeometry(), if it's not retained
+    const bool clipped = needsClipping(item, context);
+    const RenderGeometry geometry = clipped ? clipQuads(item->quads(), context) : RenderGeometry();
+    const bool hasGeometry = clipped ? !geometry.isEmpty() : !item->quads().isEmpty();
 
     if (auto shadowItem = qobject_cast<ShadowItem *>(item)) {
-        if (!geometry.isEmpty()) {
+        if (hasGeometry) {
             const auto ninePatch = static_cast<NinePatchOpenGL *>(shadowItem->ninePatch());
             if (ninePatch->texture()) {
                 RenderNode &renderNode = context->renderNodes.emplace_back(RenderNode{
                     .traits = ShaderTrait::MapTexture,
                     .textures = {ninePatch->texture()},
                     .geometry = geometry,
-                    .transformMatrix = context->transformStack.top(),
-                    .opacity = context->opacityStack.top(),
+                    .transformMatrix = context->transformStack.back(),
+                    .opacity = context->opacityStack.back(),
                     .hasAlpha = true,
                     .colorDescription = item->colorDescription(),
                     .renderingIntent = item->renderingIntent(),
                     .bufferReleasePoint = nullptr,
                     .paintHole = hole,
                 });
-                renderNode.geometry.postProcessTextureCoordinates(ninePatch->texture()->matrix(UnnormalizedCoordinates));
+                setGeometry(renderNode, item, context, clipped, ninePatch->texture()->matrix(UnnormalizedCoordinates));
             }
         }
     } else if (auto decorationItem = qobject_cast<DecorationItem *>(item)) {
-        if (!geometry.isEmpty()) {
+        if (hasGeometry) {
             auto atlas = static_cast<const AtlasOpenGL *>(decorationItem->atlas());
             if (atlas && atlas->texture()) {
                 RenderNode &renderNode = context->renderNodes.emplace_back(RenderNode{
                     .traits = ShaderTrait::MapTexture,
                     .textures = {atlas->texture()},
                     .geometry = geometry,
-                    .transformMatrix = context->transformStack.top(),
-                    .opacity = context->opacityStack.top(),
+                    .transformMatrix = context->transformStack.back(),
+                    .opacity = context->opacityStack.back(),
                     .hasAlpha = true,
                     .colorDescription = item->colorDescription(),
                     .renderingIntent = item->renderingIntent(),
                     .bufferReleasePoint = nullptr,
                     .paintHole = hole,
                 });
-                renderNode.geometry.postProcessTextureCoordinates(atlas->texture()->matrix(UnnormalizedCoordinates));
+                setGeometry(renderNode, item, context, clipped, atlas->texture()->matrix(UnnormalizedCoordinates));
             }
         }
     } else if (auto surfaceItem = qobject_cast<SurfaceItem *>(item)) {
         auto texture = static_cast<TextureOpenGL *>(surfaceItem->texture());
         if (texture && !texture->planes().isEmpty()) {
-            if (!geometry.isEmpty()) {
+            if (const FileDescriptor &acquireFence = surfaceItem->bufferAcquireFence(); acquireFence.isValid() && m_eglDisplay) {
+                // the client might still be rendering, all following commands have to wait for it
+                EGLNativeFence::importFence(m_eglDisplay, acquireFence.duplicate()).waitSync();
+            }
+            if (hasGeometry) {
                 RenderNode &renderNode = context->renderNodes.emplace_back(RenderNode{
                     .traits = texture->planes().count() == 1 ? ShaderTrait::MapTexture : ShaderTrait::MapMultiPlaneTexture,
                     .textures = texture->planes(),
                     .geometry = geometry,
-                    .transformMatrix = context->transformStack.top(),
-                    .opacity = context->opacityStack.top(),
-                    .hasAlpha = surfaceItem->hasAlphaChannel(),
+                    .transformMatrix = context->transformStack.back(),
+                    .opacity = context->opacityStack.back(),
+                    // Many clients use buffers with an alpha channel but mark the surface as opaque,
+                    // blending can be skipped for them, which saves a lot of memory bandwidth.
+                    .hasAlpha = surfaceItem->hasAlphaChannel() && !surfaceItem->opaque().contains(surfaceItem->rect()),
                     .colorDescription = item->colorDescription(),
                     .renderingIntent = item->renderingIntent(),
                     .bufferReleasePoint = texture->releasePoint(),
@@ -269,54 +456,73 @@ bool ItemRendererOpenGL::createRenderNode(Item *item, RenderContext *context, co
                     .hasFloatingPointColor = texture->isFloatingPoint(),
                     .layerDebugBox = m_debug.layerEnabled ? std::optional(item->rect()) : std::nullopt,
                 });
-                renderNode.geometry.postProcessTextureCoordinates(texture->planes().at(0)->matrix(UnnormalizedCoordinates));
                 if (surfaceItem->colorDescription()->yuvCoefficients() != YUVMatrixCoefficients::Identity) {
                     renderNode.traits |= ShaderTrait::YuvConversion;
                 }
 
-                if (!context->cornerStack.isEmpty()) {
-                    const auto &top = context->cornerStack.top();
-
-                    renderNode.traits |= ShaderTrait::RoundedCorners;
-                    renderNode.hasAlpha = true;
-                    renderNode.box = QVector4D(top.box.x() + top.box.width() * 0.5,
+                if (context->cornerStack.empty()) {
+                    setGeometry(renderNode, item, context, clipped, texture->matrix(UnnormalizedCoordinates));
+                } else {
+                    // Only the corners need the rounded corners shader and blending, the interior
+                    // of a large window would otherwise evaluate the shader for every pixel
+                    const auto &top = context->cornerStack.back();
+                    const auto [interiorQuads, cornerQuads] = splitRoundedCorners(item->quads(), top, context->renderTargetScale);
+
+                    RenderNode cornerNode = renderNode;
+                    cornerNode.geometry = clipQuads(cornerQuads, context);
+                    cornerNode.geometry.postProcessTextureCoordinates(texture->matrix(UnnormalizedCoordinates));
+                    cornerNode.traits |= ShaderTrait::RoundedCorners;
+                    cornerNode.hasAlpha = true;
+                    cornerNode.box = QVector4D(top.box.x() + top.box.width() * 0.5,
                                                top.box.y() + top.box.height() * 0.5,
                                                top.box.width() * 0.5,
-                                               top.box.height() * 0.5),
-                    renderNode.borderRadius = top.radius.toVector();
+                                               top.box.height() * 0.5);
+                    cornerNode.borderRadius = top.radius.toVector();
+                    cornerNode.layerDebugBox = std::nullopt;
+
+                    renderNode.geometry = clipQuads(interiorQuads, context);
+                    renderNode.geometry.postProcessTextureCoordinates(texture->matrix(UnnormalizedCoordinates));
+
+                    if (renderNode.geometry.isEmpty()) {
+                        cornerNode.layerDebugBox = renderNode.layerDebugBox;
+                        context->renderNodes.pop_back();
+                    }
+                    if (!cornerNode.geometry.isEmpty()) {
+                        context->renderNodes.push_back(std::move(cornerNode));
+                    }
                 }
             }
         }
     } else if (auto imageItem = qobject_cast<ImageItem *>(item)) {
-        if (!geometry.isEmpty()) {
+        if (hasGeometry) {
             auto texture = static_cast<TextureOpenGL *>(imageItem->texture());
             if (texture && !texture->planes().isEmpty()) {
                 RenderNode &renderNode = context->renderNodes.emplace_back(RenderNode{
                     .traits = ShaderTrait::MapTexture,
                     .textures = texture->planes(),
                     .geometry = geometry,
-                    .transformMatrix = context->transformStack.top(),
-                    .opacity = context->opacityStack.top(),
+                    .transformMatrix = context->transformStack.back(),
+                    .opacity = context->opacityStack.back(),
                     .hasAlpha = imageItem->image().hasAlphaChannel(),
                     .colorDescription = item->colorDescription(),
                     .renderingIntent = item->renderingIntent(),
                     .bufferReleasePoint = texture->releasePoint(),
                     .paintHole = hole,
                 });
-                renderNode.geometry.postProcessTextureCoordinates(texture->planes()[0]->matrix(UnnormalizedCoordinates));
+                setGeometry(renderNode, item, context, clipped, texture->matrix(UnnormalizedCoordinates));
             }
         }
     } else if (auto borderItem = qobject_cast<OutlinedBorderItem *>(item)) {
-        if (!geometry.isEmpty()) {
+        if (hasGeometry) {
             const BorderOutline outline = borderItem->outline();
             const int thickness = std::round(outline.thickness() * context->renderTargetScale);
             const RectF outerRect = borderItem->rect().scaled(context->renderTargetScale).rounded();
             const RectF innerRect = outerRect.adjusted(thickness, thickness, -thickness, -thickness);
-            context->renderNodes.append(RenderNode{
+            RenderNode &renderNode = context->renderNodes.emplace_back(RenderNode{
                 .traits = ShaderTrait::Border,
                 .geometry = geometry,
-                .transformMatrix = context->transformStack.top(),
-                .opacity = context->opacityStack.top(),
+                .transformMatrix = context->transformStack.back(),
+                .opacity = context->opacityStack.back(),
                 .hasAlpha = true,
                 .colorDescription = borderItem->colorDescription(),
                 .renderingIntent = borderItem->renderingIntent(),
@@ -329,6 +535,7 @@ bool ItemRendererOpenGL::createRenderNode(Item *item, RenderContext *context, co
                 .borderColor = outline.color(),
                 .paintHole = hole,
             });
+            setGeometry(renderNode, item, context, clipped, std::nullopt);
         }
     }
 
@@ -343,16 +550,136 @@ bool ItemRendererOpenGL::createRenderNode(Item *item, RenderContext *context, co
         }
     }
 
-    context->transformStack.pop();
-    context->opacityStack.pop();
-    if (!context->cornerStack.isEmpty()) {
-        context->cornerStack.pop();
+    context->transformStack.pop_back();
+    context->opacityStack.pop_back();
+    if (!context->cornerStack.empty()) {
+        context->cornerStack.pop_back();
     }
     return true;
 }
 
+// retained geometry that hasn't been drawn for this many frames belongs to
+// an item that is hidden or gone
+static constexpr quint64 s_maxRetainedGeometryAge = 600;
+
+void ItemRendererOpenGL::setGeometry(RenderNode &renderNode, const Item *item, const RenderContext *context, bool clipped, const std::optional<QMatrix4x4> &textureMatrix)
+{
+    if (clipped) {
+        if (textureMatrix) {
+            renderNode.geometry.postProcessTextureCoordinates(*textureMatrix);
+        }
+        return;
+    }
+
+    RetainedGeometry &retained = m_retainedGeometry[std::make_pair(item, context->renderTargetScale)];
+    retained.lastUsedFrame = m_frameCounter;
+    if (retained.quadsSerial == item->quadsSerial() && retained.textureMatrix == textureMatrix && retained.firstVertex != -1) {
+        renderNode.retained = true;
+        renderNode.firstVertex = retained.firstVertex;
+        renderNode.vertexCount = retained.vertexCount;
+        return;
+    }
+
+    renderNode.geometry = unclippedQuads(item->quads(), context->renderTargetScale);
+    if (textureMatrix) {
+        renderNode.geometry.postProcessTextureCoordinates(*textureMatrix);
+    }
+
+    if (retained.quadsSerial != item->quadsSerial() || retained.textureMatrix != textureMatrix) {
+        // the geometry has just changed, it's likely to change again in the next frame
+        if (retained.firstVertex != -1) {
+            m_unusedRetainedVertices += retained.vertexCount;
+        }
+        retained.quadsSerial = item->quadsSerial();
+        retained.textureMatrix = textureMatrix;
+        retained.firstVertex = -1;
+        retained.vertexCount = 0;
+        return;
+    }
+
+    retained.firstVertex = m_retainedVertices.size();
+    retained.vertexCount = renderNode.geometry.count();
+    m_retainedVertices.append(renderNode.geometry);
+    m_retainedVerticesDirty = true;
+
+    renderNode.retained = true;
+    renderNode.firstVertex = retained.firstVertex;
+    renderNode.vertexCount = retained.vertexCount;
+    renderNode.geometry.clear();
+}
+
+void ItemRendererOpenGL::uploadRetainedGeometry()
+{
+    if (!m_retainedVerticesDirty) {
+        return;
+    }
+    if (!m_retainedVertexBuffer) {
+        m_retainedVertexBuffer = std::make_unique<GLVertexBuffer>(GLVertexBuffer::Static);
+    }
+    m_retainedVertexBuffer->setVertices(m_retainedVertices);
+    m_retainedVerticesDirty = false;
+}
+
+void ItemRendererOpenGL::collectRetainedGeometry()
+{
+    ++m_frameCounter;
+    if (m_frameCounter % 64 != 0) {
+        return;
+    }
+
+    for (auto it = m_retainedGeometry.begin(); it != m_retainedGeometry.end();) {
+        if (m_frameCounter - it->second.lastUsedFrame > s_maxRetainedGeometryAge) {
+            if (it->second.firstVertex != -1) {
+                m_unusedRetainedVertices += it->second.vertexCount;
+            }
+            it = m_retainedGeometry.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    // the buffer is only compacted when most of it is garbage, so that resizing
+    // windows don't cause all retained geometry to be uploaded over and over again
+    if (m_unusedRetainedVertices < 4096 || m_unusedRetainedVertices * 2 < m_retainedVertices.size()) {
+        return;
+    }
+
+    QList<GLVertex2D> vertices;
+    vertices.reserve(m_retainedVertices.size() - m_unusedRetainedVertices);
+    for (auto &[key, retained] : m_retainedGeometry) {
+        if (retained.firstVertex != -1) {
+            const int firstVertex = vertices.size();
+            vertices.append(m_retainedVertices.mid(retained.firstVertex, retained.vertexCount));
+            retained.firstVertex = firstVertex;
+        }
+    }
+    m_retainedVertices = std::move(vertices);
+    m_unusedRetainedVertices = 0;
+    m_retainedVerticesDirty = true;
+}
+
+GLVertexBuffer *ItemRendererOpenGL::vertexBuffer(const RenderNode &renderNode) const
+{
+    return renderNode.retained ? m_retainedVertexBuffer.get() : GLVertexBuffer::streamingBuffer();
+}
+
+/**
+ * Makes @a buffer the vertex buffer that the following draw calls use.
+ */
+static void bindVertexBuffer(GLVertexBuffer *buffer, GLVertexBuffer *&boundBuffer)
+{
+    if (buffer != boundBuffer) {
+        if (boundBuffer) {
+            boundBuffer->unbindArrays();
+        }
+        buffer->bindArrays();
+        boundBuffer = buffer;
+    }
+}
+
 void ItemRendererOpenGL::renderBackground(const RenderTarget &renderTarget, const RenderViewport &viewport, const Region &deviceRegion)
 {
+    GLGpuProfilerScope profilerScope(QStringLiteral("Background"));
     const auto clipped = deviceRegion & renderTarget.transformedRect();
     if (clipped == renderTarget.transformedRect()) {
         glClearColor(0, 0, 0, 0);
@@ -372,6 +699,56 @@ void ItemRendererOpenGL::renderBackground(const RenderTarget &renderTarget, cons
     }
 }
 
+/**
+ * Returns @c true if @a next can be drawn in the same draw call as @a previous, i.e. the
+ * shader, its uniforms, the textures and the blending state are the same for both nodes.
+ */
+static bool canBatch(const ItemRendererOpenGL::RenderNode &previous, const ItemRendererOpenGL::RenderNode &next)
+{
+    return previous.retained == next.retained
+        && previous.firstVertex + previous.vertexCount == next.firstVertex
+        && previous.traits == next.traits
+        && previous.textures == next.textures
+        && previous.transformMatrix == next.transformMatrix
+        && previous.opacity == next.opacity
+        && previous.hasAlpha == next.hasAlpha
+        && previous.colorDescription == next.colorDescription
+        && previous.renderingIntent == next.renderingIntent
+        && previous.bufferReleasePoint == next.bufferReleasePoint
+        && previous.box == next.box
+        && previous.borderRadius == next.borderRadius
+        && previous.borderThickness == next.borderThickness
+        && previous.borderColor == next.borderColor
+        && previous.paintHole == next.paintHole
+        && previous.hasFloatingPointColor == next.hasFloatingPointColor
+        && !previous.layerDebugBox.has_value()
+        && !next.layerDebugBox.has_value();
+}
+
+/**
+ * Merges adjacent render nodes that can be drawn with a single draw call. The nodes are not
+ * reordered, so the result is the same as if every node had been drawn separately.
+ */
+static void batchRenderNodes(std::pmr::vector<ItemRendererOpenGL::RenderNode> &renderNodes)
+{
+    if (renderNodes.empty()) {
+        return;
+    }
+
+    size_t last = 0;
+    for (size_t i = 1; i < renderNodes.size(); ++i) {
+        if (canBatch(renderNodes[last], renderNodes[i])) {
+            renderNodes[last].vertexCount += renderNodes[i].vertexCount;
+        } else {
+            ++last;
+            if (last != i) {
+                renderNodes[last] = std::move(renderNodes[i]);
+            }
+        }
+    }
+    renderNodes.erase(renderNodes.begin() + last + 1, renderNodes.end());
+}
+
 bool ItemRendererOpenGL::renderItem(const RenderTarget &renderTarget, const RenderViewport &viewport, Item *item, int mask, const Region &deviceRegion, const WindowPaintData &data, const std::function<bool(Item *)> &filter, const std::function<bool(Item *)> &holeFilter)
 {
     if (deviceRegion.isEmpty()) {
@@ -379,6 +756,10 @@ bool ItemRendererOpenGL::renderItem(const RenderTarget &renderTarget, const Rend
     }
 
     RenderContext renderContext{
+        .renderNodes = std::pmr::vector<RenderNode>(frameArena()->resource()),
+        .transformStack = std::pmr::vector<QMatrix4x4>(frameArena()->resource()),
+        .opacityStack = std::pmr::vector<qreal>(frameArena()->resource()),
+        .cornerStack = std::pmr::vector<RenderCorner>(frameArena()->resource()),
         .projectionMatrix = viewport.projectionMatrix(),
         .rootTransform = data.toMatrix(viewport.scale()), // TODO: unify transforms
         .deviceClip = (deviceRegion & renderTarget.transformedRect()),
@@ -388,41 +769,54 @@ bool ItemRendererOpenGL::renderItem(const RenderTarget &renderTarget, const Rend
         .renderOffset = viewport.renderOffset(),
     };
 
-    renderContext.transformStack.push(QMatrix4x4());
-    renderContext.opacityStack.push(data.opacity());
+    renderContext.transformStack.push_back(QMatrix4x4());
+    renderContext.opacityStack.push_back(data.opacity());
 
-    if (!createRenderNode(item, &renderContext, filter, holeFilter)) {
-        return false;
+    {
+        fTraceDuration("Create render nodes");
+        if (!createRenderNode(item, &renderContext, filter, holeFilter)) {
+            return false;
+        }
+    }
+
+    if (renderContext.renderNodes.empty()) {
+        return true;
     }
 
+    // must be done before the streaming buffer is mapped, which expects the array buffer binding not to change
+    uploadRetainedGeometry();
+
     int totalVertexCount = 0;
     for (const RenderNode &node : std::as_const(renderContext.renderNodes)) {
         totalVertexCount += node.geometry.count();
     }
-    if (totalVertexCount == 0) {
-        return true;
-    }
 
     GLVertexBuffer *vbo = GLVertexBuffer::streamingBuffer();
-    vbo->reset();
-    vbo->setAttribLayout(std::span(GLVertexBuffer::GLVertex2DLayout), sizeof(GLVertex2D));
+    if (totalVertexCount > 0) {
+        vbo->reset();
+        vbo->setAttribLayout(std::span(GLVertexBuffer::GLVertex2DLayout), sizeof(GLVertex2D));
 
-    const auto map = vbo->map<GLVertex2D>(totalVertexCount);
-    if (!map) {
-        EglContext::currentContext()->isFailed();
-        return true;
-    }
+        const auto map = vbo->map<GLVertex2D>(totalVertexCount);
+        if (!map) {
+            EglContext::currentContext()->isFailed();
+            return true;
+        }
+
+        int v = 0;
+        for (RenderNode &renderNode : renderContext.renderNodes) {
+            if (renderNode.retained) {
+                continue;
+            }
+            renderNode.firstVertex = v;
+            renderNode.vertexCount = renderNode.geometry.count();
+            renderNode.geometry.copy(map->subspan(v));
+            v += renderNode.geometry.count();
+        }
 
-    for (int i = 0, v = 0; i < renderContext.renderNodes.count(); i++) {
-        RenderNode &renderNode = renderContext.renderNodes[i];
-        renderNode.firstVertex = v;
-        renderNode.vertexCount = renderNode.geometry.count();
-        renderNode.geometry.copy(map->subspan(v));
-        v += renderNode.geometry.count();
+        vbo->unmap();
     }
 
-    vbo->unmap();
-    vbo->bindArrays();
+    batchRenderNodes(renderContext.renderNodes);
 
     if (renderContext.hardwareClipping) {
         glEnable(GL_SCISSOR_TEST);
@@ -440,8 +834,11 @@ bool ItemRendererOpenGL::renderItem(const RenderTarget &renderTarget, const Rend
 
     ShaderTraits lastTraits;
     GLShader *shader = nullptr;
-    for (int i = 0; i < renderContext.renderNodes.count(); i++) {
+    const ColorTransformation *lastColorTransformation = nullptr;
+    GLVertexBuffer *boundBuffer = nullptr;
+    for (size_t i = 0; i < renderContext.renderNodes.size(); i++) {
         const RenderNode &renderNode = renderContext.renderNodes[i];
+        const ColorTransformation &colorTransformation = cachedColorTransformation(renderNode.colorDescription, renderTarget.colorDescription(), renderNode.renderingIntent, renderNode.hasFloatingPointColor);
 
         ShaderTraits traits = renderNode.traits;
         if (renderNode.opacity != 1.0 || data.brightness() != 1.0) {
@@ -453,12 +850,8 @@ bool ItemRendererOpenGL::renderItem(const RenderTarget &renderTarget, const Rend
         if (data.brightness() != 1.0 || data.saturation() != 1.0) {
             // make sure that brightness and saturation adjustments are always applied in linear space
             traits |= ShaderTrait::TransformColorspace;
-        } else {
-            const auto colorTransformation = ColorPipeline::create(renderNode.colorDescription, renderTarget.colorDescription(), renderNode.renderingIntent,
-                                                                   renderNode.hasFloatingPointColor ? ColorPipeline::InputType::FloatingPoint : ColorPipeline::InputType::FixedPoint);
-            if (!colorTransformation.isIdentity()) {
-                traits |= ShaderTrait::TransformColorspace;
-            }
+        } else if (!colorTransformation.isIdentity) {
+            traits |= ShaderTrait::TransformColorspace;
         }
 
         if (renderNode.paintHole) {
@@ -476,6 +869,7 @@ bool ItemRendererOpenGL::renderItem(const RenderTarget &renderTarget, const Rend
                 ShaderManager::instance()->popShader();
             }
             shader = ShaderManager::instance()->pushShader(traits);
+            lastColorTransformation = nullptr;
             if (traits & ShaderTrait::AdjustSaturation) {
                 const auto toXYZ = renderTarget.colorDescription()->containerColorimetry().toXYZ();
                 shader->setUniform(GLShader::FloatUniform::Saturation, data.saturation());
@@ -493,8 +887,10 @@ bool ItemRendererOpenGL::renderItem(const RenderTarget &renderTarget, const Rend
         if (traits & ShaderTrait::Modulate) {
             shader->setUniform(GLShader::Vec4Uniform::ModulationConstant, modulate(renderNode.opacity, data.brightness()));
         }
-        if (traits & ShaderTrait::TransformColorspace) {
-            shader->setColorspaceUniforms(renderNode.colorDescription, renderTarget.colorDescription(), renderNode.renderingIntent);
+        if ((traits & ShaderTrait::TransformColorspace) && lastColorTransformation != &colorTransformation) {
+            // the uniforms only need to be uploaded again if the shader or the color descriptions change
+            lastColorTransformation = &colorTransformation;
+            shader->setColorspaceUniforms(colorTransformation.source, colorTransformation.destination, colorTransformation.intent, colorTransformation.colorimetryTransformation);
         }
         if (traits & ShaderTrait::YuvConversion) {
             shader->setUniform(GLShader::Mat4Uniform::YuvToRgb, renderNode.colorDescription->yuvMatrix());
@@ -518,8 +914,9 @@ bool ItemRendererOpenGL::renderItem(const RenderTarget &renderTarget, const Rend
             renderNode.textures[i]->bind();
         }
 
-        vbo->draw(scissorRegion, GL_TRIANGLES, renderNode.firstVertex,
-                  renderNode.vertexCount, renderContext.hardwareClipping);
+        bindVertexBuffer(vertexBuffer(renderNode), boundBuffer);
+        boundBuffer->draw(scissorRegion, GL_TRIANGLES, renderNode.firstVertex,
+                          renderNode.vertexCount, renderContext.hardwareClipping);
 
         for (int i = 0; i < renderNode.textures.count() && !renderNode.paintHole; ++i) {
             glActiveTexture(GL_TEXTURE0 + i);
@@ -549,8 +946,8 @@ bool ItemRendererOpenGL::renderItem(const RenderTarget &renderTarget, const Rend
             } else {
                 shader->setUniform(GLShader::ColorUniform::Color, QColor(255, 0, 0, 50));
             }
-            vbo->draw(scissorRegion, GL_TRIANGLES, renderNode.firstVertex,
-                      renderNode.vertexCount, renderContext.hardwareClipping);
+            boundBuffer->draw(scissorRegion, GL_TRIANGLES, renderNode.firstVertex,
+                              renderNode.vertexCount, renderContext.hardwareClipping);
         }
     }
     if (shader) {
@@ -559,12 +956,14 @@ bool ItemRendererOpenGL::renderItem(const RenderTarget &renderTarget, const Rend
         ShaderManager::instance()->popShader();
     }
 
+    if (boundBuffer) {
+        boundBuffer->unbindArrays();
+    }
+
     if (m_debug.fractionalEnabled) {
         visualizeFractional(viewport, scissorRegion, renderContext);
     }
 
-    vbo->unbindArrays();
-
     setBlendEnabled(false);
 
     if (renderContext.hardwareClipping) {
@@ -592,9 +991,8 @@ void ItemRendererOpenGL::visualizeFractional(const RenderViewport &viewport, con
     auto screenSize = viewport.renderRect().size() * viewport.scale();
     m_debug.fractionalShader->setUniform("screenSize", QVector2D(float(screenSize.width()), float(screenSize.height())));
 
-    GLVertexBuffer *vbo = GLVertexBuffer::streamingBuffer();
-
-    for (int i = 0; i < renderContext.renderNodes.count(); i++) {
+    GLVertexBuffer *boundBuffer = nullptr;
+    for (size_t i = 0; i < renderContext.renderNodes.size(); i++) {
         const RenderNode &renderNode = renderContext.renderNodes[i];
 
         setBlendEnabled(true);
@@ -607,8 +1005,12 @@ void ItemRendererOpenGL::visualizeFractional(const RenderViewport &viewport, con
         m_debug.fractionalShader->setUniform("geometrySize", size);
         m_debug.fractionalShader->setUniform(GLShader::Mat4Uniform::ModelViewProjectionMatrix, renderContext.projectionMatrix * renderNode.transformMatrix);
 
-        vbo->draw(logicalRegion, GL_TRIANGLES, renderNode.firstVertex,
-                  renderNode.vertexCount, renderContext.hardwareClipping);
+        bindVertexBuffer(vertexBuffer(renderNode), boundBuffer);
+        boundBuffer->draw(logicalRegion, GL_TRIANGLES, renderNode.firstVertex,
+                          renderNode.vertexCount, renderContext.hardwareClipping);
+    }
+    if (boundBuffer) {
+        boundBuffer->unbindArrays();
     }
 }
 
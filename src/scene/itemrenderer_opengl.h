@@ -10,12 +10,16 @@
 #include "scene/itemrenderer.h"
 #include "scene/surfaceitem.h"
 
+#include <deque>
+#include <map>
+#include <memory_resource>
 #include <unordered_set>
 
 namespace KWin
 {
 
 class EglDisplay;
+class ImageAtlasOpenGL;
 
 class KWIN_EXPORT ItemRendererOpenGL : public ItemRenderer
 {
@@ -28,6 +32,10 @@ public:
         QMatrix4x4 transformMatrix;
         int firstVertex = 0;
         int vertexCount = 0;
+        /**
+         * Whether the vertices are in the retained vertex buffer rather than in the geometry
+         */
+        bool retained = false;
         qreal opacity = 1;
         bool hasAlpha = false;
         std::shared_ptr<ColorDescription> colorDescription;
@@ -50,10 +58,10 @@ public:
 
     struct RenderContext
     {
-        QList<RenderNode> renderNodes;
-        QStack<QMatrix4x4> transformStack;
-        QStack<qreal> opacityStack;
-        QStack<RenderCorner> cornerStack;
+        std::pmr::vector<RenderNode> renderNodes;
+        std::pmr::vector<QMatrix4x4> transformStack;
+        std::pmr::vector<qreal> opacityStack;
+        std::pmr::vector<RenderCorner> cornerStack;
         const QMatrix4x4 projectionMatrix;
         const QMatrix4x4 rootTransform;
         const Region deviceClip;
@@ -64,6 +72,7 @@ public:
     };
 
     ItemRendererOpenGL(EglDisplay *eglDisplay);
+    ~ItemRendererOpenGL() override;
 
     std::unique_ptr<Texture> createTexture(GraphicsBuffer *buffer, const std::shared_ptr<SyncReleasePoint> &releasePoint) override;
     std::unique_ptr<Texture> createTexture(const QImage &image) override;
@@ -87,16 +96,63 @@ public:
     bool renderItem(const RenderTarget &renderTarget, const RenderViewport &viewport, Item *item, int mask, const Region &deviceRegion, const WindowPaintData &data, const std::function<bool(Item *)> &filter, const std::function<bool(Item *)> &holeFilter) override;
 
     void setLayerDebugging(bool enable) override;
+    void setColorFilter(const QMatrix4x4 &filter) override;
 
 private:
     QVector4D modulate(float opacity, float brightness) const;
     void setBlendEnabled(bool enabled);
     bool createRenderNode(Item *item, RenderContext *context, const std::function<bool(Item *)> &filter, const std::function<bool(Item *)> &holeFilter);
+    void setGeometry(RenderNode &renderNode, const Item *item, const RenderContext *context, bool clipped, const std::optional<QMatrix4x4> &textureMatrix);
+    void uploadRetainedGeometry();
+    void collectRetainedGeometry();
+    GLVertexBuffer *vertexBuffer(const RenderNode &renderNode) const;
     void visualizeFractional(const RenderViewport &viewport, const Region &logicalRegion, const RenderContext &renderContext);
 
+    /**
+     * The ColorTransformation type caches what's needed to convert between two color
+     * descriptions. The descriptions are kept alive, so that the pointers can be used
+     * to look up the transformation without their addresses getting reused. References
+     * to the cached transformations stay valid until the next frame.
+     */
+    struct ColorTransformation
+    {
+        std::shared_ptr<ColorDescription> source;
+        std::shared_ptr<ColorDescription> destination;
+        RenderingIntent intent;
+        bool floatingPoint;
+        bool isIdentity;
+        QMatrix4x4 colorimetryTransformation;
+    };
+    const ColorTransformation &cachedColorTransformation(const std::shared_ptr<ColorDescription> &source, const std::shared_ptr<ColorDescription> &destination, RenderingIntent intent, bool floatingPoint);
+
+    /**
+     * The RetainedGeometry type describes the vertices of an item that are kept in the retained
+     * vertex buffer. Most items don't change for thousands of frames, so once their quads have
+     * been the same for two frames in a row, they are drawn straight from that buffer instead
+     * of being written to the streaming buffer every frame. Items that have to be clipped on
+     * the CPU are always streamed.
+     */
+    struct RetainedGeometry
+    {
+        quint64 quadsSerial = 0;
+        std::optional<QMatrix4x4> textureMatrix;
+        int firstVertex = -1;
+        int vertexCount = 0;
+        quint64 lastUsedFrame = 0;
+    };
+
     bool m_blendingEnabled = false;
     EglDisplay *const m_eglDisplay;
     std::unordered_set<std::shared_ptr<SyncReleasePoint>> m_releasePoints;
+    std::deque<ColorTransformation> m_colorTransformations;
+    QMatrix4x4 m_colorFilter;
+    std::shared_ptr<ImageAtlasOpenGL> m_imageAtlas;
+    std::map<std::pair<const Item *, qreal>, RetainedGeometry> m_retainedGeometry;
+    QList<GLVertex2D> m_retainedVertices;
+    std::unique_ptr<GLVertexBuffer> m_retainedVertexBuffer;
+    qsizetype m_unusedRetainedVertices = 0;
+    bool m_retainedVerticesDirty = false;
+    quint64 m_frameCounter = 0;
 
     struct
     {
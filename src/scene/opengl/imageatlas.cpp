@@ -0,0 +1,311 @@
+/*
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "scene/opengl/imageatlas.h"
+#include "opengl/gltexture.h"
+
+#include <QPainter>
+
+#include <algorithm>
+
+namespace KWin
+{
+
+// every sprite is surrounded by a copy of its edges, so that linear
+// filtering doesn't pick up the pixels of the neighbouring sprites
+static const QMargins s_padding(1, 1, 1, 1);
+
+// the atlas is only defragmented if nothing has been added or removed for this long
+static constexpr std::chrono::seconds s_idleTime(5);
+
+static std::unique_ptr<GLTexture> allocatePage(const QSize &size)
+{
+    auto texture = GLTexture::allocate(GL_RGBA8, size);
+    if (texture) {
+        texture->setContentTransform(OutputTransform::FlipY);
+        texture->setFilter(GL_LINEAR);
+        texture->setWrapMode(GL_CLAMP_TO_EDGE);
+    }
+    return texture;
+}
+
+ImageAtlasOpenGL::Sprite::~Sprite()
+{
+    if (auto atlas = this->atlas.lock()) {
+        atlas->release(this);
+    }
+}
+
+ImageAtlasOpenGL::~ImageAtlasOpenGL()
+{
+    // the textures that still use the sprites must not touch the pages anymore
+    for (const auto &[key, weakSprite] : m_sprites) {
+        if (const auto sprite = weakSprite.lock()) {
+            sprite->page = nullptr;
+        }
+    }
+}
+
+bool ImageAtlasOpenGL::canStore(const QImage &image)
+{
+    if (image.isNull() || image.width() > s_maxSpriteSize || image.height() > s_maxSpriteSize) {
+        return false;
+    }
+    // the pages use 8 bits per channel, other formats would lose precision
+    switch (image.format()) {
+    case QImage::Format_RGB32:
+    case QImage::Format_ARGB32:
+    case QImage::Format_ARGB32_Premultiplied:
+    case QImage::Format_RGBX8888:
+    case QImage::Format_RGBA8888:
+    case QImage::Format_RGBA8888_Premultiplied:
+        return true;
+    default:
+        return false;
+    }
+}
+
+std::unique_ptr<AtlasTextureOpenGL> ImageAtlasOpenGL::createTexture(const QImage &image)
+{
+    if (auto sprite = acquire(image)) {
+        return std::make_unique<AtlasTextureOpenGL>(sprite);
+    }
+    return nullptr;
+}
+
+std::shared_ptr<ImageAtlasOpenGL::Sprite> ImageAtlasOpenGL::acquire(const QImage &image)
+{
+    if (const auto it = m_sprites.find(image.cacheKey()); it != m_sprites.end()) {
+        if (auto sprite = it->second.lock()) {
+            return sprite;
+        }
+    }
+
+    auto sprite = std::make_shared<Sprite>();
+    sprite->atlas = weak_from_this();
+    sprite->key = image.cacheKey();
+    sprite->image = image;
+    if (!place(sprite.get())) {
+        return nullptr;
+    }
+
+    m_sprites[sprite->key] = sprite;
+    m_lastChange = std::chrono::steady_clock::now();
+    return sprite;
+}
+
+bool ImageAtlasOpenGL::update(Sprite *sprite, const QImage &image)
+{
+    if (!sprite->page || sprite->image.size() != image.size()) {
+        return false;
+    }
+    if (const auto it = m_sprites.find(image.cacheKey()); it != m_sprites.end() && !it->second.expired()) {
+        // another sprite already has the same contents
+        return false;
+    }
+
+    auto node = m_sprites.extract(sprite->key);
+    node.key() = image.cacheKey();
+    m_sprites.insert(std::move(node));
+
+    sprite->key = image.cacheKey();
+    sprite->image = image;
+    upload(sprite);
+    return true;
+}
+
+bool ImageAtlasOpenGL::place(Sprite *sprite)
+{
+    const QSize paddedSize = sprite->image.size().grownBy(s_padding);
+
+    const auto tryPage = [&](Page *page) {
+        if (const auto rect = page->packer.allocate(paddedSize)) {
+            sprite->page = page;
+            sprite->geometry = Rect(rect->topLeft() + QPoint(s_padding.left(), s_padding.top()), sprite->image.size());
+            upload(sprite);
+            return true;
+        }
+        return false;
+    };
+
+    for (const auto &page : m_pages) {
+        if (tryPage(page.get())) {
+            return true;
+        }
+    }
+    for (const auto &page : m_pages) {
+        while (page->packer.size().width() < s_maxPageSize && grow(page.get())) {
+            if (tryPage(page.get())) {
+                return true;
+            }
+        }
+    }
+
+    auto texture = allocatePage(QSize(s_initialPageSize, s_initialPageSize));
+    if (!texture) {
+        return false;
+    }
+    Page *page = m_pages.emplace_back(std::make_unique<Page>(Page{
+                                          .texture = std::move(texture),
+                                          .packer = ShelfPacker(QSize(s_initialPageSize, s_initialPageSize)),
+                                      }))
+                     .get();
+    return tryPage(page);
+}
+
+bool ImageAtlasOpenGL::grow(Page *page)
+{
+    const QSize size = page->packer.size() * 2;
+    auto texture = allocatePage(size);
+    if (!texture) {
+        return false;
+    }
+
+    page->texture = std::move(texture);
+    page->packer.grow(size);
+
+    // the contents of the old texture are gone, but every sprite still has its image
+    for (const Sprite *sprite : sprites(page)) {
+        upload(sprite);
+    }
+    return true;
+}
+
+void ImageAtlasOpenGL::upload(const Sprite *sprite)
+{
+    const QImage &image = sprite->image;
+    const int width = image.width();
+    const int height = image.height();
+
+    QImage padded(image.size().grownBy(s_padding), QImage::Format_ARGB32_Premultiplied);
+    QPainter painter(&padded);
+    painter.setCompositionMode(QPainter::CompositionMode_Source);
+    painter.drawImage(QPoint(1, 1), image);
+    painter.drawImage(QRect(1, 0, width, 1), image, QRect(0, 0, width, 1));
+    painter.drawImage(QRect(1, height + 1, width, 1), image, QRect(0, height - 1, width, 1));
+    painter.drawImage(QRect(0, 1, 1, height), image, QRect(0, 0, 1, height));
+    painter.drawImage(QRect(width + 1, 1, 1, height), image, QRect(width - 1, 0, 1, height));
+    painter.drawImage(QRect(0, 0, 1, 1), image, QRect(0, 0, 1, 1));
+    painter.drawImage(QRect(width + 1, 0, 1, 1), image, QRect(width - 1, 0, 1, 1));
+    painter.drawImage(QRect(0, height + 1, 1, 1), image, QRect(0, height - 1, 1, 1));
+    painter.drawImage(QRect(width + 1, height + 1, 1, 1), image, QRect(width - 1, height - 1, 1, 1));
+    painter.end();
+
+    sprite->page->texture->update(padded, padded.rect(), sprite->geometry.topLeft() - QPoint(s_padding.left(), s_padding.top()));
+}
+
+void ImageAtlasOpenGL::release(Sprite *sprite)
+{
+    if (sprite->page) {
+        sprite->page->packer.free(Rect(sprite->geometry.topLeft() - QPoint(s_padding.left(), s_padding.top()), sprite->image.size().grownBy(s_padding)));
+    }
+    if (const auto it = m_sprites.find(sprite->key); it != m_sprites.end() && it->second.expired()) {
+        m_sprites.erase(it);
+    }
+    m_lastChange = std::chrono::steady_clock::now();
+}
+
+std::vector<ImageAtlasOpenGL::Sprite *> ImageAtlasOpenGL::sprites(const Page *page) const
+{
+    std::vector<Sprite *> ret;
+    for (const auto &[key, weakSprite] : m_sprites) {
+        if (const auto sprite = weakSprite.lock(); sprite && sprite->page == page) {
+            ret.push_back(sprite.get());
+        }
+    }
+    return ret;
+}
+
+void ImageAtlasOpenGL::defragmentIfIdle()
+{
+    if (m_pages.empty() || std::chrono::steady_clock::now() - m_lastChange < s_idleTime) {
+        return;
+    }
+
+    qint64 usedArea = 0;
+    qint64 pageArea = 0;
+    for (const auto &page : m_pages) {
+        usedArea += page->packer.usedArea();
+        pageArea += qint64(page->packer.size().width()) * page->packer.size().height();
+    }
+    if (usedArea == 0) {
+        m_pages.clear();
+        return;
+    }
+    if (pageArea <= s_initialPageSize * s_initialPageSize || usedArea * 2 > pageArea) {
+        return;
+    }
+
+    std::vector<std::shared_ptr<Sprite>> sprites;
+    for (const auto &[key, weakSprite] : m_sprites) {
+        if (auto sprite = weakSprite.lock()) {
+            sprite->page = nullptr;
+            sprites.push_back(std::move(sprite));
+        }
+    }
+    m_pages.clear();
+
+    // tall sprites first, so that the shelves are filled with sprites of similar height
+    std::ranges::sort(sprites, [](const auto &a, const auto &b) {
+        return a->image.height() > b->image.height();
+    });
+    for (const auto &sprite : sprites) {
+        place(sprite.get());
+    }
+
+    m_lastChange = std::chrono::steady_clock::now();
+}
+
+AtlasTextureOpenGL::AtlasTextureOpenGL(const std::shared_ptr<ImageAtlasOpenGL::Sprite> &sprite)
+    : m_sprite(sprite)
+{
+    m_size = sprite->image.size();
+}
+
+QVarLengthArray<GLTexture *, 4> AtlasTextureOpenGL::planes() const
+{
+    if (!m_sprite->page) {
+        return {};
+    }
+    return {m_sprite->page->texture.get()};
+}
+
+QMatrix4x4 AtlasTextureOpenGL::matrix(TextureCoordinateType type) const
+{
+    if (!m_sprite->page) {
+        return QMatrix4x4();
+    }
+
+    QMatrix4x4 matrix = m_sprite->page->texture->matrix(UnnormalizedCoordinates);
+    matrix.translate(m_sprite->geometry.x(), m_sprite->geometry.y());
+    if (type == NormalizedCoordinates) {
+        matrix.scale(m_sprite->geometry.width(), m_sprite->geometry.height());
+    }
+    return matrix;
+}
+
+void AtlasTextureOpenGL::attach(GraphicsBuffer *buffer, const Region &region, const std::shared_ptr<SyncReleasePoint> &releasePoint)
+{
+    Q_UNREACHABLE();
+}
+
+void AtlasTextureOpenGL::upload(const QImage &image, const Rect &region)
+{
+    const auto atlas = m_sprite->atlas.lock();
+    if (!atlas) {
+        return;
+    }
+    // the sprite can be updated in place unless other textures show the old image
+    if (m_sprite.use_count() == 1 && atlas->update(m_sprite.get(), image)) {
+        return;
+    }
+    if (auto sprite = atlas->acquire(image)) {
+        m_sprite = std::move(sprite);
+        m_size = m_sprite->image.size();
+    }
+}
+
+} // namespace KWin
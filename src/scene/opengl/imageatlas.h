@@ -0,0 +1,106 @@
+/*
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include "scene/opengl/texture.h"
+#include "scene/shelfpacker.h"
+
+#include <chrono>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace KWin
+{
+
+class AtlasTextureOpenGL;
+
+/**
+ * The ImageAtlasOpenGL class stores small images, such as icons and effect sprites, in a few
+ * shared textures. Items that use textures from the same page can be drawn in one draw call.
+ *
+ * Images with the same cache key share a sprite. The sprites are removed from the atlas once
+ * no texture uses them anymore. Pages start small and grow when they're full, if a page
+ * can't grow anymore, another one is added. Since the freed space is not always reusable,
+ * the sprites are arranged again once the atlas has been idle for a while and most of its
+ * space is unused.
+ */
+class ImageAtlasOpenGL : public std::enable_shared_from_this<ImageAtlasOpenGL>
+{
+public:
+    static constexpr int s_maxSpriteSize = 256;
+    static constexpr int s_initialPageSize = 512;
+    static constexpr int s_maxPageSize = 2048;
+
+    struct Page
+    {
+        std::unique_ptr<GLTexture> texture;
+        ShelfPacker packer;
+    };
+
+    struct Sprite
+    {
+        ~Sprite();
+
+        std::weak_ptr<ImageAtlasOpenGL> atlas;
+        qint64 key = 0;
+        QImage image;
+        Page *page = nullptr;
+        /**
+         * The geometry of the image in the page, without the padding
+         */
+        Rect geometry;
+    };
+
+    ~ImageAtlasOpenGL();
+
+    /**
+     * Returns @c true if the @a image is small enough to be stored in the atlas.
+     */
+    static bool canStore(const QImage &image);
+
+    std::unique_ptr<AtlasTextureOpenGL> createTexture(const QImage &image);
+    std::shared_ptr<Sprite> acquire(const QImage &image);
+    bool update(Sprite *sprite, const QImage &image);
+
+    /**
+     * Arranges the sprites again if the atlas hasn't changed for a while and most of its
+     * space is unused. This must be called with the OpenGL context current.
+     */
+    void defragmentIfIdle();
+
+private:
+    bool place(Sprite *sprite);
+    bool grow(Page *page);
+    void upload(const Sprite *sprite);
+    void release(Sprite *sprite);
+    std::vector<Sprite *> sprites(const Page *page) const;
+
+    std::vector<std::unique_ptr<Page>> m_pages;
+    std::unordered_map<qint64, std::weak_ptr<Sprite>> m_sprites;
+    std::chrono::steady_clock::time_point m_lastChange;
+};
+
+/**
+ * The AtlasTextureOpenGL class is a texture for an image in an ImageAtlasOpenGL.
+ */
+class AtlasTextureOpenGL : public TextureOpenGL
+{
+public:
+    explicit AtlasTextureOpenGL(const std::shared_ptr<ImageAtlasOpenGL::Sprite> &sprite);
+
+    QVarLengthArray<GLTexture *, 4> planes() const override;
+    QMatrix4x4 matrix(TextureCoordinateType type) const override;
+
+    void attach(GraphicsBuffer *buffer, const Region &region, const std::shared_ptr<SyncReleasePoint> &releasePoint) override;
+    void upload(const QImage &image, const Rect &region) override;
+
+private:
+    std::shared_ptr<ImageAtlasOpenGL::Sprite> m_sprite;
+};
+
+} // namespace KWin
@@ -12,6 +12,7 @@
 #include "core/graphicsbufferview.h"
 #include "core/renderdevice.h"
 #include "core/syncobjtimeline.h"
+#include "ftrace.h"
 #include "opengl/eglbackend.h"
 #include "opengl/gltexture.h"
 #include "utils/common.h"
@@ -31,6 +32,11 @@ QVarLengthArray<GLTexture *, 4> TextureOpenGL::planes() const
     return m_planes;
 }
 
+QMatrix4x4 TextureOpenGL::matrix(TextureCoordinateType type) const
+{
+    return m_planes[0]->matrix(type);
+}
+
 std::unique_ptr<ImageTextureOpenGL> ImageTextureOpenGL::create(const QImage &image)
 {
     auto texture = std::make_unique<ImageTextureOpenGL>();
@@ -155,12 +161,17 @@ static std::unique_ptr<GLTexture> createTexture(EGLImageKHR image, const QSize &
 
 bool BufferTextureOpenGL::loadShmTexture(GraphicsBuffer *buffer)
 {
-    const GraphicsBufferView view(buffer);
-    if (Q_UNLIKELY(view.isNull())) {
-        return false;
+    fTraceDuration("Upload shm texture ", buffer->size().width(), "x", buffer->size().height());
+    std::unique_ptr<GLTexture> texture;
+    if (const QImage converted = buffer->convertedImage(); !converted.isNull()) {
+        texture = GLTexture::upload(converted);
+    } else {
+        const GraphicsBufferView view(buffer);
+        if (Q_UNLIKELY(view.isNull())) {
+            return false;
+        }
+        texture = GLTexture::upload(*view.image());
     }
-
-    std::unique_ptr<GLTexture> texture = GLTexture::upload(*view.image());
     if (Q_UNLIKELY(!texture)) {
         return false;
     }
@@ -178,13 +189,39 @@ bool BufferTextureOpenGL::loadShmTexture(GraphicsBuffer *buffer)
     return true;
 }
 
-static Region simplifyDamage(const Region &damage)
+static qint64 area(const Rect &rect)
 {
-    if (damage.rects().size() < 3) {
-        return damage;
-    } else {
-        return damage.boundingRect();
+    return qint64(rect.width()) * rect.height();
+}
+
+/**
+ * Merges the damaged rects into a few uploads. Two rects are merged if their bounding rect
+ * doesn't contain much undamaged area, uploading a few extra pixels is cheaper than issuing
+ * many small uploads. If the damage is too fragmented, the bounding rect is uploaded instead.
+ */
+static QVarLengthArray<Rect, 8> coalesceDamage(const Region &damage)
+{
+    static constexpr qsizetype maxUploads = 8;
+
+    QVarLengthArray<Rect, 8> uploads;
+    for (const Rect &rect : damage.rects()) {
+        bool merged = false;
+        for (Rect &upload : uploads) {
+            const Rect united = upload.united(rect);
+            if (area(united) * 4 <= (area(upload) + area(rect)) * 5) {
+                upload = united;
+                merged = true;
+                break;
+            }
+        }
+        if (!merged) {
+            if (uploads.size() == maxUploads) {
+                return {damage.boundingRect()};
+            }
+            uploads.append(rect);
+        }
     }
+    return uploads;
 }
 
 void BufferTextureOpenGL::updateShmTexture(GraphicsBuffer *buffer, const Region &region, const std::shared_ptr<SyncReleasePoint> &releasePoint)
@@ -195,12 +232,17 @@ void BufferTextureOpenGL::updateShmTexture(GraphicsBuffer *buffer, const Region
         return;
     }
 
-    const GraphicsBufferView view(buffer);
-    if (Q_UNLIKELY(view.isNull())) {
-        return;
+    const auto uploads = coalesceDamage(region & Rect(QPoint(0, 0), m_planes[0]->size()));
+    fTraceDuration("Update shm texture rects=", uploads.size());
+    if (const QImage converted = buffer->convertedImage(); !converted.isNull()) {
+        m_planes[0]->update(converted, uploads);
+    } else {
+        const GraphicsBufferView view(buffer);
+        if (Q_UNLIKELY(view.isNull())) {
+            return;
+        }
+        m_planes[0]->update(*view.image(), uploads);
     }
-
-    m_planes[0]->update(*view.image(), simplifyDamage(region) & Rect(QPoint(0, 0), m_planes[0]->size()));
     const auto info = FormatInfo::get(buffer->shmAttributes()->format);
     m_isFloatingPoint = info && info->floatingPoint;
 }
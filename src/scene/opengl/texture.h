@@ -6,9 +6,11 @@
 
 #pragma once
 
+#include "opengl/gltexture.h"
 #include "scene/texture.h"
 
 #include <QImage>
+#include <QMatrix4x4>
 #include <QVarLengthArray>
 
 namespace KWin
@@ -26,7 +28,13 @@ class TextureOpenGL : public Texture
 public:
     ~TextureOpenGL() override;
 
-    QVarLengthArray<GLTexture *, 4> planes() const;
+    virtual QVarLengthArray<GLTexture *, 4> planes() const;
+
+    /**
+     * Returns the matrix that transforms texture coordinates of the given @a type to the
+     * coordinates in the planes.
+     */
+    virtual QMatrix4x4 matrix(TextureCoordinateType type) const;
 
 protected:
     QVarLengthArray<GLTexture *, 4> m_planes;
@@ -0,0 +1,428 @@
+/*
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "scene/performancehud.h"
+#include "compositor.h"
+#include "core/backendoutput.h"
+#include "core/frametimingjournal.h"
+#include "core/renderbackend.h"
+#include "core/renderloop.h"
+#include "core/rendertarget.h"
+#include "core/renderviewport.h"
+#include "opengl/glshader.h"
+#include "opengl/glshadermanager.h"
+#include "opengl/gltexture.h"
+#include "opengl/glvertexbuffer.h"
+#include "scene/scene.h"
+
+#include <QFontDatabase>
+#include <QFontMetrics>
+#include <QPainter>
+
+#include <algorithm>
+#include <cmath>
+#include <span>
+
+namespace KWin
+{
+
+static constexpr std::chrono::milliseconds s_updateInterval(250);
+// the text lines are about the frames in this period
+static constexpr std::chrono::seconds s_summaryPeriod(2);
+
+static constexpr char s_firstGlyph = ' ';
+static constexpr int s_glyphCount = '~' - ' ' + 1;
+static constexpr int s_atlasColumns = 16;
+static constexpr int s_fontSize = 11;
+
+static constexpr int s_columns = 40;
+static constexpr int s_lines = 7;
+static constexpr int s_graphFrames = 120;
+static constexpr int s_barWidth = 2;
+static constexpr int s_graphHeight = 40;
+static constexpr int s_padding = 4;
+
+enum class Color {
+    Background,
+    Grid,
+    Text,
+    Good,
+    Late,
+    Dropped,
+    Scanout,
+    Prediction,
+};
+
+static const QColor s_palette[] = {
+    QColor(0, 0, 0, 180),
+    QColor(128, 128, 128),
+    QColor(255, 255, 255),
+    QColor(64, 200, 64),
+    QColor(230, 200, 40),
+    QColor(230, 50, 50),
+    QColor(70, 130, 240),
+    QColor(255, 255, 255),
+};
+
+static QPoint glyphCell(char glyph)
+{
+    const int index = glyph - s_firstGlyph;
+    return QPoint(index % s_atlasColumns, index / s_atlasColumns);
+}
+
+static QPoint colorCell(Color color)
+{
+    // the solid colors are in the row after the glyphs
+    return QPoint(int(color), (s_glyphCount + s_atlasColumns - 1) / s_atlasColumns);
+}
+
+static double milliseconds(int64_t nanoseconds)
+{
+    return nanoseconds / 1'000'000.0;
+}
+
+namespace
+{
+
+class QuadBuilder
+{
+public:
+    QuadBuilder(const QSize &cellSize, const QMatrix4x4 &textureMatrix)
+        : m_cellSize(cellSize)
+        , m_textureMatrix(textureMatrix)
+    {
+    }
+
+    void fill(const QRectF &geometry, Color color)
+    {
+        // sample the middle of the cell, so that the whole quad gets the same color
+        const QPointF center = QRectF(QPointF(colorCell(color).x() * m_cellSize.width(), colorCell(color).y() * m_cellSize.height()), m_cellSize).center();
+        add(geometry, QRectF(center, center));
+    }
+
+    void text(const QPointF &position, const QByteArray &text)
+    {
+        for (int i = 0; i < std::min<int>(text.size(), s_columns); ++i) {
+            const char glyph = text[i];
+            if (glyph <= s_firstGlyph || glyph >= s_firstGlyph + s_glyphCount) {
+                continue;
+            }
+            const QPoint cell = glyphCell(glyph);
+            add(QRectF(position + QPointF(i * m_cellSize.width(), 0), m_cellSize),
+                QRectF(QPointF(cell.x() * m_cellSize.width(), cell.y() * m_cellSize.height()), m_cellSize));
+        }
+    }
+
+    std::vector<GLVertex2D> &vertices()
+    {
+        return m_vertices;
+    }
+
+private:
+    void add(const QRectF &geometry, const QRectF &source)
+    {
+        const auto vertex = [this](const QPointF &position, const QPointF &texcoord) {
+            const QPointF mapped = m_textureMatrix.map(texcoord);
+            return GLVertex2D{
+                .position = QVector2D(position),
+                .texcoord = QVector2D(mapped),
+            };
+        };
+        const GLVertex2D topLeft = vertex(geometry.topLeft(), source.topLeft());
+        const GLVertex2D bottomRight = vertex(geometry.bottomRight(), source.bottomRight());
+        m_vertices.push_back(topLeft);
+        m_vertices.push_back(vertex(geometry.bottomLeft(), source.bottomLeft()));
+        m_vertices.push_back(bottomRight);
+        m_vertices.push_back(bottomRight);
+        m_vertices.push_back(vertex(geometry.topRight(), source.topRight()));
+        m_vertices.push_back(topLeft);
+    }
+
+    const QSize m_cellSize;
+    const QMatrix4x4 m_textureMatrix;
+    std::vector<GLVertex2D> m_vertices;
+};
+
+}
+
+PerformanceHud::PerformanceHud(Scene *scene)
+    : m_scene(scene)
+{
+    connect(scene, &Scene::viewRemoved, this, [this](RenderView *view) {
+        m_views.erase(view);
+    });
+    connect(&m_timer, &QTimer::timeout, this, &PerformanceHud::scheduleRepaints);
+    m_timer.start(s_updateInterval);
+}
+
+PerformanceHud::~PerformanceHud()
+{
+}
+
+Rect PerformanceHud::deviceRect(RenderView *view) const
+{
+    const auto it = m_views.find(view);
+    return it != m_views.end() ? it->second.deviceRect : Rect();
+}
+
+PerformanceHud::Atlas *PerformanceHud::atlas(int scale)
+{
+    if (auto it = m_atlases.find(scale); it != m_atlases.end()) {
+        return &it->second;
+    }
+
+    QFont font = QFontDatabase::systemFont(QFontDatabase::FixedFont);
+    font.setPixelSize(s_fontSize * scale);
+    const QFontMetrics metrics(font);
+    const QSize cellSize(metrics.horizontalAdvance(QLatin1Char('M')), metrics.height());
+
+    const int rows = colorCell(Color::Background).y() + 1;
+    QImage image(s_atlasColumns * cellSize.width(), rows * cellSize.height(), QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::transparent);
+    QPainter painter(&image);
+    painter.setFont(font);
+    painter.setPen(s_palette[int(Color::Text)]);
+    for (int i = 0; i < s_glyphCount; ++i) {
+        const QPoint cell = glyphCell(s_firstGlyph + i);
+        painter.drawText(QRect(QPoint(cell.x() * cellSize.width(), cell.y() * cellSize.height()), cellSize), Qt::AlignCenter, QString(QLatin1Char(s_firstGlyph + i)));
+    }
+    for (size_t i = 0; i < std::size(s_palette); ++i) {
+        const QPoint cell = colorCell(Color(i));
+        painter.fillRect(QRect(QPoint(cell.x() * cellSize.width(), cell.y() * cellSize.height()), cellSize), s_palette[i]);
+    }
+    painter.end();
+
+    auto texture = GLTexture::upload(image);
+    if (!texture) {
+        return nullptr;
+    }
+    texture->setFilter(GL_NEAREST);
+    texture->setWrapMode(GL_CLAMP_TO_EDGE);
+    return &(m_atlases[scale] = Atlas{
+                 .texture = std::move(texture),
+                 .cellSize = cellSize,
+             });
+}
+
+void PerformanceHud::update(RenderView *view, ViewData &data, const Atlas &atlas)
+{
+    const int scale = data.scale;
+    const int padding = s_padding * scale;
+    const int graphHeight = s_graphHeight * scale;
+    const int barWidth = s_barWidth * scale;
+    const QSize size(std::max(s_columns * atlas.cellSize.width(), s_graphFrames * barWidth) + 2 * padding,
+                     s_lines * atlas.cellSize.height() + 2 * graphHeight + 4 * padding);
+
+    QuadBuilder builder(atlas.cellSize, atlas.texture->matrix(UnnormalizedCoordinates));
+    builder.fill(QRectF(QPointF(0, 0), size), Color::Background);
+
+    BackendOutput *output = view->backendOutput();
+    FrameTimingJournal *journal = output->renderLoop()->frameTimings();
+    std::span<const FrameTimingRecord> records;
+    QByteArray recordData;
+    if (journal) {
+        const uint64_t lastSequence = journal->lastSequence();
+        const uint32_t count = std::min<uint64_t>(lastSequence, FrameTimingJournal::s_capacity);
+        recordData = journal->records(lastSequence - count + 1, count);
+        records = std::span(reinterpret_cast<const FrameTimingRecord *>(recordData.constData()), recordData.size() / sizeof(FrameTimingRecord));
+    }
+
+    const int64_t since = records.empty() ? 0 : std::max(records.back().actualPresentation, records.back().targetPresentation) - std::chrono::nanoseconds(s_summaryPeriod).count();
+    int presented = 0;
+    int dropped = 0;
+    int missed = 0;
+    int64_t totalRenderTime = 0;
+    int64_t maxRenderTime = 0;
+    int64_t totalGpuTime = 0;
+    int64_t maxGpuTime = 0;
+    for (const FrameTimingRecord &record : records) {
+        const int64_t timestamp = record.flags & FrameTimingRecord::Dropped ? record.targetPresentation : record.actualPresentation;
+        if (timestamp < since) {
+            continue;
+        }
+        if (record.flags & FrameTimingRecord::Dropped) {
+            dropped++;
+            continue;
+        }
+        presented++;
+        if (record.targetPresentation && record.actualPresentation - record.targetPresentation > record.refreshDuration / 2) {
+            missed++;
+        }
+        totalRenderTime += record.renderEnd - record.renderStart;
+        maxRenderTime = std::max(maxRenderTime, record.renderEnd - record.renderStart);
+        totalGpuTime += record.gpuTime;
+        maxGpuTime = std::max(maxGpuTime, record.gpuTime);
+    }
+
+    QList<QByteArray> lines;
+    lines.append(QByteArray(output->name().toLatin1() + "  " + QByteArray::number(output->refreshRate() / 1000.0, 'f', 1)
+                            + " Hz  " + QByteArray::number(presented / double(s_summaryPeriod.count()), 'f', 0) + " fps"));
+    lines.append(QByteArray::asprintf("cpu   avg %6.2f  max %6.2f ms", presented ? milliseconds(totalRenderTime / presented) : 0.0, milliseconds(maxRenderTime)));
+    lines.append(QByteArray::asprintf("gpu   avg %6.2f  max %6.2f ms", presented ? milliseconds(totalGpuTime / presented) : 0.0, milliseconds(maxGpuTime)));
+    if (!records.empty()) {
+        lines.append(QByteArray::asprintf("pred  %6.2f ms  margin %5.2f ms", milliseconds(records.back().predictedRenderTime), milliseconds(records.back().safetyMargin)));
+    } else {
+        lines.append(QByteArray("pred  -"));
+    }
+    lines.append(QByteArray::asprintf("dropped %d (%llu total)  missed %d", dropped, journal ? (unsigned long long)journal->droppedCount() : 0ull, missed));
+
+    // which layers got their content by direct scanout since the last update
+    QByteArray layerLine;
+    QByteArray failureLine;
+    RenderBackend *backend = Compositor::self()->backend();
+    const QList<OutputLayer *> layers = backend ? backend->compatibleOutputLayers(output) : QList<OutputLayer *>();
+    data.layerStatistics.resize(layers.size());
+    for (qsizetype i = 0; i < layers.size(); ++i) {
+        const OutputLayerStatistics &current = layers[i]->statistics();
+        const OutputLayerStatistics &previous = data.layerStatistics[i];
+        const char *state = "idle";
+        if (!layers[i]->isEnabled()) {
+            state = "off";
+        } else if (current.directScanout > previous.directScanout) {
+            state = "scanout";
+        } else if (current.composited > previous.composited) {
+            state = "comp";
+        }
+        if (!layerLine.isEmpty()) {
+            layerLine += ' ';
+        }
+        layerLine += QByteArray(outputLayerTypeName(layers[i]->type())) + ':' + state;
+
+        if (failureLine.isEmpty()) {
+            size_t mostFrequent = OutputLayerStatistics::s_scanoutFailureCount;
+            uint64_t mostFailures = 0;
+            for (size_t failure = 0; failure < OutputLayerStatistics::s_scanoutFailureCount; ++failure) {
+                const uint64_t failures = current.scanoutFailures[failure] - previous.scanoutFailures[failure];
+                if (failure != size_t(OutputLayerStatistics::ScanoutFailure::NoCandidate) && failures > mostFailures) {
+                    mostFrequent = failure;
+                    mostFailures = failures;
+                }
+            }
+            if (mostFrequent != OutputLayerStatistics::s_scanoutFailureCount) {
+                failureLine = QByteArray(outputLayerTypeName(layers[i]->type())) + " no scanout: " + OutputLayerStatistics::scanoutFailureName(OutputLayerStatistics::ScanoutFailure(mostFrequent));
+            }
+        }
+        data.layerStatistics[i] = current;
+    }
+    lines.append(layerLine);
+    lines.append(failureLine);
+
+    for (qsizetype i = 0; i < lines.size(); ++i) {
+        builder.text(QPointF(padding, padding + i * atlas.cellSize.height()), lines[i]);
+    }
+
+    // the graphs show the render and GPU time of the last frames, relative to the refresh
+    // duration at the top. Dropped frames fill the whole height
+    const auto graph = [&](int top, bool gpu) {
+        const QRectF area(padding, top, s_graphFrames * barWidth, graphHeight);
+        builder.fill(QRectF(area.left(), area.top(), area.width(), scale), Color::Grid);
+        builder.fill(QRectF(area.left(), area.bottom() - scale, area.width(), scale), Color::Grid);
+        const auto height = [&](int64_t duration, int64_t refreshDuration) {
+            return std::clamp(area.height() * duration / double(std::max<int64_t>(refreshDuration, 1)), 0.0, area.height());
+        };
+        const size_t first = records.size() > size_t(s_graphFrames) ? records.size() - s_graphFrames : 0;
+        for (size_t i = first; i < records.size(); ++i) {
+            const FrameTimingRecord &record = records[i];
+            const qreal x = area.left() + (i - first) * barWidth;
+            if (record.flags & FrameTimingRecord::Dropped) {
+                builder.fill(QRectF(x, area.top(), barWidth, area.height()), Color::Dropped);
+                continue;
+            }
+            const int64_t duration = gpu ? record.gpuTime : record.renderEnd - record.renderStart;
+            Color color = Color::Good;
+            if (record.flags & FrameTimingRecord::DirectScanout) {
+                color = Color::Scanout;
+            } else if (record.targetPresentation && record.actualPresentation - record.targetPresentation > record.refreshDuration / 2) {
+                color = Color::Late;
+            }
+            const qreal barHeight = std::max<qreal>(height(duration, record.refreshDuration), scale);
+            builder.fill(QRectF(x, area.bottom() - barHeight, barWidth, barHeight), color);
+            if (!gpu && record.predictedRenderTime) {
+                const qreal predicted = height(record.predictedRenderTime, record.refreshDuration);
+                builder.fill(QRectF(x, area.bottom() - predicted - scale, barWidth, scale), Color::Prediction);
+            }
+        }
+    };
+    const int graphTop = 2 * padding + s_lines * atlas.cellSize.height();
+    graph(graphTop, false);
+    graph(graphTop + graphHeight + padding, true);
+
+    if (!data.vertexBuffer) {
+        data.vertexBuffer = std::make_unique<GLVertexBuffer>(GLVertexBuffer::Dynamic);
+    }
+    data.vertexBuffer->setVertices(builder.vertices());
+
+    const Rect viewRect = view->deviceRect();
+    data.deviceRect = Rect(viewRect.right() - size.width() - padding, viewRect.y() + padding, size.width(), size.height());
+    data.lastUpdate = std::chrono::steady_clock::now();
+}
+
+void PerformanceHud::paint(RenderView *view, const RenderTarget &renderTarget, const RenderViewport &viewport, const Region &deviceRegion)
+{
+    if (!renderTarget.framebuffer() || !view->backendOutput()) {
+        return;
+    }
+    const int scale = std::max(1, int(std::round(viewport.scale())));
+    Atlas *atlas = this->atlas(scale);
+    if (!atlas) {
+        return;
+    }
+
+    ViewData &data = m_views[view];
+    const Rect previousRect = data.deviceRect;
+    if (!data.vertexBuffer || data.scale != scale || std::chrono::steady_clock::now() - data.lastUpdate >= s_updateInterval) {
+        data.scale = scale;
+        update(view, data, *atlas);
+    }
+    if (data.deviceRect != previousRect) {
+        // the parts the old or new geometry covers outside of this frame's repaint are painted next frame
+        m_scene->addDeviceRepaint(view, Region(previousRect) | data.deviceRect);
+    }
+
+    const Region clip = deviceRegion & data.deviceRect & renderTarget.transformedRect();
+    if (clip.isEmpty()) {
+        return;
+    }
+
+    // the projection matrix maps the render rect, which starts at the render offset in device coordinates
+    const QPoint position = viewport.scaledRenderRect().topLeft() + data.deviceRect.topLeft() - viewport.renderOffset();
+    QMatrix4x4 mvp = viewport.projectionMatrix();
+    mvp.translate(position.x(), position.y());
+
+    GLShader *shader = ShaderManager::instance()->pushShader(ShaderTrait::MapTexture | ShaderTrait::TransformColorspace);
+    shader->setUniform(GLShader::Mat4Uniform::ModelViewProjectionMatrix, mvp);
+    shader->setColorspaceUniforms(ColorDescription::sRGB, renderTarget.colorDescription(), RenderingIntent::Perceptual);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+    glEnable(GL_SCISSOR_TEST);
+
+    atlas->texture->bind();
+    data.vertexBuffer->render(viewport.transform().map(clip, renderTarget.transformedSize()), GL_TRIANGLES, true);
+    atlas->texture->unbind();
+
+    glDisable(GL_SCISSOR_TEST);
+    glDisable(GL_BLEND);
+    ShaderManager::instance()->popShader();
+}
+
+void PerformanceHud::scheduleRepaints()
+{
+    for (auto &[view, data] : m_views) {
+        FrameTimingJournal *journal = view->backendOutput()->renderLoop()->frameTimings();
+        if (!journal || data.deviceRect.isEmpty()) {
+            continue;
+        }
+        // the frames caused by the HUD itself aren't worth another update
+        if (journal->lastSequence() > data.repaintSequence) {
+            data.repaintSequence = journal->lastSequence() + 1;
+            m_scene->addDeviceRepaint(view, data.deviceRect);
+        }
+    }
+}
+
+} // namespace KWin
+
+#include "moc_performancehud.cpp"
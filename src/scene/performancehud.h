@@ -0,0 +1,87 @@
+/*
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include "core/outputlayer.h"
+#include "core/rect.h"
+#include "core/region.h"
+
+#include <QObject>
+#include <QTimer>
+
+#include <chrono>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace KWin
+{
+
+class GLTexture;
+class GLVertexBuffer;
+class RenderTarget;
+class RenderView;
+class RenderViewport;
+class Scene;
+
+/**
+ * The PerformanceHud class draws the frame timings of an output in its top right corner:
+ * graphs of the render and GPU times of the last frames, the render time predicted by the
+ * RenderJournal, dropped frames and which output layers are scanned out directly. All of it
+ * is read from the FrameTimingJournal of the output and the statistics of its layers.
+ *
+ * Unlike the showfps effect, the HUD doesn't use QtQuick, so that it changes the timings
+ * it shows as little as possible. The text is drawn from a glyph atlas that is rasterized
+ * once, and the whole HUD is a single draw call in the primary layer. Its content is only
+ * rebuilt a few times per second, and it only repaints itself if frames other than the ones
+ * it caused have been presented since, so an idle output stays idle. Frames that are scanned
+ * out directly don't show the HUD, as drawing it would prevent the direct scanout.
+ */
+class PerformanceHud : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit PerformanceHud(Scene *scene);
+    ~PerformanceHud() override;
+
+    /**
+     * Returns the area the HUD covers on the @a view, in device coordinates. It's empty
+     * until the HUD has been painted on the view.
+     */
+    Rect deviceRect(RenderView *view) const;
+    void paint(RenderView *view, const RenderTarget &renderTarget, const RenderViewport &viewport, const Region &deviceRegion);
+
+private:
+    struct Atlas
+    {
+        std::unique_ptr<GLTexture> texture;
+        QSize cellSize;
+    };
+
+    struct ViewData
+    {
+        std::unique_ptr<GLVertexBuffer> vertexBuffer;
+        Rect deviceRect;
+        std::chrono::steady_clock::time_point lastUpdate;
+        // the repaints scheduled by the HUD cause a frame with this sequence number at the earliest
+        uint64_t repaintSequence = 0;
+        std::vector<OutputLayerStatistics> layerStatistics;
+        int scale = 0;
+    };
+
+    Atlas *atlas(int scale);
+    void update(RenderView *view, ViewData &data, const Atlas &atlas);
+    void scheduleRepaints();
+
+    Scene *m_scene;
+    QTimer m_timer;
+    std::unordered_map<int, Atlas> m_atlases;
+    std::unordered_map<RenderView *, ViewData> m_views;
+};
+
+} // namespace KWin
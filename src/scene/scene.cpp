@@ -503,16 +503,33 @@ RectF ItemTreeView::viewport() const
 
 SurfaceItem *ItemTreeView::scanoutCandidate() const
 {
-    if (dynamic_cast<SurfaceItem *>(m_item.get())) {
-        const bool visibleChildren = std::ranges::any_of(m_item->childItems(), [](Item *child) {
-            return child->isVisible();
-        });
-        if (visibleChildren) {
-            return {};
+    // items without contents of their own, like the cursor item, can be skipped
+    // as long as there is only a single surface below them
+    Item *item = m_item;
+    while (item && !dynamic_cast<SurfaceItem *>(item)) {
+        Item *visibleChild = nullptr;
+        const auto children = item->childItems();
+        for (Item *child : children) {
+            if (!child->isVisible()) {
+                continue;
+            }
+            if (visibleChild) {
+                return {};
+            }
+            visibleChild = child;
         }
-        return static_cast<SurfaceItem *>(m_item.get());
+        item = visibleChild;
+    }
+    if (!item) {
+        return {};
+    }
+    const bool visibleChildren = std::ranges::any_of(item->childItems(), [](Item *child) {
+        return child->isVisible();
+    });
+    if (visibleChildren) {
+        return {};
     }
-    return {};
+    return static_cast<SurfaceItem *>(item);
 }
 
 static void accumulateRepaints(Item *item, ItemTreeView *view, Region *repaints)
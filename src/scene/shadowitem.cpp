@@ -11,27 +11,34 @@
 #include "shadow.h"
 #include "window.h"
 
+#include <unordered_map>
+
 namespace KWin
 {
 
-class DecorationShadowTextureCache
+/**
+ * The ShadowTextureCache class shares the textures of shadows with the same images. Decorations
+ * usually give all windows the same shadow, and so do many clients, so most windows end up
+ * sharing a handful of textures. The textures are released once no item uses them anymore.
+ */
+class ShadowTextureCache
 {
 public:
-    ~DecorationShadowTextureCache();
-    DecorationShadowTextureCache(const DecorationShadowTextureCache &) = delete;
-    static DecorationShadowTextureCache &instance();
+    static ShadowTextureCache &instance();
 
-    void unregister(ShadowItem *shadowItem);
-    std::shared_ptr<NinePatch> ninePatch(ShadowItem *shadowItem);
+    std::shared_ptr<NinePatch> ninePatch(ItemRenderer *renderer, const QList<QImage> &images);
 
 private:
-    DecorationShadowTextureCache() = default;
-    struct Data
+    ShadowTextureCache() = default;
+    struct Entry
     {
-        std::shared_ptr<NinePatch> ninePatch;
-        QList<ShadowItem *> shadowItems;
+        ItemRenderer *renderer;
+        QList<QImage> images;
+        std::weak_ptr<NinePatch> ninePatch;
     };
-    QHash<KDecoration3::DecorationShadow *, Data> m_cache;
+    void removeExpired();
+
+    std::unordered_multimap<size_t, Entry> m_cache;
 };
 
 ShadowItem::ShadowItem(Shadow *shadow, Window *window, Item *parent)
@@ -53,10 +60,6 @@ ShadowItem::ShadowItem(Shadow *shadow, Window *window, Item *parent)
 
 ShadowItem::~ShadowItem()
 {
-    if (m_ninePatch) {
-        DecorationShadowTextureCache::instance().unregister(this);
-        m_ninePatch.reset();
-    }
 }
 
 Shadow *ShadowItem::shadow() const
@@ -330,82 +333,83 @@ void ShadowItem::preprocess()
 
     m_textureDirty = false;
 
+    QList<QImage> images;
     if (m_shadow->hasDecorationShadow()) {
-        m_ninePatch = DecorationShadowTextureCache::instance().ninePatch(this);
+        images = {m_shadow->decorationShadowImage()};
     } else {
-        m_ninePatch = scene()->renderer()->createNinePatch(m_shadow->shadowElement(Shadow::ShadowElementTopLeft),
-                                                           m_shadow->shadowElement(Shadow::ShadowElementTop),
-                                                           m_shadow->shadowElement(Shadow::ShadowElementTopRight),
-                                                           m_shadow->shadowElement(Shadow::ShadowElementRight),
-                                                           m_shadow->shadowElement(Shadow::ShadowElementBottomRight),
-                                                           m_shadow->shadowElement(Shadow::ShadowElementBottom),
-                                                           m_shadow->shadowElement(Shadow::ShadowElementBottomLeft),
-                                                           m_shadow->shadowElement(Shadow::ShadowElementLeft));
+        images = {
+            m_shadow->shadowElement(Shadow::ShadowElementTopLeft),
+            m_shadow->shadowElement(Shadow::ShadowElementTop),
+            m_shadow->shadowElement(Shadow::ShadowElementTopRight),
+            m_shadow->shadowElement(Shadow::ShadowElementRight),
+            m_shadow->shadowElement(Shadow::ShadowElementBottomRight),
+            m_shadow->shadowElement(Shadow::ShadowElementBottom),
+            m_shadow->shadowElement(Shadow::ShadowElementBottomLeft),
+            m_shadow->shadowElement(Shadow::ShadowElementLeft),
+        };
     }
+    m_ninePatch = ShadowTextureCache::instance().ninePatch(scene()->renderer(), images);
 }
 
 void ShadowItem::releaseResources()
 {
-    DecorationShadowTextureCache::instance().unregister(this);
     m_ninePatch.reset();
     m_textureDirty = true;
 }
 
-DecorationShadowTextureCache &DecorationShadowTextureCache::instance()
+ShadowTextureCache &ShadowTextureCache::instance()
 {
-    static DecorationShadowTextureCache s_instance;
+    static ShadowTextureCache s_instance;
     return s_instance;
 }
 
-DecorationShadowTextureCache::~DecorationShadowTextureCache()
+static size_t hashImages(const QList<QImage> &images)
 {
-    Q_ASSERT(m_cache.isEmpty());
+    size_t seed = 0;
+    for (const QImage &image : images) {
+        seed = qHashMulti(seed, image.width(), image.height(), image.format());
+        // the padding at the end of the scanlines can contain garbage
+        const qsizetype lineSize = (qsizetype(image.width()) * image.depth() + 7) / 8;
+        for (int y = 0; y < image.height(); ++y) {
+            seed = qHashBits(image.constScanLine(y), lineSize, seed);
+        }
+    }
+    return seed;
 }
 
-void DecorationShadowTextureCache::unregister(ShadowItem *shadowItem)
+void ShadowTextureCache::removeExpired()
 {
-    auto it = m_cache.begin();
-    while (it != m_cache.end()) {
-        auto &d = it.value();
-        // check whether the Vector of Shadows contains our shadow and remove all of them
-        auto glIt = d.shadowItems.begin();
-        while (glIt != d.shadowItems.end()) {
-            if (*glIt == shadowItem) {
-                glIt = d.shadowItems.erase(glIt);
-            } else {
-                glIt++;
-            }
-        }
-        // if there are no shadows any more we can erase the cache entry
-        if (d.shadowItems.isEmpty()) {
-            it = m_cache.erase(it);
-        } else {
-            it++;
-        }
-    }
+    std::erase_if(m_cache, [](const auto &entry) {
+        return entry.second.ninePatch.expired();
+    });
 }
 
-std::shared_ptr<NinePatch> DecorationShadowTextureCache::ninePatch(ShadowItem *shadowItem)
+std::shared_ptr<NinePatch> ShadowTextureCache::ninePatch(ItemRenderer *renderer, const QList<QImage> &images)
 {
-    Shadow *shadow = shadowItem->shadow();
-    Q_ASSERT(shadow->hasDecorationShadow());
-    unregister(shadowItem);
-    const auto decoShadow = shadow->decorationShadow().lock();
-    Q_ASSERT(decoShadow);
-    auto it = m_cache.find(decoShadow.get());
-    if (it != m_cache.end()) {
-        Q_ASSERT(!it.value().shadowItems.contains(shadowItem));
-        it.value().shadowItems << shadowItem;
-        return it.value().ninePatch;
+    removeExpired();
+
+    const size_t hash = hashImages(images);
+    const auto [begin, end] = m_cache.equal_range(hash);
+    for (auto it = begin; it != end; ++it) {
+        if (it->second.renderer == renderer && it->second.images == images) {
+            return it->second.ninePatch.lock();
+        }
+    }
+
+    std::shared_ptr<NinePatch> ninePatch;
+    if (images.size() == 1) {
+        ninePatch = renderer->createNinePatch(images[0]);
+    } else {
+        ninePatch = renderer->createNinePatch(images[0], images[1], images[2], images[3], images[4], images[5], images[6], images[7]);
     }
-    Data d;
-    d.shadowItems << shadowItem;
-    d.ninePatch = shadowItem->scene()->renderer()->createNinePatch(shadow->decorationShadowImage());
-    if (!d.ninePatch) {
-        return nullptr;
+    if (ninePatch) {
+        m_cache.emplace(hash, Entry{
+                                  .renderer = renderer,
+                                  .images = images,
+                                  .ninePatch = ninePatch,
+                              });
     }
-    m_cache.insert(decoShadow.get(), d);
-    return d.ninePatch;
+    return ninePatch;
 }
 
 } // namespace KWin
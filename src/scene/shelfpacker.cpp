@@ -0,0 +1,119 @@
+/*
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "scene/shelfpacker.h"
+
+#include <algorithm>
+
+namespace KWin
+{
+
+// the shelf heights are rounded, so that rectangles of similar height share shelves
+static constexpr int s_shelfAlignment = 8;
+
+ShelfPacker::ShelfPacker(const QSize &size)
+    : m_size(size)
+{
+}
+
+QSize ShelfPacker::size() const
+{
+    return m_size;
+}
+
+void ShelfPacker::grow(const QSize &size)
+{
+    Q_ASSERT(size.width() >= m_size.width() && size.height() >= m_size.height());
+    m_size = size;
+}
+
+std::optional<Rect> ShelfPacker::allocate(const QSize &size)
+{
+    if (size.isEmpty() || size.width() > m_size.width() || size.height() > m_size.height()) {
+        return std::nullopt;
+    }
+
+    Shelf *best = nullptr;
+    for (Shelf &shelf : m_shelves) {
+        if (shelf.count == 0 && shelf.height >= size.height()) {
+            // an empty shelf can be used for anything that fits
+            if (!best || shelf.height < best->height) {
+                best = &shelf;
+            }
+            continue;
+        }
+        if (shelf.height < size.height() || shelf.width + size.width() > m_size.width()) {
+            continue;
+        }
+        // don't put small rectangles on tall shelves, the space above them would be lost
+        if (shelf.height > size.height() * 2 && shelf.height - size.height() > s_shelfAlignment) {
+            continue;
+        }
+        if (!best || shelf.height < best->height) {
+            best = &shelf;
+        }
+    }
+
+    if (!best) {
+        const int y = m_shelves.empty() ? 0 : m_shelves.back().y + m_shelves.back().height;
+        const int height = std::min(m_size.height() - y, (size.height() + s_shelfAlignment - 1) / s_shelfAlignment * s_shelfAlignment);
+        if (height < size.height()) {
+            return std::nullopt;
+        }
+        best = &m_shelves.emplace_back(Shelf{
+            .y = y,
+            .height = height,
+        });
+    }
+
+    const Rect rect(QPoint(best->width, best->y), size);
+    best->width += size.width();
+    best->count++;
+    m_usedArea += qint64(size.width()) * size.height();
+    return rect;
+}
+
+void ShelfPacker::free(const Rect &rect)
+{
+    const auto it = std::ranges::find_if(m_shelves, [&rect](const Shelf &shelf) {
+        return shelf.y == rect.y();
+    });
+    Q_ASSERT(it != m_shelves.end() && it->count > 0);
+    if (it == m_shelves.end()) {
+        return;
+    }
+
+    m_usedArea -= qint64(rect.width()) * rect.height();
+    it->count--;
+    if (it->count == 0) {
+        it->width = 0;
+        // trailing empty shelves are given back, so that the space can be split differently
+        while (!m_shelves.empty() && m_shelves.back().count == 0) {
+            m_shelves.pop_back();
+        }
+    }
+}
+
+bool ShelfPacker::isEmpty() const
+{
+    return m_usedArea == 0;
+}
+
+qint64 ShelfPacker::usedArea() const
+{
+    return m_usedArea;
+}
+
+qreal ShelfPacker::fragmentation() const
+{
+    if (m_shelves.empty()) {
+        return 0;
+    }
+    const qint64 shelfArea = qint64(m_size.width()) * (m_shelves.back().y + m_shelves.back().height);
+    return 1.0 - qreal(m_usedArea) / shelfArea;
+}
+
+} // namespace KWin
@@ -0,0 +1,69 @@
+/*
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include "core/rect.h"
+#include "kwin_export.h"
+
+#include <optional>
+#include <vector>
+
+namespace KWin
+{
+
+/**
+ * The ShelfPacker class arranges rectangles in an area of a fixed width.
+ *
+ * The area is divided into shelves, horizontal strips that are filled from left to right. A
+ * rectangle is put on the shelf that wastes the least space, or on a new shelf if none of the
+ * existing shelves fit. A shelf becomes empty and can be reused for rectangles of a different
+ * height once all of its rectangles have been freed, the space of individual rectangles isn't
+ * reused otherwise. Callers that free lots of rectangles should check fragmentation() and
+ * arrange the remaining rectangles again.
+ */
+class KWIN_EXPORT ShelfPacker
+{
+public:
+    explicit ShelfPacker(const QSize &size);
+
+    QSize size() const;
+
+    /**
+     * Makes the area bigger. The existing rectangles keep their position.
+     */
+    void grow(const QSize &size);
+
+    std::optional<Rect> allocate(const QSize &size);
+    void free(const Rect &rect);
+
+    bool isEmpty() const;
+
+    /**
+     * Returns the area of the rectangles that haven't been freed.
+     */
+    qint64 usedArea() const;
+
+    /**
+     * Returns the fraction of the area taken by shelves that isn't used by any rectangle.
+     */
+    qreal fragmentation() const;
+
+private:
+    struct Shelf
+    {
+        int y;
+        int height;
+        int width = 0;
+        int count = 0;
+    };
+
+    QSize m_size;
+    std::vector<Shelf> m_shelves;
+    qint64 m_usedArea = 0;
+};
+
+} // namespace KWin
@@ -61,6 +61,19 @@ void SurfaceItem::setBufferReleasePoint(const std::shared_ptr<SyncReleasePoint>
     m_bufferReleasePoint = releasePoint;
 }
 
+const FileDescriptor &SurfaceItem::bufferAcquireFence()
+{
+    if (m_bufferAcquireFence.isValid() && m_bufferAcquireFence.isReadable()) {
+        m_bufferAcquireFence = FileDescriptor{};
+    }
+    return m_bufferAcquireFence;
+}
+
+void SurfaceItem::setBufferAcquireFence(FileDescriptor &&fence)
+{
+    m_bufferAcquireFence = std::move(fence);
+}
+
 RectF SurfaceItem::bufferSourceBox() const
 {
     return m_bufferSourceBox;
@@ -237,6 +250,11 @@ void SurfaceItem::setScanoutHint(DrmDevice *device, const FormatModifierMap &drm
 {
 }
 
+bool SurfaceItem::hasExplicitSync() const
+{
+    return false;
+}
+
 void SurfaceItem::freeze()
 {
 }
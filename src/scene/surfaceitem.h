@@ -39,6 +39,13 @@ public:
 
     void setBufferReleasePoint(const std::shared_ptr<SyncReleasePoint> &releasePoint);
 
+    /**
+     * Returns the fence that has to be waited for before the buffer is read, or an invalid
+     * file descriptor if the buffer is ready to be used
+     */
+    const FileDescriptor &bufferAcquireFence();
+    void setBufferAcquireFence(FileDescriptor &&fence);
+
     RectF bufferSourceBox() const;
     void setBufferSourceBox(const RectF &box);
 
@@ -60,6 +67,12 @@ public:
 
     virtual ContentType contentType() const;
     virtual void setScanoutHint(DrmDevice *device, const FormatModifierMap &drmFormats);
+    /**
+     * Returns whether the buffer has been committed with an explicit acquire point. The
+     * buffer is only attached after the acquire point has been signaled, so it doesn't
+     * need implicit synchronization anymore.
+     */
+    virtual bool hasExplicitSync() const;
 
     virtual void freeze();
 
@@ -92,6 +105,7 @@ protected:
     std::optional<std::chrono::nanoseconds> m_accumulatedTimeDiffs;
     std::optional<std::chrono::steady_clock::time_point> m_lastDamage;
     std::shared_ptr<SyncReleasePoint> m_bufferReleasePoint;
+    FileDescriptor m_bufferAcquireFence;
 };
 
 } // namespace KWin
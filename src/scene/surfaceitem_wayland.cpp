@@ -7,9 +7,12 @@
 #include "scene/surfaceitem_wayland.h"
 #include "core/backendoutput.h"
 #include "core/drmdevice.h"
+#include "core/output.h"
 #include "core/renderbackend.h"
+#include "core/renderloop.h"
 #include "texture.h"
 #include "wayland/linuxdmabufv1clientbuffer.h"
+#include "wayland/presentationtime.h"
 #include "wayland/subcompositor.h"
 #include "wayland/surface.h"
 #include "window.h"
@@ -21,6 +24,8 @@
 namespace KWin
 {
 
+static const bool s_lateFrameCallbacks = qEnvironmentVariableIntValue("KWIN_WAYLAND_LATE_FRAME_CALLBACKS") == 1;
+
 SurfaceItemWayland::SurfaceItemWayland(SurfaceInterface *surface, Item *parent)
     : SurfaceItem(parent)
     , m_surface(surface)
@@ -47,6 +52,7 @@ SurfaceItemWayland::SurfaceItemWayland(SurfaceInterface *surface, Item *parent)
     connect(surface, &SurfaceInterface::presentationModeHintChanged,
             this, &SurfaceItemWayland::handlePresentationModeHintChanged);
     connect(surface, &SurfaceInterface::bufferReleasePointChanged, this, &SurfaceItemWayland::handleReleasePointChanged);
+    connect(surface, &SurfaceInterface::bufferAcquireFenceChanged, this, &SurfaceItemWayland::handleAcquireFenceChanged);
     connect(surface, &SurfaceInterface::alphaMultiplierChanged, this, &SurfaceItemWayland::handleAlphaMultiplierChanged);
 
     connect(surface, &SurfaceInterface::mapped,
@@ -68,10 +74,15 @@ SurfaceItemWayland::SurfaceItemWayland(SurfaceInterface *surface, Item *parent)
     setBufferSourceBox(surface->bufferSourceBox());
     setBuffer(surface->buffer());
     m_bufferReleasePoint = m_surface->bufferReleasePoint();
+    setBufferAcquireFence(m_surface->bufferAcquireFence().duplicate());
     setColorDescription(surface->colorDescription());
     setRenderingIntent(surface->renderingIntent());
     setPresentationHint(surface->presentationModeHint());
     setOpacity(surface->alphaMultiplier());
+
+    m_frameCallbackTimer.setSingleShot(true);
+    m_frameCallbackTimer.setTimerType(Qt::PreciseTimer);
+    connect(&m_frameCallbackTimer, &QTimer::timeout, this, &SurfaceItemWayland::sendFrameCallbacks);
 }
 
 RegionF SurfaceItemWayland::shape() const
@@ -114,6 +125,19 @@ void SurfaceItemWayland::handleBufferTransformChanged()
 
 void SurfaceItemWayland::handleSurfaceCommitted()
 {
+    if (m_frameCallbacksSent) {
+        const auto renderTime = std::chrono::steady_clock::now() - *m_frameCallbacksSent;
+        m_frameCallbacksSent.reset();
+        // a client that took longer than a refresh cycle most likely wasn't rendering continuously
+        if (renderTime <= m_refreshDuration) {
+            // react quickly to the client getting slower, but only slowly to it getting faster
+            if (renderTime > m_clientRenderTime) {
+                m_clientRenderTime = renderTime;
+            } else {
+                m_clientRenderTime = (m_clientRenderTime * 7 + renderTime) / 8;
+            }
+        }
+    }
     if (m_surface->hasFrameCallbacks() || m_surface->hasFifoBarrier() || m_surface->hasPresentationFeedback()) {
         scheduleFrame();
     }
@@ -183,6 +207,12 @@ void SurfaceItemWayland::setScanoutHint(DrmDevice *device, const FormatModifierM
     }
 }
 
+bool SurfaceItemWayland::hasExplicitSync() const
+{
+    // linux-drm-syncobj-v1 requires an acquire point for every release point
+    return m_surface && m_surface->bufferReleasePoint();
+}
+
 void SurfaceItemWayland::freeze()
 {
     if (!m_surface) {
@@ -229,6 +259,11 @@ void SurfaceItemWayland::handleReleasePointChanged()
     }
 }
 
+void SurfaceItemWayland::handleAcquireFenceChanged()
+{
+    setBufferAcquireFence(m_surface->bufferAcquireFence().duplicate());
+}
+
 void SurfaceItemWayland::handleAlphaMultiplierChanged()
 {
     setOpacity(m_surface->alphaMultiplier());
@@ -239,15 +274,69 @@ void SurfaceItemWayland::handleFramePainted(LogicalOutput *output, OutputFrame *
     if (!m_surface) {
         return;
     }
-    m_surface->frameRendered(timestamp.count());
+    if (s_lateFrameCallbacks) {
+        scheduleFrameCallbacks(output, timestamp);
+    } else {
+        m_surface->frameRendered(timestamp.count());
+    }
     if (frame) {
         // FIXME make frame always valid
         if (auto feedback = m_surface->presentationFeedback(output)) {
+            frame->sharedFeedback<PresentationTimeFeedbackBatch>()->add(m_surface, std::move(feedback));
+        }
+        if (auto feedback = m_surface->takeCommitLatencyFeedback()) {
+            frame->addFeedback(std::move(feedback));
+        }
+        // the barrier is released by the page flip, which is when the next refresh cycle begins
+        if (auto feedback = m_surface->fifoBarrierFeedback(output)) {
             frame->addFeedback(std::move(feedback));
         }
+    } else {
+        m_surface->clearFifoBarrier();
+    }
+}
+
+void SurfaceItemWayland::scheduleFrameCallbacks(LogicalOutput *output, std::chrono::milliseconds timestamp)
+{
+    // leave some time for the client to actually submit the buffer and for the compositor to pick it up
+    constexpr std::chrono::milliseconds safetyMargin(1);
+
+    RenderLoop *renderLoop = output ? output->backendOutput()->renderLoop() : nullptr;
+    if (!renderLoop || !m_surface->hasFrameCallbacks()) {
+        if (m_frameCallbackTimer.isActive()) {
+            m_frameCallbackTimer.stop();
+        }
+        m_frameCallbackTimestamp = timestamp;
+        sendFrameCallbacks();
+        return;
+    }
+
+    // this is called while compositing, so the next presentation timestamp is the one of the current frame
+    m_refreshDuration = std::chrono::nanoseconds(1'000'000'000'000) / renderLoop->refreshRate();
+    const auto nextFrameStart = renderLoop->nextPresentationTimestamp() + m_refreshDuration - renderLoop->predictedRenderTime();
+    const auto deadline = nextFrameStart - m_clientRenderTime - safetyMargin;
+    const auto now = std::chrono::steady_clock::now().time_since_epoch();
+    const auto delay = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now);
+
+    m_frameCallbackTimestamp = timestamp;
+    if (delay <= std::chrono::milliseconds::zero()) {
+        m_frameCallbackTimer.stop();
+        sendFrameCallbacks();
+    } else if (!m_frameCallbackTimer.isActive() || m_frameCallbackTimer.remainingTimeAsDuration() > delay) {
+        // if the surface is shown on multiple outputs, the earliest deadline wins
+        m_frameCallbackTimer.start(delay);
+    }
+}
+
+void SurfaceItemWayland::sendFrameCallbacks()
+{
+    if (!m_surface) {
+        return;
+    }
+    if (s_lateFrameCallbacks && m_surface->hasFrameCallbacks()) {
+        m_frameCallbacksSent = std::chrono::steady_clock::now();
     }
-    // TODO only call this once per refresh cycle
-    m_surface->clearFifoBarrier(output ? std::optional(std::chrono::nanoseconds(1'000'000'000'000) / output->refreshRate()) : std::nullopt);
+    m_surface->frameRendered(m_frameCallbackTimestamp.count());
 }
 
 #if KWIN_BUILD_X11
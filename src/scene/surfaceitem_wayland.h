@@ -33,6 +33,7 @@ public:
     RegionF opaque() const override;
     ContentType contentType() const override;
     void setScanoutHint(DrmDevice *device, const FormatModifierMap &drmFormats) override;
+    bool hasExplicitSync() const override;
     void freeze() override;
 
     SurfaceInterface *surface() const;
@@ -51,13 +52,26 @@ private Q_SLOTS:
     void handleColorDescriptionChanged();
     void handlePresentationModeHintChanged();
     void handleReleasePointChanged();
+    void handleAcquireFenceChanged();
     void handleAlphaMultiplierChanged();
 
 private:
     SurfaceItemWayland *getOrCreateSubSurfaceItem(SubSurfaceInterface *s);
     void handleFramePainted(LogicalOutput *output, OutputFrame *frame, std::chrono::milliseconds timestamp) override;
+    void scheduleFrameCallbacks(LogicalOutput *output, std::chrono::milliseconds timestamp);
+    void sendFrameCallbacks();
 
     QPointer<SurfaceInterface> m_surface;
+    /**
+     * With late frame callbacks, the callbacks are sent as late as possible for the client
+     * to still make it in time for the next frame, based on how long it took the client to
+     * commit after the previous frame callbacks.
+     */
+    QTimer m_frameCallbackTimer;
+    std::chrono::milliseconds m_frameCallbackTimestamp = std::chrono::milliseconds::zero();
+    std::optional<std::chrono::steady_clock::time_point> m_frameCallbacksSent;
+    std::chrono::nanoseconds m_clientRenderTime = std::chrono::nanoseconds::zero();
+    std::chrono::nanoseconds m_refreshDuration = std::chrono::nanoseconds::zero();
     struct ScanoutFeedback
     {
         DrmDevice *device = nullptr;
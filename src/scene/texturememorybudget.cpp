@@ -0,0 +1,181 @@
+/*
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "scene/texturememorybudget.h"
+
+#include <QtEnvironmentVariables>
+
+#include <algorithm>
+
+namespace KWin
+{
+
+static size_t defaultBudget()
+{
+    bool ok = false;
+    const int mebibytes = qEnvironmentVariableIntValue("KWIN_TEXTURE_MEMORY_BUDGET", &ok);
+    return size_t(ok && mebibytes >= 0 ? mebibytes : 512) * 1024 * 1024;
+}
+
+TextureMemoryAllocation::TextureMemoryAllocation(TextureMemoryBudget *budget, const QString &owner, std::function<void()> &&evict)
+    : m_budget(budget)
+    , m_owner(owner)
+    , m_evict(std::move(evict))
+    , m_lastUsed(std::chrono::steady_clock::now())
+{
+}
+
+TextureMemoryAllocation::~TextureMemoryAllocation()
+{
+    if (m_budget) {
+        m_budget->remove(this);
+    }
+}
+
+QString TextureMemoryAllocation::owner() const
+{
+    return m_owner;
+}
+
+size_t TextureMemoryAllocation::size() const
+{
+    return m_size;
+}
+
+void TextureMemoryAllocation::setSize(size_t size)
+{
+    if (size) {
+        markUsed();
+    }
+    if (m_budget) {
+        m_budget->resize(this, size);
+    } else {
+        m_size = size;
+    }
+}
+
+std::chrono::steady_clock::time_point TextureMemoryAllocation::lastUsed() const
+{
+    return m_lastUsed;
+}
+
+void TextureMemoryAllocation::markUsed()
+{
+    m_lastUsed = std::chrono::steady_clock::now();
+}
+
+bool TextureMemoryAllocation::isEvictable() const
+{
+    return bool(m_evict);
+}
+
+TextureMemoryBudget::TextureMemoryBudget(std::optional<size_t> budget, std::chrono::milliseconds minimumAge)
+    : m_budget(budget.value_or(defaultBudget()))
+    , m_minimumAge(minimumAge)
+{
+}
+
+TextureMemoryBudget::~TextureMemoryBudget()
+{
+    for (TextureMemoryAllocation *allocation : m_allocations) {
+        allocation->m_budget = nullptr;
+    }
+}
+
+size_t TextureMemoryBudget::budget() const
+{
+    return m_budget;
+}
+
+void TextureMemoryBudget::setBudget(size_t budget)
+{
+    m_budget = budget;
+    evict();
+}
+
+std::chrono::milliseconds TextureMemoryBudget::minimumAge() const
+{
+    return m_minimumAge;
+}
+
+size_t TextureMemoryBudget::usage() const
+{
+    return m_usage;
+}
+
+std::map<QString, size_t> TextureMemoryBudget::usageByOwner() const
+{
+    std::map<QString, size_t> ret;
+    for (const TextureMemoryAllocation *allocation : m_allocations) {
+        ret[allocation->owner()] += allocation->size();
+    }
+    return ret;
+}
+
+std::unique_ptr<TextureMemoryAllocation> TextureMemoryBudget::track(const QString &owner, std::function<void()> evict)
+{
+    std::unique_ptr<TextureMemoryAllocation> allocation(new TextureMemoryAllocation(this, owner, std::move(evict)));
+    add(allocation.get());
+    return allocation;
+}
+
+void TextureMemoryBudget::add(TextureMemoryAllocation *allocation)
+{
+    m_allocations.push_back(allocation);
+}
+
+void TextureMemoryBudget::remove(TextureMemoryAllocation *allocation)
+{
+    m_usage -= allocation->m_size;
+    m_allocations.erase(std::find(m_allocations.begin(), m_allocations.end(), allocation));
+}
+
+void TextureMemoryBudget::resize(TextureMemoryAllocation *allocation, size_t size)
+{
+    m_usage = m_usage - allocation->m_size + size;
+    allocation->m_size = size;
+    if (m_usage > m_budget) {
+        evict();
+    }
+}
+
+void TextureMemoryBudget::evict()
+{
+    if (m_evicting || m_usage <= m_budget) {
+        return;
+    }
+    m_evicting = true;
+
+    const auto deadline = std::chrono::steady_clock::now() - m_minimumAge;
+    std::vector<TextureMemoryAllocation *> candidates;
+    for (TextureMemoryAllocation *allocation : m_allocations) {
+        if (allocation->isEvictable() && allocation->size() > 0 && allocation->lastUsed() <= deadline) {
+            candidates.push_back(allocation);
+        }
+    }
+    std::sort(candidates.begin(), candidates.end(), [](const TextureMemoryAllocation *a, const TextureMemoryAllocation *b) {
+        return a->lastUsed() < b->lastUsed();
+    });
+
+    for (TextureMemoryAllocation *candidate : candidates) {
+        if (m_usage <= m_budget) {
+            break;
+        }
+        // a previous eviction function might have destroyed the allocation
+        if (std::find(m_allocations.begin(), m_allocations.end(), candidate) == m_allocations.end()) {
+            continue;
+        }
+        const std::function<void()> evict = candidate->m_evict;
+        evict();
+        if (std::find(m_allocations.begin(), m_allocations.end(), candidate) != m_allocations.end()) {
+            resize(candidate, 0);
+        }
+    }
+
+    m_evicting = false;
+}
+
+} // namespace KWin
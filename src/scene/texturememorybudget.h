@@ -0,0 +1,122 @@
+/*
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include "kwin_export.h"
+
+#include <QString>
+
+#include <chrono>
+#include <functional>
+#include <map>
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace KWin
+{
+
+class TextureMemoryBudget;
+
+/**
+ * The TextureMemoryAllocation class represents GPU memory that is used by a cache or an
+ * offscreen render target. The owner reports the size of the memory with setSize() and
+ * should call markUsed() whenever the memory is used. Setting a non-zero size also marks
+ * the memory as used.
+ *
+ * If the allocation is evictable, the budget may call the eviction function to make the
+ * owner release the memory. The owner has to be able to recreate the contents on demand.
+ */
+class KWIN_EXPORT TextureMemoryAllocation
+{
+public:
+    ~TextureMemoryAllocation();
+
+    QString owner() const;
+    size_t size() const;
+    void setSize(size_t size);
+
+    std::chrono::steady_clock::time_point lastUsed() const;
+    void markUsed();
+
+    bool isEvictable() const;
+
+private:
+    TextureMemoryAllocation(TextureMemoryBudget *budget, const QString &owner, std::function<void()> &&evict);
+
+    TextureMemoryBudget *m_budget;
+    const QString m_owner;
+    const std::function<void()> m_evict;
+    size_t m_size = 0;
+    std::chrono::steady_clock::time_point m_lastUsed;
+
+    friend class TextureMemoryBudget;
+};
+
+/**
+ * The TextureMemoryBudget class keeps track of the GPU memory that is used by caches and
+ * offscreen render targets, such as window thumbnails, offscreen effect textures and blur
+ * textures.
+ *
+ * If the tracked memory exceeds the budget, the least recently used evictable allocations
+ * are released until the memory fits in the budget again. Allocations that have been used
+ * more recently than minimumAge() are never evicted, so the memory can still exceed the
+ * budget if everything is in use.
+ */
+class KWIN_EXPORT TextureMemoryBudget
+{
+public:
+    /**
+     * Constructs a budget of @a budget bytes. By default, the KWIN_TEXTURE_MEMORY_BUDGET
+     * environment variable specifies the budget in MiB, or 512 MiB are used if it's not set.
+     */
+    explicit TextureMemoryBudget(std::optional<size_t> budget = std::nullopt, std::chrono::milliseconds minimumAge = std::chrono::seconds(1));
+    ~TextureMemoryBudget();
+
+    size_t budget() const;
+    void setBudget(size_t budget);
+
+    std::chrono::milliseconds minimumAge() const;
+
+    /**
+     * Returns the total size of all allocations.
+     */
+    size_t usage() const;
+
+    /**
+     * Returns the total size of the allocations of each owner.
+     */
+    std::map<QString, size_t> usageByOwner() const;
+
+    /**
+     * Starts tracking memory of the given @a owner. If the @a evict function is provided, the
+     * allocation is evictable and the function will be called when the memory should be
+     * released. The size of the allocation is reset to zero after the function returns.
+     */
+    std::unique_ptr<TextureMemoryAllocation> track(const QString &owner, std::function<void()> evict = {});
+
+    /**
+     * Evicts the least recently used allocations until the memory fits in the budget,
+     * or there are no evictable allocations left.
+     */
+    void evict();
+
+private:
+    void add(TextureMemoryAllocation *allocation);
+    void remove(TextureMemoryAllocation *allocation);
+    void resize(TextureMemoryAllocation *allocation, size_t size);
+
+    std::vector<TextureMemoryAllocation *> m_allocations;
+    size_t m_budget;
+    size_t m_usage = 0;
+    const std::chrono::milliseconds m_minimumAge;
+    bool m_evicting = false;
+
+    friend class TextureMemoryAllocation;
+};
+
+} // namespace KWin
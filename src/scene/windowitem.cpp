@@ -21,6 +21,8 @@
 
 #include <KDecoration3/Decoration>
 
+#include <cmath>
+
 namespace KWin
 {
 
@@ -70,6 +72,81 @@ WindowItem::~WindowItem()
 {
 }
 
+WindowItem::RenderProperties WindowItem::RenderPropertiesTransition::valueAt(std::chrono::steady_clock::time_point time) const
+{
+    if (time >= start + duration) {
+        return to;
+    }
+    const qreal progress = easingCurve.valueForProgress(std::chrono::duration<qreal>(time - start) / duration);
+    return RenderProperties{
+        .opacity = std::lerp(from.opacity, to.opacity, progress),
+        .brightness = std::lerp(from.brightness, to.brightness, progress),
+        .saturation = std::lerp(from.saturation, to.saturation, progress),
+    };
+}
+
+void WindowItem::setRenderProperties(QObject *owner, const RenderProperties &properties, std::chrono::milliseconds duration, const QEasingCurve &easingCurve)
+{
+    const auto now = std::chrono::steady_clock::now();
+    auto it = std::ranges::find(m_renderProperties, owner, &RenderPropertiesTransition::owner);
+    if (it == m_renderProperties.end()) {
+        if (properties == RenderProperties{}) {
+            return;
+        }
+        connect(owner, &QObject::destroyed, this, [this, owner]() {
+            clearRenderProperties(owner);
+        });
+        m_renderProperties.push_back(RenderPropertiesTransition{
+            .owner = owner,
+        });
+        it = std::prev(m_renderProperties.end());
+    } else {
+        if (it->to == properties) {
+            return;
+        }
+        it->from = it->valueAt(now);
+    }
+    it->to = properties;
+    it->start = now;
+    it->duration = duration;
+    it->easingCurve = easingCurve;
+    scheduleRepaint(boundingRect());
+}
+
+void WindowItem::clearRenderProperties(QObject *owner)
+{
+    auto it = std::ranges::find(m_renderProperties, owner, &RenderPropertiesTransition::owner);
+    if (it != m_renderProperties.end()) {
+        disconnect(owner, &QObject::destroyed, this, nullptr);
+        m_renderProperties.erase(it);
+        scheduleRepaint(boundingRect());
+    }
+}
+
+WindowItem::RenderProperties WindowItem::renderProperties() const
+{
+    RenderProperties ret;
+    if (m_renderProperties.empty()) {
+        return ret;
+    }
+    const auto now = std::chrono::steady_clock::now();
+    for (const RenderPropertiesTransition &transition : m_renderProperties) {
+        const RenderProperties properties = transition.valueAt(now);
+        ret.opacity *= properties.opacity;
+        ret.brightness *= properties.brightness;
+        ret.saturation *= properties.saturation;
+    }
+    return ret;
+}
+
+bool WindowItem::isRenderPropertiesTransitionRunning() const
+{
+    const auto now = std::chrono::steady_clock::now();
+    return std::ranges::any_of(m_renderProperties, [now](const RenderPropertiesTransition &transition) {
+        return now < transition.start + transition.duration;
+    });
+}
+
 SurfaceItem *WindowItem::surfaceItem() const
 {
     return m_surfaceItem.get();
@@ -214,6 +291,8 @@ void WindowItem::addSurfaceItemDamageConnects(Item *item)
     connect(surfaceItem, &SurfaceItem::childAdded, this, &WindowItem::addSurfaceItemDamageConnects);
     connect(surfaceItem, &SurfaceItem::childRemoved, this, &WindowItem::markDamaged);
     connect(surfaceItem, &SurfaceItem::visibleChanged, this, &WindowItem::markDamaged);
+    // subsurfaces can be moved without any of the surfaces being damaged
+    connect(surfaceItem, &SurfaceItem::positionChanged, this, &WindowItem::markDamaged);
     const auto childItems = item->childItems();
     for (const auto &child : childItems) {
         addSurfaceItemDamageConnects(child);
@@ -250,6 +329,7 @@ void WindowItem::updateSurfacePosition()
 void WindowItem::updateBorderRadius()
 {
     m_windowContainer->setBorderRadius(m_window->borderRadius());
+    markDamaged();
 }
 
 void WindowItem::updateShadowItem()
@@ -261,8 +341,9 @@ void WindowItem::updateShadowItem()
         }
         m_shadowItem->stackBefore(m_windowContainer.get());
         markDamaged();
-    } else {
+    } else if (m_shadowItem) {
         m_shadowItem.reset();
+        markDamaged();
     }
 }
 
@@ -278,8 +359,9 @@ void WindowItem::updateDecorationItem()
         }
         connect(m_window->decoration(), &KDecoration3::Decoration::damaged, this, &WindowItem::markDamaged);
         markDamaged();
-    } else {
+    } else if (m_decorationItem) {
         m_decorationItem.reset();
+        markDamaged();
     }
 }
 
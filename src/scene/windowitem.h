@@ -10,6 +10,10 @@
 
 #include "scene/item.h"
 
+#include <QEasingCurve>
+
+#include <chrono>
+
 namespace KDecoration3
 {
 
@@ -47,6 +51,21 @@ public:
         PAINT_DISABLED_BY_ACTIVITY = 1 << 3,
     };
 
+    /**
+     * The RenderProperties type describes how the window is modulated when it's painted.
+     * Unlike the adjustments that effects make in paintWindow(), render properties persist
+     * between frames, so effects that only dim or fade windows don't need to be part of
+     * the paint chain.
+     */
+    struct RenderProperties
+    {
+        qreal opacity = 1;
+        qreal brightness = 1;
+        qreal saturation = 1;
+
+        bool operator==(const RenderProperties &other) const = default;
+    };
+
     ~WindowItem() override;
 
     SurfaceItem *surfaceItem() const;
@@ -62,6 +81,19 @@ public:
     void elevate();
     void deelevate();
 
+    /**
+     * Sets the render properties requested by @a owner. The render properties of all owners
+     * are multiplied. If @a duration is not zero, the scene animates from the current render
+     * properties of the owner to the new ones.
+     */
+    void setRenderProperties(QObject *owner, const RenderProperties &properties, std::chrono::milliseconds duration = std::chrono::milliseconds::zero(), const QEasingCurve &easingCurve = QEasingCurve::InOutSine);
+    void clearRenderProperties(QObject *owner);
+    /**
+     * Returns the combined render properties of all owners at the current time.
+     */
+    RenderProperties renderProperties() const;
+    bool isRenderPropertiesTransitionRunning() const;
+
 protected:
     explicit WindowItem(Window *window, Item *parent = nullptr);
     void updateSurfaceItem(std::unique_ptr<SurfaceItem> &&surfaceItem);
@@ -84,6 +116,18 @@ private:
     void markDamaged();
     void freeze();
 
+    struct RenderPropertiesTransition
+    {
+        QObject *owner;
+        RenderProperties from;
+        RenderProperties to;
+        std::chrono::steady_clock::time_point start;
+        std::chrono::milliseconds duration;
+        QEasingCurve easingCurve;
+
+        RenderProperties valueAt(std::chrono::steady_clock::time_point time) const;
+    };
+
     Window *m_window;
     std::unique_ptr<SurfaceItem> m_surfaceItem;
     std::unique_ptr<DecorationItem> m_decorationItem;
@@ -94,6 +138,7 @@ private:
     int m_forceVisibleByDesktopCount = 0;
     int m_forceVisibleByMinimizeCount = 0;
     int m_forceVisibleByActivityCount = 0;
+    std::vector<RenderPropertiesTransition> m_renderProperties;
 };
 
 #if KWIN_BUILD_X11
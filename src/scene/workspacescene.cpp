@@ -58,19 +58,26 @@
 #include "core/graphicsbufferview.h"
 #include "core/output.h"
 #include "core/pixelgrid.h"
+#include "core/regiontrace.h"
 #include "core/renderbackend.h"
 #include "core/renderloop.h"
 #include "core/renderviewport.h"
 #include "cursoritem.h"
 #include "effect/effecthandler.h"
+#include "ftrace.h"
 #include "opengl/eglbackend.h"
 #include "opengl/eglcontext.h"
+#include "opengl/glframebuffer.h"
+#include "opengl/glgpuprofiler.h"
+#include "opengl/gltexture.h"
 #include "scene/backgroundeffectitem.h"
 #include "scene/decorationitem.h"
 #include "scene/dndiconitem.h"
 #include "scene/itemrenderer.h"
+#include "scene/performancehud.h"
 #include "scene/rootitem.h"
 #include "scene/surfaceitem.h"
+#include "scene/texturememorybudget.h"
 #include "scene/windowitem.h"
 #include "utils/envvar.h"
 #include "wayland/seat.h"
@@ -83,6 +90,9 @@
 #include <QAction>
 #include <QtMath>
 
+#include <algorithm>
+#include <optional>
+
 namespace KWin
 {
 
@@ -90,21 +100,43 @@ namespace KWin
 // Scene
 //****************************************
 
+static const bool s_throttleOccludedWindows = qEnvironmentVariable("KWIN_THROTTLE_OCCLUDED_WINDOWS") != QLatin1String("0");
+static constexpr std::chrono::milliseconds s_occludedFrameInterval(100);
+static const bool s_backgroundCacheEnabled = qEnvironmentVariable("KWIN_SCENE_BACKGROUND_CACHE") != QLatin1String("0");
+// with fewer windows, painting them is about as cheap as copying the cache
+static constexpr qsizetype s_minimumCachedWindows = 2;
+static constexpr int s_backgroundCacheStableFrames = 3;
+
 WorkspaceScene::WorkspaceScene()
     : m_containerItem(std::make_unique<RootItem>(this))
     , m_overlayItem(std::make_unique<RootItem>(this))
     , m_cursorItem(std::make_unique<CursorItem>(m_overlayItem.get()))
+    , m_textureMemoryBudget(std::make_unique<TextureMemoryBudget>())
 {
     setGeometry(workspace()->geometry());
     connect(workspace(), &Workspace::geometryChanged, this, [this]() {
         setGeometry(workspace()->geometry());
     });
 
+    connect(this, &Scene::viewRemoved, this, [this](RenderView *view) {
+        m_backgroundCaches.remove(view);
+        m_occludedFrameTimes.remove(view);
+    });
+
     connect(waylandServer()->seat(), &SeatInterface::dragStarted, this, &WorkspaceScene::createDndIconItem);
     connect(waylandServer()->seat(), &SeatInterface::dragEnded, this, &WorkspaceScene::destroyDndIconItem);
 
     // make sure it's over the dnd icon
     m_cursorItem->setZ(1);
+
+    // Record the regions that are painted so they can be replayed in the Region benchmarks.
+    const QString regionTraceFile = qEnvironmentVariable("KWIN_SCENE_REGION_TRACE");
+    if (!regionTraceFile.isEmpty()) {
+        m_regionTrace = std::make_unique<RegionTraceWriter>(regionTraceFile);
+        if (!m_regionTrace->isValid()) {
+            m_regionTrace.reset();
+        }
+    }
     connect(Cursors::self(), &Cursors::hiddenChanged, this, &WorkspaceScene::updateCursor);
     connect(Cursors::self(), &Cursors::positionChanged, this, &WorkspaceScene::updateCursor);
     updateCursor();
@@ -118,6 +150,19 @@ WorkspaceScene::WorkspaceScene()
     connect(toggleAction, &QAction::triggered, this, [this]() {
         setLayerDebugging(!m_layerDebugging);
     });
+
+    QAction *hudAction = new QAction(this);
+    hudAction->setProperty("componentName", QStringLiteral("kwin"));
+    hudAction->setObjectName("Toggle Performance HUD");
+    hudAction->setText(i18n("Toggle Performance HUD"));
+    KGlobalAccel::self()->setDefaultShortcut(hudAction, QList<QKeySequence>());
+    KGlobalAccel::self()->setShortcut(hudAction, QList<QKeySequence>());
+    connect(hudAction, &QAction::triggered, this, [this]() {
+        setPerformanceHudEnabled(!m_performanceHud);
+    });
+    if (environmentVariableBoolValue("KWIN_PERFORMANCE_HUD").value_or(false)) {
+        setPerformanceHudEnabled(true);
+    }
 }
 
 WorkspaceScene::~WorkspaceScene()
@@ -137,6 +182,11 @@ void WorkspaceScene::detachRenderer()
     releaseResources(m_containerItem.get());
     releaseResources(m_overlayItem.get());
     releaseResources(m_cursorItem.get());
+    m_backgroundCaches.clear();
+    if (m_performanceHud) {
+        // drop the textures and buffers while the context is still current
+        m_performanceHud = std::make_unique<PerformanceHud>(this);
+    }
 
     m_renderer.reset();
 }
@@ -516,11 +566,63 @@ double WorkspaceScene::desiredHdrHeadroom() const
     return maxHeadroom;
 }
 
+QSet<Item *> WorkspaceScene::throttledWindows(SceneView *delegate, std::chrono::milliseconds frameTime)
+{
+    QSet<Item *> throttled;
+    if (!s_throttleOccludedWindows || (m_paintContext.mask & (PAINT_SCREEN_TRANSFORMED | PAINT_SCREEN_WITH_TRANSFORMED_WINDOWS))) {
+        m_occludedFrameTimes.remove(delegate);
+        return throttled;
+    }
+
+    // Windows that are completely covered by opaque windows above them only get frame callbacks
+    // every now and then, so that clients animating in the background don't keep redrawing at
+    // the refresh rate of the output. Windows that are shown elsewhere, e.g. in a thumbnail
+    // or a screencast, keep getting all of them
+    const QHash<Item *, std::chrono::milliseconds> previous = m_occludedFrameTimes.take(delegate);
+    QHash<Item *, std::chrono::milliseconds> &frameTimes = m_occludedFrameTimes[delegate];
+    Region opaque;
+    for (const Phase2Data &data : m_paintContext.phase2Data | std::views::reverse) {
+        if (!opaque.isEmpty() && !(data.mask & PAINT_WINDOW_TRANSFORMED) && !data.item->window()->isOffscreenRendering()) {
+            const Rect deviceBounds = delegate->mapToDeviceCoordinatesAligned(data.item->mapToView(data.item->boundingRect(), delegate));
+            if (opaque.contains(deviceBounds)) {
+                const auto it = previous.constFind(data.item);
+                if (it != previous.constEnd() && frameTime - *it < s_occludedFrameInterval) {
+                    throttled.insert(data.item);
+                    frameTimes.insert(data.item, *it);
+                } else {
+                    frameTimes.insert(data.item, frameTime);
+                }
+            }
+        }
+        if (!(data.mask & (PAINT_WINDOW_TRANSLUCENT | PAINT_WINDOW_TRANSFORMED))) {
+            opaque += data.deviceOpaque;
+        }
+    }
+    return throttled;
+}
+
 void WorkspaceScene::frame(SceneView *delegate, OutputFrame *frame)
 {
     LogicalOutput *logicalOutput = delegate->logicalOutput();
     const auto frameTime = std::chrono::duration_cast<std::chrono::milliseconds>(logicalOutput->backendOutput()->renderLoop()->lastPresentationTimestamp());
-    m_containerItem->framePainted(delegate, logicalOutput, frame, frameTime);
+    const QSet<Item *> throttled = throttledWindows(delegate, frameTime);
+    if (throttled.isEmpty()) {
+        m_containerItem->framePainted(delegate, logicalOutput, frame, frameTime);
+    } else {
+        // items may get deleted while handling the frame, see Item::framePainted()
+        QList<QPointer<Item>> windowItems;
+        const auto childItems = m_containerItem->childItems();
+        for (Item *childItem : childItems) {
+            if (!throttled.contains(childItem)) {
+                windowItems.push_back(childItem);
+            }
+        }
+        for (const QPointer<Item> &windowItem : std::as_const(windowItems)) {
+            if (windowItem && windowItem->explicitVisible() && workspace()->outputAt(windowItem->mapToScene(windowItem->boundingRect()).center()) == logicalOutput) {
+                windowItem->framePainted(delegate, logicalOutput, frame, frameTime);
+            }
+        }
+    }
     if (m_overlayItem) {
         m_overlayItem->framePainted(delegate, logicalOutput, frame, frameTime);
     }
@@ -528,6 +630,7 @@ void WorkspaceScene::frame(SceneView *delegate, OutputFrame *frame)
 
 void WorkspaceScene::prePaint(SceneView *delegate, OutputFrame *frame)
 {
+    fTraceDuration("Scene prePaint");
     painted_delegate = delegate;
     painted_screen = painted_delegate->logicalOutput();
 
@@ -549,6 +652,7 @@ void WorkspaceScene::prePaint(SceneView *delegate, OutputFrame *frame)
     m_paintContext.deviceDamage = painted_delegate->mapToDeviceCoordinatesAligned(prePaintData.paint) & painted_delegate->deviceRect();
     m_paintContext.mask = prePaintData.mask;
     m_paintContext.phase2Data.clear();
+    m_paintContext.staticWindows = 0;
 
     if (m_paintContext.mask & (PAINT_SCREEN_TRANSFORMED | PAINT_SCREEN_WITH_TRANSFORMED_WINDOWS)) {
         preparePaintGenericScreen();
@@ -571,12 +675,20 @@ static void resetRepaintsHelper(Item *item, SceneView *delegate)
 
 static void accumulateRepaints(Item *item, SceneView *view, Region *windowRepaints, Region *accumulatedRepaints, Region *forceTranslucent)
 {
+    // most of the scene is idle in a typical frame, don't visit subtrees without repaints
+    if (!item->hasDirtySubtree(view)) {
+        return;
+    }
+
     const auto childItems = item->sortedChildItems();
     auto childIt = childItems.begin();
     for (; childIt != childItems.end() && (*childIt)->z() < 0; childIt++) {
         accumulateRepaints(*childIt, view, windowRepaints, accumulatedRepaints, forceTranslucent);
     }
+    // background effect items depend on the repaints of the items below them, they have to be visited every time
+    bool clean = true;
     if (auto background = qobject_cast<BackgroundEffectItem *>(item)) {
+        clean = false;
         const Rect viewRect = view->mapToDeviceCoordinates(item->mapToView(item->rect(), view)).rounded();
         if (accumulatedRepaints->intersects(viewRect)) {
             *windowRepaints |= viewRect;
@@ -594,6 +706,14 @@ static void accumulateRepaints(Item *item, SceneView *view, Region *windowRepain
     for (; childIt != childItems.end(); childIt++) {
         accumulateRepaints(*childIt, view, windowRepaints, accumulatedRepaints, forceTranslucent);
     }
+
+    // items that are not rendered in this view keep their repaints
+    clean = clean && !item->hasRepaints(view) && std::ranges::none_of(childItems, [view](Item *child) {
+        return child->hasDirtySubtree(view);
+    });
+    if (clean) {
+        item->markSubtreeClean(view);
+    }
 }
 
 void WorkspaceScene::preparePaintGenericScreen()
@@ -603,6 +723,9 @@ void WorkspaceScene::preparePaintGenericScreen()
 
         WindowPrePaintData data;
         data.mask = m_paintContext.mask;
+        if (windowItem->renderProperties().opacity != 1.0) {
+            data.setTranslucent();
+        }
 
         effects->prePaintWindow(painted_delegate, windowItem->effectWindow(), data);
         m_paintContext.phase2Data.append(Phase2Data{
@@ -616,14 +739,21 @@ void WorkspaceScene::preparePaintGenericScreen()
 
 static void addOpaqueRegionRecursive(SceneView *view, Item *item, const std::optional<ClipCorner> &parentCorner, Region &ret)
 {
-    const std::optional<ClipCorner> corner = calculateClipCorner(item, parentCorner);
-    RegionF opaque = item->opaque();
-    if (corner.has_value()) {
-        opaque = corner->radius.clip(item->opaque(), corner->box);
+    // Hidden and translucent items, and all their children, don't cover what's below them
+    if (!item->isVisible() || item->opacity() != 1.0) {
+        return;
     }
-    const Rect deviceRect = view->mapToDeviceCoordinates(item->mapToView(item->rect(), view)).rounded();
-    for (const RectF &rect : opaque.rects()) {
-        ret |= view->mapToDeviceCoordinates(item->mapToView(rect, view)).rounded() & deviceRect;
+    const std::optional<ClipCorner> corner = calculateClipCorner(item, parentCorner);
+    // Neither do items that are not painted in this view, unless a hole is punched for them
+    if (view->shouldRenderItem(item) || view->shouldRenderHole(item)) {
+        RegionF opaque = item->opaque();
+        if (corner.has_value()) {
+            opaque = corner->radius.clip(item->opaque(), corner->box);
+        }
+        const Rect deviceRect = view->mapToDeviceCoordinates(item->mapToView(item->rect(), view)).rounded();
+        for (const RectF &rect : opaque.rects()) {
+            ret |= view->mapToDeviceCoordinates(item->mapToView(rect, view)).rounded() & deviceRect;
+        }
     }
     const auto children = item->childItems();
     for (Item *child : children) {
@@ -637,12 +767,20 @@ void WorkspaceScene::preparePaintSimpleScreen()
         Window *window = windowItem->window();
         WindowPrePaintData data;
         data.mask = m_paintContext.mask;
+        if (windowItem->renderProperties().opacity != 1.0) {
+            data.setTranslucent();
+        }
 
         effects->prePaintWindow(painted_delegate, windowItem->effectWindow(), data);
 
+        // With several outputs, most windows are not on the painted one. Their opaque
+        // region doesn't occlude anything in this view, so don't spend time collecting it
         Region opaque;
         if (window->opacity() == 1.0 && !(data.mask & PAINT_WINDOW_TRANSLUCENT)) {
-            addOpaqueRegionRecursive(painted_delegate, windowItem, std::nullopt, opaque);
+            const Rect deviceBounds = painted_delegate->mapToDeviceCoordinatesAligned(windowItem->mapToView(windowItem->boundingRect(), painted_delegate));
+            if (deviceBounds.intersects(painted_delegate->deviceRect())) {
+                addOpaqueRegionRecursive(painted_delegate, windowItem, std::nullopt, opaque);
+            }
         }
         m_paintContext.phase2Data.append(Phase2Data{
             .item = windowItem,
@@ -657,6 +795,11 @@ Region WorkspaceScene::collectDamage()
 {
     if (m_paintContext.mask & (PAINT_SCREEN_TRANSFORMED | PAINT_SCREEN_WITH_TRANSFORMED_WINDOWS)) {
         resetRepaintsHelper(m_overlayItem.get(), painted_delegate);
+        // the repaints of the windows have been dropped, the cache can't tell whether it's still up to date
+        if (auto it = m_backgroundCaches.find(painted_delegate); it != m_backgroundCaches.end()) {
+            (*it)->valid = false;
+            (*it)->stableFrames = 0;
+        }
         m_paintContext.deviceDamage = painted_delegate->deviceRect();
         return m_paintContext.deviceDamage;
     } else {
@@ -667,6 +810,7 @@ Region WorkspaceScene::collectDamage()
             data.deviceOpaque -= forceTranslucent;
             accumulateRepaints(data.item, painted_delegate, &data.deviceRegion, &accumulatedRepaints, &forceTranslucent);
         }
+        updateBackgroundCache();
         accumulateRepaints(m_overlayItem.get(), painted_delegate, &m_paintContext.deviceDamage, &accumulatedRepaints, &forceTranslucent);
 
         // Perform an occlusion cull pass, to remove surface damage occluded by opaque windows.
@@ -675,37 +819,68 @@ Region WorkspaceScene::collectDamage()
         for (auto &paintData : m_paintContext.phase2Data | std::views::reverse) {
             m_paintContext.deviceDamage |= paintData.deviceRegion - opaque;
 
-            // TODO make occlusion culling per item, rather than per window
-            const bool canCover = painted_delegate->shouldRenderItem(paintData.item->surfaceItem())
-                || painted_delegate->shouldRenderHole(paintData.item->surfaceItem());
-            if (!(paintData.mask & (PAINT_WINDOW_TRANSLUCENT | PAINT_WINDOW_TRANSFORMED)) && canCover) {
+            if (!(paintData.mask & (PAINT_WINDOW_TRANSLUCENT | PAINT_WINDOW_TRANSFORMED))) {
                 opaque += paintData.deviceOpaque;
             }
         }
 
+        if (m_performanceHud) {
+            // the HUD is translucent, it has to be painted over fresh content as a whole
+            const Rect hudRect = m_performanceHud->deviceRect(painted_delegate);
+            if (m_paintContext.deviceDamage.intersects(hudRect)) {
+                m_paintContext.deviceDamage |= hudRect;
+            }
+        }
+
         return m_paintContext.deviceDamage & painted_delegate->deviceRect();
     }
 }
 
 void WorkspaceScene::postPaint()
 {
+    fTraceDuration("Scene postPaint");
     effects->postPaintScreen();
 
+    for (WindowItem *windowItem : std::as_const(stacking_order)) {
+        if (windowItem->isRenderPropertiesTransitionRunning()) {
+            windowItem->scheduleRepaint(windowItem->boundingRect());
+        }
+    }
+
     painted_delegate = nullptr;
     painted_screen = nullptr;
     clearStackingOrder();
+
+    if (m_renderer) {
+        m_renderer->frameArena()->reset();
+    }
 }
 
 void WorkspaceScene::paint(const RenderTarget &renderTarget, const QPoint &deviceOffset, const Region &deviceRegion)
 {
+    fTraceDuration("Scene paint");
     RenderViewport viewport(painted_delegate->viewport(), painted_delegate->scale(), renderTarget, deviceOffset);
 
     m_renderer->beginFrame(renderTarget, viewport);
 
-    if (!effects->paintScreen(renderTarget, viewport, m_paintContext.mask, deviceRegion, painted_screen)) {
+    if (m_regionTrace) {
+        m_regionTrace->beginFrame(deviceRegion);
+    }
+
+    const bool painted = effects->paintScreen(renderTarget, viewport, m_paintContext.mask, deviceRegion, painted_screen);
+
+    if (m_regionTrace) {
+        m_regionTrace->endFrame();
+    }
+
+    if (!painted) {
         return;
     }
 
+    if (m_performanceHud) {
+        m_performanceHud->paint(painted_delegate, renderTarget, viewport, deviceRegion);
+    }
+
     Q_EMIT frameRendered();
     m_renderer->endFrame();
 }
@@ -714,26 +889,28 @@ void WorkspaceScene::paint(const RenderTarget &renderTarget, const QPoint &devic
 bool WorkspaceScene::finalPaintScreen(const RenderTarget &renderTarget, const RenderViewport &viewport, int mask, const Region &deviceRegion, LogicalOutput *screen)
 {
     if (mask & (PAINT_SCREEN_TRANSFORMED | PAINT_SCREEN_WITH_TRANSFORMED_WINDOWS)) {
-        return paintGenericScreen(renderTarget, viewport, mask, screen);
+        return paintGenericScreen(renderTarget, viewport, mask, deviceRegion, screen);
     } else {
         return paintSimpleScreen(renderTarget, viewport, mask, deviceRegion);
     }
 }
 
 // The generic painting code that can handle even transformations.
-// It simply paints bottom-to-top.
-bool WorkspaceScene::paintGenericScreen(const RenderTarget &renderTarget, const RenderViewport &viewport, int, LogicalOutput *screen)
+// It simply paints bottom-to-top. The painted region is only limited by effects
+// that know which part of the screen is going to be used, like zoom.
+bool WorkspaceScene::paintGenericScreen(const RenderTarget &renderTarget, const RenderViewport &viewport, int, const Region &deviceRegion, LogicalOutput *screen)
 {
-    m_renderer->renderBackground(renderTarget, viewport, Region::infinite());
+    const Region clip = deviceRegion.contains(viewport.deviceRect()) ? Region::infinite() : deviceRegion;
+    m_renderer->renderBackground(renderTarget, viewport, clip);
 
     for (const Phase2Data &paintData : std::as_const(m_paintContext.phase2Data)) {
-        if (!paintWindow(renderTarget, viewport, paintData.item, paintData.mask, paintData.deviceRegion)) {
+        if (!paintWindow(renderTarget, viewport, paintData.item, paintData.mask, paintData.deviceRegion & clip)) {
             return false;
         }
     }
 
     const Rect bounds = viewport.mapToDeviceCoordinates(m_overlayItem->mapToScene(m_overlayItem->boundingRect())).toRect();
-    return m_renderer->renderItem(renderTarget, viewport, m_overlayItem.get(), PAINT_SCREEN_TRANSFORMED, bounds, WindowPaintData{}, [this](Item *item) {
+    return m_renderer->renderItem(renderTarget, viewport, m_overlayItem.get(), PAINT_SCREEN_TRANSFORMED, clip & bounds, WindowPaintData{}, [this](Item *item) {
         return !painted_delegate->shouldRenderItem(item);
     }, [this](Item *item) {
         return painted_delegate->shouldRenderHole(item);
@@ -745,27 +922,46 @@ bool WorkspaceScene::paintGenericScreen(const RenderTarget &renderTarget, const
 // to reduce painting and improve performance.
 bool WorkspaceScene::paintSimpleScreen(const RenderTarget &renderTarget, const RenderViewport &viewport, int, const Region &deviceRegion)
 {
+    const qsizetype cachedWindows = paintBackgroundCache(renderTarget, viewport);
+
     // This is the occlusion culling pass
     Region visible = deviceRegion;
-    for (int i = m_paintContext.phase2Data.size() - 1; i >= 0; --i) {
+    for (int i = m_paintContext.phase2Data.size() - 1; i >= cachedWindows; --i) {
         Phase2Data *data = &m_paintContext.phase2Data[i];
         data->deviceRegion = visible & viewport.deviceRect();
 
+        Rect deviceBounds = viewport.deviceRect();
+        Region deviceOccluder;
         if (!(data->mask & PAINT_WINDOW_TRANSFORMED)) {
-            data->deviceRegion &= viewport.mapToDeviceCoordinatesAligned(data->item->mapToScene(data->item->boundingRect()));
+            deviceBounds = viewport.mapToDeviceCoordinatesAligned(data->item->mapToScene(data->item->boundingRect()));
+            data->deviceRegion &= deviceBounds;
 
-            // TODO change effects API, so occlusion culling is per item, rather than per window
-            const bool canCover = painted_delegate->shouldRenderItem(data->item->surfaceItem())
-                || painted_delegate->shouldRenderHole(data->item->surfaceItem());
-            if (!(data->mask & PAINT_WINDOW_TRANSLUCENT) && canCover) {
+            // TODO change effects API, so that effects can make single items translucent
+            if (!(data->mask & PAINT_WINDOW_TRANSLUCENT)) {
                 visible -= data->deviceOpaque;
+                deviceOccluder = data->deviceOpaque;
             }
         }
+
+        if (m_regionTrace) {
+            m_regionTrace->addWindow(deviceBounds, deviceOccluder);
+        }
     }
 
-    m_renderer->renderBackground(renderTarget, viewport, visible);
+    if (cachedWindows) {
+        // the cache has the background and the windows below, copy what's not covered by the windows above
+        const BackgroundCache *cache = m_backgroundCaches.value(painted_delegate).get();
+        GLFramebuffer::pushFramebuffer(cache->framebuffer.get());
+        for (const Rect &deviceRect : (visible & viewport.deviceRect()).rects()) {
+            const Rect bufferRect = viewport.transform().map(deviceRect, renderTarget.transformedSize());
+            renderTarget.framebuffer()->blitFromFramebuffer(bufferRect, bufferRect, GL_NEAREST);
+        }
+        GLFramebuffer::popFramebuffer();
+    } else {
+        m_renderer->renderBackground(renderTarget, viewport, visible);
+    }
 
-    for (const Phase2Data &paintData : std::as_const(m_paintContext.phase2Data)) {
+    for (const Phase2Data &paintData : std::as_const(m_paintContext.phase2Data) | std::views::drop(cachedWindows)) {
         if (!paintWindow(renderTarget, viewport, paintData.item, paintData.mask, paintData.deviceRegion)) {
             return false;
         }
@@ -784,6 +980,139 @@ bool WorkspaceScene::paintSimpleScreen(const RenderTarget &renderTarget, const R
     }
 }
 
+static bool startsWith(const auto &phase2Data, qsizetype count, const auto &windows)
+{
+    if (windows.size() > count) {
+        return false;
+    }
+    for (qsizetype i = 0; i < windows.size(); ++i) {
+        if (windows[i].item != phase2Data[i].item || windows[i].mask != phase2Data[i].mask) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void WorkspaceScene::updateBackgroundCache()
+{
+    qsizetype staticWindows = 0;
+    for (const Phase2Data &data : std::as_const(m_paintContext.phase2Data)) {
+        if (!data.deviceRegion.isEmpty() || (data.mask & PAINT_WINDOW_TRANSFORMED)) {
+            break;
+        }
+        ++staticWindows;
+    }
+    m_paintContext.staticWindows = staticWindows;
+
+    auto it = m_backgroundCaches.find(painted_delegate);
+    if (it == m_backgroundCaches.end()) {
+        if (!s_backgroundCacheEnabled || staticWindows < s_minimumCachedWindows) {
+            return;
+        }
+        it = m_backgroundCaches.insert(painted_delegate, std::make_shared<BackgroundCache>());
+    }
+
+    BackgroundCache *cache = it->get();
+    if (cache->valid && !startsWith(m_paintContext.phase2Data, staticWindows, cache->windows)) {
+        cache->valid = false;
+    }
+
+    if (staticWindows < s_minimumCachedWindows) {
+        cache->candidates.clear();
+        cache->stableFrames = 0;
+    } else if (cache->candidates.size() == staticWindows && startsWith(m_paintContext.phase2Data, staticWindows, cache->candidates)) {
+        ++cache->stableFrames;
+    } else {
+        cache->candidates.clear();
+        for (const Phase2Data &data : std::as_const(m_paintContext.phase2Data) | std::views::take(staticWindows)) {
+            cache->candidates.append(CachedWindow{
+                .item = data.item,
+                .mask = data.mask,
+            });
+        }
+        cache->stableFrames = 1;
+    }
+}
+
+qsizetype WorkspaceScene::paintBackgroundCache(const RenderTarget &renderTarget, const RenderViewport &viewport)
+{
+    if (m_regionTrace || !renderTarget.framebuffer() || !renderTarget.texture() || !EglContext::currentContext()->supportsBlits()) {
+        return 0;
+    }
+    const auto it = m_backgroundCaches.constFind(painted_delegate);
+    if (it == m_backgroundCaches.constEnd()) {
+        return 0;
+    }
+    BackgroundCache *cache = it->get();
+
+    GLTexture *targetTexture = renderTarget.texture();
+    const bool compatible = cache->texture
+        && cache->texture->size() == renderTarget.size()
+        && cache->texture->internalFormat() == targetTexture->internalFormat()
+        && cache->texture->contentTransform() == renderTarget.transform()
+        && cache->renderRect == viewport.renderRect()
+        && cache->scale == viewport.scale()
+        && cache->renderOffset == viewport.renderOffset()
+        && cache->colorDescription == renderTarget.colorDescription();
+    if (cache->valid && compatible) {
+        cache->memory->markUsed();
+        return cache->windows.size();
+    }
+    cache->valid = false;
+    if (cache->stableFrames < s_backgroundCacheStableFrames) {
+        return 0;
+    }
+
+    if (!cache->texture || cache->texture->size() != renderTarget.size() || cache->texture->internalFormat() != targetTexture->internalFormat()) {
+        cache->framebuffer.reset();
+        cache->texture = GLTexture::allocate(targetTexture->internalFormat(), renderTarget.size());
+        if (!cache->texture) {
+            m_backgroundCaches.erase(it);
+            return 0;
+        }
+        cache->framebuffer = std::make_unique<GLFramebuffer>(cache->texture.get());
+        if (!cache->framebuffer->valid()) {
+            m_backgroundCaches.erase(it);
+            return 0;
+        }
+    }
+    if (!cache->memory) {
+        cache->memory = m_textureMemoryBudget->track(QStringLiteral("BackgroundCache"), [cache]() {
+            cache->framebuffer.reset();
+            cache->texture.reset();
+            cache->valid = false;
+        });
+    }
+    const int bytesPerPixel = targetTexture->internalFormat() == GL_RGBA16F ? 8 : 4;
+    cache->memory->setSize(size_t(renderTarget.size().width()) * renderTarget.size().height() * bytesPerPixel);
+    cache->texture->setContentTransform(renderTarget.transform());
+
+    const RenderTarget cacheTarget(cache->framebuffer.get(), renderTarget.colorDescription());
+    const RenderViewport cacheViewport(viewport.renderRect(), viewport.scale(), cacheTarget, viewport.renderOffset());
+    const Rect deviceRect = cacheViewport.deviceRect();
+
+    GLFramebuffer::pushFramebuffer(cache->framebuffer.get());
+    const qsizetype windowCount = cache->candidates.size();
+    m_renderer->renderBackground(cacheTarget, cacheViewport, Region::infinite());
+    for (const Phase2Data &paintData : std::as_const(m_paintContext.phase2Data) | std::views::take(windowCount)) {
+        const Rect deviceBounds = cacheViewport.mapToDeviceCoordinatesAligned(paintData.item->mapToScene(paintData.item->boundingRect()));
+        if (!paintWindow(cacheTarget, cacheViewport, paintData.item, paintData.mask, deviceBounds & deviceRect)) {
+            GLFramebuffer::popFramebuffer();
+            cache->stableFrames = 0;
+            return 0;
+        }
+    }
+    GLFramebuffer::popFramebuffer();
+
+    cache->windows = cache->candidates;
+    cache->renderRect = viewport.renderRect();
+    cache->scale = viewport.scale();
+    cache->renderOffset = viewport.renderOffset();
+    cache->colorDescription = renderTarget.colorDescription();
+    cache->valid = true;
+    return windowCount;
+}
+
 void WorkspaceScene::createStackingOrder()
 {
     QList<Item *> items = m_containerItem->sortedChildItems();
@@ -813,7 +1142,16 @@ bool WorkspaceScene::paintWindow(const RenderTarget &renderTarget, const RenderV
         return true;
     }
 
+    std::optional<GLGpuProfilerScope> profilerScope;
+    if (GLGpuProfiler::isEnabled()) {
+        profilerScope.emplace(item->window()->caption());
+    }
+
     WindowPaintData data;
+    const WindowItem::RenderProperties properties = item->renderProperties();
+    data.multiplyOpacity(properties.opacity);
+    data.multiplyBrightness(properties.brightness);
+    data.multiplySaturation(properties.saturation);
     return effects->paintWindow(renderTarget, viewport, item->effectWindow(), mask, deviceRegion, data);
 }
 
@@ -843,6 +1181,11 @@ EglContext *WorkspaceScene::openglContext() const
     return nullptr;
 }
 
+TextureMemoryBudget *WorkspaceScene::textureMemoryBudget() const
+{
+    return m_textureMemoryBudget.get();
+}
+
 bool WorkspaceScene::animationsSupported() const
 {
     const auto context = openglContext();
@@ -861,6 +1204,22 @@ void WorkspaceScene::setLayerDebugging(bool enable)
     addRepaintFull();
 }
 
+void WorkspaceScene::setPerformanceHudEnabled(bool enable)
+{
+    if (bool(m_performanceHud) == enable) {
+        return;
+    }
+    if (enable) {
+        m_performanceHud = std::make_unique<PerformanceHud>(this);
+    } else {
+        if (auto context = openglContext()) {
+            context->makeCurrent();
+        }
+        m_performanceHud.reset();
+    }
+    addRepaintFull();
+}
+
 } // namespace
 
 #include "moc_workspacescene.cpp"
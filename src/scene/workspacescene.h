@@ -12,13 +12,25 @@
 #include "core/renderviewport.h"
 #include "scene/scene.h"
 
+#include <QHash>
+#include <QPointer>
+#include <QSet>
+
+#include <chrono>
+
 namespace KWin
 {
 
 class DragAndDropIconItem;
 class EffectWindow;
 class EglContext;
+class GLFramebuffer;
+class GLTexture;
 class Item;
+class PerformanceHud;
+class RegionTraceWriter;
+class TextureMemoryAllocation;
+class TextureMemoryBudget;
 class WindowItem;
 class WindowPaintData;
 class CursorItem;
@@ -57,6 +69,12 @@ public:
 
     EglContext *openglContext() const;
 
+    /**
+     * Returns the budget that caches and offscreen render targets should account their
+     * GPU memory against.
+     */
+    TextureMemoryBudget *textureMemoryBudget() const;
+
     /**
      * Whether the Scene is able to drive animations.
      * This is used as a hint to the effects system which effects can be supported.
@@ -66,6 +84,10 @@ public:
     bool animationsSupported() const;
 
     void setLayerDebugging(bool enable);
+    /**
+     * Shows the frame timings of every output in its top right corner, see PerformanceHud.
+     */
+    void setPerformanceHudEnabled(bool enable);
 
 Q_SIGNALS:
     void preFrameRender();
@@ -80,7 +102,7 @@ protected:
     // shared implementation of painting the screen in the generic
     // (unoptimized) way
     void preparePaintGenericScreen();
-    [[nodiscard]] bool paintGenericScreen(const RenderTarget &renderTarget, const RenderViewport &viewport, int mask, LogicalOutput *screen);
+    [[nodiscard]] bool paintGenericScreen(const RenderTarget &renderTarget, const RenderViewport &viewport, int mask, const Region &deviceRegion, LogicalOutput *screen);
     // shared implementation of painting the screen in an optimized way
     void preparePaintSimpleScreen();
     [[nodiscard]] bool paintSimpleScreen(const RenderTarget &renderTarget, const RenderViewport &viewport, int mask, const Region &deviceRegion);
@@ -105,6 +127,8 @@ protected:
         Region deviceDamage;
         int mask = 0;
         QList<Phase2Data> phase2Data;
+        // the number of windows at the bottom of the stack that have no repaints
+        qsizetype staticWindows = 0;
     };
 
     // The screen that is being currently painted
@@ -118,13 +142,50 @@ private:
     void createDndIconItem();
     void destroyDndIconItem();
     void updateCursor();
+    QSet<Item *> throttledWindows(SceneView *delegate, std::chrono::milliseconds frameTime);
+    void updateBackgroundCache();
+    qsizetype paintBackgroundCache(const RenderTarget &renderTarget, const RenderViewport &viewport);
+
+    struct CachedWindow
+    {
+        QPointer<WindowItem> item;
+        int mask = 0;
+    };
+
+    /**
+     * The BackgroundCache type holds the background and the windows at the bottom of the
+     * stack of a view, rendered into an offscreen texture. When the windows above them are
+     * repainted, the cache is blitted instead of painting the background and the windows
+     * below again. The cache is only built once the same windows have had no repaints for a
+     * few frames in a row, and it's invalidated as soon as any of them gets repainted.
+     */
+    struct BackgroundCache
+    {
+        std::unique_ptr<GLTexture> texture;
+        std::unique_ptr<GLFramebuffer> framebuffer;
+        std::unique_ptr<TextureMemoryAllocation> memory;
+        QList<CachedWindow> windows;
+        QList<CachedWindow> candidates;
+        int stableFrames = 0;
+        RectF renderRect;
+        qreal scale = 1;
+        QPoint renderOffset;
+        std::shared_ptr<ColorDescription> colorDescription;
+        bool valid = false;
+    };
 
     PaintContext m_paintContext;
     std::unique_ptr<Item> m_containerItem;
     std::unique_ptr<Item> m_overlayItem;
     std::unique_ptr<DragAndDropIconItem> m_dndIcon;
     std::unique_ptr<CursorItem> m_cursorItem;
+    std::unique_ptr<RegionTraceWriter> m_regionTrace;
+    std::unique_ptr<PerformanceHud> m_performanceHud;
+    std::unique_ptr<TextureMemoryBudget> m_textureMemoryBudget;
     bool m_layerDebugging = false;
+    // when the occluded windows of each view last got their frame callbacks
+    QHash<RenderView *, QHash<Item *, std::chrono::milliseconds>> m_occludedFrameTimes;
+    QHash<RenderView *, std::shared_ptr<BackgroundCache>> m_backgroundCaches;
 };
 
 } // namespace
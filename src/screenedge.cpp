@@ -282,13 +282,14 @@ bool Edge::activatesForTouchGesture() const
 
 bool Edge::triggersFor(const QPoint &cursorPos) const
 {
-    if (isBlocked()) {
+    // the geometry is checked first, it's much cheaper than activatesForPointer()
+    if (!m_geometry.contains(cursorPos)) {
         return false;
     }
-    if (!activatesForPointer()) {
+    if (isBlocked()) {
         return false;
     }
-    if (!m_geometry.contains(cursorPos)) {
+    if (!activatesForPointer()) {
         return false;
     }
     if (isLeft() && cursorPos.x() != m_geometry.x()) {
@@ -1402,11 +1403,18 @@ bool ScreenEdges::inApproachGeometry(const QPoint &pos) const
 
 void ScreenEdges::handlePointerMotion(const QPointF &pos, std::chrono::microseconds timestamp)
 {
+    const QPoint point = pos.toPoint();
     bool activatedForClient = false;
     for (const auto &edge : m_edges) {
         if (!edge->isReserved() || edge->isBlocked()) {
             continue;
         }
+        if (!edge->isApproaching() && !edge->approachGeometry().contains(point) && !edge->geometry().contains(point)) {
+            // most of the motion happens far away from the edges, the edge can neither be
+            // approached nor be triggered, it only needs to know that the cursor moved away
+            edge->check(point, timestamp);
+            continue;
+        }
         if (!edge->activatesForPointer()) {
             if (edge->isApproaching()) {
                 edge->stopApproaching();
@@ -1419,7 +1427,7 @@ void ScreenEdges::handlePointerMotion(const QPointF &pos, std::chrono::microseco
             }
             continue;
         }
-        if (edge->approachGeometry().contains(pos.toPoint())) {
+        if (edge->approachGeometry().contains(point)) {
             if (!edge->isApproaching()) {
                 edge->startApproaching();
             } else {
@@ -1431,7 +1439,7 @@ void ScreenEdges::handlePointerMotion(const QPointF &pos, std::chrono::microseco
             }
         }
         // always send event to all edges so that they can update their state
-        if (edge->check(pos.toPoint(), timestamp)) {
+        if (edge->check(point, timestamp)) {
             if (edge->client()) {
                 activatedForClient = true;
             }
@@ -1440,7 +1448,7 @@ void ScreenEdges::handlePointerMotion(const QPointF &pos, std::chrono::microseco
     if (activatedForClient) {
         for (const auto &edge : m_edges) {
             if (edge->client()) {
-                edge->markAsTriggered(pos.toPoint(), timestamp);
+                edge->markAsTriggered(point, timestamp);
             }
         }
     }
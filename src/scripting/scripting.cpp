@@ -55,6 +55,8 @@
 #include <QStandardPaths>
 #include <QtConcurrentRun>
 
+#include <algorithm>
+
 #include "scriptadaptor.h"
 
 static QRect scriptValueToQRect(const QJSValue &value)
@@ -126,6 +128,11 @@ void KWin::AbstractScript::stop()
     deleteLater();
 }
 
+QString KWin::AbstractScript::profile() const
+{
+    return QString();
+}
+
 KWin::ScriptTimer::ScriptTimer(QObject *parent)
     : QTimer(parent)
 {
@@ -274,7 +281,56 @@ void KWin::Script::slotScriptLoadedFromFile()
     )"));
     Q_ASSERT(!result.isError());
 
+    if (qEnvironmentVariableIntValue("KWIN_SCRIPT_PROFILING") == 1) {
+        // signals are connected with Function.prototype.connect(), wrap the handlers so
+        // the time spent in them shows up in the profile
+        result = m_engine->evaluate(QStringLiteral(R"(
+            (function (script) {
+                const connect = Function.prototype.connect;
+                const disconnect = Function.prototype.disconnect;
+                if (typeof connect !== "function" || typeof disconnect !== "function") {
+                    return;
+                }
+                const wrappers = new WeakMap();
+                function wrap(signal, handler, create) {
+                    if (typeof handler !== "function") {
+                        return handler;
+                    }
+                    const name = (signal.name || "signal") + " -> " + (handler.name || "anonymous function");
+                    let wrappersByName = wrappers.get(handler);
+                    if (!wrappersByName) {
+                        wrappersByName = new Map();
+                        wrappers.set(handler, wrappersByName);
+                    }
+                    let wrapper = wrappersByName.get(name);
+                    if (!wrapper && create) {
+                        wrapper = function (...args) {
+                            script.profiledCall(name, handler, this, args);
+                        };
+                        wrappersByName.set(name, wrapper);
+                    }
+                    return wrapper || handler;
+                }
+                Function.prototype.connect = function (receiver, handler) {
+                    if (handler === undefined) {
+                        return connect.call(this, wrap(this, receiver, true));
+                    }
+                    return connect.call(this, receiver, wrap(this, handler, true));
+                };
+                Function.prototype.disconnect = function (receiver, handler) {
+                    if (handler === undefined) {
+                        return disconnect.call(this, wrap(this, receiver, false));
+                    }
+                    return disconnect.call(this, receiver, wrap(this, handler, false));
+                };
+            })
+        )")).call({self});
+        Q_ASSERT(!result.isError());
+    }
+
+    const auto evaluationStart = std::chrono::steady_clock::now();
     result = m_engine->evaluate(QString::fromUtf8(watcher->result()), fileName());
+    addProfileSample(QStringLiteral("startup"), std::chrono::steady_clock::now() - evaluationStart);
     if (result.isError()) {
         qCWarning(KWIN_SCRIPTING, "%s:%d: error: %s", qPrintable(fileName()),
                   result.property(QStringLiteral("lineNumber")).toInt(),
@@ -293,6 +349,60 @@ void KWin::Script::slotScriptLoadedFromFile()
     m_starting = false;
 }
 
+void KWin::Script::addProfileSample(const QString &name, std::chrono::nanoseconds duration)
+{
+    ProfileEntry &entry = m_profile[name];
+    entry.calls++;
+    entry.duration += duration;
+}
+
+QJSValue KWin::Script::callProfiled(const QString &name, const QJSValue &callback, const QJSValueList &arguments)
+{
+    const auto start = std::chrono::steady_clock::now();
+    const QJSValue result = QJSValue(callback).call(arguments);
+    addProfileSample(name, std::chrono::steady_clock::now() - start);
+    return result;
+}
+
+void KWin::Script::profiledCall(const QString &name, const QJSValue &function, const QJSValue &thisObject, const QJSValue &arguments)
+{
+    QJSValueList jsArguments;
+    const int length = arguments.property(QStringLiteral("length")).toInt();
+    jsArguments.reserve(length);
+    for (int i = 0; i < length; ++i) {
+        jsArguments << arguments.property(i);
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    const QJSValue result = QJSValue(function).callWithInstance(thisObject, jsArguments);
+    addProfileSample(name, std::chrono::steady_clock::now() - start);
+
+    if (result.isError()) {
+        qCWarning(KWIN_SCRIPTING, "%s:%d: error: %s", qPrintable(fileName()),
+                  result.property(QStringLiteral("lineNumber")).toInt(),
+                  qPrintable(result.property(QStringLiteral("message")).toString()));
+    }
+}
+
+QString KWin::Script::profile() const
+{
+    std::vector<std::pair<QString, ProfileEntry>> entries(m_profile.begin(), m_profile.end());
+    std::sort(entries.begin(), entries.end(), [](const auto &a, const auto &b) {
+        return a.second.duration > b.second.duration;
+    });
+
+    QString result;
+    for (const auto &[name, entry] : entries) {
+        const double total = std::chrono::duration<double, std::milli>(entry.duration).count();
+        result += QStringLiteral("%1: %2 calls, %3 ms total, %4 ms average\n")
+                      .arg(name)
+                      .arg(entry.calls)
+                      .arg(total, 0, 'f', 3)
+                      .arg(total / entry.calls, 0, 'f', 3);
+    }
+    return result;
+}
+
 QVariant KWin::Script::readConfig(const QString &key, const QVariant &defaultValue)
 {
     return config().readEntry(key, defaultValue);
@@ -349,13 +459,16 @@ void KWin::Script::callDBus(const QString &service, const QString &path, const Q
     QDBusMessage message = QDBusMessage::createMethodCall(service, path, interface, method);
     message.setArguments(dbusArguments);
 
+    const QString profileName = QStringLiteral("callDBus %1 %2.%3").arg(service, interface, method);
+    const auto start = std::chrono::steady_clock::now();
     const QDBusPendingCall call = QDBusConnection::sessionBus().asyncCall(message);
+    addProfileSample(profileName, std::chrono::steady_clock::now() - start);
     if (callback.isUndefined()) {
         return;
     }
 
     QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(call, this);
-    connect(watcher, &QDBusPendingCallWatcher::finished, this, [this, callback](QDBusPendingCallWatcher *self) {
+    connect(watcher, &QDBusPendingCallWatcher::finished, this, [this, callback, profileName](QDBusPendingCallWatcher *self) {
         self->deleteLater();
 
         if (self->isError()) {
@@ -369,7 +482,7 @@ void KWin::Script::callDBus(const QString &service, const QString &path, const Q
             arguments << m_engine->toScriptValue(dbusToVariant(variant));
         }
 
-        QJSValue(callback).call(arguments);
+        callProfiled(profileName + QLatin1String(" reply"), callback, arguments);
     });
 }
 
@@ -388,7 +501,7 @@ bool KWin::Script::registerShortcut(const QString &objectName, const QString &te
     KGlobalAccel::self()->setShortcut(action, {shortcut});
 
     connect(action, &QAction::triggered, this, [this, action, callback]() {
-        QJSValue(callback).call({m_engine->toScriptValue(action)});
+        callProfiled(QLatin1String("shortcut ") + action->objectName(), callback, {m_engine->toScriptValue(action)});
     });
 
     return true;
@@ -438,8 +551,8 @@ bool KWin::Script::registerTouchScreenEdge(int edge, const QJSValue &callback)
     workspace()->screenEdges()->reserveTouch(KWin::ElectricBorder(edge), action);
     m_touchScreenEdgeCallbacks.insert(edge, action);
 
-    connect(action, &QAction::triggered, this, [callback]() {
-        QJSValue(callback).call();
+    connect(action, &QAction::triggered, this, [this, edge, callback]() {
+        callProfiled(QStringLiteral("touch screen edge %1").arg(edge), callback);
     });
 
     return true;
@@ -472,8 +585,8 @@ QList<QAction *> KWin::Script::actionsForUserActionMenu(KWin::Window *client, QM
     QList<QAction *> actions;
     actions.reserve(m_userActionsMenuCallbacks.count());
 
-    for (QJSValue callback : std::as_const(m_userActionsMenuCallbacks)) {
-        const QJSValue result = callback.call({m_engine->toScriptValue(client)});
+    for (const QJSValue &callback : std::as_const(m_userActionsMenuCallbacks)) {
+        const QJSValue result = callProfiled(QStringLiteral("user actions menu"), callback, {m_engine->toScriptValue(client)});
         if (result.isError()) {
             continue;
         }
@@ -494,9 +607,9 @@ bool KWin::Script::slotBorderActivated(ElectricBorder border)
     if (callbacks.isEmpty()) {
         return false;
     }
-    std::for_each(callbacks.begin(), callbacks.end(), [](QJSValue callback) {
-        callback.call();
-    });
+    for (const QJSValue &callback : callbacks) {
+        callProfiled(QStringLiteral("screen edge %1").arg(int(border)), callback);
+    }
     return true;
 }
 
@@ -680,7 +793,12 @@ KWin::Scripting::Scripting(QObject *parent)
     m_qmlEngine->rootContext()->setContextObject(new KLocalizedQmlContext(m_qmlEngine));
     init();
     QDBusConnection::sessionBus().registerObject(QStringLiteral("/Scripting"), this, QDBusConnection::ExportScriptableContents | QDBusConnection::ExportScriptableInvokables);
-    connect(Workspace::self(), &Workspace::configChanged, this, &Scripting::start);
+    connect(Workspace::self(), &Workspace::configChanged, this, [this]() {
+        // only the enabled state of the scripts decides which of them have to be loaded
+        if (Workspace::self()->isConfigGroupChanged(QStringLiteral("Plugins"))) {
+            start();
+        }
+    });
     connect(Workspace::self(), &Workspace::workspaceInitialized, this, &Scripting::start);
 }
 
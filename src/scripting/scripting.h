@@ -22,6 +22,9 @@
 #include <QDBusContext>
 #include <QDBusMessage>
 
+#include <chrono>
+#include <map>
+
 class QQmlComponent;
 class QQmlContext;
 class QQmlEngine;
@@ -69,6 +72,11 @@ public:
 public Q_SLOTS:
     void stop();
     virtual void run() = 0;
+    /**
+     * Returns a human readable summary of how much time the script spent in the callbacks
+     * invoked by KWin, or an empty string if the script doesn't support profiling.
+     */
+    virtual QString profile() const;
 
 Q_SIGNALS:
     void runningChanged(bool);
@@ -188,8 +196,16 @@ public:
      */
     QList<QAction *> actionsForUserActionMenu(Window *client, QMenu *parent);
 
+    /**
+     * Calls the @p function with the given @p arguments and adds the time it took to the
+     * profile of the script under the given @p name. If KWIN_SCRIPT_PROFILING is set, the
+     * signal handlers connected by the script are invoked through this function.
+     */
+    Q_INVOKABLE void profiledCall(const QString &name, const QJSValue &function, const QJSValue &thisObject, const QJSValue &arguments);
+
 public Q_SLOTS:
     void run() override;
+    QString profile() const override;
 
 private Q_SLOTS:
     /**
@@ -244,7 +260,17 @@ private:
      */
     QAction *createMenu(const QString &title, const QJSValue &items, QMenu *parent);
 
+    QJSValue callProfiled(const QString &name, const QJSValue &callback, const QJSValueList &arguments = {});
+    void addProfileSample(const QString &name, std::chrono::nanoseconds duration);
+
+    struct ProfileEntry
+    {
+        quint64 calls = 0;
+        std::chrono::nanoseconds duration = std::chrono::nanoseconds::zero();
+    };
+
     QJSEngine *m_engine;
+    std::map<QString, ProfileEntry> m_profile;
     QDBusMessage m_invocationContext;
     bool m_starting;
     QHash<int, QJSValueList> m_screenEdgeCallbacks;
@@ -20,6 +20,10 @@ WindowModel::WindowModel(QObject *parent)
     connect(workspace(), &Workspace::windowAdded, this, &WindowModel::handleWindowAdded);
     connect(workspace(), &Workspace::windowRemoved, this, &WindowModel::handleWindowRemoved);
 
+    m_flushTimer.setSingleShot(true);
+    m_flushTimer.setInterval(0);
+    connect(&m_flushTimer, &QTimer::timeout, this, &WindowModel::flush);
+
     m_windows = workspace()->windows();
     for (Window *window : std::as_const(m_windows)) {
         setupWindowConnections(window);
@@ -28,8 +32,56 @@ WindowModel::WindowModel(QObject *parent)
 
 void WindowModel::markRoleChanged(Window *window, int role)
 {
-    const QModelIndex row = index(m_windows.indexOf(window), 0);
-    Q_EMIT dataChanged(row, row, {role});
+    if (m_addedWindows.contains(window)) {
+        return;
+    }
+    QList<int> &roles = m_changedRoles[window];
+    if (!roles.contains(role)) {
+        roles.append(role);
+    }
+    scheduleFlush();
+}
+
+void WindowModel::scheduleFlush()
+{
+    if (!m_flushTimer.isActive()) {
+        m_flushTimer.start();
+    }
+}
+
+void WindowModel::flush()
+{
+    if (!m_addedWindows.isEmpty()) {
+        beginInsertRows(QModelIndex(), m_windows.count(), m_windows.count() + m_addedWindows.count() - 1);
+        m_windows.append(m_addedWindows);
+        m_addedWindows.clear();
+        endInsertRows();
+    }
+
+    if (!m_changedRoles.isEmpty()) {
+        // a single change spanning all affected rows is a lot cheaper for proxy models and
+        // views than one change per row, even if it covers some unchanged rows as well
+        int first = m_windows.count();
+        int last = -1;
+        QList<int> roles;
+        for (const auto &[window, windowRoles] : m_changedRoles.asKeyValueRange()) {
+            const int row = m_windows.indexOf(window);
+            if (row == -1) {
+                continue;
+            }
+            first = std::min(first, row);
+            last = std::max(last, row);
+            for (int role : windowRoles) {
+                if (!roles.contains(role)) {
+                    roles.append(role);
+                }
+            }
+        }
+        m_changedRoles.clear();
+        if (last != -1) {
+            Q_EMIT dataChanged(index(first, 0), index(last, 0), roles);
+        }
+    }
 }
 
 void WindowModel::setupWindowConnections(Window *window)
@@ -47,15 +99,20 @@ void WindowModel::setupWindowConnections(Window *window)
 
 void WindowModel::handleWindowAdded(Window *window)
 {
-    beginInsertRows(QModelIndex(), m_windows.count(), m_windows.count());
-    m_windows.append(window);
-    endInsertRows();
+    m_addedWindows.append(window);
+    scheduleFlush();
 
     setupWindowConnections(window);
 }
 
 void WindowModel::handleWindowRemoved(Window *window)
 {
+    disconnect(window, nullptr, this, nullptr);
+    if (m_addedWindows.removeOne(window)) {
+        return;
+    }
+    m_changedRoles.remove(window);
+
     const int index = m_windows.indexOf(window);
     Q_ASSERT(index != -1);
 
@@ -11,6 +11,7 @@
 #include <QAbstractListModel>
 #include <QPointer>
 #include <QSortFilterProxyModel>
+#include <QTimer>
 
 #include <optional>
 
@@ -34,6 +35,10 @@ class LogicalOutput;
  * \li activity (list<string>)
  * \endlist
  *
+ * Added windows and role changes are batched and reported once control returns to the
+ * event loop, so a burst of changes, e.g. after an output has been unplugged, causes at
+ * most one row insertion and one data change per consumer.
+ *
  * \sa WindowFilterModel
  */
 class WindowModel : public QAbstractListModel
@@ -56,12 +61,17 @@ public:
 
 private:
     void markRoleChanged(Window *window, int role);
+    void scheduleFlush();
+    void flush();
 
     void handleWindowAdded(Window *window);
     void handleWindowRemoved(Window *window);
     void setupWindowConnections(Window *window);
 
     QList<Window *> m_windows;
+    QList<Window *> m_addedWindows;
+    QHash<Window *, QList<int>> m_changedRoles;
+    QTimer m_flushTimer;
 };
 
 /*!
@@ -15,6 +15,7 @@
 #include "opengl/eglcontext.h"
 #include "opengl/glframebuffer.h"
 #include "scene/itemrenderer.h"
+#include "scene/texturememorybudget.h"
 #include "scene/windowitem.h"
 #include "scene/workspacescene.h"
 #include "scripting_logging.h"
@@ -29,9 +30,15 @@
 #include <QSGImageNode>
 #include <QSGTextureProvider>
 
+#include <bit>
+
 namespace KWin
 {
 
+// thumbnails of windows that aren't visible are rendered again at most this often
+static constexpr std::chrono::milliseconds s_throttledRefreshInterval(1000);
+static constexpr qreal s_minimumTextureScale = 1.0 / 16;
+
 static bool useGlThumbnails()
 {
     static bool qtQuickIsSoftware = QStringList({QStringLiteral("software"), QStringLiteral("softwarecontext")}).contains(QQuickWindow::sceneGraphBackend());
@@ -42,17 +49,22 @@ WindowThumbnailSource::WindowThumbnailSource(QQuickWindow *view, Window *handle)
     : m_view(view)
     , m_handle(handle)
 {
-    connect(handle, &Window::frameGeometryChanged, this, [this]() {
-        m_dirty = true;
-        Q_EMIT changed();
-    });
-    connect(handle, &Window::damaged, this, [this]() {
-        m_dirty = true;
-        Q_EMIT changed();
+    // the window is rendered relative to its own geometry, moving it doesn't change the thumbnail
+    connect(handle, &Window::frameGeometryChanged, this, [this](const RectF &oldGeometry) {
+        if (m_handle->frameGeometry().size() != oldGeometry.size()) {
+            markDirty();
+        }
     });
+    connect(handle, &Window::damaged, this, &WindowThumbnailSource::markDirty);
+
+    m_throttleTimer.setSingleShot(true);
+    connect(&m_throttleTimer, &QTimer::timeout, this, &WindowThumbnailSource::changed);
 
     connect(kwinApp()->scene(), &WorkspaceScene::preFrameRender, this, &WindowThumbnailSource::update);
 
+    // the thumbnail is shown as long as the source exists, so it's accounted but never evicted
+    m_memory = kwinApp()->scene()->textureMemoryBudget()->track(QStringLiteral("WindowThumbnail"));
+
     m_handle->refOffscreenRendering();
 }
 
@@ -100,6 +112,49 @@ std::shared_ptr<WindowThumbnailSource> WindowThumbnailSource::getOrCreate(QQuick
     return s;
 }
 
+void WindowThumbnailSource::markDirty()
+{
+    m_dirty = true;
+    Q_EMIT changed();
+}
+
+bool WindowThumbnailSource::isThrottled() const
+{
+    return m_handle->isMinimized() || !m_handle->isOnCurrentDesktop() || !m_handle->isOnCurrentActivity();
+}
+
+qreal WindowThumbnailSource::textureScale(const QSize &fullSize) const
+{
+    qreal ratio = 0;
+    for (const auto &[consumer, size] : m_desiredSizes) {
+        ratio = std::max({ratio, qreal(size.width()) / fullSize.width(), qreal(size.height()) / fullSize.height()});
+    }
+    if (ratio <= 0) {
+        return 1;
+    }
+    qreal scale = 1;
+    while (scale / 2 >= ratio && scale / 2 >= s_minimumTextureScale) {
+        scale /= 2;
+    }
+    return scale;
+}
+
+void WindowThumbnailSource::setDesiredSize(const QObject *consumer, const QSize &size)
+{
+    if (size.isEmpty()) {
+        m_desiredSizes.erase(consumer);
+    } else {
+        m_desiredSizes[consumer] = size;
+    }
+    if (!m_handle || !m_view) {
+        return;
+    }
+    const QSize fullSize = m_handle->visibleGeometry().toAlignedRect().size() * m_view->devicePixelRatio();
+    if (!fullSize.isEmpty() && textureScale(fullSize) != m_textureScale) {
+        markDirty();
+    }
+}
+
 WindowThumbnailSource::Frame WindowThumbnailSource::acquire()
 {
     return Frame{
@@ -116,22 +171,41 @@ void WindowThumbnailSource::update()
     Q_ASSERT(m_view);
 
     const RectF geometry = m_handle->visibleGeometry();
-    const qreal devicePixelRatio = m_view->devicePixelRatio();
-    const QSize textureSize = geometry.toAlignedRect().size() * devicePixelRatio;
+    const QSize fullSize = geometry.toAlignedRect().size() * m_view->devicePixelRatio();
+    const qreal scale = textureScale(fullSize);
+    const QSize textureSize = (QSizeF(fullSize) * scale).toSize();
+
+    const bool reallocate = !m_offscreenTexture || m_offscreenTexture->size() != textureSize;
+    if (!reallocate && isThrottled()) {
+        const auto sinceLastRendered = std::chrono::steady_clock::now() - m_lastRendered;
+        if (sinceLastRendered < s_throttledRefreshInterval) {
+            if (!m_throttleTimer.isActive()) {
+                m_throttleTimer.start(std::chrono::ceil<std::chrono::milliseconds>(s_throttledRefreshInterval - sinceLastRendered));
+            }
+            return;
+        }
+    }
 
-    if (!m_offscreenTexture || m_offscreenTexture->size() != textureSize) {
-        m_offscreenTexture = GLTexture::allocate(GL_RGBA8, textureSize);
+    if (reallocate) {
+        // mipmaps keep the thumbnail smooth while it's painted smaller than the texture,
+        // e.g. during zoom animations. GLES2 only supports them for power of two sizes
+        const bool mipmaps = EglContext::currentContext()->hasVersion(Version(3, 0));
+        const int levels = mipmaps ? std::bit_width(uint(std::max(textureSize.width(), textureSize.height()))) : 1;
+        m_offscreenTexture = GLTexture::allocate(GL_RGBA8, textureSize, levels);
         if (!m_offscreenTexture) {
             return;
         }
         m_offscreenTexture->setContentTransform(OutputTransform::FlipY);
-        m_offscreenTexture->setFilter(GL_LINEAR);
+        m_offscreenTexture->setFilter(levels > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
         m_offscreenTexture->setWrapMode(GL_CLAMP_TO_EDGE);
         m_offscreenTarget = std::make_unique<GLFramebuffer>(m_offscreenTexture.get());
+        m_memory->setSize(m_offscreenTexture->memoryUsage());
     }
+    m_memory->markUsed();
+    m_textureScale = scale;
 
     RenderTarget offscreenRenderTarget(m_offscreenTarget.get());
-    RenderViewport offscreenViewport(geometry, devicePixelRatio, offscreenRenderTarget, QPoint());
+    RenderViewport offscreenViewport(geometry, m_view->devicePixelRatio() * scale, offscreenRenderTarget, QPoint());
 
     // The thumbnail must be rendered using kwin's opengl context as VAOs are not
     // shared across contexts. Unfortunately, this also introduces a latency of 1
@@ -143,6 +217,13 @@ void WindowThumbnailSource::update()
     renderer->renderItem(offscreenRenderTarget, offscreenViewport, m_handle->windowItem(), mask, Region::infinite(), WindowPaintData{}, {}, {});
     renderer->endFrame();
 
+    if (m_offscreenTexture->mipLevels() > 1) {
+        m_offscreenTexture->bind();
+        m_offscreenTexture->generateMipmaps();
+        m_offscreenTexture->unbind();
+    }
+    m_lastRendered = std::chrono::steady_clock::now();
+
     // The fence is needed to avoid the case where qtquick renderer starts using
     // the texture while all rendering commands to it haven't completed yet.
     m_dirty = false;
@@ -181,10 +262,15 @@ void ThumbnailTextureProvider::setTexture(const std::shared_ptr<GLTexture> &nati
     if (m_nativeTexture != nativeTexture) {
         const GLuint textureId = nativeTexture->texture();
         m_nativeTexture = nativeTexture;
+        QQuickWindow::CreateTextureOptions options = QQuickWindow::TextureHasAlphaChannel;
+        if (nativeTexture->mipLevels() > 1) {
+            options |= QQuickWindow::TextureHasMipmaps;
+        }
         m_texture.reset(QNativeInterface::QSGOpenGLTexture::fromNative(textureId, m_window,
                                                                        nativeTexture->size(),
-                                                                       QQuickWindow::TextureHasAlphaChannel));
+                                                                       options));
         m_texture->setFiltering(QSGTexture::Linear);
+        m_texture->setMipmapFiltering(nativeTexture->mipLevels() > 1 ? QSGTexture::Linear : QSGTexture::None);
         m_texture->setHorizontalWrapMode(QSGTexture::ClampToEdge);
         m_texture->setVerticalWrapMode(QSGTexture::ClampToEdge);
     }
@@ -234,6 +320,7 @@ WindowThumbnailItem::WindowThumbnailItem(QQuickItem *parent)
 
 WindowThumbnailItem::~WindowThumbnailItem()
 {
+    releaseSource();
     if (m_provider) {
         if (window()) {
             window()->scheduleRenderJob(new ThumbnailTextureProviderCleanupJob(m_provider),
@@ -257,7 +344,7 @@ void WindowThumbnailItem::invalidateSceneGraph()
 {
     delete m_provider;
     m_provider = nullptr;
-    m_source.reset();
+    releaseSource();
 }
 
 void WindowThumbnailItem::itemChange(QQuickItem::ItemChange change, const QQuickItem::ItemChangeData &value)
@@ -284,9 +371,15 @@ QSGTextureProvider *WindowThumbnailItem::textureProvider() const
     return m_provider;
 }
 
+void WindowThumbnailItem::geometryChange(const QRectF &newGeometry, const QRectF &oldGeometry)
+{
+    QQuickItem::geometryChange(newGeometry, oldGeometry);
+    updateDesiredSize();
+}
+
 void WindowThumbnailItem::releaseOpenGlResources()
 {
-    m_source.reset();
+    releaseSource();
     if (m_provider) {
         m_provider->setTexture(nullptr);
     }
@@ -294,14 +387,30 @@ void WindowThumbnailItem::releaseOpenGlResources()
 
 void WindowThumbnailItem::updateSource()
 {
+    releaseSource();
     if (useGlThumbnails() && window() && m_client) {
         m_source = WindowThumbnailSource::getOrCreate(window(), m_client);
         connect(m_source.get(), &WindowThumbnailSource::changed, this, &WindowThumbnailItem::update);
-    } else {
+        updateDesiredSize();
+    }
+}
+
+void WindowThumbnailItem::releaseSource()
+{
+    if (m_source) {
+        disconnect(m_source.get(), &WindowThumbnailSource::changed, this, &WindowThumbnailItem::update);
+        m_source->setDesiredSize(this, QSize());
         m_source.reset();
     }
 }
 
+void WindowThumbnailItem::updateDesiredSize()
+{
+    if (m_source && window()) {
+        m_source->setDesiredSize(this, (paintedRect().size() * window()->devicePixelRatio()).toSize());
+    }
+}
+
 QSGNode *WindowThumbnailItem::updatePaintNode(QSGNode *oldNode, QQuickItem::UpdatePaintNodeData *)
 {
     if (!m_source) {
@@ -329,6 +438,7 @@ QSGNode *WindowThumbnailItem::updatePaintNode(QSGNode *oldNode, QQuickItem::Upda
         node = window()->createImageNode();
         node->setFiltering(QSGTexture::Linear);
     }
+    node->setMipmapFiltering(texture->mipLevels() > 1 ? QSGTexture::Linear : QSGTexture::None);
     node->setTexture(m_provider->texture());
     node->setTextureCoordinatesTransform(QSGImageNode::NoTransform);
     node->setRect(paintedRect());
@@ -372,11 +482,15 @@ void WindowThumbnailItem::setClient(Window *client)
     if (m_client) {
         disconnect(m_client, &Window::frameGeometryChanged,
                    this, &WindowThumbnailItem::updateImplicitSize);
+        disconnect(m_client, &Window::frameGeometryChanged,
+                   this, &WindowThumbnailItem::updateDesiredSize);
     }
     m_client = client;
     if (m_client) {
         connect(m_client, &Window::frameGeometryChanged,
                 this, &WindowThumbnailItem::updateImplicitSize);
+        connect(m_client, &Window::frameGeometryChanged,
+                this, &WindowThumbnailItem::updateDesiredSize);
         setWId(m_client->internalId());
     } else {
         setWId(QUuid());
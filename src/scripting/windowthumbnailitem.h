@@ -10,19 +10,33 @@
 #include "core/rect.h"
 
 #include <QQuickItem>
+#include <QTimer>
 #include <QUuid>
 
 #include <epoxy/gl.h>
 
+#include <chrono>
+#include <map>
+
 namespace KWin
 {
 
 class Window;
 class GLFramebuffer;
 class GLTexture;
+class TextureMemoryAllocation;
 class ThumbnailTextureProvider;
 class WindowThumbnailSource;
 
+/**
+ * The WindowThumbnailSource class renders a window into a texture that is shared by all the
+ * thumbnails of the window in a QQuickWindow.
+ *
+ * The texture is rendered at the largest size the thumbnails are painted at, rounded up to the
+ * size of the window divided by a power of two, so zooming thumbnails doesn't render the window
+ * again on every frame. It's only rendered again after the window has been damaged, and at most
+ * once per second while the window is minimized or not on the current virtual desktop.
+ */
 class WindowThumbnailSource : public QObject
 {
     Q_OBJECT
@@ -41,18 +55,32 @@ public:
 
     Frame acquire();
 
+    /**
+     * Sets the size, in device pixels, at which the thumbnail @a consumer paints the window.
+     * An empty @a size removes the consumer.
+     */
+    void setDesiredSize(const QObject *consumer, const QSize &size);
+
 Q_SIGNALS:
     void changed();
 
 private:
     void update();
+    void markDirty();
+    bool isThrottled() const;
+    qreal textureScale(const QSize &fullSize) const;
 
     QPointer<QQuickWindow> m_view;
     QPointer<Window> m_handle;
 
     std::shared_ptr<GLTexture> m_offscreenTexture;
     std::unique_ptr<GLFramebuffer> m_offscreenTarget;
+    std::unique_ptr<TextureMemoryAllocation> m_memory;
     GLsync m_acquireFence = 0;
+    std::map<const QObject *, QSize> m_desiredSizes;
+    std::chrono::steady_clock::time_point m_lastRendered;
+    QTimer m_throttleTimer;
+    qreal m_textureScale = 1;
     bool m_dirty = true;
 };
 
@@ -93,6 +121,7 @@ public:
 protected:
     void releaseResources() override;
     void itemChange(QQuickItem::ItemChange change, const QQuickItem::ItemChangeData &value) override;
+    void geometryChange(const QRectF &newGeometry, const QRectF &oldGeometry) override;
 
 Q_SIGNALS:
     void wIdChanged();
@@ -113,8 +142,10 @@ private Q_SLOTS:
 
 private:
     RectF paintedRect() const;
+    void updateDesiredSize();
     void updateImplicitSize();
     void updateSource();
+    void releaseSource();
     void releaseOpenGlResources();
 
     QUuid m_wId;
@@ -347,6 +347,75 @@ void WorkspaceWrapper::raiseWindow(KWin::Window *window)
     }
 }
 
+QVariantList WorkspaceWrapper::windowSnapshot(const QStringList &properties) const
+{
+    const QString windowKey = QStringLiteral("window");
+    // the property indices only need to be looked up once for every window type
+    QHash<const QMetaObject *, QList<int>> propertyIndices;
+
+    QVariantList result;
+    const QList<Window *> windows = workspace()->windows();
+    result.reserve(windows.size());
+    for (Window *window : windows) {
+        const QMetaObject *metaObject = window->metaObject();
+        auto it = propertyIndices.find(metaObject);
+        if (it == propertyIndices.end()) {
+            QList<int> indices;
+            indices.reserve(properties.size());
+            for (const QString &property : properties) {
+                indices.append(metaObject->indexOfProperty(property.toUtf8().constData()));
+            }
+            it = propertyIndices.insert(metaObject, indices);
+        }
+
+        QVariantMap snapshot;
+        snapshot.insert(windowKey, QVariant::fromValue(window));
+        for (qsizetype i = 0; i < properties.size(); ++i) {
+            const int index = (*it)[i];
+            if (index != -1) {
+                snapshot.insert(properties[i], metaObject->property(index).read(window));
+            }
+        }
+        result.append(snapshot);
+    }
+    return result;
+}
+
+static std::optional<RectF> variantToRectF(const QVariant &variant)
+{
+    if (variant.canConvert<RectF>()) {
+        return variant.value<RectF>();
+    } else if (variant.metaType() == QMetaType::fromType<QVariantMap>()) {
+        const QVariantMap map = variant.toMap();
+        return RectF(map.value(QStringLiteral("x")).toReal(),
+                     map.value(QStringLiteral("y")).toReal(),
+                     map.value(QStringLiteral("width")).toReal(),
+                     map.value(QStringLiteral("height")).toReal());
+    }
+    return std::nullopt;
+}
+
+void WorkspaceWrapper::moveResizeWindows(const QList<KWin::Window *> &windows, const QVariantList &geometries)
+{
+    if (windows.size() != geometries.size()) {
+        qCWarning(KWIN_SCRIPTING) << "moveResizeWindows() got" << windows.size() << "windows and" << geometries.size() << "geometries";
+    }
+
+    StackingUpdatesBlocker blocker(workspace());
+    const qsizetype count = std::min(windows.size(), geometries.size());
+    for (qsizetype i = 0; i < count; ++i) {
+        Window *window = windows[i];
+        if (!window) {
+            continue;
+        }
+        if (const auto geometry = variantToRectF(geometries[i])) {
+            window->moveResize(*geometry);
+        } else {
+            qCWarning(KWIN_SCRIPTING) << "moveResizeWindows() got an invalid geometry for" << window;
+        }
+    }
+}
+
 void WorkspaceWrapper::constrain(KWin::Window *below, KWin::Window *above)
 {
     KWin::Workspace::self()->constrain(below, above);
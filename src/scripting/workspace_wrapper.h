@@ -19,6 +19,7 @@
 #include <QRect>
 #include <QSize>
 #include <QStringList>
+#include <QVariant>
 
 namespace KWin
 {
@@ -509,6 +510,28 @@ public:
      */
     Q_INVOKABLE bool isEffectActive(const QString &pluginId) const;
 
+    /*!
+     * \qmlmethod list<object> Workspace::windowSnapshot(list<string> properties)
+     *
+     * Returns a plain object for every window with the given \a properties of the window,
+     * and the window itself in the \c window field. The properties are read in one go, which
+     * is much cheaper than reading them from the windows one by one in scripts that look at
+     * many windows at once. Properties that a window doesn't have are left out.
+     *
+     * \since 6.7
+     */
+    Q_INVOKABLE QVariantList windowSnapshot(const QStringList &properties) const;
+
+    /*!
+     * \qmlmethod void Workspace::moveResizeWindows(list<Window> windows, list<rect> geometries)
+     *
+     * Sets the frame geometry of each window in \a windows to the rect at the same index
+     * in \a geometries.
+     *
+     * \since 6.7
+     */
+    Q_INVOKABLE void moveResizeWindows(const QList<KWin::Window *> &windows, const QVariantList &geometries);
+
     /*!
      * \qmlmethod void Workspace::constrain(Window below, Window above)
      *
@@ -190,9 +190,14 @@ void SessionManager::storeClient(KConfigGroup &cg, int num, X11Window *c)
 void SessionManager::loadSession(const QString &sessionName)
 {
     session.clear();
+    m_sessionTaken.clear();
+    m_sessionById.clear();
+    m_sessionByResource.clear();
+    m_pendingSessionCount = 0;
     KConfigGroup cg(sessionConfig(sessionName, QString()), QStringLiteral("Session"));
     Q_EMIT loadSessionRequested(sessionName);
     addSessionInfo(cg);
+    m_restoreTimer.start();
 }
 
 void SessionManager::addSessionInfo(KConfigGroup &cg)
@@ -227,7 +232,16 @@ void SessionManager::addSessionInfo(KConfigGroup &cg)
         info.active = (active_client == i);
         info.stackingOrder = cg.readEntry(QLatin1StringView("stackingOrder") + n, -1);
         info.activities = cg.readEntry(QLatin1StringView("activities") + n, QStringList());
+
+        // index the entries, so that matching a new window doesn't have to go over all of them
+        const qsizetype index = session.size();
+        if (!info.sessionId.isEmpty()) {
+            m_sessionById[info.sessionId].append(index);
+        }
+        m_sessionByResource[std::make_pair(info.resourceName, info.resourceClass)].append(index);
         session.append(info);
+        m_sessionTaken.push_back(false);
+        m_pendingSessionCount++;
     }
 }
 
@@ -252,59 +266,88 @@ static bool sessionInfoWindowTypeMatch(X11Window *c, const SessionInfo &info)
  */
 std::optional<SessionInfo> SessionManager::takeSessionInfo(X11Window *c)
 {
-    std::optional<SessionInfo> realInfo;
+    if (m_pendingSessionCount == 0) {
+        return std::nullopt;
+    }
+
     QByteArray sessionId = c->sessionId();
     QString windowRole = c->windowRole();
     QString wmCommand = c->wmCommand();
     QString resourceName = c->resourceName();
     QString resourceClass = c->resourceClass();
 
+    std::optional<qsizetype> match;
     // First search ``session''
     if (!sessionId.isEmpty()) {
         // look for a real session managed client (algorithm suggested by ICCCM)
-        for (const SessionInfo &info : std::as_const(session)) {
-            if (realInfo) {
-                break;
+        const QList<qsizetype> candidates = m_sessionById.value(sessionId);
+        for (const qsizetype index : candidates) {
+            const SessionInfo &info = session[index];
+            if (m_sessionTaken[index] || !sessionInfoWindowTypeMatch(c, info)) {
+                continue;
             }
-            if (info.sessionId == sessionId && sessionInfoWindowTypeMatch(c, info)) {
-                if (!windowRole.isEmpty()) {
-                    if (info.windowRole == windowRole) {
-                        realInfo = info;
-                        session.removeAll(info);
-                    }
-                } else {
-                    if (info.windowRole.isEmpty()
-                        && info.resourceName == resourceName
-                        && info.resourceClass == resourceClass) {
-                        realInfo = info;
-                        session.removeAll(info);
-                    }
+            if (!windowRole.isEmpty()) {
+                if (info.windowRole == windowRole) {
+                    match = index;
+                    break;
+                }
+            } else {
+                if (info.windowRole.isEmpty()
+                    && info.resourceName == resourceName
+                    && info.resourceClass == resourceClass) {
+                    match = index;
+                    break;
                 }
             }
         }
     } else {
         // look for a sessioninfo with matching features.
-        for (const SessionInfo &info : std::as_const(session)) {
-            if (realInfo) {
-                break;
+        const QList<qsizetype> candidates = m_sessionByResource.value(std::make_pair(resourceName, resourceClass));
+        for (const qsizetype index : candidates) {
+            const SessionInfo &info = session[index];
+            if (m_sessionTaken[index] || !sessionInfoWindowTypeMatch(c, info)) {
+                continue;
             }
-            if (info.resourceName == resourceName
-                && info.resourceClass == resourceClass
-                && sessionInfoWindowTypeMatch(c, info)) {
-                if (wmCommand.isEmpty() || info.wmCommand == wmCommand) {
-                    realInfo = info;
-                    session.removeAll(info);
-                }
+            if (wmCommand.isEmpty() || info.wmCommand == wmCommand) {
+                match = index;
+                break;
             }
         }
     }
-    return realInfo;
+    if (!match) {
+        return std::nullopt;
+    }
+
+    m_sessionTaken[*match] = true;
+    m_pendingSessionCount--;
+
+    // restack the windows that get restored in quick succession together rather than one by one
+    if (!m_restoreBatchTimer.isActive()) {
+        workspace()->blockStackingUpdates(true);
+        m_restoreBatchTimer.start();
+    }
+    if (m_pendingSessionCount == 0) {
+        finishRestoreBatch();
+        qCDebug(KWIN_CORE) << "Restored" << session.size() << "session windows in" << m_restoreTimer.elapsed() << "ms";
+    }
+    return session[*match];
 }
 #endif
 
+void SessionManager::finishRestoreBatch()
+{
+    m_restoreBatchTimer.stop();
+    workspace()->blockStackingUpdates(false);
+}
+
 SessionManager::SessionManager(QObject *parent)
     : QObject(parent)
 {
+    // the stacking order is not updated while a batch is open, so keep it short
+    m_restoreBatchTimer.setSingleShot(true);
+    m_restoreBatchTimer.setInterval(std::chrono::milliseconds(100));
+    connect(&m_restoreBatchTimer, &QTimer::timeout, this, &SessionManager::finishRestoreBatch);
+
     new SessionAdaptor(this);
     QDBusConnection::sessionBus().registerObject(QStringLiteral("/Session"), this);
 }
@@ -17,6 +17,8 @@
 
 #include <QDBusContext>
 #include <QDataStream>
+#include <QElapsedTimer>
+#include <QHash>
 #include <QPointer>
 #include <QStringList>
 #include <QTimer>
@@ -77,6 +79,7 @@ private:
     void addSessionInfo(KConfigGroup &cg);
 
     void updateWaylandCancelNotification();
+    void finishRestoreBatch();
 
     SessionState m_sessionState = SessionState::Normal;
 
@@ -84,6 +87,12 @@ private:
     int m_sessionDesktop;
 
     QList<SessionInfo> session;
+    std::vector<bool> m_sessionTaken;
+    QHash<QByteArray, QList<qsizetype>> m_sessionById;
+    QHash<std::pair<QString, QString>, QList<qsizetype>> m_sessionByResource;
+    qsizetype m_pendingSessionCount = 0;
+    QTimer m_restoreBatchTimer;
+    QElapsedTimer m_restoreTimer;
     QList<XdgToplevelWindow *> m_pendingWindows;
     QTimer m_closeTimer;
     QTimer m_logoutAnywayTimer;
@@ -0,0 +1,312 @@
+/*
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "stalldetector.h"
+#include "utils/common.h"
+
+#include <QAbstractEventDispatcher>
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QStandardPaths>
+
+#include <csignal>
+#include <fcntl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#if __has_include(<execinfo.h>)
+#include <execinfo.h>
+#define KWIN_HAVE_BACKTRACE 1
+#else
+#define KWIN_HAVE_BACKTRACE 0
+#endif
+
+namespace KWin
+{
+
+static constexpr int s_maxStackFrames = 64;
+static constexpr std::chrono::milliseconds s_sampleTimeout(100);
+
+// written by the signal handler in the main thread and read by the monitoring thread
+static void *s_stackFrames[s_maxStackFrames];
+static std::atomic<int> s_stackDepth = 0;
+static std::atomic<bool> s_stackSampled = false;
+
+static int sampleSignal()
+{
+    return SIGRTMIN + 3;
+}
+
+static void sampleHandler(int)
+{
+#if KWIN_HAVE_BACKTRACE
+    s_stackDepth.store(backtrace(s_stackFrames, s_maxStackFrames), std::memory_order_relaxed);
+#endif
+    s_stackSampled.store(true, std::memory_order_release);
+}
+
+static std::chrono::nanoseconds monotonicNow()
+{
+    return std::chrono::steady_clock::now().time_since_epoch();
+}
+
+static StallDetector::Bucket bucketFor(std::chrono::nanoseconds duration)
+{
+    using namespace std::chrono_literals;
+    if (duration < 100ms) {
+        return StallDetector::Short;
+    } else if (duration < 250ms) {
+        return StallDetector::Medium;
+    } else if (duration < 500ms) {
+        return StallDetector::Long;
+    } else if (duration < 1s) {
+        return StallDetector::VeryLong;
+    } else {
+        return StallDetector::Freeze;
+    }
+}
+
+StallDetector::StallDetector(QObject *parent)
+    : QObject(parent)
+    , m_threshold(std::chrono::nanoseconds(std::chrono::milliseconds(1000 / 60)).count())
+{
+    bool ok = false;
+    m_thresholdMultiplier = qEnvironmentVariableIntValue("KWIN_STALL_DETECTOR", &ok);
+    if (!ok) {
+        m_thresholdMultiplier = 8;
+    }
+    if (m_thresholdMultiplier <= 0) {
+        return;
+    }
+    m_threshold = m_threshold * m_thresholdMultiplier;
+
+    QAbstractEventDispatcher *dispatcher = QAbstractEventDispatcher::instance(QCoreApplication::instance()->thread());
+    if (!dispatcher) {
+        m_thresholdMultiplier = 0;
+        return;
+    }
+
+#if KWIN_HAVE_BACKTRACE
+    // the first call loads libgcc, which must not happen in the signal handler
+    void *frame;
+    backtrace(&frame, 1);
+#endif
+    struct sigaction action{};
+    action.sa_handler = sampleHandler;
+    action.sa_flags = SA_RESTART;
+    sigemptyset(&action.sa_mask);
+    sigaction(sampleSignal(), &action, nullptr);
+
+    m_mainThreadId = gettid();
+    connect(dispatcher, &QAbstractEventDispatcher::awake, this, &StallDetector::awake, Qt::DirectConnection);
+    connect(dispatcher, &QAbstractEventDispatcher::aboutToBlock, this, &StallDetector::aboutToBlock, Qt::DirectConnection);
+    m_busySince = monotonicNow().count();
+    m_thread = std::thread(&StallDetector::run, this);
+}
+
+StallDetector::~StallDetector()
+{
+    if (m_thread.joinable()) {
+        {
+            std::lock_guard lock(m_mutex);
+            m_quit = true;
+        }
+        m_condition.notify_one();
+        m_thread.join();
+    }
+}
+
+bool StallDetector::isEnabled() const
+{
+    return m_thresholdMultiplier > 0;
+}
+
+void StallDetector::setRefreshInterval(std::chrono::nanoseconds interval)
+{
+    if (isEnabled()) {
+        m_threshold = (interval * m_thresholdMultiplier).count();
+    }
+}
+
+std::chrono::nanoseconds StallDetector::threshold() const
+{
+    return std::chrono::nanoseconds(m_threshold.load(std::memory_order_relaxed));
+}
+
+std::array<quint64, StallDetector::BucketCount> StallDetector::stallCounts() const
+{
+    std::array<quint64, BucketCount> counts;
+    for (int i = 0; i < BucketCount; ++i) {
+        counts[i] = m_stallCounts[i].load(std::memory_order_relaxed);
+    }
+    return counts;
+}
+
+void StallDetector::awake()
+{
+    if (m_busySince.load(std::memory_order_relaxed)) {
+        return;
+    }
+    m_busySince = monotonicNow().count();
+    // the monitoring thread only sleeps without a timeout while the main thread is idle
+    if (m_monitorSleeping) {
+        std::lock_guard lock(m_mutex);
+        m_condition.notify_one();
+    }
+}
+
+void StallDetector::aboutToBlock()
+{
+    const auto since = std::chrono::nanoseconds(m_busySince.exchange(0));
+    if (since.count() == 0) {
+        return;
+    }
+    const std::chrono::nanoseconds now = monotonicNow();
+    const std::chrono::nanoseconds duration = now - since;
+    {
+        std::lock_guard lock(m_historyMutex);
+        m_history[m_historyNext] = Iteration{
+            .start = since,
+            .duration = duration,
+        };
+        m_historyNext = (m_historyNext + 1) % s_historySize;
+    }
+
+    if (duration >= threshold()) {
+        const Bucket bucket = bucketFor(duration);
+        m_stallCounts[bucket].fetch_add(1, std::memory_order_relaxed);
+        qCWarning(KWIN_CORE) << "The main thread was stalled for" << std::chrono::duration_cast<std::chrono::milliseconds>(duration).count() << "ms";
+    }
+}
+
+void StallDetector::run()
+{
+    pthread_setname_np(pthread_self(), "KWinStallDetect");
+
+    std::chrono::nanoseconds reported = std::chrono::nanoseconds::zero();
+    std::unique_lock lock(m_mutex);
+    while (!m_quit) {
+        const auto since = std::chrono::nanoseconds(m_busySince.load());
+        if (since.count() == 0) {
+            m_monitorSleeping = true;
+            m_condition.wait(lock, [this]() {
+                return m_quit || m_busySince.load() != 0;
+            });
+            m_monitorSleeping = false;
+            continue;
+        }
+
+        const std::chrono::nanoseconds deadline = since + threshold();
+        const std::chrono::nanoseconds now = monotonicNow();
+        if (now < deadline) {
+            m_condition.wait_for(lock, deadline - now, [this]() {
+                return m_quit;
+            });
+            continue;
+        }
+
+        // report every stall once, even if it takes several times as long as the threshold
+        if (since != reported && since.count() == m_busySince.load()) {
+            reported = since;
+            lock.unlock();
+            report(since);
+            lock.lock();
+        } else {
+            m_condition.wait_for(lock, threshold(), [this]() {
+                return m_quit;
+            });
+        }
+    }
+}
+
+bool StallDetector::sampleMainThread()
+{
+#if KWIN_HAVE_BACKTRACE
+    s_stackSampled.store(false, std::memory_order_relaxed);
+    if (syscall(SYS_tgkill, getpid(), m_mainThreadId, sampleSignal()) != 0) {
+        return false;
+    }
+    const auto deadline = std::chrono::steady_clock::now() + s_sampleTimeout;
+    while (!s_stackSampled.load(std::memory_order_acquire)) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+void StallDetector::report(std::chrono::nanoseconds busySince)
+{
+    if (m_reportCount >= s_maxReports) {
+        return;
+    }
+    ++m_reportCount;
+
+    const bool sampled = sampleMainThread();
+    const std::chrono::nanoseconds now = monotonicNow();
+
+    const QString directory = QStandardPaths::writableLocation(QStandardPaths::RuntimeLocation);
+    const QString fileName = QDir(directory).filePath(QStringLiteral("kwin-stall-%1-%2.txt").arg(QDateTime::currentDateTime().toString(QStringLiteral("yyyyMMdd-hhmmss"))).arg(m_reportCount));
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qCWarning(KWIN_CORE) << "Failed to open" << fileName << "for writing:" << file.errorString();
+        return;
+    }
+
+    const auto toMilliseconds = [](std::chrono::nanoseconds duration) {
+        return QString::number(std::chrono::duration<double, std::milli>(duration).count(), 'f', 3);
+    };
+
+    QByteArray text;
+    text += "KWin main thread stall\n";
+    text += "started at: " + toMilliseconds(busySince).toUtf8() + " ms (CLOCK_MONOTONIC)\n";
+    text += "stalled for: " + toMilliseconds(now - busySince).toUtf8() + " ms, threshold " + toMilliseconds(threshold()).toUtf8() + " ms\n";
+
+    const auto counts = stallCounts();
+    text += "stalls so far: <100ms " + QByteArray::number(counts[Short])
+        + ", 100-250ms " + QByteArray::number(counts[Medium])
+        + ", 250-500ms " + QByteArray::number(counts[Long])
+        + ", 500ms-1s " + QByteArray::number(counts[VeryLong])
+        + ", >1s " + QByteArray::number(counts[Freeze]) + "\n";
+
+    text += "\nrecent event loop iterations (start in ms relative to the stall, duration in ms):\n";
+    {
+        std::lock_guard lock(m_historyMutex);
+        for (size_t i = 0; i < s_historySize; ++i) {
+            const Iteration &iteration = m_history[(m_historyNext + i) % s_historySize];
+            if (iteration.start.count() == 0 || busySince - iteration.start > s_historyDuration) {
+                continue;
+            }
+            text += toMilliseconds(iteration.start - busySince).toUtf8() + " " + toMilliseconds(iteration.duration).toUtf8() + "\n";
+        }
+    }
+
+    text += "\nstack of the main thread:\n";
+    file.write(text);
+    file.flush();
+#if KWIN_HAVE_BACKTRACE
+    if (sampled) {
+        backtrace_symbols_fd(s_stackFrames, s_stackDepth.load(std::memory_order_relaxed), file.handle());
+    } else {
+        file.write("could not be sampled\n");
+    }
+#else
+    file.write("not supported on this platform\n");
+#endif
+    file.close();
+
+    qCWarning(KWIN_CORE) << "The main thread has been stalled for" << std::chrono::duration_cast<std::chrono::milliseconds>(now - busySince).count() << "ms, wrote a report to" << fileName;
+}
+
+} // namespace KWin
+
+#include "moc_stalldetector.cpp"
@@ -0,0 +1,110 @@
+/*
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include "kwin_export.h"
+
+#include <QObject>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include <sys/types.h>
+
+namespace KWin
+{
+
+/**
+ * The StallDetector class notices when the main thread doesn't return to the event loop
+ * for a long time, i.e. when the compositor freezes.
+ *
+ * A monitoring thread checks whether the main thread has been busy for longer than the
+ * threshold, which is a number of refresh intervals of the fastest output, 8 by default or
+ * the value of the KWIN_STALL_DETECTOR environment variable. Setting the variable to 0
+ * disables the detector.
+ *
+ * When a stall is detected, a sample of the stack of the main thread is taken while it's still
+ * stuck, and written together with the durations of the most recent event loop iterations to
+ * a report in the runtime directory, so that reports of short freezes can come with the culprit.
+ * The timestamps in the report use the monotonic clock, like ftrace does, so the report can be
+ * matched with a trace recorded with KWIN_PERF_FTRACE. At most a few reports are written per
+ * session, but all stalls are counted by their duration.
+ */
+class KWIN_EXPORT StallDetector : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Bucket {
+        // shorter than 100ms
+        Short,
+        // 100 to 250ms
+        Medium,
+        // 250 to 500ms
+        Long,
+        // 500ms to 1s
+        VeryLong,
+        // longer than 1s
+        Freeze,
+        BucketCount,
+    };
+
+    explicit StallDetector(QObject *parent = nullptr);
+    ~StallDetector() override;
+
+    bool isEnabled() const;
+
+    /**
+     * Sets the refresh interval of the fastest output, which the threshold depends on.
+     */
+    void setRefreshInterval(std::chrono::nanoseconds interval);
+    std::chrono::nanoseconds threshold() const;
+
+    /**
+     * Returns the number of stalls that have been detected so far, by their duration.
+     */
+    std::array<quint64, BucketCount> stallCounts() const;
+
+private:
+    struct Iteration
+    {
+        std::chrono::nanoseconds start;
+        std::chrono::nanoseconds duration;
+    };
+
+    static constexpr size_t s_historySize = 512;
+    static constexpr std::chrono::seconds s_historyDuration{2};
+    static constexpr int s_maxReports = 8;
+
+    void awake();
+    void aboutToBlock();
+    void run();
+    void report(std::chrono::nanoseconds busySince);
+    bool sampleMainThread();
+
+    int m_thresholdMultiplier = 0;
+    pid_t m_mainThreadId = 0;
+    std::thread m_thread;
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    bool m_quit = false;
+    std::atomic<bool> m_monitorSleeping = false;
+    // the time at which the current event loop iteration started, or zero if the main thread is idle
+    std::atomic<std::chrono::nanoseconds::rep> m_busySince = 0;
+    std::atomic<std::chrono::nanoseconds::rep> m_threshold;
+    std::array<std::atomic<quint64>, BucketCount> m_stallCounts{};
+    std::mutex m_historyMutex;
+    std::array<Iteration, s_historySize> m_history{};
+    size_t m_historyNext = 0;
+    int m_reportCount = 0;
+};
+
+} // namespace KWin
@@ -0,0 +1,157 @@
+/*
+    KWin - the KDE window manager
+    This file is part of the KDE project.
+
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "startuptracer.h"
+#include "ftrace.h"
+#include "utils/common.h"
+
+#include <QCoreApplication>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
+#include <QThread>
+
+#include <vector>
+
+namespace KWin
+{
+
+struct StartupEvent
+{
+    const char *name;
+    std::chrono::steady_clock::time_point start;
+    std::chrono::steady_clock::duration duration;
+    quintptr thread;
+    bool instant;
+};
+
+struct StartupTrace
+{
+    QMutex mutex;
+    // the time the first static object is initialized at is close enough to the process start
+    const std::chrono::steady_clock::time_point origin = std::chrono::steady_clock::now();
+    std::vector<StartupEvent> events;
+    bool finished = false;
+};
+
+static StartupTrace &startupTrace()
+{
+    static StartupTrace trace;
+    return trace;
+}
+
+static void record(const StartupEvent &event)
+{
+    StartupTrace &trace = startupTrace();
+    QMutexLocker locker(&trace.mutex);
+    if (!trace.finished) {
+        trace.events.push_back(event);
+    }
+}
+
+static quintptr currentThread()
+{
+    return reinterpret_cast<quintptr>(QThread::currentThreadId());
+}
+
+StartupTracer::Stage::Stage(const char *name)
+    : m_name(name)
+    , m_start(std::chrono::steady_clock::now())
+{
+    if (FTraceLogger::self() && FTraceLogger::self()->isEnabled()) {
+        m_ftrace = std::make_unique<FTraceDuration>("Startup ", name);
+    }
+}
+
+StartupTracer::Stage::~Stage()
+{
+    record(StartupEvent{
+        .name = m_name,
+        .start = m_start,
+        .duration = std::chrono::steady_clock::now() - m_start,
+        .thread = currentThread(),
+        .instant = false,
+    });
+}
+
+void StartupTracer::mark(const char *name)
+{
+    fTrace("Startup ", name);
+    record(StartupEvent{
+        .name = name,
+        .start = std::chrono::steady_clock::now(),
+        .duration = std::chrono::steady_clock::duration::zero(),
+        .thread = currentThread(),
+        .instant = true,
+    });
+}
+
+bool StartupTracer::isFinished()
+{
+    StartupTrace &trace = startupTrace();
+    QMutexLocker locker(&trace.mutex);
+    return trace.finished;
+}
+
+static qint64 toMicroseconds(std::chrono::steady_clock::duration duration)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+}
+
+void StartupTracer::finish()
+{
+    StartupTrace &trace = startupTrace();
+    QMutexLocker locker(&trace.mutex);
+    if (trace.finished) {
+        return;
+    }
+    trace.finished = true;
+
+    // startup is finished on the main thread
+    const quintptr mainThread = currentThread();
+    QJsonArray traceEvents;
+    for (const StartupEvent &event : trace.events) {
+        const qint64 start = toMicroseconds(event.start - trace.origin);
+        if (event.instant) {
+            qCDebug(KWIN_CORE, "Startup: %s after %lldms", event.name, start / 1000);
+        } else {
+            qCDebug(KWIN_CORE, "Startup: %s took %lldms%s", event.name, toMicroseconds(event.duration) / 1000, event.thread == mainThread ? "" : " (worker thread)");
+        }
+
+        QJsonObject object{
+            {QStringLiteral("name"), QString::fromLatin1(event.name)},
+            {QStringLiteral("cat"), QStringLiteral("startup")},
+            {QStringLiteral("ph"), event.instant ? QStringLiteral("i") : QStringLiteral("X")},
+            {QStringLiteral("ts"), start},
+            {QStringLiteral("pid"), QCoreApplication::applicationPid()},
+            {QStringLiteral("tid"), qint64(event.thread)},
+        };
+        if (event.instant) {
+            object[QStringLiteral("s")] = QStringLiteral("g");
+        } else {
+            object[QStringLiteral("dur")] = toMicroseconds(event.duration);
+        }
+        traceEvents.append(object);
+    }
+    trace.events.clear();
+
+    const QString fileName = qEnvironmentVariable("KWIN_STARTUP_TRACE_FILE");
+    if (fileName.isEmpty()) {
+        return;
+    }
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qCWarning(KWIN_CORE) << "Failed to write the startup trace to" << fileName << file.errorString();
+        return;
+    }
+    file.write(QJsonDocument(QJsonObject{{QStringLiteral("traceEvents"), traceEvents}}).toJson(QJsonDocument::Compact));
+}
+
+} // namespace KWin
@@ -0,0 +1,69 @@
+/*
+    KWin - the KDE window manager
+    This file is part of the KDE project.
+
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+
+#include "kwin_export.h"
+
+#include <QByteArray>
+
+#include <chrono>
+#include <memory>
+
+namespace KWin
+{
+
+class FTraceDuration;
+
+/**
+ * The StartupTracer records how long the stages of the compositor startup take, from the
+ * creation of the application to the presentation of the first frame.
+ *
+ * Every stage is also written to the ftrace log if it's enabled. If the KWIN_STARTUP_TRACE_FILE
+ * environment variable is set, the stages are written to the given file in the Chrome trace
+ * event format once startup has finished, so that they can be inspected with tools such as
+ * chrome://tracing or Perfetto.
+ */
+class KWIN_EXPORT StartupTracer
+{
+public:
+    /**
+     * The Stage class records the time from its construction to its destruction as one stage.
+     * Stages may be recorded on any thread.
+     */
+    class KWIN_EXPORT Stage
+    {
+    public:
+        explicit Stage(const char *name);
+        ~Stage();
+
+    private:
+        const char *m_name;
+        std::chrono::steady_clock::time_point m_start;
+        std::unique_ptr<FTraceDuration> m_ftrace;
+    };
+
+    /**
+     * Records that @a name happened now, e.g. the first frame being presented.
+     */
+    static void mark(const char *name);
+
+    /**
+     * Logs the recorded stages and writes the trace file. Stages recorded afterwards are ignored.
+     */
+    static void finish();
+
+    static bool isFinished();
+};
+
+} // namespace KWin
+
+/**
+ * Records the time until the end of the current block as a startup stage.
+ */
+#define startupStage(name) KWin::StartupTracer::Stage _startupStage(name)
@@ -239,9 +239,38 @@ void ClientModel::createClientList(bool partialReset)
         return;
     }
 
-    beginResetModel();
-    m_clientList = m_mutableClientList;
-    endResetModel();
+    // Update the list in place, resetting the model would make the switcher recreate all
+    // of its delegates. Usually, only the previously active window moves to the front
+    for (int i = m_clientList.size() - 1; i >= 0; i--) {
+        if (!m_mutableClientList.contains(m_clientList[i])) {
+            beginRemoveRows(QModelIndex(), i, i);
+            m_clientList.removeAt(i);
+            endRemoveRows();
+        }
+    }
+    for (int i = 0; i < m_mutableClientList.size(); i++) {
+        Window *window = m_mutableClientList[i];
+        if (i < m_clientList.size() && m_clientList[i] == window) {
+            continue;
+        }
+        const int current = m_clientList.indexOf(window, i);
+        if (current != -1) {
+            beginMoveRows(QModelIndex(), current, current, QModelIndex(), i);
+            m_clientList.move(current, i);
+            endMoveRows();
+        } else {
+            beginInsertRows(QModelIndex(), i, i);
+            m_clientList.insert(i, window);
+            endInsertRows();
+        }
+    }
+    while (m_clientList.size() > m_mutableClientList.size()) {
+        // only happens if a window was in the old list more than once
+        const int last = m_clientList.size() - 1;
+        beginRemoveRows(QModelIndex(), last, last);
+        m_clientList.removeLast();
+        endRemoveRows();
+    }
 }
 
 void ClientModel::close(int i)
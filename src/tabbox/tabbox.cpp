@@ -285,7 +285,11 @@ TabBox::TabBox()
 
     m_tabBoxMode = TabBoxWindowsMode; // init variables
     connect(&m_delayedShowTimer, &QTimer::timeout, this, &TabBox::show);
-    connect(Workspace::self(), &Workspace::configChanged, this, &TabBox::reconfigure);
+    connect(Workspace::self(), &Workspace::configChanged, this, [this]() {
+        if (Workspace::self()->isConfigGroupChanged(QStringLiteral("TabBox")) || Workspace::self()->isConfigGroupChanged(QStringLiteral("TabBoxAlternative"))) {
+            reconfigure();
+        }
+    });
     connect(Workspace::self(), &Workspace::windowAdded, this, &TabBox::handleWindowAdded);
     connect(Workspace::self(), &Workspace::windowRemoved, this, &TabBox::handleWindowRemoved);
     Workspace::self()->forEachWindow([this](Window *window) {
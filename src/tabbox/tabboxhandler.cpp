@@ -98,15 +98,20 @@ TabBoxHandlerPrivate::~TabBoxHandlerPrivate()
     qDeleteAll(m_clientTabBoxes);
 }
 
-QQuickWindow *TabBoxHandlerPrivate::window() const
+static QQuickWindow *findWindow(QObject *mainItem)
 {
-    if (!m_mainItem) {
+    if (!mainItem) {
         return nullptr;
     }
-    if (QQuickWindow *w = qobject_cast<QQuickWindow *>(m_mainItem)) {
+    if (QQuickWindow *w = qobject_cast<QQuickWindow *>(mainItem)) {
         return w;
     }
-    return m_mainItem->findChild<QQuickWindow *>();
+    return mainItem->findChild<QQuickWindow *>();
+}
+
+QQuickWindow *TabBoxHandlerPrivate::window() const
+{
+    return findWindow(m_mainItem);
 }
 
 #ifndef KWIN_UNIT_TEST
@@ -219,13 +224,14 @@ void TabBoxHandlerPrivate::show()
         }
         return nullptr;
     };
-    m_mainItem = nullptr;
     m_mainItem = findMainItem(m_clientTabBoxes);
+    bool created = false;
     if (!m_mainItem) {
         m_mainItem = createSwitcherItem();
         if (!m_mainItem) {
             return;
         }
+        created = true;
     }
     if (SwitcherItem *item = switcherItem()) {
         // In case the model isn't yet set (see below), index will be reset and therefore we
@@ -239,21 +245,28 @@ void TabBoxHandlerPrivate::show()
         item->setNoModifierGrab(q->noModifierGrab());
         Q_EMIT item->aboutToShow();
 
-        // When SwitcherItem gets hidden, destroy also the window and main item
-        QObject::connect(item, &SwitcherItem::visibleChanged, q, [this, item]() {
-            if (!item->isVisible()) {
-                if (QQuickWindow *w = window()) {
-                    w->hide();
-                    w->destroy();
+        if (created) {
+            // When SwitcherItem gets hidden, hide also the window. The window and its scene graph
+            // are kept around, so that showing the switcher again only takes a single frame
+            QObject *mainItem = m_mainItem;
+            QObject::connect(item, &SwitcherItem::visibleChanged, q, [this, item, mainItem]() {
+                if (!item->isVisible()) {
+                    if (QQuickWindow *w = findWindow(mainItem)) {
+                        w->hide();
+                    }
+                    if (m_mainItem == mainItem) {
+                        m_mainItem = nullptr;
+                    }
                 }
-                m_mainItem = nullptr;
-            }
-        });
+            });
+        }
 
         // everything is prepared, so let's make the whole thing visible
         item->setVisible(true);
     }
-    if (QWindow *w = window()) {
+    if (QQuickWindow *w = window()) {
+        w->setPersistentGraphics(true);
+        w->setPersistentSceneGraph(true);
         wheelAngleDelta = 0;
         w->installEventFilter(q);
         // pretend to activate the window to enable accessibility notifications
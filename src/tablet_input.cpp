@@ -28,6 +28,7 @@
 
 #include <QAction>
 #include <QHoverEvent>
+#include <QTimer>
 #include <QWindow>
 
 namespace KWin
@@ -75,11 +76,59 @@ public:
             m_shapeSource->setShape(shape);
             setSource(m_shapeSource.get());
         });
+
+        m_settleTimer.setSingleShot(true);
+        connect(&m_settleTimer, &QTimer::timeout, this, [this]() {
+            // the tool has stopped, don't leave the cursor ahead of it
+            m_velocity = QPointF();
+            setPos(m_lastSample->position);
+        });
+    }
+
+    /**
+     * Moves the cursor to where the tool is expected to be @a horizon after the sample at
+     * @a position has been taken, so the cursor lags less behind the tool. The velocity of
+     * the tool is estimated from the previous samples.
+     */
+    void setPredictedPos(const QPointF &position, std::chrono::microseconds timestamp, std::chrono::milliseconds horizon, const RectF &bounds)
+    {
+        if (m_lastSample && timestamp > m_lastSample->timestamp && timestamp - m_lastSample->timestamp < s_maximumSampleInterval) {
+            const QPointF velocity = (position - m_lastSample->position) / std::chrono::duration<qreal>(timestamp - m_lastSample->timestamp).count();
+            // smooth out the jitter of the samples
+            m_velocity = (m_velocity + velocity) / 2;
+        } else {
+            m_velocity = QPointF();
+        }
+        m_lastSample = Sample{
+            .position = position,
+            .timestamp = timestamp,
+        };
+        setPos(confineToBoundingBox(position + m_velocity * std::chrono::duration<qreal>(horizon).count(), bounds));
+        m_settleTimer.start(horizon * 2);
+    }
+
+    void resetPrediction()
+    {
+        m_lastSample.reset();
+        m_velocity = QPointF();
+        m_settleTimer.stop();
     }
 
 private:
+    struct Sample
+    {
+        QPointF position;
+        std::chrono::microseconds timestamp;
+    };
+
+    // samples further apart belong to different strokes
+    static constexpr std::chrono::milliseconds s_maximumSampleInterval{50};
+
     std::unique_ptr<ShapeCursorSource> m_shapeSource;
     std::unique_ptr<SurfaceCursorSource> m_surfaceSource;
+    std::optional<Sample> m_lastSample;
+    QPointF m_velocity;
+    QTimer m_settleTimer;
 };
 
 TabletInputRedirection::TabletInputRedirection(InputRedirection *parent)
@@ -214,7 +263,7 @@ void TabletInputRedirection::ensureTabletTool(InputDeviceTabletTool *device)
     m_cursorByTool[device] = cursor;
 }
 
-void TabletInputRedirection::setPosition(InputDeviceTabletTool *tool, const QPointF &position)
+void TabletInputRedirection::setPosition(InputDeviceTabletTool *tool, const QPointF &position, std::optional<std::chrono::microseconds> time, InputDevice *device)
 {
     m_lastPosition = position;
 
@@ -222,7 +271,15 @@ void TabletInputRedirection::setPosition(InputDeviceTabletTool *tool, const QPoi
     LogicalOutput *output = Workspace::self()->outputAt(m_lastPosition);
     m_lastPosition = confineToBoundingBox(m_lastPosition, output->geometryF());
 
-    m_cursorByTool[tool]->setPos(m_lastPosition);
+    // only the cursor is moved ahead, the clients get the positions as they have been sampled
+    auto cursor = m_cursorByTool[tool];
+    const std::chrono::milliseconds horizon(device ? device->tabletToolCursorPrediction() : 0);
+    if (time && horizon > std::chrono::milliseconds::zero()) {
+        cursor->setPredictedPos(m_lastPosition, *time, horizon, output->geometryF());
+    } else {
+        cursor->resetPrediction();
+        cursor->setPos(m_lastPosition);
+    }
     workspace()->setActiveOutput(m_lastPosition);
     input()->setLastPosition(m_lastPosition);
 }
@@ -234,7 +291,7 @@ void TabletInputRedirection::tabletToolAxisEvent(const QPointF &pos, qreal press
     }
 
     ensureTabletTool(tool);
-    setPosition(tool, pos);
+    setPosition(tool, pos, time, device);
 
     update();
 
@@ -266,7 +323,7 @@ void TabletInputRedirection::tabletToolAxisEventRelative(const QPointF &delta,
     }
 
     ensureTabletTool(tool);
-    setPosition(tool, m_lastPosition + delta);
+    setPosition(tool, m_lastPosition + delta, time, device);
 
     update();
 
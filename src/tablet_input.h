@@ -15,10 +15,13 @@
 #include <QPointF>
 #include <QPointer>
 
+#include <chrono>
+#include <optional>
+
 namespace KWin
 {
 
-class Cursor;
+class SurfaceCursor;
 class InputDeviceTabletTool;
 class TabletToolV2Interface;
 class TabletV2Interface;
@@ -75,12 +78,12 @@ private:
     void removeDevice(InputDevice *device);
     void trackNextOutput();
     void ensureTabletTool(InputDeviceTabletTool *tool);
-    void setPosition(InputDeviceTabletTool *tool, const QPointF &position);
+    void setPosition(InputDeviceTabletTool *tool, const QPointF &position, std::optional<std::chrono::microseconds> time = std::nullopt, InputDevice *device = nullptr);
 
     QPointF m_lastPosition;
     QMetaObject::Connection m_decorationGeometryConnection;
     QMetaObject::Connection m_decorationDestroyedConnection;
-    QHash<InputDeviceTabletTool *, Cursor *> m_cursorByTool;
+    QHash<InputDeviceTabletTool *, SurfaceCursor *> m_cursorByTool;
     bool m_tipDown = false;
     bool m_buttonDown = false;
 };
@@ -12,6 +12,7 @@
 #include "effect/globals.h"
 #include "tilemanager.h"
 #include "window.h"
+#include "workspace.h"
 
 namespace KWin
 {
@@ -64,6 +65,8 @@ void CustomTile::setRelativeGeometry(const RectF &geom)
         return;
     }
 
+    // the neighbors and children are adjusted as well, some of them several times
+    GeometryUpdatesBatcher batcher(workspace());
     auto *parentT = static_cast<CustomTile *>(parentTile());
 
     if (!m_geometryLock && parentT && parentT->layoutDirection() != LayoutDirection::Floating) {
@@ -280,6 +283,7 @@ void CustomTile::remove()
     auto *prev = previousSibling();
     auto *next = nextSibling();
 
+    GeometryUpdatesBatcher batcher(workspace());
     TileModel *model = static_cast<RootTile *>(rootTile())->model();
     model->beginRemoveTile(this);
     parentT->removeChild(this);
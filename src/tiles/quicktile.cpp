@@ -10,6 +10,7 @@
 #include "quicktile.h"
 #include "tilemanager.h"
 #include "virtualdesktops.h"
+#include "workspace.h"
 
 namespace KWin
 {
@@ -144,6 +145,7 @@ void QuickRootTile::setHorizontalSplit(qreal split)
 {
     const QSizeF minSize = minimumSize(); // minimum size is the same for all tiles
     const qreal effectiveSplit = std::clamp(split, minSize.width(), 1.0 - minSize.width());
+    GeometryUpdatesBatcher batcher(workspace());
 
     auto geom = m_leftVerticalTile->relativeGeometry();
     geom.setRight(effectiveSplit);
@@ -179,6 +181,7 @@ void QuickRootTile::setVerticalSplit(qreal split)
 {
     const QSizeF minSize = minimumSize(); // minimum size is the same for all tiles
     const qreal effectiveSplit = std::clamp(split, minSize.height(), 1.0 - minSize.height());
+    GeometryUpdatesBatcher batcher(workspace());
 
     auto geom = m_topHorizontalTile->relativeGeometry();
     geom.setBottom(effectiveSplit);
@@ -140,7 +140,7 @@ void Tile::setRelativeGeometry(const RectF &geom)
     if (isActive()) {
         for (auto *w : std::as_const(m_windows)) {
             // Resize only if we are the currently managing tile for that window
-            w->moveResize(windowGeometry());
+            workspace()->moveResizeBatched(w, windowGeometry());
         }
     }
 }
@@ -239,6 +239,7 @@ void Tile::setPadding(qreal padding)
     }
 
     m_padding = padding;
+    GeometryUpdatesBatcher batcher(workspace());
 
     for (auto *t : std::as_const(m_children)) {
         t->setPadding(padding);
@@ -246,7 +247,7 @@ void Tile::setPadding(qreal padding)
     if (isActive()) {
         for (auto *w : std::as_const(m_windows)) {
             // Resize only if we are the currently managing tile for that window
-            w->moveResize(windowGeometry());
+            workspace()->moveResizeBatched(w, windowGeometry());
         }
     }
 
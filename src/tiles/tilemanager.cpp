@@ -160,6 +160,29 @@ Tile *TileManager::tileForWindow(Window *window, VirtualDesktop *desktop)
     return m_rootTiles[desktop]->tileForWindow(window);
 }
 
+QHash<Window *, Tile *> TileManager::windowTiles(VirtualDesktop *desktop)
+{
+    QHash<Window *, Tile *> tiles;
+    if (!desktop) {
+        return tiles;
+    }
+    Q_ASSERT(m_rootTiles.contains(desktop));
+    Q_ASSERT(m_quickRootTiles.contains(desktop));
+
+    // quick tiles take precedence over custom tiles
+    m_rootTiles[desktop]->visitDescendants([&tiles](Tile *tile) {
+        for (Window *window : tile->windows()) {
+            tiles.insert(window, tile);
+        }
+    });
+    m_quickRootTiles[desktop]->visitDescendants([&tiles](Tile *tile) {
+        for (Window *window : tile->windows()) {
+            tiles.insert(window, tile);
+        }
+    });
+    return tiles;
+}
+
 void TileManager::forgetWindow(Window *window, VirtualDesktop *desktop)
 {
     if (!window) {
@@ -296,6 +319,7 @@ void TileManager::readSettings(RootTile *rootTile)
     padding = cg.readEntry("padding", padding);
 
     Q_ASSERT(m_rootTiles.contains(desk));
+    GeometryUpdatesBatcher batcher(workspace());
 
     auto createDefaultSetup = [](RootTile *rootTile) {
         Q_ASSERT(rootTile->childCount() == 0);
@@ -17,6 +17,7 @@
 #include <kwin_export.h>
 
 #include <QAbstractItemModel>
+#include <QHash>
 #include <QObject>
 
 #include <QJsonValue>
@@ -57,6 +58,11 @@ public:
     TileModel *model() const;
 
     Tile *tileForWindow(Window *window, VirtualDesktop *desktop);
+    /**
+     * Returns the tile of every window that is tiled on the @a desktop, like tileForWindow()
+     * would return it, but without searching all tiles for every window.
+     */
+    QHash<Window *, Tile *> windowTiles(VirtualDesktop *desktop);
     void forgetWindow(Window *window, VirtualDesktop *desktop);
 
 Q_SIGNALS:
@@ -30,6 +30,8 @@
 #include <QHoverEvent>
 #include <QWindow>
 
+#include <algorithm>
+
 namespace KWin
 {
 
@@ -47,6 +49,12 @@ void TouchInputRedirection::init()
     connect(input(), &InputRedirection::hasTouchChanged,
             waylandServer()->seat(), &SeatInterface::setHasTouch);
 
+    connect(input(), &InputRedirection::deviceRemoved, this, [this](InputDevice *device) {
+        if (m_framedDevices.remove(device)) {
+            flushPendingMotions();
+        }
+    });
+
     setInited(true);
     InputDeviceHandler::init();
 
@@ -111,6 +119,7 @@ void TouchInputRedirection::processDown(qint32 id, const QPointF &pos, std::chro
     if (!inited()) {
         return;
     }
+    flushPendingMotions();
     m_lastPosition = pos;
     m_windowUpdatedInCycle = false;
     m_activeTouchPoints.insert(id);
@@ -144,6 +153,7 @@ void TouchInputRedirection::processUp(qint32 id, std::chrono::microseconds time,
     if (!inited()) {
         return;
     }
+    flushPendingMotions();
     if (!m_activeTouchPoints.remove(id)) {
         return;
     }
@@ -171,6 +181,26 @@ void TouchInputRedirection::processMotion(qint32 id, const QPointF &pos, std::ch
     if (!m_activeTouchPoints.contains(id)) {
         return;
     }
+    if (device && m_framedDevices.contains(device)) {
+        // only the last position of a touch point in the frame matters
+        const auto it = std::ranges::find(m_pendingMotions, id, &PendingMotion::id);
+        if (it != m_pendingMotions.end()) {
+            it->pos = pos;
+            it->time = time;
+        } else {
+            m_pendingMotions.append(PendingMotion{
+                .id = id,
+                .pos = pos,
+                .time = time,
+            });
+        }
+        return;
+    }
+    dispatchMotion(id, pos, time);
+}
+
+void TouchInputRedirection::dispatchMotion(qint32 id, const QPointF &pos, std::chrono::microseconds time)
+{
     input()->setLastInputHandler(this);
     m_lastPosition = pos;
 
@@ -186,11 +216,23 @@ void TouchInputRedirection::processMotion(qint32 id, const QPointF &pos, std::ch
     m_windowUpdatedInCycle = false;
 }
 
+void TouchInputRedirection::flushPendingMotions()
+{
+    const QList<PendingMotion> motions = std::exchange(m_pendingMotions, {});
+    for (const PendingMotion &motion : motions) {
+        // the touch point might have been cancelled by a filter in the meantime
+        if (m_activeTouchPoints.contains(motion.id)) {
+            dispatchMotion(motion.id, motion.pos, motion.time);
+        }
+    }
+}
+
 void TouchInputRedirection::cancel()
 {
     if (!inited()) {
         return;
     }
+    m_pendingMotions.clear();
     // If the touch sequence is artificially cancelled by the compositor, touch motion and touch
     // up events will be silently ignored and won't be passed down through the event filter chain.
     // If the touch sequence is cancelled because we received a TOUCH_CANCEL event from libinput,
@@ -201,11 +243,15 @@ void TouchInputRedirection::cancel()
     }
 }
 
-void TouchInputRedirection::frame()
+void TouchInputRedirection::frame(InputDevice *device)
 {
     if (!inited() || !waylandServer()->seat()->hasTouch()) {
         return;
     }
+    if (device) {
+        m_framedDevices.insert(device);
+    }
+    flushPendingMotions();
     input()->processFilters(&InputEventFilter::touchFrame);
 }
 
@@ -45,7 +45,7 @@ public:
     void processUp(qint32 id, std::chrono::microseconds time, InputDevice *device = nullptr);
     void processMotion(qint32 id, const QPointF &pos, std::chrono::microseconds time, InputDevice *device = nullptr);
     void cancel();
-    void frame();
+    void frame(InputDevice *device = nullptr);
 
     void setDecorationPressId(qint32 id)
     {
@@ -71,7 +71,24 @@ private:
 
     void focusUpdate(Window *focusOld, Window *focusNow) override;
 
+    void dispatchMotion(qint32 id, const QPointF &pos, std::chrono::microseconds time);
+    void flushPendingMotions();
+
+    struct PendingMotion
+    {
+        qint32 id;
+        QPointF pos;
+        std::chrono::microseconds time;
+    };
+
     QSet<qint32> m_activeTouchPoints;
+    /**
+     * Devices that end their events with touch frames. Their motion events are held back
+     * until the end of the frame, so that every touch point is only processed once per
+     * frame, however many motion events the device sent for it.
+     */
+    QSet<InputDevice *> m_framedDevices;
+    QList<PendingMotion> m_pendingMotions;
     qint32 m_decorationId = -1;
     bool m_windowUpdatedInCycle = false;
     QPointF m_lastPosition;
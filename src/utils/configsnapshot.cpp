@@ -0,0 +1,54 @@
+/*
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "utils/configsnapshot.h"
+
+#include <KConfig>
+#include <KConfigGroup>
+
+namespace KWin
+{
+
+static void collectEntries(const KConfigGroup &group, const QString &prefix, QMap<QString, QString> &entries)
+{
+    const QMap<QString, QString> groupEntries = group.entryMap();
+    for (auto it = groupEntries.cbegin(); it != groupEntries.cend(); ++it) {
+        entries.insert(prefix + it.key(), it.value());
+    }
+
+    const QStringList subGroups = group.groupList();
+    for (const QString &name : subGroups) {
+        collectEntries(group.group(name), prefix + QLatin1Char('[') + name + QLatin1Char(']'), entries);
+    }
+}
+
+ConfigSnapshot::ConfigSnapshot(const KConfig *config)
+{
+    const QStringList groups = config->groupList();
+    for (const QString &name : groups) {
+        QMap<QString, QString> &entries = m_groups[name];
+        collectEntries(config->group(name), QString(), entries);
+    }
+}
+
+QSet<QString> ConfigSnapshot::changedGroups(const ConfigSnapshot &other) const
+{
+    QSet<QString> changed;
+    for (auto it = m_groups.cbegin(); it != m_groups.cend(); ++it) {
+        const auto otherIt = other.m_groups.constFind(it.key());
+        if (otherIt == other.m_groups.cend() || *otherIt != *it) {
+            changed.insert(it.key());
+        }
+    }
+    for (auto it = other.m_groups.cbegin(); it != other.m_groups.cend(); ++it) {
+        if (!m_groups.contains(it.key())) {
+            changed.insert(it.key());
+        }
+    }
+    return changed;
+}
+
+} // namespace KWin
@@ -0,0 +1,44 @@
+/*
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include "kwin_export.h"
+
+#include <QHash>
+#include <QMap>
+#include <QSet>
+#include <QString>
+
+class KConfig;
+
+namespace KWin
+{
+
+/**
+ * The ConfigSnapshot type records the entries of all top level groups of a config, so
+ * that the groups that changed between two points in time can be found. The entries of
+ * nested groups are recorded as part of the top level group they belong to.
+ */
+class KWIN_EXPORT ConfigSnapshot
+{
+public:
+    ConfigSnapshot() = default;
+    explicit ConfigSnapshot(const KConfig *config);
+
+    /**
+     * Returns the names of the top level groups whose entries differ between the two snapshots,
+     * including the groups that only exist in one of them.
+     */
+    QSet<QString> changedGroups(const ConfigSnapshot &other) const;
+
+    bool operator==(const ConfigSnapshot &other) const = default;
+
+private:
+    QHash<QString, QMap<QString, QString>> m_groups;
+};
+
+} // namespace KWin
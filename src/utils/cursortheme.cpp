@@ -12,6 +12,8 @@
 #include <KConfigGroup>
 #include <KShell>
 
+#include <QCache>
+#include <QDateTime>
 #include <QDir>
 #include <QSet>
 #include <QSharedData>
@@ -113,6 +115,41 @@ std::chrono::milliseconds CursorSprite::delay() const
     return d->delay;
 }
 
+struct CursorSpriteCacheKey
+{
+    QString path;
+    QDateTime lastModified;
+    int size;
+    qreal devicePixelRatio;
+
+    bool operator==(const CursorSpriteCacheKey &other) const = default;
+};
+
+static size_t qHash(const CursorSpriteCacheKey &key, size_t seed = 0)
+{
+    return qHashMulti(seed, key.path, key.lastModified, key.size, key.devicePixelRatio);
+}
+
+/**
+ * Rasterized sprites are shared between all cursor themes in the process, so switching between
+ * themes, sizes or scale factors, or loading the theme for another output, only needs to read the
+ * cursor files and render svg cursors once. The cost of an entry is its size in KiB.
+ */
+static QCache<CursorSpriteCacheKey, QList<CursorSprite>> &spriteCache()
+{
+    static QCache<CursorSpriteCacheKey, QList<CursorSprite>> cache(32 * 1024);
+    return cache;
+}
+
+static qsizetype spriteCacheCost(const QList<CursorSprite> &sprites)
+{
+    qsizetype bytes = 0;
+    for (const CursorSprite &sprite : sprites) {
+        bytes += sprite.data().sizeInBytes();
+    }
+    return bytes / 1024 + 1;
+}
+
 CursorThemePrivate::CursorThemePrivate()
 {
 }
@@ -135,10 +172,28 @@ void CursorThemeEntry::load(int size, qreal devicePixelRatio)
         return;
     }
 
-    if (const auto raster = std::get_if<CursorThemeXEntryInfo>(&info)) {
-        sprites = XCursorReader::load(raster->path, size, devicePixelRatio);
-    } else if (const auto svg = std::get_if<CursorThemeSvgEntryInfo>(&info)) {
-        sprites = SvgCursorReader::load(svg->path, size, devicePixelRatio);
+    const QString path = std::visit([](const auto &info) {
+        return info.path;
+    }, info);
+    // the modification time makes sure that updated themes are loaded again
+    const CursorSpriteCacheKey key{
+        .path = path,
+        .lastModified = QFileInfo(path).lastModified(),
+        .size = size,
+        .devicePixelRatio = devicePixelRatio,
+    };
+    if (const QList<CursorSprite> *cached = spriteCache().object(key)) {
+        sprites = *cached;
+        return;
+    }
+
+    if (std::holds_alternative<CursorThemeXEntryInfo>(info)) {
+        sprites = XCursorReader::load(path, size, devicePixelRatio);
+    } else if (std::holds_alternative<CursorThemeSvgEntryInfo>(info)) {
+        sprites = SvgCursorReader::load(path, size, devicePixelRatio);
+    }
+    if (!sprites.isEmpty()) {
+        spriteCache().insert(key, new QList<CursorSprite>(sprites), spriteCacheCost(sprites));
     }
 }
 
@@ -200,8 +255,9 @@ void CursorThemePrivate::discoverSvgCursors(const QString &packagePath)
 
 static QStringList defaultSearchPaths()
 {
-    static QStringList paths;
-    if (paths.isEmpty()) {
+    // cursor themes may be loaded in worker threads
+    static const QStringList paths = []() {
+        QStringList paths;
         if (const QString env = qEnvironmentVariable("XCURSOR_PATH"); !env.isEmpty()) {
             const QStringList rawPaths = env.split(':', Qt::SkipEmptyParts);
             for (const QString &rawPath : rawPaths) {
@@ -217,7 +273,8 @@ static QStringList defaultSearchPaths()
                 paths.append(dataDir + QLatin1StringView("/icons"));
             }
         }
-    }
+        return paths;
+    }();
     return paths;
 }
 
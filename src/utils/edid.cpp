@@ -16,6 +16,7 @@
 #include "envvar.h"
 
 #include <QFile>
+#include <QHash>
 #include <QStandardPaths>
 #include <cstdlib>
 
@@ -77,22 +78,26 @@ static QByteArray parseEisaId(const uint8_t *data)
     return parsePnpId(data);
 }
 
-static QByteArray parseVendor(const uint8_t *data)
+static QHash<QByteArray, QByteArray> loadVendors()
 {
-    const auto pnpId = parsePnpId(data);
-
-    // Map to vendor name
+    QHash<QByteArray, QByteArray> vendors;
     QFile pnpFile(QStandardPaths::locate(QStandardPaths::GenericDataLocation, QStringLiteral("hwdata/pnp.ids")));
     if (pnpFile.exists() && pnpFile.open(QIODevice::ReadOnly)) {
         while (!pnpFile.atEnd()) {
             const auto line = pnpFile.readLine();
-            if (line.startsWith(pnpId)) {
-                return line.mid(4).trimmed();
-            }
+            vendors.tryEmplace(line.left(3), line.mid(4).trimmed());
         }
     }
+    return vendors;
+}
 
-    return {};
+static QByteArray parseVendor(const uint8_t *data)
+{
+    // The list of vendors is long, read it only once instead of for every EDID
+    static const QHash<QByteArray, QByteArray> vendors = loadVendors();
+
+    // Map to vendor name
+    return vendors.value(parsePnpId(data));
 }
 
 static QSize determineScreenPhysicalSizeMm(const di_edid *edid)
@@ -0,0 +1,62 @@
+/*
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "utils/framearena.h"
+
+#include <bit>
+
+namespace KWin
+{
+
+void *FrameArena::OverflowResource::do_allocate(size_t bytes, size_t alignment)
+{
+    allocated += bytes;
+    return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+}
+
+void FrameArena::OverflowResource::do_deallocate(void *p, size_t bytes, size_t alignment)
+{
+    std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+}
+
+bool FrameArena::OverflowResource::do_is_equal(const std::pmr::memory_resource &other) const noexcept
+{
+    return this == &other;
+}
+
+FrameArena::FrameArena(size_t initialCapacity)
+    : m_buffer(std::make_unique<std::byte[]>(initialCapacity))
+    , m_capacity(initialCapacity)
+{
+    m_resource.emplace(m_buffer.get(), m_capacity, &m_overflow);
+}
+
+std::pmr::memory_resource *FrameArena::resource()
+{
+    return &*m_resource;
+}
+
+size_t FrameArena::capacity() const
+{
+    return m_capacity;
+}
+
+void FrameArena::reset()
+{
+    m_resource->release();
+
+    if (m_overflow.allocated) {
+        // make the buffer big enough for frames like the last one
+        m_capacity = std::bit_ceil(m_capacity + m_overflow.allocated);
+        m_overflow.allocated = 0;
+
+        m_resource.reset();
+        m_buffer = std::make_unique<std::byte[]>(m_capacity);
+        m_resource.emplace(m_buffer.get(), m_capacity, &m_overflow);
+    }
+}
+
+} // namespace KWin
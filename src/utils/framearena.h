@@ -0,0 +1,63 @@
+/*
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include "kwin_export.h"
+
+#include <memory>
+#include <memory_resource>
+#include <optional>
+
+namespace KWin
+{
+
+/**
+ * The FrameArena class is a bump allocator for temporary objects that only live while a
+ * frame is being painted, for example the render node lists of the item renderer.
+ *
+ * Memory is handed out by a std::pmr::memory_resource, so the arena can be used with
+ * std::pmr containers. Nothing is freed until reset() is called, at which point all memory
+ * that has been allocated from the arena must not be in use anymore. If a frame needed more
+ * memory than the arena had, the arena grows on reset() so the next frames don't need to hit
+ * the general purpose allocator.
+ */
+class KWIN_EXPORT FrameArena
+{
+public:
+    explicit FrameArena(size_t initialCapacity = 64 * 1024);
+
+    std::pmr::memory_resource *resource();
+
+    /**
+     * Returns the size of the preallocated buffer.
+     */
+    size_t capacity() const;
+
+    /**
+     * Releases all memory that has been allocated since the last reset.
+     */
+    void reset();
+
+private:
+    class OverflowResource : public std::pmr::memory_resource
+    {
+    public:
+        size_t allocated = 0;
+
+    protected:
+        void *do_allocate(size_t bytes, size_t alignment) override;
+        void do_deallocate(void *p, size_t bytes, size_t alignment) override;
+        bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override;
+    };
+
+    std::unique_ptr<std::byte[]> m_buffer;
+    size_t m_capacity;
+    OverflowResource m_overflow;
+    std::optional<std::pmr::monotonic_buffer_resource> m_resource;
+};
+
+} // namespace KWin
@@ -8,22 +8,341 @@
 
 #include "config-kwin.h"
 
+#include <QDir>
+#include <QFile>
+
+#include <algorithm>
+#include <mutex>
 #include <pthread.h>
+#include <ranges>
 #include <sched.h>
+#include <vector>
+
+#if defined(Q_OS_LINUX)
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
 
 namespace KWin
 {
 
-void gainRealTime()
+namespace
+{
+
+enum class Policy {
+    None,
+    RoundRobin,
+    Fifo,
+    Deadline,
+};
+
+struct Settings
+{
+    Policy policy = Policy::RoundRobin;
+    std::optional<int> priority;
+    int runtimePercent = 25;
+    std::optional<int> utilizationMin;
+    std::optional<int> utilizationMax;
+    QString cpus;
+};
+
+#if defined(Q_OS_LINUX)
+// glibc doesn't provide a wrapper for sched_setattr on all versions that we support
+struct SchedAttr
+{
+    uint32_t size;
+    uint32_t policy;
+    uint64_t flags;
+    int32_t nice;
+    uint32_t priority;
+    uint64_t runtime;
+    uint64_t deadline;
+    uint64_t period;
+    uint32_t utilizationMin;
+    uint32_t utilizationMax;
+};
+
+static constexpr uint32_t s_schedDeadline = 6;
+static constexpr uint64_t s_flagResetOnFork = 0x01;
+static constexpr uint64_t s_flagKeepPolicy = 0x08;
+static constexpr uint64_t s_flagKeepParams = 0x10;
+static constexpr uint64_t s_flagUtilClampMin = 0x20;
+static constexpr uint64_t s_flagUtilClampMax = 0x40;
+
+static int setSchedAttr(SchedAttr &attr)
+{
+    attr.size = sizeof(SchedAttr);
+    return syscall(SYS_sched_setattr, 0, &attr, 0);
+}
+#endif
+
+struct ThreadState
+{
+    ~ThreadState();
+
+    Settings settings;
+    RealTimeThreadInfo info;
+    std::chrono::nanoseconds requestedPeriod = std::chrono::nanoseconds::zero();
+};
+
+} // namespace
+
+static std::mutex s_registryMutex;
+static std::vector<RealTimeThreadInfo> s_registry;
+static thread_local std::optional<ThreadState> t_state;
+
+static void publish(const RealTimeThreadInfo &info)
+{
+    std::unique_lock lock(s_registryMutex);
+    const auto it = std::ranges::find(s_registry, info.threadId, &RealTimeThreadInfo::threadId);
+    if (it != s_registry.end()) {
+        *it = info;
+    } else {
+        s_registry.push_back(info);
+    }
+}
+
+ThreadState::~ThreadState()
+{
+    std::unique_lock lock(s_registryMutex);
+    std::erase_if(s_registry, [this](const RealTimeThreadInfo &other) {
+        return other.threadId == info.threadId;
+    });
+}
+
+const char *realTimeRoleName(RealTimeRole role)
+{
+    switch (role) {
+    case RealTimeRole::Compositor:
+        return "compositor";
+    case RealTimeRole::Commit:
+        return "commit";
+    case RealTimeRole::Input:
+        return "input";
+    }
+    Q_UNREACHABLE();
+}
+
+static std::optional<int> intOption(const QByteArray &name)
+{
+    bool ok = false;
+    const int value = qEnvironmentVariableIntValue(name.constData(), &ok);
+    return ok ? std::make_optional(value) : std::nullopt;
+}
+
+static Settings readSettings(RealTimeRole role)
+{
+    const QByteArray prefix = QByteArrayLiteral("KWIN_REALTIME_") + QByteArray(realTimeRoleName(role)).toUpper() + '_';
+
+    Settings settings;
+    const QString policy = qEnvironmentVariable(prefix + "POLICY");
+    if (policy == QLatin1String("none")) {
+        settings.policy = Policy::None;
+    } else if (policy == QLatin1String("fifo")) {
+        settings.policy = Policy::Fifo;
+    } else if (policy == QLatin1String("deadline")) {
+        settings.policy = Policy::Deadline;
+    } else if (!policy.isEmpty() && policy != QLatin1String("rr")) {
+        qWarning("Unknown scheduling policy %s for the %s thread", qPrintable(policy), realTimeRoleName(role));
+    }
+    settings.priority = intOption(prefix + "PRIORITY");
+    settings.runtimePercent = std::clamp(intOption(prefix + "RUNTIME_PERCENT").value_or(25), 1, 100);
+    settings.utilizationMin = intOption(prefix + "UCLAMP_MIN").transform([](int value) {
+        return std::clamp(value, 0, 1024);
+    });
+    settings.utilizationMax = intOption(prefix + "UCLAMP_MAX").transform([](int value) {
+        return std::clamp(value, 0, 1024);
+    });
+    settings.cpus = qEnvironmentVariable(prefix + "CPUS");
+    return settings;
+}
+
+static QList<int> parseCpuList(const QString &list)
+{
+    QList<int> ret;
+    const auto ranges = QStringView(list).trimmed().split(QLatin1Char(','), Qt::SkipEmptyParts);
+    for (const QStringView range : ranges) {
+        const auto bounds = range.split(QLatin1Char('-'));
+        bool firstOk = false;
+        bool lastOk = false;
+        const int first = bounds.front().toInt(&firstOk);
+        const int last = bounds.size() == 2 ? bounds.back().toInt(&lastOk) : first;
+        if (!firstOk || (bounds.size() == 2 && !lastOk) || bounds.size() > 2) {
+            return {};
+        }
+        for (int cpu = first; cpu <= last; cpu++) {
+            ret.push_back(cpu);
+        }
+    }
+    return ret;
+}
+
+/**
+ * Returns the fastest cores of hybrid CPUs, or an empty list if all cores are the same.
+ */
+static QList<int> performanceCores()
+{
+    // Intel hybrid CPUs expose the performance cores as a separate PMU
+    QFile intelCores(QStringLiteral("/sys/devices/cpu_core/cpus"));
+    if (intelCores.open(QIODevice::ReadOnly)) {
+        return parseCpuList(QString::fromLatin1(intelCores.readAll()));
+    }
+
+    // on ARM and some others, the relative capacity of each core is known
+    QList<std::pair<int, int>> capacities;
+    const QDir cpuDir(QStringLiteral("/sys/devices/system/cpu"));
+    const QStringList entries = cpuDir.entryList({QStringLiteral("cpu[0-9]*")}, QDir::Dirs);
+    for (const QString &entry : entries) {
+        QFile capacity(cpuDir.filePath(entry + QLatin1String("/cpu_capacity")));
+        if (capacity.open(QIODevice::ReadOnly)) {
+            capacities.push_back({QStringView(entry).mid(3).toInt(), capacity.readAll().trimmed().toInt()});
+        }
+    }
+    if (capacities.isEmpty()) {
+        return {};
+    }
+    const auto [minCapacity, maxCapacity] = std::ranges::minmax(capacities | std::views::values);
+    if (minCapacity == maxCapacity) {
+        return {};
+    }
+    QList<int> ret;
+    for (const auto &[cpu, capacity] : capacities) {
+        if (capacity == maxCapacity) {
+            ret.push_back(cpu);
+        }
+    }
+    std::ranges::sort(ret);
+    return ret;
+}
+
+static void applyFixedPriority(const Settings &settings, RealTimeThreadInfo &info)
 {
 #if HAVE_SCHED_RESET_ON_FORK
-    const int minPriority = sched_get_priority_min(SCHED_RR);
+    // SCHED_DEADLINE needs the period, until it's known SCHED_RR is used
+    const int policy = settings.policy == Policy::Fifo ? SCHED_FIFO : SCHED_RR;
+    const int minPriority = sched_get_priority_min(policy);
+    const int maxPriority = sched_get_priority_max(policy);
     sched_param sp;
-    sp.sched_priority = minPriority;
-    if (pthread_setschedparam(pthread_self(), SCHED_RR | SCHED_RESET_ON_FORK, &sp) != 0) {
-        qWarning("Failed to gain real time thread priority (See CAP_SYS_NICE in the capabilities(7) man page). error: %s", strerror(errno));
+    sp.sched_priority = std::clamp(settings.priority.value_or(minPriority), minPriority, maxPriority);
+    if (const int error = pthread_setschedparam(pthread_self(), policy | SCHED_RESET_ON_FORK, &sp); error != 0) {
+        qWarning("Failed to gain real time thread priority (See CAP_SYS_NICE in the capabilities(7) man page). error: %s", strerror(error));
+        info.errors.append(QStringLiteral("%1: %2").arg(policy == SCHED_FIFO ? QStringLiteral("fifo") : QStringLiteral("rr"), QString::fromLocal8Bit(strerror(error))));
+        return;
+    }
+    info.policy = policy == SCHED_FIFO ? QStringLiteral("fifo") : QStringLiteral("rr");
+    info.priority = sp.sched_priority;
+#endif
+}
+
+static void applyUtilizationClamp(const Settings &settings, RealTimeThreadInfo &info)
+{
+    if (!settings.utilizationMin && !settings.utilizationMax) {
+        return;
+    }
+#if defined(Q_OS_LINUX)
+    SchedAttr attr{};
+    attr.flags = s_flagKeepPolicy | s_flagKeepParams;
+    if (settings.utilizationMin) {
+        attr.flags |= s_flagUtilClampMin;
+        attr.utilizationMin = *settings.utilizationMin;
+    }
+    if (settings.utilizationMax) {
+        attr.flags |= s_flagUtilClampMax;
+        attr.utilizationMax = *settings.utilizationMax;
+    }
+    if (setSchedAttr(attr) != 0) {
+        qWarning("Failed to set the utilization clamping hints of the %s thread: %s", realTimeRoleName(info.role), strerror(errno));
+        info.errors.append(QStringLiteral("uclamp: %1").arg(QString::fromLocal8Bit(strerror(errno))));
+        return;
+    }
+    info.utilizationMin = settings.utilizationMin;
+    info.utilizationMax = settings.utilizationMax;
+#endif
+}
+
+static void applyAffinity(const Settings &settings, RealTimeThreadInfo &info)
+{
+    if (settings.cpus.isEmpty()) {
+        return;
+    }
+    if (settings.policy == Policy::Deadline) {
+        // the kernel rejects SCHED_DEADLINE for threads that may only run on some CPUs
+        info.errors.append(QStringLiteral("affinity: not supported with deadline scheduling"));
+        return;
+    }
+#if defined(Q_OS_LINUX)
+    const QList<int> cpus = settings.cpus == QLatin1String("performance") ? performanceCores() : parseCpuList(settings.cpus);
+    if (cpus.isEmpty()) {
+        return;
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : cpus) {
+        if (cpu >= 0 && cpu < CPU_SETSIZE) {
+            CPU_SET(cpu, &set);
+        }
+    }
+    if (const int error = pthread_setaffinity_np(pthread_self(), sizeof(set), &set); error != 0) {
+        qWarning("Failed to set the CPU affinity of the %s thread: %s", realTimeRoleName(info.role), strerror(error));
+        info.errors.append(QStringLiteral("affinity: %1").arg(QString::fromLocal8Bit(strerror(error))));
+        return;
     }
+    info.cpus = cpus;
 #endif
 }
 
+void gainRealTime(RealTimeRole role, const QString &name)
+{
+    ThreadState &state = t_state.emplace();
+    state.settings = readSettings(role);
+    state.info.name = name;
+    state.info.role = role;
+    state.info.policy = QStringLiteral("other");
+#if defined(Q_OS_LINUX)
+    state.info.threadId = gettid();
+#endif
+
+    if (state.settings.policy != Policy::None) {
+        applyFixedPriority(state.settings, state.info);
+    }
+    applyUtilizationClamp(state.settings, state.info);
+    applyAffinity(state.settings, state.info);
+    publish(state.info);
+}
+
+void setRealTimePeriod(std::chrono::nanoseconds period)
+{
+    if (!t_state || t_state->settings.policy != Policy::Deadline || t_state->requestedPeriod == period) {
+        return;
+    }
+#if defined(Q_OS_LINUX)
+    ThreadState &state = *t_state;
+    state.requestedPeriod = period;
+    const std::chrono::nanoseconds runtime = period * state.settings.runtimePercent / 100;
+    SchedAttr attr{};
+    attr.policy = s_schedDeadline;
+    attr.flags = s_flagResetOnFork;
+    attr.runtime = runtime.count();
+    attr.deadline = period.count();
+    attr.period = period.count();
+    if (setSchedAttr(attr) != 0) {
+        // most likely, admission control didn't accept the bandwidth
+        qWarning("Failed to use deadline scheduling for the %s thread: %s", realTimeRoleName(state.info.role), strerror(errno));
+        state.info.errors.append(QStringLiteral("deadline: %1").arg(QString::fromLocal8Bit(strerror(errno))));
+    } else {
+        state.info.policy = QStringLiteral("deadline");
+        state.info.priority = 0;
+        state.info.runtime = runtime;
+        state.info.period = period;
+    }
+    publish(state.info);
+#endif
+}
+
+QList<RealTimeThreadInfo> realTimeThreads()
+{
+    std::unique_lock lock(s_registryMutex);
+    return QList<RealTimeThreadInfo>(s_registry.begin(), s_registry.end());
+}
+
 } // namespace KWin
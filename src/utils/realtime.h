@@ -8,12 +8,74 @@
 
 #include "kwin_export.h"
 
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+#include <chrono>
+#include <optional>
+
 namespace KWin
 {
 
 /**
- * Makes the calling thread to use realtime scheduling.
+ * The threads that use realtime scheduling. Each of them can be configured separately.
+ */
+enum class RealTimeRole {
+    Compositor,
+    Commit,
+    Input,
+};
+
+KWIN_EXPORT const char *realTimeRoleName(RealTimeRole role);
+
+/**
+ * Describes the scheduling settings that have been applied to a thread.
+ */
+struct RealTimeThreadInfo
+{
+    QString name;
+    RealTimeRole role;
+    int threadId = 0;
+    QString policy;
+    int priority = 0;
+    /**
+     * The runtime budget and the period of threads that use SCHED_DEADLINE
+     */
+    std::chrono::nanoseconds runtime = std::chrono::nanoseconds::zero();
+    std::chrono::nanoseconds period = std::chrono::nanoseconds::zero();
+    std::optional<int> utilizationMin;
+    std::optional<int> utilizationMax;
+    /**
+     * The CPUs the thread may run on, or an empty list if it may run on all of them
+     */
+    QList<int> cpus;
+    QStringList errors;
+};
+
+/**
+ * Makes the calling thread to use realtime scheduling. By default, SCHED_RR with the minimum
+ * priority is used, this can be changed for every role with environment variables, for
+ * example for the commit threads:
+ * - KWIN_REALTIME_COMMIT_POLICY: none, rr, fifo or deadline
+ * - KWIN_REALTIME_COMMIT_PRIORITY: the priority for rr and fifo
+ * - KWIN_REALTIME_COMMIT_RUNTIME_PERCENT: the runtime budget for deadline, in percent of the period
+ * - KWIN_REALTIME_COMMIT_UCLAMP_MIN, KWIN_REALTIME_COMMIT_UCLAMP_MAX: utilization clamping hints, from 0 to 1024
+ * - KWIN_REALTIME_COMMIT_CPUS: a list of CPUs like "0-3,8", or "performance" for the fastest cores of hybrid CPUs
+ *
+ * SCHED_DEADLINE needs a period, threads use SCHED_RR until they call setRealTimePeriod().
+ */
+KWIN_EXPORT void gainRealTime(RealTimeRole role, const QString &name);
+
+/**
+ * Tells the scheduler that the calling thread has work to do once every @a period. This only
+ * has an effect for threads that are configured to use SCHED_DEADLINE.
+ */
+KWIN_EXPORT void setRealTimePeriod(std::chrono::nanoseconds period);
+
+/**
+ * Returns the scheduling settings of all threads that currently use realtime scheduling.
  */
-KWIN_EXPORT void gainRealTime();
+KWIN_EXPORT QList<RealTimeThreadInfo> realTimeThreads();
 
 } // namespace KWin
@@ -0,0 +1,79 @@
+/*
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <optional>
+
+namespace KWin
+{
+
+/**
+ * The SpscQueue class is a bounded lock-free queue for exactly one producer thread and one
+ * consumer thread. push() may only be called by the producer, peek() and pop() only by the
+ * consumer.
+ */
+template<typename T, size_t Capacity>
+class SpscQueue
+{
+    static_assert(std::has_single_bit(Capacity), "the capacity must be a power of two");
+
+public:
+    /**
+     * Appends @a value to the queue. If the queue is full, @a value is left untouched
+     * and false is returned.
+     */
+    bool push(T &&value)
+    {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_head.load() == Capacity) {
+            return false;
+        }
+        m_slots[tail % Capacity] = std::move(value);
+        m_tail.store(tail + 1);
+        return true;
+    }
+
+    /**
+     * Returns the element @a offset positions after the front of the queue without
+     * removing it, or @c nullptr if the queue doesn't contain that many elements.
+     */
+    T *peek(size_t offset = 0)
+    {
+        const size_t head = m_head.load(std::memory_order_relaxed);
+        if (m_tail.load() - head <= offset) {
+            return nullptr;
+        }
+        return &m_slots[(head + offset) % Capacity];
+    }
+
+    std::optional<T> pop()
+    {
+        const size_t head = m_head.load(std::memory_order_relaxed);
+        if (m_tail.load() == head) {
+            return std::nullopt;
+        }
+        std::optional<T> ret(std::move(m_slots[head % Capacity]));
+        m_head.store(head + 1);
+        return ret;
+    }
+
+    bool isFull() const
+    {
+        return m_tail.load() - m_head.load() == Capacity;
+    }
+
+private:
+    std::array<T, Capacity> m_slots{};
+    // keep the indices in separate cache lines, so the threads don't invalidate each other's
+    alignas(64) std::atomic<size_t> m_head = 0;
+    alignas(64) std::atomic<size_t> m_tail = 0;
+};
+
+} // namespace KWin
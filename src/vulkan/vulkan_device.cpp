@@ -13,6 +13,7 @@
 #include "vulkan_texture.h"
 
 #include <QDebug>
+#include <algorithm>
 #include <sys/stat.h>
 
 namespace KWin
@@ -29,19 +30,24 @@ VulkanDevice::VulkanDevice(vk::raii::PhysicalDevice physicalDevice, vk::raii::De
     , m_queueProperties(std::move(queueProperties))
     , m_graphicsQueue(nullptr)
     , m_commandPool(nullptr)
+    , m_transferQueue(nullptr)
+    , m_transferCommandPool(nullptr)
     , m_deviceLimits(m_physical.getProperties().limits)
 {
     m_memoryProperties = physicalDevice.getMemoryProperties();
     getQueue();
     createCommandPool();
+    QMetaObject::invokeMethod(this, &VulkanDevice::warmUpCopies, Qt::QueuedConnection);
 }
 
 VulkanDevice::~VulkanDevice()
 {
     Q_EMIT deviceLost();
-    m_graphicsQueue.waitIdle();
+    waitIdle();
     m_importedTextures.clear();
+    m_warmUpTextures.clear();
     m_submittedCommandBuffers.clear();
+    m_transferCommandPool.clear();
     m_commandPool.clear();
     m_logical.clear();
 }
@@ -54,20 +60,41 @@ void VulkanDevice::getQueue()
     Q_ASSERT(it != m_queueProperties.end());
     m_queueFamilyIndex = std::distance(m_queueProperties.begin(), it);
     m_graphicsQueue = m_logical.getQueue(m_queueFamilyIndex, 0);
+
+    // the device is created with one queue of every family, so
+    // a dedicated transfer queue can be used if there is one
+    it = std::ranges::find_if(m_queueProperties, [](const VkQueueFamilyProperties &props) {
+        return (props.queueFlags & VK_QUEUE_TRANSFER_BIT) && !(props.queueFlags & (VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT));
+    });
+    if (it != m_queueProperties.end()) {
+        m_transferQueueFamilyIndex = std::distance(m_queueProperties.begin(), it);
+        m_transferQueue = m_logical.getQueue(*m_transferQueueFamilyIndex, 0);
+    }
 }
 
 void VulkanDevice::createCommandPool()
 {
-    // only one queue for now -> also only one command pool
+    m_commandPool = createCommandPool(m_queueFamilyIndex);
+    if (m_transferQueueFamilyIndex) {
+        m_transferCommandPool = createCommandPool(*m_transferQueueFamilyIndex);
+        if (!*m_transferCommandPool) {
+            m_transferQueue.clear();
+            m_transferQueueFamilyIndex.reset();
+        }
+    }
+}
+
+vk::raii::CommandPool VulkanDevice::createCommandPool(uint32_t queueFamily)
+{
     auto [result, cmdPool] = m_logical.createCommandPool(vk::CommandPoolCreateInfo{
         vk::CommandPoolCreateFlagBits::eResetCommandBuffer,
-        m_queueFamilyIndex,
+        queueFamily,
     });
     if (result != vk::Result::eSuccess) {
         qCCritical(KWIN_VULKAN) << "creating a command pool failed:" << vk::to_string(result);
-        return;
+        return nullptr;
     }
-    m_commandPool = std::move(cmdPool);
+    return std::move(cmdPool);
 }
 
 std::shared_ptr<VulkanTexture> VulkanDevice::importBuffer(GraphicsBuffer *buffer, VkImageUsageFlags usage)
@@ -357,6 +384,19 @@ uint32_t VulkanDevice::graphicsQueueFamily() const
     return m_queueFamilyIndex;
 }
 
+bool VulkanDevice::hasTransferQueue() const
+{
+    return m_transferQueueFamilyIndex.has_value();
+}
+
+uint32_t VulkanDevice::queueFamily(Queue queue) const
+{
+    if (queue == Queue::Transfer && m_transferQueueFamilyIndex) {
+        return *m_transferQueueFamilyIndex;
+    }
+    return m_queueFamilyIndex;
+}
+
 std::span<const VkQueueFamilyProperties> VulkanDevice::queueFamilyProperties() const
 {
     return m_queueProperties;
@@ -367,7 +407,7 @@ float VulkanDevice::nanosecondsPerQueryTick() const
     return m_deviceLimits.timestampPeriod;
 }
 
-vk::raii::CommandBuffer VulkanDevice::createCommandBuffer()
+vk::raii::CommandBuffer VulkanDevice::createCommandBuffer(Queue queue)
 {
     // clean up old command buffers first
     for (auto it = m_submittedCommandBuffers.begin(); it != m_submittedCommandBuffers.end();) {
@@ -379,9 +419,14 @@ vk::raii::CommandBuffer VulkanDevice::createCommandBuffer()
             it++;
         }
     }
+    if (!m_warmUpTextures.empty() && m_warmUpFence.isReadable()) {
+        m_warmUpTextures.clear();
+        m_warmUpFence = FileDescriptor{};
+    }
 
+    const bool transfer = queue == Queue::Transfer && m_transferQueueFamilyIndex;
     auto [result, buffers] = m_logical.allocateCommandBuffers(vk::CommandBufferAllocateInfo{
-        m_commandPool,
+        transfer ? m_transferCommandPool : m_commandPool,
         vk::CommandBufferLevel::ePrimary,
         1,
     });
@@ -417,7 +462,7 @@ std::optional<vk::raii::Semaphore> VulkanDevice::importSemaphore(FileDescriptor
     return std::move(semaphore);
 }
 
-std::optional<FileDescriptor> VulkanDevice::submit(vk::raii::CommandBuffer &&buffer, FileDescriptor &&syncFd)
+std::optional<FileDescriptor> VulkanDevice::submit(vk::raii::CommandBuffer &&buffer, FileDescriptor &&syncFd, Queue queue)
 {
     vk::ExportFenceCreateInfo exportInfo{
         vk::ExternalFenceHandleTypeFlagBits::eSyncFd,
@@ -436,13 +481,14 @@ std::optional<FileDescriptor> VulkanDevice::submit(vk::raii::CommandBuffer &&buf
         waitSemaphores.push_back(*waitSemaphore);
         waitFlags.push_back(vk::PipelineStageFlagBits::eAllCommands);
     }
-    vk::Result result = m_graphicsQueue.submit(vk::SubmitInfo{
-                                                   waitSemaphores,
-                                                   waitFlags,
-                                                   *buffer,
-                                                   {},
-                                               },
-                                               fence);
+    const vk::raii::Queue &submitQueue = queue == Queue::Transfer && m_transferQueueFamilyIndex ? m_transferQueue : m_graphicsQueue;
+    vk::Result result = submitQueue.submit(vk::SubmitInfo{
+                                               waitSemaphores,
+                                               waitFlags,
+                                               *buffer,
+                                               {},
+                                           },
+                                           fence);
     if (result == vk::Result::eErrorDeviceLost) {
         handleDeviceLoss();
         return std::nullopt;
@@ -465,6 +511,72 @@ std::optional<FileDescriptor> VulkanDevice::submit(vk::raii::CommandBuffer &&buf
     return ret;
 }
 
+// the formats that multi-GPU copies are usually done with
+static constexpr std::array s_warmUpFormats = {
+    DRM_FORMAT_ARGB8888,
+    DRM_FORMAT_ABGR8888,
+    DRM_FORMAT_ARGB2101010,
+    DRM_FORMAT_ABGR2101010,
+    DRM_FORMAT_ABGR16161616F,
+};
+
+void VulkanDevice::warmUpCopies()
+{
+    // Drivers implement blits with internal pipelines, which they only compile the first
+    // time a blit with the format is recorded. Doing that before any output needs a
+    // multi-GPU copy keeps the compilation out of its first frame. The pipelines end up
+    // in the shader disk cache of the driver, so later sessions just load them
+    if (m_lost || isSoftwareRenderer()) {
+        return;
+    }
+    auto commandBuffer = createCommandBuffer();
+    if (!*commandBuffer || commandBuffer.begin(vk::CommandBufferBeginInfo{vk::CommandBufferUsageFlagBits::eOneTimeSubmit}) != vk::Result::eSuccess) {
+        return;
+    }
+    constexpr int size = 16;
+    const vk::ImageSubresourceLayers layers{
+        vk::ImageAspectFlagBits::eColor,
+        0,
+        0,
+        1,
+    };
+    std::vector<std::unique_ptr<VulkanTexture>> textures;
+    std::vector<VkFormat> vulkanFormats;
+    for (const uint32_t drmFormat : s_warmUpFormats) {
+        const auto info = FormatInfo::get(drmFormat);
+        if (!info || info->vulkanFormat == VK_FORMAT_UNDEFINED || !m_formats.contains(drmFormat) || std::ranges::contains(vulkanFormats, info->vulkanFormat)) {
+            continue;
+        }
+        const vk::FormatFeatureFlags features = m_physical.getFormatProperties(vk::Format(info->vulkanFormat)).optimalTilingFeatures;
+        if (!(features & vk::FormatFeatureFlagBits::eBlitSrc) || !(features & vk::FormatFeatureFlagBits::eBlitDst)) {
+            continue;
+        }
+        vulkanFormats.push_back(info->vulkanFormat);
+        auto texture = VulkanTexture::allocate(this, vk::Format(info->vulkanFormat), QSize(2 * size, size), vk::ImageUsageFlagBits::eTransferSrc | vk::ImageUsageFlagBits::eTransferDst);
+        if (!texture) {
+            continue;
+        }
+        // one image is enough, as long as the source and destination regions don't overlap
+        commandBuffer.blitImage(texture->handle(), vk::ImageLayout::eGeneral,
+                                texture->handle(), vk::ImageLayout::eGeneral,
+                                vk::ImageBlit{
+                                    layers,
+                                    std::array{vk::Offset3D{0, 0, 0}, vk::Offset3D{size, size, 1}},
+                                    layers,
+                                    std::array{vk::Offset3D{size, 0, 0}, vk::Offset3D{2 * size, size, 1}},
+                                },
+                                vk::Filter::eNearest);
+        textures.push_back(std::move(texture));
+    }
+    if (commandBuffer.end() != vk::Result::eSuccess || textures.empty()) {
+        return;
+    }
+    if (auto fence = submit(std::move(commandBuffer), FileDescriptor{})) {
+        m_warmUpTextures = std::move(textures);
+        m_warmUpFence = std::move(*fence);
+    }
+}
+
 void VulkanDevice::handleDeviceLoss()
 {
     if (m_lost) {
@@ -522,6 +634,9 @@ vk::raii::DeviceMemory VulkanDevice::allocateMemory(const vk::BufferCreateInfo &
 void VulkanDevice::waitIdle()
 {
     m_graphicsQueue.waitIdle();
+    if (m_transferQueueFamilyIndex) {
+        m_transferQueue.waitIdle();
+    }
 }
 
 }
@@ -49,15 +49,27 @@ public:
     const FormatModifierMap &supportedFormats() const;
     const vk::raii::Device &logicalDevice() const;
 
+    enum class Queue {
+        Graphics,
+        /**
+         * A queue that only supports transfer operations. On dedicated GPUs, it's usually
+         * backed by a copy engine that works in parallel to rendering.
+         * If the device doesn't have one, the graphics queue is used instead
+         */
+        Transfer,
+    };
+
     const vk::raii::Queue &graphicsQueue() const;
     uint32_t graphicsQueueFamily() const;
+    bool hasTransferQueue() const;
+    uint32_t queueFamily(Queue queue) const;
     std::span<const VkQueueFamilyProperties> queueFamilyProperties() const;
     float nanosecondsPerQueryTick() const;
 
-    vk::raii::CommandBuffer createCommandBuffer();
+    vk::raii::CommandBuffer createCommandBuffer(Queue queue = Queue::Graphics);
     std::optional<vk::raii::Semaphore> importSemaphore(FileDescriptor &&syncFd) const;
 
-    std::optional<FileDescriptor> submit(vk::raii::CommandBuffer &&buffer, FileDescriptor &&syncFd);
+    std::optional<FileDescriptor> submit(vk::raii::CommandBuffer &&buffer, FileDescriptor &&syncFd, Queue queue = Queue::Graphics);
     /**
      * NOTE avoid using this if at all possible, it's obviously terrible for performance!
      */
@@ -96,9 +108,11 @@ Q_SIGNALS:
 private:
     void getQueue();
     void createCommandPool();
+    vk::raii::CommandPool createCommandPool(uint32_t queueFamily);
     FormatModifierMap queryFormats(VkImageUsageFlags flags) const;
     std::optional<uint32_t> findMemoryType(uint32_t typeBits, vk::MemoryPropertyFlags memoryPropertyFlags) const;
     std::shared_ptr<VulkanTexture> importDmabuf(const DmaBufAttributes *attributes, VkImageUsageFlags usage);
+    void warmUpCopies();
 
     vk::PhysicalDeviceType m_type;
     vk::raii::PhysicalDevice m_physical;
@@ -108,6 +122,9 @@ private:
     vk::raii::Queue m_graphicsQueue;
     vk::raii::CommandPool m_commandPool;
     uint32_t m_queueFamilyIndex;
+    vk::raii::Queue m_transferQueue;
+    vk::raii::CommandPool m_transferCommandPool;
+    std::optional<uint32_t> m_transferQueueFamilyIndex;
     vk::PhysicalDeviceMemoryProperties m_memoryProperties;
     struct SubmittedCommand
     {
@@ -119,6 +136,9 @@ private:
     vk::PhysicalDeviceLimits m_deviceLimits;
 
     QHash<GraphicsBuffer *, std::shared_ptr<VulkanTexture>> m_importedTextures;
+    // kept until the warm up copies are done
+    std::vector<std::unique_ptr<VulkanTexture>> m_warmUpTextures;
+    FileDescriptor m_warmUpFence;
     bool m_lost = false;
 };
 
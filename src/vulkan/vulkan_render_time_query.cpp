@@ -45,6 +45,7 @@ std::optional<RenderTimeSpan> VulkanRenderTimeQuery::query()
         }
         const uint64_t gpuTicks = timestamps[1] - timestamps[0];
         const std::chrono::nanoseconds gpuDuration(uint64_t(std::round(gpuTicks * m_device->nanosecondsPerQueryTick())));
+        m_gpuTime = gpuDuration;
         m_result = RenderTimeSpan{
             .start = m_cpuProbe.start,
             .end = std::max(m_cpuProbe.end, m_cpuProbe.start + gpuDuration),
@@ -53,6 +54,11 @@ std::optional<RenderTimeSpan> VulkanRenderTimeQuery::query()
     return m_result;
 }
 
+std::chrono::nanoseconds VulkanRenderTimeQuery::gpuTime() const
+{
+    return m_gpuTime;
+}
+
 void VulkanRenderTimeQuery::reset()
 {
     m_pool.clear();
@@ -31,6 +31,7 @@ public:
      * fetches the result of the query. If rendering is not done yet, this will block!
      */
     std::optional<RenderTimeSpan> query() override;
+    std::chrono::nanoseconds gpuTime() const override;
 
     static std::unique_ptr<VulkanRenderTimeQuery> begin(VulkanDevice *device, vk::raii::CommandBuffer &buffer, uint32_t queueFamily);
 
@@ -46,6 +47,7 @@ private:
         std::chrono::steady_clock::time_point end;
     } m_cpuProbe;
     std::optional<RenderTimeSpan> m_result;
+    std::chrono::nanoseconds m_gpuTime{0};
 };
 
 }
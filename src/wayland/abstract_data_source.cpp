@@ -5,6 +5,8 @@
 */
 
 #include "abstract_data_source.h"
+#include "utils/envvar.h"
+#include "wayland/datasourcecache.h"
 
 namespace KWin
 {
@@ -14,6 +16,23 @@ AbstractDataSource::AbstractDataSource(QObject *parent)
 {
 }
 
+AbstractDataSource::~AbstractDataSource() = default;
+
+void AbstractDataSource::receive(const QString &mimeType, FileDescriptor fd)
+{
+    static const bool cacheEnabled = environmentVariableBoolValue("KWIN_SELECTION_CACHE").value_or(true);
+    if (cacheEnabled) {
+        if (!m_cache) {
+            m_cache = std::make_unique<DataSourceCache>(this);
+        }
+        if (m_cache->canCache(mimeType)) {
+            m_cache->send(mimeType, std::move(fd));
+            return;
+        }
+    }
+    requestData(mimeType, std::move(fd));
+}
+
 void AbstractDataSource::setKeyboardModifiers(Qt::KeyboardModifiers heldModifiers)
 {
     if (m_heldModifiers == heldModifiers) {
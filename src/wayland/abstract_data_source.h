@@ -11,11 +11,15 @@
 #include "clientconnection.h"
 #include "utils/filedescriptor.h"
 
+#include <memory>
+
 struct wl_client;
 
 namespace KWin
 {
 
+class DataSourceCache;
+
 /**
  * Drag and Drop actions supported by the data source.
  */
@@ -42,6 +46,8 @@ class KWIN_EXPORT AbstractDataSource : public QObject
     Q_OBJECT
 
 public:
+    ~AbstractDataSource() override;
+
     virtual bool isAccepted() const
     {
         return false;
@@ -51,6 +57,11 @@ public:
     {
     }
     virtual void requestData(const QString &mimeType, FileDescriptor fd) = 0;
+    /**
+     * Sends the data for the given @p mimeType to @p fd. Unlike requestData(), the source gets
+     * asked for text and images only once, the data is shared with all other readers.
+     */
+    void receive(const QString &mimeType, FileDescriptor fd);
     virtual void cancel() = 0;
 
     virtual QStringList mimeTypes() const = 0;
@@ -138,6 +149,7 @@ protected:
     explicit AbstractDataSource(QObject *parent = nullptr);
 
 private:
+    std::unique_ptr<DataSourceCache> m_cache;
     std::optional<DnDAction> m_exclusiveAction;
     Qt::KeyboardModifiers m_heldModifiers;
     bool m_dndCancelled = false;
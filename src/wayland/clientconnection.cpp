@@ -7,7 +7,9 @@
 
 #include "config-kwin.h"
 
+#include "commitlatency.h"
 #include "display.h"
+#include "ftrace.h"
 #include "utils/executable_path.h"
 // Qt
 #include <QFileInfo>
@@ -72,6 +74,12 @@ public:
     qreal scaleOverride = 1.0;
     bool sandboxed = false;
     bool tearingDown = false;
+    quint64 requestCount = 0;
+    quint32 dispatchRequestCount = 0;
+    quint32 lastDispatchRequestCount = 0;
+    quint64 budgetExceededCount = 0;
+    CommitLatencyStatistics commitLatency;
+    std::optional<InputTrace> inputTrace;
 
 private:
     static void destroyListenerCallback(wl_listener *listener, void *data);
@@ -192,6 +200,7 @@ void ClientConnection::setSecurityContextAppId(const QString &appId)
 {
     d->securityContextAppId = appId;
     d->sandboxed = true;
+    Q_EMIT securityContextAppIdChanged();
 }
 
 QString ClientConnection::securityContextAppId() const
@@ -199,6 +208,66 @@ QString ClientConnection::securityContextAppId() const
     return d->securityContextAppId;
 }
 
+quint64 ClientConnection::requestCount() const
+{
+    return d->requestCount;
+}
+
+quint32 ClientConnection::lastDispatchRequestCount() const
+{
+    return d->lastDispatchRequestCount;
+}
+
+quint64 ClientConnection::budgetExceededCount() const
+{
+    return d->budgetExceededCount;
+}
+
+CommitLatencyStatistics &ClientConnection::commitLatency()
+{
+    return d->commitLatency;
+}
+
+const CommitLatencyStatistics &ClientConnection::commitLatency() const
+{
+    return d->commitLatency;
+}
+
+void ClientConnection::traceInput(std::chrono::microseconds timestamp)
+{
+    if (d->inputTrace) {
+        return;
+    }
+    static quint64 s_inputId = 0;
+    d->inputTrace = InputTrace{
+        .id = ++s_inputId,
+        .timestamp = timestamp,
+    };
+    fTrace("Input latency begin id=", d->inputTrace->id, " pid=", d->pid);
+}
+
+std::optional<InputTrace> ClientConnection::takeInputTrace()
+{
+    return std::exchange(d->inputTrace, std::nullopt);
+}
+
+bool ClientConnection::addDispatchedRequest()
+{
+    d->requestCount++;
+    return d->dispatchRequestCount++ == 0;
+}
+
+bool ClientConnection::finishDispatch(quint32 requestBudget)
+{
+    d->lastDispatchRequestCount = d->dispatchRequestCount;
+    d->dispatchRequestCount = 0;
+    if (requestBudget && d->lastDispatchRequestCount > requestBudget) {
+        d->budgetExceededCount++;
+        return true;
+    }
+    return false;
+}
+
 ClientConnection *ClientConnection::get(wl_client *native)
 {
     return static_cast<ClientConnection *>(wl_client_get_user_data(native));
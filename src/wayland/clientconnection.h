@@ -10,7 +10,9 @@
 #include <sys/types.h>
 
 #include <QObject>
+#include <chrono>
 #include <memory>
+#include <optional>
 
 struct wl_client;
 
@@ -18,7 +20,9 @@ namespace KWin
 {
 
 class ClientConnectionPrivate;
+class CommitLatencyStatistics;
 class Display;
+struct InputTrace;
 
 /**
  * @brief Convenient Class which represents a wl_client.
@@ -136,6 +140,43 @@ public:
     void setSecurityContextAppId(const QString &appId);
     QString securityContextAppId() const;
 
+    /**
+     * Returns the total number of requests that have been dispatched for this client.
+     */
+    quint64 requestCount() const;
+
+    /**
+     * Returns the number of requests that have been dispatched for this client in the last
+     * dispatch round that it took part in.
+     */
+    quint32 lastDispatchRequestCount() const;
+
+    /**
+     * Returns how many times the client has sent more requests in a single dispatch round
+     * than the request budget of the Display allows.
+     *
+     * @see Display::setDispatchBudget
+     */
+    quint64 budgetExceededCount() const;
+
+    /**
+     * Returns how long the surface commits of this client took from the commit request
+     * to being presented on an output.
+     */
+    CommitLatencyStatistics &commitLatency();
+    const CommitLatencyStatistics &commitLatency() const;
+
+    /**
+     * Notifies the client connection that an input event with the given device @a timestamp
+     * has been sent to the client. Only the first input event since the last call to
+     * takeInputTrace() is remembered.
+     */
+    void traceInput(std::chrono::microseconds timestamp);
+    /**
+     * Returns the first input event sent to the client since the last call, if any.
+     */
+    std::optional<InputTrace> takeInputTrace();
+
     /**
      * Returns the associated client connection object for the specified @a native wl_client object.
      */
@@ -148,11 +189,14 @@ Q_SIGNALS:
     void aboutToBeDestroyed();
 
     void scaleOverrideChanged();
+    void securityContextAppIdChanged();
 
 private:
     friend class ClientConnectionPrivate;
     friend class DisplayPrivate;
     explicit ClientConnection(wl_client *c, Display *parent);
+    bool addDispatchedRequest();
+    bool finishDispatch(quint32 requestBudget);
     std::unique_ptr<ClientConnectionPrivate> d;
 };
 
@@ -0,0 +1,131 @@
+/*
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+#include "wayland/commitlatency.h"
+#include "ftrace.h"
+#include "wayland/clientconnection.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace KWin
+{
+
+static constexpr std::chrono::nanoseconds s_firstBucketUpperBound = std::chrono::microseconds(250);
+
+void LatencyHistogram::add(std::chrono::nanoseconds latency)
+{
+    size_t index = 0;
+    while (index < s_bucketCount - 1 && latency > bucketUpperBound(index)) {
+        index++;
+    }
+    m_buckets[index]++;
+    m_count++;
+}
+
+quint64 LatencyHistogram::count() const
+{
+    return m_count;
+}
+
+quint64 LatencyHistogram::bucket(size_t index) const
+{
+    return m_buckets[index];
+}
+
+std::chrono::nanoseconds LatencyHistogram::bucketUpperBound(size_t index)
+{
+    if (index >= s_bucketCount - 1) {
+        return std::chrono::nanoseconds::max();
+    }
+    return s_firstBucketUpperBound * (1 << index);
+}
+
+std::chrono::nanoseconds LatencyHistogram::percentile(double percentile) const
+{
+    if (m_count == 0) {
+        return std::chrono::nanoseconds::zero();
+    }
+    const quint64 target = std::max<quint64>(1, std::ceil(m_count * std::clamp(percentile, 0.0, 1.0)));
+    quint64 accumulated = 0;
+    for (size_t i = 0; i < s_bucketCount; i++) {
+        accumulated += m_buckets[i];
+        if (accumulated >= target) {
+            return bucketUpperBound(i);
+        }
+    }
+    return bucketUpperBound(s_bucketCount - 1);
+}
+
+void CommitLatencyStatistics::add(const CommitTimings &timings, std::chrono::steady_clock::time_point painted, std::chrono::steady_clock::time_point presented)
+{
+    m_histograms[size_t(Stage::Fences)].add(timings.fencesSignaled - timings.committed);
+    m_histograms[size_t(Stage::Queue)].add(timings.applied - timings.fencesSignaled);
+    m_histograms[size_t(Stage::Paint)].add(painted - timings.applied);
+    m_histograms[size_t(Stage::Presentation)].add(presented - painted);
+    m_histograms[size_t(Stage::Total)].add(presented - timings.committed);
+    if (timings.input) {
+        m_inputLatency.add(presented - std::chrono::steady_clock::time_point(timings.input->timestamp));
+    }
+}
+
+void CommitLatencyStatistics::addDiscarded()
+{
+    m_discarded++;
+}
+
+const LatencyHistogram &CommitLatencyStatistics::histogram(Stage stage) const
+{
+    return m_histograms[size_t(stage)];
+}
+
+const LatencyHistogram &CommitLatencyStatistics::inputLatency() const
+{
+    return m_inputLatency;
+}
+
+quint64 CommitLatencyStatistics::discardedCount() const
+{
+    return m_discarded;
+}
+
+void CommitLatencyStatistics::addResizeLatency(std::chrono::nanoseconds latency)
+{
+    m_resizeLatency.add(latency);
+}
+
+const LatencyHistogram &CommitLatencyStatistics::resizeLatency() const
+{
+    return m_resizeLatency;
+}
+
+CommitLatencyFeedback::CommitLatencyFeedback(ClientConnection *client, const CommitTimings &timings)
+    : m_client(client)
+    , m_timings(timings)
+    , m_painted(std::chrono::steady_clock::now())
+{
+}
+
+CommitLatencyFeedback::~CommitLatencyFeedback()
+{
+    if (!m_presented && m_client) {
+        m_client->commitLatency().addDiscarded();
+    }
+}
+
+void CommitLatencyFeedback::presented(std::chrono::nanoseconds refreshCycleDuration, std::chrono::nanoseconds timestamp, PresentationMode mode)
+{
+    m_presented = true;
+    if (m_timings.input) {
+        const auto latency = std::chrono::duration_cast<std::chrono::microseconds>(timestamp - m_timings.input->timestamp);
+        fTrace("Input latency end id=", m_timings.input->id, " latency_us=", latency.count());
+    }
+    if (m_client) {
+        // presentation timestamps are sourced from the monotonic clock, like steady_clock
+        m_client->commitLatency().add(m_timings, m_painted, std::chrono::steady_clock::time_point(timestamp));
+    }
+}
+
+} // namespace KWin
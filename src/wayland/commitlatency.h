@@ -0,0 +1,147 @@
+/*
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+#pragma once
+
+#include "kwin_export.h"
+
+#include "core/renderbackend.h"
+
+#include <QPointer>
+
+#include <array>
+#include <chrono>
+#include <optional>
+
+namespace KWin
+{
+
+class ClientConnection;
+
+/**
+ * The LatencyHistogram class counts latencies in buckets with exponentially growing sizes.
+ * The first bucket contains latencies up to 250µs, every following bucket covers latencies
+ * up to twice the upper bound of the previous one, and the last bucket contains everything
+ * that doesn't fit in the other ones.
+ */
+class KWIN_EXPORT LatencyHistogram
+{
+public:
+    static constexpr size_t s_bucketCount = 12;
+
+    void add(std::chrono::nanoseconds latency);
+
+    quint64 count() const;
+    quint64 bucket(size_t index) const;
+    /**
+     * Returns the upper bound of the bucket, or std::chrono::nanoseconds::max() for the last one.
+     */
+    static std::chrono::nanoseconds bucketUpperBound(size_t index);
+
+    /**
+     * Returns the upper bound of the bucket that contains the given @a percentile of all
+     * latencies, or zero if there are no latencies yet.
+     */
+    std::chrono::nanoseconds percentile(double percentile) const;
+
+private:
+    std::array<quint64, s_bucketCount> m_buckets{};
+    quint64 m_count = 0;
+};
+
+/**
+ * The InputTrace type identifies an input event that has been sent to a client. The timestamp
+ * is the one provided by the input device, in the monotonic clock.
+ */
+struct InputTrace
+{
+    quint64 id;
+    std::chrono::microseconds timestamp;
+};
+
+/**
+ * The CommitTimings type describes when a surface commit went through the steps before it
+ * gets painted. If the client received input since its previous commit, @c input refers to
+ * the first input event it got, the commit is assumed to be the client's reaction to it.
+ */
+struct CommitTimings
+{
+    std::chrono::steady_clock::time_point committed;
+    std::chrono::steady_clock::time_point fencesSignaled;
+    std::chrono::steady_clock::time_point applied;
+    std::optional<InputTrace> input;
+};
+
+/**
+ * The CommitLatencyStatistics class aggregates how long the surface commits of a client take
+ * from the commit request to the presentation of the first frame that contains them. The time
+ * is split up into
+ * - Fences: waiting for the buffer of the commit to be ready to be used
+ * - Queue: waiting for previous commits, synchronized subsurfaces or fifo barriers
+ * - Paint: waiting for the compositor to paint a frame with the commit
+ * - Presentation: waiting for the painted frame to be presented
+ */
+class KWIN_EXPORT CommitLatencyStatistics
+{
+public:
+    enum class Stage {
+        Fences,
+        Queue,
+        Paint,
+        Presentation,
+        Total,
+    };
+    static constexpr size_t s_stageCount = 5;
+
+    void add(const CommitTimings &timings, std::chrono::steady_clock::time_point painted, std::chrono::steady_clock::time_point presented);
+    void addDiscarded();
+    void addResizeLatency(std::chrono::nanoseconds latency);
+
+    const LatencyHistogram &histogram(Stage stage) const;
+    /**
+     * Returns how long it took from the input events received by the client to the presentation
+     * of the commits that followed them.
+     */
+    const LatencyHistogram &inputLatency() const;
+    /**
+     * Returns the number of commits that were painted, but the frame they were painted in
+     * has never been presented.
+     */
+    quint64 discardedCount() const;
+    /**
+     * Returns how long it took from the configure events sent to the client during
+     * interactive resize to the commits of buffers for them.
+     */
+    const LatencyHistogram &resizeLatency() const;
+
+private:
+    std::array<LatencyHistogram, s_stageCount> m_histograms;
+    LatencyHistogram m_inputLatency;
+    LatencyHistogram m_resizeLatency;
+    quint64 m_discarded = 0;
+};
+
+/**
+ * \internal
+ *
+ * Records the latency of a commit in the statistics of the client once the frame it has
+ * been painted in is presented.
+ */
+class CommitLatencyFeedback : public PresentationFeedback
+{
+public:
+    CommitLatencyFeedback(ClientConnection *client, const CommitTimings &timings);
+    ~CommitLatencyFeedback() override;
+
+    void presented(std::chrono::nanoseconds refreshCycleDuration, std::chrono::nanoseconds timestamp, PresentationMode mode) override;
+
+private:
+    QPointer<ClientConnection> m_client;
+    const CommitTimings m_timings;
+    const std::chrono::steady_clock::time_point m_painted;
+    bool m_presented = false;
+};
+
+} // namespace KWin
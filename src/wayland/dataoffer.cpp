@@ -61,7 +61,7 @@ void DataOfferInterfacePrivate::data_offer_receive(Resource *resource, const QSt
     FileDescriptor pipe(fd);
 
     if (source && source->mimeTypes().contains(mime_type)) {
-        source->requestData(mime_type, std::move(pipe));
+        source->receive(mime_type, std::move(pipe));
     }
 }
 
@@ -0,0 +1,196 @@
+/*
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+#include "wayland/datasourcecache.h"
+#include "utils/common.h"
+#include "utils/pipe.h"
+#include "wayland/abstract_data_source.h"
+
+#include <array>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/sendfile.h>
+#include <unistd.h>
+
+namespace KWin
+{
+
+static void releaseNotifier(std::unique_ptr<QSocketNotifier> &notifier)
+{
+    if (notifier) {
+        // the notifier may currently be emitting the signal that led here
+        notifier->setEnabled(false);
+        notifier.release()->deleteLater();
+    }
+}
+
+DataSourceCache::DataSourceCache(AbstractDataSource *source)
+    : m_source(source)
+{
+}
+
+DataSourceCache::~DataSourceCache() = default;
+
+bool DataSourceCache::canCache(const QString &mimeType) const
+{
+    if (m_uncacheable.contains(mimeType)) {
+        return false;
+    }
+    return mimeType.startsWith(QLatin1String("text/")) || mimeType.startsWith(QLatin1String("image/"));
+}
+
+void DataSourceCache::send(const QString &mimeType, FileDescriptor &&fd)
+{
+    Entry *entry = nullptr;
+    if (auto it = m_entries.find(mimeType); it != m_entries.end()) {
+        entry = it->second.get();
+    } else {
+        entry = startReading(mimeType);
+    }
+    if (!entry) {
+        m_source->requestData(mimeType, std::move(fd));
+        return;
+    }
+
+    const int flags = fcntl(fd.get(), F_GETFL);
+    if (flags == -1 || fcntl(fd.get(), F_SETFL, flags | O_NONBLOCK) == -1) {
+        qCWarning(KWIN_CORE) << "Failed to make the selection transfer pipe non-blocking:" << strerror(errno);
+        m_source->requestData(mimeType, std::move(fd));
+        return;
+    }
+
+    auto reader = std::make_unique<Reader>();
+    reader->fd = std::move(fd);
+    reader->notifier = std::make_unique<QSocketNotifier>(reader->fd.get(), QSocketNotifier::Write);
+    reader->notifier->setEnabled(false);
+    QObject::connect(reader->notifier.get(), &QSocketNotifier::activated, reader->notifier.get(), [this, mimeType, entry]() {
+        writeReaders(mimeType, entry);
+    });
+    entry->readers.push_back(std::move(reader));
+    writeReaders(mimeType, entry);
+}
+
+DataSourceCache::Entry *DataSourceCache::startReading(const QString &mimeType)
+{
+    FileDescriptor memfd(memfd_create("selection", MFD_CLOEXEC));
+    if (!memfd.isValid()) {
+        return nullptr;
+    }
+    std::optional<Pipe> pipe = Pipe::create(O_CLOEXEC);
+    if (!pipe) {
+        return nullptr;
+    }
+    // only our end of the pipe is non-blocking, the source might not expect it
+    if (fcntl(pipe->readEndpoint.get(), F_SETFL, O_NONBLOCK) == -1) {
+        return nullptr;
+    }
+
+    auto entry = std::make_unique<Entry>();
+    entry->memfd = std::move(memfd);
+    entry->sourcePipe = std::move(pipe->readEndpoint);
+    entry->sourceNotifier = std::make_unique<QSocketNotifier>(entry->sourcePipe.get(), QSocketNotifier::Read);
+    Entry *ret = entry.get();
+    QObject::connect(entry->sourceNotifier.get(), &QSocketNotifier::activated, entry->sourceNotifier.get(), [this, mimeType, ret]() {
+        readSource(mimeType, ret);
+    });
+    m_entries[mimeType] = std::move(entry);
+
+    m_source->requestData(mimeType, std::move(pipe->writeEndpoint));
+    return ret;
+}
+
+void DataSourceCache::readSource(const QString &mimeType, Entry *entry)
+{
+    std::array<char, 64 * 1024> buffer;
+    while (true) {
+        const ssize_t count = read(entry->sourcePipe.get(), buffer.data(), buffer.size());
+        if (count > 0) {
+            if (pwrite(entry->memfd.get(), buffer.data(), count, entry->size) != count) {
+                qCWarning(KWIN_CORE) << "Failed to cache selection data:" << strerror(errno);
+                break;
+            }
+            entry->size += count;
+            if (!entry->oversized) {
+                m_totalSize += count;
+                if (m_totalSize > s_maxSize) {
+                    // the data is still sent to the readers that are waiting for it, but not kept afterwards
+                    entry->oversized = true;
+                    m_totalSize -= entry->size;
+                    m_uncacheable.insert(mimeType);
+                }
+            }
+            continue;
+        } else if (count == -1 && errno == EINTR) {
+            continue;
+        } else if (count == -1 && errno == EAGAIN) {
+            writeReaders(mimeType, entry);
+            return;
+        } else if (count == 0) {
+            entry->complete = true;
+            releaseNotifier(entry->sourceNotifier);
+            entry->sourcePipe = FileDescriptor();
+            writeReaders(mimeType, entry);
+            return;
+        }
+        qCWarning(KWIN_CORE) << "Failed to read selection data:" << strerror(errno);
+        break;
+    }
+
+    // the data is incomplete, it must not be sent to anyone who asks for it later on
+    if (!entry->oversized) {
+        entry->oversized = true;
+        m_totalSize -= entry->size;
+    }
+    m_uncacheable.insert(mimeType);
+    entry->complete = true;
+    releaseNotifier(entry->sourceNotifier);
+    entry->sourcePipe = FileDescriptor();
+    writeReaders(mimeType, entry);
+}
+
+void DataSourceCache::writeReaders(const QString &mimeType, Entry *entry)
+{
+    for (auto it = entry->readers.begin(); it != entry->readers.end();) {
+        if (writeReader(entry, it->get())) {
+            releaseNotifier((*it)->notifier);
+            it = entry->readers.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    if (entry->oversized && entry->readers.empty()) {
+        // nobody needs the data anymore
+        releaseNotifier(entry->sourceNotifier);
+        m_entries.erase(mimeType);
+    }
+}
+
+bool DataSourceCache::writeReader(Entry *entry, Reader *reader)
+{
+    while (reader->offset < entry->size) {
+        const ssize_t count = sendfile(reader->fd.get(), entry->memfd.get(), &reader->offset, entry->size - reader->offset);
+        if (count == -1) {
+            if (errno == EINTR) {
+                continue;
+            } else if (errno == EAGAIN) {
+                reader->notifier->setEnabled(true);
+                return false;
+            }
+            // most likely the reader has closed its end of the pipe
+            return true;
+        } else if (count == 0) {
+            return true;
+        }
+    }
+    if (entry->complete) {
+        return true;
+    }
+    // wait for more data from the source
+    reader->notifier->setEnabled(false);
+    return false;
+}
+
+} // namespace KWin
@@ -0,0 +1,77 @@
+/*
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+#pragma once
+
+#include "utils/filedescriptor.h"
+
+#include <QSet>
+#include <QSocketNotifier>
+#include <QString>
+
+#include <memory>
+#include <sys/types.h>
+#include <unordered_map>
+#include <vector>
+
+namespace KWin
+{
+
+class AbstractDataSource;
+
+/**
+ * \internal
+ *
+ * The DataSourceCache class requests the data of a source only once per mime type and sends it
+ * to every reader. When the selection changes, usually several clients read it: clipboard
+ * managers, Xwayland and the focused window. Without the cache, the source would have to
+ * serialize the data for every one of them.
+ *
+ * The data is kept in a memfd for as long as the source exists, so the cache doesn't have to
+ * be invalidated. Only text and images are cached, up to s_maxSize bytes per source. Bigger
+ * transfers are still shared between the readers that ask for the data while it is being
+ * read, but they aren't kept afterwards.
+ */
+class DataSourceCache
+{
+public:
+    static constexpr off_t s_maxSize = 32 * 1024 * 1024;
+
+    explicit DataSourceCache(AbstractDataSource *source);
+    ~DataSourceCache();
+
+    bool canCache(const QString &mimeType) const;
+    void send(const QString &mimeType, FileDescriptor &&fd);
+
+private:
+    struct Reader
+    {
+        FileDescriptor fd;
+        off_t offset = 0;
+        std::unique_ptr<QSocketNotifier> notifier;
+    };
+    struct Entry
+    {
+        FileDescriptor memfd;
+        off_t size = 0;
+        bool complete = false;
+        bool oversized = false;
+        FileDescriptor sourcePipe;
+        std::unique_ptr<QSocketNotifier> sourceNotifier;
+        std::vector<std::unique_ptr<Reader>> readers;
+    };
+
+    Entry *startReading(const QString &mimeType);
+    void readSource(const QString &mimeType, Entry *entry);
+    void writeReaders(const QString &mimeType, Entry *entry);
+    bool writeReader(Entry *entry, Reader *reader);
+
+    AbstractDataSource *const m_source;
+    std::unordered_map<QString, std::unique_ptr<Entry>> m_entries;
+    QSet<QString> m_uncacheable;
+    off_t m_totalSize = 0;
+};
+
+} // namespace KWin
@@ -24,6 +24,7 @@
 #include <QAbstractEventDispatcher>
 #include <QCoreApplication>
 #include <QDebug>
+#include <QTimer>
 
 namespace KWin
 {
@@ -33,8 +34,24 @@ DisplayPrivate *DisplayPrivate::get(Display *display)
     return display->d.get();
 }
 
+static std::chrono::microseconds defaultDispatchTimeBudget()
+{
+    bool ok = false;
+    const int microseconds = qEnvironmentVariableIntValue("KWIN_WAYLAND_DISPATCH_BUDGET_US", &ok);
+    return std::chrono::microseconds(ok && microseconds >= 0 ? microseconds : 4000);
+}
+
+static quint32 defaultDispatchRequestBudget()
+{
+    bool ok = false;
+    const int requests = qEnvironmentVariableIntValue("KWIN_WAYLAND_CLIENT_REQUEST_BUDGET", &ok);
+    return ok && requests >= 0 ? requests : 1000;
+}
+
 DisplayPrivate::DisplayPrivate(Display *q)
     : q(q)
+    , dispatchTimeBudget(defaultDispatchTimeBudget())
+    , dispatchRequestBudget(defaultDispatchRequestBudget())
 {
 }
 
@@ -54,6 +71,18 @@ void DisplayPrivate::clientCreatedCallback(wl_listener *listener, void *data)
     Q_EMIT display->clientConnected(connection);
 }
 
+void DisplayPrivate::protocolLoggerCallback(void *userData, wl_protocol_logger_type type, const wl_protocol_logger_message *message)
+{
+    if (type != WL_PROTOCOL_LOGGER_REQUEST) {
+        return;
+    }
+    DisplayPrivate *displayPrivate = static_cast<DisplayPrivate *>(userData);
+    ClientConnection *connection = ClientConnection::get(wl_resource_get_client(message->resource));
+    if (connection && connection->addDispatchedRequest()) {
+        displayPrivate->dispatchedClients.append(connection);
+    }
+}
+
 Display::Display(QObject *parent)
     : QObject(parent)
     , d(new DisplayPrivate(this))
@@ -63,11 +92,14 @@ Display::Display(QObject *parent)
 
     d->clientCreatedListener.notify = DisplayPrivate::clientCreatedCallback;
     wl_display_add_client_created_listener(d->display, &d->clientCreatedListener);
+
+    d->protocolLogger = wl_display_add_protocol_logger(d->display, DisplayPrivate::protocolLoggerCallback, d.get());
 }
 
 Display::~Display()
 {
     wl_list_remove(&d->clientCreatedListener.link);
+    wl_protocol_logger_destroy(d->protocolLogger);
 
     wl_display_destroy_clients(d->display);
     wl_display_destroy(d->display);
@@ -135,9 +167,33 @@ bool Display::start()
 
 void Display::dispatchEvents()
 {
+    const auto start = std::chrono::steady_clock::now();
     if (wl_event_loop_dispatch(d->loop, 0) != 0) {
         qCWarning(KWIN_CORE) << "Error on dispatching Wayland event loop";
     }
+    const auto duration = std::chrono::steady_clock::now() - start;
+
+    // libwayland reads and dispatches all buffered requests of a client at once, so the
+    // budget can't interrupt a round. Instead, if a round was too expensive, give the rest
+    // of the event loop a chance to run before the next round starts.
+    bool exceeded = d->dispatchTimeBudget.count() && duration > d->dispatchTimeBudget;
+    for (const QPointer<ClientConnection> &connection : std::as_const(d->dispatchedClients)) {
+        if (connection && connection->finishDispatch(d->dispatchRequestBudget)) {
+            exceeded = true;
+        }
+    }
+    d->dispatchedClients.clear();
+
+    if (exceeded && d->socketNotifier && !d->dispatchDeferred) {
+        d->dispatchDeferred = true;
+        d->socketNotifier->setEnabled(false);
+        QTimer::singleShot(0, this, [this]() {
+            d->dispatchDeferred = false;
+            if (d->socketNotifier) {
+                d->socketNotifier->setEnabled(true);
+            }
+        });
+    }
 }
 
 void Display::flush()
@@ -148,7 +204,12 @@ void Display::flush()
 void Display::createShm()
 {
     Q_ASSERT(d->display);
-    new ShmClientBufferIntegration(this);
+    d->shm = new ShmClientBufferIntegration(this);
+}
+
+ShmClientBufferIntegration *Display::shm() const
+{
+    return d->shm;
 }
 
 quint32 Display::nextSerial()
@@ -242,6 +303,22 @@ void Display::setDefaultMaxBufferSize(size_t max)
     wl_display_set_default_max_buffer_size(d->display, max);
 }
 
+void Display::setDispatchBudget(std::chrono::microseconds time, quint32 requests)
+{
+    d->dispatchTimeBudget = time;
+    d->dispatchRequestBudget = requests;
+}
+
+std::chrono::microseconds Display::dispatchTimeBudget() const
+{
+    return d->dispatchTimeBudget;
+}
+
+quint32 Display::dispatchRequestBudget() const
+{
+    return d->dispatchRequestBudget;
+}
+
 SecurityContext::SecurityContext(Display *display, FileDescriptor &&listenFd, FileDescriptor &&closeFd, const QString &appId)
     : QObject(display)
     , m_display(display)
@@ -13,6 +13,8 @@
 #include <QList>
 #include <QObject>
 
+#include <chrono>
+
 struct wl_display;
 struct wl_resource;
 
@@ -23,6 +25,7 @@ class ClientConnection;
 class DisplayPrivate;
 class OutputInterface;
 class SeatInterface;
+class ShmClientBufferIntegration;
 class GraphicsBuffer;
 
 /**
@@ -95,6 +98,10 @@ public:
     bool isRunning() const;
 
     void createShm();
+    /**
+     * @returns The shm integration created by createShm(), or @c null if there is none.
+     */
+    ShmClientBufferIntegration *shm() const;
     /**
      * @returns All SeatInterface currently managed on the Display.
      */
@@ -114,6 +121,19 @@ public:
      */
     void setDefaultMaxBufferSize(size_t max);
 
+    /**
+     * Sets the budget of a single dispatch round. If dispatching the pending requests takes
+     * longer than @a time, or a client sends more than @a requests requests in one round,
+     * the next round is deferred until the event loop has processed other pending events,
+     * such as input and timers. A value of zero disables the respective budget.
+     *
+     * By default, the budget is 4ms and 1000 requests per client. The KWIN_WAYLAND_DISPATCH_BUDGET_US
+     * and KWIN_WAYLAND_CLIENT_REQUEST_BUDGET environment variables override the defaults.
+     */
+    void setDispatchBudget(std::chrono::microseconds time, quint32 requests);
+    std::chrono::microseconds dispatchTimeBudget() const;
+    quint32 dispatchRequestBudget() const;
+
 public Q_SLOTS:
     void flush();
 
@@ -11,9 +11,12 @@
 
 #include "utils/filedescriptor.h"
 #include <QList>
+#include <QPointer>
 #include <QSocketNotifier>
 #include <QString>
 
+#include <chrono>
+
 struct wl_resource;
 
 namespace KWin
@@ -24,6 +27,7 @@ class Display;
 class OutputInterface;
 class OutputDeviceV2Interface;
 class SeatInterface;
+class ShmClientBufferIntegration;
 
 class DisplayPrivate
 {
@@ -34,6 +38,7 @@ public:
     void registerSocketName(const QString &socketName);
 
     static void clientCreatedCallback(wl_listener *listener, void *data);
+    static void protocolLoggerCallback(void *userData, wl_protocol_logger_type type, const wl_protocol_logger_message *message);
 
     Display *q;
     QSocketNotifier *socketNotifier = nullptr;
@@ -43,8 +48,14 @@ public:
     QList<OutputInterface *> outputs;
     QList<OutputDeviceV2Interface *> outputdevicesV2;
     QList<SeatInterface *> seats;
+    ShmClientBufferIntegration *shm = nullptr;
     QStringList socketNames;
     wl_listener clientCreatedListener;
+    wl_protocol_logger *protocolLogger = nullptr;
+    QList<QPointer<ClientConnection>> dispatchedClients;
+    std::chrono::microseconds dispatchTimeBudget;
+    quint32 dispatchRequestBudget;
+    bool dispatchDeferred = false;
 };
 
 /**
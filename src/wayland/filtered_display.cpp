@@ -10,7 +10,9 @@
 
 #include <wayland-server.h>
 
+#include <QBitArray>
 #include <QByteArray>
+#include <QHash>
 
 namespace KWin
 {
@@ -20,14 +22,55 @@ class FilteredDisplayPrivate
 public:
     FilteredDisplayPrivate(FilteredDisplay *_q);
     FilteredDisplay *q;
+
+    /**
+     * The decisions made for one client, indexed by the bit assigned to the interface.
+     * The filter is consulted for every global whenever the registry is sent, so the
+     * decision is only computed the first time the client runs into an interface.
+     */
+    struct ClientFilter
+    {
+        QBitArray known;
+        QBitArray allowed;
+    };
+
+    int interfaceBit(const wl_interface *interface)
+    {
+        auto it = interfaceBits.constFind(interface);
+        if (it == interfaceBits.constEnd()) {
+            it = interfaceBits.insert(interface, interfaceBits.size());
+        }
+        return *it;
+    }
+
+    bool isAllowed(const wl_client *client, const wl_global *global)
+    {
+        const wl_interface *interface = wl_global_get_interface(global);
+        const int bit = interfaceBit(interface);
+
+        ClientFilter &filter = clientFilters[client];
+        if (filter.known.size() <= bit) {
+            const int size = interfaceBits.size();
+            filter.known.resize(size);
+            filter.allowed.resize(size);
+        }
+        if (!filter.known.testBit(bit)) {
+            auto clientConnection = ClientConnection::get(const_cast<wl_client *>(client));
+            auto name = QByteArray::fromRawData(interface->name, strlen(interface->name));
+            filter.allowed.setBit(bit, q->allowInterface(clientConnection, name));
+            filter.known.setBit(bit);
+        }
+        return filter.allowed.testBit(bit);
+    }
+
     static bool globalFilterCallback(const wl_client *client, const wl_global *global, void *data)
     {
         auto t = static_cast<FilteredDisplayPrivate *>(data);
-        auto clientConnection = ClientConnection::get(const_cast<wl_client *>(client));
-        auto interface = wl_global_get_interface(global);
-        auto name = QByteArray::fromRawData(interface->name, strlen(interface->name));
-        return t->q->allowInterface(clientConnection, name);
+        return t->isAllowed(client, global);
     }
+
+    QHash<const wl_interface *, int> interfaceBits;
+    QHash<const wl_client *, ClientFilter> clientFilters;
 };
 
 FilteredDisplayPrivate::FilteredDisplayPrivate(FilteredDisplay *_q)
@@ -45,12 +88,26 @@ FilteredDisplay::FilteredDisplay(QObject *parent)
         }
         wl_display_set_global_filter(*this, FilteredDisplayPrivate::globalFilterCallback, d.get());
     });
+    connect(this, &Display::clientConnected, this, [this](ClientConnection *client) {
+        const wl_client *handle = client->client();
+        connect(client, &ClientConnection::securityContextAppIdChanged, this, [this, client]() {
+            invalidateAllowedInterfaces(client);
+        });
+        connect(client, &ClientConnection::aboutToBeDestroyed, this, [this, handle]() {
+            d->clientFilters.remove(handle);
+        });
+    });
 }
 
 FilteredDisplay::~FilteredDisplay()
 {
 }
 
+void FilteredDisplay::invalidateAllowedInterfaces(ClientConnection *client)
+{
+    d->clientFilters.remove(client->client());
+}
+
 }
 
 #include "moc_filtered_display.cpp"
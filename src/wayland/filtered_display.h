@@ -36,6 +36,13 @@ public:
      */
     virtual bool allowInterface(ClientConnection *client, const QByteArray &interfaceName) = 0;
 
+    /**
+     * Forgets the cached results of allowInterface() for the given @a client. Implementations
+     * have to call this whenever the policy for a client changes, apart from the security
+     * context app id, which is tracked automatically.
+     */
+    void invalidateAllowedInterfaces(ClientConnection *client);
+
 private:
     std::unique_ptr<FilteredDisplayPrivate> d;
 };
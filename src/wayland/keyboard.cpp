@@ -15,10 +15,13 @@
 
 #include <algorithm>
 #include <unistd.h>
+#include <utility>
 
 namespace KWin
 {
 
+static const size_t s_previousKeymapCount = 3;
+
 KeyboardInterfacePrivate::KeyboardInterfacePrivate(SeatInterface *s)
     : seat(s)
 {
@@ -103,9 +106,32 @@ void KeyboardInterface::setKeymap(const QByteArray &content)
         return;
     }
 
+    if (content == d->keymap) {
+        return;
+    }
+
+    RamFile file;
+    auto it = std::ranges::find(d->previousKeymaps, content, &KeyboardInterfacePrivate::CachedKeymap::content);
+    if (it != d->previousKeymaps.end()) {
+        file = std::move(it->file);
+        d->previousKeymaps.erase(it);
+    } else {
+        // +1 to include QByteArray null terminator.
+        file = RamFile("kwin-xkb-keymap-shared", content.constData(), content.size() + 1, RamFile::Flag::SealWrite);
+    }
+
+    if (!d->keymap.isNull()) {
+        d->previousKeymaps.push_front(KeyboardInterfacePrivate::CachedKeymap{
+            .content = std::exchange(d->keymap, QByteArray()),
+            .file = std::move(d->sharedKeymapFile),
+        });
+        if (d->previousKeymaps.size() > s_previousKeymapCount) {
+            d->previousKeymaps.pop_back();
+        }
+    }
+
     d->keymap = content;
-    // +1 to include QByteArray null terminator.
-    d->sharedKeymapFile = RamFile("kwin-xkb-keymap-shared", content.constData(), content.size() + 1, RamFile::Flag::SealWrite);
+    d->sharedKeymapFile = std::move(file);
 
     const auto keyboardResources = d->resourceMap();
     for (KeyboardInterfacePrivate::Resource *resource : keyboardResources) {
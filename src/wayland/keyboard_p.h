@@ -13,6 +13,8 @@
 #include <QHash>
 #include <QPointer>
 
+#include <deque>
+
 namespace KWin
 {
 
@@ -45,6 +47,17 @@ public:
     QByteArray keymap;
     RamFile sharedKeymapFile;
 
+    struct CachedKeymap
+    {
+        QByteArray content;
+        RamFile file;
+    };
+    /**
+     * The keymaps that were used before the current one, the most recent one first. Switching
+     * between a few keymaps, e.g. for typing keysyms that are not in the keymap, happens often
+     */
+    std::deque<CachedKeymap> previousKeymaps;
+
     struct
     {
         qint32 charactersPerSecond = 0;
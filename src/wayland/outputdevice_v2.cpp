@@ -14,6 +14,8 @@
 #include <QString>
 #include <QTimer>
 
+#include <algorithm>
+
 #include "qwayland-server-kde-output-device-v2.h"
 
 namespace KWin
@@ -232,7 +234,8 @@ public:
     transform m_transform = transform_normal;
     std::vector<std::unique_ptr<OutputDeviceModeV2Interface>> m_modes;
     OutputDeviceModeV2Interface *m_currentMode = nullptr;
-    QByteArray m_edid;
+    // base64 encoded, which is the same for all clients
+    QString m_edid;
     bool m_enabled = true;
     QString m_uuid;
     uint32_t m_capabilities = 0;
@@ -562,7 +565,7 @@ void OutputDeviceV2InterfacePrivate::sendDone(Resource *resource)
 
 void OutputDeviceV2InterfacePrivate::sendEdid(Resource *resource)
 {
-    send_edid(resource->handle, QString::fromStdString(m_edid.toBase64().toStdString()));
+    send_edid(resource->handle, m_edid);
 }
 
 void OutputDeviceV2InterfacePrivate::sendEnabled(Resource *resource)
@@ -834,32 +837,58 @@ void OutputDeviceV2Interface::updateScale()
 
 void OutputDeviceV2Interface::updateModes()
 {
+    // Monitors can have hundreds of modes, only announce the ones that are actually new
+    // and keep the objects of the modes that still exist.
     auto oldModes = std::move(d->m_modes);
-    d->m_currentMode = nullptr;
+    OutputDeviceModeV2Interface *const oldCurrentMode = std::exchange(d->m_currentMode, nullptr);
+    bool changed = false;
 
     const auto clientResources = d->resourceMap();
     const auto nativeModes = d->m_handle->modes();
 
     for (const std::shared_ptr<OutputMode> &mode : nativeModes) {
-        d->m_modes.push_back(std::make_unique<OutputDeviceModeV2Interface>(mode));
-        OutputDeviceModeV2Interface *deviceMode = d->m_modes.back().get();
+        const OutputModeline modeline = mode->modeline();
+        const auto it = std::ranges::find_if(oldModes, [&modeline](const std::unique_ptr<OutputDeviceModeV2Interface> &oldMode) {
+            return oldMode && OutputDeviceModeV2InterfacePrivate::get(oldMode.get())->m_modeline == modeline;
+        });
+
+        OutputDeviceModeV2Interface *deviceMode;
+        if (it != oldModes.end()) {
+            OutputDeviceModeV2InterfacePrivate::get(it->get())->m_handle = mode;
+            d->m_modes.push_back(std::move(*it));
+            deviceMode = d->m_modes.back().get();
+        } else {
+            d->m_modes.push_back(std::make_unique<OutputDeviceModeV2Interface>(mode));
+            deviceMode = d->m_modes.back().get();
+            for (auto resource : clientResources) {
+                d->sendNewMode(resource, deviceMode);
+            }
+            changed = true;
+        }
 
         if (d->m_handle->currentMode() == mode) {
             d->m_currentMode = deviceMode;
         }
+    }
 
+    if (d->m_currentMode && d->m_currentMode != oldCurrentMode) {
         for (auto resource : clientResources) {
-            d->sendNewMode(resource, deviceMode);
+            d->sendCurrentMode(resource);
         }
-    }
-
-    for (auto resource : clientResources) {
-        d->sendCurrentMode(resource);
+        changed = true;
     }
 
     // make sure old modes are removed before the done event
+    for (const auto &oldMode : oldModes) {
+        if (oldMode) {
+            changed = true;
+            break;
+        }
+    }
     oldModes.clear();
-    scheduleDone();
+    if (changed) {
+        scheduleDone();
+    }
 }
 
 void OutputDeviceV2Interface::updateCurrentMode()
@@ -881,7 +910,11 @@ void OutputDeviceV2Interface::updateCurrentMode()
 
 void OutputDeviceV2Interface::updateEdid()
 {
-    d->m_edid = d->m_handle->edid().raw();
+    const QString edid = QString::fromLatin1(d->m_handle->edid().raw().toBase64());
+    if (d->m_edid == edid) {
+        return;
+    }
+    d->m_edid = edid;
     const auto clientResources = d->resourceMap();
     for (auto resource : clientResources) {
         d->sendEdid(resource);
@@ -19,6 +19,9 @@
 #include <QThreadPool>
 #include <QUuid>
 
+#include <memory>
+#include <mutex>
+
 #include <qwayland-server-plasma-window-management.h>
 
 namespace KWin
@@ -56,6 +59,64 @@ protected:
     void org_kde_plasma_window_management_get_stacking_order(Resource *resource, uint32_t id) override;
 };
 
+/**
+ * The serialized data of an icon. It's only serialized once, on the first request for the icon,
+ * and then shared by all requests, and by all windows that have the same icon.
+ */
+class SerializedIcon
+{
+public:
+    explicit SerializedIcon(const QIcon &icon);
+
+    /**
+     * Returns the serialized data of the icon, serializing it if that hasn't happened yet.
+     * This can be called from any thread.
+     */
+    const QByteArray &data();
+
+    /**
+     * Returns the serialized icon shared by the windows with the given @a icon. This must only
+     * be called from the main thread.
+     */
+    static std::shared_ptr<SerializedIcon> get(const QIcon &icon);
+
+private:
+    const QIcon m_icon;
+    std::once_flag m_serialized;
+    QByteArray m_data;
+};
+
+SerializedIcon::SerializedIcon(const QIcon &icon)
+    : m_icon(icon)
+{
+}
+
+const QByteArray &SerializedIcon::data()
+{
+    std::call_once(m_serialized, [this]() {
+        QDataStream ds(&m_data, QIODevice::WriteOnly);
+        ds << m_icon;
+    });
+    return m_data;
+}
+
+std::shared_ptr<SerializedIcon> SerializedIcon::get(const QIcon &icon)
+{
+    // the icons are identified by their cache key, which copies of an icon share
+    static QHash<qint64, std::weak_ptr<SerializedIcon>> cache;
+
+    auto &entry = cache[icon.cacheKey()];
+    if (auto serialized = entry.lock()) {
+        return serialized;
+    }
+    auto serialized = std::make_shared<SerializedIcon>(icon);
+    entry = serialized;
+    cache.removeIf([](const auto &it) {
+        return it.value().expired();
+    });
+    return serialized;
+}
+
 class PlasmaWindowInterfacePrivate : public QtWaylandServer::org_kde_plasma_window
 {
 public:
@@ -83,6 +144,14 @@ public:
     wl_resource *resourceForParent(PlasmaWindowInterface *parent, Resource *child) const;
     void setClientGeometry(const Rect &geometry);
 
+    enum PendingChange {
+        StateChange = 1 << 0,
+        GeometryChange = 1 << 1,
+        ClientGeometryChange = 1 << 2,
+    };
+    void schedulePendingChange(PendingChange change);
+    void sendPendingChanges();
+
     quint32 windowId = 0;
     QHash<SurfaceInterface *, Rect> minimizedGeometries;
     PlasmaWindowManagementInterface *wm;
@@ -101,10 +170,14 @@ public:
     QString m_appServiceName;
     QString m_appObjectPath;
     QIcon m_icon;
+    std::shared_ptr<SerializedIcon> m_serializedIcon;
     quint32 m_state = 0;
     QString uuid;
     QString m_resourceName;
     Rect clientGeometry;
+    // the state and geometries can change many times in a row, e.g. while a window is moved,
+    // the clients are only told about the latest ones, once the event loop is idle
+    uint pendingChanges = 0;
 
 protected:
     Resource *org_kde_plasma_window_allocate() override;
@@ -482,7 +555,11 @@ void PlasmaWindowInterfacePrivate::setThemedIconName(const QString &iconName)
 
 void PlasmaWindowInterfacePrivate::setIcon(const QIcon &icon)
 {
+    if (m_icon.cacheKey() == icon.cacheKey()) {
+        return;
+    }
     m_icon = icon;
+    m_serializedIcon.reset();
     setThemedIconName(m_icon.name());
 
     const auto clientResources = resourceMap();
@@ -510,15 +587,17 @@ void PlasmaWindowInterfacePrivate::setResourceName(const QString &resourceName)
 
 void PlasmaWindowInterfacePrivate::org_kde_plasma_window_get_icon(Resource *resource, int32_t fd)
 {
-    QThreadPool::globalInstance()->start([fd, icon = m_icon]() {
+    if (!m_serializedIcon) {
+        m_serializedIcon = SerializedIcon::get(m_icon);
+    }
+    QThreadPool::globalInstance()->start([fd, icon = m_serializedIcon]() {
         QFile file;
         if (!file.open(fd, QIODevice::WriteOnly, QFileDevice::AutoCloseHandle)) {
             close(fd);
             qCWarning(KWIN_CORE) << Q_FUNC_INFO << "failed to open file:" << file.errorString();
             return;
         }
-        QDataStream ds(&file);
-        ds << icon;
+        file.write(icon->data());
         file.close();
     });
 }
@@ -572,6 +651,7 @@ void PlasmaWindowInterfacePrivate::unmap()
         return;
     }
     unmapped = true;
+    sendPendingChanges();
     const auto clientResources = resourceMap();
 
     for (auto resource : clientResources) {
@@ -579,6 +659,37 @@ void PlasmaWindowInterfacePrivate::unmap()
     }
 }
 
+void PlasmaWindowInterfacePrivate::schedulePendingChange(PendingChange change)
+{
+    if (!pendingChanges) {
+        QMetaObject::invokeMethod(q, [this]() {
+            sendPendingChanges();
+        }, Qt::QueuedConnection);
+    }
+    pendingChanges |= change;
+}
+
+void PlasmaWindowInterfacePrivate::sendPendingChanges()
+{
+    const uint changes = std::exchange(pendingChanges, 0);
+    if (!changes) {
+        return;
+    }
+
+    const auto clientResources = resourceMap();
+    for (auto resource : clientResources) {
+        if (changes & StateChange) {
+            send_state_changed(resource->handle, m_state);
+        }
+        if ((changes & GeometryChange) && geometry.isValid() && resource->version() >= ORG_KDE_PLASMA_WINDOW_GEOMETRY_SINCE_VERSION) {
+            send_geometry(resource->handle, geometry.x(), geometry.y(), geometry.width(), geometry.height());
+        }
+        if ((changes & ClientGeometryChange) && clientGeometry.isValid() && resource->version() >= ORG_KDE_PLASMA_WINDOW_CLIENT_GEOMETRY_SINCE_VERSION) {
+            send_client_geometry(resource->handle, clientGeometry.x(), clientGeometry.y(), clientGeometry.width(), clientGeometry.height());
+        }
+    }
+}
+
 void PlasmaWindowInterfacePrivate::setState(org_kde_plasma_window_management_state flag, bool set)
 {
     quint32 newState = m_state;
@@ -591,11 +702,7 @@ void PlasmaWindowInterfacePrivate::setState(org_kde_plasma_window_management_sta
         return;
     }
     m_state = newState;
-    const auto clientResources = resourceMap();
-
-    for (auto resource : clientResources) {
-        send_state_changed(resource->handle, m_state);
-    }
+    schedulePendingChange(StateChange);
 }
 
 wl_resource *PlasmaWindowInterfacePrivate::resourceForParent(PlasmaWindowInterface *parent, Resource *child) const
@@ -647,14 +754,7 @@ void PlasmaWindowInterfacePrivate::setGeometry(const Rect &geo)
     if (!geometry.isValid()) {
         return;
     }
-
-    const auto clientResources = resourceMap();
-    for (auto resource : clientResources) {
-        if (resource->version() < ORG_KDE_PLASMA_WINDOW_GEOMETRY_SINCE_VERSION) {
-            continue;
-        }
-        send_geometry(resource->handle, geometry.x(), geometry.y(), geometry.width(), geometry.height());
-    }
+    schedulePendingChange(GeometryChange);
 }
 
 void PlasmaWindowInterfacePrivate::setApplicationMenuPaths(const QString &service, const QString &object)
@@ -1180,14 +1280,7 @@ void PlasmaWindowInterfacePrivate::setClientGeometry(const Rect &geometry)
     if (!clientGeometry.isValid()) {
         return;
     }
-
-    const auto clientResources = resourceMap();
-    for (auto resource : clientResources) {
-        if (resource->version() < ORG_KDE_PLASMA_WINDOW_CLIENT_GEOMETRY_SINCE_VERSION) {
-            continue;
-        }
-        send_client_geometry(resource->handle, clientGeometry.x(), clientGeometry.y(), clientGeometry.width(), clientGeometry.height());
-    }
+    schedulePendingChange(ClientGeometryChange);
 }
 
 }
@@ -4,11 +4,14 @@
     SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
 */
 #include "presentationtime.h"
+#include "clientconnection.h"
 #include "display.h"
 #include "output.h"
 #include "surface.h"
 #include "surface_p.h"
 
+#include <algorithm>
+
 namespace KWin
 {
 
@@ -64,35 +67,74 @@ PresentationTimeFeedback::~PresentationTimeFeedback()
     }
 }
 
+PresentationTimeFeedback::PresentedEvent::PresentedEvent(std::chrono::nanoseconds refreshCycleDuration, std::chrono::nanoseconds timestamp, PresentationMode mode)
+{
+    const auto secs = std::chrono::duration_cast<std::chrono::seconds>(timestamp);
+    tvSecHi = secs.count() >> 32;
+    tvSecLo = secs.count() & 0xffffffff;
+    tvNsec = (timestamp - secs).count();
+    // TODO with adaptive sync, send an estimation of the current actual refresh rate?
+    refreshDuration = refreshCycleDuration.count();
+
+    adaptiveSync = mode == PresentationMode::AdaptiveSync || mode == PresentationMode::AdaptiveAsync;
+    flags = WP_PRESENTATION_FEEDBACK_KIND_HW_CLOCK | WP_PRESENTATION_FEEDBACK_KIND_HW_COMPLETION;
+    if (mode == PresentationMode::VSync || mode == PresentationMode::AdaptiveSync) {
+        flags |= WP_PRESENTATION_FEEDBACK_KIND_VSYNC;
+    }
+}
+
 void PresentationTimeFeedback::presented(std::chrono::nanoseconds refreshCycleDuration, std::chrono::nanoseconds timestamp, PresentationMode mode)
+{
+    sendPresented(PresentedEvent(refreshCycleDuration, timestamp, mode), false);
+}
+
+void PresentationTimeFeedback::sendPresented(const PresentedEvent &event, bool zeroCopy)
 {
     if (m_presented) {
         return;
     }
     m_presented = true;
-    const auto secs = std::chrono::duration_cast<std::chrono::seconds>(timestamp);
-    const uint32_t tvSecHi = secs.count() >> 32;
-    const uint32_t tvSecLo = secs.count() & 0xffffffff;
-    const uint32_t tvNsec = (timestamp - secs).count();
 
-    const bool adaptiveSync = mode == PresentationMode::AdaptiveSync || mode == PresentationMode::AdaptiveAsync;
-    uint32_t flags = WP_PRESENTATION_FEEDBACK_KIND_HW_CLOCK | WP_PRESENTATION_FEEDBACK_KIND_HW_COMPLETION;
-    if (mode == PresentationMode::VSync || mode == PresentationMode::AdaptiveSync) {
-        flags |= WP_PRESENTATION_FEEDBACK_KIND_VSYNC;
-    }
+    const uint32_t flags = zeroCopy ? event.flags | WP_PRESENTATION_FEEDBACK_KIND_ZERO_COPY : event.flags;
 
     wl_resource *resource;
     wl_resource *tmp;
     wl_resource_for_each_safe (resource, tmp, &resources) {
-        // TODO with adaptive sync, send an estimation of the current actual refresh rate?
-        uint32_t refreshDuration = refreshCycleDuration.count();
-        if (adaptiveSync && wl_resource_get_version(resource) == 1) {
+        uint32_t refreshDuration = event.refreshDuration;
+        if (event.adaptiveSync && wl_resource_get_version(resource) == 1) {
             // version 1 requires sending zero when the refresh rate isn't stable
             refreshDuration = 0;
         }
-        wp_presentation_feedback_send_presented(resource, tvSecHi, tvSecLo, tvNsec, refreshDuration, 0, 0, flags);
+        wp_presentation_feedback_send_presented(resource, event.tvSecHi, event.tvSecLo, event.tvNsec, refreshDuration, 0, 0, flags);
         wl_resource_destroy(resource);
     }
 }
 
+void PresentationTimeFeedbackBatch::add(SurfaceInterface *surface, std::shared_ptr<PresentationTimeFeedback> &&feedback)
+{
+    m_entries.push_back(Entry{
+        .client = surface->client()->client(),
+        .surface = surface,
+        .feedback = std::move(feedback),
+    });
+}
+
+void PresentationTimeFeedbackBatch::setZeroCopy(SurfaceInterface *surface)
+{
+    m_zeroCopySurfaces.push_back(surface);
+}
+
+void PresentationTimeFeedbackBatch::presented(std::chrono::nanoseconds refreshCycleDuration, std::chrono::nanoseconds timestamp, PresentationMode mode)
+{
+    const PresentationTimeFeedback::PresentedEvent event(refreshCycleDuration, timestamp, mode);
+
+    // keep the events of every client together, so that they are written out in one go
+    std::ranges::stable_sort(m_entries, std::less{}, &Entry::client);
+    for (const Entry &entry : m_entries) {
+        const bool zeroCopy = std::ranges::contains(m_zeroCopySurfaces, entry.surface);
+        entry.feedback->sendPresented(event, zeroCopy);
+    }
+    m_entries.clear();
+}
+
 }
@@ -7,6 +7,8 @@
 
 #include <QObject>
 #include <chrono>
+#include <memory>
+#include <vector>
 
 #include "core/renderbackend.h"
 #include "effect/globals.h"
@@ -34,15 +36,61 @@ private:
 class PresentationTimeFeedback : public PresentationFeedback
 {
 public:
+    /**
+     * The PresentedEvent type holds the arguments of the presented event that are the same
+     * for all the surfaces shown in a frame.
+     */
+    struct PresentedEvent
+    {
+        PresentedEvent(std::chrono::nanoseconds refreshCycleDuration, std::chrono::nanoseconds timestamp, PresentationMode mode);
+
+        uint32_t tvSecHi;
+        uint32_t tvSecLo;
+        uint32_t tvNsec;
+        uint32_t refreshDuration;
+        uint32_t flags;
+        bool adaptiveSync;
+    };
+
     PresentationTimeFeedback();
     ~PresentationTimeFeedback() override;
 
     wl_list resources;
 
     void presented(std::chrono::nanoseconds refreshCycleDuration, std::chrono::nanoseconds timestamp, PresentationMode mode) override;
+    void sendPresented(const PresentedEvent &event, bool zeroCopy);
 
 private:
     bool m_presented = false;
 };
 
+/**
+ * The PresentationTimeFeedbackBatch class delivers the presentation feedback of all the
+ * surfaces shown in an output frame in one pass, grouped by client. It is meant to be
+ * used with OutputFrame::sharedFeedback().
+ */
+class PresentationTimeFeedbackBatch : public PresentationFeedback
+{
+public:
+    void add(SurfaceInterface *surface, std::shared_ptr<PresentationTimeFeedback> &&feedback);
+    /**
+     * Marks the @a surface as scanned out directly in this frame, which makes its presentation
+     * feedback carry the zero-copy flag.
+     */
+    void setZeroCopy(SurfaceInterface *surface);
+
+    void presented(std::chrono::nanoseconds refreshCycleDuration, std::chrono::nanoseconds timestamp, PresentationMode mode) override;
+
+private:
+    struct Entry
+    {
+        wl_client *client;
+        SurfaceInterface *surface;
+        std::shared_ptr<PresentationTimeFeedback> feedback;
+    };
+
+    std::vector<Entry> m_entries;
+    std::vector<SurfaceInterface *> m_zeroCopySurfaces;
+};
+
 }
@@ -54,7 +54,7 @@ void PrimarySelectionOfferV1InterfacePrivate::zwp_primary_selection_offer_v1_rec
     FileDescriptor pipe(fd);
 
     if (source && source->mimeTypes().contains(mimeType)) {
-        source->requestData(mimeType, std::move(pipe));
+        source->receive(mimeType, std::move(pipe));
     }
 }
 
@@ -0,0 +1,287 @@
+/*
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+#include "protocolrecorder.h"
+#include "clientconnection.h"
+#include "display.h"
+#include "utils/common.h"
+#include "utils/containerof.h"
+
+#include <QDBusConnection>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QStandardPaths>
+
+#include <algorithm>
+#include <cstring>
+
+namespace KWin
+{
+
+// the logs of clients that have disconnected are kept around, as they are often the interesting ones
+static const size_t s_maxDisconnectedClients = 16;
+
+static size_t defaultRecordsPerClient()
+{
+    bool ok = false;
+    const int records = qEnvironmentVariableIntValue("KWIN_WAYLAND_PROTOCOL_RECORDER_SIZE", &ok);
+    return ok && records > 0 ? records : 4096;
+}
+
+ProtocolRecorder::ProtocolRecorder(Display *display, QObject *parent)
+    : QObject(parent)
+    , m_display(display)
+    , m_recordsPerClient(defaultRecordsPerClient())
+{
+    QDBusConnection::sessionBus().registerObject(QStringLiteral("/ProtocolRecorder"), this, QDBusConnection::ExportScriptableContents);
+    if (qEnvironmentVariableIntValue("KWIN_WAYLAND_PROTOCOL_RECORDER") == 1) {
+        setEnabled(true);
+    }
+}
+
+ProtocolRecorder::~ProtocolRecorder()
+{
+    setEnabled(false);
+}
+
+bool ProtocolRecorder::isEnabled() const
+{
+    return m_logger;
+}
+
+void ProtocolRecorder::setEnabled(bool enabled)
+{
+    if (isEnabled() == enabled) {
+        return;
+    }
+
+    if (enabled) {
+        m_logger = wl_display_add_protocol_logger(*m_display, loggerCallback, this);
+    } else {
+        wl_protocol_logger_destroy(m_logger);
+        m_logger = nullptr;
+        for (const auto &log : m_logs) {
+            if (log->connected) {
+                wl_list_remove(&log->destroyListener.link);
+            }
+        }
+        m_clients.clear();
+        m_logs.clear();
+        m_lastClient = nullptr;
+        m_lastLog = nullptr;
+    }
+    Q_EMIT enabledChanged();
+}
+
+void ProtocolRecorder::loggerCallback(void *userData, wl_protocol_logger_type type, const wl_protocol_logger_message *message)
+{
+    ProtocolRecorder *recorder = static_cast<ProtocolRecorder *>(userData);
+    wl_client *client = wl_resource_get_client(message->resource);
+    ClientLog *log;
+    if (client == recorder->m_lastClient) {
+        log = recorder->m_lastLog;
+    } else {
+        log = recorder->logForClient(client);
+        recorder->m_lastClient = client;
+        recorder->m_lastLog = log;
+    }
+    recorder->record(log, type, message);
+}
+
+void ProtocolRecorder::clientDestroyedCallback(wl_listener *listener, void *data)
+{
+    ClientLog *log = containerOf(listener, &ClientLog::destroyListener);
+    ProtocolRecorder *recorder = log->recorder;
+    wl_client *client = static_cast<wl_client *>(data);
+
+    wl_list_remove(&log->destroyListener.link);
+    log->connected = false;
+    recorder->m_clients.remove(client);
+    if (recorder->m_lastClient == client) {
+        recorder->m_lastClient = nullptr;
+        recorder->m_lastLog = nullptr;
+    }
+
+    const size_t disconnected = std::ranges::count(recorder->m_logs, false, [](const auto &log) {
+        return log->connected;
+    });
+    if (disconnected > s_maxDisconnectedClients) {
+        const auto it = std::ranges::find(recorder->m_logs, false, [](const auto &log) {
+            return log->connected;
+        });
+        recorder->m_logs.erase(it);
+    }
+}
+
+ProtocolRecorder::ClientLog *ProtocolRecorder::logForClient(wl_client *client)
+{
+    if (ClientLog *log = m_clients.value(client)) {
+        return log;
+    }
+
+    auto log = std::make_unique<ClientLog>();
+    log->recorder = this;
+    log->id = m_nextClientId++;
+    log->records.resize(m_recordsPerClient);
+    if (ClientConnection *connection = ClientConnection::get(client)) {
+        log->pid = connection->processId();
+        log->executable = connection->executablePath();
+    } else {
+        log->pid = 0;
+    }
+    log->destroyListener.notify = clientDestroyedCallback;
+    wl_client_add_destroy_listener(client, &log->destroyListener);
+
+    ClientLog *ret = log.get();
+    m_clients.insert(client, ret);
+    m_logs.push_back(std::move(log));
+    return ret;
+}
+
+void ProtocolRecorder::record(ClientLog *log, wl_protocol_logger_type type, const wl_protocol_logger_message *message)
+{
+    Record &record = log->records[log->next];
+    record.timestamp = std::chrono::steady_clock::now().time_since_epoch();
+    record.interface = wl_resource_get_class(message->resource);
+    record.message = message->message;
+    record.objectId = wl_resource_get_id(message->resource);
+    record.event = type == WL_PROTOCOL_LOGGER_EVENT;
+    record.argumentCount = std::min(message->arguments_count, s_maxArguments);
+
+    const char *signature = message->message->signature;
+    int argument = 0;
+    for (const char *c = signature; *c && argument < record.argumentCount; ++c) {
+        const wl_argument &value = message->arguments[argument];
+        switch (*c) {
+        case 'i':
+            record.arguments[argument] = value.i;
+            break;
+        case 'u':
+            record.arguments[argument] = value.u;
+            break;
+        case 'f':
+            record.arguments[argument] = value.f;
+            break;
+        case 'h':
+            record.arguments[argument] = value.h;
+            break;
+        case 's':
+            record.arguments[argument] = value.s ? strlen(value.s) : 0;
+            break;
+        case 'o':
+            record.arguments[argument] = value.o ? wl_resource_get_id(reinterpret_cast<wl_resource *>(value.o)) : 0;
+            break;
+        case 'n':
+            record.arguments[argument] = value.n;
+            break;
+        case 'a':
+            record.arguments[argument] = value.a ? value.a->size : 0;
+            break;
+        default:
+            // the since version and the nullable markers
+            continue;
+        }
+        argument++;
+    }
+
+    log->next++;
+    if (log->next == log->records.size()) {
+        log->next = 0;
+        log->wrapped = true;
+    }
+}
+
+QString ProtocolRecorder::dump(uint seconds)
+{
+    if (!isEnabled()) {
+        return QString();
+    }
+
+    const QString directory = QStandardPaths::writableLocation(QStandardPaths::RuntimeLocation);
+    const QString fileName = QDir(directory).filePath(QStringLiteral("kwin-protocol-%1.kwpr").arg(QDateTime::currentDateTime().toString(QStringLiteral("yyyyMMdd-hhmmss"))));
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qCWarning(KWIN_CORE) << "Failed to open" << fileName << "for writing:" << file.errorString();
+        return QString();
+    }
+
+    const std::chrono::nanoseconds now = std::chrono::steady_clock::now().time_since_epoch();
+    const std::chrono::nanoseconds since = seconds ? now - std::chrono::seconds(seconds) : std::chrono::nanoseconds::zero();
+
+    struct Entry
+    {
+        const ClientLog *log;
+        const Record *record;
+    };
+    std::vector<Entry> entries;
+    QHash<const char *, quint16> stringIndices;
+    QList<QByteArray> strings;
+    const auto stringIndex = [&](const char *string) {
+        auto it = stringIndices.constFind(string);
+        if (it == stringIndices.cend()) {
+            it = stringIndices.insert(string, strings.size());
+            strings.append(QByteArray(string));
+        }
+        return *it;
+    };
+
+    for (const auto &log : m_logs) {
+        const size_t count = log->wrapped ? log->records.size() : log->next;
+        const size_t first = log->wrapped ? log->next : 0;
+        for (size_t i = 0; i < count; ++i) {
+            const Record &record = log->records[(first + i) % log->records.size()];
+            if (record.timestamp >= since) {
+                entries.push_back(Entry{log.get(), &record});
+            }
+        }
+    }
+    std::ranges::stable_sort(entries, std::less{}, [](const Entry &entry) {
+        return entry.record->timestamp;
+    });
+
+    QByteArray records;
+    QDataStream recordStream(&records, QIODevice::WriteOnly);
+    recordStream.setByteOrder(QDataStream::LittleEndian);
+    for (const Entry &entry : entries) {
+        const Record &record = *entry.record;
+        recordStream << qint64(record.timestamp.count())
+                     << entry.log->id
+                     << record.objectId
+                     << stringIndex(record.interface)
+                     << stringIndex(record.message->name)
+                     << stringIndex(record.message->signature)
+                     << record.event
+                     << record.argumentCount;
+        for (int i = 0; i < record.argumentCount; ++i) {
+            recordStream << record.arguments[i];
+        }
+    }
+
+    QDataStream stream(&file);
+    stream.setByteOrder(QDataStream::LittleEndian);
+    stream << s_magic << s_version;
+    stream << quint32(m_logs.size());
+    for (const auto &log : m_logs) {
+        stream << log->id << log->pid << log->executable.toUtf8();
+    }
+    stream << quint32(strings.size());
+    for (const QByteArray &string : std::as_const(strings)) {
+        stream << string;
+    }
+    stream << quint32(entries.size());
+    stream.writeRawData(records.constData(), records.size());
+
+    if (stream.status() != QDataStream::Ok) {
+        qCWarning(KWIN_CORE) << "Failed to write the protocol log to" << fileName;
+        return QString();
+    }
+    return fileName;
+}
+
+} // namespace KWin
+
+#include "moc_protocolrecorder.cpp"
@@ -0,0 +1,112 @@
+/*
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: LGPL-2.1-only OR LGPL-3.0-only OR LicenseRef-KDE-Accepted-LGPL
+*/
+#pragma once
+
+#include "kwin_export.h"
+
+#include <QHash>
+#include <QObject>
+
+#include <wayland-server-core.h>
+
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <vector>
+
+namespace KWin
+{
+
+class Display;
+
+/**
+ * The ProtocolRecorder class keeps a log of the most recent requests and events of every
+ * client in memory, so that protocol level issues can be looked into without the overhead
+ * of WAYLAND_DEBUG, which changes the timing too much for many of them to show up.
+ *
+ * Messages are stored as fixed size binary records in a ring buffer per client. Only the
+ * first few arguments of a message are kept. Numbers, object ids and file descriptors are
+ * stored as they are, strings and arrays only with their size.
+ *
+ * The recorder is enabled with the KWIN_WAYLAND_PROTOCOL_RECORDER environment variable or
+ * by calling setEnabled(true) on the /ProtocolRecorder DBus object. dump() writes the
+ * recorded messages to a file, which can be read with the kwin_wayland_protocol_dump tool.
+ *
+ * The file starts with the magic "KWPR" and the format version, written with QDataStream
+ * in little endian byte order, followed by the list of clients (id, pid, executable), the
+ * string table with the names of the interfaces and messages, and the records ordered by
+ * their timestamp (timestamp, client id, object id, interface, message, signature,
+ * direction, arguments).
+ */
+class KWIN_EXPORT ProtocolRecorder : public QObject
+{
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "org.kde.kwin.ProtocolRecorder")
+    Q_PROPERTY(bool enabled READ isEnabled NOTIFY enabledChanged)
+
+public:
+    static constexpr quint32 s_magic = 0x5250574b; // "KWPR"
+    static constexpr quint32 s_version = 1;
+    static constexpr int s_maxArguments = 8;
+
+    explicit ProtocolRecorder(Display *display, QObject *parent = nullptr);
+    ~ProtocolRecorder() override;
+
+    bool isEnabled() const;
+
+public Q_SLOTS:
+    Q_SCRIPTABLE void setEnabled(bool enabled);
+    /**
+     * Writes the messages of the last @a seconds, or all recorded messages if @a seconds is 0,
+     * to a new file in the runtime directory and returns its path, or an empty string on failure.
+     */
+    Q_SCRIPTABLE QString dump(uint seconds);
+
+Q_SIGNALS:
+    void enabledChanged();
+
+private:
+    struct Record
+    {
+        std::chrono::nanoseconds timestamp;
+        const char *interface;
+        const wl_message *message;
+        quint32 objectId;
+        quint8 event;
+        quint8 argumentCount;
+        quint32 arguments[s_maxArguments];
+    };
+
+    struct ClientLog
+    {
+        ProtocolRecorder *recorder;
+        wl_listener destroyListener;
+        quint32 id;
+        qint32 pid;
+        QString executable;
+        std::vector<Record> records;
+        size_t next = 0;
+        bool wrapped = false;
+        bool connected = true;
+    };
+
+    static void loggerCallback(void *userData, wl_protocol_logger_type type, const wl_protocol_logger_message *message);
+    static void clientDestroyedCallback(wl_listener *listener, void *data);
+
+    ClientLog *logForClient(wl_client *client);
+    void record(ClientLog *log, wl_protocol_logger_type type, const wl_protocol_logger_message *message);
+
+    Display *m_display;
+    wl_protocol_logger *m_logger = nullptr;
+    QHash<wl_client *, ClientLog *> m_clients;
+    std::deque<std::unique_ptr<ClientLog>> m_logs;
+    wl_client *m_lastClient = nullptr;
+    ClientLog *m_lastLog = nullptr;
+    size_t m_recordsPerClient;
+    quint32 m_nextClientId = 1;
+};
+
+} // namespace KWin
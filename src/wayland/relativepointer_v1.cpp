@@ -71,6 +71,14 @@ void RelativePointerV1Interface::zwp_relative_pointer_v1_destroy(Resource *resou
     wl_resource_destroy(resource->handle);
 }
 
+bool RelativePointerV1Interface::isBound() const
+{
+    if (!pointer->focusedSurface()) {
+        return false;
+    }
+    return resourceMap().contains(pointer->focusedSurface()->client()->client());
+}
+
 void RelativePointerV1Interface::sendRelativeMotion(const QPointF &delta, const QPointF &deltaNonAccelerated, std::chrono::microseconds time)
 {
     if (!pointer->focusedSurface()) {
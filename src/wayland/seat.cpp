@@ -7,6 +7,7 @@
 */
 #include "seat.h"
 #include "abstract_data_source.h"
+#include "clientconnection.h"
 #include "datacontroldevice_v1.h"
 #include "datacontrolsource_v1.h"
 #include "datadevice.h"
@@ -450,6 +451,7 @@ void SeatInterface::notifyPointerMotion(const QPointF &pos)
     }
 
     d->pointer->sendMotion(localPosition);
+    d->traceInput(effectiveFocusedSurface);
 }
 
 std::chrono::milliseconds SeatInterface::timestamp() const
@@ -460,6 +462,14 @@ std::chrono::milliseconds SeatInterface::timestamp() const
 void SeatInterface::setTimestamp(std::chrono::microseconds time)
 {
     d->timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(time);
+    d->preciseTimestamp = time;
+}
+
+void SeatInterfacePrivate::traceInput(SurfaceInterface *surface)
+{
+    if (surface) {
+        surface->client()->traceInput(preciseTimestamp);
+    }
 }
 
 void SeatInterface::setDragTarget(AbstractDropHandler *dropTarget,
@@ -651,6 +661,7 @@ void SeatInterface::notifyPointerAxis(Qt::Orientation orientation, qreal delta,
         return;
     }
     d->pointer->sendAxis(orientation, delta, deltaV120, source, inverted);
+    d->traceInput(d->pointer->focusedSurface());
 }
 
 void SeatInterface::notifyPointerButton(Qt::MouseButton button, PointerButtonState state)
@@ -696,6 +707,7 @@ void SeatInterface::notifyPointerButton(quint32 button, PointerButtonState state
     }
 
     d->pointer->sendButton(button, state, serial);
+    d->traceInput(d->pointer->focusedSurface());
 }
 
 void SeatInterface::notifyPointerFrame()
@@ -736,6 +748,16 @@ void SeatInterface::relativePointerMotion(const QPointF &delta, const QPointF &d
     }
 }
 
+bool SeatInterface::isRelativePointerBound() const
+{
+    if (!d->pointer) {
+        return false;
+    }
+
+    auto relativePointer = RelativePointerV1Interface::get(pointer());
+    return relativePointer && relativePointer->isBound();
+}
+
 void SeatInterface::startPointerSwipeGesture(quint32 fingerCount)
 {
     if (!d->pointer) {
@@ -899,6 +921,7 @@ void SeatInterface::notifyKeyboardKey(quint32 keyCode, KeyboardKeyState state, u
         return;
     }
     d->keyboard->sendKey(keyCode, state, serial);
+    d->traceInput(d->keyboard->focusedSurface());
 }
 
 void SeatInterface::notifyKeyboardModifiers(quint32 depressed, quint32 latched, quint32 locked, quint32 group)
@@ -969,6 +992,7 @@ TouchPoint *SeatInterface::notifyTouchDown(SurfaceInterface *surface, const QPoi
     const auto [effectiveTouchedSurface, pos] = surface->mapToInputSurface(globalPosition - surfacePosition);
     const quint32 serial = display()->nextSerial();
     d->touch->sendDown(effectiveTouchedSurface, id, serial, pos);
+    d->traceInput(effectiveTouchedSurface);
 
     auto touchPoint = std::make_unique<TouchPoint>(id, serial, surface, this);
     touchPoint->position = globalPosition;
@@ -999,6 +1023,7 @@ void SeatInterface::notifyTouchMotion(qint32 id, const QPointF &globalPosition)
     if (touchPoint->surface) {
         const auto [effectiveTouchedSurface, pos] = touchPoint->surface->mapToInputSurface(globalPosition - touchPoint->offset);
         d->touch->sendMotion(effectiveTouchedSurface, id, pos);
+        d->traceInput(effectiveTouchedSurface);
     }
 
     Q_EMIT touchMoved(id, touchPoint->serial, globalPosition);
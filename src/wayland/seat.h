@@ -375,6 +375,11 @@ public:
      * @see setPointerPos
      */
     void relativePointerMotion(const QPointF &delta, const QPointF &deltaNonAccelerated, std::chrono::microseconds timestamp);
+    /**
+     * Returns @c true if the client of the currently focused pointer surface has created a
+     * relative pointer, and therefore wants every motion event with its precise timestamp.
+     */
+    bool isRelativePointerBound() const;
 
     /**
      * Starts a multi-finger swipe gesture for the currently focused pointer surface.
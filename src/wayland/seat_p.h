@@ -47,6 +47,7 @@ public:
     void registerDataDevice(DataDeviceInterface *dataDevice);
     void registerDataControlDevice(DataControlDeviceV1Interface *dataDevice);
     bool dragInhibitsPointer(SurfaceInterface *surface) const;
+    void traceInput(SurfaceInterface *surface);
 
     void offerSelection(DataDeviceInterface *device);
     void offerSelection(DataControlDeviceV1Interface *device);
@@ -57,6 +58,7 @@ public:
     QPointer<Display> display;
     QString name;
     std::chrono::milliseconds timestamp = std::chrono::milliseconds::zero();
+    std::chrono::microseconds preciseTimestamp = std::chrono::microseconds::zero();
     quint32 capabilities = 0;
     std::unique_ptr<KeyboardInterface> keyboard;
     std::unique_ptr<PointerInterface> pointer;
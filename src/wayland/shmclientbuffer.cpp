@@ -8,16 +8,23 @@
 
 #include "core/drm_formats.h"
 #include "core/gpumanager.h"
+#include "core/graphicsbufferview.h"
+#include "utils/common.h"
 #include "wayland/display.h"
 #include "wayland/shmclientbuffer.h"
 #include "wayland/shmclientbuffer_p.h"
 
+#include <QThread>
+
+#include <algorithm>
 #include <drm_fourcc.h>
 #include <fcntl.h>
 #include <mutex>
 #include <signal.h>
+#include <sys/eventfd.h>
 #include <sys/mman.h>
 #include <sys/stat.h>
+#include <unistd.h>
 
 #if defined(Q_OS_LINUX)
 #include <linux/dma-buf.h>
@@ -92,6 +99,51 @@ void ShmPool::unref()
     }
 }
 
+std::optional<DmaBufAttributes> ShmPool::importUdmabuf(const ShmAttributes &attributes)
+{
+    ShmUdmabufStatistics &statistics = ShmClientBufferIntegrationPrivate::get(integration)->udmabufStatistics;
+
+    // udmabufs can only be created for memfds that are sealed against shrinking
+    if (!sigbusImpossible) {
+        statistics.uploads++;
+        return std::nullopt;
+    }
+
+    const size_t pageSize = getpagesize();
+    if (attributes.offset % pageSize == 0) {
+        const size_t end = attributes.offset + size_t(attributes.stride) * attributes.size.height();
+        if (end > udmabufSize && !udmabufFailed) {
+            // Either there's no udmabuf yet, or the pool has grown since it was created
+            const size_t size = mapping->size() / pageSize * pageSize;
+            if (end <= size) {
+                udmabuf = GpuManager::self()->createUdmabuf(fd, 0, size);
+                if (udmabuf.isValid()) {
+                    udmabufSize = size;
+                    statistics.poolImports++;
+                } else {
+                    // e.g. the pool exceeds the size limit of udmabufs, don't try again
+                    udmabufSize = 0;
+                    udmabufFailed = true;
+                }
+            }
+        }
+        if (end <= udmabufSize) {
+            if (auto ret = GpuManager::self()->udmabufAttributes(udmabuf.duplicate(), attributes.offset, &attributes)) {
+                statistics.cachedImports++;
+                return ret;
+            }
+        }
+    }
+
+    if (auto ret = GpuManager::self()->createUdmabuf(&attributes)) {
+        statistics.bufferImports++;
+        return ret;
+    }
+
+    statistics.uploads++;
+    return std::nullopt;
+}
+
 void ShmPool::shm_pool_destroy_resource(Resource *resource)
 {
     unref();
@@ -181,7 +233,7 @@ const struct wl_buffer_interface ShmClientBuffer::implementation = {
 ShmClientBuffer::ShmClientBuffer(ShmPool *pool, ShmAttributes attributes, wl_client *client, uint32_t id)
     : m_shmPool(pool)
     , m_shmAttributes(std::move(attributes))
-    , m_udmabufAttributes(GpuManager::self()->createUdmabuf(&m_shmAttributes))
+    , m_udmabufAttributes(pool->importUdmabuf(m_shmAttributes))
 {
     m_shmPool->ref();
     if (m_udmabufAttributes) {
@@ -224,6 +276,11 @@ void ShmClientBuffer::onReferenced()
 
 void ShmClientBuffer::onReleased()
 {
+    if (m_conversion) {
+        // the client is free to reuse the buffer now, the next commit will convert it again
+        std::lock_guard lock(m_conversion->mutex);
+        m_conversion->image = QImage();
+    }
 #if defined(Q_OS_LINUX)
     if (m_udmabufAttributes) {
         struct dma_buf_sync sync = {
@@ -255,6 +312,81 @@ const DmaBufAttributes *ShmClientBuffer::udmabufAttributes() const
     return m_udmabufAttributes ? &*m_udmabufAttributes : nullptr;
 }
 
+QImage ShmClientBuffer::convertedImage() const
+{
+    if (!m_conversion) {
+        return QImage();
+    }
+    std::lock_guard lock(m_conversion->mutex);
+    return m_conversion->image;
+}
+
+static bool asyncConversionEnabled()
+{
+    static const bool enabled = qEnvironmentVariable("KWIN_SHM_ASYNC_CONVERSION") != QLatin1StringView("0");
+    return enabled;
+}
+
+FileDescriptor ShmClientBuffer::convert()
+{
+    const QImage::Format format = drmFormatToQImageFormat(m_shmAttributes.format);
+    if (format == QImage::Format_ARGB32_Premultiplied || format == QImage::Format_Invalid) {
+        return FileDescriptor{};
+    }
+
+    // Any conversion that is still running is for older contents, make sure its result is discarded
+    const uint64_t generation = ++m_conversionGeneration;
+    if (m_conversion) {
+        std::lock_guard lock(m_conversion->mutex);
+        m_conversion->image = QImage();
+        m_conversion->generation = generation;
+    }
+
+    // The worker threads can't deal with SIGBUS, so only pools that can't shrink are eligible.
+    // Buffers that are imported as udmabufs are not uploaded at all.
+    if (!asyncConversionEnabled() || !m_shmPool->sigbusImpossible || m_udmabufAttributes) {
+        return FileDescriptor{};
+    }
+
+    FileDescriptor fence{eventfd(0, EFD_CLOEXEC)};
+    FileDescriptor signal = fence.duplicate();
+    if (!signal.isValid()) {
+        return FileDescriptor{};
+    }
+
+    if (!m_conversion) {
+        m_conversion = std::make_shared<ShmConversion>();
+        m_conversion->generation = generation;
+    }
+
+    auto task = [conversion = m_conversion,
+                 mapping = m_shmPool->mapping,
+                 offset = m_shmAttributes.offset,
+                 stride = m_shmAttributes.stride,
+                 size = m_shmAttributes.size,
+                 format,
+                 generation,
+                 signal = std::move(signal)]() {
+        const QImage source(static_cast<const uchar *>(mapping->data()) + offset, size.width(), size.height(), stride, format);
+        QImage converted = source.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+
+        {
+            std::lock_guard lock(conversion->mutex);
+            if (conversion->generation == generation) {
+                conversion->image = std::move(converted);
+            }
+        }
+
+        const uint64_t value = 1;
+        if (write(signal.get(), &value, sizeof(value)) != sizeof(value)) {
+            qCWarning(KWIN_CORE) << "Failed to signal the completion of an shm buffer conversion";
+        }
+    };
+    ShmClientBufferIntegrationPrivate::get(m_shmPool->integration)->conversionPool.start(std::move(task));
+
+    return fence;
+}
+
 ShmClientBuffer *ShmClientBuffer::get(wl_resource *resource)
 {
     if (wl_resource_instance_of(resource, &wl_buffer_interface, &implementation)) {
@@ -353,6 +485,14 @@ ShmClientBufferIntegrationPrivate::ShmClientBufferIntegrationPrivate(Display *di
     : QtWaylandServer::wl_shm(*display, s_version)
     , q(q)
 {
+    // a couple of threads are enough to keep clients that spam shm commits from blocking others
+    conversionPool.setMaxThreadCount(std::clamp(QThread::idealThreadCount() / 2, 1, 2));
+    conversionPool.setObjectName(QStringLiteral("ShmConversion"));
+}
+
+ShmClientBufferIntegrationPrivate *ShmClientBufferIntegrationPrivate::get(ShmClientBufferIntegration *integration)
+{
+    return integration->d.get();
 }
 
 void ShmClientBufferIntegrationPrivate::shm_bind_resource(Resource *resource)
@@ -395,6 +535,11 @@ ShmClientBufferIntegration::~ShmClientBufferIntegration()
 {
 }
 
+ShmUdmabufStatistics ShmClientBufferIntegration::udmabufStatistics() const
+{
+    return d->udmabufStatistics;
+}
+
 } // namespace KWin
 
 #include "moc_shmclientbuffer_p.cpp"
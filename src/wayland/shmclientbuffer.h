@@ -10,12 +10,37 @@
 
 #include <QObject>
 
+#include <cstdint>
+
 namespace KWin
 {
 
 class Display;
 class ShmClientBufferIntegrationPrivate;
 
+/**
+ * Counts how shm buffers have been made available to the GPU.
+ */
+struct ShmUdmabufStatistics
+{
+    /**
+     * Buffers that reference the cached udmabuf of their pool.
+     */
+    uint64_t cachedImports = 0;
+    /**
+     * Buffers that needed a udmabuf of their own.
+     */
+    uint64_t bufferImports = 0;
+    /**
+     * Buffers that couldn't be imported and have to be uploaded.
+     */
+    uint64_t uploads = 0;
+    /**
+     * Udmabufs that have been created for whole pools.
+     */
+    uint64_t poolImports = 0;
+};
+
 /**
  * The ShmClientBufferIntegration class provides support for shared memory client buffers.
  */
@@ -27,6 +52,8 @@ public:
     explicit ShmClientBufferIntegration(Display *display);
     ~ShmClientBufferIntegration() override;
 
+    ShmUdmabufStatistics udmabufStatistics() const;
+
 private:
     friend class ShmClientBufferIntegrationPrivate;
     std::unique_ptr<ShmClientBufferIntegrationPrivate> d;
@@ -13,6 +13,11 @@
 
 #include "qwayland-server-wayland.h"
 
+#include <QImage>
+#include <QThreadPool>
+
+#include <mutex>
+
 namespace KWin
 {
 
@@ -21,7 +26,14 @@ class ShmClientBufferIntegrationPrivate : public QtWaylandServer::wl_shm
 public:
     ShmClientBufferIntegrationPrivate(Display *display, ShmClientBufferIntegration *q);
 
+    static ShmClientBufferIntegrationPrivate *get(ShmClientBufferIntegration *integration);
+
     ShmClientBufferIntegration *q;
+    /**
+     * Converts the contents of shm buffers off the main thread, see ShmClientBuffer::convert().
+     */
+    QThreadPool conversionPool;
+    ShmUdmabufStatistics udmabufStatistics;
 
 protected:
     void shm_bind_resource(Resource *resource) override;
@@ -37,11 +49,20 @@ public:
     void ref();
     void unref();
 
+    /**
+     * Makes the buffer with the given @a attributes available as a dmabuf. If possible, the
+     * whole pool is converted to a udmabuf once, and buffers only reference a range of it.
+     */
+    std::optional<DmaBufAttributes> importUdmabuf(const ShmAttributes &attributes);
+
     ShmClientBufferIntegration *integration;
     std::shared_ptr<MemoryMap> mapping;
     FileDescriptor fd;
+    FileDescriptor udmabuf;
+    size_t udmabufSize = 0;
     int refCount = 1;
     bool sigbusImpossible = false;
+    bool udmabufFailed = false;
 
 protected:
     void shm_pool_destroy_resource(Resource *resource) override;
@@ -57,6 +78,17 @@ struct ShmAccess
     std::atomic<ShmAccess *> next = nullptr;
 };
 
+/**
+ * The result of converting an shm buffer on a worker thread. The image is replaced as a whole
+ * when a conversion finishes, so a QImage that has been handed out is never written to.
+ */
+struct ShmConversion
+{
+    std::mutex mutex;
+    QImage image;
+    uint64_t generation = 0;
+};
+
 class KWIN_EXPORT ShmClientBuffer : public GraphicsBuffer
 {
     Q_OBJECT
@@ -72,6 +104,15 @@ public:
     bool hasAlphaChannel() const override;
     const ShmAttributes *shmAttributes() const override;
     const DmaBufAttributes *udmabufAttributes() const override;
+    QImage convertedImage() const override;
+
+    /**
+     * Starts converting the current contents of the buffer to QImage::Format_ARGB32_Premultiplied
+     * on a worker thread, if the buffer has a format that can't be uploaded as is. Returns a file
+     * descriptor that becomes readable when the conversion is done, or an invalid file descriptor
+     * if nothing has to be waited for.
+     */
+    FileDescriptor convert();
 
     static ShmClientBuffer *get(wl_resource *resource);
 
@@ -87,6 +128,8 @@ private:
     ShmAttributes m_shmAttributes;
     std::optional<DmaBufAttributes> m_udmabufAttributes;
     std::optional<ShmAccess> m_shmAccess;
+    std::shared_ptr<ShmConversion> m_conversion;
+    uint64_t m_conversionGeneration = 0;
 };
 
 } // namespace KWin
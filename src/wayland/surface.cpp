@@ -300,6 +300,9 @@ void SurfaceInterfacePrivate::surface_commit(Resource *resource)
     if (pending->buffer && pending->buffer->dmabufAttributes()) {
         switch (pending->buffer->dmabufAttributes()->format) {
         case DRM_FORMAT_NV12:
+        case DRM_FORMAT_NV21:
+        case DRM_FORMAT_NV16:
+        case DRM_FORMAT_NV24:
         case DRM_FORMAT_XYUV8888:
             if (!hasColorRepresentation) {
                 pending->yuvCoefficients = YUVMatrixCoefficients::BT709;
@@ -312,6 +315,8 @@ void SurfaceInterfacePrivate::surface_commit(Resource *resource)
             }
             break;
         case DRM_FORMAT_P010:
+        case DRM_FORMAT_P012:
+        case DRM_FORMAT_P016:
             if (!hasColorRepresentation) {
                 pending->yuvCoefficients = YUVMatrixCoefficients::BT2020;
                 pending->range = EncodingRange::Limited;
@@ -422,9 +427,12 @@ SurfaceInterface::SurfaceInterface(CompositorInterface *compositor, wl_resource
         d->serverScale = d->client->scaleOverride();
     });
 
-    d->fifoFallbackTimer.setInterval(1000 / 20);
+    static const bool coalesceCommits = qEnvironmentVariableIntValue("KWIN_WAYLAND_COALESCE_COMMITS") == 1;
+    d->commitCoalescing = coalesceCommits;
+
+    d->fifoFallbackTimer.setTimerType(Qt::PreciseTimer);
     d->fifoFallbackTimer.setSingleShot(true);
-    connect(&d->fifoFallbackTimer, &QTimer::timeout, this, &SurfaceInterface::handleFifoFallback);
+    connect(&d->fifoFallbackTimer, &QChronoTimer::timeout, this, &SurfaceInterface::handleFifoFallback);
 }
 
 SurfaceInterface::~SurfaceInterface()
@@ -505,7 +513,7 @@ void SurfaceInterface::frameRendered(quint32 msec)
     }
 }
 
-std::shared_ptr<PresentationFeedback> SurfaceInterface::presentationFeedback(LogicalOutput *output)
+std::shared_ptr<PresentationTimeFeedback> SurfaceInterface::presentationFeedback(LogicalOutput *output)
 {
     if (output && (!d->primaryOutput || d->primaryOutput->handle() != output)) {
         return nullptr;
@@ -513,6 +521,16 @@ std::shared_ptr<PresentationFeedback> SurfaceInterface::presentationFeedback(Log
     return d->current->presentationFeedback;
 }
 
+std::shared_ptr<PresentationFeedback> SurfaceInterface::takeCommitLatencyFeedback()
+{
+    if (!d->commitTimings) {
+        return nullptr;
+    }
+    auto feedback = std::make_shared<CommitLatencyFeedback>(d->client, *d->commitTimings);
+    d->commitTimings.reset();
+    return feedback;
+}
+
 bool SurfaceInterface::hasPresentationFeedback() const
 {
     return d->current->presentationFeedback.get();
@@ -560,6 +578,7 @@ void SurfaceState::mergeInto(SurfaceState *target)
         target->offset = offset;
         target->acquirePoint = std::move(acquirePoint);
         target->releasePoint = std::move(releasePoint);
+        target->acquireFence = std::move(acquireFence);
     }
 
     wl_list_insert_list(&target->frameCallbacks, &frameCallbacks);
@@ -618,6 +637,16 @@ void SurfaceState::mergeInto(SurfaceState *target)
     target->committed |= std::exchange(committed, SurfaceState::Fields{});
 }
 
+void SurfaceInterfacePrivate::addAcquireLatency(std::chrono::nanoseconds latency)
+{
+    // react quickly to the client getting slower, but only slowly to it getting faster
+    if (latency > acquireLatency) {
+        acquireLatency = latency;
+    } else {
+        acquireLatency = (acquireLatency * 7 + latency) / 8;
+    }
+}
+
 void SurfaceInterfacePrivate::applyState(SurfaceState *next)
 {
     const bool bufferChanged = (next->committed & SurfaceState::Field::Buffer) && (current->buffer != next->buffer);
@@ -632,6 +661,7 @@ void SurfaceInterfacePrivate::applyState(SurfaceState *next)
         && (current->colorDescription != next->colorDescription || current->renderingIntent != next->renderingIntent);
     const bool presentationModeHintChanged = (next->committed & SurfaceState::Field::PresentationModeHint);
     const bool bufferReleasePointChanged = (next->committed & SurfaceState::Field::Buffer) && current->releasePoint != next->releasePoint;
+    const bool bufferAcquireFenceChanged = (next->committed & SurfaceState::Field::Buffer) && (current->acquireFence.isValid() || next->acquireFence.isValid());
     const bool alphaMultiplierChanged = (next->committed & SurfaceState::Field::AlphaMultiplier);
     const bool yuvCoefficientsChanged = (next->committed & SurfaceState::Field::YuvCoefficients) && (current->yuvCoefficients != next->yuvCoefficients);
     const bool pointerLockRegionChanged = (next->committed & SurfaceState::Field::PointerLockRegion) && (current->pointerLockRegion != next->pointerLockRegion);
@@ -691,8 +721,11 @@ void SurfaceInterfacePrivate::applyState(SurfaceState *next)
     if (visibilityChanged) {
         updateEffectiveMapped();
     }
-    if (current->fifoBarrier) {
-        fifoFallbackTimer.start();
+    if (commitCoalescing && bufferChanged && current->buffer && !current->fifoBarrier) {
+        commitBarrier = true;
+    }
+    if (current->fifoBarrier || commitBarrier) {
+        startFifoFallbackTimer();
     }
 
     const bool inputRegionChanged = oldInputRegion != inputRegion;
@@ -755,6 +788,9 @@ void SurfaceInterfacePrivate::applyState(SurfaceState *next)
     if (bufferReleasePointChanged) {
         Q_EMIT q->bufferReleasePointChanged();
     }
+    if (bufferAcquireFenceChanged) {
+        Q_EMIT q->bufferAcquireFenceChanged();
+    }
     if (alphaMultiplierChanged) {
         Q_EMIT q->alphaMultiplierChanged();
     }
@@ -1283,6 +1319,11 @@ void SurfaceInterface::traverseTree(std::function<void(SurfaceInterface *surface
     }
 }
 
+const FileDescriptor &SurfaceInterface::bufferAcquireFence() const
+{
+    return d->current->acquireFence;
+}
+
 std::shared_ptr<SyncReleasePoint> SurfaceInterface::bufferReleasePoint() const
 {
     return d->current->releasePoint;
@@ -1293,19 +1334,92 @@ double SurfaceInterface::alphaMultiplier() const
     return d->current->alphaMultiplier;
 }
 
-void SurfaceInterface::clearFifoBarrier(std::optional<std::chrono::nanoseconds> refreshDuration)
+void SurfaceInterfacePrivate::startFifoFallbackTimer()
+{
+    const auto now = std::chrono::steady_clock::now().time_since_epoch();
+    if (!fifoRefreshDuration) {
+        fifoFallbackTimer.setInterval(std::chrono::milliseconds(1000 / 20));
+        fifoFallbackTimer.start();
+        return;
+    }
+
+    // some games don't work properly if the refresh rate goes too low with FIFO. 30Hz is assumed to be fine here.
+    // this must still be slower than the actual screen though, or fifo behavior would be broken! To keep the
+    // pacing of hidden surfaces even, the fallback interval is a whole number of refresh cycles
+    const std::chrono::nanoseconds refreshDuration = *fifoRefreshDuration;
+    const std::chrono::nanoseconds minimumInterval = std::chrono::nanoseconds(1'000'000'000) / 30;
+    const auto cycles = std::max<int64_t>(1, (minimumInterval + refreshDuration - std::chrono::nanoseconds(1)) / refreshDuration);
+    const std::chrono::nanoseconds interval = refreshDuration * cycles;
+
+    // the barrier is released between two vblanks, so that the timer doesn't race with the page flip of
+    // an output the surface is visible on, and not earlier than most of an interval from now, so that the
+    // barriers of a hidden surface are released exactly once every interval
+    const std::chrono::nanoseconds phase = fifoPresentationTimestamp + refreshDuration / 2;
+    const std::chrono::nanoseconds earliest = now + std::max(interval - refreshDuration / 2, interval * 3 / 4);
+    const auto elapsedCycles = std::max<int64_t>(0, (earliest - phase + refreshDuration - std::chrono::nanoseconds(1)) / refreshDuration);
+    const std::chrono::nanoseconds deadline = phase + refreshDuration * elapsedCycles;
+
+    fifoFallbackTimer.setInterval(deadline - now);
+    fifoFallbackTimer.start();
+}
+
+void SurfaceInterfacePrivate::handleFifoPresented(std::chrono::nanoseconds refreshDuration, std::chrono::nanoseconds timestamp)
+{
+    if (refreshDuration > std::chrono::nanoseconds::zero()) {
+        fifoRefreshDuration = refreshDuration;
+        fifoPresentationTimestamp = timestamp;
+    }
+    q->clearFifoBarrier();
+}
+
+class FifoBarrierFeedback : public PresentationFeedback
+{
+public:
+    explicit FifoBarrierFeedback(SurfaceInterface *surface)
+        : m_surface(surface)
+    {
+    }
+
+    ~FifoBarrierFeedback() override
+    {
+        // the frame has been discarded, there's no reason to hold the client back any longer
+        if (!m_presented && m_surface) {
+            m_surface->clearFifoBarrier();
+        }
+    }
+
+    void presented(std::chrono::nanoseconds refreshCycleDuration, std::chrono::nanoseconds timestamp, PresentationMode mode) override
+    {
+        m_presented = true;
+        if (m_surface) {
+            SurfaceInterfacePrivate::get(m_surface)->handleFifoPresented(refreshCycleDuration, timestamp);
+        }
+    }
+
+private:
+    QPointer<SurfaceInterface> m_surface;
+    bool m_presented = false;
+};
+
+std::shared_ptr<PresentationFeedback> SurfaceInterface::fifoBarrierFeedback(LogicalOutput *output)
+{
+    if (!d->current->fifoBarrier && !d->commitBarrier) {
+        return nullptr;
+    }
+    if (output && d->primaryOutput && d->primaryOutput->handle() != output) {
+        return nullptr;
+    }
+    return std::make_shared<FifoBarrierFeedback>(this);
+}
+
+void SurfaceInterface::clearFifoBarrier()
 {
     // When the barrier is cleared by the scene in time, the timer should never fire.
     // If the next transaction sets a fifo barrier again, that will start the timer again.
     d->fifoFallbackTimer.stop();
-    if (refreshDuration.has_value()) {
-        // some games don't work properly if the refresh rate goes too low with FIFO. 30Hz is assumed to be fine here.
-        // this must still be slower than the actual screen though, or fifo behavior would be broken!
-        const auto fallbackRefreshDuration = std::max(*refreshDuration * 5 / 4, std::chrono::nanoseconds(1'000'000'000) / 30);
-        d->fifoFallbackTimer.setInterval(std::chrono::duration_cast<std::chrono::milliseconds>(fallbackRefreshDuration));
-    }
-    if (d->current->fifoBarrier) {
+    if (d->current->fifoBarrier || d->commitBarrier) {
         d->current->fifoBarrier = false;
+        d->commitBarrier = false;
         if (d->firstTransaction) {
             d->firstTransaction->tryApply();
         }
@@ -1322,6 +1436,30 @@ bool SurfaceInterface::hasFifoBarrier() const
     return d->current->fifoBarrier;
 }
 
+void SurfaceInterface::setCommitCoalescing(bool enable)
+{
+    if (d->commitCoalescing == enable) {
+        return;
+    }
+    d->commitCoalescing = enable;
+    if (!enable && d->commitBarrier) {
+        d->commitBarrier = false;
+        if (d->firstTransaction) {
+            d->firstTransaction->tryApply();
+        }
+    }
+}
+
+bool SurfaceInterface::commitCoalescing() const
+{
+    return d->commitCoalescing;
+}
+
+bool SurfaceInterface::hasCommitBarrier() const
+{
+    return d->commitBarrier;
+}
+
 std::optional<RegionF> SurfaceInterface::confinedPointerRegion() const
 {
     return d->effectivePointerConfinement;
@@ -24,6 +24,7 @@ class CompositorInterface;
 class LinuxDmaBufV1Feedback;
 class LockedPointerV1Interface;
 class OutputInterface;
+class PresentationTimeFeedback;
 class ShadowInterface;
 class SlideInterface;
 class SubSurfaceInterface;
@@ -135,9 +136,16 @@ public:
     void frameRendered(quint32 msec);
     bool hasFrameCallbacks() const;
 
-    std::shared_ptr<PresentationFeedback> presentationFeedback(LogicalOutput *output);
+    std::shared_ptr<PresentationTimeFeedback> presentationFeedback(LogicalOutput *output);
     bool hasPresentationFeedback() const;
 
+    /**
+     * Returns a feedback that records the latency of the last applied buffer commit in the
+     * statistics of the client when it's presented. Only the first frame that contains the
+     * commit gets a feedback, @c null is returned for every following frame.
+     */
+    std::shared_ptr<PresentationFeedback> takeCommitLatencyFeedback();
+
     RegionF opaque() const;
     RegionF input() const;
     Region bufferDamage() const;
@@ -355,6 +363,14 @@ public:
      */
     std::shared_ptr<SyncReleasePoint> bufferReleasePoint() const;
 
+    /**
+     * Returns a fence that has to be waited for before the current buffer is read, or an
+     * invalid file descriptor if the client's rendering to it has already finished. This is
+     * only used if KWIN_WAYLAND_GPU_ACQUIRE_WAIT is set, otherwise the buffer isn't attached
+     * before it is ready
+     */
+    const FileDescriptor &bufferAcquireFence() const;
+
     /**
      * Traverses the surface sub-tree with this surface as the root.
      */
@@ -366,13 +382,38 @@ public:
     SurfaceInterface *mainSurface();
 
     /**
-     * Should be called immediately after compositing a non-tearing frame.
-     * If it's not called within one refreshDuration after the barrier is set,
-     * it will be cleared automatically.
+     * Returns a feedback that clears the FIFO barrier when the frame it is added to gets
+     * presented, or @c null if there's no barrier or @a output is not the primary output of
+     * the surface. If the frame is discarded, the barrier is cleared as well.
+     *
+     * If no frame clears the barrier, for example because the surface is hidden, it will be
+     * cleared automatically, in step with the refresh cycles of the last presentation.
      */
-    void clearFifoBarrier(std::optional<std::chrono::nanoseconds> refreshDuration = std::nullopt);
+    std::shared_ptr<PresentationFeedback> fifoBarrierFeedback(LogicalOutput *output);
+    void clearFifoBarrier();
     bool hasFifoBarrier() const;
 
+    /**
+     * Sets whether buffer commits that arrive faster than the surface is painted should be
+     * collapsed. If enabled, a new buffer is not applied until the previous one has been
+     * painted, and only the latest queued state is applied then. Buffers that are skipped
+     * are released right away and their presentation feedback is discarded. Commits that
+     * use a FIFO wait condition are never collapsed.
+     *
+     * This is disabled by default, unless the KWIN_WAYLAND_COALESCE_COMMITS environment
+     * variable is set to 1.
+     */
+    void setCommitCoalescing(bool enable);
+    bool commitCoalescing() const;
+
+    /**
+     * Returns @c true if a new buffer can't be applied until the current one has been painted.
+     * The barrier is cleared together with the FIFO barrier.
+     *
+     * @see setCommitCoalescing, fifoBarrierFeedback
+     */
+    bool hasCommitBarrier() const;
+
     /**
      * Registers the specified @a extension. Returns the pending state for the extension.
      *
@@ -464,6 +505,7 @@ Q_SIGNALS:
     void colorDescriptionChanged();
     void presentationModeHintChanged();
     void bufferReleasePointChanged();
+    void bufferAcquireFenceChanged();
     void alphaMultiplierChanged();
 
     /**
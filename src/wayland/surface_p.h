@@ -9,11 +9,12 @@
 #include "core/graphicsbuffer.h"
 #include "core/region.h"
 #include "surface.h"
+#include "wayland/commitlatency.h"
 // Qt
 #include <QHash>
 #include <QList>
+#include <QChronoTimer>
 #include <QPointer>
-#include <QTimer>
 // Wayland
 #include "qwayland-server-wayland.h"
 // C++
@@ -98,6 +99,11 @@ struct SurfaceState
         uint64_t point = 0;
     } acquirePoint;
     std::shared_ptr<SyncObjReleasePoint> releasePoint;
+    /**
+     * A fence that has to be waited for on the GPU before the buffer is read, if the
+     * transaction has been applied without waiting for the client's rendering
+     */
+    FileDescriptor acquireFence;
     double alphaMultiplier = 1;
     YUVMatrixCoefficients yuvCoefficients = YUVMatrixCoefficients::Identity;
     EncodingRange range = EncodingRange::Full;
@@ -213,7 +219,25 @@ public:
     ColorRepresentationSurfaceV1 *colorRepresentation = nullptr;
     ExtBlurSurfaceV1 *extBlur = nullptr;
     ExtBackgroundEffectSurfaceV1 *extBackgroundeffect = nullptr;
-    QTimer fifoFallbackTimer;
+    void startFifoFallbackTimer();
+    void handleFifoPresented(std::chrono::nanoseconds refreshDuration, std::chrono::nanoseconds timestamp);
+
+    QChronoTimer fifoFallbackTimer;
+    /**
+     * The refresh duration and the timestamp of the last presentation that cleared the FIFO
+     * barrier. The fallback timer fires in step with these refresh cycles.
+     */
+    std::optional<std::chrono::nanoseconds> fifoRefreshDuration;
+    std::chrono::nanoseconds fifoPresentationTimestamp = std::chrono::nanoseconds::zero();
+    bool commitCoalescing = false;
+    bool commitBarrier = false;
+    std::optional<CommitTimings> commitTimings;
+    /**
+     * An estimate of how long the rendering of the client takes to finish after it commits
+     * a buffer, see addAcquireLatency()
+     */
+    std::chrono::nanoseconds acquireLatency = std::chrono::nanoseconds::zero();
+    void addAcquireLatency(std::chrono::nanoseconds latency);
 
     struct
     {
@@ -5,12 +5,28 @@
 */
 
 #include "wayland/transaction.h"
+#include "core/backendoutput.h"
+#include "core/renderloop.h"
 #include "core/syncobjtimeline.h"
+#include "utils/common.h"
+#include "utils/envvar.h"
+#include "ftrace.h"
 #include "utils/filedescriptor.h"
 #include "wayland/clientconnection.h"
+#include "wayland/output.h"
+#include "wayland/shmclientbuffer_p.h"
 #include "wayland/subcompositor.h"
 #include "wayland/surface_p.h"
 
+#include <QSocketNotifier>
+
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <unordered_map>
+
+#include <sys/epoll.h>
+
 #if defined(Q_OS_LINUX)
 #include <linux/dma-buf.h>
 #include <xf86drm.h>
@@ -19,20 +35,124 @@
 namespace KWin
 {
 
+class TransactionFenceWaiter
+{
+public:
+    static TransactionFenceWaiter *self();
+
+    TransactionFenceWaiter();
+
+    bool watch(TransactionFence *fence);
+    void unwatch(TransactionFence *fence);
+
+private:
+    void dispatch();
+
+    FileDescriptor m_epollFd;
+    std::unique_ptr<QSocketNotifier> m_notifier;
+    std::unordered_map<uint64_t, TransactionFence *> m_fences;
+    uint64_t m_lastId = 0;
+};
+
+TransactionFenceWaiter *TransactionFenceWaiter::self()
+{
+    static TransactionFenceWaiter waiter;
+    return &waiter;
+}
+
+TransactionFenceWaiter::TransactionFenceWaiter()
+    : m_epollFd(epoll_create1(EPOLL_CLOEXEC))
+{
+    if (!m_epollFd.isValid()) {
+        qCWarning(KWIN_CORE) << "Failed to create an epoll instance for transaction fences:" << strerror(errno);
+        return;
+    }
+    m_notifier = std::make_unique<QSocketNotifier>(m_epollFd.get(), QSocketNotifier::Read);
+    QObject::connect(m_notifier.get(), &QSocketNotifier::activated, m_notifier.get(), [this]() {
+        dispatch();
+    });
+}
+
+bool TransactionFenceWaiter::watch(TransactionFence *fence)
+{
+    if (!m_epollFd.isValid()) {
+        return false;
+    }
+
+    fence->m_id = ++m_lastId;
+    epoll_event event{
+        .events = EPOLLIN | EPOLLONESHOT,
+        .data = {.u64 = fence->m_id},
+    };
+    if (epoll_ctl(m_epollFd.get(), EPOLL_CTL_ADD, fence->m_fileDescriptor.get(), &event) != 0) {
+        qCWarning(KWIN_CORE) << "Failed to watch a transaction fence:" << strerror(errno);
+        return false;
+    }
+    m_fences[fence->m_id] = fence;
+    return true;
+}
+
+void TransactionFenceWaiter::unwatch(TransactionFence *fence)
+{
+    if (m_fences.erase(fence->m_id) && fence->m_waiting) {
+        epoll_ctl(m_epollFd.get(), EPOLL_CTL_DEL, fence->m_fileDescriptor.get(), nullptr);
+    }
+}
+
+void TransactionFenceWaiter::dispatch()
+{
+    std::array<epoll_event, 32> events;
+    int count;
+    do {
+        count = epoll_wait(m_epollFd.get(), events.data(), events.size(), 0);
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            qCWarning(KWIN_CORE) << "Failed to wait for transaction fences:" << strerror(errno);
+            return;
+        }
+
+        // Mark all signaled fences first, so a transaction that waits for several of them
+        // is applied only once.
+        for (int i = 0; i < count; ++i) {
+            const auto it = m_fences.find(events[i].data.u64);
+            if (it != m_fences.end()) {
+                TransactionFence *fence = it->second;
+                epoll_ctl(m_epollFd.get(), EPOLL_CTL_DEL, fence->m_fileDescriptor.get(), nullptr);
+                fence->m_waiting = false;
+                fence->m_transaction->m_fencesSignaled = std::chrono::steady_clock::now();
+            }
+        }
+
+        // Applying a transaction destroys its fences, the fences of the transactions that
+        // have been applied along with it won't be found anymore.
+        for (int i = 0; i < count; ++i) {
+            const auto it = m_fences.find(events[i].data.u64);
+            if (it != m_fences.end()) {
+                Transaction *transaction = it->second->m_transaction;
+                m_fences.erase(it);
+                transaction->tryApply();
+            }
+        }
+    } while (count == int(events.size()));
+}
+
 TransactionFence::TransactionFence(Transaction *transaction, FileDescriptor &&fileDescriptor)
     : m_transaction(transaction)
     , m_fileDescriptor(std::move(fileDescriptor))
 {
-    m_notifier = std::make_unique<QSocketNotifier>(m_fileDescriptor.get(), QSocketNotifier::Read);
-    QObject::connect(m_notifier.get(), &QSocketNotifier::activated, m_notifier.get(), [this]() {
-        m_notifier->setEnabled(false);
-        m_transaction->tryApply();
-    });
+    m_waiting = TransactionFenceWaiter::self()->watch(this);
+}
+
+TransactionFence::~TransactionFence()
+{
+    TransactionFenceWaiter::self()->unwatch(this);
 }
 
 bool TransactionFence::isWaiting() const
 {
-    return m_notifier->isEnabled();
+    return m_waiting;
 }
 
 bool TransactionEntry::isDiscarded() const
@@ -61,6 +181,10 @@ bool Transaction::isReady() const
             }
         }
 
+        if ((entry.state->committed & SurfaceState::Field::Buffer) && entry.surface->hasCommitBarrier()) {
+            return true;
+        }
+
         return entry.state->hasFifoWaitCondition && entry.surface->hasFifoBarrier();
     });
 }
@@ -146,6 +270,7 @@ static SurfaceInterface *mainSurface(SurfaceInterface *surface)
 
 void Transaction::apply()
 {
+    fTraceDuration("Apply transaction entries=", m_entries.size());
     // Sort surfaces so descendants come first, then their ancestors.
     std::sort(m_entries.begin(), m_entries.end(), [](const TransactionEntry &a, const TransactionEntry &b) {
         if (!a.surface) {
@@ -164,9 +289,22 @@ void Transaction::apply()
         return mainSurface(a.surface) < mainSurface(b.surface);
     });
 
+    const auto now = std::chrono::steady_clock::now();
     for (TransactionEntry &entry : m_entries) {
         if (!entry.isDiscarded()) {
-            SurfaceInterfacePrivate::get(entry.surface)->applyState(entry.state.get());
+            SurfaceInterfacePrivate *surfacePrivate = SurfaceInterfacePrivate::get(entry.surface);
+            if (entry.state->committed & SurfaceState::Field::Buffer) {
+                if (entry.state->buffer && !entry.state->acquireFence.isValid()) {
+                    surfacePrivate->addAcquireLatency(m_fencesSignaled.value_or(m_committed) - m_committed);
+                }
+                surfacePrivate->commitTimings = CommitTimings{
+                    .committed = m_committed,
+                    .fencesSignaled = m_fencesSignaled.value_or(m_committed),
+                    .applied = now,
+                    .input = std::exchange(m_input, std::nullopt),
+                };
+            }
+            surfacePrivate->applyState(entry.state.get());
         }
     }
 
@@ -203,15 +341,25 @@ void Transaction::tryApply()
 
 void Transaction::commit()
 {
+    m_committed = std::chrono::steady_clock::now();
     for (TransactionEntry &entry : m_entries) {
         if (!entry.surface) {
             continue;
         }
 
         if ((entry.state->committed & SurfaceState::Field::Buffer) && entry.state->buffer) {
+            if (!m_input) {
+                // the first new buffer after input events is assumed to be the reaction to them
+                m_input = entry.surface->client()->takeInputTrace();
+            }
+
             // Avoid applying the transaction until all graphics buffers have become idle.
-            if (entry.state->acquirePoint.timeline) {
+            if (waitOnGpu(&entry)) {
+                // the renderer waits for the buffer instead
+            } else if (entry.state->acquirePoint.timeline) {
                 watchSyncObj(&entry);
+            } else if (entry.buffer->shmAttributes()) {
+                watchShm(&entry);
             } else {
                 watchDmaBuf(&entry);
             }
@@ -232,9 +380,68 @@ void Transaction::commit()
         entry.surface->setLastTransaction(this);
     }
 
+    coalesce();
     tryApply();
 }
 
+void Transaction::coalesce()
+{
+    // Only simple commits of a single surface are collapsed, transactions that involve
+    // synchronized subsurfaces must be applied as they are.
+    if (m_entries.size() != 1) {
+        return;
+    }
+    TransactionEntry &entry = m_entries.front();
+    if (entry.isDiscarded() || !entry.surface->hasCommitBarrier() || entry.state->hasFifoWaitCondition) {
+        return;
+    }
+
+    Transaction *previous = entry.previousTransaction;
+    if (!previous || previous->m_entries.size() != 1) {
+        return;
+    }
+    TransactionEntry &previousEntry = previous->m_entries.front();
+    if (previousEntry.previousTransaction || previousEntry.state->hasFifoWaitCondition) {
+        return;
+    }
+    // The previous transaction must be blocked by nothing but the commit barrier
+    for (const auto &fence : previousEntry.fences) {
+        if (fence->isWaiting()) {
+            return;
+        }
+    }
+
+    auto state = std::make_unique<SurfaceState>();
+    previousEntry.state->mergeInto(state.get());
+    entry.state->mergeInto(state.get());
+    entry.state = std::move(state);
+    if (!entry.buffer && entry.state->buffer) {
+        entry.buffer = std::move(previousEntry.buffer);
+    }
+
+    entry.previousTransaction = nullptr;
+    entry.surface->setFirstTransaction(this);
+    if (!m_input) {
+        m_input = std::move(previous->m_input);
+    }
+
+    // This releases the skipped buffer and discards its presentation feedback
+    delete previous;
+}
+
+/**
+ * Returns when the buffers of the @a surface have to be ready to be shown in the next frame
+ * on its primary output, so the GPU driver can boost its clocks if the client is late.
+ */
+static std::optional<std::chrono::steady_clock::time_point> renderDeadline(SurfaceInterface *surface)
+{
+    OutputInterface *output = SurfaceInterfacePrivate::get(surface)->primaryOutput;
+    if (!output || !output->handle() || !output->handle()->backendOutput()->renderLoop()) {
+        return std::nullopt;
+    }
+    return std::chrono::steady_clock::time_point(output->handle()->backendOutput()->renderLoop()->nextRenderDeadline());
+}
+
 void Transaction::watchSyncObj(TransactionEntry *entry)
 {
     auto eventFd = entry->state->acquirePoint.timeline->eventFd(entry->state->acquirePoint.point);
@@ -246,6 +453,10 @@ void Transaction::watchSyncObj(TransactionEntry *entry)
         return;
     }
 
+    if (const auto deadline = renderDeadline(entry->surface)) {
+        entry->state->acquirePoint.timeline->setDeadline(entry->state->acquirePoint.point, *deadline);
+    }
+
     entry->fences.emplace_back(std::make_unique<TransactionFence>(this, std::move(eventFd)));
 }
 
@@ -280,10 +491,118 @@ void Transaction::watchDmaBuf(TransactionEntry *entry)
 
         auto syncFile = exportWaitSyncFile(fileDescriptor);
         if (syncFile.isValid()) {
+            if (const auto deadline = renderDeadline(entry->surface)) {
+                SyncReleasePoint::setSyncFdDeadline(syncFile, *deadline);
+            }
             entry->fences.emplace_back(std::make_unique<TransactionFence>(this, std::move(syncFile)));
         }
     }
 #endif
 }
 
+static const bool s_gpuAcquireWait = environmentVariableBoolValue("KWIN_WAYLAND_GPU_ACQUIRE_WAIT").value_or(false);
+
+/**
+ * Measures how long the client's rendering takes to finish if the transaction didn't wait for it.
+ */
+class AcquireFenceMonitor : public QObject
+{
+public:
+    AcquireFenceMonitor(SurfaceInterface *surface, FileDescriptor &&fence, std::chrono::steady_clock::time_point committed)
+        : QObject(surface)
+        , m_fence(std::move(fence))
+        , m_notifier(m_fence.get(), QSocketNotifier::Read)
+        , m_committed(committed)
+    {
+        connect(&m_notifier, &QSocketNotifier::activated, this, [this, surface]() {
+            SurfaceInterfacePrivate::get(surface)->addAcquireLatency(std::chrono::steady_clock::now() - m_committed);
+            deleteLater();
+        });
+    }
+
+private:
+    FileDescriptor m_fence;
+    QSocketNotifier m_notifier;
+    const std::chrono::steady_clock::time_point m_committed;
+};
+
+static std::chrono::nanoseconds gpuWaitBudget(SurfaceInterfacePrivate *surface)
+{
+    uint32_t refreshRate = 60000;
+    if (surface->primaryOutput && surface->primaryOutput->handle() && surface->primaryOutput->handle()->refreshRate() > 0) {
+        refreshRate = surface->primaryOutput->handle()->refreshRate();
+    }
+    return std::chrono::nanoseconds(1'000'000'000'000ull / refreshRate) / 2;
+}
+
+bool Transaction::waitOnGpu(TransactionEntry *entry)
+{
+#if defined(Q_OS_LINUX)
+    if (!s_gpuAcquireWait || !entry->buffer->dmabufAttributes()) {
+        return false;
+    }
+    // This is only worth it if the client usually finishes rendering well before the compositor
+    // has to start with its own rendering. Otherwise the whole frame would be delayed, so it's
+    // better to keep showing the previous buffer until the new one is ready
+    SurfaceInterfacePrivate *surfacePrivate = SurfaceInterfacePrivate::get(entry->surface);
+    if (surfacePrivate->acquireLatency > gpuWaitBudget(surfacePrivate)) {
+        return false;
+    }
+
+    FileDescriptor fence;
+    if (entry->state->acquirePoint.timeline) {
+        SyncTimeline *timeline = entry->state->acquirePoint.timeline.get();
+        // without a fence for the timeline point, there is nothing to wait for on the GPU yet
+        if (!timeline->isMaterialized(entry->state->acquirePoint.point)) {
+            return false;
+        }
+        fence = timeline->exportSyncFile(entry->state->acquirePoint.point);
+    } else {
+        const DmaBufAttributes *attributes = entry->buffer->dmabufAttributes();
+        for (int i = 0; i < attributes->planeCount; ++i) {
+            if (attributes->fd[i].isReadable()) {
+                continue;
+            }
+            FileDescriptor planeFence = exportWaitSyncFile(attributes->fd[i]);
+            if (!planeFence.isValid()) {
+                return false;
+            }
+            fence = fence.isValid() ? SyncReleasePoint::mergeSyncFds(fence, planeFence) : std::move(planeFence);
+        }
+        if (!fence.isValid()) {
+            // the buffer is idle already
+            return true;
+        }
+    }
+    if (!fence.isValid()) {
+        return false;
+    }
+    if (!fence.isReadable()) {
+        if (const auto deadline = renderDeadline(entry->surface)) {
+            SyncReleasePoint::setSyncFdDeadline(fence, *deadline);
+        }
+        new AcquireFenceMonitor(entry->surface, fence.duplicate(), m_committed);
+        entry->state->acquireFence = std::move(fence);
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+void Transaction::watchShm(TransactionEntry *entry)
+{
+    // Buffers that need a format conversion are converted on a worker thread, the
+    // transaction can be applied once the converted copy is ready.
+    auto shmBuffer = qobject_cast<ShmClientBuffer *>(entry->buffer.buffer());
+    if (!shmBuffer) {
+        return;
+    }
+
+    auto fence = shmBuffer->convert();
+    if (fence.isValid()) {
+        entry->fences.emplace_back(std::make_unique<TransactionFence>(this, std::move(fence)));
+    }
+}
+
 } // namespace KWin
@@ -7,12 +7,14 @@
 #pragma once
 
 #include "core/graphicsbuffer.h"
+#include "wayland/commitlatency.h"
 
 #include <QPointer>
-#include <QSocketNotifier>
 
+#include <chrono>
 #include <functional>
 #include <memory>
+#include <optional>
 #include <vector>
 
 namespace KWin
@@ -27,18 +29,25 @@ class Transaction;
  *
  * The TransactionFence prevents the corresponding transaction from getting applied until the
  * specified file descriptor becomes readable.
+ *
+ * All fences are watched by a single epoll instance, so waiting for a fence doesn't need a
+ * socket notifier of its own, and fences that signal at the same time are resolved together.
  */
 class TransactionFence
 {
 public:
     TransactionFence(Transaction *transaction, FileDescriptor &&fileDescriptor);
+    ~TransactionFence();
 
     bool isWaiting() const;
 
 private:
     Transaction *m_transaction;
-    std::unique_ptr<QSocketNotifier> m_notifier;
     FileDescriptor m_fileDescriptor;
+    uint64_t m_id = 0;
+    bool m_waiting = false;
+
+    friend class TransactionFenceWaiter;
 };
 
 /**
@@ -143,11 +152,19 @@ public:
 
 private:
     void apply();
+    void coalesce();
 
+    bool waitOnGpu(TransactionEntry *entry);
     void watchSyncObj(TransactionEntry *entry);
     void watchDmaBuf(TransactionEntry *entry);
+    void watchShm(TransactionEntry *entry);
 
     std::vector<TransactionEntry> m_entries;
+    std::chrono::steady_clock::time_point m_committed;
+    std::optional<std::chrono::steady_clock::time_point> m_fencesSignaled;
+    std::optional<InputTrace> m_input;
+
+    friend class TransactionFenceWaiter;
 };
 
 } // namespace KWin
@@ -65,6 +65,7 @@
 #include "wayland/pointergestures_v1.h"
 #include "wayland/pointerwarp_v1.h"
 #include "wayland/presentationtime.h"
+#include "wayland/protocolrecorder.h"
 #include "wayland/primaryselectiondevicemanager_v1.h"
 #include "wayland/relativepointer_v1.h"
 #include "wayland/screenedge_v1.h"
@@ -183,6 +184,8 @@ WaylandServer::WaylandServer(QObject *parent)
 
 WaylandServer::~WaylandServer()
 {
+    // the recorder has to be gone before the display is destroyed
+    m_protocolRecorder.reset();
     s_self = nullptr;
 }
 
@@ -478,6 +481,7 @@ bool WaylandServer::init()
     });
 
     new PresentationTime(m_display, m_display);
+    m_protocolRecorder = std::make_unique<ProtocolRecorder>(m_display);
     m_colorManager = new ColorManagerV1(m_display, m_display);
     m_xdgDialogWm = new KWin::XdgDialogWmV1Interface(m_display, m_display);
     connect(m_xdgDialogWm, &KWin::XdgDialogWmV1Interface::dialogCreated, this, [this](KWin::XdgDialogV1Interface *dialog) {
@@ -685,6 +689,7 @@ FileDescriptor WaylandServer::createXWaylandConnection()
         return FileDescriptor();
     }
     m_xwaylandConnection = socket.connection;
+    static_cast<KWinDisplay *>(m_display)->invalidateAllowedInterfaces(m_xwaylandConnection);
 
     m_xwaylandConnection->setScaleOverride(kwinApp()->xwaylandScale());
     connect(kwinApp(), &Application::xwaylandScaleChanged, m_xwaylandConnection, [this]() {
@@ -711,6 +716,7 @@ int WaylandServer::createInputMethodConnection()
         return -1;
     }
     m_inputMethodServerConnection = socket.connection;
+    static_cast<KWinDisplay *>(m_display)->invalidateAllowedInterfaces(m_inputMethodServerConnection);
     return socket.fd;
 }
 
@@ -62,6 +62,7 @@ class XdgPopupWindow;
 class XdgSurfaceWindow;
 class XdgToplevelWindow;
 class PresentationTime;
+class ProtocolRecorder;
 class ColorManagerV1;
 class LinuxDrmSyncObjV1Interface;
 class RenderBackend;
@@ -304,6 +305,7 @@ private:
     ColorRepresentationManagerV1 *m_colorRepresentation = nullptr;
     PointerWarpV1 *m_pointerWarp = nullptr;
     ExtBackgroundEffectManagerV1 *m_backgroundEffect = nullptr;
+    std::unique_ptr<ProtocolRecorder> m_protocolRecorder;
 
     std::shared_ptr<FileDescriptor> m_sleepInhibitor;
     KWIN_SINGLETON(WaylandServer)
@@ -3839,7 +3839,7 @@ void Window::requestTile(Tile *tile)
 
     m_requestedTile = tile;
     if (tile) {
-        moveResize(tile->windowGeometry());
+        workspace()->moveResizeBatched(this, tile->windowGeometry());
     } else {
         RectF geometry = moveResizeGeometry();
         if (geometryRestore().isValid()) {
@@ -3851,7 +3851,7 @@ void Window::requestTile(Tile *tile)
             geometry.moveTopLeft(QPointF(anchor.x() - geometry.width() * offset.x(),
                                          anchor.y() - geometry.height() * offset.y()));
         }
-        moveResize(geometry);
+        workspace()->moveResizeBatched(this, geometry);
     }
     doSetQuickTileMode();
     Q_EMIT requestedTileChanged();
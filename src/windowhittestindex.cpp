@@ -0,0 +1,189 @@
+/*
+    KWin - the KDE window manager
+    This file is part of the KDE project.
+
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#include "windowhittestindex.h"
+#include "wayland/surface.h"
+#include "window.h"
+#include "workspace.h"
+
+#include <KDecoration3/Decoration>
+
+#include <algorithm>
+#include <cmath>
+
+namespace KWin
+{
+
+// small enough that a pointer usually only has a handful of candidates,
+// large enough that a maximized window only covers a few dozen cells
+static constexpr qreal s_minimumCellSize = 256;
+static constexpr int s_maximumCellsPerSide = 64;
+
+WindowHitTestIndex::WindowHitTestIndex(Workspace *workspace)
+    : QObject(workspace)
+    , m_workspace(workspace)
+{
+    connect(workspace, &Workspace::stackingOrderChanged, this, &WindowHitTestIndex::invalidate);
+    connect(workspace, &Workspace::currentDesktopChanged, this, &WindowHitTestIndex::invalidate);
+    connect(workspace, &Workspace::currentActivityChanged, this, &WindowHitTestIndex::invalidate);
+    connect(workspace, &Workspace::showingDesktopChanged, this, &WindowHitTestIndex::invalidate);
+    connect(workspace, &Workspace::windowAdded, this, [this](Window *window) {
+        watch(window);
+        invalidate();
+    });
+    connect(workspace, &Workspace::windowRemoved, this, &WindowHitTestIndex::invalidate);
+}
+
+void WindowHitTestIndex::watch(Window *window)
+{
+    if (!m_watched.insert(window).second) {
+        return;
+    }
+    connect(window, &Window::bufferGeometryChanged, this, &WindowHitTestIndex::invalidate);
+    connect(window, &Window::frameGeometryChanged, this, &WindowHitTestIndex::invalidate);
+    connect(window, &Window::desktopsChanged, this, &WindowHitTestIndex::invalidate);
+    connect(window, &Window::activitiesChanged, this, &WindowHitTestIndex::invalidate);
+    connect(window, &Window::outputChanged, this, &WindowHitTestIndex::invalidate);
+    connect(window, &Window::minimizedChanged, this, &WindowHitTestIndex::invalidate);
+    connect(window, &Window::hiddenChanged, this, &WindowHitTestIndex::invalidate);
+    connect(window, &Window::hiddenByShowDesktopChanged, this, &WindowHitTestIndex::invalidate);
+    connect(window, &Window::readyForPaintingChanged, this, &WindowHitTestIndex::invalidate);
+    connect(window, &Window::decorationChanged, this, &WindowHitTestIndex::invalidate);
+    connect(window, &Window::surfaceChanged, this, &WindowHitTestIndex::invalidate);
+    connect(window, &Window::closed, this, &WindowHitTestIndex::invalidate);
+    connect(window, &QObject::destroyed, this, [this, window]() {
+        m_watched.erase(window);
+        invalidate();
+    });
+}
+
+void WindowHitTestIndex::invalidate()
+{
+    m_dirty = true;
+}
+
+static bool acceptsInput(const Window *window)
+{
+    return !window->isDeleted()
+        && window->isOnCurrentActivity()
+        && window->isOnCurrentDesktop()
+        && !window->isMinimized()
+        && !window->isHidden()
+        && !window->isHiddenByShowDesktop()
+        && window->readyForPainting();
+}
+
+static bool hasSubSurfaces(const Window *window)
+{
+    const SurfaceInterface *surface = window->surface();
+    return surface && (!surface->below().isEmpty() || !surface->above().isEmpty());
+}
+
+static RectF inputBounds(const Window *window)
+{
+    RectF bounds = window->bufferGeometry() | window->frameGeometry();
+    if (window->isDecorated()) {
+        // the decoration accepts input in the resize borders outside the frame as well
+        bounds |= window->frameGeometry().marginsAdded(window->decoration()->resizeOnlyBorders());
+    }
+    return bounds;
+}
+
+void WindowHitTestIndex::rebuild()
+{
+    m_dirty = false;
+    m_windows.clear();
+    m_unbounded.clear();
+    m_cells.clear();
+
+    const QList<Window *> &stacking = m_workspace->stackingOrder();
+    std::vector<RectF> bounds;
+    for (auto it = stacking.rbegin(); it != stacking.rend(); ++it) {
+        Window *window = *it;
+        watch(window);
+        if (!acceptsInput(window)) {
+            continue;
+        }
+        if (const SurfaceInterface *surface = window->surface()) {
+            // subsurfaces may be added to or removed from the surface without the window geometry changing
+            connect(surface, &SurfaceInterface::childSubSurfacesChanged, this, &WindowHitTestIndex::invalidate, Qt::UniqueConnection);
+        }
+        const uint32_t rank = m_windows.size();
+        m_windows.push_back(window);
+        if (hasSubSurfaces(window)) {
+            m_unbounded.push_back(rank);
+            bounds.push_back(RectF());
+        } else {
+            bounds.push_back(inputBounds(window));
+        }
+    }
+
+    RectF gridRect;
+    for (const RectF &rect : bounds) {
+        if (!rect.isEmpty()) {
+            gridRect = gridRect.isEmpty() ? rect : (gridRect | rect);
+        }
+    }
+    m_gridRect = gridRect;
+    if (m_gridRect.isEmpty()) {
+        m_columns = m_rows = 0;
+        return;
+    }
+
+    m_cellSize = std::max({s_minimumCellSize, m_gridRect.width() / s_maximumCellsPerSide, m_gridRect.height() / s_maximumCellsPerSide});
+    m_columns = std::max(1, int(std::ceil(m_gridRect.width() / m_cellSize)));
+    m_rows = std::max(1, int(std::ceil(m_gridRect.height() / m_cellSize)));
+    m_cells.resize(m_columns * m_rows);
+
+    // windows are visited top to bottom, so every cell ends up sorted by stacking order
+    for (uint32_t rank = 0; rank < m_windows.size(); ++rank) {
+        const RectF &rect = bounds[rank];
+        if (rect.isEmpty()) {
+            continue;
+        }
+        const int left = std::clamp(int((rect.left() - m_gridRect.left()) / m_cellSize), 0, m_columns - 1);
+        const int right = std::clamp(int((rect.right() - m_gridRect.left()) / m_cellSize), 0, m_columns - 1);
+        const int top = std::clamp(int((rect.top() - m_gridRect.top()) / m_cellSize), 0, m_rows - 1);
+        const int bottom = std::clamp(int((rect.bottom() - m_gridRect.top()) / m_cellSize), 0, m_rows - 1);
+        for (int row = top; row <= bottom; ++row) {
+            for (int column = left; column <= right; ++column) {
+                m_cells[row * m_columns + column].push_back(rank);
+            }
+        }
+    }
+}
+
+const std::vector<Window *> &WindowHitTestIndex::candidatesAt(const QPointF &pos)
+{
+    if (m_dirty) {
+        rebuild();
+    }
+    m_candidates.clear();
+
+    static const std::vector<uint32_t> s_noCell;
+    const std::vector<uint32_t> *cell = &s_noCell;
+    if (m_columns > 0 && m_gridRect.contains(pos)) {
+        const int column = std::clamp(int((pos.x() - m_gridRect.left()) / m_cellSize), 0, m_columns - 1);
+        const int row = std::clamp(int((pos.y() - m_gridRect.top()) / m_cellSize), 0, m_rows - 1);
+        cell = &m_cells[row * m_columns + column];
+    }
+
+    // merge the windows in the cell with the ones that can be anywhere, keeping the stacking order
+    auto cellIt = cell->begin();
+    auto unboundedIt = m_unbounded.begin();
+    while (cellIt != cell->end() || unboundedIt != m_unbounded.end()) {
+        if (unboundedIt == m_unbounded.end() || (cellIt != cell->end() && *cellIt < *unboundedIt)) {
+            m_candidates.push_back(m_windows[*cellIt++]);
+        } else {
+            m_candidates.push_back(m_windows[*unboundedIt++]);
+        }
+    }
+    return m_candidates;
+}
+
+} // namespace KWin
@@ -0,0 +1,70 @@
+/*
+    KWin - the KDE window manager
+    This file is part of the KDE project.
+
+    SPDX-FileCopyrightText: 2026 KWin contributors
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+#pragma once
+
+#include "core/rect.h"
+#include "kwin_export.h"
+
+#include <QObject>
+
+#include <unordered_set>
+#include <vector>
+
+namespace KWin
+{
+
+class Window;
+class Workspace;
+
+/**
+ * The WindowHitTestIndex class speeds up looking for the window at a given position.
+ *
+ * It keeps the windows that can currently receive input, i.e. that are on the current virtual
+ * desktop and activity and are neither minimized nor hidden, sorted top to bottom, and sorts
+ * them into a uniform grid of cells by the area in which they may accept input. Windows with
+ * subsurfaces may accept input outside of their geometry, they are candidates everywhere.
+ *
+ * The index is rebuilt lazily after the stacking order, the geometry or the visibility of a
+ * window changed.
+ */
+class KWIN_EXPORT WindowHitTestIndex : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit WindowHitTestIndex(Workspace *workspace);
+
+    /**
+     * Returns the windows that may accept input at @a pos, topmost first. Whether they
+     * actually do has to be checked with Window::hitTest().
+     *
+     * The returned list is only valid until the next call.
+     */
+    const std::vector<Window *> &candidatesAt(const QPointF &pos);
+
+    void invalidate();
+
+private:
+    void rebuild();
+    void watch(Window *window);
+
+    Workspace *const m_workspace;
+    std::unordered_set<Window *> m_watched;
+    std::vector<Window *> m_windows;
+    std::vector<uint32_t> m_unbounded;
+    std::vector<std::vector<uint32_t>> m_cells;
+    std::vector<Window *> m_candidates;
+    RectF m_gridRect;
+    qreal m_cellSize = 0;
+    int m_columns = 0;
+    int m_rows = 0;
+    bool m_dirty = true;
+};
+
+} // namespace KWin
@@ -83,6 +83,9 @@
 #include <QDBusConnection>
 #include <QDBusPendingCall>
 #include <QMetaProperty>
+#include <QVarLengthArray>
+#include <algorithm>
+#include <bit>
 #include <ranges>
 
 namespace KWin
@@ -162,7 +165,11 @@ Workspace::Workspace()
 
     m_decorationBridge = std::make_unique<Decoration::DecorationBridge>();
     m_decorationBridge->init();
-    connect(this, &Workspace::configChanged, m_decorationBridge.get(), &Decoration::DecorationBridge::reconfigure);
+    connect(this, &Workspace::configChanged, m_decorationBridge.get(), [this]() {
+        if (isConfigGroupChanged(QStringLiteral("org.kde.kdecoration2"))) {
+            m_decorationBridge->reconfigure();
+        }
+    });
 
     new DBusInterface(this);
     m_outline = std::make_unique<Outline>();
@@ -183,6 +190,8 @@ Workspace::Workspace()
     initShortcuts();
 
     init();
+
+    m_configSnapshot = ConfigSnapshot(kwinApp()->config().data());
 }
 
 static const double s_autoBrightnessDeadzone = environmentVariableIntValue("KWIN_AUTO_BRIGHTNESS_DEADZONE").transform([](int percent) {
@@ -194,11 +203,29 @@ void Workspace::init()
     KSharedConfigPtr config = kwinApp()->config();
     m_screenEdges->setConfig(config);
     m_screenEdges->init();
-    connect(options, &Options::configChanged, m_screenEdges.get(), &ScreenEdges::reconfigure);
+    connect(options, &Options::configChanged, m_screenEdges.get(), [this]() {
+        static const QStringList groups{
+            QStringLiteral("ScreenEdges"),
+            QStringLiteral("Windows"),
+            QStringLiteral("ElectricBorders"),
+            QStringLiteral("TouchEdges"),
+        };
+        if (std::ranges::any_of(groups, [this](const QString &group) {
+                return isConfigGroupChanged(group);
+            })) {
+            m_screenEdges->reconfigure();
+        }
+    });
     connect(VirtualDesktopManager::self(), &VirtualDesktopManager::layoutChanged, m_screenEdges.get(), &ScreenEdges::updateLayout);
     connect(this, &Workspace::windowActivated, m_screenEdges.get(), &ScreenEdges::checkBlocking);
 
     connect(this, &Workspace::windowRemoved, m_focusChain.get(), &FocusChain::remove);
+    connect(this, &Workspace::windowAdded, this, [this]() {
+        m_snapIndex.valid = false;
+    });
+    connect(this, &Workspace::windowRemoved, this, [this]() {
+        m_snapIndex.valid = false;
+    });
     connect(this, &Workspace::windowActivated, m_focusChain.get(), &FocusChain::setActiveWindow);
     connect(options, &Options::separateScreenFocusChanged, m_focusChain.get(), &FocusChain::setSeparateScreenFocus);
     m_focusChain->setSeparateScreenFocus(options->isSeparateScreenFocus());
@@ -456,6 +483,8 @@ void Workspace::cleanupX11()
     }
 
     manual_overlays.clear();
+    m_x11WindowStack.clear();
+    m_x11ClientListStacking.clear();
 
     VirtualDesktopManager *desktopManager = VirtualDesktopManager::self();
     desktopManager->setRootInfo(nullptr);
@@ -1009,16 +1038,24 @@ void Workspace::slotReconfigure()
     bool borderlessMaximizedWindows = options->borderlessMaximizedWindows();
 
     kwinApp()->config()->reparseConfiguration();
+
+    ConfigSnapshot snapshot(kwinApp()->config().data());
+    m_changedConfigGroups = m_configSnapshot.changedGroups(snapshot);
+    m_configSnapshot = std::move(snapshot);
+    qCDebug(KWIN_CORE) << "Changed config groups:" << m_changedConfigGroups;
+
     options->updateSettings();
 
     Q_EMIT configChanged();
     m_userActionsMenu->discard();
+    m_changedConfigGroups.clear();
 
-    m_rulebook->load();
-    for (Window *window : std::as_const(m_windows)) {
-        if (window->supportsWindowRules()) {
-            window->evaluateWindowRules();
-            m_rulebook->discardUsed(window, false);
+    if (m_rulebook->reload()) {
+        for (Window *window : std::as_const(m_windows)) {
+            if (window->supportsWindowRules()) {
+                window->evaluateWindowRules();
+                m_rulebook->discardUsed(window, false);
+            }
         }
     }
 
@@ -1035,7 +1072,14 @@ void Workspace::slotReconfigure()
 
 void Workspace::slotCurrentDesktopChanged(VirtualDesktop *oldDesktop, VirtualDesktop *newDesktop, LogicalOutput *output)
 {
+#if KWIN_BUILD_ACTIVITIES
+    // updateCurrentActivity() takes care of the windows on all outputs
+    if (!m_activities || !m_activities->isSwitching()) {
+        updateWindowVisibilityAndActivateOnDesktopChange(newDesktop, output);
+    }
+#else
     updateWindowVisibilityAndActivateOnDesktopChange(newDesktop, output);
+#endif
     Q_EMIT currentDesktopChanged(oldDesktop, newDesktop, output, m_moveResizeWindow);
 }
 
@@ -1089,29 +1133,32 @@ void Workspace::updateWindowVisibilityOnDesktopChange(VirtualDesktop *newDesktop
 void Workspace::updateWindowVisibilityAndActivateOnDesktopChange(VirtualDesktop *newDesktop, LogicalOutput *output)
 {
     closeActivePopup();
-    ++block_focus;
     StackingUpdatesBlocker blocker(this);
+    updateWindowsOnDesktopChange(newDesktop, output);
+
+    if (output == m_activeOutput) {
+        activateWindowOnDesktop(newDesktop);
+    }
+}
+
+void Workspace::updateWindowsOnDesktopChange(VirtualDesktop *newDesktop, LogicalOutput *output)
+{
+    ++block_focus;
     updateWindowVisibilityOnDesktopChange(newDesktop, output);
     // Restore the focus on this desktop
     --block_focus;
 
+    QHash<Window *, Tile *> windowTiles;
+    for (const auto &[tileOutput, manager] : m_tileManagers) {
+        windowTiles.insert(manager->windowTiles(newDesktop));
+    }
+
+    GeometryUpdatesBatcher batcher(this);
     for (Window *window : std::as_const(m_windows)) {
         if (!window->isOnDesktop(newDesktop) || !window->isOnOutput(output)) {
             continue;
         }
-
-        Tile *tile = nullptr;
-        for (const auto &[tileOutput, manager] : m_tileManagers) {
-            if (Tile *candidate = manager->tileForWindow(window, newDesktop)) {
-                tile = candidate;
-            }
-        }
-
-        window->requestTile(tile);
-    }
-
-    if (output == m_activeOutput) {
-        activateWindowOnDesktop(newDesktop);
+        window->requestTile(windowTiles.value(window));
     }
 }
 
@@ -1185,8 +1232,17 @@ void Workspace::updateCurrentActivity(const QString &new_activity)
         return;
     }
 
-    for (LogicalOutput *output : std::as_const(m_outputs)) {
-        updateWindowVisibilityAndActivateOnDesktopChange(VirtualDesktopManager::self()->currentDesktop(output), output);
+    // update the windows of all outputs behind a single stacking update, and only look for
+    // a window to activate once, rather than once per output
+    closeActivePopup();
+    {
+        StackingUpdatesBlocker blocker(this);
+        for (LogicalOutput *output : std::as_const(m_outputs)) {
+            updateWindowsOnDesktopChange(VirtualDesktopManager::self()->currentDesktop(output), output);
+        }
+    }
+    if (m_activeOutput) {
+        activateWindowOnDesktop(VirtualDesktopManager::self()->currentDesktop(m_activeOutput));
     }
 
     Q_EMIT currentActivityChanged();
@@ -2395,6 +2451,38 @@ RectF Workspace::adjustClientArea(Window *window, const RectF &area) const
     return adjustedArea;
 }
 
+static std::array<StrutRects, 4> splitStrutRects(const StrutRects &rects)
+{
+    std::array<StrutRects, 4> sides;
+    for (const StrutRect &rect : rects) {
+        for (size_t side = 0; side < sides.size(); ++side) {
+            if (rect.area() & (1 << side)) {
+                sides[side].append(rect);
+            }
+        }
+    }
+    return sides;
+}
+
+static StrutRects filterStrutRects(const StrutRects &rects, const std::array<StrutRects, 4> &sides, StrutAreas areas)
+{
+    if (areas == StrutAreaAll) {
+        return rects;
+    }
+    if (const uint flags = areas.toInt(); std::has_single_bit(flags)) {
+        return sides[std::countr_zero(flags)];
+    }
+
+    StrutRects ret;
+    ret.reserve(rects.size());
+    for (const StrutRect &rect : rects) {
+        if (rect.area() & areas) {
+            ret.append(rect);
+        }
+    }
+    return ret;
+}
+
 void Workspace::scheduleRearrange()
 {
     m_rearrangeTimer.start(0);
@@ -2463,7 +2551,10 @@ void Workspace::rearrange(const QHash<Window *, LogicalOutput *> &oldOutputs)
 
         m_inRearrange = true;
         m_oldRestrictedArea = m_restrictedArea;
+        m_oldRestrictedAreaBySide = m_restrictedAreaBySide;
         m_restrictedArea = restrictedArea;
+        m_restrictedAreaBySide = splitStrutRects(restrictedArea);
+        m_clientAreaSerial++;
 
 #if KWIN_BUILD_X11
         if (rootInfo()) {
@@ -2481,6 +2572,7 @@ void Workspace::rearrange(const QHash<Window *, LogicalOutput *> &oldOutputs)
         }
 
         m_oldRestrictedArea.clear(); // reset, no longer valid or needed
+        m_oldRestrictedAreaBySide = StrutRectsBySide{};
         m_inRearrange = false;
     }
 }
@@ -2535,18 +2627,7 @@ Rect Workspace::geometry() const
 
 StrutRects Workspace::restrictedMoveArea(StrutAreas areas) const
 {
-    if (areas == StrutAreaAll) {
-        return m_restrictedArea;
-    }
-
-    StrutRects ret;
-    ret.reserve(m_restrictedArea.size());
-    for (const StrutRect &rect : m_restrictedArea) {
-        if (rect.area() & areas) {
-            ret.append(rect);
-        }
-    }
-    return ret;
+    return filterStrutRects(m_restrictedArea, m_restrictedAreaBySide, areas);
 }
 
 bool Workspace::inRearrange() const
@@ -2556,18 +2637,12 @@ bool Workspace::inRearrange() const
 
 StrutRects Workspace::previousRestrictedMoveArea(StrutAreas areas) const
 {
-    if (areas == StrutAreaAll) {
-        return m_oldRestrictedArea;
-    }
+    return filterStrutRects(m_oldRestrictedArea, m_oldRestrictedAreaBySide, areas);
+}
 
-    StrutRects ret;
-    ret.reserve(m_oldRestrictedArea.size());
-    for (const StrutRect &rect : m_oldRestrictedArea) {
-        if (rect.area() & areas) {
-            ret.append(rect);
-        }
-    }
-    return ret;
+quint64 Workspace::clientAreaSerial() const
+{
+    return m_clientAreaSerial;
 }
 
 QHash<const LogicalOutput *, Rect> Workspace::previousScreenSizes() const
@@ -2659,6 +2734,48 @@ static bool canSnap(const Window *window, const Window *other)
     return !(other->isUnmanaged() || other->isDesktop() || other->isSplash() || other->isNotification() || other->isCriticalNotification() || other->isOnScreenDisplay() || other->isAppletPopup() || other->isDock());
 }
 
+void Workspace::updateSnapIndex(const Window *window) const
+{
+    if (m_snapIndex.valid && m_snapIndex.window == window) {
+        return;
+    }
+
+    m_snapIndex.window = window;
+    m_snapIndex.windows.clear();
+    m_snapIndex.horizontalEdges.clear();
+    m_snapIndex.verticalEdges.clear();
+    // dropping the old context disconnects from the windows of the previous index
+    m_snapIndex.context = std::make_unique<QObject>();
+
+    for (Window *other : m_windows) {
+        if (other == window) {
+            continue;
+        }
+        const qsizetype index = m_snapIndex.windows.size();
+        const RectF geometry = other->frameGeometry();
+        m_snapIndex.windows.append(other);
+        m_snapIndex.horizontalEdges.push_back({geometry.left(), index});
+        m_snapIndex.horizontalEdges.push_back({geometry.right(), index});
+        m_snapIndex.verticalEdges.push_back({geometry.top(), index});
+        m_snapIndex.verticalEdges.push_back({geometry.bottom(), index});
+        connect(other, &Window::frameGeometryChanged, m_snapIndex.context.get(), [this]() {
+            m_snapIndex.valid = false;
+        });
+    }
+
+    const auto byPosition = [](const SnapIndex::Edge &a, const SnapIndex::Edge &b) {
+        return a.position < b.position;
+    };
+    std::sort(m_snapIndex.horizontalEdges.begin(), m_snapIndex.horizontalEdges.end(), byPosition);
+    std::sort(m_snapIndex.verticalEdges.begin(), m_snapIndex.verticalEdges.end(), byPosition);
+    m_snapIndex.valid = true;
+}
+
+void Workspace::resetSnapIndex()
+{
+    m_snapIndex = SnapIndex{};
+}
+
 /**
  * \a window is moved around to position \a pos. This gives the
  * workspace the opportunity to interveniate and to implement
@@ -2736,15 +2853,38 @@ QPointF Workspace::adjustWindowPosition(const Window *window, QPointF pos, bool
         // windows snap
         const qreal windowSnapZone = options->windowSnapZone() * snapAdjust;
         if (windowSnapZone > 0) {
-            for (auto l = m_windows.constBegin(); l != m_windows.constEnd(); ++l) {
-                if (!canSnap(window, (*l))) {
+            updateSnapIndex(window);
+
+            // A window can only affect the snapped position if one of its edges is closer to
+            // the moved window than the snap zones, so only those windows need to be checked.
+            // They are checked in the same order as all windows would be, since a snap to
+            // one window can make a later window snap to the corner of it.
+            const qreal rangeX = std::max(windowSnapZone, borderXSnapZone);
+            const qreal rangeY = std::max(windowSnapZone, borderYSnapZone);
+            QVarLengthArray<qsizetype, 32> candidates;
+            const auto collect = [&candidates](const std::vector<SnapIndex::Edge> &edges, qreal from, qreal to) {
+                auto it = std::lower_bound(edges.begin(), edges.end(), from, [](const SnapIndex::Edge &edge, qreal position) {
+                    return edge.position < position;
+                });
+                for (; it != edges.end() && it->position <= to; ++it) {
+                    candidates.append(it->window);
+                }
+            };
+            collect(m_snapIndex.horizontalEdges, cx - rangeX, rx + rangeX);
+            collect(m_snapIndex.verticalEdges, cy - rangeY, ry + rangeY);
+            std::sort(candidates.begin(), candidates.end());
+            candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+            for (const qsizetype candidate : std::as_const(candidates)) {
+                const Window *l = m_snapIndex.windows[candidate];
+                if (!canSnap(window, l)) {
                     continue;
                 }
 
-                lx = (*l)->x();
-                ly = (*l)->y();
-                lrx = lx + (*l)->width();
-                lry = ly + (*l)->height();
+                lx = l->x();
+                ly = l->y();
+                lrx = lx + l->width();
+                lry = ly + l->height();
 
                 if (!(guideMaximized & MaximizeHorizontal) && (cy <= lry) && (ly <= ry)) {
                     if ((sOWO ? (cx < lrx) : true) && (std::abs(lrx - cx) < windowSnapZone) && (std::abs(lrx - cx) < deltaX)) {
@@ -3065,6 +3205,41 @@ void Workspace::setMoveResizeWindow(Window *window)
         ++block_focus;
     } else {
         --block_focus;
+        resetSnapIndex();
+    }
+}
+
+void Workspace::batchGeometryUpdates(bool batch)
+{
+    if (batch) {
+        ++m_batchGeometryUpdates;
+        return;
+    }
+    Q_ASSERT(m_batchGeometryUpdates > 0);
+    if (--m_batchGeometryUpdates > 0) {
+        return;
+    }
+    const auto geometries = std::exchange(m_batchedGeometries, {});
+    for (const auto &[window, geometry] : geometries) {
+        if (window && !window->isDeleted()) {
+            window->moveResize(geometry);
+        }
+    }
+}
+
+void Workspace::moveResizeBatched(Window *window, const RectF &geometry)
+{
+    if (!m_batchGeometryUpdates) {
+        window->moveResize(geometry);
+        return;
+    }
+    const auto it = std::ranges::find_if(m_batchedGeometries, [window](const auto &entry) {
+        return entry.first == window;
+    });
+    if (it != m_batchedGeometries.end()) {
+        it->second = geometry;
+    } else {
+        m_batchedGeometries.emplace_back(window, geometry);
     }
 }
 
@@ -3112,6 +3287,11 @@ Placement *Workspace::placement() const
     return m_placement.get();
 }
 
+bool Workspace::isConfigGroupChanged(const QString &group) const
+{
+    return m_changedConfigGroups.contains(group);
+}
+
 RuleBook *Workspace::rulebook() const
 {
     return m_rulebook.get();
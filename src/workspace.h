@@ -17,17 +17,21 @@
 #include "options.h"
 #include "sm.h"
 #include "utils/common.h"
+#include "utils/configsnapshot.h"
 #include "utils/filedescriptor.h"
 #include "utils/serial.h"
 // KF
 #include <netwm_def.h>
 // Qt
 #include <QList>
+#include <QPointer>
 #include <QStringList>
 #include <QTimer>
 // std
+#include <array>
 #include <functional>
 #include <memory>
+#include <vector>
 
 class KConfig;
 class KConfigGroup;
@@ -203,6 +207,17 @@ public:
     void constrain(Window *below, Window *above);
     void unconstrain(Window *below, Window *above);
 
+    /**
+     * While geometry updates are batched, moveResizeBatched() only remembers the last
+     * geometry of every window. The windows are moved and resized once the batch ends,
+     * so that every window gets a single configure, even if a layout change touches it
+     * several times.
+     *
+     * @see GeometryUpdatesBatcher
+     */
+    void batchGeometryUpdates(bool batch);
+    void moveResizeBatched(Window *window, const RectF &geometry);
+
     void windowAttentionChanged(Window *, bool set);
 
     /**
@@ -245,6 +260,12 @@ public:
      */
     bool inRearrange() const;
 
+    /**
+     * Returns a number that changes every time the client areas or the restricted move
+     * areas change, so that results derived from them can be cached and checked cheaply.
+     */
+    quint64 clientAreaSerial() const;
+
     /**
      * Re-arranges the workspace, it includes computing restricted areas, moving windows out of the
      * restricted areas, and so on.
@@ -414,6 +435,13 @@ public:
     void addInternalWindow(InternalWindow *window);
     void removeInternalWindow(InternalWindow *window);
 
+    /**
+     * Returns @c true if the entries of the given group of the kwinrc config changed in the
+     * reconfigure that is in progress. The slots connected to configChanged() use it to avoid
+     * re-initialising subsystems none of whose settings changed.
+     */
+    bool isConfigGroupChanged(const QString &group) const;
+
     FocusChain *focusChain() const;
     ApplicationMenu *applicationMenu() const;
     Decoration::DecorationBridge *decorationBridge() const;
@@ -621,6 +649,7 @@ private:
     void closeActivePopup();
     void updateWindowVisibilityOnDesktopChange(VirtualDesktop *newDesktop, LogicalOutput *output);
     void updateWindowVisibilityAndActivateOnDesktopChange(VirtualDesktop *newDesktop, LogicalOutput *output);
+    void updateWindowsOnDesktopChange(VirtualDesktop *newDesktop, LogicalOutput *output);
     void activateWindowOnDesktop(VirtualDesktop *desktop);
     Window *findWindowToActivateOnDesktop(VirtualDesktop *desktop);
     void removeWindow(Window *window);
@@ -664,6 +693,32 @@ private:
     QList<Window *> m_windows;
     QList<Window *> deleted;
 
+    /**
+     * The left and right, and the top and bottom edges of the windows that a window being
+     * moved may snap to, sorted by their position. adjustWindowPosition() looks up the
+     * windows with an edge close to the moved window in them instead of going through all
+     * windows on every motion. The index is rebuilt after one of the windows has changed
+     * its geometry, or windows have been added or removed.
+     */
+    struct SnapIndex
+    {
+        struct Edge
+        {
+            qreal position;
+            qsizetype window;
+        };
+
+        const Window *window = nullptr;
+        QList<Window *> windows;
+        std::vector<Edge> horizontalEdges;
+        std::vector<Edge> verticalEdges;
+        std::unique_ptr<QObject> context;
+        bool valid = false;
+    };
+    void updateSnapIndex(const Window *window) const;
+    void resetSnapIndex();
+    mutable SnapIndex m_snapIndex;
+
     QList<Window *> unconstrained_stacking_order; // Topmost last
     QList<Window *> stacking_order; // Topmost last
     QList<Window *> attention_chain;
@@ -676,6 +731,8 @@ private:
     bool was_user_interaction;
 #if KWIN_BUILD_X11
     QList<xcb_window_t> manual_overlays; // Topmost last
+    QList<xcb_window_t> m_x11WindowStack; // Last stacking order applied to the X server, topmost first
+    QList<xcb_window_t> m_x11ClientListStacking;
     std::unique_ptr<Xcb::Window> m_nullFocus;
     std::unique_ptr<Xcb::Window> m_guardWindow;
     std::unique_ptr<X11EventFilter> m_syncAlarmFilter;
@@ -698,6 +755,8 @@ private:
 
     // Timer to collect requests for 'reconfigure'
     QTimer reconfigureTimer;
+    ConfigSnapshot m_configSnapshot;
+    QSet<QString> m_changedConfigGroups;
 
     static Workspace *_self;
 #if KWIN_BUILD_X11
@@ -707,6 +766,12 @@ private:
     StrutRects m_restrictedArea;
     QHash<const LogicalOutput *, RectF> m_screenAreas;
     Rect m_geometry;
+    quint64 m_clientAreaSerial = 0;
+
+    // the restricted areas split up by side, most callers only ask for the struts along one side
+    using StrutRectsBySide = std::array<StrutRects, 4>;
+    StrutRectsBySide m_restrictedAreaBySide;
+    StrutRectsBySide m_oldRestrictedAreaBySide;
 
     QHash<const LogicalOutput *, Rect> m_oldScreenGeometries;
     StrutRects m_oldRestrictedArea;
@@ -715,6 +780,8 @@ private:
 
     int m_setActiveWindowRecursion = 0;
     int m_blockStackingUpdates = 0; // When > 0, stacking updates are temporarily disabled
+    int m_batchGeometryUpdates = 0;
+    std::vector<std::pair<QPointer<Window>, RectF>> m_batchedGeometries;
     bool m_blockedPropagatingNewWindows; // Propagate also new windows after enabling stacking updates?
     friend class StackingUpdatesBlocker;
 
@@ -781,6 +848,26 @@ private:
     Workspace *ws;
 };
 
+/**
+ * Helper for Workspace::batchGeometryUpdates() being called in pairs (true/false)
+ */
+class GeometryUpdatesBatcher
+{
+public:
+    explicit GeometryUpdatesBatcher(Workspace *w)
+        : ws(w)
+    {
+        ws->batchGeometryUpdates(true);
+    }
+    ~GeometryUpdatesBatcher()
+    {
+        ws->batchGeometryUpdates(false);
+    }
+
+private:
+    Workspace *ws;
+};
+
 //---------------------------------------------------------
 // Unsorted
 
@@ -836,6 +923,9 @@ inline bool Workspace::globalShortcutsDisabled() const
 inline void Workspace::forceRestacking()
 {
     force_restacking = true;
+#if KWIN_BUILD_X11
+    m_x11WindowStack.clear();
+#endif
     StackingUpdatesBlocker blocker(this); // Do restacking if not blocked
 }
 
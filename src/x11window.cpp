@@ -372,6 +372,7 @@ bool X11Window::manage(xcb_window_t w, bool isMapped)
     auto applicationMenuServiceNameCookie = fetchApplicationMenuServiceName();
     auto applicationMenuObjectPathCookie = fetchApplicationMenuObjectPath();
     auto pidCookie = fetchPid();
+    auto syncCounterCookie = fetchSyncCounter();
 
     m_geometryHints.init(window());
     m_motif.init(window());
@@ -389,7 +390,7 @@ bool X11Window::manage(xcb_window_t w, bool isMapped)
     getResourceClass();
     readWmClientLeader(wmClientLeaderCookie);
     getWmClientMachine();
-    getSyncCounter();
+    readSyncCounter(syncCounterCookie);
     setCaption(readName());
 
     setupWindowRules();
@@ -1866,19 +1867,37 @@ void X11Window::getIcons()
     setIcon(icon);
 }
 
-void X11Window::getSyncCounter()
+static bool isSyncRequestAvailable()
 {
     if (!Xcb::Extensions::self()->isSyncAvailable()) {
-        return;
+        return false;
     }
 
     static bool noXsync = qEnvironmentVariableIntValue("KWIN_X11_NO_SYNC_REQUEST") == 1;
-    if (noXsync) {
+    return !noXsync;
+}
+
+Xcb::Property X11Window::fetchSyncCounter() const
+{
+    if (!isSyncRequestAvailable()) {
+        return Xcb::Property();
+    }
+    return Xcb::Property(false, window(), atoms->net_wm_sync_request_counter, XCB_ATOM_CARDINAL, 0, 1);
+}
+
+void X11Window::getSyncCounter()
+{
+    Xcb::Property property = fetchSyncCounter();
+    readSyncCounter(property);
+}
+
+void X11Window::readSyncCounter(Xcb::Property &property)
+{
+    if (!isSyncRequestAvailable()) {
         return;
     }
 
-    Xcb::Property syncProp(false, window(), atoms->net_wm_sync_request_counter, XCB_ATOM_CARDINAL, 0, 1);
-    const xcb_sync_counter_t counter = syncProp.value<xcb_sync_counter_t>().value_or(XCB_NONE);
+    const xcb_sync_counter_t counter = property.value<xcb_sync_counter_t>().value_or(XCB_NONE);
     if (counter != XCB_NONE) {
         m_syncRequest.enabled = true;
         m_syncRequest.counter = counter;
@@ -3885,7 +3904,8 @@ void X11Window::updateShapeRegion()
 {
     const RectF bufferRect(0, 0, m_bufferGeometry.width(), m_bufferGeometry.height());
     const auto previousRegion = m_shapeRegion;
-    if (Xcb::Extensions::self()->hasShape(window())) {
+    // is_shape is kept up to date by detectShape() when the shape changes
+    if (is_shape) {
         auto cookie = xcb_shape_get_rectangles_unchecked(kwinApp()->x11Connection(), window(), XCB_SHAPE_SK_BOUNDING);
         UniqueCPtr<xcb_shape_get_rectangles_reply_t> reply(xcb_shape_get_rectangles_reply(kwinApp()->x11Connection(), cookie, nullptr));
         if (reply) {
@@ -307,6 +307,8 @@ private:
     void detectShape();
 
     void configureRequest(int value_mask, qreal rx, qreal ry, qreal rw, qreal rh, int gravity, bool from_tool);
+    Xcb::Property fetchSyncCounter() const;
+    void readSyncCounter(Xcb::Property &property);
     void getSyncCounter();
     void sendSyncRequest();
 
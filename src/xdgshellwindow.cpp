@@ -24,6 +24,7 @@
 #include "utils/subsurfacemonitor.h"
 #include "virtualdesktops.h"
 #include "wayland/appmenu.h"
+#include "wayland/clientconnection.h"
 #include "wayland/output.h"
 #include "wayland/plasmashell.h"
 #include "wayland/seat.h"
@@ -111,8 +112,26 @@ void XdgSurfaceWindow::scheduleConfigure()
     }
 }
 
+bool XdgSurfaceWindow::isInteractiveResizeConfigurePending() const
+{
+    return std::ranges::any_of(m_configureEvents, [](const XdgSurfaceConfigure *configureEvent) {
+        return configureEvent->flags & XdgSurfaceConfigure::ConfigureInteractiveResize;
+    });
+}
+
 void XdgSurfaceWindow::sendConfigure()
 {
+    // During interactive resize, the pointer usually moves faster than the client can repaint.
+    // Only one resize is sent at a time, the next one is sent with the latest size as soon as
+    // the client has committed a buffer for the previous one, so the configure events follow
+    // the commit rate of the client and the intermediate sizes are dropped.
+    if (isInteractiveResize() && isInteractiveResizeConfigurePending()) {
+        m_configureThrottled = true;
+        return;
+    }
+    m_configureThrottled = false;
+
+    const bool resize = isInteractiveResize() && (m_configureFlags & XdgSurfaceConfigure::ConfigurePosition);
     XdgSurfaceConfigure *configureEvent = sendRoleConfigure();
 
     // The configure event inherits configure flags from the previous event.
@@ -124,6 +143,8 @@ void XdgSurfaceWindow::sendConfigure()
     configureEvent->gravity = m_nextGravity;
     configureEvent->flags |= m_configureFlags;
     configureEvent->scale = m_nextTargetScale;
+    configureEvent->flags.setFlag(XdgSurfaceConfigure::ConfigureInteractiveResize, resize);
+    configureEvent->sent = std::chrono::steady_clock::now();
     m_configureFlags = {};
     if (!isInteractiveMoveResize()) {
         m_nextGravity = Gravity::None;
@@ -155,6 +176,12 @@ void XdgSurfaceWindow::handleCommit()
             }
             m_lastAcknowledgedConfigure.reset(m_configureEvents.takeFirst());
         }
+        if (m_lastAcknowledgedConfigure && m_lastAcknowledgedConfigure->flags & XdgSurfaceConfigure::ConfigureInteractiveResize) {
+            surface()->client()->commitLatency().addResizeLatency(std::chrono::steady_clock::now() - m_lastAcknowledgedConfigure->sent);
+        }
+        if (m_configureThrottled && !isInteractiveResizeConfigurePending()) {
+            scheduleConfigure();
+        }
     }
 
     handleRolePrecommit();
@@ -181,7 +208,7 @@ void XdgSurfaceWindow::handleRoleCommit()
 void XdgSurfaceWindow::maybeUpdateMoveResizeGeometry(const RectF &rect)
 {
     // We are about to send a configure event, ignore the committed window geometry.
-    if (m_configureTimer->isActive()) {
+    if (m_configureTimer->isActive() || m_configureThrottled) {
         return;
     }
 
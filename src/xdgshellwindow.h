@@ -17,6 +17,7 @@
 #include <QQueue>
 #include <QTimer>
 
+#include <chrono>
 #include <optional>
 
 namespace KDecoration3
@@ -48,6 +49,7 @@ public:
 
     enum ConfigureFlag {
         ConfigurePosition = 0x1,
+        ConfigureInteractiveResize = 0x2,
     };
     Q_DECLARE_FLAGS(ConfigureFlags, ConfigureFlag)
 
@@ -56,6 +58,7 @@ public:
     qreal serial;
     ConfigureFlags flags;
     double scale;
+    std::chrono::steady_clock::time_point sent;
 };
 
 class XdgSurfaceWindow : public WaylandWindow
@@ -97,6 +100,7 @@ private:
     void setHaveNextWindowGeometry();
     void resetHaveNextWindowGeometry();
     void maybeUpdateMoveResizeGeometry(const RectF &rect);
+    bool isInteractiveResizeConfigurePending() const;
 
     XdgSurfaceInterface *m_shellSurface;
     QTimer *m_configureTimer;
@@ -106,6 +110,7 @@ private:
     std::optional<quint32> m_lastAcknowledgedConfigureSerial;
     RectF m_windowGeometry;
     bool m_haveNextWindowGeometry = false;
+    bool m_configureThrottled = false;
 };
 
 class XdgToplevelConfigure final : public XdgSurfaceConfigure
@@ -665,6 +665,7 @@ void Xkb::updateKeymap(xkb_keymap *keymap)
 
     m_keymap = keymap;
     m_state = state;
+    m_keycodesFromKeysyms.clear();
 
     m_shiftModifier = xkb_keymap_mod_get_index(m_keymap, XKB_MOD_NAME_SHIFT);
     m_capsModifier = xkb_keymap_mod_get_index(m_keymap, XKB_MOD_NAME_CAPS);
@@ -1244,7 +1245,23 @@ std::optional<Xkb::KeyCode> Xkb::keycodeFromKeysym(xkb_keysym_t keysym)
     if (!m_keymap || !m_state) {
         return {};
     }
-    auto layout = xkb_state_serialize_layout(m_state, XKB_STATE_LAYOUT_EFFECTIVE);
+    const xkb_layout_index_t layout = xkb_state_serialize_layout(m_state, XKB_STATE_LAYOUT_EFFECTIVE);
+    auto it = m_keycodesFromKeysyms.find(layout);
+    if (it == m_keycodesFromKeysyms.end()) {
+        it = m_keycodesFromKeysyms.insert(layout, buildKeycodesFromKeysyms(layout));
+    }
+    const auto keyCode = it->constFind(keysym);
+    if (keyCode == it->constEnd()) {
+        return {};
+    }
+    return *keyCode;
+}
+
+QHash<xkb_keysym_t, Xkb::KeyCode> Xkb::buildKeycodesFromKeysyms(xkb_layout_index_t layout) const
+{
+    // virtual keyboards and remote input type by looking up the keycode of every character,
+    // so do a single pass over the keymap instead of searching it for every keysym
+    QHash<xkb_keysym_t, KeyCode> keyCodes;
     const xkb_keycode_t max = xkb_keymap_max_keycode(m_keymap);
     for (xkb_keycode_t keycode = xkb_keymap_min_keycode(m_keymap); keycode < max; keycode++) {
         uint levelCount = xkb_keymap_num_levels_for_key(m_keymap, keycode, layout);
@@ -1252,21 +1269,23 @@ std::optional<Xkb::KeyCode> Xkb::keycodeFromKeysym(xkb_keysym_t keysym)
             const xkb_keysym_t *syms;
             uint num_syms = xkb_keymap_key_get_syms_by_level(m_keymap, keycode, layout, currentLevel, &syms);
             for (uint sym = 0; sym < num_syms; sym++) {
-                if (syms[sym] == keysym) {
-                    xkb_mod_mask_t masks[1]; // this function returns every way to shift to this level, we just need 1
-                    int nMasks = xkb_keymap_key_get_mods_for_level(
-                        m_keymap, keycode, layout, currentLevel,
-                        masks, 1);
-                    xkb_mod_mask_t modifiers = 0;
-                    if (nMasks > 0) {
-                        modifiers = masks[0];
-                    }
-                    return Xkb::KeyCode({keycode - EVDEV_OFFSET, currentLevel, modifiers});
+                // the first key and level that produce the keysym win
+                if (keyCodes.contains(syms[sym])) {
+                    continue;
+                }
+                xkb_mod_mask_t masks[1]; // this function returns every way to shift to this level, we just need 1
+                int nMasks = xkb_keymap_key_get_mods_for_level(
+                    m_keymap, keycode, layout, currentLevel,
+                    masks, 1);
+                xkb_mod_mask_t modifiers = 0;
+                if (nMasks > 0) {
+                    modifiers = masks[0];
                 }
+                keyCodes.insert(syms[sym], Xkb::KeyCode({keycode - EVDEV_OFFSET, currentLevel, modifiers}));
             }
         }
     }
-    return {};
+    return keyCodes;
 }
 
 QList<xkb_keysym_t> Xkb::keysymsFromQtKey(QKeyCombination keyQt)
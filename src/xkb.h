@@ -14,6 +14,7 @@
 
 #include <KConfigGroup>
 
+#include <QHash>
 #include <QLoggingCategory>
 
 #include <optional>
@@ -173,6 +174,7 @@ private:
     void createKeymapFile();
     void updateModifiers();
     void updateConsumedModifiers(uint32_t key);
+    QHash<xkb_keysym_t, KeyCode> buildKeycodesFromKeysyms(xkb_layout_index_t layout) const;
     xkb_context *m_context;
     xkb_keymap *m_keymap;
     QStringList m_layoutList;
@@ -193,6 +195,7 @@ private:
     Qt::KeyboardModifiers m_consumedModifiers;
     xkb_keysym_t m_keysym;
     quint32 m_currentLayout = 0;
+    QHash<xkb_layout_index_t, QHash<xkb_keysym_t, KeyCode>> m_keycodesFromKeysyms;
 
     struct
     {
@@ -384,7 +384,7 @@ bool Selection::startTransferToX(xcb_selection_request_event_t *event)
         qCWarning(KWIN_XWL) << "Failed to set O_NONBLOCK flag for the read endpoint of a Wayland to X11 transfer pipe:" << strerror(errno);
     }
 
-    m_waylandSource->requestData(mimeType, std::move(pipe->writeEndpoint));
+    m_waylandSource->receive(mimeType, std::move(pipe->writeEndpoint));
 
     auto transfer = new TransferWltoX(*event, std::move(pipe->readEndpoint), this);
     m_wlToXTransfers.append(transfer);
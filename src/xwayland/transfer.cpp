@@ -27,6 +27,16 @@ namespace Xwl
 
 // in Bytes: equals 64KB
 static const uint32_t s_incrChunkSize = 63 * 1024;
+// incremental transfers start with small chunks and double their size with every chunk,
+// so that large transfers need fewer round trips with the requestor
+static const uint32_t s_maxIncrChunkSize = 4 * 1024 * 1024;
+
+static uint32_t maxIncrChunkSize()
+{
+    // the chunk has to fit into a single ChangeProperty request, which is limited by the server
+    const uint32_t maxRequestSize = xcb_get_maximum_request_length(kwinApp()->x11Connection()) * 4;
+    return std::clamp<uint32_t>(maxRequestSize - 1024, s_incrChunkSize, s_maxIncrChunkSize);
+}
 
 Transfer::Transfer(xcb_atom_t selection, FileDescriptor fd, xcb_timestamp_t timestamp, QObject *parent)
     : QObject(parent)
@@ -64,7 +74,9 @@ void Transfer::endTransfer()
 TransferWltoX::TransferWltoX(const xcb_selection_request_event_t &request, FileDescriptor fd, QObject *parent)
     : Transfer(request.selection, std::move(fd), 0, parent)
     , m_request(request)
+    , m_chunkSize(s_incrChunkSize)
 {
+    xcb_prefetch_maximum_request_length(kwinApp()->x11Connection());
 }
 
 void TransferWltoX::startTransferFromSource()
@@ -134,16 +146,16 @@ void TransferWltoX::startIncr()
 
 void TransferWltoX::readWlSource()
 {
-    if (m_chunks.size() == 0 || m_chunks.last().second == s_incrChunkSize) {
+    if (m_chunks.size() == 0 || m_chunks.last().second == m_chunks.last().first.size()) {
         // append new chunk
         auto next = QPair<QByteArray, int>();
-        next.first.resize(s_incrChunkSize);
+        next.first.resize(m_chunkSize);
         next.second = 0;
         m_chunks.append(next);
     }
 
     const auto oldLen = m_chunks.last().second;
-    const auto avail = s_incrChunkSize - m_chunks.last().second;
+    const auto avail = m_chunks.last().first.size() - m_chunks.last().second;
     Q_ASSERT(avail > 0);
 
     ssize_t readLen = read(fd(), m_chunks.last().first.data() + oldLen, avail);
@@ -175,8 +187,9 @@ void TransferWltoX::readWlSource()
             Selection::sendSelectionNotify(&m_request, true);
             endTransfer();
         }
-    } else if (m_chunks.last().second == s_incrChunkSize) {
+    } else if (m_chunks.last().second == m_chunks.last().first.size()) {
         // first chunk full, but not yet at fd end -> go incremental
+        m_chunkSize = std::min(m_chunkSize * 2, maxIncrChunkSize());
         if (incr()) {
             m_flushPropertyOnDelete = true;
             if (!m_propertyIsSet) {
@@ -20,6 +20,7 @@
 
 #include "atoms.h"
 #include "core/backendoutput.h"
+#include "ftrace.h"
 #include "keyboard_input.h"
 #include "main_wayland.h"
 #include "utils/common.h"
@@ -49,6 +50,9 @@
 
 #include <cerrno>
 #include <cstring>
+#include <optional>
+#include <set>
+#include <tuple>
 #include <input_event.h>
 #include <sys/socket.h>
 #include <unistd.h>
@@ -59,6 +63,9 @@ namespace KWin
 namespace Xwl
 {
 
+// how long X11 events are handled at a time before the compositor gets to run again
+static constexpr std::chrono::milliseconds s_dispatchBudget(4);
+
 class XrandrEventFilter : public X11EventFilter
 {
 public:
@@ -396,16 +403,103 @@ void Xwayland::dispatchEvents(DispatchEventsMode mode)
 
     auto pollEventFunc = mode == DispatchEventsMode::Poll ? xcb_poll_for_event : xcb_poll_for_queued_event;
 
+    // Read everything that has arrived first, so that bursts of events superseding each other
+    // can be coalesced, and then handle the events for at most a fixed amount of time in order
+    // not to hold up compositing. The rest is handled in the next iteration of the event loop.
+    const size_t pendingCount = m_pendingEvents.size();
     while (xcb_generic_event_t *event = pollEventFunc(connection)) {
-        if (!m_dataBridge->dispatchEvent(event)) {
-            kwinApp()->dispatchEvent(event);
+        m_pendingEvents.emplace_back(event);
+    }
+    if (m_pendingEvents.size() - pendingCount > 1) {
+        coalesceEvents();
+    }
+
+    const auto deadline = std::chrono::steady_clock::now() + s_dispatchBudget;
+    while (!m_pendingEvents.empty()) {
+        const UniqueCPtr<xcb_generic_event_t> event = std::move(m_pendingEvents.front());
+        m_pendingEvents.pop_front();
+        if (!event) {
+            continue;
+        }
+        if (!m_dataBridge->dispatchEvent(event.get())) {
+            kwinApp()->dispatchEvent(event.get());
+        }
+        if (!m_pendingEvents.empty() && std::chrono::steady_clock::now() > deadline) {
+            scheduleDispatchPendingEvents();
+            break;
         }
-        free(event);
     }
 
     xcb_flush(connection);
 }
 
+void Xwayland::coalesceEvents()
+{
+    // Only a few kinds of events can be dropped in favor of a later one of the same kind: the
+    // handlers of property notifications query the current value of the property anyway, and
+    // only the last known geometry of a window matters. Events that change the structure of
+    // the window tree, or that may refer to a property, end the range that is coalesced.
+    using Key = std::tuple<uint8_t, xcb_window_t, uint32_t>;
+    std::set<Key> seen;
+    for (auto it = m_pendingEvents.rbegin(); it != m_pendingEvents.rend(); ++it) {
+        if (!*it) {
+            continue;
+        }
+        const uint8_t type = (*it)->response_type & ~0x80;
+        const bool synthetic = (*it)->response_type & 0x80;
+        std::optional<Key> key;
+        switch (type) {
+        case XCB_PROPERTY_NOTIFY: {
+            const auto event = reinterpret_cast<const xcb_property_notify_event_t *>(it->get());
+            // deletions drive incremental selection transfers, every one of them counts
+            if (!synthetic && event->state == XCB_PROPERTY_NEW_VALUE) {
+                key = std::make_tuple(type, event->window, event->atom);
+            }
+            break;
+        }
+        case XCB_CONFIGURE_NOTIFY: {
+            const auto event = reinterpret_cast<const xcb_configure_notify_event_t *>(it->get());
+            if (!synthetic) {
+                key = std::make_tuple(type, event->event, event->window);
+            }
+            break;
+        }
+        case XCB_CREATE_NOTIFY:
+        case XCB_DESTROY_NOTIFY:
+        case XCB_UNMAP_NOTIFY:
+        case XCB_MAP_NOTIFY:
+        case XCB_MAP_REQUEST:
+        case XCB_REPARENT_NOTIFY:
+        case XCB_CONFIGURE_REQUEST:
+        case XCB_CLIENT_MESSAGE:
+        case XCB_SELECTION_CLEAR:
+        case XCB_SELECTION_REQUEST:
+        case XCB_SELECTION_NOTIFY:
+            seen.clear();
+            break;
+        default:
+            break;
+        }
+        if (key && !seen.insert(*key).second) {
+            it->reset();
+        }
+    }
+}
+
+void Xwayland::scheduleDispatchPendingEvents()
+{
+    if (m_dispatchPendingEventsScheduled) {
+        return;
+    }
+    m_dispatchPendingEventsScheduled = true;
+    QTimer::singleShot(0, this, [this]() {
+        m_dispatchPendingEventsScheduled = false;
+        if (kwinApp()->x11Connection()) {
+            dispatchEvents(DispatchEventsMode::EventQueue);
+        }
+    });
+}
+
 void Xwayland::installSocketNotifier()
 {
     const int fileDescriptor = xcb_get_file_descriptor(kwinApp()->x11Connection());
@@ -430,6 +524,7 @@ void Xwayland::uninstallSocketNotifier()
     disconnect(dispatcher, nullptr, this, nullptr);
 
     m_socketNotifier.reset();
+    m_pendingEvents.clear();
 }
 
 void Xwayland::handleXwaylandFinished()
@@ -451,26 +546,52 @@ void Xwayland::handleXwaylandFinished()
     destroyX11Connection();
 }
 
+static qint64 millisecondsSince(std::chrono::steady_clock::time_point since)
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - since).count();
+}
+
 void Xwayland::handleXwaylandReady()
 {
-    if (!createX11Connection()) {
-        Q_EMIT errorOccurred();
-        return;
+    // the first X11 client waits for all of this, log how long each step takes
+    auto phaseStart = std::chrono::steady_clock::now();
+    const auto endPhase = [&phaseStart](const char *name) {
+        qCDebug(KWIN_XWL, "Xwayland bootstrap: %s took %lldms", name, millisecondsSince(phaseStart));
+        phaseStart = std::chrono::steady_clock::now();
+    };
+
+    {
+        // this includes the setup of the window manager, which happens when the connection is announced
+        fTraceDuration("Xwayland bootstrap connection");
+        if (!createX11Connection()) {
+            Q_EMIT errorOccurred();
+            return;
+        }
     }
+    endPhase("connection and window manager setup");
 
     qCInfo(KWIN_XWL) << "Xwayland server started on display" << m_launcher->displayName();
 
-    m_dataBridge = std::make_unique<DataBridge>();
+    {
+        fTraceDuration("Xwayland bootstrap selections");
+        m_dataBridge = std::make_unique<DataBridge>();
+    }
+    endPhase("selections");
 
-    connect(workspace(), &Workspace::outputOrderChanged, this, &Xwayland::updatePrimary);
-    updatePrimary();
+    {
+        fTraceDuration("Xwayland bootstrap randr");
+        connect(workspace(), &Workspace::outputOrderChanged, this, &Xwayland::updatePrimary);
+        updatePrimary();
 
-    m_xrandrEventsFilter = std::make_unique<XrandrEventFilter>(this);
+        m_xrandrEventsFilter = std::make_unique<XrandrEventFilter>(this);
+    }
+    endPhase("randr");
 
     refreshEavesdropping();
     connect(options, &Options::xwaylandEavesdropsChanged, this, &Xwayland::refreshEavesdropping);
     connect(options, &Options::xwaylandEavesdropsMouseChanged, this, &Xwayland::refreshEavesdropping);
 
+    m_startupScriptsStartTime = std::chrono::steady_clock::now();
     runXWaylandStartupScripts();
 
     Q_EMIT started();
@@ -478,6 +599,10 @@ void Xwayland::handleXwaylandReady()
 
 void Xwayland::registerReady()
 {
+    qCDebug(KWIN_XWL, "Xwayland bootstrap: startup scripts took %lldms", millisecondsSince(m_startupScriptsStartTime));
+    qCDebug(KWIN_XWL, "Xwayland bootstrap: the window manager is ready %lldms after Xwayland was started", millisecondsSince(m_launcher->startTime()));
+    fTrace("Xwayland window manager ready");
+
     // Helper window to claim _NET_WM_CM_S0 and WM_S0 selections. It will be destroyed together with our connection.
     const xcb_window_t selectionOwner = xcb_generate_id(kwinApp()->x11Connection());
     xcb_create_window(kwinApp()->x11Connection(), XCB_COPY_FROM_PARENT, selectionOwner, kwinApp()->x11RootWindow(), 0, 0, 1, 1, 0, XCB_WINDOW_CLASS_INPUT_OUTPUT, XCB_COPY_FROM_PARENT, 0, nullptr);
@@ -15,8 +15,13 @@
 #error Do not include on non-X11 builds
 #endif
 
+#include <chrono>
+#include <deque>
 #include <memory>
 
+#include <xcb/xcb.h>
+
+#include "utils/c_ptr.h"
 #include "xwayland_interface.h"
 
 class QSocketNotifier;
@@ -71,6 +76,8 @@ private:
         EventQueue,
     };
     void dispatchEvents(DispatchEventsMode mode);
+    void coalesceEvents();
+    void scheduleDispatchPendingEvents();
 
     void installSocketNotifier();
     void uninstallSocketNotifier();
@@ -93,6 +100,15 @@ private:
     std::unique_ptr<XrandrEventFilter> m_xrandrEventsFilter;
     std::unique_ptr<XwaylandLauncher> m_launcher;
     std::unique_ptr<XwaylandInputFilter> m_inputFilter;
+    std::chrono::steady_clock::time_point m_startupScriptsStartTime;
+
+    /**
+     * Events that have been read from the connection but not handled yet, either because
+     * the dispatch ran out of time or because they have been superseded by later events
+     * (in which case they are null).
+     */
+    std::deque<UniqueCPtr<xcb_generic_event_t>> m_pendingEvents;
+    bool m_dispatchPendingEventsScheduled = false;
 
     Q_DISABLE_COPY(Xwayland)
 };
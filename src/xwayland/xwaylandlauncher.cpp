@@ -15,6 +15,7 @@
 #include "xwayland_logging.h"
 #include "xwaylandsocket.h"
 
+#include "ftrace.h"
 #include "options.h"
 #include "utils/pipe.h"
 #include "utils/socketpair.h"
@@ -27,7 +28,9 @@
 
 #include <QAbstractEventDispatcher>
 #include <QDataStream>
+#include <QFile>
 #include <QSocketNotifier>
+#include <QStandardPaths>
 #include <QTimer>
 
 // system
@@ -42,6 +45,9 @@ namespace KWin
 namespace Xwl
 {
 
+// long enough to not compete with the rest of the session startup
+static constexpr std::chrono::seconds s_prepareDelay(10);
+
 XwaylandLauncher::XwaylandLauncher()
     : m_resetCrashCountTimer(std::make_unique<QTimer>())
 {
@@ -142,6 +148,37 @@ void XwaylandLauncher::enable()
     }
 
     m_enabled = true;
+
+    // Xwayland is only started when the first X11 client connects, reduce the time that client
+    // has to wait by doing the work that doesn't need the process ahead of time
+    QTimer::singleShot(s_prepareDelay, this, &XwaylandLauncher::prepare);
+}
+
+QString XwaylandLauncher::executable()
+{
+    if (m_executable.isEmpty()) {
+        m_executable = QStandardPaths::findExecutable(QStringLiteral("Xwayland"));
+    }
+    return m_executable;
+}
+
+void XwaylandLauncher::prepare()
+{
+    if (!m_enabled || m_xwaylandProcess) {
+        return;
+    }
+
+    const QString path = executable();
+    if (path.isEmpty()) {
+        return;
+    }
+
+    // ask the kernel to read the executable into the page cache, unlike spawning Xwayland this
+    // doesn't cost any memory that can't be reclaimed if no X11 client shows up
+    const FileDescriptor fd(open(QFile::encodeName(path).constData(), O_RDONLY | O_CLOEXEC));
+    if (fd.isValid()) {
+        posix_fadvise(fd.get(), 0, 0, POSIX_FADV_WILLNEED);
+    }
 }
 
 void XwaylandLauncher::disable()
@@ -225,7 +262,7 @@ bool XwaylandLauncher::start()
     }
 
     m_xwaylandProcess = std::make_unique<QProcess>();
-    m_xwaylandProcess->setProgram(QStandardPaths::findExecutable("Xwayland"));
+    m_xwaylandProcess->setProgram(executable());
     m_xwaylandProcess->setArguments(arguments);
     m_xwaylandProcess->setProcessChannelMode(QProcess::ForwardedErrorChannel);
     m_xwaylandProcess->setProcessEnvironment(env);
@@ -257,9 +294,14 @@ bool XwaylandLauncher::start()
     m_readyNotifier = std::make_unique<QSocketNotifier>(m_readyFd.get(), QSocketNotifier::Read);
     connect(m_readyNotifier.get(), &QSocketNotifier::activated, this, [this]() {
         m_readyNotifier.reset();
+        const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - m_startTime);
+        qCDebug(KWIN_XWL) << "Xwayland became ready after" << elapsed.count() << "ms";
+        fTrace("Xwayland ready");
         Q_EMIT ready();
     });
 
+    fTrace("Xwayland start");
+    m_startTime = std::chrono::steady_clock::now();
     m_xwaylandProcess->start();
 
     Q_EMIT started();
@@ -286,6 +328,11 @@ QString XwaylandLauncher::initDisplayName() const
     return m_initDisplayName;
 }
 
+std::chrono::steady_clock::time_point XwaylandLauncher::startTime() const
+{
+    return m_startTime;
+}
+
 QProcess *XwaylandLauncher::process() const
 {
     return m_xwaylandProcess.get();
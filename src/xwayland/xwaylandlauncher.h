@@ -17,6 +17,7 @@
 #include <QObject>
 #include <QProcess>
 #include <QSocketNotifier>
+#include <chrono>
 #include <memory>
 #include <optional>
 
@@ -78,6 +79,11 @@ public:
 
     QString initDisplayName() const;
 
+    /**
+     * Returns the time the current Xwayland process has been started at.
+     */
+    std::chrono::steady_clock::time_point startTime() const;
+
     /**
      * @internal
      */
@@ -107,6 +113,9 @@ private Q_SLOTS:
     void handleXwaylandError(QProcess::ProcessError error);
 
 private:
+    QString executable();
+    void prepare();
+
     std::unique_ptr<QProcess> m_xwaylandProcess;
     std::unique_ptr<QSocketNotifier> m_readyNotifier;
     std::unique_ptr<QTimer> m_resetCrashCountTimer;
@@ -124,6 +133,8 @@ private:
     QMap<QString, QString> m_extraEnvironment;
     std::vector<FileDescriptor> m_fdsToPreserve;
 
+    QString m_executable;
+    std::chrono::steady_clock::time_point m_startTime;
     bool m_enabled = false;
     int m_crashCount = 0;
     FileDescriptor m_readyFd;